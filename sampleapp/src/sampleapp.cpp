@@ -47,10 +47,11 @@ void SampleApp::LoadContent()
     if (worldToLoad != "")
         world.Load(worldToLoad);
 
-    Entity& cameraObj = world.CreateCamera();
-    m_CameraTransform = &cameraObj.GetComponent<Ecs::EcsTransformComponent>();
-    m_CameraTransform->m_Translation = { 0, 2, 0 };
-    m_CameraTransform->m_Rotation = { 0, SMath::DegToRad(-90.0f), 0 };
+    m_Camera = &world.CreateCamera();
+    Ecs::EcsTransformComponent& transform = m_Camera->GetComponent<Ecs::EcsTransformComponent>();
+    transform.m_Translation = { 0, 2, 0 };
+    transform.m_Rotation = { 0, SMath::DegToRad(-90.0f), 0 };
+    m_Camera->MarkModified<Ecs::EcsTransformComponent>();
 }
 
 void SampleApp::UnloadContent()
@@ -112,6 +113,8 @@ void SampleApp::UpdateGraphicConfig() const
 
 void SampleApp::UpdateCamera() const
 {
+    Ecs::EcsTransformComponent& transform = m_Camera->GetComponent<Ecs::EcsTransformComponent>();
+
     static ethVector3 cameraRotation;
     static float moveSpeed = 0.001f;
 
@@ -122,35 +125,37 @@ void SampleApp::UpdateCamera() const
 
     if (Input::GetMouseButton(2))
     {
-        m_CameraTransform->m_Rotation.x += Input::GetMouseDeltaY() / 500;
-        m_CameraTransform->m_Rotation.y += Input::GetMouseDeltaX() / 500;
-        m_CameraTransform->m_Rotation.x = std::clamp(
-            m_CameraTransform->m_Rotation.x,
+        transform.m_Rotation.x += Input::GetMouseDeltaY() / 500;
+        transform.m_Rotation.y += Input::GetMouseDeltaX() / 500;
+        transform.m_Rotation.x = std::clamp(
+            transform.m_Rotation.x,
             -SMath::DegToRad(89.0f),
             SMath::DegToRad(89.0f));
     }
 
     if (Input::GetKey((KeyCode)Win32::KeyCode::E))
-        m_CameraTransform->m_Translation.y += Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation.y += Time::GetDeltaTime() * moveSpeed;
 
     if (Input::GetKey((KeyCode)Win32::KeyCode::Q))
-        m_CameraTransform->m_Translation.y -= Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation.y -= Time::GetDeltaTime() * moveSpeed;
 
-    ethMatrix4x4 rotation = Transform::GetRotationMatrix(m_CameraTransform->m_Rotation);
+    ethMatrix4x4 rotation = Transform::GetRotationMatrix(transform.m_Rotation);
     ethVector3 forward = (rotation * ethVector4(0, 0, 1, 0)).Resize<3>().Normalized();
     ethVector3 upVec = { 0, 1, 0 };
     ethVector3 rightVec = ethVector3::Cross(upVec, forward).Normalized();
 
     if (Input::GetKey((KeyCode)Win32::KeyCode::W))
-        m_CameraTransform->m_Translation = m_CameraTransform->m_Translation +
-                                           forward * Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation = transform.m_Translation +
+                                forward * Time::GetDeltaTime() * moveSpeed;
     if (Input::GetKey((KeyCode)Win32::KeyCode::A))
-        m_CameraTransform->m_Translation = m_CameraTransform->m_Translation -
-                                           rightVec * Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation = transform.m_Translation -
+                                rightVec * Time::GetDeltaTime() * moveSpeed;
     if (Input::GetKey((KeyCode)Win32::KeyCode::S))
-        m_CameraTransform->m_Translation = m_CameraTransform->m_Translation -
-                                           forward * Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation = transform.m_Translation -
+                                forward * Time::GetDeltaTime() * moveSpeed;
     if (Input::GetKey((KeyCode)Win32::KeyCode::D))
-        m_CameraTransform->m_Translation = m_CameraTransform->m_Translation +
-                                           rightVec * Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation = transform.m_Translation +
+                                rightVec * Time::GetDeltaTime() * moveSpeed;
+
+    m_Camera->MarkModified<Ecs::EcsTransformComponent>();
 }
@@ -41,5 +41,5 @@ private:
     void UpdateCamera() const;
 
 private:
-    Ether::Ecs::EcsTransformComponent* m_CameraTransform;
+    Ether::Entity* m_Camera;
 };
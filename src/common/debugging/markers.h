@@ -24,3 +24,6 @@
 #define ETH_MARKER_FRAME(name)  OPTICK_FRAME(name);
 #define ETH_MARKER_THREAD(name) OPTICK_THREAD(name);
 #define ETH_MARKER_EVENT(name)  OPTICK_EVENT(name);
+
+// For names only known at runtime (OPTICK_EVENT caches its description per call site)
+#define ETH_MARKER_EVENT_DYNAMIC(name) OPTICK_EVENT_DYNAMIC(name);
@@ -0,0 +1,228 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/ipc/ipcmessage.h"
+#include "common/logging/loggingmanager.h"
+
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+Ether::IpcMessage::IpcMessage()
+    : m_Format(IpcMessageFormat::Json)
+    , m_MessageType(0)
+    , m_SchemaVersion(0)
+{
+}
+
+Ether::IpcMessage::IpcMessage(uint32_t messageType, uint16_t schemaVersion)
+    : m_Format(IpcMessageFormat::Binary)
+    , m_MessageType(messageType)
+    , m_SchemaVersion(schemaVersion)
+    , m_Buffer(sizeof(IpcFrameHeader), 0)
+{
+    WriteFrameHeader();
+}
+
+Ether::IpcMessage Ether::IpcMessage::FromJson(std::string_view json)
+{
+    if (json.size() > MaxMessageSize)
+        throw std::runtime_error(std::format("IPC message of {} bytes exceeds the maximum message size", json.size()));
+
+    const uint32_t length = static_cast<uint32_t>(json.size());
+
+    IpcMessage message;
+    message.m_Buffer.resize(sizeof(length) + json.size());
+    std::memcpy(message.m_Buffer.data(), &length, sizeof(length));
+    std::memcpy(message.m_Buffer.data() + sizeof(length), json.data(), json.size());
+    return message;
+}
+
+std::string_view Ether::IpcMessage::GetJson() const
+{
+    if (m_Format != IpcMessageFormat::Json || m_Buffer.size() < sizeof(uint32_t))
+        return {};
+
+    return std::string_view(reinterpret_cast<const char*>(m_Buffer.data()) + sizeof(uint32_t), m_Buffer.size() - sizeof(uint32_t));
+}
+
+Ether::IpcSection Ether::IpcMessage::GetSection(size_t index) const
+{
+    IpcSectionHeader sectionHeader;
+    std::memcpy(&sectionHeader, m_Buffer.data() + m_SectionOffsets[index], sizeof(sectionHeader));
+
+    const uint8_t* data = m_Buffer.data() + m_SectionOffsets[index] + sizeof(sectionHeader);
+    return { sectionHeader.m_Tag, data, static_cast<size_t>(sectionHeader.m_Size) };
+}
+
+Ether::IpcSection Ether::IpcMessage::FindSection(uint32_t tag) const
+{
+    for (size_t i = 0; i < m_SectionOffsets.size(); ++i)
+    {
+        const IpcSection section = GetSection(i);
+        if (section.m_Tag == tag)
+            return section;
+    }
+
+    return { tag, nullptr, 0 };
+}
+
+uint8_t* Ether::IpcMessage::AddSection(uint32_t tag, size_t numBytes)
+{
+    Assert(m_Format == IpcMessageFormat::Binary, "Sections can only be added to binary IPC messages");
+
+    const size_t sectionOffset = m_Buffer.size();
+    const size_t sectionSize = sizeof(IpcSectionHeader) + AlignUp(numBytes, SectionAlignment);
+
+    if (sectionOffset + sectionSize > MaxMessageSize)
+        throw std::runtime_error(std::format("IPC message of {} bytes exceeds the maximum message size", sectionOffset + sectionSize));
+
+    // Zero filled, so that the padding does not leak whatever was in memory before
+    m_Buffer.resize(sectionOffset + sectionSize, 0);
+
+    IpcSectionHeader sectionHeader = {};
+    sectionHeader.m_Tag = tag;
+    sectionHeader.m_Size = numBytes;
+    std::memcpy(m_Buffer.data() + sectionOffset, &sectionHeader, sizeof(sectionHeader));
+
+    m_SectionOffsets.push_back(sectionOffset);
+    WriteFrameHeader();
+
+    return m_Buffer.data() + sectionOffset + sizeof(sectionHeader);
+}
+
+void Ether::IpcMessage::AddSection(uint32_t tag, const void* data, size_t numBytes)
+{
+    uint8_t* dst = AddSection(tag, numBytes);
+    if (numBytes > 0)
+        std::memcpy(dst, data, numBytes);
+}
+
+void Ether::IpcMessage::WriteTo(IpcTransport& transport) const
+{
+    transport.Send(m_Buffer.data(), m_Buffer.size());
+}
+
+Ether::IpcMessage Ether::IpcMessage::ReadFrom(IpcTransport& transport)
+{
+    uint32_t prefix;
+    transport.Receive(&prefix, sizeof(prefix));
+
+    if (prefix != Magic)
+    {
+        if (prefix > MaxMessageSize)
+            throw std::runtime_error(std::format("IPC message of {} bytes exceeds the maximum message size", prefix));
+
+        IpcMessage message;
+        message.m_Buffer.resize(sizeof(prefix) + prefix);
+        std::memcpy(message.m_Buffer.data(), &prefix, sizeof(prefix));
+        transport.Receive(message.m_Buffer.data() + sizeof(prefix), prefix);
+        return message;
+    }
+
+    IpcFrameHeader frameHeader;
+    frameHeader.m_Magic = prefix;
+    transport.Receive(reinterpret_cast<uint8_t*>(&frameHeader) + sizeof(prefix), sizeof(frameHeader) - sizeof(prefix));
+
+    if (frameHeader.m_PayloadSize > MaxMessageSize - sizeof(frameHeader))
+        throw std::runtime_error(std::format("IPC message of {} bytes exceeds the maximum message size", frameHeader.m_PayloadSize));
+
+    IpcMessage message(frameHeader.m_MessageType, frameHeader.m_SchemaVersion);
+    message.m_Buffer.resize(sizeof(frameHeader) + frameHeader.m_PayloadSize);
+    std::memcpy(message.m_Buffer.data(), &frameHeader, sizeof(frameHeader));
+    transport.Receive(message.m_Buffer.data() + sizeof(frameHeader), frameHeader.m_PayloadSize);
+
+    message.ReadSectionOffsets(frameHeader.m_NumSections);
+    return message;
+}
+
+Ether::IpcMessage Ether::IpcMessage::FromBytes(const void* data, size_t numBytes)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    uint32_t prefix;
+    if (numBytes < sizeof(prefix))
+        throw std::runtime_error("Malformed IPC message: truncated");
+
+    std::memcpy(&prefix, bytes, sizeof(prefix));
+
+    if (prefix != Magic)
+    {
+        if (prefix > MaxMessageSize)
+            throw std::runtime_error(std::format("IPC message of {} bytes exceeds the maximum message size", prefix));
+
+        if (numBytes - sizeof(prefix) != prefix)
+            throw std::runtime_error(std::format("Malformed IPC message: {} bytes of JSON in {} bytes", prefix, numBytes - sizeof(prefix)));
+
+        IpcMessage message;
+        message.m_Buffer.assign(bytes, bytes + numBytes);
+        return message;
+    }
+
+    IpcFrameHeader frameHeader;
+    if (numBytes < sizeof(frameHeader))
+        throw std::runtime_error("Malformed IPC message: truncated");
+
+    std::memcpy(&frameHeader, bytes, sizeof(frameHeader));
+
+    if (frameHeader.m_PayloadSize > MaxMessageSize - sizeof(frameHeader))
+        throw std::runtime_error(std::format("IPC message of {} bytes exceeds the maximum message size", frameHeader.m_PayloadSize));
+
+    if (numBytes - sizeof(frameHeader) != frameHeader.m_PayloadSize)
+        throw std::runtime_error(std::format("Malformed IPC message: {} bytes of payload in {} bytes", frameHeader.m_PayloadSize, numBytes - sizeof(frameHeader)));
+
+    IpcMessage message(frameHeader.m_MessageType, frameHeader.m_SchemaVersion);
+    message.m_Buffer.assign(bytes, bytes + numBytes);
+    message.ReadSectionOffsets(frameHeader.m_NumSections);
+    return message;
+}
+
+void Ether::IpcMessage::ReadSectionOffsets(uint32_t numSections)
+{
+    // Validated up front, so that reading a section later on never goes out of bounds
+    size_t offset = sizeof(IpcFrameHeader);
+    m_SectionOffsets.reserve((std::min)(static_cast<size_t>(numSections), (m_Buffer.size() - offset) / sizeof(IpcSectionHeader)));
+
+    for (uint32_t i = 0; i < numSections; ++i)
+    {
+        if (m_Buffer.size() - offset < sizeof(IpcSectionHeader))
+            throw std::runtime_error("Malformed IPC message: section header out of bounds");
+
+        IpcSectionHeader sectionHeader;
+        std::memcpy(&sectionHeader, m_Buffer.data() + offset, sizeof(sectionHeader));
+
+        const size_t numBytesLeft = m_Buffer.size() - offset - sizeof(sectionHeader);
+        if (sectionHeader.m_Size > numBytesLeft)
+            throw std::runtime_error("Malformed IPC message: section payload out of bounds");
+
+        m_SectionOffsets.push_back(offset);
+        offset += sizeof(sectionHeader) + (std::min)(AlignUp(static_cast<size_t>(sectionHeader.m_Size), SectionAlignment), numBytesLeft);
+    }
+}
+
+void Ether::IpcMessage::WriteFrameHeader()
+{
+    IpcFrameHeader frameHeader = {};
+    frameHeader.m_Magic = Magic;
+    frameHeader.m_SchemaVersion = m_SchemaVersion;
+    frameHeader.m_MessageType = m_MessageType;
+    frameHeader.m_NumSections = static_cast<uint32_t>(m_SectionOffsets.size());
+    frameHeader.m_PayloadSize = m_Buffer.size() - sizeof(frameHeader);
+    std::memcpy(m_Buffer.data(), &frameHeader, sizeof(frameHeader));
+}
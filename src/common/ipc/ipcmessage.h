@@ -0,0 +1,143 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+#include "common/ipc/ipctransport.h"
+
+#include <string_view>
+#include <vector>
+
+namespace Ether
+{
+enum class IpcMessageFormat : uint8_t
+{
+    Json,
+    Binary,
+};
+
+constexpr uint32_t MakeIpcTag(char a, char b, char c, char d)
+{
+    return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+}
+
+// Wire format, little endian
+struct IpcFrameHeader
+{
+    uint32_t m_Magic;
+    uint16_t m_SchemaVersion;
+    uint16_t m_Flags;
+    uint32_t m_MessageType;
+    uint32_t m_NumSections;
+    uint64_t m_PayloadSize;
+};
+
+struct IpcSectionHeader
+{
+    uint32_t m_Tag;
+    uint32_t m_Reserved;
+    uint64_t m_Size;
+};
+
+static_assert(sizeof(IpcFrameHeader) == 24);
+static_assert(sizeof(IpcSectionHeader) == 16);
+
+struct IpcSection
+{
+    uint32_t m_Tag;
+    const uint8_t* m_Data;
+    size_t m_Size;
+};
+
+/*
+    A single message exchanged with the editor, in one of two framings:
+
+    - Json:   [uint32 length][JSON text]
+              The original protocol. Still used for commands, which are small and easy to extend.
+
+    - Binary: [IpcFrameHeader][IpcSectionHeader][payload][padding]...
+              A typed header with a schema version, followed by raw payload sections that are read
+              in place, without any parsing. Sections are padded to 8 bytes, so their payloads can
+              be reinterpreted directly as arrays of plain data.
+
+    The two can be told apart from the first four bytes, since the binary magic is larger than the
+    largest JSON message that will be accepted.
+
+    The message keeps its bytes exactly as they go over the wire, so sending it is a single write.
+*/
+class ETH_COMMON_DLL IpcMessage
+{
+public:
+    IpcMessage();
+    IpcMessage(uint32_t messageType, uint16_t schemaVersion);
+
+    static IpcMessage FromJson(std::string_view json);
+
+public:
+    inline IpcMessageFormat GetFormat() const { return m_Format; }
+    inline uint32_t GetMessageType() const { return m_MessageType; }
+    inline uint16_t GetSchemaVersion() const { return m_SchemaVersion; }
+    inline size_t GetNumSections() const { return m_SectionOffsets.size(); }
+    inline size_t GetSizeInBytes() const { return m_Buffer.size(); }
+
+    // The message exactly as it goes over the wire
+    inline const uint8_t* GetData() const { return m_Buffer.data(); }
+
+    std::string_view GetJson() const;
+
+    IpcSection GetSection(size_t index) const;
+
+    // The returned section has no data if the message does not contain the tag
+    IpcSection FindSection(uint32_t tag) const;
+
+public:
+    // Returns the storage of the new section, so that the payload can be written in place. It is
+    // only valid until the next section is added.
+    uint8_t* AddSection(uint32_t tag, size_t numBytes);
+    void AddSection(uint32_t tag, const void* data, size_t numBytes);
+
+public:
+    void WriteTo(IpcTransport& transport) const;
+    static IpcMessage ReadFrom(IpcTransport& transport);
+
+    // A whole message that was read before, e.g. from a recording. Validated the same way as
+    // ReadFrom(), and throws if the bytes are not exactly one message.
+    static IpcMessage FromBytes(const void* data, size_t numBytes);
+
+public:
+    static constexpr uint32_t Magic = MakeIpcTag('E', 'I', 'P', 'C');
+    static constexpr size_t MaxMessageSize = _256MiB;
+    static constexpr size_t SectionAlignment = 8;
+
+    static_assert(Magic > MaxMessageSize, "Binary frames must not be mistaken for JSON lengths");
+
+private:
+    void WriteFrameHeader();
+    void ReadSectionOffsets(uint32_t numSections);
+
+private:
+    IpcMessageFormat m_Format;
+    uint32_t m_MessageType;
+    uint16_t m_SchemaVersion;
+
+    std::vector<uint8_t> m_Buffer;
+    std::vector<size_t> m_SectionOffsets;
+};
+} // namespace Ether
@@ -0,0 +1,293 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/ipc/ipcsender.h"
+#include "common/logging/loggingmanager.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+// The sender is woken up whenever something is enqueued; this is only a safety net
+constexpr std::chrono::milliseconds SenderIdleInterval(5);
+
+Ether::IpcSender::IpcSender()
+    : m_Queue(std::make_unique<MpscQueue<PendingMessage, QueueCapacity>>())
+    , m_NumEnqueued(0)
+    , m_NumProcessed(0)
+    , m_HasParked(false)
+    , m_Transport(nullptr)
+    , m_IsRunning(true)
+    , m_IsSenderIdle(false)
+    , m_NumFlushWaiters(0)
+    , m_NumMessagesSent(0)
+    , m_NumBytesSent(0)
+    , m_NumWrites(0)
+    , m_NumDropped(0)
+    , m_NumCoalesced(0)
+{
+    m_WriteBuffer.reserve(MaxBatchSize);
+    m_SenderThread = std::thread(&IpcSender::SenderThread, this);
+}
+
+Ether::IpcSender::~IpcSender()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_IsRunning = false;
+    }
+
+    m_WakeCondition.notify_one();
+    m_SenderThread.join();
+}
+
+void Ether::IpcSender::Attach(IpcTransport& transport)
+{
+    std::lock_guard<std::mutex> lock(m_TransportMutex);
+    m_Transport = &transport;
+}
+
+void Ether::IpcSender::Detach()
+{
+    std::lock_guard<std::mutex> lock(m_TransportMutex);
+    m_Transport = nullptr;
+}
+
+bool Ether::IpcSender::Enqueue(IpcMessage&& message, IpcSendPolicy policy, uint64_t coalesceKey)
+{
+    PendingMessage pending;
+    pending.m_Message = std::move(message);
+    pending.m_Ordinal = m_NumEnqueued.fetch_add(1, std::memory_order_relaxed);
+    pending.m_CoalesceKey = coalesceKey;
+    pending.m_Policy = policy;
+
+    while (!m_Queue->TryPush(pending))
+    {
+        if (policy == IpcSendPolicy::Drop)
+        {
+            m_NumDropped.fetch_add(1, std::memory_order_relaxed);
+            OnProcessed(1);
+            return false;
+        }
+
+        if (policy == IpcSendPolicy::Coalesce)
+        {
+            std::lock_guard<std::mutex> lock(m_ParkedMutex);
+
+            auto it = m_Parked.find(coalesceKey);
+            if (it == m_Parked.end())
+                m_Parked.emplace(coalesceKey, std::move(pending));
+            else
+            {
+                it->second = std::move(pending);
+                m_NumCoalesced.fetch_add(1, std::memory_order_relaxed);
+                OnProcessed(1);
+            }
+
+            m_HasParked = true;
+            break;
+        }
+
+        // The sender has fallen behind. Wake it up and wait rather than drop the message.
+        WakeSender();
+        std::this_thread::yield();
+    }
+
+    WakeSender();
+    return true;
+}
+
+void Ether::IpcSender::Flush()
+{
+    const uint64_t numEnqueued = m_NumEnqueued.load();
+    m_NumFlushWaiters++;
+    WakeSender();
+
+    {
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_FlushCondition.wait(lock, [&]() { return m_NumProcessed.load() >= numEnqueued; });
+    }
+
+    m_NumFlushWaiters--;
+}
+
+Ether::IpcSenderStats Ether::IpcSender::GetStats() const
+{
+    IpcSenderStats stats;
+    stats.m_NumMessagesSent = m_NumMessagesSent.load(std::memory_order_relaxed);
+    stats.m_NumBytesSent = m_NumBytesSent.load(std::memory_order_relaxed);
+    stats.m_NumWrites = m_NumWrites.load(std::memory_order_relaxed);
+    stats.m_NumDropped = m_NumDropped.load(std::memory_order_relaxed);
+    stats.m_NumCoalesced = m_NumCoalesced.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Ether::IpcSender::SenderThread()
+{
+    std::vector<PendingMessage> batch;
+    batch.reserve(QueueCapacity);
+
+    while (true)
+    {
+        PendingMessage pending;
+        size_t batchSize = 0;
+
+        while (batchSize < MaxBatchSize && m_Queue->TryPop(pending))
+        {
+            batchSize += pending.m_Message.GetSizeInBytes();
+            batch.push_back(std::move(pending));
+        }
+
+        // Taken after draining the queue, so a message parked before anything in this batch was
+        // enqueued can not be written after it
+        if (m_HasParked.exchange(false))
+        {
+            std::lock_guard<std::mutex> lock(m_ParkedMutex);
+            for (auto& parked : m_Parked)
+                batch.push_back(std::move(parked.second));
+
+            m_Parked.clear();
+        }
+
+        if (!batch.empty())
+        {
+            SendBatch(batch);
+            OnProcessed(batch.size());
+            batch.clear();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+
+        if (!m_IsRunning)
+            break;
+
+        m_IsSenderIdle = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        m_WakeCondition.wait_for(lock, SenderIdleInterval, [this]()
+        {
+            return !m_IsRunning || !m_Queue->IsEmpty() || m_HasParked;
+        });
+
+        m_IsSenderIdle = false;
+    }
+}
+
+void Ether::IpcSender::SendBatch(std::vector<PendingMessage>& batch)
+{
+    // Only the newest message for each coalesce key survives
+    m_NewestOrdinals.clear();
+    for (const PendingMessage& pending : batch)
+    {
+        if (pending.m_Policy != IpcSendPolicy::Coalesce)
+            continue;
+
+        uint64_t& newestOrdinal = m_NewestOrdinals.try_emplace(pending.m_CoalesceKey, pending.m_Ordinal).first->second;
+        newestOrdinal = (std::max)(newestOrdinal, pending.m_Ordinal);
+    }
+
+    std::lock_guard<std::mutex> lock(m_TransportMutex);
+
+    if (m_Transport == nullptr || !m_Transport->HasActiveConnection())
+    {
+        m_NumDropped.fetch_add(batch.size(), std::memory_order_relaxed);
+        return;
+    }
+
+    uint64_t numMessagesSent = 0;
+    uint64_t numMessagesCoalesced = 0;
+    uint64_t numBytesSent = 0;
+    uint64_t numWrites = 0;
+
+    const auto write = [&](const void* data, size_t numBytes)
+    {
+        m_Transport->Send(data, numBytes);
+        numBytesSent += numBytes;
+        numWrites++;
+    };
+
+    try
+    {
+        m_WriteBuffer.clear();
+
+        for (const PendingMessage& pending : batch)
+        {
+            if (pending.m_Policy == IpcSendPolicy::Coalesce && m_NewestOrdinals[pending.m_CoalesceKey] != pending.m_Ordinal)
+            {
+                numMessagesCoalesced++;
+                continue;
+            }
+
+            const IpcMessage& message = pending.m_Message;
+
+            if (message.GetSizeInBytes() > MaxBatchedMessageSize)
+            {
+                if (!m_WriteBuffer.empty())
+                    write(m_WriteBuffer.data(), m_WriteBuffer.size());
+
+                m_WriteBuffer.clear();
+                write(message.GetData(), message.GetSizeInBytes());
+            }
+            else
+                m_WriteBuffer.insert(m_WriteBuffer.end(), message.GetData(), message.GetData() + message.GetSizeInBytes());
+
+            numMessagesSent++;
+        }
+
+        if (!m_WriteBuffer.empty())
+            write(m_WriteBuffer.data(), m_WriteBuffer.size());
+    }
+    catch (const std::runtime_error& err)
+    {
+        // Whoever owns the transport finds out about the disconnect on its own, through the
+        // receiving end. Until then there is no point in trying to write to it.
+        LogWarning("IPC: %s, discarding outgoing messages until reconnected", err.what());
+        m_Transport = nullptr;
+        m_NumDropped.fetch_add(batch.size() - numMessagesSent - numMessagesCoalesced, std::memory_order_relaxed);
+    }
+
+    m_WriteBuffer.clear();
+    m_NumMessagesSent.fetch_add(numMessagesSent, std::memory_order_relaxed);
+    m_NumCoalesced.fetch_add(numMessagesCoalesced, std::memory_order_relaxed);
+    m_NumBytesSent.fetch_add(numBytesSent, std::memory_order_relaxed);
+    m_NumWrites.fetch_add(numWrites, std::memory_order_relaxed);
+}
+
+void Ether::IpcSender::WakeSender()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_IsSenderIdle.load())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    m_WakeCondition.notify_one();
+}
+
+void Ether::IpcSender::OnProcessed(uint64_t numMessages)
+{
+    m_NumProcessed.fetch_add(numMessages);
+
+    // Keeps producers that drop messages off the mutex, unless someone is actually waiting
+    if (m_NumFlushWaiters.load() == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    m_FlushCondition.notify_all();
+}
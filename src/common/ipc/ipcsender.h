@@ -0,0 +1,140 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+#include "common/ipc/ipcmessage.h"
+#include "common/ipc/ipctransport.h"
+#include "common/ipc/mpscqueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Ether
+{
+enum class IpcSendPolicy : uint8_t
+{
+    // Waits for room in the queue. For responses, and anything else that has to arrive.
+    Block,
+
+    // Dropped if the queue is full. For updates that a later message supersedes anyway.
+    Drop,
+
+    // Only the newest message for each coalesce key is written per batch. If the queue is full the
+    // message is parked rather than dropped, so the latest state for a key always arrives.
+    Coalesce,
+};
+
+struct IpcSenderStats
+{
+    uint64_t m_NumMessagesSent;
+    uint64_t m_NumBytesSent;
+    uint64_t m_NumWrites;
+    uint64_t m_NumDropped;
+    uint64_t m_NumCoalesced;
+};
+
+/*
+    Outgoing half of an IPC connection. Any thread can enqueue messages without taking a lock; a
+    dedicated sender thread drains whatever is pending and writes it out in as few writes as
+    possible, by copying small messages back to back into a single buffer.
+
+    Messages are written in the order they were enqueued, except for coalesced messages that had
+    to be parked while the queue was full, which go out at the end of the next batch.
+*/
+class ETH_COMMON_DLL IpcSender : public NonCopyable, public NonMovable
+{
+public:
+    IpcSender();
+    ~IpcSender();
+
+public:
+    // The transport has to stay alive until Detach() returns
+    void Attach(IpcTransport& transport);
+
+    // Waits for the write in flight (if any). Messages are discarded until the next Attach().
+    void Detach();
+
+    // Any thread. Returns false if the message was dropped.
+    bool Enqueue(IpcMessage&& message, IpcSendPolicy policy = IpcSendPolicy::Block, uint64_t coalesceKey = 0);
+
+    // Blocks until everything enqueued so far has been written (or discarded)
+    void Flush();
+
+    IpcSenderStats GetStats() const;
+
+public:
+    static constexpr uint32_t QueueCapacity = 1024;
+
+    // Larger messages are written on their own, rather than copied into the batch buffer
+    static constexpr size_t MaxBatchedMessageSize = _64KiB;
+    static constexpr size_t MaxBatchSize = _1MiB;
+
+private:
+    struct PendingMessage
+    {
+        IpcMessage m_Message;
+        uint64_t m_Ordinal = 0;
+        uint64_t m_CoalesceKey = 0;
+        IpcSendPolicy m_Policy = IpcSendPolicy::Block;
+    };
+
+    void SenderThread();
+    void SendBatch(std::vector<PendingMessage>& batch);
+    void WakeSender();
+    void OnProcessed(uint64_t numMessages);
+
+private:
+    std::unique_ptr<MpscQueue<PendingMessage, QueueCapacity>> m_Queue;
+    std::atomic<uint64_t> m_NumEnqueued;
+    std::atomic<uint64_t> m_NumProcessed;
+
+    // Newest coalesced message per key that did not fit into the queue
+    std::unordered_map<uint64_t, PendingMessage> m_Parked;
+    std::mutex m_ParkedMutex;
+    std::atomic<bool> m_HasParked;
+
+    IpcTransport* m_Transport;
+    std::mutex m_TransportMutex;
+
+    std::thread m_SenderThread;
+    std::atomic<bool> m_IsRunning;
+    std::atomic<bool> m_IsSenderIdle;
+    std::condition_variable m_WakeCondition;
+    std::condition_variable m_FlushCondition;
+    std::atomic<uint32_t> m_NumFlushWaiters;
+    std::mutex m_WakeMutex;
+
+    // Sender thread only
+    std::vector<uint8_t> m_WriteBuffer;
+    std::unordered_map<uint64_t, uint64_t> m_NewestOrdinals;
+
+    std::atomic<uint64_t> m_NumMessagesSent;
+    std::atomic<uint64_t> m_NumBytesSent;
+    std::atomic<uint64_t> m_NumWrites;
+    std::atomic<uint64_t> m_NumDropped;
+    std::atomic<uint64_t> m_NumCoalesced;
+};
+} // namespace Ether
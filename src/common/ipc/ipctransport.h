@@ -0,0 +1,45 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+
+namespace Ether
+{
+/*
+    A reliable, ordered byte stream between two processes (or two threads, see LoopbackTransport).
+    Framing is left to IpcMessage. Send() and Receive() block until every byte has been transferred,
+    and throw std::runtime_error once the connection is lost.
+*/
+class ETH_COMMON_DLL IpcTransport : public NonCopyable
+{
+public:
+    IpcTransport() = default;
+    virtual ~IpcTransport() = default;
+
+public:
+    virtual void WaitForConnection() = 0;
+    virtual bool HasActiveConnection() const = 0;
+
+    virtual void Send(const void* data, size_t numBytes) = 0;
+    virtual void Receive(void* data, size_t numBytes) = 0;
+    virtual void Close() = 0;
+};
+} // namespace Ether
@@ -0,0 +1,113 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/ipc/loopbacktransport.h"
+
+#include <cstring>
+#include <stdexcept>
+
+Ether::LoopbackTransport::LoopbackTransport(std::shared_ptr<Channel> incoming, std::shared_ptr<Channel> outgoing)
+    : m_Incoming(std::move(incoming))
+    , m_Outgoing(std::move(outgoing))
+{
+}
+
+Ether::LoopbackTransport::~LoopbackTransport()
+{
+    Close();
+}
+
+Ether::LoopbackTransport::Pair Ether::LoopbackTransport::CreatePair()
+{
+    std::shared_ptr<Channel> aToB = std::make_shared<Channel>();
+    std::shared_ptr<Channel> bToA = std::make_shared<Channel>();
+
+    return {
+        std::unique_ptr<LoopbackTransport>(new LoopbackTransport(bToA, aToB)),
+        std::unique_ptr<LoopbackTransport>(new LoopbackTransport(aToB, bToA))
+    };
+}
+
+bool Ether::LoopbackTransport::HasActiveConnection() const
+{
+    std::lock_guard<std::mutex> lock(m_Incoming->m_Mutex);
+    return !m_Incoming->m_IsClosed;
+}
+
+void Ether::LoopbackTransport::Send(const void* data, size_t numBytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Outgoing->m_Mutex);
+
+        if (m_Outgoing->m_IsClosed)
+            throw std::runtime_error("IPC connection was terminated while sending");
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        m_Outgoing->m_Buffer.insert(m_Outgoing->m_Buffer.end(), bytes, bytes + numBytes);
+    }
+
+    m_Outgoing->m_DataAvailable.notify_one();
+}
+
+void Ether::LoopbackTransport::Receive(void* data, size_t numBytes)
+{
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    std::unique_lock<std::mutex> lock(m_Incoming->m_Mutex);
+
+    while (numBytes > 0)
+    {
+        Channel& channel = *m_Incoming;
+        channel.m_DataAvailable.wait(lock, [&]() { return channel.m_IsClosed || channel.m_ReadOffset < channel.m_Buffer.size(); });
+
+        // Whatever was sent before the close can still be read, same as a socket
+        const size_t numBytesAvailable = channel.m_Buffer.size() - channel.m_ReadOffset;
+        if (numBytesAvailable == 0)
+            throw std::runtime_error("IPC connection was terminated");
+
+        const size_t numBytesToCopy = (std::min)(numBytes, numBytesAvailable);
+        std::memcpy(bytes, channel.m_Buffer.data() + channel.m_ReadOffset, numBytesToCopy);
+        channel.m_ReadOffset += numBytesToCopy;
+        bytes += numBytesToCopy;
+        numBytes -= numBytesToCopy;
+
+        // Only shift the unread bytes down once more than half of the buffer has been consumed,
+        // which keeps the cost of compacting amortized against the bytes that were read
+        if (channel.m_ReadOffset > channel.m_Buffer.size() / 2)
+        {
+            channel.m_Buffer.erase(channel.m_Buffer.begin(), channel.m_Buffer.begin() + channel.m_ReadOffset);
+            channel.m_ReadOffset = 0;
+        }
+    }
+}
+
+void Ether::LoopbackTransport::Close()
+{
+    CloseChannel(*m_Incoming);
+    CloseChannel(*m_Outgoing);
+}
+
+void Ether::LoopbackTransport::CloseChannel(Channel& channel)
+{
+    {
+        std::lock_guard<std::mutex> lock(channel.m_Mutex);
+        channel.m_IsClosed = true;
+    }
+
+    channel.m_DataAvailable.notify_all();
+}
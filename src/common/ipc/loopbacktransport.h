@@ -0,0 +1,74 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+#include "common/ipc/ipctransport.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Ether
+{
+/*
+    In-process stand-in for a socket. CreatePair() returns two endpoints that are already connected
+    to each other, so both sides of the IPC protocol can be exercised (or benchmarked) from within a
+    single process, without going through the network stack.
+*/
+class ETH_COMMON_DLL LoopbackTransport : public IpcTransport
+{
+public:
+    using Pair = std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>>;
+    static Pair CreatePair();
+
+    ~LoopbackTransport() override;
+
+public:
+    void WaitForConnection() override {}
+    bool HasActiveConnection() const override;
+
+    void Send(const void* data, size_t numBytes) override;
+    void Receive(void* data, size_t numBytes) override;
+
+    // Closes both directions, so that the other endpoint sees the disconnect as well
+    void Close() override;
+
+private:
+    // One direction of the connection
+    struct Channel
+    {
+        std::mutex m_Mutex;
+        std::condition_variable m_DataAvailable;
+        std::vector<uint8_t> m_Buffer;
+        size_t m_ReadOffset = 0;
+        bool m_IsClosed = false;
+    };
+
+    LoopbackTransport(std::shared_ptr<Channel> incoming, std::shared_ptr<Channel> outgoing);
+
+    static void CloseChannel(Channel& channel);
+
+private:
+    std::shared_ptr<Channel> m_Incoming;
+    std::shared_ptr<Channel> m_Outgoing;
+};
+} // namespace Ether
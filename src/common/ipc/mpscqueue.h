@@ -0,0 +1,112 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+
+#include <atomic>
+#include <type_traits>
+
+namespace Ether
+{
+/*
+    Fixed capacity multi-producer, single-consumer queue, after Dmitry Vyukov's bounded MPMC queue.
+
+    Every slot carries a sequence number that tells producers whether the slot is free for the
+    current lap, and the consumer whether it has been published. Producers only contend on the
+    tail with a single CAS, and the consumer does not write to any shared counter at all.
+*/
+template <typename T, uint32_t Capacity>
+class MpscQueue : public NonCopyable, public NonMovable
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "MPSC queue capacity must be a power of two");
+    static_assert(std::is_nothrow_move_assignable_v<T>, "MPSC queue items must be nothrow move assignable");
+
+public:
+    MpscQueue()
+        : m_Tail(0)
+        , m_Head(0)
+    {
+        for (uint32_t i = 0; i < Capacity; ++i)
+            m_Slots[i].m_Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~MpscQueue() = default;
+
+public:
+    // Any thread. Returns false (and leaves the item untouched) if the queue is full.
+    bool TryPush(T& item)
+    {
+        uint64_t tail = m_Tail.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot& slot = m_Slots[tail & Mask];
+            const uint64_t sequence = slot.m_Sequence.load(std::memory_order_acquire);
+            const int64_t lap = static_cast<int64_t>(sequence - tail);
+
+            if (lap == 0)
+            {
+                if (m_Tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                {
+                    slot.m_Item = std::move(item);
+                    slot.m_Sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lap < 0)
+                return false;
+            else
+                tail = m_Tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer thread only
+    bool TryPop(T& item)
+    {
+        Slot& slot = m_Slots[m_Head & Mask];
+
+        // Either empty, or the producer that claimed this slot has not published it yet
+        if (slot.m_Sequence.load(std::memory_order_acquire) != m_Head + 1)
+            return false;
+
+        item = std::move(slot.m_Item);
+        slot.m_Sequence.store(m_Head + Capacity, std::memory_order_release);
+        ++m_Head;
+        return true;
+    }
+
+    // Consumer thread only
+    inline bool IsEmpty() const { return m_Slots[m_Head & Mask].m_Sequence.load(std::memory_order_acquire) != m_Head + 1; }
+
+private:
+    static constexpr uint64_t Mask = Capacity - 1;
+
+    struct Slot
+    {
+        std::atomic<uint64_t> m_Sequence;
+        T m_Item;
+    };
+
+    alignas(64) std::atomic<uint64_t> m_Tail;
+    alignas(64) uint64_t m_Head;
+    alignas(64) Slot m_Slots[Capacity];
+};
+} // namespace Ether
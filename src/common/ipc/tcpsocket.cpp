@@ -0,0 +1,239 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/ipc/tcpsocket.h"
+#include "common/logging/loggingmanager.h"
+
+#include <format>
+#include <stdexcept>
+
+#ifdef ETH_PLATFORM_WIN32
+#define NOMINMAX
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef ETH_PLATFORM_WIN32
+using SocketLength = int;
+constexpr uintptr_t InvalidSocket = INVALID_SOCKET;
+constexpr int SendFlags = 0;
+constexpr int ShutdownBoth = SD_BOTH;
+
+inline int GetLastSocketError() { return WSAGetLastError(); }
+inline void CloseSocket(uintptr_t socket) { closesocket(socket); }
+#else
+using SocketLength = socklen_t;
+constexpr int InvalidSocket = -1;
+constexpr int ShutdownBoth = SHUT_RDWR;
+
+// Report a closed peer as a failed send rather than raising SIGPIPE
+constexpr int SendFlags = MSG_NOSIGNAL;
+
+inline int GetLastSocketError() { return errno; }
+inline void CloseSocket(int socket) { close(socket); }
+#endif
+
+// WinSock takes an int length, so large buffers are transferred in several calls
+constexpr size_t MaxTransferSize = 1 << 30;
+} // namespace
+
+Ether::TcpSocket::TcpSocket()
+    : m_ListenSocket(InvalidSocket)
+    , m_ActiveSocket(InvalidSocket)
+    , m_Port(0)
+    , m_HasActiveConnection(false)
+{
+#ifdef ETH_PLATFORM_WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        throw std::runtime_error("Failed to find a suitable WinSock DLL");
+#endif
+}
+
+Ether::TcpSocket::TcpSocket(uint16_t port)
+    : TcpSocket()
+{
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    if ((m_ListenSocket = socket(AF_INET, SOCK_STREAM, 0)) == InvalidSocket)
+        throw std::runtime_error("Failed to create socket descriptor");
+
+#ifndef ETH_PLATFORM_WIN32
+    // Allows the toolmode to be restarted right away, instead of waiting for TIME_WAIT to expire
+    int reuseAddress = 1;
+    setsockopt(m_ListenSocket, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress));
+#endif
+
+    if (bind(m_ListenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+        throw std::runtime_error(std::format("Failed to bind socket on port {}", port));
+
+    if (listen(m_ListenSocket, SOMAXCONN) != 0)
+        throw std::runtime_error("Failed to mark socket as passive (listener)");
+
+    SocketLength addressLength = sizeof(address);
+    getsockname(m_ListenSocket, reinterpret_cast<sockaddr*>(&address), &addressLength);
+    m_Port = ntohs(address.sin_port);
+
+    LogInfo("IPC socket listening on port %u", m_Port);
+}
+
+Ether::TcpSocket::~TcpSocket()
+{
+    Close();
+
+#ifdef ETH_PLATFORM_WIN32
+    WSACleanup();
+#endif
+}
+
+std::unique_ptr<Ether::TcpSocket> Ether::TcpSocket::Connect(const std::string& address, uint16_t port)
+{
+    std::unique_ptr<TcpSocket> tcpSocket(new TcpSocket());
+
+    sockaddr_in peerAddress = {};
+    peerAddress.sin_family = AF_INET;
+    peerAddress.sin_port = htons(port);
+
+    if (inet_pton(AF_INET, address.c_str(), &peerAddress.sin_addr) != 1)
+        throw std::runtime_error(std::format("Invalid IPv4 address {}", address));
+
+    if ((tcpSocket->m_ActiveSocket = socket(AF_INET, SOCK_STREAM, 0)) == InvalidSocket)
+        throw std::runtime_error("Failed to create socket descriptor");
+
+    if (connect(tcpSocket->m_ActiveSocket, reinterpret_cast<sockaddr*>(&peerAddress), sizeof(peerAddress)) != 0)
+        throw std::runtime_error(std::format("Failed to connect to {}:{} ({})", address, port, GetLastSocketError()));
+
+    tcpSocket->m_Port = port;
+    tcpSocket->OnConnected();
+    return tcpSocket;
+}
+
+void Ether::TcpSocket::WaitForConnection()
+{
+    if (m_ListenSocket == InvalidSocket)
+        return;
+
+    if (m_HasActiveConnection)
+    {
+        LogWarning("Socket already has an established connection");
+        return;
+    }
+
+    // The previous connection was lost. Release it before it is replaced by the next one.
+    if (m_ActiveSocket != InvalidSocket)
+    {
+        CloseSocket(m_ActiveSocket);
+        m_ActiveSocket = InvalidSocket;
+    }
+
+    if ((m_ActiveSocket = accept(m_ListenSocket, nullptr, nullptr)) == InvalidSocket)
+        throw std::runtime_error(std::format("Failed to accept incoming IPC connection ({})", GetLastSocketError()));
+
+    OnConnected();
+    LogInfo("IPC socket connected on port %u", m_Port);
+}
+
+void Ether::TcpSocket::Send(const void* data, size_t numBytes)
+{
+    if (!m_HasActiveConnection)
+        throw std::runtime_error("An attempt was made to write to the socket before a connection has been established");
+
+    const char* bytes = static_cast<const char*>(data);
+
+    while (numBytes > 0)
+    {
+        const int sizeToSend = static_cast<int>((std::min)(numBytes, MaxTransferSize));
+        const auto numBytesSent = send(m_ActiveSocket, bytes, sizeToSend, SendFlags);
+
+        if (numBytesSent <= 0)
+        {
+            m_HasActiveConnection = false;
+            throw std::runtime_error("IPC connection was terminated while sending");
+        }
+
+        bytes += numBytesSent;
+        numBytes -= static_cast<size_t>(numBytesSent);
+    }
+}
+
+void Ether::TcpSocket::Receive(void* data, size_t numBytes)
+{
+    if (!m_HasActiveConnection)
+        throw std::runtime_error("An attempt was made to read from the socket before a connection has been established");
+
+    // Received straight into the destination, there is no need for an intermediate buffer
+    char* bytes = static_cast<char*>(data);
+
+    while (numBytes > 0)
+    {
+        const int sizeToReceive = static_cast<int>((std::min)(numBytes, MaxTransferSize));
+        const auto numBytesReceived = recv(m_ActiveSocket, bytes, sizeToReceive, 0);
+
+        if (numBytesReceived <= 0)
+        {
+            m_HasActiveConnection = false;
+            throw std::runtime_error("IPC connection was terminated");
+        }
+
+        bytes += numBytesReceived;
+        numBytes -= static_cast<size_t>(numBytesReceived);
+    }
+}
+
+void Ether::TcpSocket::Close()
+{
+    m_HasActiveConnection = false;
+
+    // Shutting down first also wakes up any thread that is still blocked on the socket
+    if (m_ActiveSocket != InvalidSocket)
+    {
+        shutdown(m_ActiveSocket, ShutdownBoth);
+        CloseSocket(m_ActiveSocket);
+        m_ActiveSocket = InvalidSocket;
+    }
+
+    if (m_ListenSocket != InvalidSocket)
+    {
+        shutdown(m_ListenSocket, ShutdownBoth);
+        CloseSocket(m_ListenSocket);
+        m_ListenSocket = InvalidSocket;
+    }
+}
+
+void Ether::TcpSocket::OnConnected()
+{
+    // Messages are written with a single Send(), so Nagle's algorithm has nothing to coalesce
+    // and would only hold back small requests
+    int noDelay = 1;
+    setsockopt(m_ActiveSocket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+    m_HasActiveConnection = true;
+}
@@ -0,0 +1,74 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+#include "common/ipc/ipctransport.h"
+
+#include <atomic>
+#include <memory>
+
+namespace Ether
+{
+/*
+    TCP transport, implemented on top of WinSock on Windows and BSD sockets elsewhere. The platform
+    headers are kept out of this header, so it can be included anywhere.
+
+    A socket either listens for a single incoming connection (the toolmode waiting for the editor),
+    or is connected to a listening socket through Connect().
+*/
+class ETH_COMMON_DLL TcpSocket : public IpcTransport
+{
+public:
+    // Pass port 0 to listen on any free port (see GetPort())
+    TcpSocket(uint16_t port);
+    ~TcpSocket() override;
+
+    static std::unique_ptr<TcpSocket> Connect(const std::string& address, uint16_t port);
+
+public:
+    inline uint16_t GetPort() const { return m_Port; }
+
+    void WaitForConnection() override;
+    bool HasActiveConnection() const override { return m_HasActiveConnection; }
+
+    void Send(const void* data, size_t numBytes) override;
+    void Receive(void* data, size_t numBytes) override;
+    void Close() override;
+
+private:
+#ifdef ETH_PLATFORM_WIN32
+    using SocketHandle = uintptr_t;
+#else
+    using SocketHandle = int;
+#endif
+
+    TcpSocket();
+
+    void OnConnected();
+
+private:
+    SocketHandle m_ListenSocket;
+    SocketHandle m_ActiveSocket;
+    uint16_t m_Port;
+
+    std::atomic<bool> m_HasActiveConnection;
+};
+} // namespace Ether
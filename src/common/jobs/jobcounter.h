@@ -0,0 +1,49 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "common/common.h"
+
+#include <atomic>
+
+namespace Ether
+{
+/*
+    Tracks the number of outstanding jobs that were scheduled against it. Dependencies
+    between jobs are expressed by waiting on the counter of the jobs that must finish first.
+*/
+class JobCounter : public NonCopyable, public NonMovable
+{
+public:
+    JobCounter()
+        : m_NumPendingJobs(0)
+    {
+    }
+
+    ~JobCounter() = default;
+
+public:
+    inline bool IsDone() const { return m_NumPendingJobs.load(std::memory_order_acquire) == 0; }
+    inline uint32_t GetNumPendingJobs() const { return m_NumPendingJobs.load(std::memory_order_relaxed); }
+
+private:
+    friend class JobSystem;
+    std::atomic<uint32_t> m_NumPendingJobs;
+};
+} // namespace Ether
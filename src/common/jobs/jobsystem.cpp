@@ -0,0 +1,242 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "common/jobs/jobsystem.h"
+#include "common/logging/loggingmanager.h"
+
+namespace
+{
+constexpr uint32_t InvalidThreadIndex = ~0u;
+constexpr uint32_t NumSpinsBeforeSleep = 64;
+
+// Cannot be a static member as thread_local data cannot be exported across the dll boundary
+thread_local uint32_t s_ThreadIndex = InvalidThreadIndex;
+} // namespace
+
+Ether::JobSystem::JobSystem()
+    : m_IsRunning(false)
+    , m_NumQueuedJobs(0)
+    , m_NumUnfinishedJobs(0)
+    , m_NumJobsThisFrame(0)
+    , m_NumJobsLastFrame(0)
+    , m_NumSleepingWorkers(0)
+{
+}
+
+Ether::JobSystem::~JobSystem()
+{
+    Shutdown();
+}
+
+void Ether::JobSystem::Initialize(uint32_t numWorkers)
+{
+    Assert(!m_IsRunning, "Job system is already initialized");
+
+    if (numWorkers == 0)
+        numWorkers = (std::max)(std::thread::hardware_concurrency(), 2u) - 1;
+
+    const uint32_t numThreads = numWorkers + 1;
+    m_ThreadData.resize(numThreads);
+
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        m_ThreadData[i] = std::make_unique<ThreadData>();
+        m_ThreadData[i]->m_JobPool = std::make_unique<Job[]>(MaxJobsPerThread);
+        m_ThreadData[i]->m_NextVictim = i + 1;
+
+        for (uint32_t j = 0; j < MaxJobsPerThread; ++j)
+            m_ThreadData[i]->m_JobPool[j].m_IsPending.store(false, std::memory_order_relaxed);
+    }
+
+    // The initializing thread is treated as the main thread
+    s_ThreadIndex = 0;
+    m_IsRunning.store(true);
+
+    m_WorkerNames.resize(numWorkers);
+    m_Workers.reserve(numWorkers);
+    for (uint32_t i = 0; i < numWorkers; ++i)
+    {
+        m_WorkerNames[i] = "Job Worker " + std::to_string(i);
+        m_Workers.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+    }
+
+    LogInfo("Job system initialized with %u worker threads", numWorkers);
+}
+
+void Ether::JobSystem::Shutdown()
+{
+    if (!m_IsRunning.exchange(false))
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_WakeCondition.notify_all();
+    }
+
+    for (std::thread& worker : m_Workers)
+        worker.join();
+
+    m_Workers.clear();
+    m_WorkerNames.clear();
+    m_ThreadData.clear();
+    s_ThreadIndex = InvalidThreadIndex;
+}
+
+void Ether::JobSystem::Wait(JobCounter& counter)
+{
+    JobSystem& jobSystem = Instance();
+
+    while (!counter.IsDone())
+    {
+        if (!jobSystem.TryExecuteJob())
+            std::this_thread::yield();
+    }
+}
+
+void Ether::JobSystem::NewFrame_Impl()
+{
+    Assert(
+        m_NumUnfinishedJobs.load() == 0,
+        "%u jobs outlived the frame they were scheduled in",
+        m_NumUnfinishedJobs.load());
+
+    m_NumJobsLastFrame = m_NumJobsThisFrame.exchange(0, std::memory_order_relaxed);
+}
+
+Ether::Job* Ether::JobSystem::AllocateJob()
+{
+    ThreadData& threadData = GetCurrentThreadData();
+    uint32_t numPendingSlots = 0;
+
+    // Slots still in flight are skipped rather than waited on, as the job occupying it could be
+    // further down this very thread's stack (nested waits). Help out only once the ring is full.
+    while (true)
+    {
+        Job* job = &threadData.m_JobPool[threadData.m_NextJobIndex++ & (MaxJobsPerThread - 1)];
+
+        if (!job->m_IsPending.load(std::memory_order_acquire))
+        {
+            job->m_IsPending.store(true, std::memory_order_relaxed);
+            return job;
+        }
+
+        if (++numPendingSlots < MaxJobsPerThread)
+            continue;
+
+        if (!TryExecuteJob())
+            std::this_thread::yield();
+
+        numPendingSlots = 0;
+    }
+}
+
+void Ether::JobSystem::Submit(Job* job)
+{
+    m_NumUnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+    m_NumJobsThisFrame.fetch_add(1, std::memory_order_relaxed);
+
+    if (!GetCurrentThreadData().m_Queue.Push(job))
+    {
+        Execute(*job);
+        return;
+    }
+
+    m_NumQueuedJobs.fetch_add(1);
+
+    if (m_NumSleepingWorkers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_WakeCondition.notify_one();
+    }
+}
+
+bool Ether::JobSystem::TryExecuteJob()
+{
+    ThreadData& threadData = GetCurrentThreadData();
+    Job* job = nullptr;
+
+    if (!threadData.m_Queue.Pop(job))
+    {
+        const uint32_t numThreads = static_cast<uint32_t>(m_ThreadData.size());
+        bool hasStolen = false;
+
+        for (uint32_t i = 0; i < numThreads && !hasStolen; ++i)
+        {
+            const uint32_t victim = threadData.m_NextVictim++ % numThreads;
+            if (victim == s_ThreadIndex)
+                continue;
+
+            hasStolen = m_ThreadData[victim]->m_Queue.Steal(job);
+        }
+
+        if (!hasStolen)
+            return false;
+    }
+
+    m_NumQueuedJobs.fetch_sub(1);
+    Execute(*job);
+    return true;
+}
+
+void Ether::JobSystem::Execute(Job& job)
+{
+    {
+        ETH_MARKER_EVENT_DYNAMIC(job.m_Name);
+        job.m_Function(job);
+    }
+
+    JobCounter* counter = job.m_Counter;
+    job.m_IsPending.store(false, std::memory_order_release);
+    m_NumUnfinishedJobs.fetch_sub(1, std::memory_order_relaxed);
+    counter->m_NumPendingJobs.fetch_sub(1, std::memory_order_release);
+}
+
+void Ether::JobSystem::WorkerMain(uint32_t threadIndex)
+{
+    ETH_MARKER_THREAD(m_WorkerNames[threadIndex - 1].c_str());
+    s_ThreadIndex = threadIndex;
+
+    uint32_t numFailedAttempts = 0;
+
+    while (m_IsRunning.load(std::memory_order_acquire))
+    {
+        if (TryExecuteJob())
+        {
+            numFailedAttempts = 0;
+            continue;
+        }
+
+        if (++numFailedAttempts < NumSpinsBeforeSleep)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_NumSleepingWorkers.fetch_add(1);
+        m_WakeCondition.wait(lock, [this]() { return m_NumQueuedJobs.load() > 0 || !m_IsRunning.load(); });
+        m_NumSleepingWorkers.fetch_sub(1);
+        numFailedAttempts = 0;
+    }
+}
+
+Ether::JobSystem::ThreadData& Ether::JobSystem::GetCurrentThreadData()
+{
+    Assert(s_ThreadIndex != InvalidThreadIndex, "Jobs can only be scheduled from the main or worker threads");
+    return *m_ThreadData[s_ThreadIndex];
+}
@@ -0,0 +1,167 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "common/common.h"
+#include "common/jobs/jobcounter.h"
+#include "common/jobs/workstealingqueue.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Ether
+{
+struct alignas(64) Job
+{
+    using Function = void (*)(Job&);
+    static constexpr size_t PayloadSize = 96;
+
+    Function m_Function;
+    JobCounter* m_Counter;
+    const char* m_Name;
+    std::atomic<bool> m_IsPending;
+    alignas(16) uint8_t m_Payload[PayloadSize];
+};
+
+/*
+    Engine-wide task runtime.
+
+    Each thread (main thread included) owns a work stealing queue and a ring of job slots.
+    Jobs are allocated from the ring of the thread that schedules them and recycled once
+    executed, so scheduling never touches the heap. Jobs are frame scoped: every job must be
+    waited on before the frame that created it ends.
+
+    Threads that wait on a counter execute pending jobs instead of blocking.
+*/
+class ETH_COMMON_DLL JobSystem : public Singleton<JobSystem>
+{
+public:
+    JobSystem();
+    ~JobSystem();
+
+    // Defaults to one worker per hardware thread not taken by the calling (main) thread
+    void Initialize(uint32_t numWorkers = 0);
+    void Shutdown();
+
+public:
+    static inline void NewFrame() { Instance().NewFrame_Impl(); }
+    static inline uint32_t GetNumThreads() { return static_cast<uint32_t>(Instance().m_ThreadData.size()); }
+    static inline uint32_t GetNumJobsLastFrame() { return Instance().m_NumJobsLastFrame; }
+
+    // Captures are copied into the job slot and must be trivially destructible
+    template <typename Func>
+    static void Run(const char* name, JobCounter& counter, Func&& func);
+
+    // Invokes func(begin, end) over [0, count) split into chunks across all threads. Blocks until done.
+    template <typename Func>
+    static void ParallelFor(const char* name, uint32_t count, Func&& func, uint32_t minChunkSize = 1);
+
+    static void Wait(JobCounter& counter);
+
+public:
+    static constexpr uint32_t MaxJobsPerThread = 4096;
+    static constexpr uint32_t ChunksPerThread = 4;
+
+private:
+    struct ThreadData
+    {
+        WorkStealingQueue<Job*, MaxJobsPerThread> m_Queue;
+        std::unique_ptr<Job[]> m_JobPool;
+        uint32_t m_NextJobIndex = 0;
+        uint32_t m_NextVictim = 0;
+    };
+
+private:
+    void NewFrame_Impl();
+
+    Job* AllocateJob();
+    void Submit(Job* job);
+    bool TryExecuteJob();
+    void Execute(Job& job);
+    void WorkerMain(uint32_t threadIndex);
+    ThreadData& GetCurrentThreadData();
+
+private:
+    std::vector<std::unique_ptr<ThreadData>> m_ThreadData;
+    std::vector<std::thread> m_Workers;
+    std::vector<std::string> m_WorkerNames;
+
+    std::atomic<bool> m_IsRunning;
+    std::atomic<uint32_t> m_NumQueuedJobs;
+    std::atomic<uint32_t> m_NumUnfinishedJobs;
+    std::atomic<uint32_t> m_NumJobsThisFrame;
+    uint32_t m_NumJobsLastFrame;
+
+    std::atomic<uint32_t> m_NumSleepingWorkers;
+    std::mutex m_WakeMutex;
+    std::condition_variable m_WakeCondition;
+};
+
+template <typename Func>
+void JobSystem::Run(const char* name, JobCounter& counter, Func&& func)
+{
+    using FuncType = std::decay_t<Func>;
+    static_assert(sizeof(FuncType) <= Job::PayloadSize, "Job captures too large, capture by reference instead");
+    static_assert(alignof(FuncType) <= 16, "Job captures are over-aligned");
+    static_assert(std::is_trivially_destructible_v<FuncType>, "Job slots are recycled without destruction");
+
+    JobSystem& jobSystem = Instance();
+    Job* job = jobSystem.AllocateJob();
+    job->m_Function = [](Job& self) { (*reinterpret_cast<FuncType*>(self.m_Payload))(); };
+    job->m_Counter = &counter;
+    job->m_Name = name;
+    new (job->m_Payload) FuncType(std::forward<Func>(func));
+
+    counter.m_NumPendingJobs.fetch_add(1, std::memory_order_relaxed);
+    jobSystem.Submit(job);
+}
+
+template <typename Func>
+void JobSystem::ParallelFor(const char* name, uint32_t count, Func&& func, uint32_t minChunkSize)
+{
+    if (count == 0)
+        return;
+
+    const uint32_t maxChunks = GetNumThreads() * ChunksPerThread;
+    const uint32_t numChunks = std::clamp(count / (std::max)(minChunkSize, 1u), 1u, maxChunks);
+    const uint32_t chunkSize = (count + numChunks - 1) / numChunks;
+
+    if (numChunks == 1)
+    {
+        ETH_MARKER_EVENT_DYNAMIC(name);
+        func(0u, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (uint32_t begin = 0; begin < count; begin += chunkSize)
+    {
+        const uint32_t end = (std::min)(begin + chunkSize, count);
+        Run(name, counter, [&func, begin, end]() { func(begin, end); });
+    }
+
+    Wait(counter);
+}
+} // namespace Ether
@@ -0,0 +1,132 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "common/common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+namespace Ether
+{
+/*
+    Fixed capacity Chase-Lev work stealing deque (Le, Pop, Cohen, Zappa Nardelli 2013).
+
+    The owning thread pushes and pops from the bottom in LIFO order, which keeps recently
+    spawned (and still cache-warm) work local. Any other thread may steal from the top in
+    FIFO order. Items must be trivially copyable as slots are read speculatively by thieves.
+*/
+template <typename T, uint32_t Capacity>
+class WorkStealingQueue : public NonCopyable, public NonMovable
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Work stealing queue capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "Work stealing queue items must be trivially copyable");
+
+public:
+    WorkStealingQueue()
+        : m_Top(0)
+        , m_Bottom(0)
+    {
+    }
+
+    ~WorkStealingQueue() = default;
+
+public:
+    // Owner thread only. Returns false if the queue is full.
+    bool Push(T item)
+    {
+        const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_Top.load(std::memory_order_acquire);
+
+        if (bottom - top >= static_cast<int64_t>(Capacity))
+            return false;
+
+        m_Items[bottom & Mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner thread only
+    bool Pop(T& item)
+    {
+        const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+        m_Bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_Top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = m_Items[bottom & Mask].load(std::memory_order_relaxed);
+
+        if (top != bottom)
+            return true;
+
+        // Last item in the queue, race against thieves for it
+        const bool won = m_Top.compare_exchange_strong(
+            top,
+            top + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed);
+
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    // Any thread
+    bool Steal(T& item)
+    {
+        int64_t top = m_Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+            return false;
+
+        T stolen = m_Items[top & Mask].load(std::memory_order_relaxed);
+
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false;
+
+        item = stolen;
+        return true;
+    }
+
+    // Approximate when called from a thread other than the owner
+    inline uint32_t GetSize() const
+    {
+        const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_Top.load(std::memory_order_relaxed);
+        return static_cast<uint32_t>((std::max)(bottom - top, int64_t(0)));
+    }
+
+private:
+    static constexpr int64_t Mask = Capacity - 1;
+
+    // Keep the ends on separate cache lines so that thieves do not false-share with the owner
+    alignas(64) std::atomic<int64_t> m_Top;
+    alignas(64) std::atomic<int64_t> m_Bottom;
+    alignas(64) std::atomic<T> m_Items[Capacity];
+};
+} // namespace Ether
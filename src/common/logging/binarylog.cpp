@@ -0,0 +1,276 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/logging/binarylog.h"
+
+#include <cstdio>
+
+namespace
+{
+struct DeferredArg
+{
+    Ether::BinaryLogArgType m_Type;
+    uint64_t m_Value;
+    std::string_view m_String;
+};
+
+bool ReadArg(const uint8_t*& cur, const uint8_t* end, DeferredArg& arg)
+{
+    if (cur >= end)
+        return false;
+
+    arg.m_Type = static_cast<Ether::BinaryLogArgType>(*cur++);
+
+    if (arg.m_Type == Ether::BinaryLogArgType::String)
+    {
+        uint16_t length;
+        if (cur + sizeof(length) > end)
+            return false;
+
+        memcpy(&length, cur, sizeof(length));
+        cur += sizeof(length);
+
+        if (cur + length > end)
+            return false;
+
+        arg.m_String = std::string_view(reinterpret_cast<const char*>(cur), length);
+        cur += length;
+        return true;
+    }
+
+    if (cur + sizeof(uint64_t) > end)
+        return false;
+
+    memcpy(&arg.m_Value, cur, sizeof(uint64_t));
+    cur += sizeof(uint64_t);
+    return true;
+}
+
+int64_t GetArgAsInt(const DeferredArg& arg)
+{
+    if (arg.m_Type == Ether::BinaryLogArgType::Double)
+    {
+        double d;
+        memcpy(&d, &arg.m_Value, sizeof(d));
+        return static_cast<int64_t>(d);
+    }
+
+    return static_cast<int64_t>(arg.m_Value);
+}
+
+double GetArgAsDouble(const DeferredArg& arg)
+{
+    double d;
+    switch (arg.m_Type)
+    {
+    case Ether::BinaryLogArgType::Double:
+        memcpy(&d, &arg.m_Value, sizeof(d));
+        return d;
+    case Ether::BinaryLogArgType::Int:
+        return static_cast<double>(static_cast<int64_t>(arg.m_Value));
+    default:
+        return static_cast<double>(arg.m_Value);
+    }
+}
+
+template <typename... Args>
+void AppendFormatted(std::string& out, const std::string& spec, Args... values)
+{
+    char buffer[256];
+    const int length = snprintf(buffer, sizeof(buffer), spec.c_str(), values...);
+
+    if (length < 0)
+        return;
+
+    if (length < static_cast<int>(sizeof(buffer)))
+    {
+        out.append(buffer, length);
+        return;
+    }
+
+    std::string large(length + 1, '\0');
+    snprintf(large.data(), large.size(), spec.c_str(), values...);
+    out.append(large.data(), length);
+}
+} // namespace
+
+std::string Ether::BinaryLog::Format(const char* fmt, const uint8_t* args, size_t argsSize)
+{
+    const uint8_t* cur = args;
+    const uint8_t* end = args + argsSize;
+    std::string out;
+    out.reserve(strlen(fmt) + argsSize);
+
+    for (const char* c = fmt; *c != '\0'; ++c)
+    {
+        if (*c != '%')
+        {
+            out += *c;
+            continue;
+        }
+
+        if (c[1] == '%')
+        {
+            out += '%';
+            ++c;
+            continue;
+        }
+
+        // Rebuild the conversion without its length modifier, as arguments are widened when encoded
+        std::string spec = "%";
+        DeferredArg arg;
+
+        for (++c; *c != '\0' && strchr("-+ #0", *c) != nullptr; ++c)
+            spec += *c;
+
+        for (; *c == '*' || (*c >= '0' && *c <= '9'); ++c)
+        {
+            if (*c == '*')
+                spec += ReadArg(cur, end, arg) ? std::to_string(GetArgAsInt(arg)) : "0";
+            else
+                spec += *c;
+        }
+
+        if (*c == '.')
+        {
+            for (spec += *c++; *c == '*' || (*c >= '0' && *c <= '9'); ++c)
+            {
+                if (*c == '*')
+                    spec += ReadArg(cur, end, arg) ? std::to_string(GetArgAsInt(arg)) : "0";
+                else
+                    spec += *c;
+            }
+        }
+
+        if (strncmp(c, "I64", 3) == 0 || strncmp(c, "I32", 3) == 0)
+            c += 3;
+        while (*c != '\0' && strchr("hlzjtLIq", *c) != nullptr)
+            ++c;
+
+        const char conversion = *c;
+        if (conversion == '\0')
+            break;
+
+        if (conversion == 'n')
+            continue;
+
+        if (!ReadArg(cur, end, arg))
+        {
+            out += "<missing>";
+            continue;
+        }
+
+        switch (conversion)
+        {
+        case 'd':
+        case 'i':
+            AppendFormatted(out, spec + "ll" + conversion, static_cast<long long>(GetArgAsInt(arg)));
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            AppendFormatted(out, spec + "ll" + conversion, static_cast<unsigned long long>(GetArgAsInt(arg)));
+            break;
+        case 'c':
+            AppendFormatted(out, spec + conversion, static_cast<int>(GetArgAsInt(arg)));
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            AppendFormatted(out, spec + conversion, GetArgAsDouble(arg));
+            break;
+        case 'p':
+            AppendFormatted(out, spec + conversion, reinterpret_cast<const void*>(arg.m_Value));
+            break;
+        case 's':
+            if (arg.m_Type == BinaryLogArgType::String)
+                AppendFormatted(out, spec + ".*s", static_cast<int>(arg.m_String.size()), arg.m_String.data());
+            else
+                out += "<?>";
+            break;
+        default:
+            out += spec + conversion;
+            break;
+        }
+    }
+
+    return out;
+}
+
+bool Ether::BinaryLogReader::Open(const std::string& path)
+{
+    m_Stream.open(path, std::ios::binary);
+    if (!m_Stream.is_open())
+        return false;
+
+    m_Stream.read(reinterpret_cast<char*>(&m_Header), sizeof(m_Header));
+    return m_Stream.good() && m_Header.m_Magic == BinaryLogMagic && m_Header.m_Version == BinaryLogVersion;
+}
+
+bool Ether::BinaryLogReader::ReadNext(DecodedLogRecord& record)
+{
+    while (true)
+    {
+        BinaryLogRecordHeader header;
+        m_Stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!m_Stream.good() || header.m_Size < sizeof(header))
+            return false;
+
+        const size_t paddedSize = AlignUp(static_cast<size_t>(header.m_Size), BinaryLogRecordAlignment);
+        m_Payload.resize(paddedSize - sizeof(header));
+        m_Stream.read(reinterpret_cast<char*>(m_Payload.data()), m_Payload.size());
+        if (!m_Stream.good())
+            return false;
+
+        const size_t payloadSize = header.m_Size - sizeof(header);
+        const char* payloadText = reinterpret_cast<const char*>(m_Payload.data());
+
+        record.m_Level = header.m_Level;
+        record.m_Type = header.m_Type;
+        record.m_ThreadIndex = header.m_ThreadIndex;
+        record.m_Time = header.m_Time;
+
+        switch (header.m_Kind)
+        {
+        case BinaryLogRecordKind::Format:
+            m_Formats[header.m_FormatId] = std::string(payloadText, payloadSize);
+            break;
+        case BinaryLogRecordKind::Text:
+            record.m_Text = std::string(payloadText, payloadSize);
+            return true;
+        case BinaryLogRecordKind::Deferred:
+        {
+            auto format = m_Formats.find(header.m_FormatId);
+            record.m_Text = format == m_Formats.end()
+                                ? "<unknown format>"
+                                : BinaryLog::Format(format->second.c_str(), m_Payload.data(), payloadSize);
+            return true;
+        }
+        case BinaryLogRecordKind::Padding:
+        default:
+            break;
+        }
+    }
+}
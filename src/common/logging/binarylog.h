@@ -0,0 +1,193 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+#include "common/logging/logentry.h"
+
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace Ether
+{
+/*
+    Binary log format. A file is a BinaryLogFileHeader followed by a stream of records, each of
+    which is a BinaryLogRecordHeader and a payload, padded to BinaryLogRecordAlignment. The same
+    records are used in the per-thread log rings, so draining a ring is a straight copy to disk.
+
+    Deferred records carry a format string id and the raw arguments instead of text. The format
+    string itself is written once per file as a Format record with the same id, and the text is
+    only produced when the log is displayed or decoded.
+*/
+constexpr uint32_t BinaryLogMagic = 0x474f4c45; // 'ELOG'
+constexpr uint32_t BinaryLogVersion = 1;
+constexpr size_t BinaryLogRecordAlignment = 8;
+constexpr size_t BinaryLogMaxStringArgLength = 256;
+
+enum class BinaryLogRecordKind : uint8_t
+{
+    Padding,
+    Text,
+    Format,
+    Deferred,
+};
+
+enum class BinaryLogArgType : uint8_t
+{
+    Int,
+    Uint,
+    Double,
+    Pointer,
+    String,
+};
+
+struct BinaryLogFileHeader
+{
+    uint32_t m_Magic;
+    uint32_t m_Version;
+    uint64_t m_StartTime; // Microseconds since epoch
+};
+
+struct BinaryLogRecordHeader
+{
+    uint16_t m_Size; // Including the header, excluding padding
+    BinaryLogRecordKind m_Kind;
+    LogLevel m_Level;
+    LogType m_Type;
+    uint8_t m_NumArgs;
+    uint16_t m_ThreadIndex;
+    uint64_t m_Time; // Microseconds since epoch
+    uint64_t m_FormatId;
+};
+
+static_assert(sizeof(BinaryLogRecordHeader) == 24, "Binary log record header layout changed, bump BinaryLogVersion");
+
+namespace BinaryLog
+{
+template <typename T>
+constexpr bool IsStringArg = std::is_convertible_v<const T&, const char*> || std::is_same_v<T, std::string>;
+
+template <typename T>
+inline const char* GetStringArg(const T& arg)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+        return arg.c_str();
+    else
+        return arg;
+}
+
+template <typename T>
+inline size_t GetArgSize(const T& arg)
+{
+    if constexpr (IsStringArg<T>)
+    {
+        const char* str = GetStringArg(arg);
+        return 1 + sizeof(uint16_t) + (str == nullptr ? 0 : strnlen(str, BinaryLogMaxStringArgLength));
+    }
+    else
+        return 1 + sizeof(uint64_t);
+}
+
+template <typename T>
+inline void WriteArg(uint8_t*& dst, const T& arg)
+{
+    static_assert(
+        IsStringArg<T> || std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>,
+        "Deferred log arguments must be strings, numbers, enums or pointers");
+
+    if constexpr (IsStringArg<T>)
+    {
+        const char* str = GetStringArg(arg);
+        const uint16_t length = static_cast<uint16_t>(str == nullptr ? 0 : strnlen(str, BinaryLogMaxStringArgLength));
+        *dst++ = static_cast<uint8_t>(BinaryLogArgType::String);
+        memcpy(dst, &length, sizeof(length));
+        memcpy(dst + sizeof(length), str, length);
+        dst += sizeof(length) + length;
+    }
+    else
+    {
+        uint64_t value = 0;
+        BinaryLogArgType argType = BinaryLogArgType::Uint;
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            const double d = arg;
+            memcpy(&value, &d, sizeof(d));
+            argType = BinaryLogArgType::Double;
+        }
+        else if constexpr (std::is_pointer_v<T>)
+        {
+            value = reinterpret_cast<uint64_t>(arg);
+            argType = BinaryLogArgType::Pointer;
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            value = static_cast<uint64_t>(static_cast<std::underlying_type_t<T>>(arg));
+            argType = std::is_signed_v<std::underlying_type_t<T>> ? BinaryLogArgType::Int : BinaryLogArgType::Uint;
+        }
+        else
+        {
+            value = static_cast<uint64_t>(arg);
+            argType = std::is_signed_v<T> ? BinaryLogArgType::Int : BinaryLogArgType::Uint;
+        }
+
+        *dst++ = static_cast<uint8_t>(argType);
+        memcpy(dst, &value, sizeof(value));
+        dst += sizeof(value);
+    }
+}
+
+// Replays a printf style format string against encoded deferred arguments
+ETH_COMMON_DLL std::string Format(const char* fmt, const uint8_t* args, size_t argsSize);
+} // namespace BinaryLog
+
+struct DecodedLogRecord
+{
+    std::string m_Text;
+    LogLevel m_Level;
+    LogType m_Type;
+    uint16_t m_ThreadIndex;
+    uint64_t m_Time;
+};
+
+class ETH_COMMON_DLL BinaryLogReader : public NonCopyable
+{
+public:
+    BinaryLogReader() = default;
+    ~BinaryLogReader() = default;
+
+public:
+    bool Open(const std::string& path);
+    // Skips over format records. Returns false at the end of the file, or if the file is truncated.
+    bool ReadNext(DecodedLogRecord& record);
+
+    inline uint64_t GetStartTime() const { return m_Header.m_StartTime; }
+
+private:
+    std::ifstream m_Stream;
+    BinaryLogFileHeader m_Header;
+    std::unordered_map<uint64_t, std::string> m_Formats;
+    std::vector<uint8_t> m_Payload;
+};
+} // namespace Ether
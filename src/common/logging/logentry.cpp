@@ -24,7 +24,15 @@ Ether::LogEntry::LogEntry(const std::string& text, LogLevel level, LogType type)
     : m_Text(text)
     , m_Level(level)
     , m_Type(type)
-    , m_Time(Time::GetCurrentTime() / 1000.0)
+    , m_Time(Time::GetWallTime() / 1000.0)
+{
+}
+
+Ether::LogEntry::LogEntry(const std::string& text, LogLevel level, LogType type, uint64_t time)
+    : m_Text(text)
+    , m_Level(level)
+    , m_Type(type)
+    , m_Time(time)
 {
 }
 
@@ -23,7 +23,7 @@
 
 namespace Ether
 {
-enum class LogLevel
+enum class LogLevel : uint8_t
 {
     Info,
     Warning,
@@ -31,7 +31,7 @@ enum class LogLevel
     Fatal
 };
 
-enum class LogType
+enum class LogType : uint8_t
 {
     Engine,
     Graphics,
@@ -40,10 +40,11 @@ enum class LogType
     None,
 };
 
-class LogEntry
+class ETH_COMMON_DLL LogEntry
 {
 public:
     LogEntry(const std::string& text, LogLevel level, LogType type);
+    LogEntry(const std::string& text, LogLevel level, LogType type, uint64_t time);
 
     std::string GetText() const;
     std::string GetFullText() const;
@@ -1,107 +1,306 @@
-/*
-    This file is part of Ether, an open-source DirectX 12 renderer.
-
-    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
-
-    Ether is free software: you can redistribute it and/or modify
-    it under the terms of the GNU General Public License as published by
-    the Free Software Foundation, either version 3 of the License, or
-    (at your option) any later version.
-
-    This program is distributed in the hope that it will be useful,
-    but WITHOUT ANY WARRANTY; without even the implied warranty of
-    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
-    GNU General Public License for more details.
-
-    You should have received a copy of the GNU General Public License
-    along with this program. If not, see <http://www.gnu.org/licenses/>.
-*/
-
-#include "common/logging/loggingmanager.h"
-#include "common/time/time.h"
-
-#include <stdarg.h>
-#include <sstream>
-#include <filesystem>
-
-#ifdef ETH_PLATFORM_WIN32
-#define _AMD64_       // So we don't have to include <windows.h> here
-#include <debugapi.h> // For OutputDebugStringA
-#endif
-
-constexpr uint32_t MaxLogEntries = 512;
-constexpr std::string_view OutputFilePath = ".\\Logs";
-constexpr std::string_view OutputFileSuffix = ".log";
-
-Ether::LoggingManager::~LoggingManager()
-{
-    m_LogFileStream.close();
-}
-
-void Ether::LoggingManager::Initialize()
-{
-#if defined(ETH_PLATFORM_WIN32)
-    std::filesystem::create_directory(OutputFilePath);
-    m_LogFileStream.open(GetOutputDirectory() + "/" + GetTimestampedFileName(), std::ios_base::app);
-
-    if (!m_LogFileStream.is_open())
-        LogWarning("Unable to open log file for serialization.Logs will be lost when the application exits");
-#endif
-}
-
-void Ether::LoggingManager::Log(LogLevel level, LogType type, const char* fmt, ...)
-{
-    char formattedBuffer[4096];
-
-    va_list args;
-    va_start(args, fmt);
-    vsprintf_s(formattedBuffer, fmt, args);
-    va_end(args);
-
-    std::string formattedText(formattedBuffer);
-
-    std::stringstream ss(formattedText);
-    std::string individualLine;
-
-    while (std::getline(ss, individualLine, '\n'))
-    {
-        LogEntry entry(individualLine, level, type);
-
-        AddLog(entry);
-        Serialize(entry);
-    }
-}
-
-void Ether::LoggingManager::AddLog(const LogEntry entry)
-{
-    std::lock_guard<std::mutex> lock(m_Mutex);
-
-    if (m_LogEntries.size() > MaxLogEntries)
-        m_LogEntries.pop_front();
-
-    m_LogEntries.emplace_back(entry);
-}
-
-void Ether::LoggingManager::Serialize(const LogEntry entry)
-{
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    m_LogFileStream << entry.GetFullText().c_str() << "\n";
-    m_LogFileStream.flush();
-    OutputDebugStringA((entry.GetFullText() + "\n").c_str());
-}
-
-void Ether::LoggingManager::Clear()
-{
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    m_LogEntries.clear();
-}
-
-const std::string Ether::LoggingManager::GetOutputDirectory() const
-{
-    return std::string(OutputFilePath);
-}
-
-const std::string Ether::LoggingManager::GetTimestampedFileName() const
-{
-    return std::to_string(Time::GetStartupTime()) + std::string(OutputFileSuffix);
-}
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/logging/loggingmanager.h"
+#include "common/time/time.h"
+
+#include <stdarg.h>
+#include <chrono>
+#include <filesystem>
+
+#ifdef ETH_PLATFORM_WIN32
+#define _AMD64_       // So we don't have to include <windows.h> here
+#include <debugapi.h> // For OutputDebugStringA and IsDebuggerPresent
+#endif
+
+constexpr std::string_view OutputFilePath = ".\\Logs";
+constexpr std::string_view OutputFileSuffix = ".elog";
+constexpr std::chrono::milliseconds WriterThreadInterval(5);
+
+namespace
+{
+struct ThreadLogState
+{
+    uint64_t m_InstanceId = 0;
+    Ether::LoggingManager::ThreadLogRing* m_Ring = nullptr;
+};
+
+std::atomic<uint64_t> s_NextInstanceId = 1;
+
+uint64_t GetTimeMicroseconds()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+// Cannot be a static member as thread_local data cannot be exported across the dll boundary.
+// Tagged with the owning instance, so that a recreated logging manager does not see stale rings.
+thread_local ThreadLogState s_ThreadLogState;
+
+Ether::LoggingManager::LoggingManager()
+    : m_InstanceId(s_NextInstanceId++)
+    , m_RecentRecords(std::make_unique<ThreadLogRing>(0))
+    , m_RingsMemory(MemoryTag::Logging)
+    , m_IsWriterRunning(false)
+    , m_NumRecordsWritten(0)
+    , m_NumProducerStalls(0)
+{
+}
+
+Ether::LoggingManager::~LoggingManager()
+{
+    if (m_WriterThread.joinable())
+    {
+        m_IsWriterRunning = false;
+        m_WakeCondition.notify_one();
+        m_WriterThread.join();
+    }
+
+    Flush();
+    m_LogFileStream.close();
+}
+
+void Ether::LoggingManager::Initialize()
+{
+#if defined(ETH_PLATFORM_WIN32)
+    std::filesystem::create_directory(OutputFilePath);
+    m_LogFileStream.open(GetOutputDirectory() + "/" + GetTimestampedFileName(), std::ios_base::binary);
+
+    if (!m_LogFileStream.is_open())
+        LogWarning("Unable to open log file for serialization.Logs will be lost when the application exits");
+    else
+    {
+        const BinaryLogFileHeader header = { BinaryLogMagic, BinaryLogVersion, GetTimeMicroseconds() };
+        m_LogFileStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+#endif
+
+    m_IsWriterRunning = true;
+    m_WriterThread = std::thread(&LoggingManager::WriterThread, this);
+}
+
+void Ether::LoggingManager::Log(LogLevel level, LogType type, const char* fmt, ...)
+{
+    char formattedBuffer[4096];
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(formattedBuffer, sizeof(formattedBuffer), fmt, args);
+    va_end(args);
+
+    for (const char* line = formattedBuffer; *line != '\0';)
+    {
+        const char* lineEnd = strchr(line, '\n');
+        const size_t length = lineEnd != nullptr ? lineEnd - line : strlen(line);
+
+        uint8_t* dst = BeginRecord(BinaryLogRecordKind::Text, level, type, length, nullptr, 0);
+        memcpy(dst, line, length);
+        EndRecord(level);
+
+        if (lineEnd == nullptr)
+            break;
+
+        line = lineEnd + 1;
+    }
+}
+
+void Ether::LoggingManager::Flush()
+{
+    std::lock_guard<std::mutex> drainLock(m_DrainMutex);
+
+    {
+        std::lock_guard<std::mutex> ringsLock(m_RingsMutex);
+        for (size_t i = m_DrainList.size(); i < m_Rings.size(); ++i)
+            m_DrainList.push_back(m_Rings[i].get());
+    }
+
+    size_t numRecords = 0;
+    for (ThreadLogRing* ring : m_DrainList)
+        numRecords += ring->Drain([this](const BinaryLogRecordHeader& record) { WriteRecord(record); });
+
+    if (numRecords > 0)
+        m_LogFileStream.flush();
+}
+
+uint8_t* Ether::LoggingManager::BeginRecord(
+    BinaryLogRecordKind kind,
+    LogLevel level,
+    LogType type,
+    size_t payloadSize,
+    const char* fmt,
+    uint32_t numArgs)
+{
+    ThreadLogRing& ring = GetThreadRing();
+    const size_t recordSize = sizeof(BinaryLogRecordHeader) + payloadSize;
+    BinaryLogRecordHeader* record = ring.BeginWrite(recordSize);
+
+    // The writer has fallen behind. Wake it up and wait rather than drop the record.
+    while (record == nullptr)
+    {
+        m_NumProducerStalls.fetch_add(1, std::memory_order_relaxed);
+
+        if (m_IsWriterRunning)
+        {
+            m_WakeCondition.notify_one();
+            std::this_thread::yield();
+        }
+        else
+            Flush();
+
+        record = ring.BeginWrite(recordSize);
+    }
+
+    record->m_Size = static_cast<uint16_t>(recordSize);
+    record->m_Kind = kind;
+    record->m_Level = level;
+    record->m_Type = type;
+    record->m_NumArgs = static_cast<uint8_t>(numArgs);
+    record->m_ThreadIndex = ring.GetThreadIndex();
+    record->m_Time = GetTimeMicroseconds();
+    record->m_FormatId = reinterpret_cast<uint64_t>(fmt);
+
+    return reinterpret_cast<uint8_t*>(record + 1);
+}
+
+void Ether::LoggingManager::EndRecord(LogLevel level)
+{
+    GetThreadRing().EndWrite();
+
+    if (level == LogLevel::Fatal)
+        Flush();
+}
+
+Ether::LoggingManager::ThreadLogRing& Ether::LoggingManager::GetThreadRing()
+{
+    if (s_ThreadLogState.m_InstanceId == m_InstanceId)
+        return *s_ThreadLogState.m_Ring;
+
+    std::lock_guard<std::mutex> lock(m_RingsMutex);
+    m_Rings.emplace_back(std::make_unique<ThreadLogRing>(static_cast<uint16_t>(m_Rings.size())));
+    m_RingsMemory.Set((m_Rings.size() + 1) * sizeof(ThreadLogRing)); // Including the recent records
+    s_ThreadLogState = { m_InstanceId, m_Rings.back().get() };
+    return *m_Rings.back();
+}
+
+void Ether::LoggingManager::WriterThread()
+{
+    ETH_MARKER_THREAD("Log Writer");
+
+    while (m_IsWriterRunning)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_WakeMutex);
+            m_WakeCondition.wait_for(lock, WriterThreadInterval);
+        }
+
+        Flush();
+    }
+}
+
+void Ether::LoggingManager::WriteRecord(const BinaryLogRecordHeader& record)
+{
+    static constexpr char padding[BinaryLogRecordAlignment] = {};
+
+    if (record.m_Kind == BinaryLogRecordKind::Deferred)
+    {
+        const char* fmt = reinterpret_cast<const char*>(record.m_FormatId);
+
+        // Format strings are only written out the first time they are used
+        if (m_WrittenFormats.insert(record.m_FormatId).second && m_LogFileStream.is_open())
+        {
+            const size_t length = strnlen(fmt, ThreadLogRing::MaxRecordSize - sizeof(BinaryLogRecordHeader));
+            BinaryLogRecordHeader formatRecord = record;
+            formatRecord.m_Kind = BinaryLogRecordKind::Format;
+            formatRecord.m_NumArgs = 0;
+            formatRecord.m_Size = static_cast<uint16_t>(sizeof(BinaryLogRecordHeader) + length);
+
+            m_LogFileStream.write(reinterpret_cast<const char*>(&formatRecord), sizeof(formatRecord));
+            m_LogFileStream.write(fmt, length);
+            m_LogFileStream.write(padding, AlignUp(size_t(formatRecord.m_Size), BinaryLogRecordAlignment) - formatRecord.m_Size);
+        }
+    }
+
+    if (m_LogFileStream.is_open())
+    {
+        m_LogFileStream.write(reinterpret_cast<const char*>(&record), record.m_Size);
+        m_LogFileStream.write(padding, AlignUp(size_t(record.m_Size), BinaryLogRecordAlignment) - record.m_Size);
+    }
+
+    AddRecentRecord(record);
+
+#ifdef ETH_PLATFORM_WIN32
+    // The only text produced while writing, and only when someone is there to read it
+    if (IsDebuggerPresent())
+        OutputDebugStringA((FormatRecord(record).GetFullText() + "\n").c_str());
+#endif
+
+    m_NumRecordsWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Ether::LoggingManager::AddRecentRecord(const BinaryLogRecordHeader& record)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    BinaryLogRecordHeader* dst = m_RecentRecords->BeginWrite(record.m_Size);
+    while (dst == nullptr && m_RecentRecords->DropOldest())
+        dst = m_RecentRecords->BeginWrite(record.m_Size);
+
+    memcpy(dst, &record, record.m_Size);
+    m_RecentRecords->EndWrite();
+}
+
+std::vector<Ether::LogEntry> Ether::LoggingManager::GetRecentEntries() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::vector<LogEntry> entries;
+    m_RecentRecords->Peek([&entries](const BinaryLogRecordHeader& record) { entries.push_back(FormatRecord(record)); });
+    return entries;
+}
+
+void Ether::LoggingManager::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    while (m_RecentRecords->DropOldest());
+}
+
+Ether::LogEntry Ether::LoggingManager::FormatRecord(const BinaryLogRecordHeader& record)
+{
+    const uint8_t* payload = reinterpret_cast<const uint8_t*>(&record + 1);
+    const size_t payloadSize = record.m_Size - sizeof(BinaryLogRecordHeader);
+
+    if (record.m_Kind == BinaryLogRecordKind::Deferred)
+    {
+        const char* fmt = reinterpret_cast<const char*>(record.m_FormatId);
+        return { BinaryLog::Format(fmt, payload, payloadSize), record.m_Level, record.m_Type, record.m_Time / 1000000 };
+    }
+
+    return { std::string(reinterpret_cast<const char*>(payload), payloadSize), record.m_Level, record.m_Type, record.m_Time / 1000000 };
+}
+
+const std::string Ether::LoggingManager::GetOutputDirectory() const
+{
+    return std::string(OutputFilePath);
+}
+
+const std::string Ether::LoggingManager::GetTimestampedFileName() const
+{
+    return std::to_string(Time::GetStartupWallTime()) + std::string(OutputFileSuffix);
+}
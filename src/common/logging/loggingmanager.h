@@ -21,16 +21,34 @@
 
 #include "common/common.h"
 #include "common/logging/logentry.h"
+#include "common/logging/binarylog.h"
+#include "common/logging/logring.h"
+#include "common/memory/memorytracker.h"
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
-#include <deque>
 #include <mutex>
+#include <thread>
+#include <unordered_set>
 
 namespace Ether
 {
+/*
+    Logging never touches the file or the debugger on the calling thread. Records are pushed into
+    a lock-free ring owned by the calling thread, and a writer thread drains every ring into a
+    binary log (see binarylog.h) which can be turned back into text with the LogDecoder tool.
+
+    Log() formats on the calling thread. LogDeferred() only copies the arguments, and leaves the
+    formatting to whoever reads the log; its format string must outlive the logging manager (i.e.
+    be a string literal). The writer keeps the most recent records as they are, and they are only
+    turned into text when GetRecentEntries() is called.
+
+    Fatal entries flush synchronously, so they are on disk before the assert that follows them.
+*/
 class ETH_COMMON_DLL LoggingManager : public Singleton<LoggingManager>
 {
 public:
-    LoggingManager() = default;
+    LoggingManager();
     ~LoggingManager();
 
     void Initialize();
@@ -38,21 +56,72 @@ public:
 public:
     void Log(LogLevel level, LogType type, const char* fmt, ...);
 
+    template <typename... Args>
+    void LogDeferred(LogLevel level, LogType type, const char* fmt, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= 32, "Too many deferred log arguments");
+
+        const size_t argsSize = (BinaryLog::GetArgSize(args) + ... + size_t(0));
+        uint8_t* dst = BeginRecord(BinaryLogRecordKind::Deferred, level, type, argsSize, fmt, sizeof...(Args));
+        (BinaryLog::WriteArg(dst, args), ...);
+        EndRecord(level);
+    }
+
+    // Blocks until every record pushed so far has been written to disk
+    void Flush();
+
+    // Formats the most recent records on the calling thread, oldest first
+    std::vector<LogEntry> GetRecentEntries() const;
+
+public:
+    inline uint64_t GetNumRecordsWritten() const { return m_NumRecordsWritten.load(std::memory_order_relaxed); }
+    inline uint64_t GetNumProducerStalls() const { return m_NumProducerStalls.load(std::memory_order_relaxed); }
+
+public:
+    static constexpr uint32_t RingCapacity = 64 * 1024;
+    using ThreadLogRing = LogRing<RingCapacity>;
+
 private:
-    void AddLog(const LogEntry entry);
-    void Serialize(const LogEntry entry);
+    uint8_t* BeginRecord(BinaryLogRecordKind kind, LogLevel level, LogType type, size_t payloadSize, const char* fmt, uint32_t numArgs);
+    void EndRecord(LogLevel level);
+    ThreadLogRing& GetThreadRing();
+
+    void WriterThread();
+    void WriteRecord(const BinaryLogRecordHeader& record);
+    void AddRecentRecord(const BinaryLogRecordHeader& record);
     void Clear();
 
-    inline const std::deque<LogEntry>& GetEntries() const { return m_LogEntries; }
+    static LogEntry FormatRecord(const BinaryLogRecordHeader& record);
 
 private:
     const std::string GetOutputDirectory() const;
     const std::string GetTimestampedFileName() const;
 
 private:
-    std::deque<LogEntry> m_LogEntries;
+    const uint64_t m_InstanceId;
+
+    // Only written by whoever drains the rings. Full records are dropped from the front to make space.
+    std::unique_ptr<ThreadLogRing> m_RecentRecords;
     std::ofstream m_LogFileStream;
-    std::mutex m_Mutex;
+    mutable std::mutex m_Mutex;
+
+    // Rings are never freed before the logging manager, as records may still be pending after their thread exits
+    std::vector<std::unique_ptr<ThreadLogRing>> m_Rings;
+    std::mutex m_RingsMutex;
+    TrackedMemory m_RingsMemory;
+
+    // Held by whoever is draining the rings, which is usually the writer thread
+    std::mutex m_DrainMutex;
+    std::vector<ThreadLogRing*> m_DrainList;
+    std::unordered_set<uint64_t> m_WrittenFormats;
+
+    std::thread m_WriterThread;
+    std::atomic<bool> m_IsWriterRunning;
+    std::condition_variable m_WakeCondition;
+    std::mutex m_WakeMutex;
+
+    std::atomic<uint64_t> m_NumRecordsWritten;
+    std::atomic<uint64_t> m_NumProducerStalls;
 };
 
 } // namespace Ether
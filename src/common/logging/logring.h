@@ -0,0 +1,179 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+#include "common/logging/binarylog.h"
+
+#include <atomic>
+
+namespace Ether
+{
+/*
+    Single producer, single consumer ring of binary log records. Each logging thread owns one and
+    the log writer drains them all, so neither side ever takes a lock.
+
+    Records are contiguous in the buffer. A record that does not fit before the end of the buffer
+    is written at the start instead, and the gap is marked with a padding record (or skipped
+    implicitly if it is too small to hold a record header).
+*/
+template <uint32_t Capacity>
+class LogRing : public NonCopyable, public NonMovable
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Log ring capacity must be a power of two");
+    static_assert(Capacity <= (std::numeric_limits<uint16_t>::max)() + 1, "Record sizes are stored in 16 bits");
+
+public:
+    LogRing(uint16_t threadIndex)
+        : m_WritePos(0)
+        , m_CachedReadPos(0)
+        , m_PendingSize(0)
+        , m_ReadPos(0)
+        , m_ThreadIndex(threadIndex)
+    {
+    }
+
+    ~LogRing() = default;
+
+public:
+    static constexpr size_t MaxRecordSize = Capacity / 4;
+
+    inline uint16_t GetThreadIndex() const { return m_ThreadIndex; }
+
+    // Producer only. Returns nullptr if the ring is full. The record is not visible to the
+    // consumer until it is published with EndWrite().
+    BinaryLogRecordHeader* BeginWrite(size_t recordSize)
+    {
+        assert(recordSize <= MaxRecordSize && "Log record too large");
+
+        const size_t writePos = m_WritePos.load(std::memory_order_relaxed);
+        const size_t alignedSize = AlignUp(recordSize, BinaryLogRecordAlignment);
+        const size_t sizeUntilWrap = Capacity - (writePos & Mask);
+        const size_t padding = sizeUntilWrap < alignedSize ? sizeUntilWrap : 0;
+
+        if (writePos + padding + alignedSize - m_CachedReadPos > Capacity)
+        {
+            m_CachedReadPos = m_ReadPos.load(std::memory_order_acquire);
+            if (writePos + padding + alignedSize - m_CachedReadPos > Capacity)
+                return nullptr;
+        }
+
+        if (padding >= sizeof(BinaryLogRecordHeader))
+        {
+            BinaryLogRecordHeader* paddingRecord = reinterpret_cast<BinaryLogRecordHeader*>(&m_Buffer[writePos & Mask]);
+            paddingRecord->m_Size = static_cast<uint16_t>(padding);
+            paddingRecord->m_Kind = BinaryLogRecordKind::Padding;
+        }
+
+        m_PendingSize = padding + alignedSize;
+        return reinterpret_cast<BinaryLogRecordHeader*>(&m_Buffer[(writePos + padding) & Mask]);
+    }
+
+    // Producer only
+    void EndWrite()
+    {
+        m_WritePos.store(m_WritePos.load(std::memory_order_relaxed) + m_PendingSize, std::memory_order_release);
+        m_PendingSize = 0;
+    }
+
+    // Consumer only. Calls func(const BinaryLogRecordHeader&) for every published record, in order.
+    template <typename Func>
+    size_t Drain(Func&& func)
+    {
+        const size_t writePos = m_WritePos.load(std::memory_order_acquire);
+        size_t readPos = m_ReadPos.load(std::memory_order_relaxed);
+        size_t numRecords = 0;
+
+        while (readPos < writePos)
+        {
+            const BinaryLogRecordHeader* record = GetRecord(readPos);
+            if (record == nullptr)
+                continue;
+
+            func(*record);
+            numRecords++;
+        }
+
+        m_ReadPos.store(readPos, std::memory_order_release);
+        return numRecords;
+    }
+
+    // Consumer only. Same as Drain(), but leaves the records in the ring.
+    template <typename Func>
+    void Peek(Func&& func) const
+    {
+        const size_t writePos = m_WritePos.load(std::memory_order_acquire);
+
+        for (size_t readPos = m_ReadPos.load(std::memory_order_relaxed); readPos < writePos;)
+        {
+            const BinaryLogRecordHeader* record = GetRecord(readPos);
+            if (record != nullptr)
+                func(*record);
+        }
+    }
+
+    // Consumer only. Drops the oldest published record, so that a full ring can be used as a history.
+    bool DropOldest()
+    {
+        const size_t writePos = m_WritePos.load(std::memory_order_acquire);
+        size_t readPos = m_ReadPos.load(std::memory_order_relaxed);
+
+        while (readPos < writePos)
+        {
+            if (GetRecord(readPos) != nullptr)
+            {
+                m_ReadPos.store(readPos, std::memory_order_release);
+                return true;
+            }
+        }
+
+        m_ReadPos.store(readPos, std::memory_order_release);
+        return false;
+    }
+
+private:
+    // Returns the record at readPos and moves readPos past it, or nullptr if there is only padding
+    const BinaryLogRecordHeader* GetRecord(size_t& readPos) const
+    {
+        const size_t sizeUntilWrap = Capacity - (readPos & Mask);
+        if (sizeUntilWrap < sizeof(BinaryLogRecordHeader))
+        {
+            readPos += sizeUntilWrap;
+            return nullptr;
+        }
+
+        const BinaryLogRecordHeader* record = reinterpret_cast<const BinaryLogRecordHeader*>(&m_Buffer[readPos & Mask]);
+        readPos += AlignUp(static_cast<size_t>(record->m_Size), BinaryLogRecordAlignment);
+        return record->m_Kind == BinaryLogRecordKind::Padding ? nullptr : record;
+    }
+
+private:
+    static constexpr size_t Mask = Capacity - 1;
+
+    alignas(64) std::atomic<size_t> m_WritePos;
+    size_t m_CachedReadPos;
+    size_t m_PendingSize;
+
+    alignas(64) std::atomic<size_t> m_ReadPos;
+    const uint16_t m_ThreadIndex;
+
+    alignas(64) uint8_t m_Buffer[Capacity];
+};
+} // namespace Ether
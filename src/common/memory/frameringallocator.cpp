@@ -0,0 +1,118 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/memory/frameringallocator.h"
+
+Ether::FrameRingAllocator::FrameRingAllocator(size_t capacity)
+    : MemoryAllocator(capacity)
+    , m_Head(0)
+    , m_Tail(0)
+    , m_FrameBegin(0)
+    , m_FrameEnd(0)
+{
+}
+
+Ether::AllocationHandle Ether::FrameRingAllocator::Allocate(SizeAlign sizeAlign)
+{
+    assert(m_Capacity % sizeAlign.m_Alignment == 0 && "FrameRingAllocator - Capacity must be a multiple of the alignment");
+
+    const size_t alignedSize = AlignUp((std::max)(sizeAlign.m_Size, size_t(1)), sizeAlign.m_Alignment);
+
+    // Aligns the head that was actually observed, so that no padding is reserved unless it is needed.
+    // Retries only when another thread moved the head in between.
+    size_t begin = m_Head.load(std::memory_order_relaxed);
+    size_t alignedBegin;
+
+    do
+    {
+        alignedBegin = AlignUp(begin, sizeAlign.m_Alignment);
+        if (alignedBegin + alignedSize > m_FrameEnd)
+            return {};
+    } while (!m_Head.compare_exchange_weak(begin, alignedBegin + alignedSize, std::memory_order_relaxed));
+
+    return CreateHandle(alignedBegin % m_Capacity, alignedSize);
+}
+
+void Ether::FrameRingAllocator::Free(const AllocationHandle& alloc)
+{
+    // Do nothing
+    throw std::runtime_error("Free is not supported by frame ring allocator. Allocations are reclaimed with their frame.");
+}
+
+bool Ether::FrameRingAllocator::HasSpace(SizeAlign sizeAlign) const
+{
+    const size_t alignedBegin = AlignUp(m_Head.load(std::memory_order_relaxed), sizeAlign.m_Alignment);
+    return alignedBegin + AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment) <= m_FrameEnd;
+}
+
+void Ether::FrameRingAllocator::Reset()
+{
+    m_Head.store(0, std::memory_order_relaxed);
+    m_Tail = 0;
+    m_FrameBegin = 0;
+    m_FrameEnd = 0;
+    m_PendingFrames = {};
+    m_Generation++;
+}
+
+void Ether::FrameRingAllocator::BeginFrame(uint64_t completedFenceValue)
+{
+    while (!m_PendingFrames.empty() && m_PendingFrames.front().m_FenceValue <= completedFenceValue)
+    {
+        m_Tail = m_PendingFrames.front().m_End;
+        m_PendingFrames.pop();
+    }
+
+    size_t head = m_Head.load(std::memory_order_relaxed);
+    size_t ringOffset = head % m_Capacity;
+
+    // Nothing in flight, restart from the beginning of the ring
+    if (m_PendingFrames.empty() && ringOffset != 0)
+    {
+        head += m_Capacity - ringOffset;
+        m_Tail = head;
+        ringOffset = 0;
+    }
+
+    const size_t freeSize = m_Capacity - (head - m_Tail);
+    const size_t sizeUntilWrap = (std::min)(freeSize, m_Capacity - ringOffset);
+    size_t frameSize = sizeUntilWrap;
+
+    // A frame range cannot wrap. If more space was freed at the start of the ring than is left
+    // at its end, skip the end. The skipped range is retired together with this frame.
+    if (freeSize - sizeUntilWrap > sizeUntilWrap)
+    {
+        head += m_Capacity - ringOffset;
+        frameSize = freeSize - sizeUntilWrap;
+    }
+
+    m_FrameBegin = head;
+    m_FrameEnd = head + frameSize;
+    m_Head.store(head, std::memory_order_relaxed);
+}
+
+void Ether::FrameRingAllocator::EndFrame(uint64_t fenceValue)
+{
+    const size_t head = m_Head.load(std::memory_order_relaxed);
+
+    m_PendingFrames.push({ head, fenceValue });
+    m_Head.store(head, std::memory_order_relaxed);
+    m_FrameBegin = head;
+    m_FrameEnd = head;
+}
@@ -0,0 +1,74 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/memory/memoryallocator.h"
+#include <atomic>
+#include <queue>
+
+namespace Ether
+{
+/**
+ * Ring of per-frame linear ranges. BeginFrame() hands the frame the largest contiguous range that
+ * is not still in use by the GPU, and allocations move an atomic head within that range with a CAS,
+ * so any number of recording threads can allocate without taking a lock. A frame's range is reclaimed
+ * once the fence value it was closed with in EndFrame() has been reached.
+ *
+ * BeginFrame(), EndFrame() and Reset() must not race with Allocate().
+ */
+class ETH_COMMON_DLL FrameRingAllocator : public MemoryAllocator
+{
+public:
+    FrameRingAllocator(size_t capacity);
+    ~FrameRingAllocator() = default;
+
+public:
+    // Thread safe. Returns an invalid handle if the current frame's range is exhausted. A failed
+    // allocation leaves the head where it was, so smaller allocations may still fit.
+    AllocationHandle Allocate(SizeAlign sizeAlign) override;
+    void Free(const AllocationHandle& alloc) override;
+    bool HasSpace(SizeAlign sizeAlign) const override;
+    void Reset() override;
+
+public:
+    void BeginFrame(uint64_t completedFenceValue);
+    void EndFrame(uint64_t fenceValue);
+
+    inline size_t GetFrameCapacity() const { return m_FrameEnd - m_FrameBegin; }
+    inline size_t GetFrameSize() const { return m_Head.load(std::memory_order_relaxed) - m_FrameBegin; }
+    inline size_t GetNumPendingFrames() const { return m_PendingFrames.size(); }
+    inline size_t GetUsedSize() const { return m_Head.load(std::memory_order_relaxed) - m_Tail; }
+
+private:
+    struct PendingFrame
+    {
+        size_t m_End;
+        uint64_t m_FenceValue;
+    };
+
+    // Positions only ever increase and are wrapped into the ring when a handle is created
+    std::atomic<size_t> m_Head;
+    size_t m_Tail;
+    size_t m_FrameBegin;
+    size_t m_FrameEnd;
+
+    std::queue<PendingFrame> m_PendingFrames;
+};
+} // namespace Ether
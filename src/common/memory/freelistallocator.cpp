@@ -25,11 +25,11 @@ Ether::FreeListAllocator::FreeListAllocator(size_t capacity)
     AddBlock(0, capacity);
 }
 
-std::unique_ptr<Ether::MemoryAllocation> Ether::FreeListAllocator::Allocate(SizeAlign sizeAlign)
+Ether::AllocationHandle Ether::FreeListAllocator::Allocate(SizeAlign sizeAlign)
 {
     auto smallestFreeBlockIter = FindFreeBlock(sizeAlign);
     if (smallestFreeBlockIter == nullptr)
-        return nullptr;
+        return {};
 
     uint32_t blockSize = smallestFreeBlockIter->m_Size;
     uint32_t offset = smallestFreeBlockIter->m_SizeToOffsetIter->second->first;
@@ -51,12 +51,13 @@ std::unique_ptr<Ether::MemoryAllocation> Ether::FreeListAllocator::Allocate(Size
     if (remainingSize > 0)
         AddBlock(alignedOffset + alignedSize, remainingSize);
 
-    return std::make_unique<FreeListAllocation>(alignedOffset, alignedSize);
+    return CreateHandle(alignedOffset, alignedSize);
 }
 
-void Ether::FreeListAllocator::Free(std::unique_ptr<MemoryAllocation>&& alloc)
+void Ether::FreeListAllocator::Free(const AllocationHandle& alloc)
 {
-    FreeBlock(alloc->GetOffset(), alloc->GetSize());
+    assert(Owns(alloc) && "FreeListAllocator - Allocation does not belong to this allocator");
+    FreeBlock(alloc.m_Offset, alloc.m_Size);
 }
 
 bool Ether::FreeListAllocator::HasSpace(SizeAlign sizeAlign) const
@@ -69,6 +70,7 @@ void Ether::FreeListAllocator::Reset()
     m_OffsetToBlockMap.clear();
     m_SizeToOffsetMap.clear();
     AddBlock(0, m_Capacity);
+    m_Generation++;
 }
 
 Ether::FreeListAllocator::FreeBlockInfo* Ether::FreeListAllocator::FindFreeBlock(SizeAlign sizeAlign) const
@@ -110,14 +112,14 @@ void Ether::FreeListAllocator::FreeBlock(size_t offset, size_t size)
     // The previous block is exactly behind the block that is to be freed.
     if (prevBlockIter != m_OffsetToBlockMap.end() && offset == prevBlockIter->first + prevBlockIter->second.m_Size)
     {
-        MergeBlock(prevBlockIter, { offset, size });
+        MergeBlock(prevBlockIter, offset, size);
         return;
     }
 
     // The next block is exactly in front of the block that is to be freed.
     if (nextBlockIter != m_OffsetToBlockMap.end() && offset + size == nextBlockIter->first)
     {
-        MergeBlock(nextBlockIter, { offset, size });
+        MergeBlock(nextBlockIter, offset, size);
         return;
     }
 
@@ -125,15 +127,14 @@ void Ether::FreeListAllocator::FreeBlock(size_t offset, size_t size)
     AddBlock(offset, size);
 }
 
-void Ether::FreeListAllocator::MergeBlock(OffsetToBlockMap::iterator blockIter, FreeListAllocation newBlock)
+void Ether::FreeListAllocator::MergeBlock(OffsetToBlockMap::iterator blockIter, size_t offset, size_t size)
 {
     assert(
-        (newBlock.GetOffset() + newBlock.GetSize() == blockIter->first ||
-         blockIter->first + blockIter->second.m_Size == newBlock.GetOffset()) &&
+        (offset + size == blockIter->first || blockIter->first + blockIter->second.m_Size == offset) &&
         "FreeListAllocator - Misaligned blocks cannot be merged");
 
-    size_t newSize = newBlock.GetSize() + blockIter->second.m_Size;
-    size_t newOffset = (newBlock.GetOffset() < blockIter->first) ? newBlock.GetOffset() : blockIter->first;
+    size_t newSize = size + blockIter->second.m_Size;
+    size_t newOffset = (offset < blockIter->first) ? offset : blockIter->first;
 
     m_SizeToOffsetMap.erase(blockIter->second.m_SizeToOffsetIter);
     m_OffsetToBlockMap.erase(blockIter);
@@ -29,26 +29,6 @@ namespace Ether
  * Inspired by DiligentGraphics
  * http://diligentgraphics.com/diligent-engine/architecture/d3d12/variable-size-memory-allocations-manager/
  */
-class ETH_COMMON_DLL FreeListAllocation : public MemoryAllocation
-{
-public:
-    FreeListAllocation() = default;
-    FreeListAllocation(size_t offset, size_t size)
-        : m_Offset(offset)
-        , m_Size(size)
-    {
-    }
-    ~FreeListAllocation() override {}
-
-    virtual size_t GetOffset() const override { return m_Offset; }
-    virtual size_t GetSize() const override { return m_Size; }
-    virtual void* GetBaseCpuHandle() const override { return nullptr; }
-
-protected:
-    size_t m_Offset;
-    size_t m_Size;
-};
-
 class ETH_COMMON_DLL FreeListAllocator : public MemoryAllocator
 {
 public:
@@ -56,8 +36,8 @@ public:
     ~FreeListAllocator() = default;
 
 public:
-    std::unique_ptr<MemoryAllocation> Allocate(SizeAlign sizeAlign) override;
-    void Free(std::unique_ptr<MemoryAllocation>&& alloc) override;
+    AllocationHandle Allocate(SizeAlign sizeAlign) override;
+    void Free(const AllocationHandle& alloc) override;
     bool HasSpace(SizeAlign sizeAlign) const override;
     void Reset() override;
 
@@ -79,7 +59,7 @@ protected:
     FreeBlockInfo* FindFreeBlock(SizeAlign sizeAlign) const;
     void AddBlock(size_t offset, size_t size);
     void FreeBlock(size_t offset, size_t size);
-    void MergeBlock(OffsetToBlockMap::iterator existingBlock, FreeListAllocation newBlock);
+    void MergeBlock(OffsetToBlockMap::iterator existingBlock, size_t offset, size_t size);
 
 protected:
     OffsetToBlockMap m_OffsetToBlockMap;
@@ -18,6 +18,7 @@
 */
 
 #include "linearallocator.h"
+#include <algorithm>
 
 static constexpr size_t InternalAlignment = 32;
 
@@ -27,19 +28,19 @@ Ether::LinearAllocator::LinearAllocator(size_t capacity)
 {
 }
 
-std::unique_ptr<Ether::MemoryAllocation> Ether::LinearAllocator::Allocate(SizeAlign sizeAlign)
+Ether::AllocationHandle Ether::LinearAllocator::Allocate(SizeAlign sizeAlign)
 {
     if (!HasSpace(sizeAlign))
-        return nullptr;
+        return {};
 
-    size_t alignedOffset = AlignUp(m_Offset, InternalAlignment);
+    size_t alignedOffset = AlignUp(m_Offset, std::max(InternalAlignment, sizeAlign.m_Alignment));
     size_t alignedSize = AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment);
 
     m_Offset = alignedOffset + alignedSize;
-    return std::make_unique<Ether::LinearAllocation>(alignedOffset, alignedSize);
+    return CreateHandle(alignedOffset, alignedSize);
 }
 
-void Ether::LinearAllocator::Free(std::unique_ptr<MemoryAllocation>&& alloc)
+void Ether::LinearAllocator::Free(const AllocationHandle& alloc)
 {
     // Do nothing
     throw std::runtime_error("Free is not supported by linear allocator. Reset the allocator once full.");
@@ -48,11 +49,12 @@ void Ether::LinearAllocator::Free(std::unique_ptr<MemoryAllocation>&& alloc)
 bool Ether::LinearAllocator::HasSpace(SizeAlign sizeAlign) const
 {
     size_t alignedSize = AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment);
-    size_t alignedOffset = AlignUp(m_Offset, InternalAlignment);
+    size_t alignedOffset = AlignUp(m_Offset, std::max(InternalAlignment, sizeAlign.m_Alignment));
     return alignedOffset + alignedSize <= m_Capacity;
 }
 
 void Ether::LinearAllocator::Reset()
 {
     m_Offset = 0;
+    m_Generation++;
 }
@@ -23,26 +23,6 @@
 
 namespace Ether
 {
-class ETH_COMMON_DLL LinearAllocation : public MemoryAllocation
-{
-public:
-    LinearAllocation() = default;
-    LinearAllocation(size_t offset, size_t size)
-        : m_Offset(offset)
-        , m_Size(size)
-    {
-    }
-    ~LinearAllocation() override {}
-
-    virtual size_t GetOffset() const override { return m_Offset; }
-    virtual size_t GetSize() const override { return m_Size; }
-    virtual void* GetBaseCpuHandle() const override { return nullptr; }
-
-protected:
-    size_t m_Offset;
-    size_t m_Size;
-};
-
 class ETH_COMMON_DLL LinearAllocator : public MemoryAllocator
 {
 public:
@@ -50,8 +30,8 @@ public:
     ~LinearAllocator() = default;
 
 public:
-    std::unique_ptr<MemoryAllocation> Allocate(SizeAlign sizeAlign) override;
-    void Free(std::unique_ptr<MemoryAllocation>&& alloc) override;
+    AllocationHandle Allocate(SizeAlign sizeAlign) override;
+    void Free(const AllocationHandle& alloc) override;
     bool HasSpace(SizeAlign sizeAlign) const override;
     void Reset() override;
 
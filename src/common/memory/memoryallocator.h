@@ -35,17 +35,22 @@ struct ETH_COMMON_DLL SizeAlign
     size_t m_Alignment;
 };
 
-class ETH_COMMON_DLL MemoryAllocation
+class MemoryAllocator;
+
+/*
+    Allocations are handed out by value, so that sub-allocating never touches the heap.
+    The owner and generation let allocators reject handles that belong to another allocator,
+    or that were handed out before the allocator was last reset.
+*/
+struct AllocationHandle
 {
-public:
-    MemoryAllocation() = default;
-    virtual ~MemoryAllocation() = default;
+    size_t m_Offset = 0;
+    size_t m_Size = 0;
+    uint32_t m_BlockIndex = 0; // Allocator specific bookkeeping (e.g. the block that backs the allocation)
+    uint32_t m_Generation = 0;
+    const MemoryAllocator* m_Owner = nullptr;
 
-public:
-    virtual size_t GetOffset() const = 0;
-    virtual size_t GetSize() const = 0;
-    virtual void* GetBaseCpuHandle() const = 0;
-    virtual void* GetCpuHandle() const { return (uint8_t*)GetBaseCpuHandle() + GetOffset(); }
+    inline bool IsValid() const { return m_Owner != nullptr; }
 };
 
 class ETH_COMMON_DLL MemoryAllocator : public NonCopyable, public NonMovable
@@ -53,18 +58,34 @@ class ETH_COMMON_DLL MemoryAllocator : public NonCopyable, public NonMovable
 public:
     MemoryAllocator(size_t capacity)
         : m_Capacity(capacity)
+        , m_Generation(0)
     {
     }
 
     virtual ~MemoryAllocator() = default;
 
 public:
-    virtual std::unique_ptr<MemoryAllocation> Allocate(SizeAlign sizeAlign) = 0;
-    virtual void Free(std::unique_ptr<MemoryAllocation>&& alloc) = 0;
+    // Returns an invalid handle if there is not enough space left
+    virtual AllocationHandle Allocate(SizeAlign sizeAlign) = 0;
+    virtual void Free(const AllocationHandle& alloc) = 0;
     virtual bool HasSpace(SizeAlign sizeAlign) const = 0;
     virtual void Reset() = 0;
 
+public:
+    inline size_t GetCapacity() const { return m_Capacity; }
+    inline bool Owns(const AllocationHandle& alloc) const
+    {
+        return alloc.m_Owner == this && alloc.m_Generation == m_Generation;
+    }
+
+protected:
+    inline AllocationHandle CreateHandle(size_t offset, size_t size, uint32_t blockIndex = 0) const
+    {
+        return { offset, size, blockIndex, m_Generation, this };
+    }
+
 protected:
     size_t m_Capacity;
+    uint32_t m_Generation;
 };
 } // namespace Ether
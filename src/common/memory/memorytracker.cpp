@@ -0,0 +1,194 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/memory/memorytracker.h"
+#include "common/logging/loggingmanager.h"
+
+#include <cstdlib>
+
+static constexpr size_t NumTags = static_cast<size_t>(Ether::MemoryTag::NumTags);
+
+namespace
+{
+struct alignas(64) TagCounters
+{
+    std::atomic<size_t> m_LiveBytes;
+    std::atomic<size_t> m_PeakBytes;
+    std::atomic<uint64_t> m_NumLiveAllocations;
+    std::atomic<uint64_t> m_NumAllocations;
+    std::atomic<uint64_t> m_NumAllocatedBytes;
+};
+
+struct AllocationHeader
+{
+    size_t m_Size;
+    Ether::MemoryTag m_Tag;
+};
+
+static_assert(sizeof(AllocationHeader) <= Ether::MemoryTracker::HeaderSize);
+} // namespace
+
+// Static storage is zero initialized before any code runs, so this is usable from static constructors
+static TagCounters s_Counters[NumTags];
+
+// Only touched by NewFrame() and GetSnapshot() on the main thread
+static uint64_t s_FrameNumber = 0;
+static uint64_t s_NumAllocationsAtFrameStart[NumTags];
+static uint64_t s_NumAllocatedBytesAtFrameStart[NumTags];
+static uint64_t s_NumFrameAllocations[NumTags];
+static uint64_t s_NumFrameAllocatedBytes[NumTags];
+
+const char* Ether::GetMemoryTagName(MemoryTag tag)
+{
+    switch (tag)
+    {
+    case MemoryTag::Ecs:
+        return "ECS";
+    case MemoryTag::Resources:
+        return "Resources";
+    case MemoryTag::Streams:
+        return "Streams";
+    case MemoryTag::GraphicsStaging:
+        return "Graphics Staging";
+    case MemoryTag::Logging:
+        return "Logging";
+    default:
+        return "Unknown";
+    }
+}
+
+void* Ether::MemoryTracker::Allocate(size_t size, MemoryTag tag)
+{
+    void* block = std::malloc(size + HeaderSize);
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(block);
+    header->m_Size = size;
+    header->m_Tag = tag;
+
+    s_Counters[static_cast<size_t>(tag)].m_NumLiveAllocations.fetch_add(1, std::memory_order_relaxed);
+    OnAllocated(tag, size);
+
+    return static_cast<uint8_t*>(block) + HeaderSize;
+}
+
+void Ether::MemoryTracker::Free(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(static_cast<uint8_t*>(ptr) - HeaderSize);
+
+    s_Counters[static_cast<size_t>(header->m_Tag)].m_NumLiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    OnFreed(header->m_Tag, header->m_Size);
+
+    std::free(header);
+}
+
+void Ether::MemoryTracker::OnAllocated(MemoryTag tag, size_t size)
+{
+    TagCounters& counters = s_Counters[static_cast<size_t>(tag)];
+    counters.m_NumAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.m_NumAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    const size_t liveBytes = counters.m_LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peakBytes = counters.m_PeakBytes.load(std::memory_order_relaxed);
+
+    // Only contended while the peak is actually rising
+    while (liveBytes > peakBytes &&
+           !counters.m_PeakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+void Ether::MemoryTracker::OnFreed(MemoryTag tag, size_t size)
+{
+    s_Counters[static_cast<size_t>(tag)].m_LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void Ether::MemoryTracker::NewFrame()
+{
+    for (size_t i = 0; i < NumTags; ++i)
+    {
+        const uint64_t numAllocations = s_Counters[i].m_NumAllocations.load(std::memory_order_relaxed);
+        const uint64_t numAllocatedBytes = s_Counters[i].m_NumAllocatedBytes.load(std::memory_order_relaxed);
+
+        s_NumFrameAllocations[i] = numAllocations - s_NumAllocationsAtFrameStart[i];
+        s_NumFrameAllocatedBytes[i] = numAllocatedBytes - s_NumAllocatedBytesAtFrameStart[i];
+        s_NumAllocationsAtFrameStart[i] = numAllocations;
+        s_NumAllocatedBytesAtFrameStart[i] = numAllocatedBytes;
+    }
+
+    s_FrameNumber++;
+}
+
+Ether::MemorySnapshot Ether::MemoryTracker::GetSnapshot()
+{
+    MemorySnapshot snapshot = {};
+    snapshot.m_FrameNumber = s_FrameNumber;
+
+    for (size_t i = 0; i < NumTags; ++i)
+    {
+        MemoryTagStats& stats = snapshot.m_Tags[i];
+        stats.m_LiveBytes = s_Counters[i].m_LiveBytes.load(std::memory_order_relaxed);
+        stats.m_PeakBytes = s_Counters[i].m_PeakBytes.load(std::memory_order_relaxed);
+        stats.m_NumLiveAllocations = s_Counters[i].m_NumLiveAllocations.load(std::memory_order_relaxed);
+        stats.m_NumAllocations = s_Counters[i].m_NumAllocations.load(std::memory_order_relaxed);
+        stats.m_NumAllocatedBytes = s_Counters[i].m_NumAllocatedBytes.load(std::memory_order_relaxed);
+        stats.m_NumFrameAllocations = s_NumFrameAllocations[i];
+        stats.m_NumFrameAllocatedBytes = s_NumFrameAllocatedBytes[i];
+    }
+
+    return snapshot;
+}
+
+bool Ether::MemoryTracker::ReportLeaks()
+{
+    const MemorySnapshot snapshot = GetSnapshot();
+    bool isClean = true;
+
+    for (size_t i = 0; i < NumTags; ++i)
+    {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        const MemoryTagStats& stats = snapshot.m_Tags[i];
+
+        LogInfo(
+            "Memory: %s peaked at %.2f MiB over %llu allocations",
+            GetMemoryTagName(tag),
+            stats.m_PeakBytes / static_cast<double>(_1MiB),
+            static_cast<unsigned long long>(stats.m_NumAllocations));
+
+        if (tag == MemoryTag::Logging || (stats.m_LiveBytes == 0 && stats.m_NumLiveAllocations == 0))
+            continue;
+
+        LogWarning(
+            "Memory: %s still owns %.2f KiB in %llu allocations at shutdown",
+            GetMemoryTagName(tag),
+            stats.m_LiveBytes / static_cast<double>(_1KiB),
+            static_cast<unsigned long long>(stats.m_NumLiveAllocations));
+
+        isClean = false;
+    }
+
+    if (isClean)
+        LogInfo("Memory: No leaks found");
+
+    return isClean;
+}
@@ -0,0 +1,170 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+
+#include <atomic>
+#include <memory>
+
+namespace Ether
+{
+enum class MemoryTag : uint8_t
+{
+    Ecs,
+    Resources,
+    Streams,
+    GraphicsStaging,
+    Logging,
+
+    NumTags
+};
+
+ETH_COMMON_DLL const char* GetMemoryTagName(MemoryTag tag);
+
+struct MemoryTagStats
+{
+    size_t m_LiveBytes;
+    size_t m_PeakBytes;
+    uint64_t m_NumLiveAllocations;
+
+    // Since startup
+    uint64_t m_NumAllocations;
+    uint64_t m_NumAllocatedBytes;
+
+    // During the last complete frame (see MemoryTracker::NewFrame())
+    uint64_t m_NumFrameAllocations;
+    uint64_t m_NumFrameAllocatedBytes;
+};
+
+struct MemorySnapshot
+{
+    uint64_t m_FrameNumber;
+    MemoryTagStats m_Tags[static_cast<size_t>(MemoryTag::NumTags)];
+
+    inline const MemoryTagStats& Get(MemoryTag tag) const { return m_Tags[static_cast<size_t>(tag)]; }
+};
+
+/*
+    Per-tag accounting of CPU memory owned by engine subsystems. Cheap enough (a few relaxed atomics
+    per allocation, no locks, no per-allocation bookkeeping) to stay enabled in release builds.
+
+    Memory either comes from Allocate()/Free(), which store the tag and size in a small header in
+    front of the allocation, or is allocated elsewhere and reported through TrackedMemory or
+    TrackingAllocator (e.g. std containers, upload heaps).
+
+    State is static rather than a Singleton, so that allocations made before the engine starts up
+    or after it shuts down are still accounted for.
+*/
+class ETH_COMMON_DLL MemoryTracker
+{
+public:
+    // Allocations are aligned to 16 bytes
+    static void* Allocate(size_t size, MemoryTag tag);
+    static void Free(void* ptr);
+
+    static void OnAllocated(MemoryTag tag, size_t size);
+    static void OnFreed(MemoryTag tag, size_t size);
+
+public:
+    // Closes the current frame and starts counting allocations into the next one. Main thread only.
+    static void NewFrame();
+
+    // Live and total counters as of now, with the per-frame counters of the last complete frame
+    static MemorySnapshot GetSnapshot();
+
+    // Logs every tag that still owns memory. Returns false if anything was found. Logging is
+    // still running while the report is written, so the logging tag is not considered a leak.
+    static bool ReportLeaks();
+
+public:
+    static constexpr size_t HeaderSize = 16;
+};
+
+// Reports memory that is owned by an object but not allocated through the tracker (e.g. a vector
+// member). Call Set() whenever the amount changes; whatever is left is released on destruction.
+class TrackedMemory : public NonCopyable
+{
+public:
+    TrackedMemory(MemoryTag tag)
+        : m_Tag(tag)
+        , m_Size(0)
+    {
+    }
+
+    ~TrackedMemory() { Set(0); }
+
+    inline void Set(size_t size)
+    {
+        if (size > m_Size)
+            MemoryTracker::OnAllocated(m_Tag, size - m_Size);
+        else if (size < m_Size)
+            MemoryTracker::OnFreed(m_Tag, m_Size - size);
+
+        m_Size = size;
+    }
+
+    inline size_t Get() const { return m_Size; }
+
+private:
+    MemoryTag m_Tag;
+    size_t m_Size;
+};
+
+// Standard library allocator that reports to the tracker, for containers owned by a subsystem
+template <typename T, MemoryTag Tag>
+class TrackingAllocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = TrackingAllocator<U, Tag>;
+    };
+
+    TrackingAllocator() = default;
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U, Tag>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        T* ptr = std::allocator<T>().allocate(n);
+        MemoryTracker::OnAllocated(Tag, n * sizeof(T));
+        return ptr;
+    }
+
+    void deallocate(T* ptr, size_t n)
+    {
+        MemoryTracker::OnFreed(Tag, n * sizeof(T));
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    template <typename U>
+    bool operator==(const TrackingAllocator<U, Tag>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const TrackingAllocator<U, Tag>&) const { return false; }
+};
+} // namespace Ether
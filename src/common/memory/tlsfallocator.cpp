@@ -0,0 +1,356 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "common/memory/tlsfallocator.h"
+#include <bit>
+
+Ether::TlsfAllocator::TlsfAllocator(size_t capacity)
+    : MemoryAllocator(capacity)
+{
+    Reset();
+}
+
+Ether::AllocationHandle Ether::TlsfAllocator::Allocate(SizeAlign sizeAlign)
+{
+    const uint32_t blockIndex = FindFreeBlock(sizeAlign);
+    if (blockIndex == InvalidBlock)
+        return {};
+
+    const size_t alignedSize = AlignUp((std::max)(sizeAlign.m_Size, size_t(1)), sizeAlign.m_Alignment);
+    const size_t padding = AlignUp(m_Blocks[blockIndex].m_Offset, sizeAlign.m_Alignment) - m_Blocks[blockIndex].m_Offset;
+
+    RemoveFreeBlock(blockIndex);
+
+    // Split off the alignment padding as a free block on the left. The block before a free block is
+    // never free (it would have been merged), so it does not have to be merged here.
+    if (padding > 0)
+    {
+        const uint32_t leftIndex = CreateBlock(m_Blocks[blockIndex].m_Offset, padding);
+        Block& left = m_Blocks[leftIndex];
+        Block& block = m_Blocks[blockIndex];
+
+        left.m_PrevPhysical = block.m_PrevPhysical;
+        left.m_NextPhysical = blockIndex;
+
+        if (block.m_PrevPhysical != InvalidBlock)
+            m_Blocks[block.m_PrevPhysical].m_NextPhysical = leftIndex;
+        else
+            m_FirstBlock = leftIndex;
+
+        block.m_PrevPhysical = leftIndex;
+        block.m_Offset += padding;
+        block.m_Size -= padding;
+        InsertFreeBlock(leftIndex);
+    }
+
+    // Return the remainder on the right to the free lists
+    if (m_Blocks[blockIndex].m_Size > alignedSize)
+    {
+        const uint32_t rightIndex = CreateBlock(
+            m_Blocks[blockIndex].m_Offset + alignedSize,
+            m_Blocks[blockIndex].m_Size - alignedSize);
+
+        Block& right = m_Blocks[rightIndex];
+        Block& block = m_Blocks[blockIndex];
+
+        right.m_PrevPhysical = blockIndex;
+        right.m_NextPhysical = block.m_NextPhysical;
+
+        if (block.m_NextPhysical != InvalidBlock)
+            m_Blocks[block.m_NextPhysical].m_PrevPhysical = rightIndex;
+
+        block.m_NextPhysical = rightIndex;
+        block.m_Size = alignedSize;
+        InsertFreeBlock(rightIndex);
+    }
+
+    m_FreeSize -= alignedSize;
+    return CreateHandle(m_Blocks[blockIndex].m_Offset, alignedSize, blockIndex);
+}
+
+void Ether::TlsfAllocator::Free(const AllocationHandle& alloc)
+{
+    assert(Owns(alloc) && "TlsfAllocator - Allocation does not belong to this allocator");
+    assert(m_Blocks[alloc.m_BlockIndex].m_Offset == alloc.m_Offset && "TlsfAllocator - Allocation is corrupted");
+
+    FreeBlock(alloc.m_BlockIndex);
+}
+
+bool Ether::TlsfAllocator::HasSpace(SizeAlign sizeAlign) const
+{
+    return FindFreeBlock(sizeAlign) != InvalidBlock;
+}
+
+void Ether::TlsfAllocator::Reset()
+{
+    m_Blocks.clear();
+    m_UnusedBlocks.clear();
+
+    m_FirstLevelBitmap = 0;
+    std::fill_n(m_SecondLevelBitmaps, FirstLevelCount, 0u);
+    std::fill_n(&m_FreeLists[0][0], FirstLevelCount * SecondLevelCount, InvalidBlock);
+
+    m_FirstBlock = CreateBlock(0, m_Capacity);
+    m_FreeSize = m_Capacity;
+    InsertFreeBlock(m_FirstBlock);
+    m_Generation++;
+}
+
+bool Ether::TlsfAllocator::ValidateInvariants() const
+{
+    size_t expectedOffset = 0;
+    size_t freeSize = 0;
+    uint32_t numFreeBlocks = 0;
+    uint32_t prevIndex = InvalidBlock;
+
+    for (uint32_t i = m_FirstBlock; i != InvalidBlock; i = m_Blocks[i].m_NextPhysical)
+    {
+        const Block& block = m_Blocks[i];
+
+        // Blocks have to tile the whole range without gaps
+        if (block.m_Offset != expectedOffset || block.m_Size == 0 || block.m_PrevPhysical != prevIndex)
+            return false;
+
+        if (block.m_IsFree)
+        {
+            // Free neighbours should have been merged
+            if (prevIndex != InvalidBlock && m_Blocks[prevIndex].m_IsFree)
+                return false;
+
+            uint32_t fl, sl;
+            MappingInsert(block.m_Size, fl, sl);
+
+            bool isInFreeList = false;
+            for (uint32_t j = m_FreeLists[fl][sl]; j != InvalidBlock && !isInFreeList; j = m_Blocks[j].m_NextFree)
+                isInFreeList = j == i;
+
+            if (!isInFreeList)
+                return false;
+
+            freeSize += block.m_Size;
+            numFreeBlocks++;
+        }
+
+        expectedOffset += block.m_Size;
+        prevIndex = i;
+    }
+
+    if (expectedOffset != m_Capacity || freeSize != m_FreeSize)
+        return false;
+
+    // Every listed block has to be free and the bitmaps have to match the lists exactly
+    uint32_t numListedBlocks = 0;
+    for (uint32_t fl = 0; fl < FirstLevelCount; ++fl)
+    {
+        if (((m_FirstLevelBitmap >> fl) & 1) != (m_SecondLevelBitmaps[fl] != 0))
+            return false;
+
+        for (uint32_t sl = 0; sl < SecondLevelCount; ++sl)
+        {
+            if (((m_SecondLevelBitmaps[fl] >> sl) & 1) != (m_FreeLists[fl][sl] != InvalidBlock))
+                return false;
+
+            for (uint32_t j = m_FreeLists[fl][sl]; j != InvalidBlock; j = m_Blocks[j].m_NextFree)
+            {
+                if (!m_Blocks[j].m_IsFree)
+                    return false;
+
+                numListedBlocks++;
+            }
+        }
+    }
+
+    return numListedBlocks == numFreeBlocks;
+}
+
+void Ether::TlsfAllocator::FreeBlock(uint32_t blockIndex)
+{
+    assert(!m_Blocks[blockIndex].m_IsFree && "TlsfAllocator - Double free");
+
+    m_FreeSize += m_Blocks[blockIndex].m_Size;
+
+    const uint32_t prevIndex = m_Blocks[blockIndex].m_PrevPhysical;
+    if (prevIndex != InvalidBlock && m_Blocks[prevIndex].m_IsFree)
+    {
+        RemoveFreeBlock(prevIndex);
+        MergeBlocks(prevIndex, blockIndex);
+        blockIndex = prevIndex;
+    }
+
+    const uint32_t nextIndex = m_Blocks[blockIndex].m_NextPhysical;
+    if (nextIndex != InvalidBlock && m_Blocks[nextIndex].m_IsFree)
+    {
+        RemoveFreeBlock(nextIndex);
+        MergeBlocks(blockIndex, nextIndex);
+    }
+
+    InsertFreeBlock(blockIndex);
+}
+
+void Ether::TlsfAllocator::MappingInsert(size_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+    // Small blocks are spread linearly over the first bucket
+    if (size < SmallBlockSize)
+    {
+        firstLevel = 0;
+        secondLevel = static_cast<uint32_t>(size);
+        return;
+    }
+
+    const uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+    firstLevel = msb - FirstLevelShift + 1;
+    secondLevel = static_cast<uint32_t>(size >> (msb - SecondLevelBits)) ^ SecondLevelCount;
+}
+
+void Ether::TlsfAllocator::MappingSearch(size_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+    // Round up to the next bucket, so that any block found there is guaranteed to be large enough
+    if (size >= SmallBlockSize)
+    {
+        const uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        size += (size_t(1) << (msb - SecondLevelBits)) - 1;
+    }
+
+    MappingInsert(size, firstLevel, secondLevel);
+}
+
+uint32_t Ether::TlsfAllocator::FindFreeBlock(size_t size) const
+{
+    uint32_t fl, sl;
+    MappingSearch(size, fl, sl);
+
+    if (fl >= FirstLevelCount)
+        return InvalidBlock;
+
+    uint32_t secondLevelMap = m_SecondLevelBitmaps[fl] & (~0u << sl);
+
+    if (secondLevelMap == 0)
+    {
+        const uint64_t firstLevelMap = fl + 1 < 64 ? m_FirstLevelBitmap & (~0ull << (fl + 1)) : 0;
+        if (firstLevelMap == 0)
+            return InvalidBlock;
+
+        fl = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+        secondLevelMap = m_SecondLevelBitmaps[fl];
+    }
+
+    sl = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+    return m_FreeLists[fl][sl];
+}
+
+uint32_t Ether::TlsfAllocator::FindFreeBlock(SizeAlign sizeAlign) const
+{
+    const size_t alignedSize = AlignUp((std::max)(sizeAlign.m_Size, size_t(1)), sizeAlign.m_Alignment);
+    const uint32_t blockIndex = FindFreeBlock(alignedSize);
+
+    if (blockIndex == InvalidBlock || sizeAlign.m_Alignment <= 1)
+        return blockIndex;
+
+    const Block& block = m_Blocks[blockIndex];
+    const size_t padding = AlignUp(block.m_Offset, sizeAlign.m_Alignment) - block.m_Offset;
+
+    if (block.m_Size >= alignedSize + padding)
+        return blockIndex;
+
+    // Look again for a block that fits even with the worst case alignment padding
+    return FindFreeBlock(alignedSize + sizeAlign.m_Alignment - 1);
+}
+
+void Ether::TlsfAllocator::InsertFreeBlock(uint32_t blockIndex)
+{
+    uint32_t fl, sl;
+    MappingInsert(m_Blocks[blockIndex].m_Size, fl, sl);
+
+    Block& block = m_Blocks[blockIndex];
+    block.m_IsFree = true;
+    block.m_PrevFree = InvalidBlock;
+    block.m_NextFree = m_FreeLists[fl][sl];
+
+    if (block.m_NextFree != InvalidBlock)
+        m_Blocks[block.m_NextFree].m_PrevFree = blockIndex;
+
+    m_FreeLists[fl][sl] = blockIndex;
+    m_FirstLevelBitmap |= uint64_t(1) << fl;
+    m_SecondLevelBitmaps[fl] |= 1u << sl;
+}
+
+void Ether::TlsfAllocator::RemoveFreeBlock(uint32_t blockIndex)
+{
+    uint32_t fl, sl;
+    MappingInsert(m_Blocks[blockIndex].m_Size, fl, sl);
+
+    Block& block = m_Blocks[blockIndex];
+    block.m_IsFree = false;
+
+    if (block.m_PrevFree != InvalidBlock)
+        m_Blocks[block.m_PrevFree].m_NextFree = block.m_NextFree;
+    if (block.m_NextFree != InvalidBlock)
+        m_Blocks[block.m_NextFree].m_PrevFree = block.m_PrevFree;
+
+    if (m_FreeLists[fl][sl] != blockIndex)
+        return;
+
+    m_FreeLists[fl][sl] = block.m_NextFree;
+
+    if (m_FreeLists[fl][sl] != InvalidBlock)
+        return;
+
+    m_SecondLevelBitmaps[fl] &= ~(1u << sl);
+    if (m_SecondLevelBitmaps[fl] == 0)
+        m_FirstLevelBitmap &= ~(uint64_t(1) << fl);
+}
+
+uint32_t Ether::TlsfAllocator::CreateBlock(size_t offset, size_t size)
+{
+    uint32_t blockIndex;
+
+    if (!m_UnusedBlocks.empty())
+    {
+        blockIndex = m_UnusedBlocks.back();
+        m_UnusedBlocks.pop_back();
+    }
+    else
+    {
+        blockIndex = static_cast<uint32_t>(m_Blocks.size());
+        m_Blocks.emplace_back();
+    }
+
+    m_Blocks[blockIndex] = { offset, size, InvalidBlock, InvalidBlock, InvalidBlock, InvalidBlock, false };
+    return blockIndex;
+}
+
+void Ether::TlsfAllocator::DestroyBlock(uint32_t blockIndex)
+{
+    m_UnusedBlocks.push_back(blockIndex);
+}
+
+void Ether::TlsfAllocator::MergeBlocks(uint32_t leftIndex, uint32_t rightIndex)
+{
+    Block& left = m_Blocks[leftIndex];
+    const Block& right = m_Blocks[rightIndex];
+
+    assert(left.m_Offset + left.m_Size == right.m_Offset && "TlsfAllocator - Only adjacent blocks can be merged");
+
+    left.m_Size += right.m_Size;
+    left.m_NextPhysical = right.m_NextPhysical;
+
+    if (right.m_NextPhysical != InvalidBlock)
+        m_Blocks[right.m_NextPhysical].m_PrevPhysical = leftIndex;
+
+    DestroyBlock(rightIndex);
+}
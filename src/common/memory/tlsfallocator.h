@@ -0,0 +1,98 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "common/memory/memoryallocator.h"
+#include <vector>
+
+namespace Ether
+{
+/**
+ * Two-Level Segregated Fit allocator (Masmano et al. 2004).
+ * Free blocks are bucketed by the position of their most significant bit (first level) and a linear
+ * subdivision of that range (second level). A bitmap per level lets allocation find a fitting bucket
+ * with two bit scans, and blocks are merged with their free neighbours as soon as they are freed,
+ * so both Allocate and Free are O(1).
+ *
+ * Blocks are tracked outside of the managed range, so it can manage GPU memory and descriptor heaps.
+ */
+class ETH_COMMON_DLL TlsfAllocator : public MemoryAllocator
+{
+public:
+    TlsfAllocator(size_t capacity);
+    ~TlsfAllocator() = default;
+
+public:
+    AllocationHandle Allocate(SizeAlign sizeAlign) override;
+    void Free(const AllocationHandle& alloc) override;
+    bool HasSpace(SizeAlign sizeAlign) const override;
+    void Reset() override;
+
+public:
+    inline size_t GetFreeSize() const { return m_FreeSize; }
+
+    // Walks every block and checks the physical and segregated free lists against each other. Slow, for debugging.
+    bool ValidateInvariants() const;
+
+private:
+    static constexpr uint32_t SecondLevelBits = 5;
+    static constexpr uint32_t SecondLevelCount = 1 << SecondLevelBits;
+    static constexpr uint32_t FirstLevelShift = SecondLevelBits;
+    static constexpr uint32_t FirstLevelCount = 64 - FirstLevelShift + 1;
+    static constexpr size_t SmallBlockSize = size_t(1) << FirstLevelShift;
+    static constexpr uint32_t InvalidBlock = ~0u;
+
+    struct Block
+    {
+        size_t m_Offset;
+        size_t m_Size;
+        uint32_t m_PrevPhysical;
+        uint32_t m_NextPhysical;
+        uint32_t m_PrevFree;
+        uint32_t m_NextFree;
+        bool m_IsFree;
+    };
+
+private:
+    static void MappingInsert(size_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+    static void MappingSearch(size_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+    void FreeBlock(uint32_t blockIndex);
+    uint32_t FindFreeBlock(size_t size) const;
+    uint32_t FindFreeBlock(SizeAlign sizeAlign) const;
+    void InsertFreeBlock(uint32_t blockIndex);
+    void RemoveFreeBlock(uint32_t blockIndex);
+
+    uint32_t CreateBlock(size_t offset, size_t size);
+    void DestroyBlock(uint32_t blockIndex);
+    void MergeBlocks(uint32_t leftIndex, uint32_t rightIndex);
+
+private:
+    // Block storage is recycled, so that steady state allocation never touches the heap
+    std::vector<Block> m_Blocks;
+    std::vector<uint32_t> m_UnusedBlocks;
+    uint32_t m_FirstBlock;
+
+    uint64_t m_FirstLevelBitmap;
+    uint32_t m_SecondLevelBitmaps[FirstLevelCount];
+    uint32_t m_FreeLists[FirstLevelCount][SecondLevelCount];
+
+    size_t m_FreeSize;
+};
+} // namespace Ether
@@ -18,28 +18,45 @@
 */
 
 #include "common/stream/bytestream.h"
+#include "common/memory/memorytracker.h"
+#include <cstring>
 #include <stdexcept>
 
 Ether::IByteStream::IByteStream(size_t size)
     : m_Size(size)
+    , m_FileOffset(0)
 {
-    m_StartPtr = new char[size];
+    m_StartPtr = static_cast<char*>(MemoryTracker::Allocate(size, MemoryTag::Streams));
     m_CurrPtr = m_StartPtr;
     m_IsOpen = true;
 }
 
 Ether::IByteStream::IByteStream(IFileStream& file)
+    : m_FilePath(file.GetPath())
+    , m_FileOffset(file.GetPosition())
 {
-    m_StartPtr = new char[file.GetFileSize()];
+    m_StartPtr = static_cast<char*>(MemoryTracker::Allocate(file.GetFileSize(), MemoryTag::Streams));
     m_CurrPtr = m_StartPtr;
     file.ReadBytes(m_StartPtr, file.GetFileSize());
+    m_Size = file.GetFileSize();
     m_IsOpen = true;
 }
 
+Ether::IByteStream::IByteStream(IFileStream& file, size_t size)
+    : m_Size(size)
+    , m_FilePath(file.GetPath())
+    , m_FileOffset(file.GetPosition())
+{
+    m_StartPtr = static_cast<char*>(MemoryTracker::Allocate(size, MemoryTag::Streams));
+    m_CurrPtr = m_StartPtr;
+    file.ReadBytes(m_StartPtr, static_cast<uint32_t>(size));
+    m_IsOpen = !file.HasFailed();
+}
+
 Ether::IByteStream::~IByteStream()
 {
     m_IsOpen = false;
-    free(m_StartPtr);
+    MemoryTracker::Free(m_StartPtr);
 }
 
 Ether::IStream& Ether::IByteStream::operator>>(float& value)
@@ -86,8 +103,14 @@ Ether::IStream& Ether::IByteStream::operator>>(unsigned char& value)
 
 Ether::IStream& Ether::IByteStream::operator>>(std::string& value)
 {
-    value = m_CurrPtr;             // Construct string from the pointer directly since it is null terminated
-    m_CurrPtr += value.size() + 1; // +1 for null terminator
+    // Strings are null terminated, but the data might not be (e.g. a truncated file)
+    const size_t remaining = m_Size - (m_CurrPtr - m_StartPtr);
+    const size_t length = strnlen(m_CurrPtr, remaining);
+    if (length == remaining)
+        throw std::runtime_error("Attempted to read past the end of a byte stream");
+
+    value.assign(m_CurrPtr, length);
+    m_CurrPtr += length + 1; // +1 for null terminator
     return *this;
 }
 
@@ -101,7 +124,10 @@ Ether::IStream& Ether::IByteStream::operator>>(StringID& value)
 
 Ether::IStream& Ether::IByteStream::operator>>(bool& value)
 {
-    ReadBytes(&value, sizeof(value));
+    // Any other byte than 0 or 1 would not be a valid bool
+    uint8_t byte;
+    ReadBytes(&byte, sizeof(byte));
+    value = byte != 0;
     return *this;
 }
 
@@ -125,21 +151,42 @@ Ether::IStream& Ether::IByteStream::operator>>(ethVector4& value)
 
 void Ether::IByteStream::ReadBytes(void* dest, uint32_t numBytes)
 {
+    if (numBytes > m_Size - (m_CurrPtr - m_StartPtr))
+        throw std::runtime_error("Attempted to read past the end of a byte stream");
+
     memcpy(reinterpret_cast<char*>(dest), m_CurrPtr, numBytes);
     m_CurrPtr += numBytes;
 }
 
+void Ether::IByteStream::Skip(size_t numBytes)
+{
+    if (numBytes > m_Size - (m_CurrPtr - m_StartPtr))
+        throw std::runtime_error("Attempted to skip past the end of a byte stream");
+
+    m_CurrPtr += numBytes;
+}
+
+bool Ether::IByteStream::GetFileLocation(std::string& path, size_t& offset)
+{
+    if (m_FilePath.empty())
+        return false;
+
+    path = m_FilePath;
+    offset = m_FileOffset + (m_CurrPtr - m_StartPtr);
+    return true;
+}
+
 Ether::OByteStream::OByteStream()
 {
     m_IsOpen = true;
-    m_StartPtr = new char[1000000000];
+    m_StartPtr = static_cast<char*>(MemoryTracker::Allocate(1000000000, MemoryTag::Streams));
     m_CurrPtr = m_StartPtr;
 }
 
 Ether::OByteStream::~OByteStream()
 {
     m_IsOpen = false;
-    free(m_StartPtr);
+    MemoryTracker::Free(m_StartPtr);
 }
 
 Ether::OStream& Ether::OByteStream::operator<<(const float value)
@@ -29,6 +29,8 @@ class ETH_COMMON_DLL IByteStream : public IStream
 public:
     IByteStream(size_t size);
     IByteStream(IFileStream& file);
+    // Reads the next size bytes of the file
+    IByteStream(IFileStream& file, size_t size);
     ~IByteStream();
 
     IStream& operator>>(float& v) override final;
@@ -46,11 +48,21 @@ public:
     IStream& operator>>(ethVector4& v) override final;
 
     void ReadBytes(void* dest, uint32_t numBytes) override final;
+    void Skip(size_t numBytes) override final;
+    bool GetFileLocation(std::string& path, size_t& offset) override final;
+
+public:
+    // E.g. for filling a stream that was created with just a size
+    inline char* GetData() { return m_StartPtr; }
 
 private:
     char* m_StartPtr;
     const char* m_CurrPtr;
     size_t m_Size;
+
+    // Where the data was read from, empty if it was not read from a file
+    std::string m_FilePath;
+    size_t m_FileOffset;
 };
 
 class ETH_COMMON_DLL OByteStream : public OStream
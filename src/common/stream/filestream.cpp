@@ -22,6 +22,7 @@
 #include <sstream>
 
 Ether::IFileStream::IFileStream(const std::string& path)
+    : m_Path(path)
 {
     m_File.open(path, std::ios::in | std::ios::binary | std::ios::ate);
     if (!m_File.is_open())
@@ -123,6 +124,29 @@ void Ether::IFileStream::ReadBytes(void* dest, uint32_t numBytes)
     m_File.read(reinterpret_cast<char*>(dest), numBytes);
 }
 
+void Ether::IFileStream::Skip(size_t numBytes)
+{
+    m_File.seekg(numBytes, std::ios::cur);
+}
+
+bool Ether::IFileStream::GetFileLocation(std::string& path, size_t& offset)
+{
+    path = m_Path;
+    offset = GetPosition();
+    return !HasFailed();
+}
+
+void Ether::IFileStream::Seek(size_t offset)
+{
+    m_File.clear();
+    m_File.seekg(offset, std::ios::beg);
+}
+
+size_t Ether::IFileStream::GetPosition()
+{
+    return static_cast<size_t>(m_File.tellg());
+}
+
 Ether::OFileStream::OFileStream(const std::string& path)
 {
     m_File.open(path, std::ios::out | std::ios::binary);
@@ -225,3 +249,8 @@ void Ether::OFileStream::ClearFile()
 {
     m_File.clear();
 }
+
+size_t Ether::OFileStream::GetPosition()
+{
+    return static_cast<size_t>(m_File.tellp());
+}
@@ -46,12 +46,20 @@ public:
     IStream& operator>>(ethVector4& v) override final;
 
     void ReadBytes(void* dest, uint32_t numBytes) override final;
+    void Skip(size_t numBytes) override final;
+    bool GetFileLocation(std::string& path, size_t& offset) override final;
 
 public:
+    inline const std::string& GetPath() const { return m_Path; }
     inline size_t GetFileSize() const { return m_FileSize; }
+    inline bool HasFailed() const { return m_File.fail(); }
+
+    void Seek(size_t offset);
+    size_t GetPosition();
 
 private:
     std::ifstream m_File;
+    std::string m_Path;
     size_t m_FileSize;
 };
 
@@ -79,6 +87,7 @@ public:
 
 public:
     void ClearFile();
+    size_t GetPosition();
 
 private:
     std::ofstream m_File;
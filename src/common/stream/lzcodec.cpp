@@ -0,0 +1,252 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/stream/lzcodec.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+constexpr size_t MinMatch = 4;
+// The block format requires the last match to start this many bytes before the end of the data,
+// and the last 5 bytes to be literals
+constexpr size_t MatchStartLimit = 12;
+constexpr size_t LastLiterals = 5;
+constexpr size_t MaxOffset = 65535;
+constexpr uint32_t HashBits = 16;
+
+inline uint32_t Read32(const uint8_t* ptr)
+{
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+inline uint32_t Hash(uint32_t value)
+{
+    return (value * 2654435761u) >> (32 - HashBits);
+}
+
+// Copies in steps of 8 bytes, and so may write up to 7 bytes past dest + size
+inline void WildCopy(uint8_t* dest, const uint8_t* src, size_t size)
+{
+    uint8_t* const destEnd = dest + size;
+    do
+    {
+        std::memcpy(dest, src, 8);
+        dest += 8;
+        src += 8;
+    } while (dest < destEnd);
+}
+
+// Lengths that do not fit into their 4 bits of the token continue in bytes of up to 255
+inline bool WriteLength(uint8_t*& op, const uint8_t* opEnd, size_t length)
+{
+    for (; length >= 255; length -= 255)
+    {
+        if (op >= opEnd)
+            return false;
+        *op++ = 255;
+    }
+
+    if (op >= opEnd)
+        return false;
+
+    *op++ = static_cast<uint8_t>(length);
+    return true;
+}
+
+inline bool ReadLength(const uint8_t*& ip, const uint8_t* ipEnd, size_t& length)
+{
+    uint8_t value;
+    do
+    {
+        if (ip >= ipEnd)
+            return false;
+
+        value = *ip++;
+        length += value;
+    } while (value == 255);
+
+    return true;
+}
+
+// A run of literals, followed by a match unless matchLength is 0 (only the last sequence has none)
+bool WriteSequence(
+    uint8_t*& op,
+    const uint8_t* opEnd,
+    const uint8_t* literals,
+    size_t numLiterals,
+    size_t offset,
+    size_t matchLength)
+{
+    if (op >= opEnd)
+        return false;
+
+    uint8_t& token = *op++;
+    token = static_cast<uint8_t>((std::min)(numLiterals, size_t(15)) << 4);
+    if (numLiterals >= 15 && !WriteLength(op, opEnd, numLiterals - 15))
+        return false;
+
+    if (static_cast<size_t>(opEnd - op) < numLiterals)
+        return false;
+
+    // Empty input has no literals, and may not have any data to copy them from either
+    if (numLiterals > 0)
+        std::memcpy(op, literals, numLiterals);
+
+    op += numLiterals;
+
+    if (matchLength == 0)
+        return true;
+
+    if (opEnd - op < 2)
+        return false;
+
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+
+    const size_t length = matchLength - MinMatch;
+    token |= static_cast<uint8_t>((std::min)(length, size_t(15)));
+    return length < 15 || WriteLength(op, opEnd, length - 15);
+}
+} // namespace
+
+size_t Ether::LzCodec::Compress(const void* src, size_t srcSize, void* dest, size_t destCapacity)
+{
+    const uint8_t* const data = static_cast<const uint8_t*>(src);
+    uint8_t* op = static_cast<uint8_t*>(dest);
+    const uint8_t* const opEnd = op + destCapacity;
+
+    // Positions of the last occurrence of each hashed 4 byte sequence
+    std::vector<uint32_t> hashTable(size_t(1) << HashBits, 0);
+
+    size_t anchor = 0;
+    size_t pos = 1;
+    size_t numMisses = 0;
+
+    while (srcSize >= MatchStartLimit && pos <= srcSize - MatchStartLimit)
+    {
+        const uint32_t sequence = Read32(data + pos);
+        const uint32_t hash = Hash(sequence);
+        size_t match = hashTable[hash];
+        hashTable[hash] = static_cast<uint32_t>(pos);
+
+        if (pos - match > MaxOffset || Read32(data + match) != sequence)
+        {
+            // Steps up every 64 misses in a row, so that incompressible data is skipped quickly
+            pos += 1 + (numMisses++ >> 6);
+            continue;
+        }
+
+        while (pos > anchor && match > 0 && data[pos - 1] == data[match - 1])
+        {
+            --pos;
+            --match;
+        }
+
+        size_t length = MinMatch;
+        while (pos + length < srcSize - LastLiterals && data[pos + length] == data[match + length])
+            ++length;
+
+        if (!WriteSequence(op, opEnd, data + anchor, pos - anchor, pos - match, length))
+            return 0;
+
+        pos += length;
+        anchor = pos;
+        numMisses = 0;
+
+        // Gives the next search a closer candidate than the one the match started from
+        if (pos <= srcSize - MatchStartLimit)
+            hashTable[Hash(Read32(data + pos - 2))] = static_cast<uint32_t>(pos - 2);
+    }
+
+    if (!WriteSequence(op, opEnd, data + anchor, srcSize - anchor, 0, 0))
+        return 0;
+
+    return op - static_cast<uint8_t*>(dest);
+}
+
+bool Ether::LzCodec::Decompress(const void* src, size_t srcSize, void* dest, size_t destSize)
+{
+    const uint8_t* ip = static_cast<const uint8_t*>(src);
+    const uint8_t* const ipEnd = ip + srcSize;
+    uint8_t* const opStart = static_cast<uint8_t*>(dest);
+    uint8_t* op = opStart;
+    uint8_t* const opEnd = op + destSize;
+
+    while (ip < ipEnd)
+    {
+        const uint8_t token = *ip++;
+
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15 && !ReadLength(ip, ipEnd, numLiterals))
+            return false;
+
+        if (static_cast<size_t>(ipEnd - ip) < numLiterals || static_cast<size_t>(opEnd - op) < numLiterals)
+            return false;
+
+        // Most sequences are short, and far enough from the end to copy them in steps
+        if (static_cast<size_t>(ipEnd - ip) >= numLiterals + 8 && static_cast<size_t>(opEnd - op) >= numLiterals + 8)
+            WildCopy(op, ip, numLiterals);
+        else
+            std::memcpy(op, ip, numLiterals);
+
+        ip += numLiterals;
+        op += numLiterals;
+
+        // The last sequence is literals only
+        if (ip == ipEnd)
+            break;
+
+        if (ipEnd - ip < 2)
+            return false;
+
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (offset == 0 || offset > static_cast<size_t>(op - opStart))
+            return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(ip, ipEnd, matchLength))
+            return false;
+
+        matchLength += MinMatch;
+        if (static_cast<size_t>(opEnd - op) < matchLength)
+            return false;
+
+        // Matches may overlap the bytes they produce (which repeats the last offset bytes), steps of 8 bytes
+        // only read what has been written already if the offset is at least that
+        const uint8_t* match = op - offset;
+        if (offset >= 8 && static_cast<size_t>(opEnd - op) >= matchLength + 8)
+        {
+            WildCopy(op, match, matchLength);
+            op += matchLength;
+        }
+        else
+        {
+            for (size_t i = 0; i < matchLength; ++i)
+                *op++ = *match++;
+        }
+    }
+
+    return op == opEnd;
+}
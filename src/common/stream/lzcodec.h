@@ -0,0 +1,35 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+
+/*
+    A small LZ77 codec that writes the LZ4 block format (literal runs and matches of at least 4
+    bytes, within a 64 KiB window). It trades ratio for decompression speed, which is what loading
+    resources needs.
+*/
+namespace Ether::LzCodec
+{
+// Returns the compressed size, or 0 if the data does not fit into destCapacity bytes
+ETH_COMMON_DLL size_t Compress(const void* src, size_t srcSize, void* dest, size_t destCapacity);
+// Fails if the data is corrupt or does not decompress to exactly destSize bytes
+ETH_COMMON_DLL bool Decompress(const void* src, size_t srcSize, void* dest, size_t destSize);
+} // namespace Ether::LzCodec
@@ -0,0 +1,249 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/stream/packfile.h"
+#include "common/stream/lzcodec.h"
+#include "common/memory/memorytracker.h"
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+constexpr uint32_t PackFileFooterSize = 3 * sizeof(uint32_t);
+// Two empty strings, the compression, the offset and both sizes
+constexpr uint32_t MinPackEntrySize = 2 + 5 * sizeof(uint32_t);
+
+static void WriteOffset(Ether::OStream& ostream, uint64_t offset)
+{
+    ostream << static_cast<uint32_t>(offset & 0xffffffff);
+    ostream << static_cast<uint32_t>(offset >> 32);
+}
+
+static uint64_t ReadOffset(Ether::IStream& istream)
+{
+    uint32_t low, high;
+    istream >> low;
+    istream >> high;
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+Ether::PackFileWriter::PackFileWriter(const std::string& path)
+    : m_File(path)
+{
+}
+
+void Ether::PackFileWriter::AddEntry(
+    const std::string& guid,
+    const std::string& classID,
+    const void* data,
+    uint32_t size,
+    PackCompression compression)
+{
+    PackEntryDesc entry = { guid, classID, PackCompression::None, 0, size, size };
+
+    const size_t offset = m_File.GetPosition();
+    const size_t padding = (PackFileAlignment - offset % PackFileAlignment) % PackFileAlignment;
+    static const char zeros[PackFileAlignment] = {};
+    m_File.WriteBytes(zeros, static_cast<uint32_t>(padding));
+    entry.m_Offset = offset + padding;
+
+    // Only worth it if it saves at least one byte, that also keeps empty entries stored
+    if (compression == PackCompression::Lz && size > 1)
+    {
+        void* compressed = MemoryTracker::Allocate(size - 1, MemoryTag::Streams);
+        const size_t compressedSize = LzCodec::Compress(data, size, compressed, size - 1);
+        if (compressedSize != 0)
+        {
+            entry.m_Compression = PackCompression::Lz;
+            entry.m_StoredSize = static_cast<uint32_t>(compressedSize);
+            m_File.WriteBytes(compressed, entry.m_StoredSize);
+        }
+        MemoryTracker::Free(compressed);
+    }
+
+    if (entry.m_Compression == PackCompression::None)
+        m_File.WriteBytes(data, size);
+
+    m_Entries.push_back(entry);
+}
+
+void Ether::PackFileWriter::AddFile(const std::string& path, PackCompression compression)
+{
+    IFileStream file(path);
+    if (!file.IsOpen())
+        throw std::runtime_error(std::format("Failed to open {}", path));
+
+    IByteStream istream(file);
+    if (!istream.IsOpen())
+        throw std::runtime_error(std::format("Failed to read {}", path));
+
+    std::string guid;
+    const std::string classID = Serializable::DeserializeClassID(istream);
+    istream >> guid;
+
+    AddEntry(guid, classID, istream.GetData(), static_cast<uint32_t>(file.GetFileSize()), compression);
+}
+
+void Ether::PackFileWriter::Finalize()
+{
+    std::sort(
+        m_Entries.begin(),
+        m_Entries.end(),
+        [](const PackEntryDesc& a, const PackEntryDesc& b) { return a.m_Guid < b.m_Guid; });
+
+    for (size_t i = 1; i < m_Entries.size(); ++i)
+        if (m_Entries[i - 1].m_Guid == m_Entries[i].m_Guid)
+            throw std::runtime_error(std::format("Resource {} was packed more than once", m_Entries[i].m_Guid));
+
+    const uint64_t indexOffset = m_File.GetPosition();
+    m_File << PackFileVersion;
+    m_File << static_cast<uint32_t>(m_Entries.size());
+    for (const PackEntryDesc& entry : m_Entries)
+    {
+        m_File << entry.m_Guid;
+        m_File << entry.m_ClassID;
+        m_File << static_cast<uint32_t>(entry.m_Compression);
+        WriteOffset(m_File, entry.m_Offset);
+        m_File << entry.m_StoredSize;
+        m_File << entry.m_Size;
+    }
+
+    WriteOffset(m_File, indexOffset);
+    m_File << PackFileMagic;
+}
+
+Ether::PackFileReader::PackFileReader(const std::string& path)
+    : m_File(path)
+{
+    if (!m_File.IsOpen())
+        throw std::runtime_error(std::format("Failed to open {}", path));
+
+    if (m_File.GetFileSize() < PackFileFooterSize)
+        throw std::runtime_error(std::format("{} is too small to be a pack file", path));
+
+    m_File.Seek(m_File.GetFileSize() - PackFileFooterSize);
+    const uint64_t indexOffset = ReadOffset(m_File);
+    uint32_t magic;
+    m_File >> magic;
+
+    if (magic != PackFileMagic)
+        throw std::runtime_error(std::format("{} is not a pack file", path));
+
+    if (indexOffset >= m_File.GetFileSize() - PackFileFooterSize)
+        throw std::runtime_error(std::format("Index of {} is out of range", path));
+
+    // Read as a whole, so that a truncated index fails with an error rather than garbage
+    m_File.Seek(indexOffset);
+    IByteStream istream(m_File, m_File.GetFileSize() - PackFileFooterSize - indexOffset);
+    if (!istream.IsOpen())
+        throw std::runtime_error(std::format("Failed to read the index of {}", path));
+
+    uint32_t version, numEntries;
+    istream >> version;
+    istream >> numEntries;
+
+    if (version != PackFileVersion)
+        throw std::runtime_error(std::format("{} is a version {} pack file, expected version {}", path, version, PackFileVersion));
+
+    // Checked before anything is allocated for them
+    if (numEntries > (m_File.GetFileSize() - PackFileFooterSize - indexOffset) / MinPackEntrySize)
+        throw std::runtime_error(std::format("Index of {} claims more entries than it can hold", path));
+
+    m_Entries.resize(numEntries);
+    for (PackEntryDesc& entry : m_Entries)
+    {
+        uint32_t compression;
+        istream >> entry.m_Guid;
+        istream >> entry.m_ClassID;
+        istream >> compression;
+        entry.m_Compression = static_cast<PackCompression>(compression);
+        entry.m_Offset = ReadOffset(istream);
+        istream >> entry.m_StoredSize;
+        istream >> entry.m_Size;
+
+        const bool isValidSize = entry.m_Compression == PackCompression::Lz ||
+                                 (entry.m_Compression == PackCompression::None && entry.m_StoredSize == entry.m_Size);
+
+        if (!isValidSize || entry.m_Offset > indexOffset || entry.m_StoredSize > indexOffset - entry.m_Offset)
+            throw std::runtime_error(std::format("Pack entry {} in {} is invalid", entry.m_Guid, path));
+
+        if (entry.m_Offset % PackFileAlignment != 0)
+            throw std::runtime_error(std::format("Pack entry {} in {} is not aligned", entry.m_Guid, path));
+    }
+
+    // Payloads never share bytes, a damaged index could otherwise hand out the same data twice. Empty
+    // entries can start where the next one does, so they go first.
+    std::vector<const PackEntryDesc*> entriesByOffset(m_Entries.size());
+    for (size_t i = 0; i < m_Entries.size(); ++i)
+        entriesByOffset[i] = &m_Entries[i];
+
+    std::sort(
+        entriesByOffset.begin(),
+        entriesByOffset.end(),
+        [](const PackEntryDesc* a, const PackEntryDesc* b)
+        {
+            if (a->m_Offset != b->m_Offset)
+                return a->m_Offset < b->m_Offset;
+
+            return a->m_StoredSize < b->m_StoredSize;
+        });
+
+    for (size_t i = 1; i < entriesByOffset.size(); ++i)
+        if (entriesByOffset[i - 1]->m_Offset + entriesByOffset[i - 1]->m_StoredSize > entriesByOffset[i]->m_Offset)
+            throw std::runtime_error(std::format("Pack entries {} and {} in {} overlap", entriesByOffset[i - 1]->m_Guid, entriesByOffset[i]->m_Guid, path));
+
+    // Find() relies on the order
+    for (size_t i = 1; i < m_Entries.size(); ++i)
+        if (m_Entries[i - 1].m_Guid >= m_Entries[i].m_Guid)
+            throw std::runtime_error(std::format("Index of {} is not sorted", path));
+}
+
+const Ether::PackEntryDesc* Ether::PackFileReader::Find(const std::string& guid) const
+{
+    const auto it = std::lower_bound(
+        m_Entries.begin(),
+        m_Entries.end(),
+        guid,
+        [](const PackEntryDesc& entry, const std::string& value) { return entry.m_Guid < value; });
+
+    if (it == m_Entries.end() || it->m_Guid != guid)
+        return nullptr;
+
+    return &*it;
+}
+
+std::unique_ptr<Ether::IByteStream> Ether::PackFileReader::Read(const PackEntryDesc& entry)
+{
+    m_File.Seek(entry.m_Offset);
+
+    if (entry.m_Compression == PackCompression::None)
+    {
+        std::unique_ptr<IByteStream> istream = std::make_unique<IByteStream>(m_File, entry.m_Size);
+        if (!istream->IsOpen())
+            throw std::runtime_error(std::format("Failed to read pack entry {}", entry.m_Guid));
+
+        return istream;
+    }
+
+    IByteStream compressed(m_File, entry.m_StoredSize);
+    std::unique_ptr<IByteStream> istream = std::make_unique<IByteStream>(entry.m_Size);
+    if (!compressed.IsOpen() || !LzCodec::Decompress(compressed.GetData(), entry.m_StoredSize, istream->GetData(), entry.m_Size))
+        throw std::runtime_error(std::format("Failed to decompress pack entry {}", entry.m_Guid));
+
+    return istream;
+}
@@ -0,0 +1,98 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/stream/bytestream.h"
+#include "common/stream/filestream.h"
+
+namespace Ether
+{
+// Written at the very end of a pack file, after the offset of the index
+constexpr uint32_t PackFileMagic = 0x4B415045; // "EPAK"
+constexpr uint32_t PackFileVersion = 1;
+// Payloads start on a boundary of this many bytes, so that they can be read without touching their neighbours
+constexpr uint32_t PackFileAlignment = 4096;
+
+enum class PackCompression : uint32_t
+{
+    None,
+    Lz,
+};
+
+struct PackEntryDesc
+{
+    std::string m_Guid;
+    // Type of the resource, the class ID it was serialized with (e.g. Graphics::Mesh)
+    std::string m_ClassID;
+    PackCompression m_Compression;
+    uint64_t m_Offset;
+    uint32_t m_StoredSize;
+    uint32_t m_Size;
+};
+
+/*
+    Packs serialized resources (the .eres files of a library) into a single file, laid out as
+
+        payloads | index | index offset (2x u32) | magic
+
+    The index is sorted by guid. Entries that do not get smaller with LzCodec are stored as they
+    are, and those are read back through a file backed IByteStream, so textures in them can still
+    have their mips streamed.
+*/
+class ETH_COMMON_DLL PackFileWriter : public NonCopyable
+{
+public:
+    PackFileWriter(const std::string& path);
+    ~PackFileWriter() = default;
+
+public:
+    void AddEntry(const std::string& guid, const std::string& classID, const void* data, uint32_t size, PackCompression compression);
+    // Takes the guid and class ID from the serialized resource
+    void AddFile(const std::string& path, PackCompression compression);
+    // Writes the index, throws if a guid was added more than once
+    void Finalize();
+
+    inline const std::vector<PackEntryDesc>& GetEntries() const { return m_Entries; }
+
+private:
+    OFileStream m_File;
+    std::vector<PackEntryDesc> m_Entries;
+};
+
+// Not thread safe, entries are read through a single file stream
+class ETH_COMMON_DLL PackFileReader : public NonCopyable
+{
+public:
+    // Throws if the file is not a pack, or its index is damaged (entries out of range, misaligned or overlapping)
+    PackFileReader(const std::string& path);
+    ~PackFileReader() = default;
+
+public:
+    const PackEntryDesc* Find(const std::string& guid) const;
+    // Throws if the entry could not be read or decompressed
+    std::unique_ptr<IByteStream> Read(const PackEntryDesc& entry);
+
+    inline const std::vector<PackEntryDesc>& GetEntries() const { return m_Entries; }
+
+private:
+    IFileStream m_File;
+    std::vector<PackEntryDesc> m_Entries;
+};
+} // namespace Ether
@@ -53,6 +53,12 @@ public:
     virtual IStream& operator>>(ethVector4& v) = 0;
 
     virtual void ReadBytes(void* dest, uint32_t numBytes) = 0;
+    // Moves past data that is not needed right now (e.g. texture mips that are streamed in later)
+    virtual void Skip(size_t numBytes) = 0;
+
+    // Where the data that is read next is located on disk, so that it can be read again later on without
+    // this stream. Returns false if the stream is not backed by a file.
+    virtual bool GetFileLocation(std::string& path, size_t& offset) { return false; }
 };
 
 class ETH_COMMON_DLL OStream : public Stream
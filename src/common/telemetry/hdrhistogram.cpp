@@ -0,0 +1,164 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/telemetry/hdrhistogram.h"
+
+#include <bit>
+#include <cmath>
+
+Ether::HdrHistogram::HdrHistogram(uint64_t highestTrackableValue, uint32_t numSignificantDigits)
+    : m_HighestTrackableValue((std::max)(highestTrackableValue, uint64_t(2)))
+    , m_TotalCount(0)
+    , m_TotalSum(0)
+    , m_Min((std::numeric_limits<uint64_t>::max)())
+    , m_Max(0)
+{
+    assert(numSignificantDigits >= 1 && numSignificantDigits <= 5 && "Unsupported histogram precision");
+
+    // Enough linear sub-buckets to resolve the requested number of digits within one power of two
+    const uint64_t largestValueWithSingleUnitResolution = 2 * static_cast<uint64_t>(std::pow(10, numSignificantDigits));
+    const uint32_t subBucketCountMagnitude = std::bit_width(largestValueWithSingleUnitResolution - 1);
+
+    m_SubBucketHalfCountMagnitude = (std::max)(subBucketCountMagnitude, 1u) - 1;
+    m_SubBucketCount = 1u << (m_SubBucketHalfCountMagnitude + 1);
+    m_SubBucketHalfCount = m_SubBucketCount / 2;
+    m_SubBucketMask = m_SubBucketCount - 1;
+
+    uint64_t smallestUntrackableValue = m_SubBucketCount;
+    m_BucketCount = 1;
+    while (smallestUntrackableValue <= m_HighestTrackableValue)
+    {
+        if (smallestUntrackableValue > (std::numeric_limits<uint64_t>::max)() / 2)
+        {
+            m_BucketCount++;
+            break;
+        }
+
+        smallestUntrackableValue <<= 1;
+        m_BucketCount++;
+    }
+
+    m_Counts.resize((m_BucketCount + 1) * m_SubBucketHalfCount, 0);
+}
+
+void Ether::HdrHistogram::Record(uint64_t value, uint64_t count)
+{
+    value = (std::min)(value, m_HighestTrackableValue);
+
+    m_Counts[GetCountsIndex(value)] += count;
+    m_TotalCount += count;
+    m_TotalSum += value * count;
+    m_Min = (std::min)(m_Min, value);
+    m_Max = (std::max)(m_Max, value);
+}
+
+void Ether::HdrHistogram::Merge(const HdrHistogram& other)
+{
+    if (other.m_SubBucketCount == m_SubBucketCount && other.m_Counts.size() <= m_Counts.size())
+    {
+        for (size_t i = 0; i < other.m_Counts.size(); ++i)
+            m_Counts[i] += other.m_Counts[i];
+
+        m_TotalCount += other.m_TotalCount;
+        m_TotalSum += other.m_TotalSum;
+        m_Min = (std::min)(m_Min, other.m_Min);
+        m_Max = (std::max)(m_Max, (std::min)(other.m_Max, m_HighestTrackableValue));
+        return;
+    }
+
+    if (other.m_TotalCount == 0)
+        return;
+
+    const uint64_t min = (std::min)(m_Min, (std::min)(other.m_Min, m_HighestTrackableValue));
+    const uint64_t max = (std::max)(m_Max, (std::min)(other.m_Max, m_HighestTrackableValue));
+
+    // Different layouts, re-record each bucket at its representative value
+    for (size_t i = 0; i < other.m_Counts.size(); ++i)
+    {
+        if (other.m_Counts[i] != 0)
+            Record(other.GetHighestEquivalentValue(other.GetValueFromIndex(i)), other.m_Counts[i]);
+    }
+
+    // Which moves the extremes to the top of their buckets, even though both are known exactly
+    m_Min = min;
+    m_Max = max;
+}
+
+void Ether::HdrHistogram::Clear()
+{
+    std::fill(m_Counts.begin(), m_Counts.end(), 0);
+    m_TotalCount = 0;
+    m_TotalSum = 0;
+    m_Min = (std::numeric_limits<uint64_t>::max)();
+    m_Max = 0;
+}
+
+uint64_t Ether::HdrHistogram::GetValueAtPercentile(double percentile) const
+{
+    if (m_TotalCount == 0)
+        return 0;
+
+    percentile = (std::min)((std::max)(percentile, 0.0), 100.0);
+    const uint64_t countAtPercentile = (std::max)(uint64_t(1), static_cast<uint64_t>(percentile / 100.0 * m_TotalCount + 0.5));
+
+    uint64_t runningCount = 0;
+    for (size_t i = 0; i < m_Counts.size(); ++i)
+    {
+        runningCount += m_Counts[i];
+        if (runningCount >= countAtPercentile)
+            return (std::min)(GetHighestEquivalentValue(GetValueFromIndex(i)), m_Max);
+    }
+
+    return m_Max;
+}
+
+size_t Ether::HdrHistogram::GetCountsIndex(uint64_t value) const
+{
+    // Position of the highest set bit decides the bucket, the bits below it the sub-bucket
+    const uint32_t pow2Ceiling = std::bit_width(value | m_SubBucketMask);
+    const uint32_t bucketIndex = pow2Ceiling - (m_SubBucketHalfCountMagnitude + 1);
+    const uint32_t subBucketIndex = static_cast<uint32_t>(value >> bucketIndex);
+
+    // Bucket 0 has a full set of sub-buckets, every other bucket only uses its top half
+    return (size_t(bucketIndex + 1) << m_SubBucketHalfCountMagnitude) + subBucketIndex - m_SubBucketHalfCount;
+}
+
+uint64_t Ether::HdrHistogram::GetValueFromIndex(size_t index) const
+{
+    int32_t bucketIndex = static_cast<int32_t>(index >> m_SubBucketHalfCountMagnitude) - 1;
+    uint32_t subBucketIndex = static_cast<uint32_t>(index & (m_SubBucketHalfCount - 1)) + m_SubBucketHalfCount;
+
+    if (bucketIndex < 0)
+    {
+        subBucketIndex -= m_SubBucketHalfCount;
+        bucketIndex = 0;
+    }
+
+    return uint64_t(subBucketIndex) << bucketIndex;
+}
+
+uint64_t Ether::HdrHistogram::GetHighestEquivalentValue(uint64_t value) const
+{
+    const uint32_t bucketIndex = std::bit_width(value | m_SubBucketMask) - (m_SubBucketHalfCountMagnitude + 1);
+    const uint64_t subBucketIndex = value >> bucketIndex;
+    const uint32_t adjustedBucket = subBucketIndex >= m_SubBucketCount ? bucketIndex + 1 : bucketIndex;
+    const uint64_t lowestEquivalentValue = (subBucketIndex << bucketIndex);
+
+    return lowestEquivalentValue + (uint64_t(1) << adjustedBucket) - 1;
+}
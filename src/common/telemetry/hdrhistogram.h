@@ -0,0 +1,79 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+
+#include <vector>
+
+namespace Ether
+{
+/*
+    High dynamic range histogram (after Gil Tene's HdrHistogram). Values are bucketed so that
+    every recorded value can be reconstructed to within a fixed number of significant digits,
+    regardless of magnitude, with constant time recording and a fixed memory footprint.
+
+    Bucket i covers [2^i, 2^(i+1)) * subBucketHalfCount with subBucketHalfCount linear sub-buckets,
+    except bucket 0 which also covers [0, subBucketHalfCount).
+
+    Values above the highest trackable value are clamped to it (and counted as such in GetMax()).
+*/
+class ETH_COMMON_DLL HdrHistogram
+{
+public:
+    HdrHistogram(uint64_t highestTrackableValue, uint32_t numSignificantDigits = 3);
+    ~HdrHistogram() = default;
+
+public:
+    void Record(uint64_t value, uint64_t count = 1);
+    void Merge(const HdrHistogram& other);
+    void Clear();
+
+    // Percentile in [0, 100]. Returns the highest value equivalent to the one at that percentile,
+    // so that the result is never lower than the true percentile.
+    uint64_t GetValueAtPercentile(double percentile) const;
+
+    inline uint64_t GetTotalCount() const { return m_TotalCount; }
+    inline uint64_t GetMin() const { return m_TotalCount == 0 ? 0 : m_Min; }
+    inline uint64_t GetMax() const { return m_Max; }
+    inline double GetMean() const { return m_TotalCount == 0 ? 0.0 : double(m_TotalSum) / m_TotalCount; }
+    inline uint64_t GetHighestTrackableValue() const { return m_HighestTrackableValue; }
+    inline size_t GetMemorySize() const { return m_Counts.size() * sizeof(uint64_t); }
+
+private:
+    size_t GetCountsIndex(uint64_t value) const;
+    uint64_t GetValueFromIndex(size_t index) const;
+    uint64_t GetHighestEquivalentValue(uint64_t value) const;
+
+private:
+    const uint64_t m_HighestTrackableValue;
+    uint32_t m_SubBucketCount;
+    uint32_t m_SubBucketHalfCount;
+    uint32_t m_SubBucketHalfCountMagnitude;
+    uint64_t m_SubBucketMask;
+    uint32_t m_BucketCount;
+
+    std::vector<uint64_t> m_Counts;
+    uint64_t m_TotalCount;
+    uint64_t m_TotalSum;
+    uint64_t m_Min;
+    uint64_t m_Max;
+};
+} // namespace Ether
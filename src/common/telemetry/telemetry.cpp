@@ -0,0 +1,234 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/telemetry/telemetry.h"
+#include "common/logging/loggingmanager.h"
+
+#include <fstream>
+#include <filesystem>
+
+// Samples are stored in microseconds, up to 10 seconds per frame at 3 significant digits
+constexpr uint64_t HighestTrackableTime = 10 * 1000 * 1000;
+constexpr uint32_t NumSignificantDigits = 3;
+
+namespace
+{
+double ToMilliseconds(uint64_t microseconds)
+{
+    return microseconds / 1000.0;
+}
+
+std::string EscapeJson(const std::string& str)
+{
+    std::string escaped;
+    escaped.reserve(str.size());
+
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+
+        if (static_cast<unsigned char>(c) < 0x20)
+            escaped += ' ';
+        else
+            escaped += c;
+    }
+
+    return escaped;
+}
+
+std::string EscapeCsv(const std::string& str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos)
+        return str;
+
+    std::string escaped = "\"";
+    for (const char c : str)
+    {
+        if (c == '"')
+            escaped += '"';
+        escaped += c;
+    }
+
+    return escaped + "\"";
+}
+} // namespace
+
+Ether::Telemetry::Channel::Channel(const std::string& name)
+    : m_Name(name)
+    , m_Histogram(HighestTrackableTime, NumSignificantDigits)
+    , m_FrameTime(0)
+    , m_IsRecordedThisFrame(false)
+{
+}
+
+Ether::Telemetry::Telemetry()
+    : m_FrameStartTime(0)
+    , m_NumFrames(0)
+{
+}
+
+Ether::Telemetry::~Telemetry()
+{
+}
+
+void Ether::Telemetry::BeginFrame()
+{
+    m_FrameStartTime = Time::GetTimestamp();
+}
+
+void Ether::Telemetry::EndFrame()
+{
+    Record(FrameChannelName, Time::GetTimestamp() - m_FrameStartTime);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for (const std::unique_ptr<Channel>& channel : m_Channels)
+    {
+        if (!channel->m_IsRecordedThisFrame)
+            continue;
+
+        channel->m_Histogram.Record(channel->m_FrameTime / 1000);
+        channel->m_FrameTime = 0;
+        channel->m_IsRecordedThisFrame = false;
+    }
+
+    m_NumFrames++;
+}
+
+void Ether::Telemetry::Record(const std::string& channelName, uint64_t nanoseconds)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Channel& channel = GetOrCreateChannel(channelName);
+    channel.m_FrameTime += nanoseconds;
+    channel.m_IsRecordedThisFrame = true;
+}
+
+void Ether::Telemetry::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for (const std::unique_ptr<Channel>& channel : m_Channels)
+        channel->m_Histogram.Clear();
+
+    m_NumFrames = 0;
+}
+
+std::vector<std::string> Ether::Telemetry::GetChannelNames() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::vector<std::string> names;
+    for (const std::unique_ptr<Channel>& channel : m_Channels)
+        names.push_back(channel->m_Name);
+
+    return names;
+}
+
+Ether::TelemetrySummary Ether::Telemetry::GetSummary(const std::string& channel) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    const auto iter = m_ChannelMap.find(channel);
+    if (iter == m_ChannelMap.end())
+        return {};
+
+    return Summarize(*iter->second);
+}
+
+bool Ether::Telemetry::Export(const std::string& path) const
+{
+    if (std::filesystem::path(path).extension() == ".json")
+        return ExportJson(path);
+
+    return ExportCsv(path);
+}
+
+bool Ether::Telemetry::ExportCsv(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        LogWarning("Unable to open %s for telemetry export", path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    file << "channel,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+    for (const std::unique_ptr<Channel>& channel : m_Channels)
+    {
+        const TelemetrySummary summary = Summarize(*channel);
+        file << EscapeCsv(channel->m_Name) << "," << summary.m_NumFrames << "," << summary.m_Mean << ","
+             << summary.m_P50 << "," << summary.m_P95 << "," << summary.m_P99 << "," << summary.m_Max << "\n";
+    }
+
+    return file.good();
+}
+
+bool Ether::Telemetry::ExportJson(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        LogWarning("Unable to open %s for telemetry export", path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    file << "{\n    \"frames\": " << m_NumFrames << ",\n    \"channels\": [";
+    for (size_t i = 0; i < m_Channels.size(); ++i)
+    {
+        const TelemetrySummary summary = Summarize(*m_Channels[i]);
+        file << (i == 0 ? "\n" : ",\n");
+        file << "        { \"name\": \"" << EscapeJson(m_Channels[i]->m_Name) << "\", \"frames\": " << summary.m_NumFrames
+             << ", \"mean_ms\": " << summary.m_Mean << ", \"p50_ms\": " << summary.m_P50
+             << ", \"p95_ms\": " << summary.m_P95 << ", \"p99_ms\": " << summary.m_P99
+             << ", \"max_ms\": " << summary.m_Max << " }";
+    }
+    file << "\n    ]\n}\n";
+
+    return file.good();
+}
+
+Ether::Telemetry::Channel& Ether::Telemetry::GetOrCreateChannel(const std::string& name)
+{
+    const auto iter = m_ChannelMap.find(name);
+    if (iter != m_ChannelMap.end())
+        return *iter->second;
+
+    m_Channels.emplace_back(std::make_unique<Channel>(name));
+    m_ChannelMap.emplace(name, m_Channels.back().get());
+    return *m_Channels.back();
+}
+
+Ether::TelemetrySummary Ether::Telemetry::Summarize(const Channel& channel)
+{
+    const HdrHistogram& histogram = channel.m_Histogram;
+
+    TelemetrySummary summary;
+    summary.m_NumFrames = histogram.GetTotalCount();
+    summary.m_Mean = histogram.GetMean() / 1000.0;
+    summary.m_P50 = ToMilliseconds(histogram.GetValueAtPercentile(50.0));
+    summary.m_P95 = ToMilliseconds(histogram.GetValueAtPercentile(95.0));
+    summary.m_P99 = ToMilliseconds(histogram.GetValueAtPercentile(99.0));
+    summary.m_Max = ToMilliseconds(histogram.GetMax());
+    return summary;
+}
@@ -0,0 +1,119 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+#include "common/telemetry/hdrhistogram.h"
+#include "common/time/time.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Ether
+{
+// All times in milliseconds
+struct TelemetrySummary
+{
+    uint64_t m_NumFrames;
+    double m_Mean;
+    double m_P50;
+    double m_P95;
+    double m_P99;
+    double m_Max;
+};
+
+/*
+    Per-frame CPU timings, one histogram per channel (engine stage, graphic producer, ...).
+
+    Everything recorded into a channel between BeginFrame() and EndFrame() is summed, and the sum
+    is added to the channel's histogram as a single sample when the frame ends. Channels that were
+    not recorded to in a frame (e.g. a disabled producer) get no sample for that frame.
+
+    The whole frame is recorded into the "Frame" channel.
+*/
+class ETH_COMMON_DLL Telemetry : public Singleton<Telemetry>
+{
+public:
+    Telemetry();
+    ~Telemetry();
+
+public:
+    void BeginFrame();
+    void EndFrame();
+
+    // Thread safe. The time is added to the channel's total for the current frame.
+    void Record(const std::string& channel, uint64_t nanoseconds);
+    void Clear();
+
+public:
+    std::vector<std::string> GetChannelNames() const;
+    TelemetrySummary GetSummary(const std::string& channel) const;
+    inline uint64_t GetNumFrames() const { return m_NumFrames; }
+
+    // Export() picks the format from the extension (.json, anything else is CSV)
+    bool Export(const std::string& path) const;
+    bool ExportCsv(const std::string& path) const;
+    bool ExportJson(const std::string& path) const;
+
+public:
+    static constexpr char FrameChannelName[] = "Frame";
+
+private:
+    struct Channel
+    {
+        Channel(const std::string& name);
+
+        const std::string m_Name;
+        HdrHistogram m_Histogram;
+        uint64_t m_FrameTime;
+        bool m_IsRecordedThisFrame;
+    };
+
+    Channel& GetOrCreateChannel(const std::string& name);
+    static TelemetrySummary Summarize(const Channel& channel);
+
+private:
+    // In registration order, so that exports are stable from run to run
+    std::vector<std::unique_ptr<Channel>> m_Channels;
+    std::unordered_map<std::string, Channel*> m_ChannelMap;
+    mutable std::mutex m_Mutex;
+
+    uint64_t m_FrameStartTime;
+    uint64_t m_NumFrames;
+};
+
+// Records the lifetime of the scope into a telemetry channel
+class ScopedTelemetry : public NonCopyable, public NonMovable
+{
+public:
+    ScopedTelemetry(const std::string& channel)
+        : m_Channel(channel)
+        , m_StartTime(Time::GetTimestamp())
+    {
+    }
+
+    ~ScopedTelemetry() { Telemetry::Instance().Record(m_Channel, Time::GetTimestamp() - m_StartTime); }
+
+private:
+    const std::string m_Channel;
+    const uint64_t m_StartTime;
+};
+} // namespace Ether
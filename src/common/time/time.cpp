@@ -25,10 +25,29 @@ void Ether::Time::Initialize()
     m_StartupTime = Clock::now();
     m_PreviousTime = m_StartupTime;
     m_CurrentFrameTime = m_StartupTime;
+    m_StartupWallTime = WallClock::now();
 }
 
 void Ether::Time::NewFrame_Impl()
 {
     m_PreviousTime = m_CurrentFrameTime;
-    m_CurrentFrameTime = Clock::now();
+
+    if (m_NextFrameTime.has_value())
+    {
+        m_CurrentFrameTime = TimePoint(Duration(*m_NextFrameTime));
+        m_NextFrameTime.reset();
+    }
+    else if (m_FixedDeltaTime > 0.0)
+        m_CurrentFrameTime = m_PreviousTime + Duration(m_FixedDeltaTime);
+    else
+        m_CurrentFrameTime = Clock::now();
+}
+
+void Ether::Time::Rebase(double startupTime, double currentTime)
+{
+    Time& time = Instance();
+    time.m_StartupTime = TimePoint(Duration(startupTime));
+    time.m_PreviousTime = TimePoint(Duration(currentTime));
+    time.m_CurrentFrameTime = time.m_PreviousTime;
+    time.m_NextFrameTime.reset();
 }
@@ -22,9 +22,15 @@
 #include "common/common.h"
 
 #include <chrono>
+#include <optional>
 
 namespace Ether
 {
+/*
+    All frame and profiling times come from a monotonic clock (QueryPerformanceCounter on Windows),
+    so they never jump when the system clock is adjusted. Their epoch is arbitrary: only use them
+    for differences. Calendar time, e.g. for log timestamps, comes from the Wall* accessors.
+*/
 class ETH_COMMON_DLL Time : public Singleton<Time>
 {
 public:
@@ -36,6 +42,17 @@ public:
 public:
     static inline void NewFrame() { Instance().NewFrame_Impl(); }
 
+    // When non-zero, every frame advances frame time by exactly this much (in milliseconds)
+    // regardless of how long it actually took, so that simulation is reproducible run to run.
+    static inline void SetFixedDeltaTime(double deltaTime) { Instance().m_FixedDeltaTime = deltaTime; }
+    static inline double GetFixedDeltaTime() { return Instance().m_FixedDeltaTime; }
+
+    // For replaying a recorded session (see InputRecorder), where every frame has to see exactly the
+    // times it was recorded with. Rebase() moves the clock to the recorded state, SetNextFrameTime()
+    // makes the next NewFrame() advance to the given time instead of reading the clock.
+    static void Rebase(double startupTime, double currentTime);
+    static inline void SetNextFrameTime(double time) { Instance().m_NextFrameTime = time; }
+
     static inline double GetStartupTime() { return Instance().m_StartupTime.time_since_epoch().count(); }
     static inline double GetCurrentTime() { return Instance().m_CurrentFrameTime.time_since_epoch().count(); }
     static inline double GetTimeSinceStartup() { return GetCurrentTime() - GetStartupTime(); }
@@ -43,15 +60,27 @@ public:
     static inline double GetRealTimeSinceStartup() { return GetRealTime() - GetStartupTime(); }
     static inline double GetDeltaTime() { return GetCurrentTime() - GetPreviousTime(); }
 
+    // Raw monotonic timestamp in nanoseconds, for profiling. Cheap enough to call per scope.
+    static inline uint64_t GetTimestamp() { return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count(); }
+    static inline double TimestampToMilliseconds(uint64_t timestamp) { return timestamp / 1000000.0; }
+
+    // Milliseconds since the unix epoch
+    static inline double GetStartupWallTime() { return Instance().m_StartupWallTime.time_since_epoch().count(); }
+    static inline double GetWallTime() { return WallTimePoint(WallClock::now()).time_since_epoch().count(); }
+
 private:
     static inline double GetPreviousTime() { return Instance().m_PreviousTime.time_since_epoch().count(); }
 
 private:
-    // Only ever use high resolution clock
-    using Clock = std::chrono::system_clock;
+    using Clock = std::chrono::steady_clock;
     using Duration = std::chrono::duration<double, std::milli>;
     using TimePoint = std::chrono::time_point<Clock, Duration>;
 
+    using WallClock = std::chrono::system_clock;
+    using WallTimePoint = std::chrono::time_point<WallClock, Duration>;
+
+    static_assert(Clock::is_steady, "Frame time must come from a monotonic clock");
+
 private:
     void NewFrame_Impl();
 
@@ -59,6 +88,10 @@ private:
     TimePoint m_StartupTime;
     TimePoint m_PreviousTime;
     TimePoint m_CurrentFrameTime;
+    WallTimePoint m_StartupWallTime;
+
+    double m_FixedDeltaTime = 0.0;
+    std::optional<double> m_NextFrameTime;
 };
 
 } // namespace Ether
@@ -45,21 +45,27 @@ void Ether::Serializable::Serialize(OStream& ostream) const
 }
 
 void Ether::Serializable::Deserialize(IStream& istream)
+{
+    DeserializeVersioned(istream, m_Version);
+}
+
+uint32_t Ether::Serializable::DeserializeVersioned(IStream& istream, uint32_t oldestVersion)
 {
     uint32_t version = 0;
     std::string classID;
     istream >> version;
     istream >> classID;
 
-    if (m_Version != version)
+    if (version < oldestVersion || version > m_Version)
         throw std::runtime_error(
-            std::format("Asset version mismatch - expected version {} but found version {}", version, m_Version));
+            std::format("Asset version mismatch - expected version {} but found version {}", m_Version, version));
 
     if (m_ClassID != classID)
         throw std::runtime_error(
-            std::format("Asset type mismatch - expected type {} but found type {}", version, m_Version));
+            std::format("Asset type mismatch - expected type {} but found type {}", m_ClassID, classID));
 
     istream >> m_Guid;
+    return version;
 }
 
 std::string Ether::Serializable::DeserializeClassID(IStream& istream)
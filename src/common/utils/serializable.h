@@ -37,6 +37,7 @@ public:
     virtual ~Serializable() = 0;
 
     inline std::string GetGuid() const { return m_Guid; }
+    inline uint32_t GetVersion() const { return m_Version; }
 
     virtual void Serialize(OStream& ostream) const;
     virtual void Deserialize(IStream& istream);
@@ -44,6 +45,11 @@ public:
 public:
     static std::string DeserializeClassID(IStream& istream);
 
+protected:
+    // Reads the header written by Serialize(), accepting any version from oldestVersion up to the
+    // current one. Returns the version that the data was written with.
+    uint32_t DeserializeVersioned(IStream& istream, uint32_t oldestVersion);
+
 protected:
     std::string m_Guid;
     uint32_t m_Version;
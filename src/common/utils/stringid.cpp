@@ -20,6 +20,7 @@
 #include "common/utils/stringid.h"
 
 std::unordered_map<Ether::sid_t, std::string> Ether::StringID::s_HashToStringMap;
+std::shared_mutex Ether::StringID::s_HashToStringMutex;
 
 // Fast CRC32
 // https://create.stephan-brumme.com/crc32/#bitwise
@@ -56,11 +57,12 @@ Ether::StringID::StringID()
 Ether::StringID::StringID(const char* str)
     : m_Hash(Hash(str))
 {
-    s_HashToStringMap[m_Hash] = str;
+    RegisterString(m_Hash, str);
 }
 
 std::string Ether::StringID::GetString() const
 {
+    std::shared_lock<std::shared_mutex> lock(s_HashToStringMutex);
     return s_HashToStringMap.find(m_Hash) == s_HashToStringMap.end() ? "Unknown StringID"
                                                                      : s_HashToStringMap.at(m_Hash);
 }
@@ -68,7 +70,7 @@ std::string Ether::StringID::GetString() const
 Ether::StringID::StringID(const std::string& str)
     : m_Hash(Hash(str.c_str()))
 {
-    s_HashToStringMap[m_Hash] = str;
+    RegisterString(m_Hash, str.c_str());
 }
 
 bool Ether::StringID::operator==(const std::string& other) const
@@ -90,3 +92,17 @@ Ether::sid_t Ether::StringID::Hash(const char* str)
 {
     return crc32_bitwise(str, std::char_traits<char>::length(str));
 }
+
+void Ether::StringID::RegisterString(sid_t hash, const char* str)
+{
+    // Most strings have been seen before, so check under the shared lock first
+    {
+        std::shared_lock<std::shared_mutex> lock(s_HashToStringMutex);
+        const auto iter = s_HashToStringMap.find(hash);
+        if (iter != s_HashToStringMap.end() && iter->second == str)
+            return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(s_HashToStringMutex);
+    s_HashToStringMap[hash] = str;
+}
@@ -20,6 +20,8 @@
 #pragma once
 
 #include "common/common.h"
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
@@ -45,10 +47,14 @@ public:
 
 private:
     static sid_t Hash(const char* str);
+    static void RegisterString(sid_t hash, const char* str);
 
 private:
     sid_t m_Hash;
+
+    // StringIDs are also created on loader threads (e.g. guids of streamed resources)
     static std::unordered_map<sid_t, std::string> s_HashToStringMap;
+    static std::shared_mutex s_HashToStringMutex;
 };
 
 // Make sure the size of StringID is no larger than its internal representation.
@@ -19,12 +19,20 @@
 
 #include "api.h"
 #include "engine/enginecore.h"
+#include "engine/input/inputrecorder.h"
+#include "common/telemetry/telemetry.h"
 
 int Ether::Start(IApplicationBase& app)
 {
+    // E.g. to replay a recorded session (-replayinput) on a machine without a display
+    if (EngineCore::GetCommandLineOptions().GetUseHeadless())
+        return StartHeadless(app);
+
     Time::Instance().Initialize();
+    Telemetry::Instance();
     Input::Instance().Initialize();
     LoggingManager::Instance().Initialize();
+    JobSystem::Instance().Initialize();
 
     LogInfo("Starting Ether v%d.%d.%d", 0, 1, 0);
     EngineCore::Instance().Initialize();
@@ -36,7 +44,35 @@ int Ether::Start(IApplicationBase& app)
     LogInfo("Shutting down Ether");
     EngineCore::Instance().Shutdown();
 
+    JobSystem::Reset();
+    InputRecorder::Reset();
     Input::Reset();
+    Telemetry::Reset();
+    Time::Reset();
+    LoggingManager::Reset();
+    return 0;
+}
+
+int Ether::StartHeadless(IApplicationBase& app)
+{
+    Time::Instance().Initialize();
+    Telemetry::Instance();
+    Input::Instance().Initialize();
+    LoggingManager::Instance().Initialize();
+    JobSystem::Instance().Initialize();
+
+    LogInfo("Starting Ether v%d.%d.%d (headless)", 0, 1, 0);
+    EngineCore::Instance().InitializeHeadless();
+    EngineCore::Instance().LoadApplication(app);
+    EngineCore::Instance().RunHeadlessLoop();
+
+    LogInfo("Shutting down Ether");
+    EngineCore::Instance().Shutdown();
+
+    JobSystem::Reset();
+    InputRecorder::Reset();
+    Input::Reset();
+    Telemetry::Reset();
     Time::Reset();
     LoggingManager::Reset();
     return 0;
@@ -44,6 +80,7 @@ int Ether::Start(IApplicationBase& app)
 
 void Ether::Shutdown()
 {
+    EngineCore::Instance().RequestShutdown();
 }
 
 Ether::CommandLineOptions& Ether::GetCommandLineOptions()
@@ -63,6 +100,9 @@ Ether::Graphics::GraphicConfig& Ether::Graphics::GetGraphicConfig()
 
 void Ether::Client::SetClientTitle(const std::string& title)
 {
+    if (EngineCore::IsHeadless())
+        return;
+
     EngineCore::GetMainWindow().SetTitle(title);
 }
 
@@ -73,6 +113,9 @@ std::string Ether::Client::GetClientTitle()
 
 void Ether::Client::SetClientSize(const ethVector2u& size)
 {
+    if (EngineCore::IsHeadless())
+        return;
+
     EngineCore::GetMainWindow().SetClientSize(size);
 }
 
@@ -82,31 +125,49 @@ Ether::ethVector2u Ether::Client::GetClientSize()
 }
 void Ether::Client::SetFullscreen(bool enabled)
 {
+    if (EngineCore::IsHeadless())
+        return;
+
     EngineCore::GetMainWindow().SetFullscreen(enabled);
 }
 
 bool Ether::Client::IsFullscreen()
 {
+    if (EngineCore::IsHeadless())
+        return false;
+
     return EngineCore::GetMainWindow().IsFullscreen();
 }
 
 void Ether::Toolmode::SetParentWindow(void* hwnd)
 {
+    if (EngineCore::IsHeadless())
+        return;
+
     EngineCore::GetMainWindow().SetParentWindowHandle(hwnd);
 }
 
 void* Ether::Toolmode::GetWindowHandle()
 {
+    if (EngineCore::IsHeadless())
+        return nullptr;
+
     return EngineCore::GetMainWindow().GetWindowHandle();
 }
 
 void Ether::Toolmode::ShowWindow()
 {
+    if (EngineCore::IsHeadless())
+        return;
+
     EngineCore::GetMainWindow().Show();
 }
 
 void Ether::Toolmode::HideWindow()
 {
+    if (EngineCore::IsHeadless())
+        return;
+
     EngineCore::GetMainWindow().Hide();
 }
 
@@ -30,6 +30,10 @@
 namespace Ether
 {
 ETH_ENGINE_DLL int Start(IApplicationBase& app);
+// Runs without a window or a graphics device, until Shutdown() is called. Only the CPU side of
+// the renderer runs (see Graphics::HeadlessRenderer). Meant for benchmarks and automation.
+ETH_ENGINE_DLL int StartHeadless(IApplicationBase& app);
+// Exits the engine loop at the end of the current frame
 ETH_ENGINE_DLL void Shutdown();
 
 ETH_ENGINE_DLL CommandLineOptions& GetCommandLineOptions();
@@ -29,8 +29,17 @@ Ether::CommandLineOptions::CommandLineOptions()
     : m_UseSourceShaders(false)
     , m_UseShaderDaemon(false)
     , m_UseValidationLayer(false)
+    , m_ReportMemoryLeaks(false)
+    , m_UseHeadless(false)
+    , m_UseRenderThread(false)
     , m_WorldName("")
     , m_ShaderSourcePath(".\\Data\\shaders\\")
+    , m_TelemetryExportPath("")
+    , m_BenchmarkConfigPath("")
+    , m_WorldGeneratorConfigPath("")
+    , m_InputRecordPath("")
+    , m_InputReplayPath("")
+    , m_InputReplayTimestep(0.0)
 #if defined(ETH_TOOLMODE)
     , m_WorkspacePath("")
     , m_ToolmodePort(2134)
@@ -57,8 +66,26 @@ void Ether::CommandLineOptions::RegisterSingleOption(const std::string& flag, co
         m_UseShaderDaemon = true;
     else if (flag == "-validationlayer")
         m_UseValidationLayer = true;
+    else if (flag == "-memoryreport")
+        m_ReportMemoryLeaks = true;
     else if (flag == "-world")
         m_WorldName = arg;
+    else if (flag == "-telemetry")
+        m_TelemetryExportPath = arg;
+    else if (flag == "-benchmark")
+        m_BenchmarkConfigPath = arg;
+    else if (flag == "-worldgen")
+        m_WorldGeneratorConfigPath = arg;
+    else if (flag == "-recordinput")
+        m_InputRecordPath = arg;
+    else if (flag == "-replayinput")
+        m_InputReplayPath = arg;
+    else if (flag == "-replaytimestep")
+        m_InputReplayTimestep = stod(arg);
+    else if (flag == "-headless")
+        m_UseHeadless = true;
+    else if (flag == "-renderthread")
+        m_UseRenderThread = true;
 #if defined(ETH_TOOLMODE)
     else if (flag == "-workspace")
         m_WorkspacePath = arg;
@@ -33,8 +33,17 @@ public:
     inline bool GetUseSourceShaders() const { return m_UseSourceShaders; }
     inline bool GetUseShaderDaemon() const { return m_UseShaderDaemon; }
     inline bool GetUseValidationLayer() const { return m_UseValidationLayer; }
+    inline bool GetReportMemoryLeaks() const { return m_ReportMemoryLeaks; }
+    inline bool GetUseHeadless() const { return m_UseHeadless; }
+    inline bool GetUseRenderThread() const { return m_UseRenderThread; }
     inline const std::string& GetWorldName() const { return m_WorldName; }
     inline const std::string& GetShaderSourcePath() const { return m_ShaderSourcePath; }
+    inline const std::string& GetTelemetryExportPath() const { return m_TelemetryExportPath; }
+    inline const std::string& GetBenchmarkConfigPath() const { return m_BenchmarkConfigPath; }
+    inline const std::string& GetWorldGeneratorConfigPath() const { return m_WorldGeneratorConfigPath; }
+    inline const std::string& GetInputRecordPath() const { return m_InputRecordPath; }
+    inline const std::string& GetInputReplayPath() const { return m_InputReplayPath; }
+    inline double GetInputReplayTimestep() const { return m_InputReplayTimestep; }
 
 public:
     ETH_TOOLONLY(inline const std::string& GetWorkspacePath() const { return m_WorkspacePath; })
@@ -49,9 +58,18 @@ private:
     bool m_UseSourceShaders;
     bool m_UseShaderDaemon;
     bool m_UseValidationLayer;
+    bool m_ReportMemoryLeaks;
+    bool m_UseHeadless;
+    bool m_UseRenderThread;
 
     std::string m_WorldName;
     std::string m_ShaderSourcePath;
+    std::string m_TelemetryExportPath;
+    std::string m_BenchmarkConfigPath;
+    std::string m_WorldGeneratorConfigPath;
+    std::string m_InputRecordPath;
+    std::string m_InputReplayPath;
+    double m_InputReplayTimestep;
 
 private:
     ETH_TOOLONLY(std::string m_WorkspacePath);
@@ -20,6 +20,9 @@
 #include "engine/enginecore.h"
 #include "engine/platform/win32/win32window.h"
 #include "engine/platform/win32/win32notificationtray.h"
+#include "engine/input/inputrecorder.h"
+#include "common/telemetry/telemetry.h"
+#include "common/memory/memorytracker.h"
 
 void Ether::EngineCore::Initialize()
 {
@@ -32,6 +35,19 @@ void Ether::EngineCore::Initialize()
     m_IsInitialized = true;
 }
 
+void Ether::EngineCore::InitializeHeadless()
+{
+    m_IsHeadless = true;
+    m_ActiveWorld = std::make_unique<World>();
+
+    Graphics::GraphicConfig& config = Graphics::GraphicCore::GetGraphicConfig();
+    config.SetHeadless(true);
+    config.SetResolution(m_EngineConfig.GetClientSize());
+    Graphics::GraphicCore::Instance().Initialize();
+
+    m_IsInitialized = true;
+}
+
 void Ether::EngineCore::LoadApplication(IApplicationBase& app)
 {
     m_MainApplication = &app;
@@ -41,36 +57,120 @@ void Ether::EngineCore::LoadApplication(IApplicationBase& app)
 
 void Ether::EngineCore::RunEngineLoop()
 {
+    StartInputRecorder();
+
+    if (m_CommandLineOptions.GetUseRenderThread())
+        Graphics::GraphicCore::StartRenderThread();
+
     while (true)
     {
         ETH_MARKER_FRAME("Engine Frame");
 
+        // Before time advances, so that a replayed frame advances to exactly its recorded time
+        if (!InputRecorder::Instance().NewFrame())
+            break;
+
         Time::NewFrame();
         Input::NewFrame();
+        JobSystem::NewFrame();
+        Telemetry::Instance().BeginFrame();
+        MemoryTracker::NewFrame();
+
+        {
+            ScopedTelemetry telemetry("Engine - Platform Messages");
+            if (!m_MainWindow->ProcessPlatformMessages())
+                break;
+        }
 
-        if (!m_MainWindow->ProcessPlatformMessages())
+        InputRecorder::Instance().ProcessInput();
+        UpdateFrame();
+        Telemetry::Instance().EndFrame();
+
+        if (m_IsShutdownRequested)
             break;
+    }
+}
+
+void Ether::EngineCore::RunHeadlessLoop()
+{
+    StartInputRecorder();
+
+    if (m_CommandLineOptions.GetUseRenderThread())
+        Graphics::GraphicCore::StartRenderThread();
+
+    while (!m_IsShutdownRequested)
+    {
+        ETH_MARKER_FRAME("Engine Frame");
 
+        if (!InputRecorder::Instance().NewFrame())
+            break;
+
+        Time::NewFrame();
+        Input::NewFrame();
+        JobSystem::NewFrame();
+        Telemetry::Instance().BeginFrame();
+        MemoryTracker::NewFrame();
+
+        InputRecorder::Instance().ProcessInput();
+        UpdateFrame();
+        Telemetry::Instance().EndFrame();
+    }
+}
+
+void Ether::EngineCore::UpdateFrame()
+{
+    {
+        ScopedTelemetry telemetry("Engine - Application Update");
         m_MainApplication->OnUpdate({});
+    }
+
+    {
+        ScopedTelemetry telemetry("Engine - World Update");
         m_ActiveWorld->Update();
+    }
 
+    {
+        ScopedTelemetry telemetry("Engine - Graphics");
         Graphics::GraphicCore::GetGraphicConfig().SetResolution(m_EngineConfig.GetClientSize());
-        Graphics::GraphicCore::Main();
+        Graphics::GraphicCore::SubmitFrame();
     }
 }
 
 void Ether::EngineCore::Shutdown()
 {
+    InputRecorder::Instance().Stop();
+
+    // Before anything that the last frames in flight might still reference goes away
+    Graphics::GraphicCore::StopRenderThread();
     m_MainApplication->OnShutdown();
 
+    if (!m_CommandLineOptions.GetTelemetryExportPath().empty())
+    {
+        const std::string& exportPath = m_CommandLineOptions.GetTelemetryExportPath();
+        if (Telemetry::Instance().Export(exportPath))
+            LogEngineInfo("Exported telemetry for %llu frames to %s", Telemetry::Instance().GetNumFrames(), exportPath.c_str());
+    }
+
     m_ActiveWorld.reset();
     m_NotificationTray.reset();
     m_MainWindow.reset();
     Graphics::GraphicCore::Instance().Shutdown();
 
+    // Anything still live at this point is either a leak or owned by a singleton that outlives the engine
+    if (m_CommandLineOptions.GetReportMemoryLeaks())
+        MemoryTracker::ReportLeaks();
+
     m_IsInitialized = false;
 }
 
+void Ether::EngineCore::StartInputRecorder()
+{
+    if (!m_CommandLineOptions.GetInputReplayPath().empty())
+        InputRecorder::Instance().StartReplay(m_CommandLineOptions.GetInputReplayPath(), m_CommandLineOptions.GetInputReplayTimestep());
+    else if (!m_CommandLineOptions.GetInputRecordPath().empty())
+        InputRecorder::Instance().StartRecording(m_CommandLineOptions.GetInputRecordPath());
+}
+
 void Ether::EngineCore::InitializeGraphicsLayer()
 {
     Graphics::GraphicConfig& config = Graphics::GraphicCore::GetGraphicConfig();
@@ -39,10 +39,14 @@ public:
     ~EngineCore() = default;
 
     void Initialize();
+    void InitializeHeadless();
     void LoadApplication(IApplicationBase& app);
     void RunEngineLoop();
+    void RunHeadlessLoop();
     void Shutdown();
 
+    inline void RequestShutdown() { m_IsShutdownRequested = true; }
+
 public:
     static inline EngineConfig& GetEngineConfig() { return Instance().m_EngineConfig; }
     static inline CommandLineOptions& GetCommandLineOptions() { return Instance().m_CommandLineOptions; }
@@ -50,12 +54,17 @@ public:
     static inline World& GetActiveWorld() { return *Instance().m_ActiveWorld; }
 
     static inline bool IsInitialized() { return Instance().m_IsInitialized; }
+    static inline bool IsHeadless() { return Instance().m_IsHeadless; }
 
 private:
     void InitializeGraphicsLayer();
+    void StartInputRecorder();
+    void UpdateFrame();
 
 private:
     bool m_IsInitialized = false;
+    bool m_IsHeadless = false;
+    bool m_IsShutdownRequested = false;
 
     std::unique_ptr<PlatformWindow> m_MainWindow;
     std::unique_ptr<PlatformNotificationTray> m_NotificationTray;
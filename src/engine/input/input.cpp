@@ -49,7 +49,7 @@ void Ether::Input::SetMouseButtonDown(int index)
 void Ether::Input::SetMouseButtonUp(int index)
 {
     m_MouseStates[index] = false;
-    m_KeyUpCurrentFrame[index] = true;
+    m_MouseUpCurrentFrame[index] = true;
 }
 
 void Ether::Input::SetMouseWheelDelta(double delta)
@@ -63,6 +63,8 @@ public:
     void SetMousePosY(double posY);
 
 private:
+    friend class InputRecorder;
+
     void NewFrame_Impl();
     void Reset_Impl();
 
@@ -0,0 +1,380 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/input/inputrecorder.h"
+#include <filesystem>
+
+constexpr uint32_t InputLogMagic = 0x43455245; // 'EREC'
+constexpr uint32_t InputLogVersion = 0;
+
+constexpr uint8_t KeyFlagHeld = 1 << 0;
+constexpr uint8_t KeyFlagDown = 1 << 1;
+constexpr uint8_t KeyFlagUp = 1 << 2;
+
+constexpr uint32_t NumMouseButtons = 3;
+constexpr uint32_t NumMouseValues = 5;
+
+static_assert(Ether::MaxNumKeycodes <= 256, "Key codes are recorded as a single byte");
+static_assert(NumMouseButtons * 3 <= 16, "Mouse buttons are recorded as 16 bit flags");
+
+struct InputLogHeader
+{
+    uint32_t m_Magic;
+    uint32_t m_Version;
+    double m_StartupTime;
+    double m_StartTime;
+};
+
+static_assert(sizeof(InputLogHeader) == 24);
+
+template <typename T>
+static void Append(std::vector<uint8_t>& buffer, const T& value)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+Ether::InputRecorder::~InputRecorder()
+{
+    Stop();
+}
+
+void Ether::InputRecorder::StartRecording(const std::string& path)
+{
+    Stop();
+
+    try
+    {
+        m_OutputStream = std::make_unique<OFileStream>(path);
+    }
+    catch (const std::runtime_error&)
+    {
+        LogEngineError("Failed to open %s for input recording", path.c_str());
+        return;
+    }
+
+    const InputLogHeader header = { InputLogMagic, InputLogVersion, Time::GetStartupTime(), Time::GetCurrentTime() };
+    m_OutputStream->WriteBytes(&header, sizeof(header));
+
+    LogEngineInfo("Recording input to %s", path.c_str());
+}
+
+void Ether::InputRecorder::StartReplay(const std::string& path, double fixedTimestep)
+{
+    Stop();
+
+    if (!std::filesystem::exists(path))
+    {
+        LogEngineError("Input recording %s does not exist", path.c_str());
+        return;
+    }
+
+    IFileStream stream(path);
+    std::vector<uint8_t> data(stream.GetFileSize());
+    stream.ReadBytes(data.data(), static_cast<uint32_t>(data.size()));
+
+    InputLogHeader header;
+    if (data.size() < sizeof(header))
+    {
+        LogEngineError("Input recording %s is truncated", path.c_str());
+        return;
+    }
+
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.m_Magic != InputLogMagic || header.m_Version != InputLogVersion)
+    {
+        LogEngineError("%s is not an input recording of version %u", path.c_str(), InputLogVersion);
+        return;
+    }
+
+    m_ReplayData = std::move(data);
+    m_ReadOffset = sizeof(header);
+    m_ReplayTimestep = fixedTimestep;
+
+    // The first replayed frame has to see the same previous frame time as it did when it was recorded
+    Time::Rebase(header.m_StartupTime, header.m_StartTime);
+
+    if (m_ReplayTimestep > 0.0)
+        LogEngineInfo("Replaying input from %s at a fixed timestep of %.3f ms", path.c_str(), m_ReplayTimestep);
+    else
+        LogEngineInfo("Replaying input from %s", path.c_str());
+}
+
+void Ether::InputRecorder::Stop()
+{
+    if (IsRecording())
+    {
+        if (m_HasPendingFrame)
+            WriteFrame();
+
+        m_OutputStream.reset();
+        LogEngineInfo("Recorded %u frames of input", m_NumFrames);
+    }
+
+    if (IsReplaying())
+    {
+        m_ReplayData.clear();
+        LogEngineInfo("Replayed %u frames of input", m_NumFrames);
+    }
+
+    m_Frame = {};
+    m_HasPendingFrame = false;
+    m_ReadOffset = 0;
+    m_ReplayTimestep = 0.0;
+    m_NumFrames = 0;
+    std::memset(m_PreviousKeyFlags, 0, sizeof(m_PreviousKeyFlags));
+    std::memset(m_PreviousMouseValues, 0, sizeof(m_PreviousMouseValues));
+}
+
+bool Ether::InputRecorder::NewFrame()
+{
+    if (IsRecording())
+    {
+        // The previous frame is complete now, including the commands it executed
+        if (m_HasPendingFrame)
+            WriteFrame();
+
+        m_Frame.m_Commands.clear();
+        return true;
+    }
+
+    if (!IsReplaying())
+        return true;
+
+    if (!ReadFrame())
+    {
+        Stop();
+        return false;
+    }
+
+    if (m_ReplayTimestep > 0.0)
+        Time::SetNextFrameTime(Time::GetCurrentTime() + m_ReplayTimestep);
+    else
+        Time::SetNextFrameTime(m_Frame.m_FrameTime);
+
+    m_NumFrames++;
+    return true;
+}
+
+void Ether::InputRecorder::ProcessInput()
+{
+    if (IsRecording())
+    {
+        m_Frame.m_FrameTime = Time::GetCurrentTime();
+        CaptureFrame(Input::Instance());
+        m_HasPendingFrame = true;
+        m_NumFrames++;
+    }
+    else if (IsReplaying())
+        ApplyFrame(Input::Instance());
+}
+
+void Ether::InputRecorder::RecordCommand(const void* data, size_t numBytes)
+{
+    if (!IsRecording())
+        return;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_Frame.m_Commands.emplace_back(bytes, bytes + numBytes);
+}
+
+void Ether::InputRecorder::CaptureFrame(const Input& input)
+{
+    for (uint32_t key = 0; key < MaxNumKeycodes; ++key)
+    {
+        m_Frame.m_KeyFlags[key] = (input.m_KeyStates[key] ? KeyFlagHeld : 0) |
+                                  (input.m_KeyDownCurrentFrame[key] ? KeyFlagDown : 0) |
+                                  (input.m_KeyUpCurrentFrame[key] ? KeyFlagUp : 0);
+    }
+
+    m_Frame.m_MouseButtons = 0;
+    for (uint32_t i = 0; i < NumMouseButtons; ++i)
+    {
+        const uint16_t flags = (input.m_MouseStates[i] ? KeyFlagHeld : 0) |
+                               (input.m_MouseDownCurrentFrame[i] ? KeyFlagDown : 0) |
+                               (input.m_MouseUpCurrentFrame[i] ? KeyFlagUp : 0);
+
+        m_Frame.m_MouseButtons |= flags << (i * 3);
+    }
+
+    m_Frame.m_MouseValues[0] = input.m_MousePosX;
+    m_Frame.m_MouseValues[1] = input.m_MousePosY;
+    m_Frame.m_MouseValues[2] = input.m_MouseDeltaX;
+    m_Frame.m_MouseValues[3] = input.m_MouseDeltaY;
+    m_Frame.m_MouseValues[4] = input.m_MouseWheelDelta;
+}
+
+void Ether::InputRecorder::ApplyFrame(Input& input) const
+{
+    // Replaces whatever the platform delivered this frame
+    for (uint32_t key = 0; key < MaxNumKeycodes; ++key)
+    {
+        const uint8_t flags = m_Frame.m_KeyFlags[key];
+        input.m_KeyStates[key] = (flags & KeyFlagHeld) != 0;
+        input.m_KeyDownCurrentFrame[key] = (flags & KeyFlagDown) != 0;
+        input.m_KeyUpCurrentFrame[key] = (flags & KeyFlagUp) != 0;
+    }
+
+    for (uint32_t i = 0; i < NumMouseButtons; ++i)
+    {
+        const uint16_t flags = m_Frame.m_MouseButtons >> (i * 3);
+        input.m_MouseStates[i] = (flags & KeyFlagHeld) != 0;
+        input.m_MouseDownCurrentFrame[i] = (flags & KeyFlagDown) != 0;
+        input.m_MouseUpCurrentFrame[i] = (flags & KeyFlagUp) != 0;
+    }
+
+    input.m_MousePosX = m_Frame.m_MouseValues[0];
+    input.m_MousePosY = m_Frame.m_MouseValues[1];
+    input.m_MouseDeltaX = m_Frame.m_MouseValues[2];
+    input.m_MouseDeltaY = m_Frame.m_MouseValues[3];
+    input.m_MouseWheelDelta = m_Frame.m_MouseValues[4];
+}
+
+void Ether::InputRecorder::WriteFrame()
+{
+    m_WriteBuffer.clear();
+    Append(m_WriteBuffer, uint32_t(0));
+    Append(m_WriteBuffer, m_Frame.m_FrameTime);
+
+    // Most frames don't touch the keyboard or the mouse at all, so only what changed is written
+    const size_t numKeysOffset = m_WriteBuffer.size();
+    uint16_t numKeys = 0;
+    Append(m_WriteBuffer, numKeys);
+
+    for (uint32_t key = 0; key < MaxNumKeycodes; ++key)
+    {
+        if (m_Frame.m_KeyFlags[key] == m_PreviousKeyFlags[key])
+            continue;
+
+        m_WriteBuffer.push_back(static_cast<uint8_t>(key));
+        m_WriteBuffer.push_back(m_Frame.m_KeyFlags[key]);
+        m_PreviousKeyFlags[key] = m_Frame.m_KeyFlags[key];
+        numKeys++;
+    }
+
+    std::memcpy(m_WriteBuffer.data() + numKeysOffset, &numKeys, sizeof(numKeys));
+    Append(m_WriteBuffer, m_Frame.m_MouseButtons);
+
+    uint8_t mouseMask = 0;
+    for (uint32_t i = 0; i < NumMouseValues; ++i)
+        mouseMask |= m_Frame.m_MouseValues[i] != m_PreviousMouseValues[i] ? (1 << i) : 0;
+
+    m_WriteBuffer.push_back(mouseMask);
+    for (uint32_t i = 0; i < NumMouseValues; ++i)
+    {
+        if ((mouseMask & (1 << i)) != 0)
+            Append(m_WriteBuffer, m_Frame.m_MouseValues[i]);
+
+        m_PreviousMouseValues[i] = m_Frame.m_MouseValues[i];
+    }
+
+    Append(m_WriteBuffer, static_cast<uint16_t>(m_Frame.m_Commands.size()));
+    for (const std::vector<uint8_t>& command : m_Frame.m_Commands)
+    {
+        Append(m_WriteBuffer, static_cast<uint32_t>(command.size()));
+        m_WriteBuffer.insert(m_WriteBuffer.end(), command.begin(), command.end());
+    }
+
+    const uint32_t numBytes = static_cast<uint32_t>(m_WriteBuffer.size() - sizeof(uint32_t));
+    std::memcpy(m_WriteBuffer.data(), &numBytes, sizeof(numBytes));
+
+    m_OutputStream->WriteBytes(m_WriteBuffer.data(), static_cast<uint32_t>(m_WriteBuffer.size()));
+    m_HasPendingFrame = false;
+}
+
+bool Ether::InputRecorder::ReadFrame()
+{
+    uint32_t numBytes;
+    if (m_ReplayData.size() - m_ReadOffset < sizeof(numBytes))
+        return false;
+
+    std::memcpy(&numBytes, m_ReplayData.data() + m_ReadOffset, sizeof(numBytes));
+    m_ReadOffset += sizeof(numBytes);
+
+    if (numBytes > m_ReplayData.size() - m_ReadOffset)
+    {
+        LogEngineWarning("Input recording is truncated after %u frames", m_NumFrames);
+        return false;
+    }
+
+    const uint8_t* data = m_ReplayData.data() + m_ReadOffset;
+    m_ReadOffset += numBytes;
+
+    if (!DecodeFrame(data, numBytes))
+    {
+        LogEngineWarning("Input recording is malformed after %u frames", m_NumFrames);
+        return false;
+    }
+
+    return true;
+}
+
+bool Ether::InputRecorder::DecodeFrame(const uint8_t* data, size_t numBytes)
+{
+    const size_t end = numBytes;
+    size_t offset = 0;
+
+    const auto read = [&](void* dest, size_t size) {
+        if (size > end - offset)
+            return false;
+
+        std::memcpy(dest, data + offset, size);
+        offset += size;
+        return true;
+    };
+
+    uint16_t numKeys, numCommands;
+    uint8_t mouseMask;
+
+    if (!read(&m_Frame.m_FrameTime, sizeof(double)) || !read(&numKeys, sizeof(numKeys)))
+        return false;
+
+    // Keys and mouse values that are not in the frame keep their state from the previous one
+    for (uint16_t i = 0; i < numKeys; ++i)
+    {
+        uint8_t key;
+        if (!read(&key, sizeof(key)) || !read(&m_Frame.m_KeyFlags[key], sizeof(uint8_t)))
+            return false;
+    }
+
+    if (!read(&m_Frame.m_MouseButtons, sizeof(uint16_t)) || !read(&mouseMask, sizeof(mouseMask)))
+        return false;
+
+    for (uint32_t i = 0; i < NumMouseValues; ++i)
+    {
+        if ((mouseMask & (1 << i)) != 0 && !read(&m_Frame.m_MouseValues[i], sizeof(double)))
+            return false;
+    }
+
+    if (!read(&numCommands, sizeof(numCommands)))
+        return false;
+
+    m_Frame.m_Commands.resize(numCommands);
+    for (std::vector<uint8_t>& command : m_Frame.m_Commands)
+    {
+        uint32_t commandSize;
+        if (!read(&commandSize, sizeof(commandSize)) || commandSize > end - offset)
+            return false;
+
+        command.assign(data + offset, data + offset + commandSize);
+        offset += commandSize;
+    }
+
+    return offset == end;
+}
@@ -0,0 +1,110 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "engine/pch.h"
+#include "engine/input/input.h"
+#include <vector>
+
+namespace Ether
+{
+/*
+    Captures everything that drives a frame from the outside into a compact binary log, so that a
+    session can be played back exactly, e.g. to reproduce a performance problem or to compare frame
+    timings across builds (see -recordinput and -replayinput).
+
+        header: uint32 magic, uint32 version, double startupTime, double startTime
+        frame:  uint32 numBytes, followed by
+                double  frameTime
+                uint16  numKeys, then uint8 key, uint8 flags for every key that changed
+                uint16  mouse button flags, 3 bits per button
+                uint8   mouse value mask, then a double for every mouse value that changed
+                uint16  numCommands, then uint32 numBytes and the bytes of every command
+
+    Frame times are stored as absolute clock values rather than deltas, so that a replayed frame
+    sees bit for bit the same Time values as the recorded one. Keys and mouse values are stored
+    relative to the previous frame, so an idle frame costs 19 bytes. Commands are opaque to the
+    engine, toolmode uses them for the editor messages that were executed in that frame.
+
+    During replay, live input is discarded and time advances by the recorded steps regardless of
+    how long each frame actually takes. With a fixed timestep (-replaytimestep <ms>), every frame
+    advances by exactly that much instead, so that runs can be compared without the hitches of the
+    recording session. Anything that depends on the frame time will then diverge from the recording.
+*/
+class ETH_ENGINE_DLL InputRecorder : public Singleton<InputRecorder>
+{
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    void StartRecording(const std::string& path);
+    // A timestep of zero replays the recorded frame times
+    void StartReplay(const std::string& path, double fixedTimestep = 0.0);
+    void Stop();
+
+public:
+    inline bool IsRecording() const { return m_OutputStream != nullptr; }
+    inline bool IsReplaying() const { return !m_ReplayData.empty(); }
+    inline uint32_t GetNumFrames() const { return m_NumFrames; }
+
+public:
+    // Before Time::NewFrame(). Returns false once a replay has run out of frames.
+    bool NewFrame();
+
+    // Once platform messages have been processed, before anything reads Input
+    void ProcessInput();
+
+    // Stored with the current frame
+    void RecordCommand(const void* data, size_t numBytes);
+
+    // The commands that were recorded with the frame that is being replayed, in execution order
+    inline const std::vector<std::vector<uint8_t>>& GetReplayedCommands() const { return m_Frame.m_Commands; }
+
+private:
+    struct Frame
+    {
+        double m_FrameTime = 0.0;
+        uint8_t m_KeyFlags[MaxNumKeycodes] = {};
+        uint16_t m_MouseButtons = 0;
+        double m_MouseValues[5] = {};
+        std::vector<std::vector<uint8_t>> m_Commands;
+    };
+
+    void CaptureFrame(const Input& input);
+    void ApplyFrame(Input& input) const;
+    void WriteFrame();
+    bool ReadFrame();
+    bool DecodeFrame(const uint8_t* data, size_t numBytes);
+
+private:
+    std::unique_ptr<OFileStream> m_OutputStream;
+    std::vector<uint8_t> m_WriteBuffer;
+    bool m_HasPendingFrame = false;
+
+    std::vector<uint8_t> m_ReplayData;
+    size_t m_ReadOffset = 0;
+    double m_ReplayTimestep = 0.0;
+
+    Frame m_Frame;
+    uint8_t m_PreviousKeyFlags[MaxNumKeycodes] = {};
+    double m_PreviousMouseValues[5] = {};
+    uint32_t m_NumFrames = 0;
+};
+} // namespace Ether
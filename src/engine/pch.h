@@ -23,6 +23,7 @@
 
 #include "common/common.h"
 #include "common/logging/loggingmanager.h"
+#include "common/jobs/jobsystem.h"
 #include "common/stream/filestream.h"
 #include "common/stream/bytestream.h"
 
@@ -249,7 +249,8 @@ LRESULT CALLBACK Ether::Win32::Win32Window::WndProc(HWND hWnd, UINT msg, WPARAM
 
     Win32Window& win32window = static_cast<Win32Window&>(EngineCore::GetMainWindow());
 
-    if (Graphics::Dx12ImguiWrapper::Win32MessageHandler(hWnd, msg, wParam, lParam))
+    // Dear ImGui is not thread safe, and with a render thread its frames are built on that thread
+    if (!Graphics::GraphicCore::IsRenderThreadRunning() && Graphics::Dx12ImguiWrapper::Win32MessageHandler(hWnd, msg, wParam, lParam))
         return true;
 
     switch (msg)
@@ -20,7 +20,7 @@
 #include "engine/world/ecs/components/ecscameracomponent.h"
 #include "graphics/graphiccore.h"
 
-constexpr uint32_t EcsCameraComponentVersion = 2;
+constexpr uint32_t EcsCameraComponentVersion = 3;
 
 Ether::Ecs::EcsCameraComponent::EcsCameraComponent()
     : EcsToggleComponent(EcsCameraComponentVersion, "Ecs::EcsCameraComponent")
@@ -33,33 +33,14 @@ Ether::Ecs::EcsCameraComponent::EcsCameraComponent()
 {
 }
 
-void Ether::Ecs::EcsCameraComponent::Serialize(OStream& ostream) const
+Ether::ethVector2 Ether::Ecs::EcsCameraComponent::GetJitterOffset(uint32_t index) const
 {
-    EcsComponent::Serialize(ostream);
-
-    ostream << m_FieldOfView;
-    ostream << m_NearPlane;
-    ostream << m_FarPlane;
-    ostream << static_cast<uint32_t>(m_ProjectionMode);
-    ostream << static_cast<uint32_t>(m_JitterMode);
-    ostream << m_HdriTextureID;
+    return GetJitterOffset(m_JitterMode, index);
 }
 
-void Ether::Ecs::EcsCameraComponent::Deserialize(IStream& istream)
+Ether::ethVector2 Ether::Ecs::EcsCameraComponent::GetJitterOffset(JitterMode jitterMode, uint32_t index)
 {
-    EcsComponent::Deserialize(istream);
-
-    istream >> m_FieldOfView;
-    istream >> m_NearPlane;
-    istream >> m_FarPlane;
-    istream >> (uint32_t&)m_ProjectionMode;
-    istream >> (uint32_t&)m_JitterMode;
-    istream >> m_HdriTextureID;
-}
-
-Ether::ethVector2 Ether::Ecs::EcsCameraComponent::GetJitterOffset(uint32_t index) const
-{
-    switch (m_JitterMode)
+    switch (jitterMode)
     {
     case Ether::Ecs::JitterMode::None:
         return {};
@@ -84,3 +65,21 @@ Ether::Aabb Ether::Ecs::EcsCameraComponent::GetCameraSpaceFrustum() const
     simpleFrustumCs.m_Max = { 999999.0, 999999.0, m_FarPlane };
     return simpleFrustumCs;
 }
+
+const Ether::Ecs::EcsComponentInfo& Ether::Ecs::EcsCameraComponent::GetComponentInfo()
+{
+    static const EcsComponentInfo info = {
+        "Camera",
+        {
+            EcsField<EcsCameraComponent, &EcsCameraComponent::m_Enabled>("Enabled", 3),
+            EcsField<EcsCameraComponent, &EcsCameraComponent::m_FieldOfView>("FieldOfView"),
+            EcsField<EcsCameraComponent, &EcsCameraComponent::m_NearPlane>("NearPlane"),
+            EcsField<EcsCameraComponent, &EcsCameraComponent::m_FarPlane>("FarPlane"),
+            EcsField<EcsCameraComponent, &EcsCameraComponent::m_ProjectionMode>("ProjectionMode"),
+            EcsField<EcsCameraComponent, &EcsCameraComponent::m_JitterMode>("JitterMode"),
+            EcsField<EcsCameraComponent, &EcsCameraComponent::m_HdriTextureID>("HdriTexture"),
+        },
+    };
+
+    return info;
+}
@@ -43,8 +43,7 @@ public:
     ~EcsCameraComponent() override = default;
 
 public:
-    void Serialize(OStream& ostream) const override;
-    void Deserialize(IStream& istream) override;
+    static const EcsComponentInfo& GetComponentInfo();
 
 public:
     inline float GetFieldOfView() const { return m_FieldOfView; }
@@ -65,9 +64,11 @@ public:
     ethVector2 GetJitterOffset(uint32_t index) const;
     Aabb GetCameraSpaceFrustum() const;
 
+    static ethVector2 GetJitterOffset(JitterMode jitterMode, uint32_t index);
+
 private:
     template <uint32_t baseX, uint32_t baseY>
-    ethVector2 GetHaltonSequence(uint32_t index) const;
+    static ethVector2 GetHaltonSequence(uint32_t index);
 
 public:
     float m_FieldOfView;
@@ -82,7 +83,7 @@ public:
 
 
 template <uint32_t baseX, uint32_t baseY>
-ethVector2 Ether::Ecs::EcsCameraComponent::GetHaltonSequence(uint32_t index) const
+ethVector2 Ether::Ecs::EcsCameraComponent::GetHaltonSequence(uint32_t index)
 {
     static auto Halton = [](int index, int base)
     {
@@ -21,6 +21,7 @@
 
 #include "engine/pch.h"
 #include "engine/world/ecs/ecstypes.h"
+#include "engine/world/ecs/ecsreflection.h"
 
 namespace Ether::Ecs
 {
@@ -31,6 +32,14 @@ public:
     EcsComponent(uint32_t version, const char* classID);
     virtual ~EcsComponent() override = default;
 
+public:
+    // Generated from the component's reflection info, see T::GetComponentInfo()
+    void Serialize(OStream& ostream) const override;
+    void Deserialize(IStream& istream) override;
+
+    // For component arrays, which store the guid next to the fields rather than in a serializable header
+    inline void SetGuid(const std::string& guid) { m_Guid = guid; }
+
 public:
     static ComponentID s_ComponentID;
 };
@@ -41,6 +50,22 @@ Ether::Ecs::EcsComponent<T>::EcsComponent(uint32_t version, const char* classID)
 {
 }
 
+template <typename T>
+void Ether::Ecs::EcsComponent<T>::Serialize(OStream& ostream) const
+{
+    Serializable::Serialize(ostream);
+    SerializeEcsFields(ostream, T::GetComponentInfo(), static_cast<const T*>(this));
+}
+
+template <typename T>
+void Ether::Ecs::EcsComponent<T>::Deserialize(IStream& istream)
+{
+    // Unlike other serializables, older versions are accepted. Fields added since then are skipped
+    // and keep their default values.
+    const uint32_t version = Serializable::DeserializeVersioned(istream, 0);
+    DeserializeEcsFields(istream, T::GetComponentInfo(), static_cast<T*>(this), version);
+}
+
 template <typename T>
 ComponentID Ether::Ecs::EcsComponent<T>::s_ComponentID = -1;
 } // namespace Ether::Ecs
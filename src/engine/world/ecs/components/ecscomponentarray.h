@@ -21,11 +21,18 @@
 
 #include "engine/pch.h"
 #include "engine/world/ecs/ecstypes.h"
+#include "engine/world/ecs/ecsreflection.h"
+#include "common/memory/memorytracker.h"
+#include <algorithm>
 #include <array>
+#include <format>
 
 namespace Ether::Ecs
 {
-constexpr uint32_t ComponentArrayVersion = 0;
+// 0: Every slot, including dead ones, each with its own serializable header
+// 1: Live components only, as runs of consecutive entities holding just the reflected fields
+// 2: Each component's guid is stored in front of its fields
+constexpr uint32_t ComponentArrayVersion = 2;
 
 class EcsComponentArrayBase : public Serializable
 {
@@ -37,76 +44,198 @@ public:
     ~EcsComponentArrayBase() = default;
 
 public:
+    virtual void AddComponent(EntityID entityID) = 0;
     virtual void RemoveComponent(EntityID entityID) = 0;
+
+public:
+    // Type erased access for tools and world streaming, paired with the component's reflection info
+    virtual const EcsComponentInfo& GetComponentInfo() const = 0;
+    virtual uint32_t GetComponentVersion() const = 0;
+    virtual uint32_t GetNumComponents() const = 0;
+    virtual EntityID GetEntityAt(uint32_t index) const = 0;
+    virtual void* GetComponentDataAt(uint32_t index) = 0;
+
+    // Returns nullptr if the entity does not have the component
+    virtual void* GetComponentData(EntityID entityID) = 0;
 };
 
 template <typename T>
 class EcsComponentArray : public EcsComponentArrayBase
 {
 public:
-    EcsComponentArray() = default;
+    EcsComponentArray()
+        : m_NumElements(0)
+        , m_TrackedMemory(MemoryTag::Ecs)
+    {
+        // The component storage is a fixed size array, so this does not change over the array's lifetime
+        m_TrackedMemory.Set(sizeof(*this));
+    }
+
     ~EcsComponentArray() = default;
 
-    void Serialize(OStream& ostream) const override
-    {
-        Serializable::Serialize(ostream);
+    void Serialize(OStream& ostream) const override;
+    void Deserialize(IStream& istream) override;
+
+public:
+    inline T& GetComponent(EntityID entityID) { return m_ComponentArray[m_EntityToComponentIDMap.at(entityID)]; }
 
-        for (int i = 0; i < MaxNumEntities; ++i)
-            m_ComponentArray[i].Serialize(ostream);
+public:
+    void AddComponent(EntityID entityID) override;
+    void RemoveComponent(EntityID entityID) override;
+
+public:
+    inline const EcsComponentInfo& GetComponentInfo() const override { return T::GetComponentInfo(); }
+    inline uint32_t GetComponentVersion() const override { return GetEcsPrototype<T>().GetVersion(); }
+    inline uint32_t GetNumComponents() const override { return m_NumElements; }
+    inline EntityID GetEntityAt(uint32_t index) const override { return m_ComponentIDToEntityMap.at(index); }
+    inline void* GetComponentDataAt(uint32_t index) override { return &m_ComponentArray[index]; }
+    void* GetComponentData(EntityID entityID) override;
 
-        ostream << m_NumElements;
-        ostream << static_cast<uint32_t>(m_EntityToComponentIDMap.size());
-        ostream << static_cast<uint32_t>(m_ComponentIDToEntityMap.size());
+private:
+    void DeserializeLegacy(IStream& istream);
 
-        for (auto& pair : m_EntityToComponentIDMap)
-            ostream << pair.first << pair.second;
+private:
+    template <typename K, typename V>
+    using TrackedMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, TrackingAllocator<std::pair<const K, V>, MemoryTag::Ecs>>;
 
-        for (auto& pair : m_ComponentIDToEntityMap)
-            ostream << pair.first << pair.second;
-    }
+    std::array<T, MaxNumEntities> m_ComponentArray;
+    TrackedMap<EntityID, uint32_t> m_EntityToComponentIDMap;
+    TrackedMap<uint32_t, EntityID> m_ComponentIDToEntityMap;
 
-    void Deserialize(IStream& istream) override
+    uint32_t m_NumElements;
+    TrackedMemory m_TrackedMemory;
+};
+
+template <typename T>
+void Ether::Ecs::EcsComponentArray<T>::Serialize(OStream& ostream) const
+{
+    Serializable::Serialize(ostream);
+
+    // Sorted, so that neighbouring entities end up in the same run
+    std::vector<EntityID> liveEntities;
+    liveEntities.reserve(m_NumElements);
+    for (auto& pair : m_EntityToComponentIDMap)
+        liveEntities.push_back(pair.first);
+
+    std::sort(liveEntities.begin(), liveEntities.end());
+
+    std::vector<std::pair<EntityID, uint32_t>> runs;
+    for (EntityID entityID : liveEntities)
     {
-        Serializable::Deserialize(istream);
+        if (!runs.empty() && runs.back().first + runs.back().second == entityID)
+            runs.back().second++;
+        else
+            runs.emplace_back(entityID, 1);
+    }
 
-        for (int i = 0; i < MaxNumEntities; ++i)
-            m_ComponentArray[i].Deserialize(istream);
+    // Components only store their fields, the version is shared by all of them
+    ostream << m_ComponentArray[0].GetVersion();
+    ostream << static_cast<uint32_t>(runs.size());
 
-        uint32_t compToIdMapSize, entityToCompMapSize;
-        istream >> m_NumElements;
-        istream >> entityToCompMapSize;
-        istream >> compToIdMapSize;
+    const EcsComponentInfo& info = T::GetComponentInfo();
+    for (auto& run : runs)
+    {
+        ostream << run.first;
+        ostream << run.second;
 
-        uint32_t first, second;
-        for (int i = 0; i < entityToCompMapSize; ++i)
+        for (EntityID entityID = run.first; entityID < run.first + run.second; ++entityID)
         {
-            istream >> first;
-            istream >> second;
-            m_EntityToComponentIDMap[first] = second;
+            const T& component = m_ComponentArray[m_EntityToComponentIDMap.at(entityID)];
+            ostream << component.GetGuid();
+            SerializeEcsFields(ostream, info, &component);
         }
+    }
+}
+
+template <typename T>
+void Ether::Ecs::EcsComponentArray<T>::Deserialize(IStream& istream)
+{
+    const uint32_t version = DeserializeVersioned(istream, 0);
 
-        for (int i = 0; i < compToIdMapSize; ++i)
+    m_EntityToComponentIDMap.clear();
+    m_ComponentIDToEntityMap.clear();
+    m_NumElements = 0;
+
+    if (version == 0)
+    {
+        DeserializeLegacy(istream);
+        return;
+    }
+
+    uint32_t componentVersion, numRuns;
+    istream >> componentVersion;
+    istream >> numRuns;
+
+    if (componentVersion > m_ComponentArray[0].GetVersion())
+        throw std::runtime_error(std::format("{} components of version {} are newer than this build", T::GetComponentInfo().m_Name, componentVersion));
+
+    const EcsComponentInfo& info = T::GetComponentInfo();
+    for (uint32_t i = 0; i < numRuns; ++i)
+    {
+        EntityID firstEntity;
+        uint32_t numEntities;
+        istream >> firstEntity;
+        istream >> numEntities;
+
+        if (firstEntity >= MaxNumEntities || numEntities > MaxNumEntities - m_NumElements ||
+            numEntities > MaxNumEntities - firstEntity)
+            throw std::runtime_error(std::format("{} component run is out of range", info.m_Name));
+
+        for (EntityID entityID = firstEntity; entityID < firstEntity + numEntities; ++entityID)
         {
-            istream >> first;
-            istream >> second;
-            m_ComponentIDToEntityMap[first] = second;
+            if (m_EntityToComponentIDMap.find(entityID) != m_EntityToComponentIDMap.end())
+                throw std::runtime_error(std::format("{} component run overlaps entity {}", info.m_Name, entityID));
+
+            const uint32_t index = m_NumElements++;
+            m_EntityToComponentIDMap[entityID] = index;
+            m_ComponentIDToEntityMap[index] = entityID;
+
+            if (version == 1)
+            {
+                // Guids were not stored, so every component needs a new one
+                m_ComponentArray[index] = {};
+            }
+            else
+            {
+                // Copying the prototype is much cheaper than constructing a new component with its own guid
+                m_ComponentArray[index] = GetEcsPrototype<T>();
+
+                std::string guid;
+                istream >> guid;
+                m_ComponentArray[index].SetGuid(guid);
+            }
+
+            DeserializeEcsFields(istream, info, &m_ComponentArray[index], componentVersion);
         }
     }
+}
 
-public:
-    inline T& GetComponent(EntityID entityID) { return m_ComponentArray[m_EntityToComponentIDMap[entityID]]; }
+template <typename T>
+void Ether::Ecs::EcsComponentArray<T>::DeserializeLegacy(IStream& istream)
+{
+    for (int i = 0; i < LegacyNumEntities; ++i)
+        m_ComponentArray[i].Deserialize(istream);
 
-public:
-    void AddComponent(EntityID entityID);
-    void RemoveComponent(EntityID entityID) override;
+    uint32_t compToIdMapSize, entityToCompMapSize;
+    istream >> m_NumElements;
+    istream >> entityToCompMapSize;
+    istream >> compToIdMapSize;
 
-private:
-    std::array<T, MaxNumEntities> m_ComponentArray;
-    std::unordered_map<EntityID, uint32_t> m_EntityToComponentIDMap;
-    std::unordered_map<uint32_t, EntityID> m_ComponentIDToEntityMap;
+    uint32_t first, second;
+    for (int i = 0; i < entityToCompMapSize; ++i)
+    {
+        istream >> first;
+        istream >> second;
+        m_EntityToComponentIDMap[first] = second;
+    }
 
-    uint32_t m_NumElements;
-};
+    for (int i = 0; i < compToIdMapSize; ++i)
+    {
+        istream >> first;
+        istream >> second;
+        m_ComponentIDToEntityMap[first] = second;
+    }
+}
 
 template <typename T>
 void Ether::Ecs::EcsComponentArray<T>::AddComponent(EntityID entityID)
@@ -141,4 +270,14 @@ void Ether::Ecs::EcsComponentArray<T>::RemoveComponent(EntityID entityID)
 
     m_NumElements--;
 }
+
+template <typename T>
+void* Ether::Ecs::EcsComponentArray<T>::GetComponentData(EntityID entityID)
+{
+    const auto iter = m_EntityToComponentIDMap.find(entityID);
+    if (iter == m_EntityToComponentIDMap.end())
+        return nullptr;
+
+    return &m_ComponentArray[iter->second];
+}
 } // namespace Ether::Ecs
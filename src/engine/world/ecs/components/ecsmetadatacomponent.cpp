@@ -29,20 +29,16 @@ Ether::Ecs::EcsMetadataComponent::EcsMetadataComponent()
 {
 }
 
-void Ether::Ecs::EcsMetadataComponent::Serialize(OStream& ostream) const
+const Ether::Ecs::EcsComponentInfo& Ether::Ecs::EcsMetadataComponent::GetComponentInfo()
 {
-    EcsComponent::Serialize(ostream);
-
-    ostream << m_EntityID;
-    ostream << m_EntityName;
-    ostream << m_EntityEnabled;
-}
-
-void Ether::Ecs::EcsMetadataComponent::Deserialize(IStream& istream)
-{
-    EcsComponent::Deserialize(istream);
-
-    istream >> m_EntityID;
-    istream >> m_EntityName;
-    istream >> m_EntityEnabled;
+    static const EcsComponentInfo info = {
+        "Metadata",
+        {
+            EcsField<EcsMetadataComponent, &EcsMetadataComponent::m_EntityID>("EntityID", 0, EcsFieldFlags::ReadOnly),
+            EcsField<EcsMetadataComponent, &EcsMetadataComponent::m_EntityName>("Name"),
+            EcsField<EcsMetadataComponent, &EcsMetadataComponent::m_EntityEnabled>("Enabled"),
+        },
+    };
+
+    return info;
 }
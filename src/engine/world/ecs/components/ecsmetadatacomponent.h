@@ -30,8 +30,7 @@ public:
     ~EcsMetadataComponent() override = default;
 
 public:
-    void Serialize(OStream& ostream) const override;
-    void Deserialize(IStream& istream) override;
+    static const EcsComponentInfo& GetComponentInfo();
 
 public:
     EntityID m_EntityID;
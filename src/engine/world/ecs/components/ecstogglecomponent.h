@@ -31,10 +31,6 @@ public:
     EcsToggleComponent(uint32_t version, const char* classID);
     virtual ~EcsToggleComponent() override = default;
 
-public:
-    void Serialize(OStream& ostream) const override;
-    void Deserialize(IStream& istream) override;
-
 public:
     bool m_Enabled;
 };
@@ -45,18 +41,4 @@ Ether::Ecs::EcsToggleComponent<T>::EcsToggleComponent(uint32_t version, const ch
     , m_Enabled(true)
 {
 }
-
-template <typename T>
-void Ether::Ecs::EcsToggleComponent<T>::Serialize(OStream& ostream) const
-{
-    EcsComponent<T>::Serialize(ostream);
-    ostream << m_Enabled;
-}
-
-template <typename T>
-void Ether::Ecs::EcsToggleComponent<T>::Deserialize(IStream& istream)
-{
-    EcsComponent<T>::Deserialize(istream);
-    istream >> m_Enabled;
-}
 } // namespace Ether::Ecs
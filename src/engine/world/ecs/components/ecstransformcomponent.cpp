@@ -29,20 +29,16 @@ Ether::Ecs::EcsTransformComponent::EcsTransformComponent()
 {
 }
 
-void Ether::Ecs::EcsTransformComponent::Serialize(OStream& ostream) const
+const Ether::Ecs::EcsComponentInfo& Ether::Ecs::EcsTransformComponent::GetComponentInfo()
 {
-    EcsComponent::Serialize(ostream);
-
-    ostream << m_Translation;
-    ostream << m_Rotation;
-    ostream << m_Scale;
-}
-
-void Ether::Ecs::EcsTransformComponent::Deserialize(IStream& istream)
-{
-    EcsComponent::Deserialize(istream);
-
-    istream >> m_Translation;
-    istream >> m_Rotation;
-    istream >> m_Scale;
+    static const EcsComponentInfo info = {
+        "Transform",
+        {
+            EcsField<EcsTransformComponent, &EcsTransformComponent::m_Translation>("Translation"),
+            EcsField<EcsTransformComponent, &EcsTransformComponent::m_Rotation>("Rotation"),
+            EcsField<EcsTransformComponent, &EcsTransformComponent::m_Scale>("Scale"),
+        },
+    };
+
+    return info;
 }
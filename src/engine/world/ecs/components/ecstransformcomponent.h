@@ -30,8 +30,7 @@ public:
     ~EcsTransformComponent() override = default;
 
 public:
-    void Serialize(OStream& ostream) const override;
-    void Deserialize(IStream& istream) override;
+    static const EcsComponentInfo& GetComponentInfo();
 
 public:
     ethVector3 m_Translation;
@@ -26,21 +26,16 @@ Ether::Ecs::EcsVisualComponent::EcsVisualComponent()
 {
 }
 
-void Ether::Ecs::EcsVisualComponent::Serialize(OStream& ostream) const
+const Ether::Ecs::EcsComponentInfo& Ether::Ecs::EcsVisualComponent::GetComponentInfo()
 {
-    EcsToggleComponent::Serialize(ostream);
-    ostream << m_MeshGuid.GetString();
-    ostream << m_MaterialGuid.GetString();
-}
-
-void Ether::Ecs::EcsVisualComponent::Deserialize(IStream& istream)
-{
-    EcsToggleComponent::Deserialize(istream);
-
-    std::string meshGuid, materialGuid;
-    istream >> meshGuid;
-    istream >> materialGuid;
-
-    m_MeshGuid = meshGuid;
-    m_MaterialGuid = materialGuid;
+    static const EcsComponentInfo info = {
+        "Visual",
+        {
+            EcsField<EcsVisualComponent, &EcsVisualComponent::m_Enabled>("Enabled"),
+            EcsField<EcsVisualComponent, &EcsVisualComponent::m_MeshGuid>("Mesh"),
+            EcsField<EcsVisualComponent, &EcsVisualComponent::m_MaterialGuid>("Material"),
+        },
+    };
+
+    return info;
 }
@@ -32,8 +32,7 @@ public:
     ~EcsVisualComponent() override = default;
 
 public:
-    void Serialize(OStream& ostream) const override;
-    void Deserialize(IStream& istream) override;
+    static const EcsComponentInfo& GetComponentInfo();
 
 public:
     StringID m_MeshGuid;
@@ -21,6 +21,7 @@
 
 #include "engine/pch.h"
 #include "engine/world/ecs/components/ecscomponentarray.h"
+#include "engine/world/ecs/ecssystemscheduler.h"
 
 namespace Ether::Ecs
 {
@@ -34,15 +35,19 @@ public:
     void Serialize(OStream& ostream) const override;
     void Deserialize(IStream& istream) override;
 
+    // Lookups only, as these are called from systems running concurrently
     template <typename T>
     ComponentID GetTypeID()
     {
-        return m_TypeNameToIDMap[typeid(T).name()];
+        return m_TypeNameToIDMap.at(typeid(T).name());
     }
 
     template <typename T>
     T& GetComponent(EntityID entityID)
     {
+#ifdef ETH_ECS_VALIDATE_ACCESS
+        EcsSystemScheduler::ValidateComponentAccess(GetTypeID<T>(), false);
+#endif
         return dynamic_cast<EcsComponentArray<T>&>(*m_ComponentArrays.at(GetTypeID<T>())).GetComponent(entityID);
     }
 
@@ -58,6 +63,10 @@ public:
         dynamic_cast<EcsComponentArray<T>&>(*m_ComponentArrays.at(GetTypeID<T>())).RemoveComponent(entityID);
     }
 
+    // Type erased access, component IDs are contiguous from 0 in registration order
+    inline uint32_t GetNumComponentTypes() const { return static_cast<uint32_t>(m_ComponentArrays.size()); }
+    inline EcsComponentArrayBase& GetComponentArray(ComponentID componentID) { return *m_ComponentArrays.at(componentID); }
+
     void OnEntityDestroyed(EntityID entityID)
     {
         for (auto const& pair : m_ComponentArrays)
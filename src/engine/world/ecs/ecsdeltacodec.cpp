@@ -0,0 +1,533 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/world/ecs/ecsdeltacodec.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+using namespace Ether;
+using namespace Ether::Ecs;
+
+constexpr uint32_t MaxNumReflectedFields = 32;
+
+uint32_t GetFingerprintSize(EcsFieldType type)
+{
+    switch (type)
+    {
+    case EcsFieldType::Bool:
+        return sizeof(bool);
+    case EcsFieldType::UInt32:
+    case EcsFieldType::Float:
+    case EcsFieldType::StringID:
+        return sizeof(uint32_t);
+    case EcsFieldType::Vector2:
+        return sizeof(ethVector2);
+    case EcsFieldType::Vector3:
+        return sizeof(ethVector3);
+    case EcsFieldType::Vector4:
+        return sizeof(ethVector4);
+    case EcsFieldType::String:
+        return sizeof(uint64_t);
+    default:
+        return 0;
+    }
+}
+
+void WriteFingerprint(EcsFieldType type, const void* field, uint8_t* dst)
+{
+    switch (type)
+    {
+    case EcsFieldType::StringID:
+    {
+        const sid_t hash = static_cast<const StringID*>(field)->GetHash();
+        std::memcpy(dst, &hash, sizeof(hash));
+        break;
+    }
+    case EcsFieldType::String:
+    {
+        const uint64_t hash = std::hash<std::string>()(*static_cast<const std::string*>(field));
+        std::memcpy(dst, &hash, sizeof(hash));
+        break;
+    }
+    default:
+        std::memcpy(dst, field, GetFingerprintSize(type));
+        break;
+    }
+}
+
+void AppendBytes(std::vector<uint8_t>& buffer, const void* data, size_t numBytes)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + numBytes);
+}
+
+void AppendVarint(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void AppendString(std::vector<uint8_t>& buffer, const std::string& str)
+{
+    AppendVarint(buffer, static_cast<uint32_t>(str.size()));
+    AppendBytes(buffer, str.data(), str.size());
+}
+
+void AppendValue(std::vector<uint8_t>& buffer, EcsFieldType type, const void* field)
+{
+    switch (type)
+    {
+    case EcsFieldType::Bool:
+        buffer.push_back(*static_cast<const bool*>(field) ? 1 : 0);
+        break;
+    case EcsFieldType::StringID:
+        AppendString(buffer, static_cast<const StringID*>(field)->GetString());
+        break;
+    case EcsFieldType::String:
+        AppendString(buffer, *static_cast<const std::string*>(field));
+        break;
+    default:
+        AppendBytes(buffer, field, GetFingerprintSize(type));
+        break;
+    }
+}
+
+class DeltaParser
+{
+public:
+    DeltaParser(const uint8_t* data, size_t size)
+        : m_Data(data)
+        , m_Size(size)
+        , m_Offset(0)
+    {
+    }
+
+    bool ReadUInt32(uint32_t& value)
+    {
+        return ReadBytes(&value, sizeof(value));
+    }
+
+    bool ReadVarint(uint32_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 35; shift += 7)
+        {
+            if (m_Offset >= m_Size)
+                return false;
+
+            const uint8_t byte = m_Data[m_Offset++];
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    bool ReadBytes(void* dst, size_t numBytes)
+    {
+        if (numBytes > m_Size - m_Offset)
+            return false;
+
+        if (dst != nullptr)
+            std::memcpy(dst, m_Data + m_Offset, numBytes);
+
+        m_Offset += numBytes;
+        return true;
+    }
+
+    bool ReadString(std::string* dst)
+    {
+        uint32_t length;
+        if (!ReadVarint(length) || length > m_Size - m_Offset)
+            return false;
+
+        if (dst != nullptr)
+            dst->assign(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+
+        m_Offset += length;
+        return true;
+    }
+
+    // The value is skipped if field is nullptr
+    bool ReadValue(EcsFieldType type, void* field)
+    {
+        switch (type)
+        {
+        case EcsFieldType::Bool:
+        {
+            uint8_t value;
+            if (!ReadBytes(&value, sizeof(value)))
+                return false;
+
+            if (field != nullptr)
+                *static_cast<bool*>(field) = value != 0;
+
+            return true;
+        }
+        case EcsFieldType::StringID:
+        {
+            std::string value;
+            if (!ReadString(field != nullptr ? &value : nullptr))
+                return false;
+
+            if (field != nullptr)
+                *static_cast<StringID*>(field) = StringID(value);
+
+            return true;
+        }
+        case EcsFieldType::String:
+            return ReadString(static_cast<std::string*>(field));
+        default:
+            return ReadBytes(field, GetFingerprintSize(type));
+        }
+    }
+
+private:
+    const uint8_t* m_Data;
+    const size_t m_Size;
+    size_t m_Offset;
+};
+} // namespace
+
+Ether::Ecs::EcsDeltaWriter::EcsDeltaWriter(std::vector<uint8_t>& buffer)
+    : m_Buffer(buffer)
+    , m_StartOffset(buffer.size())
+    , m_GroupOffset(0)
+    , m_NumGroups(0)
+    , m_NumGroupRecords(0)
+    , m_NumRecords(0)
+    , m_PreviousEntity(0)
+{
+    // Group count, written by Finish()
+    m_Buffer.resize(m_Buffer.size() + sizeof(uint32_t));
+}
+
+void Ether::Ecs::EcsDeltaWriter::BeginComponent(ComponentID componentID)
+{
+    m_GroupOffset = m_Buffer.size();
+    m_NumGroupRecords = 0;
+    m_PreviousEntity = 0;
+
+    // Component ID and record count, the latter is written by EndComponent()
+    m_Buffer.resize(m_Buffer.size() + 2 * sizeof(uint32_t));
+    WriteUInt32At(m_GroupOffset, static_cast<uint32_t>(componentID));
+}
+
+void Ether::Ecs::EcsDeltaWriter::EndComponent()
+{
+    WriteUInt32At(m_GroupOffset + sizeof(uint32_t), m_NumGroupRecords);
+    m_NumGroups++;
+}
+
+void Ether::Ecs::EcsDeltaWriter::WriteFields(
+    EntityID entityID,
+    uint32_t fieldMask,
+    const EcsComponentInfo& info,
+    const void* component)
+{
+    AssertEngine(fieldMask != 0, "Use WriteRemoval() for removed components");
+    AssertEngine(m_NumGroupRecords == 0 || entityID > m_PreviousEntity, "Records must be written in ascending entity order");
+
+    WriteVarint(entityID - m_PreviousEntity);
+    WriteVarint(fieldMask);
+
+    for (uint32_t i = 0; i < info.m_Fields.size(); ++i)
+    {
+        if (fieldMask & (1u << i))
+            AppendValue(m_Buffer, info.m_Fields[i].m_Type, info.m_Fields[i].GetData(component));
+    }
+
+    m_PreviousEntity = entityID;
+    m_NumGroupRecords++;
+    m_NumRecords++;
+}
+
+void Ether::Ecs::EcsDeltaWriter::WriteRemoval(EntityID entityID)
+{
+    AssertEngine(m_NumGroupRecords == 0 || entityID > m_PreviousEntity, "Records must be written in ascending entity order");
+
+    WriteVarint(entityID - m_PreviousEntity);
+    WriteVarint(0);
+
+    m_PreviousEntity = entityID;
+    m_NumGroupRecords++;
+    m_NumRecords++;
+}
+
+void Ether::Ecs::EcsDeltaWriter::Finish()
+{
+    WriteUInt32At(m_StartOffset, m_NumGroups);
+}
+
+void Ether::Ecs::EcsDeltaWriter::WriteVarint(uint32_t value)
+{
+    AppendVarint(m_Buffer, value);
+}
+
+void Ether::Ecs::EcsDeltaWriter::WriteUInt32At(size_t offset, uint32_t value)
+{
+    std::memcpy(m_Buffer.data() + offset, &value, sizeof(value));
+}
+
+bool Ether::Ecs::EcsDeltaReader::Apply(
+    const uint8_t* data,
+    size_t size,
+    EcsComponentManager& componentManager,
+    const RecordCallback& onRecordApplied)
+{
+    DeltaParser parser(data, size);
+
+    uint32_t numGroups;
+    if (!parser.ReadUInt32(numGroups))
+        return false;
+
+    for (uint32_t group = 0; group < numGroups; ++group)
+    {
+        uint32_t componentID, numRecords;
+        if (!parser.ReadUInt32(componentID) || !parser.ReadUInt32(numRecords))
+            return false;
+
+        // Unknown components can't be skipped, as their field layout is unknown
+        if (componentID >= componentManager.GetNumComponentTypes())
+            return false;
+
+        EcsComponentArrayBase& componentArray = componentManager.GetComponentArray(componentID);
+        const EcsComponentInfo& info = componentArray.GetComponentInfo();
+        const uint32_t numFields = static_cast<uint32_t>(info.m_Fields.size());
+        const uint32_t validMask = numFields >= MaxNumReflectedFields ? ~0u : (1u << numFields) - 1;
+
+        EntityID entityID = 0;
+        for (uint32_t record = 0; record < numRecords; ++record)
+        {
+            uint32_t entityDelta, fieldMask;
+            if (!parser.ReadVarint(entityDelta) || !parser.ReadVarint(fieldMask))
+                return false;
+
+            if ((fieldMask & ~validMask) != 0)
+                return false;
+
+            entityID += entityDelta;
+
+            if (fieldMask == 0)
+                continue;
+
+            void* component = componentArray.GetComponentData(entityID);
+            for (uint32_t i = 0; i < numFields; ++i)
+            {
+                if ((fieldMask & (1u << i)) == 0)
+                    continue;
+
+                // Read only fields are parsed, but not written
+                void* field = component != nullptr && !info.m_Fields[i].IsReadOnly() ? info.m_Fields[i].GetData(component) : nullptr;
+                if (!parser.ReadValue(info.m_Fields[i].m_Type, field))
+                    return false;
+            }
+
+            if (component != nullptr && onRecordApplied != nullptr)
+                onRecordApplied(componentID, entityID, fieldMask);
+        }
+    }
+
+    return true;
+}
+
+Ether::Ecs::EcsDeltaTracker::EcsDeltaTracker()
+{
+}
+
+bool Ether::Ecs::EcsDeltaTracker::CollectChanges(EcsComponentManager& componentManager, std::vector<uint8_t>& buffer)
+{
+    if (m_Shadows.empty())
+        InitializeShadows(componentManager);
+
+    m_PendingRecords.clear();
+    m_PendingFingerprints.clear();
+
+    const size_t bufferStart = buffer.size();
+    EcsDeltaWriter writer(buffer);
+
+    for (uint32_t componentID = 0; componentID < m_Shadows.size(); ++componentID)
+    {
+        Shadow& shadow = m_Shadows[componentID];
+        EcsComponentArrayBase& componentArray = componentManager.GetComponentArray(componentID);
+        const EcsComponentInfo& info = componentArray.GetComponentInfo();
+        const uint32_t numFields = static_cast<uint32_t>(info.m_Fields.size());
+        const size_t firstRecord = m_PendingRecords.size();
+
+        std::fill(shadow.m_IsSeen.begin(), shadow.m_IsSeen.end(), false);
+
+        for (uint32_t index = 0; index < componentArray.GetNumComponents(); ++index)
+        {
+            const EntityID entityID = componentArray.GetEntityAt(index);
+            void* component = componentArray.GetComponentDataAt(index);
+            shadow.m_IsSeen[entityID] = true;
+
+            // Fingerprint straight into the pending data, it is dropped again if nothing changed
+            const size_t fingerprintOffset = m_PendingFingerprints.size();
+            m_PendingFingerprints.resize(fingerprintOffset + shadow.m_Stride);
+            uint8_t* fingerprint = m_PendingFingerprints.data() + fingerprintOffset;
+
+            for (uint32_t i = 0; i < numFields; ++i)
+                WriteFingerprint(info.m_Fields[i].m_Type, info.m_Fields[i].GetData(component), fingerprint + shadow.m_FieldOffsets[i]);
+
+            uint32_t fieldMask = 0;
+            if (!shadow.m_IsPresent[entityID])
+                fieldMask = numFields >= MaxNumReflectedFields ? ~0u : (1u << numFields) - 1;
+            else
+            {
+                const uint8_t* previous = shadow.m_Fingerprints.data() + size_t(entityID) * shadow.m_Stride;
+                for (uint32_t i = 0; i < numFields; ++i)
+                {
+                    const uint32_t offset = shadow.m_FieldOffsets[i];
+                    const uint32_t size = shadow.m_FieldOffsets[i + 1] - offset;
+                    if (std::memcmp(fingerprint + offset, previous + offset, size) != 0)
+                        fieldMask |= 1u << i;
+                }
+            }
+
+            if (fieldMask == 0)
+            {
+                m_PendingFingerprints.resize(fingerprintOffset);
+                continue;
+            }
+
+            m_PendingRecords.push_back({ componentID, entityID, fieldMask, index, fingerprintOffset });
+        }
+
+        for (EntityID entityID = 0; entityID < MaxNumEntities; ++entityID)
+        {
+            if (shadow.m_IsPresent[entityID] && !shadow.m_IsSeen[entityID])
+                m_PendingRecords.push_back({ componentID, entityID, 0, 0, 0 });
+        }
+
+        if (m_PendingRecords.size() == firstRecord)
+            continue;
+
+        const auto groupBegin = m_PendingRecords.begin() + firstRecord;
+        std::sort(groupBegin, m_PendingRecords.end(), [](const PendingRecord& a, const PendingRecord& b) {
+            return a.m_EntityID < b.m_EntityID;
+        });
+
+        writer.BeginComponent(componentID);
+        for (auto record = groupBegin; record != m_PendingRecords.end(); ++record)
+        {
+            if (record->m_FieldMask == 0)
+                writer.WriteRemoval(record->m_EntityID);
+            else
+                writer.WriteFields(record->m_EntityID, record->m_FieldMask, info, componentArray.GetComponentDataAt(record->m_ComponentIndex));
+        }
+        writer.EndComponent();
+    }
+
+    if (m_PendingRecords.empty())
+    {
+        buffer.resize(bufferStart);
+        return false;
+    }
+
+    writer.Finish();
+    return true;
+}
+
+void Ether::Ecs::EcsDeltaTracker::CommitChanges()
+{
+    for (const PendingRecord& record : m_PendingRecords)
+    {
+        Shadow& shadow = m_Shadows[record.m_ComponentID];
+        shadow.m_IsPresent[record.m_EntityID] = record.m_FieldMask != 0;
+
+        if (record.m_FieldMask == 0)
+            continue;
+
+        // Fields outside of the mask are unchanged, so the whole fingerprint can be copied
+        std::memcpy(
+            shadow.m_Fingerprints.data() + size_t(record.m_EntityID) * shadow.m_Stride,
+            m_PendingFingerprints.data() + record.m_FingerprintOffset,
+            shadow.m_Stride);
+    }
+
+    m_PendingRecords.clear();
+    m_PendingFingerprints.clear();
+}
+
+void Ether::Ecs::EcsDeltaTracker::Reset()
+{
+    m_Shadows.clear();
+    m_PendingRecords.clear();
+    m_PendingFingerprints.clear();
+}
+
+void Ether::Ecs::EcsDeltaTracker::MarkSynchronized(
+    EcsComponentManager& componentManager,
+    ComponentID componentID,
+    EntityID entityID,
+    uint32_t fieldMask)
+{
+    // Components that were never collected are sent in full anyway
+    if (componentID >= m_Shadows.size() || entityID >= MaxNumEntities || !m_Shadows[componentID].m_IsPresent[entityID])
+        return;
+
+    Shadow& shadow = m_Shadows[componentID];
+    EcsComponentArrayBase& componentArray = componentManager.GetComponentArray(componentID);
+    const EcsComponentInfo& info = componentArray.GetComponentInfo();
+
+    void* component = componentArray.GetComponentData(entityID);
+    if (component == nullptr)
+        return;
+
+    uint8_t* fingerprint = shadow.m_Fingerprints.data() + size_t(entityID) * shadow.m_Stride;
+    for (uint32_t i = 0; i < info.m_Fields.size(); ++i)
+    {
+        if (fieldMask & (1u << i))
+            WriteFingerprint(info.m_Fields[i].m_Type, info.m_Fields[i].GetData(component), fingerprint + shadow.m_FieldOffsets[i]);
+    }
+}
+
+void Ether::Ecs::EcsDeltaTracker::InitializeShadows(EcsComponentManager& componentManager)
+{
+    m_Shadows.resize(componentManager.GetNumComponentTypes());
+
+    for (uint32_t componentID = 0; componentID < m_Shadows.size(); ++componentID)
+    {
+        const EcsComponentInfo& info = componentManager.GetComponentArray(componentID).GetComponentInfo();
+        AssertEngine(info.m_Fields.size() <= MaxNumReflectedFields, "Component %s has too many fields to be synchronized", info.m_Name);
+
+        // One offset per field, plus the end of the last field
+        Shadow& shadow = m_Shadows[componentID];
+        shadow.m_FieldOffsets.resize(info.m_Fields.size() + 1);
+        shadow.m_FieldOffsets[0] = 0;
+
+        for (uint32_t i = 0; i < info.m_Fields.size(); ++i)
+            shadow.m_FieldOffsets[i + 1] = shadow.m_FieldOffsets[i] + GetFingerprintSize(info.m_Fields[i].m_Type);
+
+        shadow.m_Stride = shadow.m_FieldOffsets.back();
+        shadow.m_Fingerprints.resize(size_t(MaxNumEntities) * shadow.m_Stride);
+        shadow.m_IsPresent.assign(MaxNumEntities, false);
+        shadow.m_IsSeen.assign(MaxNumEntities, false);
+    }
+}
@@ -0,0 +1,152 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "engine/pch.h"
+#include "engine/world/ecs/ecscomponentmanager.h"
+#include "engine/world/ecs/ecsreflection.h"
+#include <functional>
+#include <vector>
+
+namespace Ether::Ecs
+{
+/*
+    Compact encoding of component field changes, used to keep the editor in sync with the engine.
+
+        uint32  numGroups
+        group:  uint32 componentID, uint32 numRecords, records...
+        record: varint entityDelta, varint fieldMask, the value of every field in the mask
+
+    Records in a group are sorted by entity and store the distance to the previous entity, so runs
+    of neighbouring entities cost a single byte per ID. Bit i of the field mask is the i-th
+    reflected field of the component, and a mask of 0 means that the component was removed.
+
+    Values are little endian. Bools take one byte, 32 bit values and vectors are written as is,
+    StringIDs and strings are written as a varint length followed by the characters.
+*/
+class ETH_ENGINE_DLL EcsDeltaWriter : public NonCopyable
+{
+public:
+    // The delta is appended to the buffer
+    EcsDeltaWriter(std::vector<uint8_t>& buffer);
+    ~EcsDeltaWriter() = default;
+
+public:
+    void BeginComponent(ComponentID componentID);
+    void EndComponent();
+
+    void WriteFields(EntityID entityID, uint32_t fieldMask, const EcsComponentInfo& info, const void* component);
+    void WriteRemoval(EntityID entityID);
+
+    // Writes the group count, the buffer is complete after this
+    void Finish();
+
+public:
+    inline uint32_t GetNumRecords() const { return m_NumRecords; }
+
+private:
+    void WriteVarint(uint32_t value);
+    void WriteUInt32At(size_t offset, uint32_t value);
+
+private:
+    std::vector<uint8_t>& m_Buffer;
+    const size_t m_StartOffset;
+
+    size_t m_GroupOffset;
+    uint32_t m_NumGroups;
+    uint32_t m_NumGroupRecords;
+    uint32_t m_NumRecords;
+    EntityID m_PreviousEntity;
+};
+
+class ETH_ENGINE_DLL EcsDeltaReader
+{
+public:
+    using RecordCallback = std::function<void(ComponentID componentID, EntityID entityID, uint32_t fieldMask)>;
+
+    // Writes the values into the components. Records of entities that do not have the component are
+    // skipped, and removal records are ignored, as components are only removed through commands.
+    // Read only fields are never written.
+    // The callback is invoked for every record that was applied. Returns false if the data is
+    // malformed, in which case the records before the error have already been applied.
+    static bool Apply(
+        const uint8_t* data,
+        size_t size,
+        EcsComponentManager& componentManager,
+        const RecordCallback& onRecordApplied = nullptr);
+};
+
+/*
+    Finds the component fields that changed since the last commit, by comparing every component
+    against a shadow copy of what was last sent. The result is a dirty mask per component, which
+    is encoded with EcsDeltaWriter.
+
+    The shadow holds a fingerprint of each field, which is its value for plain data and a hash for
+    strings. It is only updated on commit, so changes that could not be delivered are collected
+    again the next time, merged with whatever changed since.
+*/
+class ETH_ENGINE_DLL EcsDeltaTracker : public NonCopyable
+{
+public:
+    EcsDeltaTracker();
+    ~EcsDeltaTracker() = default;
+
+public:
+    // Appends the changes to the buffer, returns false (and leaves the buffer alone) if nothing changed
+    bool CollectChanges(EcsComponentManager& componentManager, std::vector<uint8_t>& buffer);
+    void CommitChanges();
+
+    // Forgets the shadow, so that the next collect contains the full state
+    void Reset();
+
+    // For values that were set by the other side, so that they are not sent back to it
+    void MarkSynchronized(EcsComponentManager& componentManager, ComponentID componentID, EntityID entityID, uint32_t fieldMask);
+
+public:
+    inline uint32_t GetNumPendingRecords() const { return static_cast<uint32_t>(m_PendingRecords.size()); }
+
+private:
+    struct Shadow
+    {
+        std::vector<uint32_t> m_FieldOffsets;
+        uint32_t m_Stride;
+
+        std::vector<uint8_t> m_Fingerprints;
+        std::vector<bool> m_IsPresent;
+        std::vector<bool> m_IsSeen;
+    };
+
+    struct PendingRecord
+    {
+        uint32_t m_ComponentID;
+        EntityID m_EntityID;
+        uint32_t m_FieldMask;
+        uint32_t m_ComponentIndex;
+        size_t m_FingerprintOffset;
+    };
+
+    void InitializeShadows(EcsComponentManager& componentManager);
+
+private:
+    std::vector<Shadow> m_Shadows;
+    std::vector<PendingRecord> m_PendingRecords;
+    std::vector<uint8_t> m_PendingFingerprints;
+};
+} // namespace Ether::Ecs
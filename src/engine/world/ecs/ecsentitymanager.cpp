@@ -19,7 +19,11 @@
 
 #include "engine/world/ecs/ecsentitymanager.h"
 
-constexpr uint32_t EcsEntityManagerVersion = 0;
+// 0: All available IDs one by one, and every signature as a bitset string
+// 1: Available IDs as runs, and the signatures of live entities as packed masks
+constexpr uint32_t EcsEntityManagerVersion = 1;
+
+static_assert(Ether::Ecs::MaxNumComponents <= 32, "Signatures are serialized as 32 bit masks");
 
 Ether::Ecs::EcsEntityManager::EcsEntityManager()
     : Serializable(EcsEntityManagerVersion, "Engine::EcsEntityManager")
@@ -32,26 +36,92 @@ void Ether::Ecs::EcsEntityManager::Serialize(OStream& ostream) const
 {
     Serializable::Serialize(ostream);
 
-    ostream << (uint32_t)m_AvailableEntities.size();
+    // IDs are handed out in queue order, which is mostly ascending, so runs keep this small
+    std::vector<std::pair<EntityID, uint32_t>> availableRuns;
     std::queue<EntityID> copy = m_AvailableEntities;
 
     while (!copy.empty())
     {
-        ostream << copy.front();
+        if (!availableRuns.empty() && availableRuns.back().first + availableRuns.back().second == copy.front())
+            availableRuns.back().second++;
+        else
+            availableRuns.emplace_back(copy.front(), 1);
+
         copy.pop();
     }
 
-    for (int i = 0; i < MaxNumEntities; ++i)
-        ostream << m_EntitySignatures[i].to_string();
+    ostream << static_cast<uint32_t>(availableRuns.size());
+    for (auto& run : availableRuns)
+    {
+        ostream << run.first;
+        ostream << run.second;
+    }
+
+    uint32_t numSignatures = 0;
+    for (EntityID id = 0; id < MaxNumEntities; ++id)
+        numSignatures += m_EntitySignatures[id].any() ? 1 : 0;
+
+    ostream << numSignatures;
+    for (EntityID id = 0; id < MaxNumEntities; ++id)
+    {
+        if (m_EntitySignatures[id].none())
+            continue;
+
+        ostream << id;
+        ostream << static_cast<uint32_t>(m_EntitySignatures[id].to_ulong());
+    }
 }
 
 void Ether::Ecs::EcsEntityManager::Deserialize(IStream& istream)
 {
-    Serializable::Deserialize(istream);
+    const uint32_t version = DeserializeVersioned(istream, 0);
 
     while (!m_AvailableEntities.empty())
         m_AvailableEntities.pop();
 
+    for (EntityID id = 0; id < MaxNumEntities; ++id)
+        m_EntitySignatures[id].reset();
+
+    if (version == 0)
+    {
+        DeserializeLegacy(istream);
+        return;
+    }
+
+    uint32_t numAvailableRuns;
+    istream >> numAvailableRuns;
+    for (uint32_t i = 0; i < numAvailableRuns; ++i)
+    {
+        EntityID firstID;
+        uint32_t numIDs;
+        istream >> firstID;
+        istream >> numIDs;
+
+        if (firstID >= MaxNumEntities || numIDs > MaxNumEntities - firstID)
+            throw std::runtime_error("Available entity range is out of range");
+
+        for (EntityID id = firstID; id < firstID + numIDs; ++id)
+            m_AvailableEntities.push(id);
+    }
+
+    uint32_t numSignatures;
+    istream >> numSignatures;
+    for (uint32_t i = 0; i < numSignatures; ++i)
+    {
+        EntityID id;
+        uint32_t signature;
+        istream >> id;
+        istream >> signature;
+
+        if (id >= MaxNumEntities)
+            throw std::runtime_error("Entity signature is out of range");
+
+        m_EntitySignatures[id] = EntitySignature(signature);
+    }
+}
+
+void Ether::Ecs::EcsEntityManager::DeserializeLegacy(IStream& istream)
+{
     uint32_t numAvailEntities;
     istream >> numAvailEntities;
     for (int i = 0; i < numAvailEntities; ++i)
@@ -61,12 +131,16 @@ void Ether::Ecs::EcsEntityManager::Deserialize(IStream& istream)
         m_AvailableEntities.push(entityID);
     }
 
-    for (int i = 0; i < MaxNumEntities; ++i)
+    for (int i = 0; i < LegacyNumEntities; ++i)
     {
         std::string bitsetString;
         istream >> bitsetString;
         m_EntitySignatures[i] = std::bitset<MaxNumComponents>(bitsetString);
     }
+
+    // The file only knows about its own slots, the ones beyond are free in builds with a higher limit
+    for (EntityID id = LegacyNumEntities; id < MaxNumEntities; ++id)
+        m_AvailableEntities.push(id);
 }
 
 Ether::Ecs::EntityID Ether::Ecs::EcsEntityManager::CreateEntity()
@@ -86,6 +160,18 @@ void Ether::Ecs::EcsEntityManager::DestroyEntity(EntityID id)
     m_EntitySignatures[id].reset();
 }
 
+void Ether::Ecs::EcsEntityManager::Reset()
+{
+    while (!m_AvailableEntities.empty())
+        m_AvailableEntities.pop();
+
+    for (EntityID id = 0; id < MaxNumEntities; ++id)
+    {
+        m_AvailableEntities.push(id);
+        m_EntitySignatures[id].reset();
+    }
+}
+
 void Ether::Ecs::EcsEntityManager::SetSignature(EntityID id, EntitySignature signature)
 {
     m_EntitySignatures[id] = signature;
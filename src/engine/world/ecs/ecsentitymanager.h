@@ -40,10 +40,15 @@ public:
 public:
     EntityID CreateEntity();
     void DestroyEntity(EntityID id);
+    // Hands out IDs from 0 again, only valid once every entity has been destroyed
+    void Reset();
 
     void SetSignature(EntityID id, EntitySignature signature);
     EntitySignature GetSignature(EntityID id);
 
+private:
+    void DeserializeLegacy(IStream& istream);
+
 private:
     friend class EcsManager;
 
@@ -57,3 +57,18 @@ void Ether::Ecs::EcsManager::DestroyEntity(EntityID entityID)
     m_SystemManager.OnEntityDestroyed(entityID);
     m_ComponentManager.OnEntityDestroyed(entityID);
 }
+
+bool Ether::Ecs::EcsManager::ApplyDelta(const uint8_t* data, size_t size, const EcsDeltaReader::RecordCallback& onRecordApplied)
+{
+    return EcsDeltaReader::Apply(
+        data,
+        size,
+        m_ComponentManager,
+        [&](ComponentID componentID, EntityID entityID, uint32_t fieldMask)
+        {
+            m_SystemManager.OnComponentModified(entityID, componentID);
+
+            if (onRecordApplied != nullptr)
+                onRecordApplied(componentID, entityID, fieldMask);
+        });
+}
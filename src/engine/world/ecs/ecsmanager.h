@@ -21,6 +21,7 @@
 
 #include "engine/pch.h"
 #include "engine/world/ecs/ecstypes.h"
+#include "engine/world/ecs/ecsdeltacodec.h"
 #include "engine/world/ecs/ecsentitymanager.h"
 #include "engine/world/ecs/ecscomponentmanager.h"
 #include "engine/world/ecs/ecssystemmanager.h"
@@ -49,6 +50,10 @@ public:
     EntityID CreateEntity();
     void DestroyEntity(EntityID entityID);
 
+    // Writes a delta (see EcsDeltaReader) into the components, and lets the systems know about every
+    // component that was written, as they cache what they derive from them (e.g. world matrices)
+    bool ApplyDelta(const uint8_t* data, size_t size, const EcsDeltaReader::RecordCallback& onRecordApplied = nullptr);
+
 private:
     EcsEntityManager m_EntityManager;
     EcsComponentManager m_ComponentManager;
@@ -0,0 +1,125 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/world/ecs/ecsreflection.h"
+
+const char* Ether::Ecs::GetEcsFieldTypeName(EcsFieldType type)
+{
+    switch (type)
+    {
+    case EcsFieldType::Bool:
+        return "Bool";
+    case EcsFieldType::UInt32:
+        return "UInt32";
+    case EcsFieldType::Float:
+        return "Float";
+    case EcsFieldType::Vector2:
+        return "Vector2";
+    case EcsFieldType::Vector3:
+        return "Vector3";
+    case EcsFieldType::Vector4:
+        return "Vector4";
+    case EcsFieldType::StringID:
+        return "StringID";
+    case EcsFieldType::String:
+        return "String";
+    default:
+        return "Unknown";
+    }
+}
+
+void Ether::Ecs::SerializeEcsFields(OStream& ostream, const EcsComponentInfo& info, const void* component)
+{
+    for (const EcsFieldInfo& field : info.m_Fields)
+    {
+        const void* data = field.GetData(component);
+
+        switch (field.m_Type)
+        {
+        case EcsFieldType::Bool:
+            ostream << *static_cast<const bool*>(data);
+            break;
+        case EcsFieldType::UInt32:
+            ostream << *static_cast<const uint32_t*>(data);
+            break;
+        case EcsFieldType::Float:
+            ostream << *static_cast<const float*>(data);
+            break;
+        case EcsFieldType::Vector2:
+            ostream << *static_cast<const ethVector2*>(data);
+            break;
+        case EcsFieldType::Vector3:
+            ostream << *static_cast<const ethVector3*>(data);
+            break;
+        case EcsFieldType::Vector4:
+            ostream << *static_cast<const ethVector4*>(data);
+            break;
+        case EcsFieldType::StringID:
+            ostream << *static_cast<const StringID*>(data);
+            break;
+        case EcsFieldType::String:
+            ostream << *static_cast<const std::string*>(data);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void Ether::Ecs::DeserializeEcsFields(IStream& istream, const EcsComponentInfo& info, void* component, uint32_t version)
+{
+    for (const EcsFieldInfo& field : info.m_Fields)
+    {
+        // Not part of the data yet, keeps its default value
+        if (field.m_Version > version)
+            continue;
+
+        void* data = field.GetData(component);
+
+        switch (field.m_Type)
+        {
+        case EcsFieldType::Bool:
+            istream >> *static_cast<bool*>(data);
+            break;
+        case EcsFieldType::UInt32:
+            istream >> *static_cast<uint32_t*>(data);
+            break;
+        case EcsFieldType::Float:
+            istream >> *static_cast<float*>(data);
+            break;
+        case EcsFieldType::Vector2:
+            istream >> *static_cast<ethVector2*>(data);
+            break;
+        case EcsFieldType::Vector3:
+            istream >> *static_cast<ethVector3*>(data);
+            break;
+        case EcsFieldType::Vector4:
+            istream >> *static_cast<ethVector4*>(data);
+            break;
+        case EcsFieldType::StringID:
+            istream >> *static_cast<StringID*>(data);
+            break;
+        case EcsFieldType::String:
+            istream >> *static_cast<std::string*>(data);
+            break;
+        default:
+            break;
+        }
+    }
+}
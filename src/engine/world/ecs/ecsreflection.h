@@ -0,0 +1,142 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "engine/pch.h"
+#include <type_traits>
+#include <vector>
+
+namespace Ether::Ecs
+{
+enum class EcsFieldType : uint8_t
+{
+    Bool,
+    UInt32,
+    Float,
+    Vector2,
+    Vector3,
+    Vector4,
+    StringID,
+    String,
+};
+
+template <typename T>
+constexpr EcsFieldType GetEcsFieldType()
+{
+    if constexpr (std::is_same_v<T, bool>)
+        return EcsFieldType::Bool;
+    else if constexpr (std::is_same_v<T, uint32_t> || std::is_enum_v<T>)
+    {
+        // Enums are exposed as their underlying value
+        static_assert(sizeof(T) == sizeof(uint32_t), "Only 32 bit enums can be reflected");
+        return EcsFieldType::UInt32;
+    }
+    else if constexpr (std::is_same_v<T, float>)
+        return EcsFieldType::Float;
+    else if constexpr (std::is_same_v<T, ethVector2>)
+        return EcsFieldType::Vector2;
+    else if constexpr (std::is_same_v<T, ethVector3>)
+        return EcsFieldType::Vector3;
+    else if constexpr (std::is_same_v<T, ethVector4>)
+        return EcsFieldType::Vector4;
+    else if constexpr (std::is_same_v<T, StringID>)
+        return EcsFieldType::StringID;
+    else if constexpr (std::is_same_v<T, std::string>)
+        return EcsFieldType::String;
+    else
+        static_assert(sizeof(T) == 0, "Unsupported component field type");
+}
+
+enum class EcsFieldFlags : uint32_t
+{
+    None = 0,
+
+    // Shown to tools, but never written by them
+    ReadOnly = 1 << 0,
+};
+
+ETH_ENGINE_DLL const char* GetEcsFieldTypeName(EcsFieldType type);
+
+/*
+    Describes a single member of a component, so that it can be serialized, shown and edited
+    without knowing the component's type. Fields are created with
+
+        EcsField<Component, &Component::m_Member>("Name", sinceVersion, flags)
+
+    where sinceVersion is the component version that added the field. Data of older versions
+    is loaded without it, and the field keeps the value it was constructed with.
+*/
+struct EcsFieldInfo
+{
+    const char* m_Name;
+    EcsFieldType m_Type;
+    size_t m_Offset;
+    uint32_t m_Version;
+    EcsFieldFlags m_Flags;
+
+    inline void* GetData(void* component) const { return static_cast<uint8_t*>(component) + m_Offset; }
+    inline const void* GetData(const void* component) const { return static_cast<const uint8_t*>(component) + m_Offset; }
+    inline bool IsReadOnly() const { return (static_cast<uint32_t>(m_Flags) & static_cast<uint32_t>(EcsFieldFlags::ReadOnly)) != 0; }
+
+    template <typename T>
+    inline T& Get(void* component) const
+    {
+        return *static_cast<T*>(GetData(component));
+    }
+};
+
+struct EcsComponentInfo
+{
+    const char* m_Name;
+    std::vector<EcsFieldInfo> m_Fields;
+};
+
+// A default constructed instance, to measure field offsets against
+template <typename Component>
+const Component& GetEcsPrototype()
+{
+    static const Component prototype;
+    return prototype;
+}
+
+// The component type is passed explicitly, so that members inherited from a base (e.g. m_Enabled)
+// are measured from the start of the derived type
+template <typename Component, auto Member>
+EcsFieldInfo EcsField(const char* name, uint32_t sinceVersion = 0, EcsFieldFlags flags = EcsFieldFlags::None)
+{
+    using FieldType = std::remove_cvref_t<decltype(std::declval<Component&>().*Member)>;
+
+    const Component& prototype = GetEcsPrototype<Component>();
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(&prototype);
+    const uint8_t* field = reinterpret_cast<const uint8_t*>(&(prototype.*Member));
+
+    EcsFieldInfo info;
+    info.m_Name = name;
+    info.m_Type = GetEcsFieldType<FieldType>();
+    info.m_Offset = static_cast<size_t>(field - base);
+    info.m_Version = sinceVersion;
+    info.m_Flags = flags;
+    return info;
+}
+
+// Generated binary serialization, fields are written in declaration order
+ETH_ENGINE_DLL void SerializeEcsFields(OStream& ostream, const EcsComponentInfo& info, const void* component);
+ETH_ENGINE_DLL void DeserializeEcsFields(IStream& istream, const EcsComponentInfo& info, void* component, uint32_t version);
+} // namespace Ether::Ecs
@@ -26,31 +26,85 @@ Ether::Ecs::EcsSystemManager::EcsSystemManager()
 {
     m_Systems.emplace_back(std::make_unique<EcsCameraSystem>());
     m_Systems.emplace_back(std::make_unique<EcsVisualSystem>());
+
+    m_Scheduler.Build(m_Systems);
 }
 
 void Ether::Ecs::EcsSystemManager::UpdateEntitySignature(EntityID entityID, EntitySignature newSignature)
 {
+    AssertEngine(!m_Scheduler.IsExecuting(), "Components cannot be added or removed while systems are updating");
+
     for (auto const& system : m_Systems)
     {
         const auto& systemSignature = system->m_Signature;
 
         if ((newSignature & systemSignature) == systemSignature)
-            system->m_Entities.insert(entityID);
+        {
+            if (system->m_Entities.insert(entityID).second)
+            {
+                system->m_IsEntityArrayDirty = true;
+                system->OnEntityInserted(entityID);
+            }
+        }
         else
-            system->m_Entities.erase(entityID);
+        {
+            if (system->m_Entities.erase(entityID) != 0)
+            {
+                system->m_IsEntityArrayDirty = true;
+                system->OnEntityRemoved(entityID);
+            }
+        }
     }
 }
 
 void Ether::Ecs::EcsSystemManager::OnEntityDestroyed(EntityID entityID)
 {
+    AssertEngine(!m_Scheduler.IsExecuting(), "Entities cannot be destroyed while systems are updating");
+
     for (auto const& system : m_Systems)
     {
-        system->m_Entities.erase(entityID);
+        if (system->m_Entities.erase(entityID) != 0)
+        {
+            system->m_IsEntityArrayDirty = true;
+            system->OnEntityRemoved(entityID);
+        }
     }
 }
 
-void Ether::Ecs::EcsSystemManager::Update()
+void Ether::Ecs::EcsSystemManager::OnComponentModified(EntityID entityID, ComponentID componentID)
+{
+#ifdef ETH_ECS_VALIDATE_ACCESS
+    EcsSystemScheduler::ValidateComponentAccess(componentID, true);
+#endif
+
+    if (m_Scheduler.IsExecuting())
+    {
+        std::lock_guard<std::mutex> lock(m_DeferredModificationsMutex);
+        m_DeferredModifications.emplace_back(entityID, componentID);
+        return;
+    }
+
+    NotifyComponentModified(entityID, componentID);
+}
+
+void Ether::Ecs::EcsSystemManager::NotifyComponentModified(EntityID entityID, ComponentID componentID)
 {
     for (auto const& system : m_Systems)
-        system->Update();
+    {
+        if (!system->m_Signature.test(componentID))
+            continue;
+
+        if (system->m_Entities.find(entityID) != system->m_Entities.end())
+            system->OnEntityModified(entityID);
+    }
+}
+
+void Ether::Ecs::EcsSystemManager::Update()
+{
+    m_Scheduler.Execute();
+
+    for (const auto& [entityID, componentID] : m_DeferredModifications)
+        NotifyComponentModified(entityID, componentID);
+
+    m_DeferredModifications.clear();
 }
@@ -21,7 +21,9 @@
 
 #include "engine/pch.h"
 #include "engine/world/ecs/systems/ecssystem.h"
+#include "engine/world/ecs/ecssystemscheduler.h"
 #include "engine/world/ecs/ecstypes.h"
+#include <mutex>
 #include <typeindex>
 
 namespace Ether::Ecs
@@ -35,12 +37,19 @@ public:
 public:
     ETH_ENGINE_DLL void UpdateEntitySignature(EntityID entityID, EntitySignature newSignature);
     ETH_ENGINE_DLL void OnEntityDestroyed(EntityID entityID);
+    ETH_ENGINE_DLL void OnComponentModified(EntityID entityID, ComponentID componentID);
 
 private:
     friend class EcsManager;
     void Update();
+    void NotifyComponentModified(EntityID entityID, ComponentID componentID);
 
 private:
     std::vector<std::unique_ptr<EcsSystem>> m_Systems;
+    EcsSystemScheduler m_Scheduler;
+
+    // Modifications made by systems while they run concurrently, forwarded once all systems are done
+    std::vector<std::pair<EntityID, ComponentID>> m_DeferredModifications;
+    std::mutex m_DeferredModificationsMutex;
 };
 } // namespace Ether::Ecs
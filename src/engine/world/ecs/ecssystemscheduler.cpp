@@ -0,0 +1,110 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "engine/world/ecs/ecssystemscheduler.h"
+
+Ether::Ecs::EcsSystemScheduler::EcsSystemScheduler()
+    : m_IsExecuting(false)
+{
+}
+
+void Ether::Ecs::EcsSystemScheduler::Build(const std::vector<std::unique_ptr<EcsSystem>>& systems)
+{
+    m_Nodes.clear();
+    m_Nodes.resize(systems.size());
+    m_NumPendingDependencies = std::make_unique<std::atomic<uint32_t>[]>(systems.size());
+
+    for (uint32_t i = 0; i < systems.size(); ++i)
+    {
+        m_Nodes[i].m_System = systems[i].get();
+        m_Nodes[i].m_NumDependencies = 0;
+
+        const AccessMask& reads = systems[i]->GetReadAccess();
+        const AccessMask& writes = systems[i]->GetWriteAccess();
+
+        for (uint32_t j = 0; j < i; ++j)
+        {
+            const AccessMask& otherReads = systems[j]->GetReadAccess();
+            const AccessMask& otherWrites = systems[j]->GetWriteAccess();
+
+            if ((writes & (otherReads | otherWrites)).none() && (otherWrites & reads).none())
+                continue;
+
+            m_Nodes[j].m_Dependents.push_back(i);
+            m_Nodes[i].m_NumDependencies++;
+        }
+    }
+}
+
+void Ether::Ecs::EcsSystemScheduler::Execute()
+{
+    ETH_MARKER_EVENT("Ecs Systems - Execute");
+
+    m_IsExecuting = true;
+
+    for (uint32_t i = 0; i < m_Nodes.size(); ++i)
+        m_NumPendingDependencies[i].store(m_Nodes[i].m_NumDependencies, std::memory_order_relaxed);
+
+    JobCounter counter;
+    for (uint32_t i = 0; i < m_Nodes.size(); ++i)
+    {
+        if (m_Nodes[i].m_NumDependencies == 0)
+            ScheduleSystem(i, counter);
+    }
+
+    JobSystem::Wait(counter);
+    m_IsExecuting = false;
+}
+
+void Ether::Ecs::EcsSystemScheduler::ValidateComponentAccess(ComponentID componentID, bool isWrite)
+{
+    const EcsSystem* system = EcsSystem::GetActiveSystem();
+    if (system == nullptr)
+        return;
+
+    const bool isDeclared = isWrite ? system->GetWriteAccess().test(componentID)
+                                    : (system->GetReadAccess() | system->GetWriteAccess()).test(componentID);
+
+    AssertEngine(
+        isDeclared,
+        "%s accessed component %zu (%s) without declaring it",
+        system->GetName(),
+        componentID,
+        isWrite ? "write" : "read");
+}
+
+void Ether::Ecs::EcsSystemScheduler::ScheduleSystem(uint32_t nodeIdx, JobCounter& counter)
+{
+    JobSystem::Run(m_Nodes[nodeIdx].m_System->GetName(), counter, [this, nodeIdx, &counter]() { RunSystem(nodeIdx, counter); });
+}
+
+void Ether::Ecs::EcsSystemScheduler::RunSystem(uint32_t nodeIdx, JobCounter& counter)
+{
+    const Node& node = m_Nodes[nodeIdx];
+
+    // Restore the previous value, as this may be nested in another system waiting for its own jobs
+    const EcsSystem* previousSystem = EcsSystem::SetActiveSystem(node.m_System);
+    node.m_System->Update();
+    EcsSystem::SetActiveSystem(previousSystem);
+
+    for (uint32_t dependent : node.m_Dependents)
+    {
+        if (m_NumPendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ScheduleSystem(dependent, counter);
+    }
+}
@@ -0,0 +1,64 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "engine/pch.h"
+#include "engine/world/ecs/systems/ecssystem.h"
+#include "engine/world/ecs/ecstypes.h"
+
+namespace Ether::Ecs
+{
+/*
+    Runs the update of every system as a job. Two systems conflict if either writes a component
+    (or shared resource) that the other reads or writes. Conflicting systems are ordered by their
+    registration order, everything else is free to run concurrently.
+*/
+class EcsSystemScheduler : public NonCopyable, public NonMovable
+{
+public:
+    EcsSystemScheduler();
+    ~EcsSystemScheduler() = default;
+
+public:
+    void Build(const std::vector<std::unique_ptr<EcsSystem>>& systems);
+    void Execute();
+
+    inline bool IsExecuting() const { return m_IsExecuting; }
+
+    // Asserts if the system currently running on this thread did not declare access to the component
+    ETH_ENGINE_DLL static void ValidateComponentAccess(ComponentID componentID, bool isWrite);
+
+private:
+    struct Node
+    {
+        EcsSystem* m_System;
+        std::vector<uint32_t> m_Dependents;
+        uint32_t m_NumDependencies;
+    };
+
+private:
+    void ScheduleSystem(uint32_t nodeIdx, JobCounter& counter);
+    void RunSystem(uint32_t nodeIdx, JobCounter& counter);
+
+private:
+    std::vector<Node> m_Nodes;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_NumPendingDependencies;
+    std::atomic<bool> m_IsExecuting;
+};
+} // namespace Ether::Ecs
@@ -22,12 +22,45 @@
 #include "engine/pch.h"
 #include <bitset>
 
+// Checks that systems only touch components they declared access to
+#if defined(_DEBUG) && !defined(ETH_ECS_VALIDATE_ACCESS)
+#define ETH_ECS_VALIDATE_ACCESS
+#endif
+
+// Set through the ETH_MAX_NUM_ENTITIES cmake option. Every component array and most systems reserve
+// storage for this many entities up front, so it is only raised for builds that need it (e.g. the
+// large scene benchmarks).
+#ifndef ETH_MAX_NUM_ENTITIES
+#define ETH_MAX_NUM_ENTITIES 4096
+#endif
+
 namespace Ether::Ecs
 {
-constexpr uint32_t MaxNumEntities = 4096;
+constexpr uint32_t MaxNumEntities = ETH_MAX_NUM_ENTITIES;
+// Worlds saved before sparse serialization always contain exactly this many entity slots
+constexpr uint32_t LegacyNumEntities = 4096;
 constexpr uint32_t MaxNumComponents = 32;
 
 using ComponentID = size_t;
 using EntityID = uint32_t;
 using EntitySignature = std::bitset<MaxNumComponents>;
+
+static_assert(MaxNumEntities >= LegacyNumEntities, "Worlds saved with the default entity limit have to remain loadable");
+
+// State outside of the component arrays that is shared between systems. Declared like
+// component access so that the system scheduler can order the systems that touch it.
+enum class SharedResource : uint32_t
+{
+    // The camera fields of GraphicCore::GetNextRenderData()
+    RenderDataCamera,
+    // The visuals, batches and dirty materials of GraphicCore::GetNextRenderData()
+    RenderDataVisuals,
+    // World::GetTextureStreamer(), which the visual system requests texture mips from
+    TextureStreaming,
+    Count,
+};
+
+// One bit per component type followed by one bit per shared resource
+constexpr uint32_t AccessMaskSize = MaxNumComponents + static_cast<uint32_t>(SharedResource::Count);
+using AccessMask = std::bitset<AccessMaskSize>;
 } // namespace Ether::Ecs
@@ -26,8 +26,37 @@
 #include "graphics/graphiccore.h"
 
 Ether::Ecs::EcsCameraSystem::EcsCameraSystem()
+    : EcsSystem("Camera System")
 {
     m_Signature.set(EcsCameraComponent::s_ComponentID);
+
+    DeclareRead<EcsTransformComponent>();
+    DeclareRead<EcsCameraComponent>();
+    DeclareWrite(SharedResource::RenderDataCamera);
+}
+
+Ether::ethMatrix4x4 Ether::Ecs::EcsCameraSystem::GetViewMatrix(const EcsTransformComponent& transform)
+{
+    ethMatrix4x4 rotationInv = Transform::GetRotationMatrix(transform.m_Rotation).Inversed();
+    ethMatrix4x4 translationInv = Transform::GetTranslationMatrix(-transform.m_Translation);
+    return rotationInv * translationInv;
+}
+
+Ether::ethMatrix4x4 Ether::Ecs::EcsCameraSystem::GetProjectionMatrix(const EcsCameraComponent& camera, float aspect)
+{
+    ethMatrix4x4 projectionMatrix;
+    switch (camera.m_ProjectionMode)
+    {
+    case ProjectionMode::Perspective:
+        projectionMatrix = Transform::GetPerspectiveMatrixLH(
+            SMath::DegToRad(camera.m_FieldOfView),
+            aspect,
+            camera.m_NearPlane,
+            camera.m_FarPlane);
+        break;
+    }
+
+    return projectionMatrix;
 }
 
 void Ether::Ecs::EcsCameraSystem::Update()
@@ -39,40 +68,25 @@ void Ether::Ecs::EcsCameraSystem::Update()
     for (EntityID entityID : m_Entities)
     {
         Entity& entity = EngineCore::GetActiveWorld().GetEntity(entityID);
-        EcsCameraComponent& camera = entity.GetComponent<EcsCameraComponent>();
-        EcsTransformComponent& transform = entity.GetComponent<EcsTransformComponent>();
-
-        // TODO: Jitter mode is set through imgui debug menu (which is in gfx project), so we need to update the component manually
-        // In the future, this should be updated through the engine side, and this can be removed.
-        camera.SetJitterMode((JitterMode)Graphics::GraphicCore::GetGraphicConfig().m_TemporalAAJitterMode);
+        const EcsCameraComponent& camera = entity.GetComponent<EcsCameraComponent>();
+        const EcsTransformComponent& transform = entity.GetComponent<EcsTransformComponent>();
 
         if (!camera.m_Enabled)
             continue;
 
-        ethMatrix4x4 rotationInv = Transform::GetRotationMatrix(transform.m_Rotation).Inversed();
-        ethMatrix4x4 translationInv = Transform::GetTranslationMatrix(-transform.m_Translation);
-        ethMatrix4x4 viewMatrix = rotationInv * translationInv;
+        ethMatrix4x4 viewMatrix = GetViewMatrix(transform);
 
         ethVector2u resolution = EngineCore::GetEngineConfig().GetClientSize();
         float aspect = static_cast<float>(resolution.x) / resolution.y;
-
-        ethMatrix4x4 projectionMatrix;
-        switch (camera.m_ProjectionMode)
-        {
-        case ProjectionMode::Perspective:
-            projectionMatrix = Transform::GetPerspectiveMatrixLH(
-                SMath::DegToRad(camera.m_FieldOfView),
-                aspect,
-                camera.m_NearPlane,
-                camera.m_FarPlane);
-            break;
-        }
+        ethMatrix4x4 projectionMatrix = GetProjectionMatrix(camera, aspect);
 
         ethVector2 cameraJitter;
         if (gfxConfig.m_IsTemporalAAEnabled)
         {
+            // TODO: Jitter mode is set through imgui debug menu (which is in gfx project), so it is taken from the graphic
+            // config rather than the camera component. In the future, this should be set through the engine side.
             static uint32_t idx = 0;
-            ethVector2 sample = camera.GetJitterOffset(idx++);
+            ethVector2 sample = EcsCameraComponent::GetJitterOffset((JitterMode)gfxConfig.m_TemporalAAJitterMode, idx++);
             cameraJitter.x = (sample.x - 0.5f) * gfxConfig.m_DebugJitterScale / resolution.x;
             cameraJitter.y = (sample.y - 0.5f) * gfxConfig.m_DebugJitterScale / resolution.y;
 
@@ -83,7 +97,7 @@ void Ether::Ecs::EcsCameraSystem::Update()
         ethMatrix4x4 rotation = Transform::GetRotationMatrix(transform.m_Rotation);
         ethVector4 forward = rotation * ethVector4(0, 0, 1, 0);
 
-        Graphics::RenderData& renderData = Graphics::GraphicCore::GetGraphicRenderer().GetRenderData();
+        Graphics::RenderData& renderData = Graphics::GraphicCore::GetNextRenderData();
         renderData.m_ViewMatrix = viewMatrix;
         renderData.m_ProjectionMatrix = projectionMatrix;
         renderData.m_CameraDirection = forward.Resize<3>();
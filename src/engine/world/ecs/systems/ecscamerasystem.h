@@ -24,12 +24,21 @@
 
 namespace Ether::Ecs
 {
+class EcsCameraComponent;
+class EcsTransformComponent;
+
 class EcsCameraSystem : public EcsSystem
 {
 public:
     EcsCameraSystem();
     ~EcsCameraSystem() override = default;
 
+public:
+    // Also used by systems that need the camera without waiting for this one to write the render data
+    static ethMatrix4x4 GetViewMatrix(const EcsTransformComponent& transform);
+    // Without the TAA jitter
+    static ethMatrix4x4 GetProjectionMatrix(const EcsCameraComponent& camera, float aspect);
+
 protected:
     friend class EcsManager;
     void Update() override;
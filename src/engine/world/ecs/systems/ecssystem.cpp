@@ -21,10 +21,37 @@
 #include "engine/world/ecs/components/ecsmetadatacomponent.h"
 #include "engine/world/ecs/components/ecstransformcomponent.h"
 
-Ether::Ecs::EcsSystem::EcsSystem()
+static thread_local const Ether::Ecs::EcsSystem* s_ActiveSystem = nullptr;
+
+Ether::Ecs::EcsSystem::EcsSystem(const char* name)
+    : m_Name(name)
+    , m_IsEntityArrayDirty(true)
 {
     m_Signature.set(EcsMetadataComponent::s_ComponentID);
     m_Signature.set(EcsTransformComponent::s_ComponentID);
 }
 
 Ether::Ecs::EcsSystem::~EcsSystem() = default;
+
+void Ether::Ecs::EcsSystem::DeclareRead(SharedResource resource)
+{
+    m_ReadAccess.set(MaxNumComponents + static_cast<uint32_t>(resource));
+}
+
+void Ether::Ecs::EcsSystem::DeclareWrite(SharedResource resource)
+{
+    m_WriteAccess.set(MaxNumComponents + static_cast<uint32_t>(resource));
+}
+
+const Ether::Ecs::EcsSystem* Ether::Ecs::EcsSystem::GetActiveSystem()
+{
+    return s_ActiveSystem;
+}
+
+// Returns the previously active system, which has to be restored once the system's work is done
+const Ether::Ecs::EcsSystem* Ether::Ecs::EcsSystem::SetActiveSystem(const EcsSystem* system)
+{
+    const EcsSystem* previousSystem = s_ActiveSystem;
+    s_ActiveSystem = system;
+    return previousSystem;
+}
@@ -28,15 +28,93 @@ namespace Ether::Ecs
 class EcsSystem : public NonCopyable, public NonMovable
 {
 public:
-    EcsSystem();
+    EcsSystem(const char* name);
     virtual ~EcsSystem() = 0;
 
+public:
+    inline const char* GetName() const { return m_Name; }
+    inline const AccessMask& GetReadAccess() const { return m_ReadAccess; }
+    inline const AccessMask& GetWriteAccess() const { return m_WriteAccess; }
+
+    // The system whose work is running on the calling thread, if any. Used to validate component access.
+    ETH_ENGINE_DLL static const EcsSystem* GetActiveSystem();
+    ETH_ENGINE_DLL static const EcsSystem* SetActiveSystem(const EcsSystem* system);
+
 protected:
     friend class EcsSystemManager;
+    friend class EcsSystemScheduler;
+
+    // Systems that do not conflict in their declared access are updated concurrently on worker threads
     virtual void Update() = 0;
 
+    // Notifications for systems that keep persistent state about their entities
+    virtual void OnEntityInserted(EntityID entityID) {}
+    virtual void OnEntityRemoved(EntityID entityID) {}
+    virtual void OnEntityModified(EntityID entityID) {}
+
+protected:
+    // Component access has to be declared in the constructor, so that the scheduler can order systems
+    template <typename T>
+    void DeclareRead() { m_ReadAccess.set(T::s_ComponentID); }
+    template <typename T>
+    void DeclareWrite() { m_WriteAccess.set(T::s_ComponentID); }
+    void DeclareRead(SharedResource resource);
+    void DeclareWrite(SharedResource resource);
+
+    // Splits [0, count) into chunks that are processed by func(begin, end) across worker threads
+    template <typename Func>
+    void ParallelFor(uint32_t count, Func&& func, uint32_t minChunkSize = 64);
+
+    // Splits m_Entities into chunks that are processed by func(entityID) across worker threads
+    template <typename Func>
+    void ParallelForEachEntity(Func&& func, uint32_t minChunkSize = 64);
+
 protected:
     std::set<EntityID> m_Entities;
     EntitySignature m_Signature;
+
+private:
+    const char* m_Name;
+    AccessMask m_ReadAccess;
+    AccessMask m_WriteAccess;
+
+    // Random access copy of m_Entities, so that it can be split into ranges
+    std::vector<EntityID> m_EntityArray;
+    bool m_IsEntityArrayDirty;
 };
+
+template <typename Func>
+void EcsSystem::ParallelFor(uint32_t count, Func&& func, uint32_t minChunkSize)
+{
+    JobSystem::ParallelFor(
+        m_Name,
+        count,
+        [this, &func](uint32_t begin, uint32_t end)
+        {
+            // Chunks may be picked up by threads that are in the middle of another system
+            const EcsSystem* previousSystem = SetActiveSystem(this);
+            func(begin, end);
+            SetActiveSystem(previousSystem);
+        },
+        minChunkSize);
+}
+
+template <typename Func>
+void EcsSystem::ParallelForEachEntity(Func&& func, uint32_t minChunkSize)
+{
+    if (m_IsEntityArrayDirty)
+    {
+        m_EntityArray.assign(m_Entities.begin(), m_Entities.end());
+        m_IsEntityArrayDirty = false;
+    }
+
+    ParallelFor(
+        static_cast<uint32_t>(m_EntityArray.size()),
+        [this, &func](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+                func(m_EntityArray[i]);
+        },
+        minChunkSize);
+}
 } // namespace Ether::Ecs
@@ -20,115 +20,409 @@
 #include "engine/enginecore.h"
 #include "engine/world/entity.h"
 #include "engine/world/ecs/systems/ecsvisualsystem.h"
+#include "engine/world/ecs/systems/ecscamerasystem.h"
 #include "engine/world/ecs/components/ecsvisualcomponent.h"
 #include "engine/world/ecs/components/ecscameracomponent.h"
 #include "engine/world/ecs/components/ecstransformcomponent.h"
 
 #include "graphics/graphiccore.h"
-#include "graphics/common/visualbatch.h"
+
+// Camera movement below this threshold (per view projection matrix element) does not trigger re-culling
+static constexpr float CullingCameraEpsilon = 1e-5f;
+
+// Visuals per culling job. Testing a box against the frustum is cheap, so chunks have to be large.
+static constexpr uint32_t CullingChunkSize = 512;
+
+// Transforms the bounds as center/extents so that the world space box stays conservative under rotation
+static Ether::Aabb ComputeWorldBounds(const Ether::Aabb& localBounds, const Ether::ethMatrix4x4& world)
+{
+    Ether::Aabb worldBounds = localBounds;
+
+    for (uint32_t r = 0; r < 3; ++r)
+    {
+        float center = world.m_Data2D[r][3];
+        float extent = 0.0f;
+
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            center += world.m_Data2D[r][c] * (localBounds.m_Max.m_Data[c] + localBounds.m_Min.m_Data[c]) * 0.5f;
+            extent += std::abs(world.m_Data2D[r][c]) * (localBounds.m_Max.m_Data[c] - localBounds.m_Min.m_Data[c]) * 0.5f;
+        }
+
+        worldBounds.m_Min.m_Data[r] = center - extent;
+        worldBounds.m_Max.m_Data[r] = center + extent;
+    }
+
+    return worldBounds;
+}
+
+// Rough size of the bounds on screen in pixels, along their larger side. Cameras inside of the bounds get the largest footprint.
+static float ComputeScreenFootprint(const Ether::Aabb& worldBounds, const Ether::ethVector3& cameraPosition, float projectionScale)
+{
+    const Ether::ethVector3 center = (worldBounds.m_Max + worldBounds.m_Min) * 0.5f;
+    const float radius = ((worldBounds.m_Max - worldBounds.m_Min) * 0.5f).Magnitude();
+    const float distance = (center - cameraPosition).Magnitude();
+
+    if (distance <= radius)
+        return std::numeric_limits<float>::max();
+
+    return 2.0f * radius / distance * projectionScale;
+}
+
+// True while the visual refers to a mesh or material that is not in the resource manager
+static bool HasMissingResources(const Ether::Ecs::EcsVisualComponent& visual, const Ether::ResourceManager& resources)
+{
+    if (visual.m_MeshGuid != Ether::StringID("") && resources.GetMeshResource(visual.m_MeshGuid) == nullptr)
+        return true;
+
+    return visual.m_MaterialGuid != Ether::StringID("") && resources.GetMaterialResource(visual.m_MaterialGuid) == nullptr;
+}
 
 Ether::Ecs::EcsVisualSystem::EcsVisualSystem()
+    : EcsSystem("Visual System")
+    , m_HasCullingCamera(false)
+    , m_CameraPosition()
+    , m_ProjectionScale(0.0f)
 {
     m_Signature.set(EcsVisualComponent::s_ComponentID);
+    m_EntityToSlot.fill(InvalidSlot);
+
+    DeclareRead<EcsVisualComponent>();
+    DeclareRead<EcsTransformComponent>();
+    DeclareRead<EcsCameraComponent>();
+    DeclareWrite(SharedResource::RenderDataVisuals);
+    DeclareWrite(SharedResource::TextureStreaming);
 }
 
 void Ether::Ecs::EcsVisualSystem::Update()
 {
     ETH_MARKER_EVENT("Visual System - Update");
 
-    ResourceManager& resources = EngineCore::GetActiveWorld().GetResourceManager();
-    Graphics::RenderData& renderData = Graphics::GraphicCore::GetGraphicRenderer().GetRenderData();
-    renderData.m_Visuals.clear();
-    renderData.m_VisualBatches.clear();
-    std::unordered_map<StringID, uint32_t> materialToBatchMap;
+    Graphics::RenderData& renderData = Graphics::GraphicCore::GetNextRenderData();
+    const bool cameraChanged = UpdateCullingCamera();
+
+    RetryPendingEntities();
+    const bool visualsChanged = !m_DirtyEntities.empty();
 
-    for (EntityID entityID : m_Entities)
+    if (visualsChanged)
     {
-        Entity& entity = EngineCore::GetActiveWorld().GetEntity(entityID);
-        EcsVisualComponent& data = entity.GetComponent<EcsVisualComponent>();
+        ETH_MARKER_EVENT("Visual System - Sync Dirty Entities");
 
-        if (!data.m_Enabled)
-            continue;
+        for (EntityID entityID : m_DirtyEntities)
+        {
+            m_IsDirty.reset(entityID);
+            SyncVisual(entityID, renderData);
+        }
+
+        m_DirtyEntities.clear();
+        renderData.m_VisualsVersion++;
+    }
 
-        Graphics::Visual gfxVisual;
-        Graphics::VisualBatch* gfxVisualBatch;
+    // Visuals that were synced above have already been culled against the current camera
+    if (cameraChanged)
+    {
+        ETH_MARKER_EVENT("Visual System - Frustum Culling");
 
-        if (materialToBatchMap.find(data.m_MaterialGuid) == materialToBatchMap.end())
-        {
-            renderData.m_VisualBatches.emplace_back();
-            materialToBatchMap[data.m_MaterialGuid] = renderData.m_VisualBatches.size() - 1;
-            gfxVisualBatch = &renderData.m_VisualBatches[materialToBatchMap.at(data.m_MaterialGuid)];
-            if (data.m_MaterialGuid == StringID(""))
-            {
-                gfxVisualBatch->m_Material = Graphics::GraphicCore::GetGraphicCommon().m_DefaultMaterial.get();
-            }
-            else
+        ParallelFor(
+            static_cast<uint32_t>(renderData.m_Visuals.size()),
+            [this, &renderData](uint32_t begin, uint32_t end)
             {
-                gfxVisualBatch->m_Material = resources.GetMaterialResource(data.m_MaterialGuid);
+                for (uint32_t i = begin; i < end; ++i)
+                    renderData.m_Visuals[i].m_Culled = !IsVisualInFrustum(m_SlotWorldBounds[i]);
+            },
+            CullingChunkSize);
 
-                if (gfxVisualBatch->m_Material == nullptr)
-                    gfxVisualBatch->m_Material = Graphics::GraphicCore::GetGraphicCommon().m_ErrorMaterial.get();
-            }
+        renderData.m_VisualsVersion++;
+    }
 
-            gfxVisualBatch->m_Material->SetTransientMaterialIdx(materialToBatchMap.at(data.m_MaterialGuid));
-        }
-        else
+    RequestTextureMips(renderData, visualsChanged || cameraChanged);
+}
+
+void Ether::Ecs::EcsVisualSystem::OnEntityInserted(EntityID entityID)
+{
+    // Component data is usually filled in right after the component is added, so it is only read during the next update
+    MarkDirty(entityID);
+}
+
+void Ether::Ecs::EcsVisualSystem::OnEntityRemoved(EntityID entityID)
+{
+    MarkDirty(entityID);
+}
+
+void Ether::Ecs::EcsVisualSystem::OnEntityModified(EntityID entityID)
+{
+    MarkDirty(entityID);
+}
+
+void Ether::Ecs::EcsVisualSystem::MarkDirty(EntityID entityID)
+{
+    if (m_IsDirty.test(entityID))
+        return;
+
+    m_IsDirty.set(entityID);
+    m_DirtyEntities.push_back(entityID);
+}
+
+void Ether::Ecs::EcsVisualSystem::MarkPending(EntityID entityID)
+{
+    if (m_IsPending.test(entityID))
+        return;
+
+    m_IsPending.set(entityID);
+    m_PendingEntities.push_back(entityID);
+}
+
+void Ether::Ecs::EcsVisualSystem::RetryPendingEntities()
+{
+    if (m_PendingEntities.empty())
+        return;
+
+    ETH_MARKER_EVENT("Visual System - Retry Pending Entities");
+
+    World& world = EngineCore::GetActiveWorld();
+    const ResourceManager& resources = world.GetResourceManager();
+    uint32_t numPending = 0;
+
+    for (EntityID entityID : m_PendingEntities)
+    {
+        // Still waiting, unless the entity has left the system or no longer refers to the missing resources
+        if (m_Entities.find(entityID) != m_Entities.end() &&
+            HasMissingResources(world.GetEntity(entityID).GetComponent<EcsVisualComponent>(), resources))
         {
-            gfxVisualBatch = &renderData.m_VisualBatches[materialToBatchMap.at(data.m_MaterialGuid)];
+            m_PendingEntities[numPending++] = entityID;
+            continue;
         }
 
-        if (gfxVisualBatch->m_Material->GetBaseColor().w < 1.0)
-            continue; // Don't support transparency
+        m_IsPending.reset(entityID);
+        MarkDirty(entityID);
+    }
 
+    m_PendingEntities.resize(numPending);
+}
 
-        gfxVisual.m_Mesh = resources.GetMeshResource(data.m_MeshGuid);
-        if (gfxVisual.m_Mesh == nullptr)
-            continue;
+void Ether::Ecs::EcsVisualSystem::SyncVisual(EntityID entityID, Graphics::RenderData& renderData)
+{
+    // Entities that have left the system since they were marked dirty (e.g. destroyed or component removed)
+    if (m_Entities.find(entityID) == m_Entities.end())
+    {
+        RemoveVisual(entityID, renderData);
+        return;
+    }
+
+    ResourceManager& resources = EngineCore::GetActiveWorld().GetResourceManager();
+    Entity& entity = EngineCore::GetActiveWorld().GetEntity(entityID);
+    EcsVisualComponent& data = entity.GetComponent<EcsVisualComponent>();
+    EcsTransformComponent& transform = entity.GetComponent<EcsTransformComponent>();
 
-        gfxVisual.m_Material = gfxVisualBatch->m_Material;
-        gfxVisual.m_Culled = !IsVisualCulled(gfxVisual);
+    if (!data.m_Enabled)
+    {
+        RemoveVisual(entityID, renderData);
+        return;
+    }
 
+    // Drawn with the error material (or not at all, without a mesh) until the resources are loaded
+    if (HasMissingResources(data, resources))
+        MarkPending(entityID);
+
+    const uint32_t batchIdx = GetOrCreateBatch(data.m_MaterialGuid, renderData);
+
+    Graphics::Visual gfxVisual;
+    gfxVisual.m_Material = renderData.m_VisualBatches[batchIdx].m_Material;
+    gfxVisual.m_Mesh = resources.GetMeshResource(data.m_MeshGuid);
+
+    // Don't support transparency
+    if (gfxVisual.m_Mesh == nullptr || gfxVisual.m_Material->GetBaseColor().w < 1.0)
+    {
+        RemoveVisual(entityID, renderData);
+        return;
+    }
+
+    gfxVisual.m_WorldMatrix = Transform::GetTranslationMatrix(transform.m_Translation) *
+                              Transform::GetRotationMatrix(transform.m_Rotation) *
+                              Transform::GetScaleMatrix(transform.m_Scale);
+
+    const Aabb worldBounds = ComputeWorldBounds(gfxVisual.m_Mesh->GetBoundingBox(), gfxVisual.m_WorldMatrix);
+    gfxVisual.m_Culled = !IsVisualInFrustum(worldBounds);
+
+    uint32_t slot = m_EntityToSlot[entityID];
+
+    if (slot == InvalidSlot)
+    {
+        slot = static_cast<uint32_t>(renderData.m_Visuals.size());
+        m_EntityToSlot[entityID] = slot;
+        m_SlotToEntity.push_back(entityID);
+        m_SlotWorldBounds.push_back(worldBounds);
         renderData.m_Visuals.push_back(gfxVisual);
-        gfxVisualBatch->m_Visuals.emplace_back(gfxVisual);
+        renderData.m_VisualBatches[batchIdx].m_NumVisuals++;
+        return;
     }
+
+    Graphics::Visual& oldVisual = renderData.m_Visuals[slot];
+    if (oldVisual.m_Material != gfxVisual.m_Material)
+    {
+        renderData.m_VisualBatches[oldVisual.m_Material->GetTransientMaterialIdx()].m_NumVisuals--;
+        renderData.m_VisualBatches[batchIdx].m_NumVisuals++;
+    }
+
+    oldVisual = gfxVisual;
+    m_SlotWorldBounds[slot] = worldBounds;
 }
 
-bool Ether::Ecs::EcsVisualSystem::IsVisualCulled(const Graphics::Visual& visual) const
+void Ether::Ecs::EcsVisualSystem::RemoveVisual(EntityID entityID, Graphics::RenderData& renderData)
 {
-    Entity* camera = EngineCore::GetActiveWorld().GetMainCamera();
-    if (camera == nullptr)
-        return false;
+    const uint32_t slot = m_EntityToSlot[entityID];
+    if (slot == InvalidSlot)
+        return;
+
+    renderData.m_VisualBatches[renderData.m_Visuals[slot].m_Material->GetTransientMaterialIdx()].m_NumVisuals--;
+
+    // Swap with the last visual, so that the array stays dense and only one other slot has to move
+    const uint32_t lastSlot = static_cast<uint32_t>(renderData.m_Visuals.size()) - 1;
+    if (slot != lastSlot)
+    {
+        const EntityID movedEntityID = m_SlotToEntity[lastSlot];
+        renderData.m_Visuals[slot] = renderData.m_Visuals[lastSlot];
+        m_SlotWorldBounds[slot] = m_SlotWorldBounds[lastSlot];
+        m_SlotToEntity[slot] = movedEntityID;
+        m_EntityToSlot[movedEntityID] = slot;
+    }
+
+    renderData.m_Visuals.pop_back();
+    m_SlotWorldBounds.pop_back();
+    m_SlotToEntity.pop_back();
+    m_EntityToSlot[entityID] = InvalidSlot;
+}
+
+uint32_t Ether::Ecs::EcsVisualSystem::GetOrCreateBatch(StringID materialGuid, Graphics::RenderData& renderData)
+{
+    Graphics::Material* material;
+    if (materialGuid == StringID(""))
+    {
+        material = Graphics::GraphicCore::GetGraphicCommon().m_DefaultMaterial.get();
+    }
+    else
+    {
+        material = EngineCore::GetActiveWorld().GetResourceManager().GetMaterialResource(materialGuid);
 
-    Graphics::RenderData& renderData = Graphics::GraphicCore::GetGraphicRenderer().GetRenderData();
+        if (material == nullptr)
+            material = Graphics::GraphicCore::GetGraphicCommon().m_ErrorMaterial.get();
+    }
 
-    Aabb visualAabb = visual.m_Mesh->GetBoundingBox();
+    // Batches are keyed by material rather than guid, since the transient material index can only point to one batch
+    const auto iter = m_MaterialToBatchMap.find(material);
+    if (iter != m_MaterialToBatchMap.end())
+        return iter->second;
 
-    ethMatrix4x4 viewProjectionMatrix = renderData.m_ProjectionMatrix * renderData.m_ViewMatrix;
-    //viewProjectionMatrix = viewProjectionMatrix.Transposed();
+    const uint32_t batchIdx = static_cast<uint32_t>(renderData.m_VisualBatches.size());
+    renderData.m_VisualBatches.push_back({ material, 0 });
+    renderData.m_DirtyMaterials.Add(batchIdx);
+    material->SetTransientMaterialIdx(batchIdx);
 
-    ethVector4 planes[6];
-    planes[0] = ethVector4(viewProjectionMatrix.m_Data2D[2]);
-    planes[1] = ethVector4(viewProjectionMatrix.m_Data2D[3]) - ethVector4(viewProjectionMatrix.m_Data2D[2]);
-    planes[2] = ethVector4(viewProjectionMatrix.m_Data2D[3]) + ethVector4(viewProjectionMatrix.m_Data2D[0]);
-    planes[3] = ethVector4(viewProjectionMatrix.m_Data2D[3]) - ethVector4(viewProjectionMatrix.m_Data2D[0]);
-    planes[4] = ethVector4(viewProjectionMatrix.m_Data2D[3]) - ethVector4(viewProjectionMatrix.m_Data2D[1]);
-    planes[5] = ethVector4(viewProjectionMatrix.m_Data2D[3]) + ethVector4(viewProjectionMatrix.m_Data2D[1]);
+    m_MaterialToBatchMap[material] = batchIdx;
+    return batchIdx;
+}
+
+void Ether::Ecs::EcsVisualSystem::RequestTextureMips(const Graphics::RenderData& renderData, bool visualsChanged)
+{
+    if (!Graphics::Texture::IsMipStreamingEnabled())
+        return;
+
+    if (visualsChanged || m_BatchFootprints.size() != renderData.m_VisualBatches.size())
+    {
+        ETH_MARKER_EVENT("Visual System - Estimate Footprints");
+
+        // Pixels per unit at a distance of 1
+        const float projectionScale = m_ProjectionScale * Graphics::GraphicCore::GetGraphicConfig().GetResolution().y * 0.5f;
+        m_BatchFootprints.assign(renderData.m_VisualBatches.size(), 0.0f);
+
+        for (uint32_t i = 0; i < renderData.m_Visuals.size(); ++i)
+        {
+            const Graphics::Visual& visual = renderData.m_Visuals[i];
+            if (visual.m_Culled)
+                continue;
+
+            float& footprint = m_BatchFootprints[visual.m_Material->GetTransientMaterialIdx()];
+            footprint = (std::max)(footprint, ComputeScreenFootprint(m_SlotWorldBounds[i], m_CameraPosition, projectionScale));
+        }
+    }
+
+    // The streamer only keeps up what is requested, so this happens every frame
+    TextureStreamer* textureStreamer = EngineCore::GetActiveWorld().GetTextureStreamer();
+    if (textureStreamer == nullptr)
+        return;
+
+    for (uint32_t i = 0; i < m_BatchFootprints.size(); ++i)
+        if (m_BatchFootprints[i] > 0.0f)
+            textureStreamer->RequestMaterial(*renderData.m_VisualBatches[i].m_Material, m_BatchFootprints[i]);
+}
+
+bool Ether::Ecs::EcsVisualSystem::UpdateCullingCamera()
+{
+    // Built from the camera components rather than the render data, so that this system does not have to wait
+    // for the camera system. The projection is without the TAA jitter, which would change the frustum every frame.
+    Entity* mainCamera = EngineCore::GetActiveWorld().GetMainCamera();
+    const bool hasCamera = mainCamera != nullptr;
+
+    ethMatrix4x4 viewProjectionMatrix;
+    if (hasCamera)
+    {
+        const EcsCameraComponent& camera = mainCamera->GetComponent<EcsCameraComponent>();
+        const EcsTransformComponent& transform = mainCamera->GetComponent<EcsTransformComponent>();
+
+        // Keep culling against the last frustum, like the renderer keeps drawing from the last camera
+        if (!camera.m_Enabled)
+            return false;
+
+        const ethVector2u resolution = EngineCore::GetEngineConfig().GetClientSize();
+        const float aspect = static_cast<float>(resolution.x) / resolution.y;
+        const ethMatrix4x4 projectionMatrix = EcsCameraSystem::GetProjectionMatrix(camera, aspect);
+        viewProjectionMatrix = projectionMatrix * EcsCameraSystem::GetViewMatrix(transform);
+
+        m_CameraPosition = transform.m_Translation;
+        m_ProjectionScale = projectionMatrix.m_Data2D[1][1];
+    }
+
+    bool hasChanged = hasCamera != m_HasCullingCamera;
+    for (uint32_t r = 0; r < 4 && !hasChanged; ++r)
+        for (uint32_t c = 0; c < 4 && !hasChanged; ++c)
+            hasChanged = std::abs(viewProjectionMatrix.m_Data2D[r][c] - m_CullingViewProjection.m_Data2D[r][c]) > CullingCameraEpsilon;
+
+    if (!hasChanged)
+        return false;
+
+    m_HasCullingCamera = hasCamera;
+    m_CullingViewProjection = viewProjectionMatrix;
+
+    m_FrustumPlanes[0] = ethVector4(viewProjectionMatrix.m_Data2D[2]);
+    m_FrustumPlanes[1] = ethVector4(viewProjectionMatrix.m_Data2D[3]) - ethVector4(viewProjectionMatrix.m_Data2D[2]);
+    m_FrustumPlanes[2] = ethVector4(viewProjectionMatrix.m_Data2D[3]) + ethVector4(viewProjectionMatrix.m_Data2D[0]);
+    m_FrustumPlanes[3] = ethVector4(viewProjectionMatrix.m_Data2D[3]) - ethVector4(viewProjectionMatrix.m_Data2D[0]);
+    m_FrustumPlanes[4] = ethVector4(viewProjectionMatrix.m_Data2D[3]) - ethVector4(viewProjectionMatrix.m_Data2D[1]);
+    m_FrustumPlanes[5] = ethVector4(viewProjectionMatrix.m_Data2D[3]) + ethVector4(viewProjectionMatrix.m_Data2D[1]);
 
     for (uint32_t i = 0; i < 6; ++i)
     {
-        ethVector3 normal = planes[i].Resize<3>();
-        planes[i] /= normal.Magnitude();
+        ethVector3 normal = m_FrustumPlanes[i].Resize<3>();
+        m_FrustumPlanes[i] /= normal.Magnitude();
     }
 
+    return true;
+}
+
+bool Ether::Ecs::EcsVisualSystem::IsVisualInFrustum(const Aabb& worldBounds) const
+{
+    if (!m_HasCullingCamera)
+        return true;
+
     for (uint32_t i = 0; i < 6; ++i)
     {
         ethVector4 vert;
-        vert.x = planes[i].x > 0 ? visualAabb.m_Max.x : visualAabb.m_Min.x;
-        vert.y = planes[i].y > 0 ? visualAabb.m_Max.y : visualAabb.m_Min.y;
-        vert.z = planes[i].z > 0 ? visualAabb.m_Max.z : visualAabb.m_Min.z;
+        vert.x = m_FrustumPlanes[i].x > 0 ? worldBounds.m_Max.x : worldBounds.m_Min.x;
+        vert.y = m_FrustumPlanes[i].y > 0 ? worldBounds.m_Max.y : worldBounds.m_Min.y;
+        vert.z = m_FrustumPlanes[i].z > 0 ? worldBounds.m_Max.z : worldBounds.m_Min.z;
         vert.w = 1.0f;
 
-        if (ethVector4::Dot(vert, planes[i]) < 0.0f)
+        if (ethVector4::Dot(vert, m_FrustumPlanes[i]) < 0.0f)
             return false;
     }
     return true;
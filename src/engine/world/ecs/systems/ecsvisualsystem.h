@@ -21,7 +21,8 @@
 
 #include "engine/pch.h"
 #include "engine/world/ecs/systems/ecssystem.h"
-#include "graphics/common/visual.h"
+#include "graphics/common/renderdata.h"
+#include <array>
 
 namespace Ether::Ecs
 {
@@ -34,8 +35,51 @@ public:
 protected:
     friend class EcsManager;
     void Update() override;
+    void OnEntityInserted(EntityID entityID) override;
+    void OnEntityRemoved(EntityID entityID) override;
+    void OnEntityModified(EntityID entityID) override;
 
 protected:
-    bool IsVisualCulled(const Graphics::Visual& visual) const;
+    bool IsVisualInFrustum(const Aabb& worldBounds) const;
+
+private:
+    void MarkDirty(EntityID entityID);
+    void MarkPending(EntityID entityID);
+    void RetryPendingEntities();
+    void SyncVisual(EntityID entityID, Graphics::RenderData& renderData);
+    void RemoveVisual(EntityID entityID, Graphics::RenderData& renderData);
+    uint32_t GetOrCreateBatch(StringID materialGuid, Graphics::RenderData& renderData);
+    bool UpdateCullingCamera();
+    // Reports the screen space footprint of every material in view to the texture streamer
+    void RequestTextureMips(const Graphics::RenderData& renderData, bool visualsChanged);
+
+private:
+    static constexpr uint32_t InvalidSlot = std::numeric_limits<uint32_t>::max();
+
+    // Maps between entities and their slot in RenderData::m_Visuals
+    std::array<uint32_t, MaxNumEntities> m_EntityToSlot;
+    std::vector<EntityID> m_SlotToEntity;
+    std::vector<Aabb> m_SlotWorldBounds;
+
+    std::vector<EntityID> m_DirtyEntities;
+    std::bitset<MaxNumEntities> m_IsDirty;
+
+    // Entities whose mesh or material was not loaded when they were synced (e.g. still streaming in).
+    // Nothing notifies the system when a resource arrives, so they are checked again every update.
+    std::vector<EntityID> m_PendingEntities;
+    std::bitset<MaxNumEntities> m_IsPending;
+
+    std::unordered_map<Graphics::Material*, uint32_t> m_MaterialToBatchMap;
+
+    bool m_HasCullingCamera;
+    ethMatrix4x4 m_CullingViewProjection;
+    ethVector4 m_FrustumPlanes[6];
+
+    // Of the culling camera, for the screen space footprints
+    ethVector3 m_CameraPosition;
+    float m_ProjectionScale;
+
+    // Largest footprint (in pixels) of the visuals in view, per batch
+    std::vector<float> m_BatchFootprints;
 };
 } // namespace Ether::Ecs
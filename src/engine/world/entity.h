@@ -59,6 +59,11 @@ public:
     template <typename T>
     void RemoveComponent();
 
+    // Has to be called after changing a component through GetComponent(), so that systems which
+    // cache data derived from it (e.g. the render data built by the visual system) pick up the change
+    template <typename T>
+    void MarkModified();
+
 private:
     Ecs::EntityID m_EntityID;
 
@@ -93,6 +98,19 @@ T& Ether::Entity::AddComponent()
 template <typename T>
 void Ether::Entity::RemoveComponent()
 {
-    m_ComponentManager.RemoveComponent<T>();
+    m_ComponentManager.RemoveComponent<T>(GetID());
+
+    // Update signature
+    auto signature = m_EntityManager.GetSignature(GetID());
+
+    signature.reset(m_ComponentManager.GetTypeID<T>());
+    m_EntityManager.SetSignature(GetID(), signature);
+    m_SystemsManager.UpdateEntitySignature(GetID(), signature);
+}
+
+template <typename T>
+void Ether::Entity::MarkModified()
+{
+    m_SystemsManager.OnComponentModified(GetID(), m_ComponentManager.GetTypeID<T>());
 }
 } // namespace Ether
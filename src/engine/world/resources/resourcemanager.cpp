@@ -18,7 +18,7 @@
 */
 
 #include "engine/world/resources/resourcemanager.h"
-#include "graphics/context/commandcontext.h"
+#include "graphics/graphiccore.h"
 
 constexpr uint32_t ResourceManagerVersion = 0;
 
@@ -66,6 +66,28 @@ Ether::StringID Ether::ResourceManager::RegisterTextureResource(std::unique_ptr<
     return sid;
 }
 
+std::unique_ptr<Ether::Graphics::Mesh> Ether::ResourceManager::UnregisterMeshResource(StringID guid)
+{
+    const auto iter = m_Meshes.find(guid);
+    if (iter == m_Meshes.end())
+        return nullptr;
+
+    std::unique_ptr<Graphics::Mesh> mesh = std::move(iter->second);
+    m_Meshes.erase(iter);
+    return mesh;
+}
+
+std::unique_ptr<Ether::Graphics::Texture> Ether::ResourceManager::UnregisterTextureResource(StringID guid)
+{
+    const auto iter = m_Textures.find(guid);
+    if (iter == m_Textures.end())
+        return nullptr;
+
+    std::unique_ptr<Graphics::Texture> texture = std::move(iter->second);
+    m_Textures.erase(iter);
+    return texture;
+}
+
 Ether::Graphics::Mesh* Ether::ResourceManager::GetMeshResource(StringID guid) const
 {
     if (m_Meshes.find(guid) == m_Meshes.end())
@@ -90,21 +112,34 @@ Ether::Graphics::Texture* Ether::ResourceManager::GetTextureResource(StringID gu
     return m_Textures.at(guid).get();
 }
 
-void Ether::ResourceManager::CreateGpuResources() const 
-{ 
+void Ether::ResourceManager::CreateGpuResources() const
+{
+    ETH_MARKER_EVENT("Resource Manager - Create GPU Resources");
+
+    if (Graphics::GraphicCore::IsHeadless())
+        return;
+
+    auto start = Time::GetRealTime();
+    Graphics::UploadQueue& uploadQueue = Graphics::GraphicCore::GetUploadQueue();
+    const uint32_t numBatchesBefore = uploadQueue.GetNumBatchesSubmitted();
+    const uint64_t numBytesBefore = uploadQueue.GetNumBytesStaged();
+
     for (auto& pair : m_Meshes)
-    {
-        Graphics::CommandContext ctx("CommandContext - Mesh Loading", Graphics::RhiCommandType::Graphic, _16MiB);
-        ctx.Reset();
-        pair.second->CreateGpuResources(ctx);
-        ctx.FinalizeAndExecute(true);
-    }
+        pair.second->CreateGpuResources(uploadQueue);
 
     for (auto& pair : m_Textures)
-    {
-        Graphics::CommandContext textureUploadCtx("CommandContext - Texture Loading", Graphics::RhiCommandType::Graphic, _128MiB);
-        textureUploadCtx.Reset();
-        pair.second->CreateGpuResource(textureUploadCtx);
-        textureUploadCtx.FinalizeAndExecute(true);
-    }
+        pair.second->CreateGpuResource(uploadQueue);
+
+    // Kick off whatever is left in the last batch. The graphic queue waits for the copies on the GPU,
+    // so there is no need to block here.
+    uploadQueue.Submit();
+
+    auto end = Time::GetRealTime();
+    LogEngineInfo(
+        "Staged %zu meshes and %zu textures (%.2f MiB in %u batches) for upload in %f seconds",
+        m_Meshes.size(),
+        m_Textures.size(),
+        (uploadQueue.GetNumBytesStaged() - numBytesBefore) / static_cast<double>(_1MiB),
+        uploadQueue.GetNumBatchesSubmitted() - numBatchesBefore,
+        (end - start) / 1000.0f);
 }
@@ -42,6 +42,10 @@ public:
     ETH_ENGINE_DLL StringID RegisterTextureResource(std::unique_ptr<Graphics::Texture>&& texture);
     ETH_ENGINE_DLL void CreateGpuResources() const;
 
+    // Hand ownership back, e.g. to the world streamer when a resource is evicted
+    std::unique_ptr<Graphics::Mesh> UnregisterMeshResource(StringID guid);
+    std::unique_ptr<Graphics::Texture> UnregisterTextureResource(StringID guid);
+
     Graphics::Mesh* GetMeshResource(StringID guid) const;
     Graphics::Material* GetMaterialResource(StringID guid) const;
     Graphics::Texture* GetTextureResource(StringID guid) const;
@@ -54,6 +58,7 @@ private:
 
 private:
     friend class World;
+    friend class StreamingWorldWriter;
     std::unordered_map<StringID, std::unique_ptr<Graphics::Mesh>> m_Meshes;
     std::unordered_map<StringID, std::unique_ptr<Graphics::Material>> m_Materials;
     std::unordered_map<StringID, std::unique_ptr<Graphics::Texture>> m_Textures;
@@ -18,11 +18,16 @@
 */
 
 #include "engine/world/scenegraph.h"
+#include <algorithm>
 
-constexpr uint32_t SceneGraphVersion = 0;
+constexpr uint32_t SceneGraphNodeVersion = 0;
+
+// 0: Every node, each with its own serializable header
+// 1: Only nodes that are in use, with their entity ID
+constexpr uint32_t SceneGraphVersion = 1;
 
 Ether::SceneGraphNode::SceneGraphNode()
-    : Serializable(SceneGraphVersion, "Engine::SceneGraphNode")
+    : Serializable(SceneGraphNodeVersion, "Engine::SceneGraphNode")
     , m_ParentIndex(InvalidEntityID)
     , m_IsRegistered(false)
 {
@@ -49,6 +54,7 @@ void Ether::SceneGraphNode::Deserialize(IStream& istream)
 
     uint32_t numIndices;
     istream >> numIndices;
+    m_ChildrenIndices.resize(numIndices);
 
     for (int i = 0; i < numIndices; ++i)
         istream >> m_ChildrenIndices[i];
@@ -65,30 +71,81 @@ void Ether::SceneGraph::Serialize(OStream& ostream) const
 {
     Serializable::Serialize(ostream);
 
-    for (int i = 0; i < Ecs::MaxNumEntities; ++i)
-        m_Nodes[i].Serialize(ostream);
+    uint32_t numNodes = 0;
+    for (Ecs::EntityID id = 0; id < Ecs::MaxNumEntities; ++id)
+        numNodes += IsNodeInUse(id) ? 1 : 0;
+
+    ostream << numNodes;
+    for (Ecs::EntityID id = 0; id < Ecs::MaxNumEntities; ++id)
+    {
+        if (!IsNodeInUse(id))
+            continue;
+
+        const SceneGraphNode& node = m_Nodes[id];
+        ostream << id;
+        ostream << node.m_ParentIndex;
+        ostream << node.m_IsRegistered;
+        ostream << static_cast<uint32_t>(node.m_ChildrenIndices.size());
+
+        for (Ecs::EntityID childIdx : node.m_ChildrenIndices)
+            ostream << childIdx;
+    }
 }
 
 void Ether::SceneGraph::Deserialize(IStream& istream)
 {
-    Serializable::Deserialize(istream);
+    const uint32_t version = DeserializeVersioned(istream, 0);
 
-    for (int i = 0; i < Ecs::MaxNumEntities; ++i)
-        m_Nodes[i].Deserialize(istream);
-}
+    for (Ecs::EntityID id = 0; id < Ecs::MaxNumEntities; ++id)
+    {
+        m_Nodes[id].m_ParentIndex = InvalidEntityID;
+        m_Nodes[id].m_IsRegistered = false;
+        m_Nodes[id].m_ChildrenIndices.clear();
+    }
 
-void Ether::SceneGraph::SetParent(Ecs::EntityID id, Ecs::EntityID parent)
-{
-    if (m_Nodes[id].m_ParentIndex != RootEntityID)
+    if (version == 0)
     {
-        SceneGraphNode oldParent = m_Nodes[m_Nodes[id].m_ParentIndex];
+        for (int i = 0; i < Ecs::LegacyNumEntities; ++i)
+            m_Nodes[i].Deserialize(istream);
 
-        oldParent.m_ChildrenIndices.erase(
-            std::remove(oldParent.m_ChildrenIndices.begin(), oldParent.m_ChildrenIndices.end(), id),
-            oldParent.m_ChildrenIndices.end());
+        return;
     }
 
+    uint32_t numNodes;
+    istream >> numNodes;
+
+    for (uint32_t i = 0; i < numNodes; ++i)
+    {
+        Ecs::EntityID id;
+        istream >> id;
+
+        if (id >= Ecs::MaxNumEntities)
+            throw std::runtime_error("Scene graph node is out of range");
+
+        SceneGraphNode& node = m_Nodes[id];
+        istream >> node.m_ParentIndex;
+        istream >> node.m_IsRegistered;
+
+        uint32_t numChildren;
+        istream >> numChildren;
+        node.m_ChildrenIndices.resize(numChildren);
+
+        for (uint32_t j = 0; j < numChildren; ++j)
+            istream >> node.m_ChildrenIndices[j];
+    }
+}
+
+bool Ether::SceneGraph::IsNodeInUse(Ecs::EntityID id) const
+{
+    const SceneGraphNode& node = m_Nodes[id];
+    return node.m_IsRegistered || node.m_ParentIndex != InvalidEntityID || !node.m_ChildrenIndices.empty();
+}
+
+void Ether::SceneGraph::SetParent(Ecs::EntityID id, Ecs::EntityID parent)
+{
+    RemoveFromParent(id);
     m_Nodes[id].m_ParentIndex = parent;
+    m_Nodes[parent].m_ChildrenIndices.push_back(id);
 }
 
 void Ether::SceneGraph::Register(Ecs::EntityID id, Ecs::EntityID parent)
@@ -103,10 +160,25 @@ void Ether::SceneGraph::Deregister(Ecs::EntityID id)
 {
     AssertEngine(m_Nodes[id].m_IsRegistered, "EntityID was never registered to the scene graph");
     m_Nodes[id].m_IsRegistered = false;
-    SetParent(id, RootEntityID);
+    RemoveFromParent(id);
+    m_Nodes[id].m_ParentIndex = InvalidEntityID;
 
+    // Orphans are moved up to the root, like entities that were registered without a parent
     for (Ecs::EntityID childIdx : m_Nodes[id].m_ChildrenIndices)
+    {
         m_Nodes[childIdx].m_ParentIndex = RootEntityID;
+        m_Nodes[RootEntityID].m_ChildrenIndices.push_back(childIdx);
+    }
 
     m_Nodes[id].m_ChildrenIndices.clear();
 }
+
+void Ether::SceneGraph::RemoveFromParent(Ecs::EntityID id)
+{
+    const Ecs::EntityID parent = m_Nodes[id].m_ParentIndex;
+    if (parent == InvalidEntityID)
+        return;
+
+    std::vector<Ecs::EntityID>& siblings = m_Nodes[parent].m_ChildrenIndices;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), id), siblings.end());
+}
@@ -56,6 +56,7 @@ public:
     void Deserialize(IStream& istream) override;
 
 public:
+    inline bool IsRegistered(Ecs::EntityID id) const { return m_Nodes[id].m_IsRegistered; }
     inline Ecs::EntityID GetParent(Ecs::EntityID id) const { return m_Nodes[id].m_ParentIndex; }
     inline Ecs::EntityID GetFirstChild(Ecs::EntityID id) const { return m_Nodes[id].m_ChildrenIndices.front(); }
     inline Ecs::EntityID GetLastChild(Ecs::EntityID id) const { return m_Nodes[id].m_ChildrenIndices.back(); }
@@ -68,6 +69,11 @@ public:
     void Deregister(Ecs::EntityID id);
     void SetParent(Ecs::EntityID id, Ecs::EntityID parent);
 
+private:
+    // Nodes that differ from a default constructed one are the only ones that are saved
+    bool IsNodeInUse(Ecs::EntityID id) const;
+    void RemoveFromParent(Ecs::EntityID id);
+
 private:
     SceneGraphNode m_Nodes[Ecs::MaxNumEntities];
 };
@@ -0,0 +1,351 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/world/streaming/streamingworldformat.h"
+#include "engine/world/world.h"
+#include "engine/world/ecs/components/ecsmetadatacomponent.h"
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+// 0: Initial layout
+// 1: Resources store the size of their tail
+constexpr uint32_t StreamingWorldIndexVersion = 1;
+constexpr uint32_t StreamingWorldFooterSize = 3 * sizeof(uint32_t);
+
+// The streams have no 64 bit overloads (long is 32 bit on Windows), so offsets are split in two
+static void WriteOffset(Ether::OStream& ostream, uint64_t offset)
+{
+    ostream << static_cast<uint32_t>(offset & 0xffffffff);
+    ostream << static_cast<uint32_t>(offset >> 32);
+}
+
+static uint64_t ReadOffset(Ether::IStream& istream)
+{
+    uint32_t low, high;
+    istream >> low;
+    istream >> high;
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+Ether::StreamingWorldIndex::StreamingWorldIndex()
+    : Serializable(StreamingWorldIndexVersion, "Engine::StreamingWorldIndex")
+    , m_CellSize(64.0f)
+    , m_PersistentOffset(0)
+    , m_PersistentSize(0)
+    , m_MainCameraIdx(~0u)
+{
+}
+
+void Ether::StreamingWorldIndex::Serialize(OStream& ostream) const
+{
+    Serializable::Serialize(ostream);
+    ostream << m_WorldName;
+    ostream << m_CellSize;
+
+    ostream << static_cast<uint32_t>(m_Components.size());
+    for (const StreamedComponentDesc& component : m_Components)
+    {
+        ostream << component.m_Name;
+        ostream << component.m_Version;
+    }
+
+    ostream << static_cast<uint32_t>(m_Materials.size());
+    for (const auto& material : m_Materials)
+        material->Serialize(ostream);
+
+    ostream << static_cast<uint32_t>(m_Resources.size());
+    for (const StreamedResourceDesc& resource : m_Resources)
+    {
+        ostream << resource.m_Guid;
+        ostream << static_cast<uint32_t>(resource.m_Type);
+        WriteOffset(ostream, resource.m_Offset);
+        ostream << resource.m_Size;
+        ostream << resource.m_TailSize;
+    }
+
+    ostream << static_cast<uint32_t>(m_Cells.size());
+    for (const StreamedCellDesc& cell : m_Cells)
+    {
+        ostream << cell.m_X;
+        ostream << cell.m_Z;
+        WriteOffset(ostream, cell.m_Offset);
+        ostream << cell.m_Size;
+        ostream << cell.m_NumEntities;
+        ostream << static_cast<uint32_t>(cell.m_Resources.size());
+        for (uint32_t resourceIdx : cell.m_Resources)
+            ostream << resourceIdx;
+    }
+
+    WriteOffset(ostream, m_PersistentOffset);
+    ostream << m_PersistentSize;
+    ostream << m_MainCameraIdx;
+}
+
+void Ether::StreamingWorldIndex::Deserialize(IStream& istream)
+{
+    const uint32_t version = DeserializeVersioned(istream, 0);
+    istream >> m_WorldName;
+    istream >> m_CellSize;
+
+    if (!(m_CellSize > 0.0f))
+        throw std::runtime_error("Streaming world has an invalid cell size");
+
+    uint32_t numComponents;
+    istream >> numComponents;
+    if (numComponents > Ecs::MaxNumComponents)
+        throw std::runtime_error("Streaming world has too many component types");
+
+    m_Components.resize(numComponents);
+    for (StreamedComponentDesc& component : m_Components)
+    {
+        istream >> component.m_Name;
+        istream >> component.m_Version;
+    }
+
+    uint32_t numMaterials;
+    istream >> numMaterials;
+    m_Materials.clear();
+    for (uint32_t i = 0; i < numMaterials; ++i)
+    {
+        std::unique_ptr<Graphics::Material> material = std::make_unique<Graphics::Material>();
+        material->Deserialize(istream);
+        m_Materials.push_back(std::move(material));
+    }
+
+    uint32_t numResources;
+    istream >> numResources;
+    m_Resources.resize(numResources);
+    for (StreamedResourceDesc& resource : m_Resources)
+    {
+        uint32_t type;
+        istream >> resource.m_Guid;
+        istream >> type;
+        resource.m_Offset = ReadOffset(istream);
+        istream >> resource.m_Size;
+
+        // Older worlds have to assume that textures are loaded whole
+        if (version >= 1)
+            istream >> resource.m_TailSize;
+        else
+            resource.m_TailSize = resource.m_Size;
+
+        if (type > static_cast<uint32_t>(StreamedResourceType::Texture))
+            throw std::runtime_error(std::format("Streamed resource has an unknown type {}", type));
+
+        resource.m_Type = static_cast<StreamedResourceType>(type);
+    }
+
+    uint32_t numCells;
+    istream >> numCells;
+    m_Cells.resize(numCells);
+    for (StreamedCellDesc& cell : m_Cells)
+    {
+        uint32_t numCellResources;
+        istream >> cell.m_X;
+        istream >> cell.m_Z;
+        cell.m_Offset = ReadOffset(istream);
+        istream >> cell.m_Size;
+        istream >> cell.m_NumEntities;
+        istream >> numCellResources;
+
+        cell.m_Resources.resize(numCellResources);
+        for (uint32_t& resourceIdx : cell.m_Resources)
+        {
+            istream >> resourceIdx;
+            if (resourceIdx >= numResources)
+                throw std::runtime_error("Streamed cell references a resource that does not exist");
+        }
+    }
+
+    m_PersistentOffset = ReadOffset(istream);
+    istream >> m_PersistentSize;
+    istream >> m_MainCameraIdx;
+}
+
+std::unique_ptr<Ether::StreamingWorldIndex> Ether::StreamingWorldIndex::Read(IFileStream& file)
+{
+    if (!file.IsOpen())
+        throw std::runtime_error("Failed to open the streaming world");
+
+    if (file.GetFileSize() < StreamingWorldFooterSize)
+        throw std::runtime_error("File is too small to be a streaming world");
+
+    file.Seek(file.GetFileSize() - StreamingWorldFooterSize);
+    const uint64_t indexOffset = ReadOffset(file);
+    uint32_t magic;
+    file >> magic;
+
+    if (magic != StreamingWorldMagic)
+        throw std::runtime_error("File is not a streaming world");
+
+    if (indexOffset >= file.GetFileSize() - StreamingWorldFooterSize)
+        throw std::runtime_error("Streaming world index is out of range");
+
+    // Read as a whole, so that a truncated index fails with an error rather than garbage
+    file.Seek(indexOffset);
+    IByteStream istream(file, file.GetFileSize() - StreamingWorldFooterSize - indexOffset);
+    if (!istream.IsOpen())
+        throw std::runtime_error("Failed to read the streaming world index");
+
+    std::unique_ptr<StreamingWorldIndex> index = std::make_unique<StreamingWorldIndex>();
+    index->Deserialize(istream);
+    return index;
+}
+
+void Ether::StreamingWorldIndex::Write(OFileStream& file) const
+{
+    const uint64_t indexOffset = file.GetPosition();
+    Serialize(file);
+    WriteOffset(file, indexOffset);
+    file << StreamingWorldMagic;
+}
+
+int32_t Ether::StreamingWorldIndex::GetCellCoordinate(float position, float cellSize)
+{
+    // Clamped, so that positions far outside of the world (or a huge radius around them) do not overflow
+    const float coordinate = std::floor(position / cellSize);
+    return static_cast<int32_t>(std::clamp(coordinate, -static_cast<float>(1 << 30), static_cast<float>(1 << 30)));
+}
+
+Ether::StreamedEntityCodec::StreamedEntityCodec(World& world)
+    : m_World(world)
+{
+    Ecs::EcsComponentManager& componentManager = world.GetEcsManager().GetComponentManager();
+    for (Ecs::ComponentID id = 0; id < componentManager.GetNumComponentTypes(); ++id)
+    {
+        m_ComponentIDs.push_back(id);
+        m_Versions.push_back(componentManager.GetComponentArray(id).GetComponentVersion());
+    }
+}
+
+Ether::StreamedEntityCodec::StreamedEntityCodec(World& world, const std::vector<StreamedComponentDesc>& components)
+    : m_World(world)
+{
+    Ecs::EcsComponentManager& componentManager = world.GetEcsManager().GetComponentManager();
+
+    for (const StreamedComponentDesc& component : components)
+    {
+        bool isFound = false;
+        for (Ecs::ComponentID id = 0; id < componentManager.GetNumComponentTypes(); ++id)
+        {
+            const Ecs::EcsComponentArrayBase& array = componentManager.GetComponentArray(id);
+            if (component.m_Name != array.GetComponentInfo().m_Name)
+                continue;
+
+            if (component.m_Version > array.GetComponentVersion())
+                throw std::runtime_error(std::format("{} components of version {} are newer than this build", component.m_Name, component.m_Version));
+
+            m_ComponentIDs.push_back(id);
+            m_Versions.push_back(component.m_Version);
+            isFound = true;
+            break;
+        }
+
+        if (!isFound)
+            throw std::runtime_error(std::format("Streaming world uses an unknown component type {}", component.m_Name));
+    }
+}
+
+std::vector<Ether::StreamedComponentDesc> Ether::StreamedEntityCodec::GetComponentTable() const
+{
+    Ecs::EcsComponentManager& componentManager = m_World.GetEcsManager().GetComponentManager();
+
+    std::vector<StreamedComponentDesc> components;
+    for (uint32_t i = 0; i < m_ComponentIDs.size(); ++i)
+        components.push_back({ componentManager.GetComponentArray(m_ComponentIDs[i]).GetComponentInfo().m_Name, m_Versions[i] });
+
+    return components;
+}
+
+void Ether::StreamedEntityCodec::Write(OStream& ostream, Ecs::EntityID entityID, uint32_t parentIdx)
+{
+    Ecs::EcsComponentManager& componentManager = m_World.GetEcsManager().GetComponentManager();
+
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < m_ComponentIDs.size(); ++i)
+        if (componentManager.GetComponentArray(m_ComponentIDs[i]).GetComponentData(entityID) != nullptr)
+            mask |= 1u << i;
+
+    ostream << parentIdx;
+    ostream << mask;
+
+    for (uint32_t i = 0; i < m_ComponentIDs.size(); ++i)
+    {
+        Ecs::EcsComponentArrayBase& array = componentManager.GetComponentArray(m_ComponentIDs[i]);
+        if ((mask & (1u << i)) != 0)
+            Ecs::SerializeEcsFields(ostream, array.GetComponentInfo(), array.GetComponentData(entityID));
+    }
+}
+
+Ether::Ecs::EntityID Ether::StreamedEntityCodec::Read(IStream& istream, const std::vector<Ecs::EntityID>& persistentEntities)
+{
+    uint32_t parentIdx, mask;
+    istream >> parentIdx;
+    istream >> mask;
+
+    if (m_ComponentIDs.size() < 32 && (mask >> m_ComponentIDs.size()) != 0)
+        throw std::runtime_error("Streamed entity has a component that is not in the component table");
+
+    if (parentIdx < ParentIsRoot && parentIdx >= persistentEntities.size())
+        throw std::runtime_error("Streamed entity has a parent that does not exist");
+
+    Ecs::EcsManager& ecsManager = m_World.GetEcsManager();
+    const Ecs::EntityID entityID = m_World.CreateEntity("").GetID();
+    Ecs::EntitySignature signature = ecsManager.GetEntityManager().GetSignature(entityID);
+
+    try
+    {
+        for (uint32_t i = 0; i < m_ComponentIDs.size(); ++i)
+        {
+            if ((mask & (1u << i)) == 0)
+                continue;
+
+            Ecs::EcsComponentArrayBase& array = ecsManager.GetComponentManager().GetComponentArray(m_ComponentIDs[i]);
+            if (array.GetComponentData(entityID) == nullptr)
+            {
+                array.AddComponent(entityID);
+                signature.set(m_ComponentIDs[i]);
+            }
+
+            Ecs::DeserializeEcsFields(istream, array.GetComponentInfo(), array.GetComponentData(entityID), m_Versions[i]);
+        }
+    }
+    catch (...)
+    {
+        // Components that were added above are not in the signature yet, but are removed all the same
+        m_World.DestroyEntity(entityID);
+        throw;
+    }
+
+    // The ID the entity was saved with means nothing here
+    m_World.GetEntity(entityID).GetComponent<Ecs::EcsMetadataComponent>().m_EntityID = entityID;
+
+    ecsManager.GetEntityManager().SetSignature(entityID, signature);
+    ecsManager.GetSystemManager().UpdateEntitySignature(entityID, signature);
+
+    // The root node is always registered, and is saved without a parent
+    if (entityID == RootEntityID || parentIdx == NotInSceneGraph)
+        return entityID;
+
+    const Ecs::EntityID parent = parentIdx == ParentIsRoot ? RootEntityID : persistentEntities[parentIdx];
+    m_World.GetSceneGraph().Register(entityID, parent);
+
+    return entityID;
+}
@@ -0,0 +1,141 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "engine/pch.h"
+#include "engine/world/ecs/ecstypes.h"
+#include "graphics/resources/material.h"
+
+namespace Ether
+{
+class World;
+
+// Written at the very end of a streaming world file, after the offset of the index
+constexpr uint32_t StreamingWorldMagic = 0x57545345; // "ESTW"
+
+enum class StreamedResourceType : uint32_t
+{
+    Mesh,
+    Texture,
+};
+
+struct StreamedResourceDesc
+{
+    StringID m_Guid;
+    StreamedResourceType m_Type;
+    uint64_t m_Offset;
+    // Serialized size, which doubles as the estimate of the memory the resource takes up once resident
+    uint32_t m_Size;
+    // Of the mips that are loaded with a texture whose other mips are streamed (see Texture::IsStreamable()),
+    // the same as m_Size for meshes
+    uint32_t m_TailSize;
+};
+
+struct StreamedCellDesc
+{
+    int32_t m_X;
+    int32_t m_Z;
+    uint64_t m_Offset;
+    uint32_t m_Size;
+    uint32_t m_NumEntities;
+    // Indices into the resource table, for every mesh and texture that the cell's visuals use
+    std::vector<uint32_t> m_Resources;
+};
+
+struct StreamedComponentDesc
+{
+    std::string m_Name;
+    uint32_t m_Version;
+};
+
+/*
+    Table of contents of a streaming world (see World::SaveStreamed()). The file is laid out as
+
+        persistent entities | resources | cells | index | index offset (2x u32) | magic
+
+    Entities with a visual component are assigned to a square cell of m_CellSize units on the XZ
+    plane, by their translation. Everything else (the scene graph groups, the camera, ...) is
+    persistent and loaded together with the index. Materials are small, and visual batches hold on
+    to them, so they are stored in the index and stay resident too. Meshes and textures are stored
+    once each, and are referenced by every cell that needs them.
+*/
+class StreamingWorldIndex : public Serializable
+{
+public:
+    StreamingWorldIndex();
+    ~StreamingWorldIndex() override = default;
+
+public:
+    void Serialize(OStream& ostream) const override;
+    void Deserialize(IStream& istream) override;
+
+public:
+    // Reads the index through the footer at the end of the file
+    static std::unique_ptr<StreamingWorldIndex> Read(IFileStream& file);
+    void Write(OFileStream& file) const;
+
+    static int32_t GetCellCoordinate(float position, float cellSize);
+
+public:
+    std::string m_WorldName;
+    float m_CellSize;
+
+    std::vector<StreamedComponentDesc> m_Components;
+    std::vector<std::unique_ptr<Graphics::Material>> m_Materials;
+    std::vector<StreamedResourceDesc> m_Resources;
+    std::vector<StreamedCellDesc> m_Cells;
+
+    uint64_t m_PersistentOffset;
+    uint32_t m_PersistentSize;
+    // Index into the persistent entities, or ~0 if the world has no camera
+    uint32_t m_MainCameraIdx;
+};
+
+/*
+    Writes and reads single entities of a streaming world. An entity is stored as its place in the
+    scene graph, a mask of its components (indices into the world's component table, which maps
+    them onto the runtime types by name) and the reflected fields of each of them.
+*/
+class StreamedEntityCodec
+{
+public:
+    // Every entity is written with all of the runtime's components, in registration order
+    StreamedEntityCodec(World& world);
+    // Throws if the table has components this build does not know, or newer versions of them
+    StreamedEntityCodec(World& world, const std::vector<StreamedComponentDesc>& components);
+    ~StreamedEntityCodec() = default;
+
+public:
+    static constexpr uint32_t NotInSceneGraph = ~0u;
+    static constexpr uint32_t ParentIsRoot = ~0u - 1;
+
+    std::vector<StreamedComponentDesc> GetComponentTable() const;
+
+    // parentIdx is an index into the persistent entities, or one of the values above
+    void Write(OStream& ostream, Ecs::EntityID entityID, uint32_t parentIdx);
+    // Creates the entity in the world. persistentEntities maps the parent index to an entity.
+    Ecs::EntityID Read(IStream& istream, const std::vector<Ecs::EntityID>& persistentEntities);
+
+private:
+    World& m_World;
+    std::vector<Ecs::ComponentID> m_ComponentIDs;
+    std::vector<uint32_t> m_Versions;
+};
+} // namespace Ether
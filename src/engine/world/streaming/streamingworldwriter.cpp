@@ -0,0 +1,232 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/world/streaming/streamingworldwriter.h"
+#include "engine/world/world.h"
+#include "engine/world/ecs/components/ecstransformcomponent.h"
+#include "engine/world/ecs/components/ecsvisualcomponent.h"
+#include <algorithm>
+#include <map>
+
+Ether::StreamingWorldWriter::StreamingWorldWriter(World& world, float cellSize)
+    : m_World(world)
+    , m_Codec(world)
+{
+    m_Index.m_WorldName = world.GetWorldName();
+    m_Index.m_CellSize = cellSize;
+    m_Index.m_Components = m_Codec.GetComponentTable();
+}
+
+void Ether::StreamingWorldWriter::Write(const std::string& path)
+{
+    GatherEntities();
+    GatherResources();
+
+    OFileStream file(path);
+    file.ClearFile();
+
+    m_Index.m_PersistentOffset = file.GetPosition();
+    file << static_cast<uint32_t>(m_PersistentEntities.size());
+    for (Ecs::EntityID entityID : m_PersistentEntities)
+        m_Codec.Write(file, entityID, GetParentIdx(entityID));
+    m_Index.m_PersistentSize = static_cast<uint32_t>(file.GetPosition() - m_Index.m_PersistentOffset);
+
+    ResourceManager& resourceManager = m_World.GetResourceManager();
+    for (StreamedResourceDesc& resource : m_Index.m_Resources)
+    {
+        resource.m_Offset = file.GetPosition();
+        if (resource.m_Type == StreamedResourceType::Mesh)
+            resourceManager.GetMeshResource(resource.m_Guid)->Serialize(file);
+        else
+            resourceManager.GetTextureResource(resource.m_Guid)->Serialize(file);
+        resource.m_Size = static_cast<uint32_t>(file.GetPosition() - resource.m_Offset);
+        resource.m_TailSize = resource.m_Size;
+
+        if (resource.m_Type == StreamedResourceType::Texture)
+        {
+            const Graphics::Texture& texture = *resourceManager.GetTextureResource(resource.m_Guid);
+            size_t tailSize = 0;
+            for (uint32_t i = texture.GetFirstTailMip(); i < texture.GetNumMips(); ++i)
+                tailSize += texture.GetSizeInBytes(i);
+
+            resource.m_TailSize = static_cast<uint32_t>(tailSize);
+        }
+    }
+
+    for (uint32_t i = 0; i < m_Index.m_Cells.size(); ++i)
+    {
+        StreamedCellDesc& cell = m_Index.m_Cells[i];
+        cell.m_Offset = file.GetPosition();
+        file << static_cast<uint32_t>(m_CellEntities[i].size());
+        for (Ecs::EntityID entityID : m_CellEntities[i])
+            m_Codec.Write(file, entityID, GetParentIdx(entityID));
+        cell.m_Size = static_cast<uint32_t>(file.GetPosition() - cell.m_Offset);
+    }
+
+    if (m_World.GetMainCamera() != nullptr)
+        m_Index.m_MainCameraIdx = m_PersistentEntityToIdx.at(m_World.GetMainCamera()->GetID());
+
+    m_Index.Write(file);
+
+    LogEngineInfo(
+        "Saved streaming world %s: %zu persistent entities, %zu cells of %.1f units and %zu resources",
+        path.c_str(),
+        m_PersistentEntities.size(),
+        m_Index.m_Cells.size(),
+        m_Index.m_CellSize,
+        m_Index.m_Resources.size());
+}
+
+void Ether::StreamingWorldWriter::GatherEntities()
+{
+    Ecs::EcsComponentManager& componentManager = m_World.GetEcsManager().GetComponentManager();
+    Ecs::EcsComponentArrayBase& visuals = componentManager.GetComponentArray(Ecs::EcsVisualComponent::s_ComponentID);
+    SceneGraph& sceneGraph = m_World.GetSceneGraph();
+
+    // Sorted, so that the same world is always written the same way
+    std::vector<Ecs::EntityID> entities;
+    for (auto& pair : m_World.m_Entities)
+        entities.push_back(pair.first);
+    std::sort(entities.begin(), entities.end());
+
+    std::map<std::pair<int32_t, int32_t>, std::vector<Ecs::EntityID>> cells;
+    std::vector<bool> isPersistent(Ecs::MaxNumEntities, false);
+
+    for (Ecs::EntityID entityID : entities)
+    {
+        if (visuals.GetComponentData(entityID) == nullptr)
+        {
+            isPersistent[entityID] = true;
+            continue;
+        }
+
+        const ethVector3 position = m_World.GetEntity(entityID).GetComponent<Ecs::EcsTransformComponent>().m_Translation;
+        const int32_t x = StreamingWorldIndex::GetCellCoordinate(position.x, m_Index.m_CellSize);
+        const int32_t z = StreamingWorldIndex::GetCellCoordinate(position.z, m_Index.m_CellSize);
+        cells[{ z, x }].push_back(entityID);
+    }
+
+    // Breadth first through the scene graph, so that persistent parents are read before their children
+    std::vector<Ecs::EntityID> queue = { RootEntityID };
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        if (isPersistent[queue[i]])
+        {
+            m_PersistentEntityToIdx[queue[i]] = static_cast<uint32_t>(m_PersistentEntities.size());
+            m_PersistentEntities.push_back(queue[i]);
+        }
+
+        for (Ecs::EntityID childID : sceneGraph.GetChildren(queue[i]))
+            queue.push_back(childID);
+    }
+
+    // Entities that are not in the scene graph (e.g. the camera)
+    for (Ecs::EntityID entityID : entities)
+    {
+        if (!isPersistent[entityID] || m_PersistentEntityToIdx.contains(entityID))
+            continue;
+
+        m_PersistentEntityToIdx[entityID] = static_cast<uint32_t>(m_PersistentEntities.size());
+        m_PersistentEntities.push_back(entityID);
+    }
+
+    for (auto& pair : cells)
+    {
+        StreamedCellDesc cell = {};
+        cell.m_X = pair.first.second;
+        cell.m_Z = pair.first.first;
+        cell.m_NumEntities = static_cast<uint32_t>(pair.second.size());
+        m_Index.m_Cells.push_back(cell);
+        m_CellEntities.push_back(std::move(pair.second));
+    }
+}
+
+void Ether::StreamingWorldWriter::GatherResources()
+{
+    ResourceManager& resourceManager = m_World.GetResourceManager();
+
+    for (auto& pair : resourceManager.m_Materials)
+        m_Index.m_Materials.push_back(std::make_unique<Graphics::Material>(*pair.second));
+
+    for (uint32_t i = 0; i < m_Index.m_Cells.size(); ++i)
+    {
+        std::vector<uint32_t>& cellResources = m_Index.m_Cells[i].m_Resources;
+
+        for (Ecs::EntityID entityID : m_CellEntities[i])
+        {
+            const Ecs::EcsVisualComponent& visual = m_World.GetEntity(entityID).GetComponent<Ecs::EcsVisualComponent>();
+
+            std::vector<uint32_t> resources;
+            if (resourceManager.GetMeshResource(visual.m_MeshGuid) != nullptr)
+                resources.push_back(AddResource(visual.m_MeshGuid, StreamedResourceType::Mesh));
+
+            const Graphics::Material* material = resourceManager.GetMaterialResource(visual.m_MaterialGuid);
+            if (material != nullptr)
+            {
+                const StringID textures[] = {
+                    material->GetAlbedoTextureID(),
+                    material->GetNormalTextureID(),
+                    material->GetRoughnessTextureID(),
+                    material->GetMetalnessTextureID(),
+                    material->GetEmissiveTextureID(),
+                };
+
+                for (const StringID& textureGuid : textures)
+                    if (resourceManager.GetTextureResource(textureGuid) != nullptr)
+                        resources.push_back(AddResource(textureGuid, StreamedResourceType::Texture));
+            }
+
+            for (uint32_t resourceIdx : resources)
+                if (std::find(cellResources.begin(), cellResources.end(), resourceIdx) == cellResources.end())
+                    cellResources.push_back(resourceIdx);
+        }
+    }
+}
+
+uint32_t Ether::StreamingWorldWriter::GetParentIdx(Ecs::EntityID entityID) const
+{
+    const SceneGraph& sceneGraph = m_World.GetSceneGraph();
+
+    if (entityID == RootEntityID || !sceneGraph.IsRegistered(entityID))
+        return StreamedEntityCodec::NotInSceneGraph;
+
+    // Parents that are visuals live in some other cell, and may not be loaded at the same time
+    const auto iter = m_PersistentEntityToIdx.find(sceneGraph.GetParent(entityID));
+    if (sceneGraph.GetParent(entityID) == RootEntityID || iter == m_PersistentEntityToIdx.end())
+        return StreamedEntityCodec::ParentIsRoot;
+
+    // Nodes that were cut off from the root are read in entity order, their parent may come later
+    const auto selfIter = m_PersistentEntityToIdx.find(entityID);
+    if (selfIter != m_PersistentEntityToIdx.end() && iter->second >= selfIter->second)
+        return StreamedEntityCodec::ParentIsRoot;
+
+    return iter->second;
+}
+
+uint32_t Ether::StreamingWorldWriter::AddResource(StringID guid, StreamedResourceType type)
+{
+    const auto iter = m_ResourceToIdx.find(guid);
+    if (iter != m_ResourceToIdx.end())
+        return iter->second;
+
+    const uint32_t resourceIdx = static_cast<uint32_t>(m_Index.m_Resources.size());
+    m_Index.m_Resources.push_back({ guid, type, 0, 0, 0 });
+    m_ResourceToIdx[guid] = resourceIdx;
+    return resourceIdx;
+}
@@ -0,0 +1,59 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "engine/pch.h"
+#include "engine/world/streaming/streamingworldformat.h"
+
+namespace Ether
+{
+/*
+    Splits a world into the cells of a streaming world (see StreamingWorldIndex). Visuals that are
+    children of other visuals end up in cells of their own, so they are flattened to the root.
+    Meshes and textures that no visual uses are left out.
+*/
+class StreamingWorldWriter : public NonCopyable, public NonMovable
+{
+public:
+    StreamingWorldWriter(World& world, float cellSize);
+    ~StreamingWorldWriter() = default;
+
+public:
+    void Write(const std::string& path);
+
+private:
+    void GatherEntities();
+    void GatherResources();
+    uint32_t GetParentIdx(Ecs::EntityID entityID) const;
+    uint32_t AddResource(StringID guid, StreamedResourceType type);
+
+private:
+    World& m_World;
+    StreamedEntityCodec m_Codec;
+    StreamingWorldIndex m_Index;
+
+    // Parents always come before their children
+    std::vector<Ecs::EntityID> m_PersistentEntities;
+    std::unordered_map<Ecs::EntityID, uint32_t> m_PersistentEntityToIdx;
+
+    std::vector<std::vector<Ecs::EntityID>> m_CellEntities;
+    std::unordered_map<StringID, uint32_t> m_ResourceToIdx;
+};
+} // namespace Ether
@@ -0,0 +1,330 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/world/streaming/texturestreamer.h"
+#include "engine/world/world.h"
+#include "graphics/graphiccore.h"
+#include "common/memory/memorytracker.h"
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+Ether::TextureStreamer::TextureStreamer(World& world, size_t budget)
+    : m_World(world)
+    , m_Policy(budget, MaxPendingLoads)
+    , m_FrameIndex(0)
+    , m_ReleasingMemory(0)
+    , m_IsStopping(false)
+    , m_Stats()
+{
+    m_LoaderThread = std::thread(&TextureStreamer::LoaderThread, this);
+}
+
+Ether::TextureStreamer::~TextureStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_IsStopping = true;
+    }
+
+    m_RequestCondition.notify_all();
+    m_LoaderThread.join();
+
+    for (LoadJob& job : m_CompletedLoads)
+        MemoryTracker::Free(job.m_Data);
+
+    // Textures keep the mips that they have, only the replaced resources are left to release
+    for (PendingRelease& release : m_PendingReleases)
+        Graphics::GraphicCore::QueueRenderWork([resource = std::move(release.m_Resource)]() {});
+}
+
+void Ether::TextureStreamer::Update()
+{
+    ETH_MARKER_EVENT("Texture Streamer - Update");
+
+    m_FrameIndex++;
+    ProcessCompletedLoads();
+    ReleaseRetiredResources();
+
+    m_Loads.clear();
+    m_Evictions.clear();
+    m_Policy.Update(m_ReleasingMemory, m_Loads, m_Evictions);
+
+    for (const Graphics::TextureMipEviction& eviction : m_Evictions)
+    {
+        const size_t oldSize = m_Policy.GetResidentSize(eviction.m_Handle) + eviction.m_Size;
+        SetResidentMip(eviction.m_Handle, eviction.m_ResidentMip, nullptr, oldSize);
+        m_Stats.m_NumEvictions++;
+    }
+
+    if (!m_Loads.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const Graphics::TextureMipLoad& load : m_Loads)
+        {
+            const StreamedTexture& streamedTexture = m_StreamedTextures[load.m_Handle];
+
+            LoadJob job;
+            job.m_Handle = load.m_Handle;
+            job.m_Generation = streamedTexture.m_Generation;
+            job.m_MipLevel = load.m_MipLevel;
+            job.m_Path = streamedTexture.m_Texture->GetFilePath();
+            job.m_Offset = streamedTexture.m_Texture->GetMipFileOffset(load.m_MipLevel);
+            job.m_Size = streamedTexture.m_Texture->GetSizeInBytes(load.m_MipLevel);
+            m_Requests.push_back(std::move(job));
+        }
+    }
+
+    m_RequestCondition.notify_one();
+    UpdateStats();
+}
+
+void Ether::TextureStreamer::RequestMaterial(const Graphics::Material& material, float footprint)
+{
+    ResourceManager& resourceManager = m_World.GetResourceManager();
+    const StringID materialGuid = material.GetGuid();
+    const StringID textures[] = {
+        material.GetAlbedoTextureID(),
+        material.GetNormalTextureID(),
+        material.GetRoughnessTextureID(),
+        material.GetMetalnessTextureID(),
+        material.GetEmissiveTextureID(),
+    };
+
+    for (const StringID& textureGuid : textures)
+    {
+        Graphics::Texture* texture = resourceManager.GetTextureResource(textureGuid);
+        if (texture == nullptr || !texture->IsStreamable())
+            continue;
+
+        const uint32_t handle = GetOrAddTexture(*texture);
+        std::vector<StringID>& materials = m_StreamedTextures[handle].m_Materials;
+        if (std::find(materials.begin(), materials.end(), materialGuid) == materials.end())
+            materials.push_back(materialGuid);
+
+        const uint32_t textureSize = (std::max)(texture->GetWidth(), texture->GetHeight());
+        m_Policy.RequestMip(handle, GetMipForFootprint(textureSize, footprint));
+    }
+}
+
+void Ether::TextureStreamer::RemoveTexture(const Graphics::Texture& texture)
+{
+    const auto iter = m_TextureToHandle.find(&texture);
+    if (iter == m_TextureToHandle.end())
+        return;
+
+    const uint32_t handle = iter->second;
+    m_TextureToHandle.erase(iter);
+    m_Policy.RemoveTexture(handle);
+
+    StreamedTexture& streamedTexture = m_StreamedTextures[handle];
+    streamedTexture.m_Texture = nullptr;
+    streamedTexture.m_Generation++;
+    streamedTexture.m_Materials.clear();
+
+    // A load that is being read is dropped when it arrives
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    const auto isRemoved = [handle](const LoadJob& job) { return job.m_Handle == handle; };
+    m_Requests.erase(std::remove_if(m_Requests.begin(), m_Requests.end(), isRemoved), m_Requests.end());
+}
+
+std::string Ether::TextureStreamer::Validate() const
+{
+    const std::string policyError = m_Policy.Validate();
+    if (!policyError.empty())
+        return policyError;
+
+    if (m_TextureToHandle.size() != m_Policy.GetNumTextures())
+        return std::format("{} textures are streamed, but the policy has {}", m_TextureToHandle.size(), m_Policy.GetNumTextures());
+
+    for (const auto& pair : m_TextureToHandle)
+        if (m_StreamedTextures[pair.second].m_Texture != pair.first)
+            return std::format("Handle {} belongs to a different texture", pair.second);
+
+    size_t releasingMemory = 0;
+    for (const PendingRelease& release : m_PendingReleases)
+        releasingMemory += release.m_Size;
+
+    if (releasingMemory != m_ReleasingMemory)
+        return std::format("Releasing memory is {} bytes, but the pending releases add up to {}", m_ReleasingMemory, releasingMemory);
+
+    return "";
+}
+
+uint32_t Ether::TextureStreamer::GetMipForFootprint(uint32_t textureSize, float footprint)
+{
+    if (footprint >= textureSize)
+        return 0;
+
+    return static_cast<uint32_t>(std::floor(std::log2(textureSize / (std::max)(footprint, 1.0f))));
+}
+
+uint32_t Ether::TextureStreamer::GetOrAddTexture(Graphics::Texture& texture)
+{
+    const auto iter = m_TextureToHandle.find(&texture);
+    if (iter != m_TextureToHandle.end())
+        return iter->second;
+
+    size_t mipSizes[Graphics::MaxNumMips];
+    for (uint32_t i = 0; i < texture.GetNumMips(); ++i)
+        mipSizes[i] = texture.GetSizeInBytes(i);
+
+    // The texture was deserialized with its tail resident, which is where the policy starts out as well
+    const uint32_t handle = m_Policy.AddTexture(mipSizes, texture.GetNumMips(), texture.GetFirstTailMip());
+    if (handle >= m_StreamedTextures.size())
+        m_StreamedTextures.resize(handle + 1);
+
+    m_StreamedTextures[handle].m_Texture = &texture;
+    m_TextureToHandle[&texture] = handle;
+    return handle;
+}
+
+void Ether::TextureStreamer::LoaderThread()
+{
+    // Streamed textures come from a handful of files (usually just the world), so they are kept open
+    std::unordered_map<std::string, std::unique_ptr<IFileStream>> files;
+
+    while (true)
+    {
+        LoadJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_RequestCondition.wait(lock, [this]() { return m_IsStopping || !m_Requests.empty(); });
+
+            if (m_IsStopping)
+                return;
+
+            job = std::move(m_Requests.front());
+            m_Requests.pop_front();
+        }
+
+        {
+            ETH_MARKER_EVENT("Texture Streamer - Load");
+
+            std::unique_ptr<IFileStream>& file = files[job.m_Path];
+            if (file == nullptr)
+                file = std::make_unique<IFileStream>(job.m_Path);
+
+            // Left empty if the mip could not be read
+            if (!file->HasFailed() && job.m_Offset + job.m_Size <= file->GetFileSize())
+            {
+                job.m_Data = MemoryTracker::Allocate(job.m_Size, MemoryTag::Resources);
+                file->Seek(job.m_Offset);
+                file->ReadBytes(job.m_Data, static_cast<uint32_t>(job.m_Size));
+
+                if (file->HasFailed())
+                {
+                    MemoryTracker::Free(job.m_Data);
+                    job.m_Data = nullptr;
+                    file->Seek(0);
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_CompletedLoads.push_back(std::move(job));
+    }
+}
+
+void Ether::TextureStreamer::ProcessCompletedLoads()
+{
+    std::deque<LoadJob> completedLoads;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        completedLoads.swap(m_CompletedLoads);
+    }
+
+    for (LoadJob& job : completedLoads)
+    {
+        const StreamedTexture& streamedTexture = m_StreamedTextures[job.m_Handle];
+        if (job.m_Generation != streamedTexture.m_Generation)
+        {
+            MemoryTracker::Free(job.m_Data);
+            continue;
+        }
+
+        if (job.m_Data == nullptr)
+        {
+            LogEngineError("Texture streamer: Failed to read mip %u of texture %s", job.m_MipLevel, streamedTexture.m_Texture->GetName());
+            m_Policy.OnMipLoadFailed(job.m_Handle, job.m_MipLevel);
+            m_Stats.m_NumFailedLoads++;
+            continue;
+        }
+
+        const size_t oldSize = m_Policy.GetResidentSize(job.m_Handle);
+        m_Policy.OnMipLoaded(job.m_Handle, job.m_MipLevel);
+        SetResidentMip(job.m_Handle, job.m_MipLevel, job.m_Data, oldSize);
+        m_Stats.m_NumMipLoads++;
+    }
+}
+
+void Ether::TextureStreamer::ReleaseRetiredResources()
+{
+    while (!m_PendingReleases.empty() && m_PendingReleases.front().m_Frame + ReleaseLatency <= m_FrameIndex)
+    {
+        PendingRelease& release = m_PendingReleases.front();
+
+        // The last reference goes away on the rendering thread, once the work has run
+        Graphics::GraphicCore::QueueRenderWork([resource = std::move(release.m_Resource)]() {});
+        m_ReleasingMemory -= release.m_Size;
+        m_PendingReleases.pop_front();
+    }
+}
+
+void Ether::TextureStreamer::UpdateStats()
+{
+    m_Stats.m_NumStreamedTextures = m_Policy.GetNumTextures();
+    m_Stats.m_NumPendingLoads = m_Policy.GetNumPendingLoads();
+    m_Stats.m_CommittedMemory = m_Policy.GetCommittedMemory() + m_ReleasingMemory;
+    m_Stats.m_PeakCommittedMemory = (std::max)(m_Stats.m_PeakCommittedMemory, m_Stats.m_CommittedMemory);
+}
+
+void Ether::TextureStreamer::SetResidentMip(uint32_t handle, uint32_t residentMip, void* mipData, size_t oldSize)
+{
+    std::shared_ptr<std::unique_ptr<Graphics::RhiResource>> oldResource = std::make_shared<std::unique_ptr<Graphics::RhiResource>>();
+
+    Graphics::GraphicCore::QueueRenderWork(
+        [texture = m_StreamedTextures[handle].m_Texture, residentMip, mipData, oldResource]() mutable
+        {
+            *oldResource = texture->SetResidentMip(residentMip, &mipData, Graphics::GraphicCore::GetUploadQueue());
+            MemoryTracker::Free(mipData);
+        });
+
+    m_PendingReleases.push_back({ m_FrameIndex, oldSize, std::move(oldResource) });
+    m_ReleasingMemory += oldSize;
+    MarkMaterialsDirty(handle);
+}
+
+void Ether::TextureStreamer::MarkMaterialsDirty(uint32_t handle) const
+{
+    ResourceManager& resourceManager = m_World.GetResourceManager();
+    Graphics::RenderData& renderData = Graphics::GraphicCore::GetNextRenderData();
+
+    // The material table picks up the new shader resource view in the same frame as the resource changes
+    for (const StringID& materialGuid : m_StreamedTextures[handle].m_Materials)
+    {
+        const Graphics::Material* material = resourceManager.GetMaterialResource(materialGuid);
+        if (material == nullptr)
+            continue;
+
+        const uint32_t batchIdx = material->GetTransientMaterialIdx();
+        if (batchIdx < renderData.m_VisualBatches.size() && renderData.m_VisualBatches[batchIdx].m_Material == material)
+            renderData.m_DirtyMaterials.Add(batchIdx);
+    }
+}
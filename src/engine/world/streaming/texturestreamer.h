@@ -0,0 +1,164 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "engine/pch.h"
+#include "graphics/resources/material.h"
+#include "graphics/resources/texture.h"
+#include "graphics/resources/textureresidencypolicy.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Ether
+{
+class World;
+
+struct TextureStreamingStats
+{
+    uint32_t m_NumStreamedTextures;
+    uint32_t m_NumPendingLoads;
+
+    // Resident mips above the tails and pending loads, plus the resources that are waiting to be released
+    size_t m_CommittedMemory;
+    size_t m_PeakCommittedMemory;
+
+    uint64_t m_NumMipLoads;
+    uint64_t m_NumEvictions;
+    uint64_t m_NumFailedLoads;
+};
+
+/*
+    Streams the mips of the textures that only had their tail loaded (see Texture::IsStreamable()),
+    based on how large the materials that use them are on screen.
+
+    The visual system requests the screen space footprint of every material in view each frame,
+    which is turned into the mip that its textures are sampled at. TextureResidencyPolicy decides
+    what to load and evict within the texture streaming budget (see GraphicConfig), and the mips are
+    read on a loader thread.
+
+    The tails belong to whoever loaded the textures. In a streamed world the world streamer budgets for
+    them, so only the mips above the tails count against the texture streaming budget.
+
+    A change in residency recreates the texture's GPU resource through GraphicCore::QueueRenderWork(),
+    and points the materials that use it at the new shader resource view. The old resource is only
+    destroyed once the frames that could still use it have been rendered, and counts against the
+    budget until then.
+*/
+class ETH_ENGINE_DLL TextureStreamer : public NonCopyable, public NonMovable
+{
+public:
+    TextureStreamer(World& world, size_t budget);
+    ~TextureStreamer();
+
+public:
+    // Main thread, once per frame. Acts on the footprints that were requested during the last frame.
+    void Update();
+
+    // The material covers up to this many pixels on screen (along its larger side) in the current frame
+    void RequestMaterial(const Graphics::Material& material, float footprint);
+
+    // Has to be called before a texture that may be streamed is destroyed
+    void RemoveTexture(const Graphics::Texture& texture);
+
+    // Checks the bookkeeping, returns a description of the first problem found. Meant for tests.
+    std::string Validate() const;
+
+public:
+    inline const TextureStreamingStats& GetStats() const { return m_Stats; }
+
+    // The mip that a texture of this size (along its larger side) is sampled at when it covers footprint
+    // pixels on screen. Assumes that the texture is mapped across the surface once.
+    static uint32_t GetMipForFootprint(uint32_t textureSize, float footprint);
+
+private:
+    struct StreamedTexture
+    {
+        Graphics::Texture* m_Texture = nullptr;
+        // Loads that complete after the texture was removed are told apart by this
+        uint32_t m_Generation = 0;
+        // Materials whose table entries change with the texture's residency
+        std::vector<StringID> m_Materials;
+    };
+
+    // A mip on its way to the loader thread, and its data on the way back
+    struct LoadJob
+    {
+        uint32_t m_Handle = 0;
+        uint32_t m_Generation = 0;
+        uint32_t m_MipLevel = 0;
+        std::string m_Path;
+        uint64_t m_Offset = 0;
+        size_t m_Size = 0;
+        void* m_Data = nullptr;
+    };
+
+    struct PendingRelease
+    {
+        uint64_t m_Frame;
+        size_t m_Size;
+        // Filled in on the rendering thread, once the texture has been given its new resource
+        std::shared_ptr<std::unique_ptr<Graphics::RhiResource>> m_Resource;
+    };
+
+private:
+    uint32_t GetOrAddTexture(Graphics::Texture& texture);
+    void LoaderThread();
+    void ProcessCompletedLoads();
+    void ReleaseRetiredResources();
+    void UpdateStats();
+
+    // Queues the change in residency on the rendering thread, and retires the resource that the texture had.
+    // Takes ownership of mipData.
+    void SetResidentMip(uint32_t handle, uint32_t residentMip, void* mipData, size_t oldSize);
+    void MarkMaterialsDirty(uint32_t handle) const;
+
+private:
+    // Replaced resources are destroyed once the frames that could still use them have been rendered
+    static constexpr uint32_t ReleaseLatency = Graphics::MaxSwapChainBuffers + 2;
+    // Mips are read one at a time, this just keeps the loader thread busy
+    static constexpr uint32_t MaxPendingLoads = 8;
+
+    World& m_World;
+    Graphics::TextureResidencyPolicy m_Policy;
+
+    // Indexed by the policy's handles
+    std::vector<StreamedTexture> m_StreamedTextures;
+    std::unordered_map<const Graphics::Texture*, uint32_t> m_TextureToHandle;
+
+    uint64_t m_FrameIndex;
+    size_t m_ReleasingMemory;
+    std::deque<PendingRelease> m_PendingReleases;
+
+    std::thread m_LoaderThread;
+    std::mutex m_Mutex;
+    std::condition_variable m_RequestCondition;
+    std::deque<LoadJob> m_Requests;
+    std::deque<LoadJob> m_CompletedLoads;
+    bool m_IsStopping;
+
+    // Scratch space for Update()
+    std::vector<Graphics::TextureMipLoad> m_Loads;
+    std::vector<Graphics::TextureMipEviction> m_Evictions;
+
+    TextureStreamingStats m_Stats;
+};
+} // namespace Ether
@@ -0,0 +1,840 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/world/streaming/worldstreamer.h"
+#include "engine/world/world.h"
+#include "engine/world/ecs/components/ecsvisualcomponent.h"
+#include "graphics/graphiccore.h"
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+static uint64_t GetCellKey(int32_t x, int32_t z)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+}
+
+Ether::WorldStreamer::WorldStreamer(World& world, const std::string& path, const WorldStreamingParams& params)
+    : m_World(world)
+    , m_Path(path)
+    , m_Params(params)
+    , m_File(path)
+    , m_Index(StreamingWorldIndex::Read(m_File))
+    , m_Codec(world, m_Index->m_Components)
+    , m_MinCellX(0)
+    , m_MaxCellX(-1)
+    , m_MinCellZ(0)
+    , m_MaxCellZ(-1)
+    , m_MainCameraID(InvalidEntityID)
+    , m_CameraPosition(0.0f, 0.0f, 0.0f)
+    , m_FrameIndex(0)
+    , m_Stamp(0)
+    , m_MaxStreamedEntities(0)
+    , m_NumCommittedEntities(0)
+    , m_AreTextureMipsStreamed(Graphics::Texture::IsMipStreamingEnabled())
+    , m_CommittedMemory(0)
+    , m_ReleasingMemory(0)
+    , m_IsStopping(false)
+    , m_Stats()
+{
+    m_Cells.resize(m_Index->m_Cells.size());
+    m_Resources.resize(m_Index->m_Resources.size());
+
+    std::unordered_map<StringID, uint32_t> textureToResource;
+    for (uint32_t i = 0; i < m_Index->m_Resources.size(); ++i)
+        if (m_Index->m_Resources[i].m_Type == StreamedResourceType::Texture)
+            textureToResource[m_Index->m_Resources[i].m_Guid] = i;
+
+    // Materials stay resident, one that is already registered (e.g. by a world that was loaded before) is kept
+    ResourceManager& resourceManager = world.GetResourceManager();
+    for (std::unique_ptr<Graphics::Material>& material : m_Index->m_Materials)
+    {
+        const StringID materialGuid = material->GetGuid();
+        const StringID textures[] = {
+            material->GetAlbedoTextureID(),
+            material->GetNormalTextureID(),
+            material->GetRoughnessTextureID(),
+            material->GetMetalnessTextureID(),
+            material->GetEmissiveTextureID(),
+        };
+
+        for (const StringID& textureGuid : textures)
+        {
+            const auto iter = textureToResource.find(textureGuid);
+            if (iter != textureToResource.end())
+                m_Resources[iter->second].m_Materials.push_back(materialGuid);
+        }
+
+        if (resourceManager.GetMaterialResource(materialGuid) == nullptr)
+            resourceManager.RegisterMaterialResource(std::move(material));
+    }
+    m_Index->m_Materials.clear();
+
+    LoadPersistentEntities();
+
+    const uint32_t numFreeEntities = Ecs::MaxNumEntities - world.GetNumEntities();
+    m_MaxStreamedEntities = numFreeEntities > NumReservedEntities ? numFreeEntities - NumReservedEntities : 0;
+
+    for (uint32_t i = 0; i < m_Index->m_Cells.size(); ++i)
+    {
+        const StreamedCellDesc& desc = m_Index->m_Cells[i];
+        m_CellLookup[GetCellKey(desc.m_X, desc.m_Z)] = i;
+
+        m_MinCellX = i == 0 ? desc.m_X : (std::min)(m_MinCellX, desc.m_X);
+        m_MaxCellX = i == 0 ? desc.m_X : (std::max)(m_MaxCellX, desc.m_X);
+        m_MinCellZ = i == 0 ? desc.m_Z : (std::min)(m_MinCellZ, desc.m_Z);
+        m_MaxCellZ = i == 0 ? desc.m_Z : (std::max)(m_MaxCellZ, desc.m_Z);
+
+        size_t cost = 0;
+        for (uint32_t resourceIdx : desc.m_Resources)
+            cost += GetResourceMemory(resourceIdx);
+
+        if (cost > m_Params.m_MemoryBudget || desc.m_NumEntities > m_MaxStreamedEntities)
+        {
+            m_Cells[i].m_IsOversized = true;
+            LogEngineWarning(
+                "Streaming world: Cell (%d, %d) needs %.2f MiB and %u entities, which is more than there is, it will never be loaded",
+                desc.m_X,
+                desc.m_Z,
+                cost / static_cast<double>(_1MiB),
+                desc.m_NumEntities);
+        }
+    }
+
+    for (uint32_t i = 0; i < m_Params.m_NumLoaderThreads; ++i)
+        m_LoaderThreads.emplace_back(&WorldStreamer::LoaderThread, this);
+
+    LogEngineInfo(
+        "Streaming world %s: %zu cells of %.1f units, %zu resources, %zu persistent entities",
+        path.c_str(),
+        m_Cells.size(),
+        m_Index->m_CellSize,
+        m_Resources.size(),
+        m_PersistentEntities.size());
+}
+
+Ether::WorldStreamer::~WorldStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_IsStopping = true;
+    }
+
+    m_RequestCondition.notify_all();
+    for (std::thread& thread : m_LoaderThreads)
+        thread.join();
+
+    // Whatever is still resident belongs to the world now, only the evicted resources are left to release
+    for (PendingRelease& release : m_PendingReleases)
+        Graphics::GraphicCore::QueueRenderWork([mesh = release.m_Mesh, texture = release.m_Texture]() {});
+}
+
+void Ether::WorldStreamer::Update(const ethVector3& cameraPosition)
+{
+    ETH_MARKER_EVENT("World Streamer - Update");
+
+    m_FrameIndex++;
+    m_CameraPosition = cameraPosition;
+
+    ProcessCompletedLoads();
+    ReleaseRetiredResources();
+    SelectWantedCells();
+    UnloadDistantCells();
+    RequestWantedCells();
+
+    // Loads were done on this thread just now, and are instantiated in the same frame
+    if (m_Params.m_NumLoaderThreads == 0)
+        ProcessCompletedLoads();
+
+    InstantiateLoadedCells();
+    UpdateStats();
+}
+
+bool Ether::WorldStreamer::HasCell(int32_t x, int32_t z) const
+{
+    return FindCell(x, z) >= 0;
+}
+
+bool Ether::WorldStreamer::IsCellResident(int32_t x, int32_t z) const
+{
+    const int64_t cellIdx = FindCell(x, z);
+    return cellIdx >= 0 && m_Cells[cellIdx].m_State == CellState::Resident;
+}
+
+void Ether::WorldStreamer::LoadPersistentEntities()
+{
+    m_File.Seek(m_Index->m_PersistentOffset);
+    IByteStream istream(m_File, m_Index->m_PersistentSize);
+    if (!istream.IsOpen())
+        throw std::runtime_error("Failed to read the persistent entities of the streaming world");
+
+    uint32_t numEntities;
+    istream >> numEntities;
+    if (numEntities > Ecs::MaxNumEntities)
+        throw std::runtime_error("Streaming world has too many persistent entities");
+
+    for (uint32_t i = 0; i < numEntities; ++i)
+        m_PersistentEntities.push_back(m_Codec.Read(istream, m_PersistentEntities));
+
+    if (m_Index->m_MainCameraIdx < m_PersistentEntities.size())
+        m_MainCameraID = m_PersistentEntities[m_Index->m_MainCameraIdx];
+}
+
+void Ether::WorldStreamer::LoaderThread()
+{
+    // Each thread reads through its own file handle, so that seeks do not have to be serialized
+    IFileStream file(m_Path);
+
+    while (true)
+    {
+        LoadJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_RequestCondition.wait(lock, [this]() { return m_IsStopping || !m_Requests.empty(); });
+
+            if (m_IsStopping)
+                return;
+
+            job = std::move(m_Requests.front());
+            m_Requests.pop_front();
+        }
+
+        Load(file, job);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_CompletedLoads.push_back(std::move(job));
+    }
+}
+
+void Ether::WorldStreamer::Load(IFileStream& file, LoadJob& job) const
+{
+    ETH_MARKER_EVENT("World Streamer - Load");
+
+    const uint64_t offset = job.m_IsCell ? m_Index->m_Cells[job.m_Index].m_Offset : m_Index->m_Resources[job.m_Index].m_Offset;
+    const uint32_t size = job.m_IsCell ? m_Index->m_Cells[job.m_Index].m_Size : m_Index->m_Resources[job.m_Index].m_Size;
+
+    if (!file.IsOpen() || offset + size > file.GetFileSize())
+    {
+        job.m_Error = "The data is out of range of the file";
+        return;
+    }
+
+    try
+    {
+        file.Seek(offset);
+        std::unique_ptr<IByteStream> istream = std::make_unique<IByteStream>(file, size);
+        if (!istream->IsOpen())
+            throw std::runtime_error("Failed to read from the file");
+
+        if (job.m_IsCell)
+            job.m_Data = std::move(istream);
+        else if (job.m_Mesh != nullptr)
+            job.m_Mesh->Deserialize(*istream);
+        else
+            job.m_Texture->Deserialize(*istream);
+    }
+    catch (const std::exception& e)
+    {
+        job.m_Error = e.what();
+        job.m_Data.reset();
+    }
+}
+
+void Ether::WorldStreamer::IssueLoad(LoadJob&& job)
+{
+    if (m_Params.m_NumLoaderThreads == 0)
+    {
+        Load(m_File, job);
+        m_CompletedLoads.push_back(std::move(job));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Requests.push_back(std::move(job));
+    }
+
+    m_RequestCondition.notify_one();
+}
+
+bool Ether::WorldStreamer::CancelQueuedLoad(bool isCell, uint32_t index, uint32_t generation)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    const auto iter = std::find_if(m_Requests.begin(), m_Requests.end(), [&](const LoadJob& job) {
+        return job.m_IsCell == isCell && job.m_Index == index && job.m_Generation == generation;
+    });
+
+    if (iter == m_Requests.end())
+        return false;
+
+    m_Requests.erase(iter);
+    return true;
+}
+
+void Ether::WorldStreamer::ProcessCompletedLoads()
+{
+    std::deque<LoadJob> completedLoads;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::swap(completedLoads, m_CompletedLoads);
+    }
+
+    for (LoadJob& job : completedLoads)
+    {
+        if (!job.m_IsCell)
+        {
+            OnResourceLoaded(job);
+            continue;
+        }
+
+        Cell& cell = m_Cells[job.m_Index];
+        if (job.m_Generation != cell.m_Generation || cell.m_State != CellState::Loading)
+            continue;
+
+        if (!job.m_Error.empty())
+        {
+            const StreamedCellDesc& desc = m_Index->m_Cells[job.m_Index];
+            LogEngineError("Streaming world: Failed to load cell (%d, %d): %s", desc.m_X, desc.m_Z, job.m_Error.c_str());
+            m_Stats.m_NumFailedLoads++;
+        }
+
+        // A cell that failed to load is left empty, rather than retried every frame
+        cell.m_Data = std::move(job.m_Data);
+        cell.m_State = CellState::Loaded;
+    }
+}
+
+void Ether::WorldStreamer::ReleaseRetiredResources()
+{
+    while (!m_PendingReleases.empty() && m_PendingReleases.front().m_Frame + ReleaseLatency <= m_FrameIndex)
+    {
+        PendingRelease& release = m_PendingReleases.front();
+
+        // The last reference goes away on the rendering thread, once the work has run
+        Graphics::GraphicCore::QueueRenderWork([mesh = std::move(release.m_Mesh), texture = std::move(release.m_Texture)]() {});
+        m_ReleasingMemory -= release.m_Size;
+        m_PendingReleases.pop_front();
+    }
+}
+
+void Ether::WorldStreamer::SelectWantedCells()
+{
+    for (uint32_t cellIdx : m_WantedCells)
+        m_Cells[cellIdx].m_IsWanted = false;
+
+    m_WantedCells.clear();
+
+    const float cellSize = m_Index->m_CellSize;
+    const float radius = m_Params.m_LoadRadius;
+    const int32_t minX = (std::max)(StreamingWorldIndex::GetCellCoordinate(m_CameraPosition.x - radius, cellSize), m_MinCellX);
+    const int32_t maxX = (std::min)(StreamingWorldIndex::GetCellCoordinate(m_CameraPosition.x + radius, cellSize), m_MaxCellX);
+    const int32_t minZ = (std::max)(StreamingWorldIndex::GetCellCoordinate(m_CameraPosition.z - radius, cellSize), m_MinCellZ);
+    const int32_t maxZ = (std::min)(StreamingWorldIndex::GetCellCoordinate(m_CameraPosition.z + radius, cellSize), m_MaxCellZ);
+
+    std::vector<std::pair<float, uint32_t>> candidates;
+    for (int32_t z = minZ; z <= maxZ; ++z)
+    {
+        for (int32_t x = minX; x <= maxX; ++x)
+        {
+            const int64_t cellIdx = FindCell(x, z);
+            if (cellIdx < 0 || m_Cells[cellIdx].m_IsOversized)
+                continue;
+
+            const float distance = GetCellDistance(static_cast<uint32_t>(cellIdx));
+            if (distance <= radius)
+                candidates.emplace_back(distance, static_cast<uint32_t>(cellIdx));
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    // The nearest cells whose resources fit together. Stops at the first one that does not, so
+    // that a farther cell never takes the memory that a nearer one will need.
+    m_Stamp++;
+    size_t cost = 0;
+    uint32_t numEntities = 0;
+
+    for (auto& candidate : candidates)
+    {
+        const uint32_t cellIdx = candidate.second;
+        const StreamedCellDesc& desc = m_Index->m_Cells[cellIdx];
+
+        size_t cellCost = 0;
+        for (uint32_t resourceIdx : desc.m_Resources)
+            if (m_Resources[resourceIdx].m_Stamp != m_Stamp)
+                cellCost += GetResourceMemory(resourceIdx);
+
+        if (cost + cellCost > m_Params.m_MemoryBudget || numEntities + desc.m_NumEntities > m_MaxStreamedEntities)
+            break;
+
+        for (uint32_t resourceIdx : desc.m_Resources)
+            m_Resources[resourceIdx].m_Stamp = m_Stamp;
+
+        cost += cellCost;
+        numEntities += desc.m_NumEntities;
+        m_Cells[cellIdx].m_IsWanted = true;
+        m_WantedCells.push_back(cellIdx);
+    }
+}
+
+void Ether::WorldStreamer::UnloadDistantCells()
+{
+    // Copied, unloading removes the cell from the active cells
+    const std::vector<uint32_t> activeCells = m_ActiveCells;
+    for (uint32_t cellIdx : activeCells)
+        if (!m_Cells[cellIdx].m_IsWanted && GetCellDistance(cellIdx) > m_Params.m_UnloadRadius)
+            UnloadCell(cellIdx);
+}
+
+void Ether::WorldStreamer::RequestWantedCells()
+{
+    for (uint32_t cellIdx : m_WantedCells)
+    {
+        if (m_Cells[cellIdx].m_State != CellState::Unloaded)
+            continue;
+
+        const size_t cost = GetNewResourceCost(cellIdx);
+        const uint32_t numEntities = m_Index->m_Cells[cellIdx].m_NumEntities;
+
+        // Evicted memory still counts until it is released, so this only evicts as much as the
+        // cell needs, and the cell is loaded a few frames later
+        while (m_CommittedMemory + cost > m_Params.m_MemoryBudget ||
+               m_NumCommittedEntities + numEntities > m_MaxStreamedEntities)
+        {
+            if (!EvictFarthestUnwantedCell())
+                break;
+        }
+
+        // Nearer cells go first, later ones wait for them rather than skipping ahead
+        if (m_CommittedMemory + m_ReleasingMemory + GetNewResourceCost(cellIdx) > m_Params.m_MemoryBudget ||
+            m_NumCommittedEntities + numEntities > m_MaxStreamedEntities)
+            break;
+
+        RequestCell(cellIdx);
+    }
+}
+
+void Ether::WorldStreamer::InstantiateLoadedCells()
+{
+    std::vector<std::pair<float, uint32_t>> readyCells;
+    for (uint32_t cellIdx : m_ActiveCells)
+        if (IsCellReady(cellIdx))
+            readyCells.emplace_back(GetCellDistance(cellIdx), cellIdx);
+
+    std::sort(readyCells.begin(), readyCells.end());
+
+    const size_t numCells = (std::min)(readyCells.size(), static_cast<size_t>(m_Params.m_MaxCellsInstantiatedPerFrame));
+    for (size_t i = 0; i < numCells; ++i)
+        InstantiateCell(readyCells[i].second);
+}
+
+void Ether::WorldStreamer::UpdateStats()
+{
+    m_Stats.m_NumResidentCells = 0;
+    m_Stats.m_NumLoadingCells = 0;
+    m_Stats.m_NumStreamedEntities = 0;
+
+    for (uint32_t cellIdx : m_ActiveCells)
+    {
+        const Cell& cell = m_Cells[cellIdx];
+        m_Stats.m_NumResidentCells += cell.m_State == CellState::Resident ? 1 : 0;
+        m_Stats.m_NumLoadingCells += cell.m_State == CellState::Resident ? 0 : 1;
+        m_Stats.m_NumStreamedEntities += static_cast<uint32_t>(cell.m_Entities.size());
+    }
+
+    m_Stats.m_NumResidentResources = 0;
+    for (const Resource& resource : m_Resources)
+        m_Stats.m_NumResidentResources += resource.m_State == ResourceState::Resident ? 1 : 0;
+
+    m_Stats.m_CommittedMemory = m_CommittedMemory + m_ReleasingMemory;
+    m_Stats.m_PeakCommittedMemory = (std::max)(m_Stats.m_PeakCommittedMemory, m_Stats.m_CommittedMemory);
+}
+
+void Ether::WorldStreamer::RequestCell(uint32_t cellIdx)
+{
+    Cell& cell = m_Cells[cellIdx];
+    cell.m_State = CellState::Loading;
+    m_ActiveCells.push_back(cellIdx);
+    m_NumCommittedEntities += m_Index->m_Cells[cellIdx].m_NumEntities;
+    m_Stats.m_NumCellLoads++;
+
+    for (uint32_t resourceIdx : m_Index->m_Cells[cellIdx].m_Resources)
+        AddResourceRef(resourceIdx);
+
+    LoadJob job;
+    job.m_IsCell = true;
+    job.m_Index = cellIdx;
+    job.m_Generation = cell.m_Generation;
+    IssueLoad(std::move(job));
+}
+
+void Ether::WorldStreamer::UnloadCell(uint32_t cellIdx)
+{
+    Cell& cell = m_Cells[cellIdx];
+
+    // Destroyed before the resources are released, the visual system drops them during this frame
+    for (Ecs::EntityID entityID : cell.m_Entities)
+        m_World.DestroyEntity(entityID);
+
+    // Saves reading a cell that is no longer needed, when the camera moves faster than the loaders
+    if (cell.m_State == CellState::Loading)
+        CancelQueuedLoad(true, cellIdx, cell.m_Generation);
+
+    cell.m_Entities.clear();
+    cell.m_Data.reset();
+    cell.m_State = CellState::Unloaded;
+    cell.m_Generation++;
+
+    m_ActiveCells.erase(std::find(m_ActiveCells.begin(), m_ActiveCells.end(), cellIdx));
+    m_NumCommittedEntities -= m_Index->m_Cells[cellIdx].m_NumEntities;
+    m_Stats.m_NumCellUnloads++;
+
+    for (uint32_t resourceIdx : m_Index->m_Cells[cellIdx].m_Resources)
+        ReleaseResourceRef(resourceIdx);
+}
+
+bool Ether::WorldStreamer::EvictFarthestUnwantedCell()
+{
+    int64_t farthestCellIdx = -1;
+    float farthestDistance = -1.0f;
+
+    for (uint32_t cellIdx : m_ActiveCells)
+    {
+        const float distance = GetCellDistance(cellIdx);
+        if (!m_Cells[cellIdx].m_IsWanted && distance > farthestDistance)
+        {
+            farthestCellIdx = cellIdx;
+            farthestDistance = distance;
+        }
+    }
+
+    if (farthestCellIdx < 0)
+        return false;
+
+    UnloadCell(static_cast<uint32_t>(farthestCellIdx));
+    return true;
+}
+
+void Ether::WorldStreamer::InstantiateCell(uint32_t cellIdx)
+{
+    ETH_MARKER_EVENT("World Streamer - Instantiate Cell");
+
+    Cell& cell = m_Cells[cellIdx];
+    const StreamedCellDesc& desc = m_Index->m_Cells[cellIdx];
+    cell.m_State = CellState::Resident;
+
+    if (cell.m_Data == nullptr)
+        return;
+
+    try
+    {
+        uint32_t numEntities;
+        *cell.m_Data >> numEntities;
+
+        // The entity budget was planned with the count from the index
+        if (numEntities > desc.m_NumEntities)
+            throw std::runtime_error("Cell has more entities than its index entry");
+
+        for (uint32_t i = 0; i < numEntities; ++i)
+            cell.m_Entities.push_back(m_Codec.Read(*cell.m_Data, m_PersistentEntities));
+    }
+    catch (const std::exception& e)
+    {
+        LogEngineError("Streaming world: Failed to instantiate cell (%d, %d): %s", desc.m_X, desc.m_Z, e.what());
+        m_Stats.m_NumFailedLoads++;
+
+        for (Ecs::EntityID entityID : cell.m_Entities)
+            m_World.DestroyEntity(entityID);
+
+        cell.m_Entities.clear();
+    }
+
+    cell.m_Data.reset();
+}
+
+void Ether::WorldStreamer::AddResourceRef(uint32_t resourceIdx)
+{
+    Resource& resource = m_Resources[resourceIdx];
+    if (resource.m_RefCount++ != 0)
+        return;
+
+    const StreamedResourceDesc& desc = m_Index->m_Resources[resourceIdx];
+    resource.m_State = ResourceState::Loading;
+    resource.m_HasFailed = false;
+    m_CommittedMemory += GetResourceMemory(resourceIdx);
+    m_Stats.m_NumResourceLoads++;
+
+    LoadJob job;
+    job.m_Index = resourceIdx;
+    job.m_Generation = resource.m_Generation;
+    if (desc.m_Type == StreamedResourceType::Mesh)
+        job.m_Mesh = std::make_unique<Graphics::Mesh>();
+    else
+        job.m_Texture = std::make_unique<Graphics::Texture>();
+
+    IssueLoad(std::move(job));
+}
+
+void Ether::WorldStreamer::ReleaseResourceRef(uint32_t resourceIdx)
+{
+    Resource& resource = m_Resources[resourceIdx];
+    if (--resource.m_RefCount != 0)
+        return;
+
+    const size_t size = GetResourceMemory(resourceIdx);
+
+    if (resource.m_State == ResourceState::Loading)
+    {
+        // Unless the request was still queued, the data is being read and is dropped when it arrives
+        if (!CancelQueuedLoad(false, resourceIdx, resource.m_Generation))
+            m_ReleasingMemory += size;
+
+        resource.m_Generation++;
+        m_CommittedMemory -= size;
+    }
+    else
+    {
+        EvictResource(resourceIdx);
+    }
+
+    resource.m_State = ResourceState::Unloaded;
+}
+
+void Ether::WorldStreamer::OnResourceLoaded(LoadJob& job)
+{
+    Resource& resource = m_Resources[job.m_Index];
+    const StreamedResourceDesc& desc = m_Index->m_Resources[job.m_Index];
+
+    if (job.m_Generation != resource.m_Generation)
+    {
+        m_ReleasingMemory -= GetResourceMemory(job.m_Index);
+        return;
+    }
+
+    resource.m_State = ResourceState::Resident;
+
+    const StringID guid = job.m_Mesh != nullptr ? StringID(job.m_Mesh->GetGuid()) : StringID(job.m_Texture->GetGuid());
+    if (job.m_Error.empty() && guid != desc.m_Guid)
+        job.m_Error = "The data belongs to a different resource";
+
+    if (!job.m_Error.empty())
+    {
+        LogEngineError("Streaming world: Failed to load resource %s: %s", desc.m_Guid.GetString().c_str(), job.m_Error.c_str());
+        resource.m_HasFailed = true;
+        m_Stats.m_NumFailedLoads++;
+        return;
+    }
+
+    ResourceManager& resourceManager = m_World.GetResourceManager();
+    const bool isHeadless = Graphics::GraphicCore::IsHeadless();
+
+    if (job.m_Mesh != nullptr)
+    {
+        Graphics::Mesh* mesh = job.m_Mesh.get();
+        resourceManager.RegisterMeshResource(std::move(job.m_Mesh));
+
+        if (!isHeadless)
+            Graphics::GraphicCore::QueueRenderWork([mesh]() { mesh->CreateGpuResources(Graphics::GraphicCore::GetUploadQueue()); });
+    }
+    else
+    {
+        Graphics::Texture* texture = job.m_Texture.get();
+        resourceManager.RegisterTextureResource(std::move(job.m_Texture));
+
+        if (!isHeadless)
+            Graphics::GraphicCore::QueueRenderWork([texture]() { texture->CreateGpuResource(Graphics::GraphicCore::GetUploadQueue()); });
+
+        MarkMaterialsDirty(job.m_Index);
+    }
+}
+
+void Ether::WorldStreamer::EvictResource(uint32_t resourceIdx)
+{
+    Resource& resource = m_Resources[resourceIdx];
+    const StreamedResourceDesc& desc = m_Index->m_Resources[resourceIdx];
+
+    m_CommittedMemory -= GetResourceMemory(resourceIdx);
+    m_Stats.m_NumResourceEvictions++;
+
+    if (resource.m_HasFailed)
+        return;
+
+    ResourceManager& resourceManager = m_World.GetResourceManager();
+    PendingRelease release = { m_FrameIndex, GetResourceMemory(resourceIdx), nullptr, nullptr };
+
+    // Shader resource views are unregistered before the frame is rendered, the resources themselves
+    // are kept until the frames in flight are done with them
+    if (desc.m_Type == StreamedResourceType::Mesh)
+    {
+        release.m_Mesh = resourceManager.UnregisterMeshResource(desc.m_Guid);
+        Graphics::GraphicCore::QueueRenderWork([mesh = release.m_Mesh]() { mesh->UnregisterShaderResourceViews(); });
+    }
+    else
+    {
+        release.m_Texture = resourceManager.UnregisterTextureResource(desc.m_Guid);
+        if (m_World.GetTextureStreamer() != nullptr)
+            m_World.GetTextureStreamer()->RemoveTexture(*release.m_Texture);
+
+        Graphics::GraphicCore::QueueRenderWork([texture = release.m_Texture]() { texture->UnregisterShaderResourceView(); });
+        MarkMaterialsDirty(resourceIdx);
+    }
+
+    m_ReleasingMemory += release.m_Size;
+    m_PendingReleases.push_back(std::move(release));
+}
+
+void Ether::WorldStreamer::MarkMaterialsDirty(uint32_t resourceIdx) const
+{
+    ResourceManager& resourceManager = m_World.GetResourceManager();
+    Graphics::RenderData& renderData = Graphics::GraphicCore::GetNextRenderData();
+
+    // Only materials that have a batch are in the material table, the others pick the texture up once they get one
+    for (const StringID& materialGuid : m_Resources[resourceIdx].m_Materials)
+    {
+        const Graphics::Material* material = resourceManager.GetMaterialResource(materialGuid);
+        if (material == nullptr)
+            continue;
+
+        const uint32_t batchIdx = material->GetTransientMaterialIdx();
+        if (batchIdx < renderData.m_VisualBatches.size() && renderData.m_VisualBatches[batchIdx].m_Material == material)
+            renderData.m_DirtyMaterials.Add(batchIdx);
+    }
+}
+
+size_t Ether::WorldStreamer::GetResourceMemory(uint32_t resourceIdx) const
+{
+    const StreamedResourceDesc& desc = m_Index->m_Resources[resourceIdx];
+    return desc.m_Type == StreamedResourceType::Texture && m_AreTextureMipsStreamed ? desc.m_TailSize : desc.m_Size;
+}
+
+size_t Ether::WorldStreamer::GetNewResourceCost(uint32_t cellIdx) const
+{
+    size_t cost = 0;
+    for (uint32_t resourceIdx : m_Index->m_Cells[cellIdx].m_Resources)
+        if (m_Resources[resourceIdx].m_RefCount == 0)
+            cost += GetResourceMemory(resourceIdx);
+
+    return cost;
+}
+
+bool Ether::WorldStreamer::IsCellReady(uint32_t cellIdx) const
+{
+    if (m_Cells[cellIdx].m_State != CellState::Loaded)
+        return false;
+
+    for (uint32_t resourceIdx : m_Index->m_Cells[cellIdx].m_Resources)
+        if (m_Resources[resourceIdx].m_State != ResourceState::Resident)
+            return false;
+
+    return true;
+}
+
+float Ether::WorldStreamer::GetCellDistance(uint32_t cellIdx) const
+{
+    const StreamedCellDesc& desc = m_Index->m_Cells[cellIdx];
+    const float cellSize = m_Index->m_CellSize;
+
+    // From the camera to the nearest point of the cell, 0 if the camera is above it
+    const float minX = desc.m_X * cellSize;
+    const float minZ = desc.m_Z * cellSize;
+    const float dx = (std::max)({ minX - m_CameraPosition.x, 0.0f, m_CameraPosition.x - (minX + cellSize) });
+    const float dz = (std::max)({ minZ - m_CameraPosition.z, 0.0f, m_CameraPosition.z - (minZ + cellSize) });
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+int64_t Ether::WorldStreamer::FindCell(int32_t x, int32_t z) const
+{
+    const auto iter = m_CellLookup.find(GetCellKey(x, z));
+    return iter == m_CellLookup.end() ? -1 : static_cast<int64_t>(iter->second);
+}
+
+std::string Ether::WorldStreamer::Validate()
+{
+    ResourceManager& resourceManager = m_World.GetResourceManager();
+    std::vector<uint32_t> refCounts(m_Resources.size(), 0);
+    size_t committedMemory = 0;
+
+    for (uint32_t cellIdx = 0; cellIdx < m_Cells.size(); ++cellIdx)
+    {
+        const Cell& cell = m_Cells[cellIdx];
+        const StreamedCellDesc& desc = m_Index->m_Cells[cellIdx];
+
+        if (cell.m_State == CellState::Unloaded)
+        {
+            if (!cell.m_Entities.empty())
+                return std::format("Cell ({}, {}) is unloaded, but has entities", desc.m_X, desc.m_Z);
+
+            continue;
+        }
+
+        for (uint32_t resourceIdx : desc.m_Resources)
+        {
+            refCounts[resourceIdx]++;
+
+            if (cell.m_State == CellState::Resident && m_Resources[resourceIdx].m_State != ResourceState::Resident)
+                return std::format("Cell ({}, {}) is resident, but one of its resources is not", desc.m_X, desc.m_Z);
+        }
+
+        for (Ecs::EntityID entityID : cell.m_Entities)
+        {
+            if (!m_World.HasEntity(entityID))
+                return std::format("Cell ({}, {}) has an entity that does not exist", desc.m_X, desc.m_Z);
+
+            Ecs::EcsComponentArrayBase& visuals = m_World.GetEcsManager().GetComponentManager().GetComponentArray(Ecs::EcsVisualComponent::s_ComponentID);
+            const Ecs::EcsVisualComponent* visual = static_cast<Ecs::EcsVisualComponent*>(visuals.GetComponentData(entityID));
+            if (visual != nullptr && resourceManager.GetMeshResource(visual->m_MeshGuid) == nullptr)
+            {
+                // Meshes that are not part of the world, or that failed to load, are expected to be missing
+                for (uint32_t resourceIdx : desc.m_Resources)
+                    if (m_Index->m_Resources[resourceIdx].m_Guid == visual->m_MeshGuid && !m_Resources[resourceIdx].m_HasFailed)
+                        return std::format("Cell ({}, {}) has a visual whose mesh is not resident", desc.m_X, desc.m_Z);
+            }
+        }
+    }
+
+    for (uint32_t resourceIdx = 0; resourceIdx < m_Resources.size(); ++resourceIdx)
+    {
+        const Resource& resource = m_Resources[resourceIdx];
+        const StreamedResourceDesc& desc = m_Index->m_Resources[resourceIdx];
+
+        if (resource.m_RefCount != refCounts[resourceIdx])
+            return std::format("Resource {} has {} references, but is used by {} cells", desc.m_Guid.GetString(), resource.m_RefCount, refCounts[resourceIdx]);
+
+        if ((resource.m_RefCount == 0) != (resource.m_State == ResourceState::Unloaded))
+            return std::format("Resource {} is unloaded, but still referenced (or the other way around)", desc.m_Guid.GetString());
+
+        const bool isRegistered = desc.m_Type == StreamedResourceType::Mesh
+                                      ? resourceManager.GetMeshResource(desc.m_Guid) != nullptr
+                                      : resourceManager.GetTextureResource(desc.m_Guid) != nullptr;
+        const bool shouldBeRegistered = resource.m_State == ResourceState::Resident && !resource.m_HasFailed;
+        if (isRegistered != shouldBeRegistered)
+            return std::format("Resource {} is registered with the world, but not resident (or the other way around)", desc.m_Guid.GetString());
+
+        if (resource.m_RefCount != 0)
+            committedMemory += GetResourceMemory(resourceIdx);
+    }
+
+    if (committedMemory != m_CommittedMemory)
+        return std::format("{} bytes are committed, but the resources in use add up to {}", m_CommittedMemory, committedMemory);
+
+    if (m_CommittedMemory + m_ReleasingMemory > m_Params.m_MemoryBudget)
+        return std::format("{} bytes are committed, which is over the budget of {}", m_CommittedMemory + m_ReleasingMemory, m_Params.m_MemoryBudget);
+
+    return "";
+}
@@ -0,0 +1,255 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "engine/pch.h"
+#include "engine/world/streaming/streamingworldformat.h"
+#include "graphics/resources/mesh.h"
+#include "graphics/resources/texture.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Ether
+{
+struct ETH_ENGINE_DLL WorldStreamingParams
+{
+    // Cells are loaded nearest first while they are within this distance of the camera (on the XZ plane)
+    float m_LoadRadius = 192.0f;
+    // Cells are kept until they are this far away, unless their memory is needed for closer ones
+    float m_UnloadRadius = 256.0f;
+    // Upper bound for the meshes and textures that are resident, loading or waiting to be released. Of the
+    // textures whose mips are streamed, only their tails count (see TextureStreamer).
+    size_t m_MemoryBudget = _256MiB;
+    // 0 loads on the main thread instead, which makes streaming deterministic (e.g. for replays)
+    uint32_t m_NumLoaderThreads = 2;
+    // Cells that are turned into entities per frame, which bounds the hitch of doing so
+    uint32_t m_MaxCellsInstantiatedPerFrame = 4;
+};
+
+struct WorldStreamingStats
+{
+    uint32_t m_NumResidentCells;
+    uint32_t m_NumLoadingCells;
+    uint32_t m_NumResidentResources;
+    uint32_t m_NumStreamedEntities;
+
+    // Everything that counts against the budget, including resources that are waiting to be released
+    size_t m_CommittedMemory;
+    size_t m_PeakCommittedMemory;
+
+    uint64_t m_NumCellLoads;
+    uint64_t m_NumCellUnloads;
+    uint64_t m_NumResourceLoads;
+    uint64_t m_NumResourceEvictions;
+    uint64_t m_NumFailedLoads;
+};
+
+/*
+    Keeps the cells of a streaming world (see StreamingWorldIndex) that are near the camera resident.
+
+    Cells and the meshes and textures they use are read on loader threads and handed back to the
+    main thread, which registers them with the world in Update(). Resources are shared between cells
+    and ref counted, a cell is only turned into entities once all of them are resident. The cells
+    that are wanted are the nearest ones whose resources fit into the budget together, so farther
+    cells never take memory from nearer ones. Cells that are no longer wanted are kept until they
+    leave the unload radius, or until their memory is needed.
+
+    GPU resources are created and released through GraphicCore::QueueRenderWork(). Evicted
+    resources are only destroyed once the frames that could still use them have been rendered, and
+    count against the budget until then.
+*/
+class ETH_ENGINE_DLL WorldStreamer : public NonCopyable, public NonMovable
+{
+public:
+    // Loads the index and the persistent entities into the world, throws if the file is not valid
+    WorldStreamer(World& world, const std::string& path, const WorldStreamingParams& params);
+    ~WorldStreamer();
+
+public:
+    // Main thread, once per frame before the ECS update
+    void Update(const ethVector3& cameraPosition);
+
+    // Checks the bookkeeping against the world, returns a description of the first problem found.
+    // Expensive, meant for tests.
+    std::string Validate();
+
+public:
+    inline const std::string& GetWorldName() const { return m_Index->m_WorldName; }
+    inline float GetCellSize() const { return m_Index->m_CellSize; }
+    inline Ecs::EntityID GetMainCameraID() const { return m_MainCameraID; }
+    inline const WorldStreamingParams& GetParams() const { return m_Params; }
+    inline const WorldStreamingStats& GetStats() const { return m_Stats; }
+
+    bool HasCell(int32_t x, int32_t z) const;
+    bool IsCellResident(int32_t x, int32_t z) const;
+
+private:
+    enum class CellState : uint8_t
+    {
+        Unloaded,
+        Loading,
+        // Read, but waiting for its resources or to be instantiated
+        Loaded,
+        Resident,
+    };
+
+    enum class ResourceState : uint8_t
+    {
+        Unloaded,
+        Loading,
+        Resident,
+    };
+
+    struct Cell
+    {
+        CellState m_State = CellState::Unloaded;
+        // Loads that completed after the cell was unloaded again are told apart by this
+        uint32_t m_Generation = 0;
+        bool m_IsWanted = false;
+        // Needs more memory or entities than there are, never loaded
+        bool m_IsOversized = false;
+        std::unique_ptr<IByteStream> m_Data;
+        std::vector<Ecs::EntityID> m_Entities;
+    };
+
+    struct Resource
+    {
+        ResourceState m_State = ResourceState::Unloaded;
+        uint32_t m_Generation = 0;
+        uint32_t m_RefCount = 0;
+        // Resident, but could not be read. Cells that use it are loaded without it.
+        bool m_HasFailed = false;
+        uint32_t m_Stamp = 0;
+        // Materials that use the texture, their table entries change with its residency
+        std::vector<StringID> m_Materials;
+    };
+
+    // A request on its way to a loader thread, and its result on the way back
+    struct LoadJob
+    {
+        bool m_IsCell = false;
+        uint32_t m_Index = 0;
+        uint32_t m_Generation = 0;
+
+        // Created on the main thread, Serializable's constructor is not thread safe
+        std::unique_ptr<Graphics::Mesh> m_Mesh;
+        std::unique_ptr<Graphics::Texture> m_Texture;
+        std::unique_ptr<IByteStream> m_Data;
+        std::string m_Error;
+    };
+
+    struct PendingRelease
+    {
+        uint64_t m_Frame;
+        size_t m_Size;
+        std::shared_ptr<Graphics::Mesh> m_Mesh;
+        std::shared_ptr<Graphics::Texture> m_Texture;
+    };
+
+private:
+    void LoadPersistentEntities();
+    void LoaderThread();
+    void Load(IFileStream& file, LoadJob& job) const;
+    void IssueLoad(LoadJob&& job);
+    // Removes a request that no loader thread has picked up yet, returns false if there was none
+    bool CancelQueuedLoad(bool isCell, uint32_t index, uint32_t generation);
+
+    void ProcessCompletedLoads();
+    void ReleaseRetiredResources();
+    void SelectWantedCells();
+    void UnloadDistantCells();
+    void RequestWantedCells();
+    void InstantiateLoadedCells();
+    void UpdateStats();
+
+    void RequestCell(uint32_t cellIdx);
+    void UnloadCell(uint32_t cellIdx);
+    bool EvictFarthestUnwantedCell();
+    void InstantiateCell(uint32_t cellIdx);
+
+    void AddResourceRef(uint32_t resourceIdx);
+    void ReleaseResourceRef(uint32_t resourceIdx);
+    void OnResourceLoaded(LoadJob& job);
+    void EvictResource(uint32_t resourceIdx);
+    void MarkMaterialsDirty(uint32_t resourceIdx) const;
+
+    // What a resource takes up while it is resident. Textures only load their tail when their mips are
+    // streamed, the more detailed mips count against the texture streaming budget instead.
+    size_t GetResourceMemory(uint32_t resourceIdx) const;
+    size_t GetNewResourceCost(uint32_t cellIdx) const;
+    bool IsCellReady(uint32_t cellIdx) const;
+    float GetCellDistance(uint32_t cellIdx) const;
+    int64_t FindCell(int32_t x, int32_t z) const;
+
+private:
+    // Evicted resources are destroyed once the frames that could still use them have been rendered
+    static constexpr uint32_t ReleaseLatency = Graphics::MaxSwapChainBuffers + 2;
+    // Entities that are left for the application, on top of the ones in use when the world is loaded
+    static constexpr uint32_t NumReservedEntities = 64;
+
+    World& m_World;
+    std::string m_Path;
+    WorldStreamingParams m_Params;
+    IFileStream m_File;
+    std::unique_ptr<StreamingWorldIndex> m_Index;
+    StreamedEntityCodec m_Codec;
+
+    std::vector<Cell> m_Cells;
+    std::vector<Resource> m_Resources;
+    std::unordered_map<uint64_t, uint32_t> m_CellLookup;
+    // Bounds of the cells in the index, the search around the camera does not go past them
+    int32_t m_MinCellX;
+    int32_t m_MaxCellX;
+    int32_t m_MinCellZ;
+    int32_t m_MaxCellZ;
+    std::vector<Ecs::EntityID> m_PersistentEntities;
+    Ecs::EntityID m_MainCameraID;
+
+    // Cells that are not unloaded, and the ones that are wanted this frame (nearest first)
+    std::vector<uint32_t> m_ActiveCells;
+    std::vector<uint32_t> m_WantedCells;
+
+    ethVector3 m_CameraPosition;
+    uint64_t m_FrameIndex;
+    uint32_t m_Stamp;
+    uint32_t m_MaxStreamedEntities;
+    uint32_t m_NumCommittedEntities;
+
+    // Decided once, so that a resource is charged the same when it is loaded and when it is evicted
+    const bool m_AreTextureMipsStreamed;
+
+    // Loading and resident resources
+    size_t m_CommittedMemory;
+    // Evicted resources that have not been destroyed yet, and loads that were cancelled in flight
+    size_t m_ReleasingMemory;
+    std::deque<PendingRelease> m_PendingReleases;
+
+    std::vector<std::thread> m_LoaderThreads;
+    std::mutex m_Mutex;
+    std::condition_variable m_RequestCondition;
+    std::deque<LoadJob> m_Requests;
+    std::deque<LoadJob> m_CompletedLoads;
+    bool m_IsStopping;
+
+    WorldStreamingStats m_Stats;
+};
+} // namespace Ether
@@ -19,8 +19,14 @@
 
 #include "engine/world/world.h"
 #include "engine/world/ecs/components/ecscameracomponent.h"
+#include "engine/world/ecs/components/ecstransformcomponent.h"
+#include "engine/world/streaming/streamingworldwriter.h"
+#include "graphics/graphiccore.h"
 
-constexpr uint32_t WorldVersion = 0;
+// 0: Original format
+// 1: Sparse ECS and scene graph data (component arrays, entity signatures and scene graph
+//    nodes only store live entries). The versions of the nested objects tell the two apart.
+constexpr uint32_t WorldVersion = 1;
 
 Ether::World::World()
     : Serializable(WorldVersion, "Engine::World")
@@ -32,6 +38,19 @@ Ether::World::World()
 void Ether::World::Update()
 {
     ETH_MARKER_EVENT("World - Update");
+
+    // Before the systems run, so that cells which come and go this frame are picked up right away
+    if (m_Streamer != nullptr && m_MainCamera != nullptr)
+        m_Streamer->Update(m_MainCamera->GetComponent<Ecs::EcsTransformComponent>().m_Translation);
+
+    // Created on first use, since the graphic config is only final once the engine is running
+    if (m_TextureStreamer == nullptr && Graphics::Texture::IsMipStreamingEnabled())
+        m_TextureStreamer = std::make_unique<TextureStreamer>(*this, Graphics::GraphicCore::GetGraphicConfig().GetTextureStreamingBudget());
+
+    // Acts on the footprints that the visual system has requested during the last frame
+    if (m_TextureStreamer != nullptr)
+        m_TextureStreamer->Update();
+
     m_EcsManager.Update();
 }
 
@@ -62,6 +81,72 @@ void Ether::World::Load(const std::string& path)
 
 void Ether::World::Unload()
 {
+    m_Streamer.reset();
+    m_TextureStreamer.reset();
+
+    std::vector<Ecs::EntityID> entities;
+    for (auto& pair : m_Entities)
+        entities.push_back(pair.first);
+
+    for (Ecs::EntityID entityID : entities)
+        DestroyEntity(entityID);
+
+    m_EcsManager.GetEntityManager().Reset();
+
+    std::vector<std::shared_ptr<Graphics::Mesh>> meshes;
+    std::vector<std::shared_ptr<Graphics::Texture>> textures;
+    for (auto& pair : m_ResourceManager.m_Meshes)
+        meshes.push_back(std::move(pair.second));
+    for (auto& pair : m_ResourceManager.m_Textures)
+        textures.push_back(std::move(pair.second));
+
+    m_ResourceManager.m_Meshes.clear();
+    m_ResourceManager.m_Textures.clear();
+
+    if (meshes.empty() && textures.empty())
+        return;
+
+    // The frames in flight may still be using them
+    Graphics::GraphicCore::QueueRenderWork([meshes, textures]() {
+        if (!Graphics::GraphicCore::IsHeadless())
+            Graphics::GraphicCore::FlushGpu();
+
+        for (auto& mesh : meshes)
+            mesh->UnregisterShaderResourceViews();
+        for (auto& texture : textures)
+            texture->UnregisterShaderResourceView();
+    });
+}
+
+void Ether::World::SaveStreamed(const std::string& path, float cellSize)
+{
+    StreamingWorldWriter writer(*this, cellSize);
+    writer.Write(path);
+}
+
+void Ether::World::LoadStreamed(const std::string& path, const WorldStreamingParams& params)
+{
+    auto start = Time::GetRealTime();
+
+    Unload();
+
+    try
+    {
+        m_Streamer = std::make_unique<WorldStreamer>(*this, path, params);
+    }
+    catch (const std::exception& e)
+    {
+        LogEngineError("Failed to load streaming world %s: %s", path.c_str(), e.what());
+        Unload();
+        return;
+    }
+
+    m_WorldName = m_Streamer->GetWorldName();
+    if (m_Streamer->GetMainCameraID() != InvalidEntityID)
+        m_MainCamera = m_Entities.at(m_Streamer->GetMainCameraID()).get();
+
+    auto end = Time::GetRealTime();
+    LogInfo("Opening the streaming world took %f seconds", (end - start) / 1000.0f);
 }
 
 void Ether::World::Serialize(OStream& ostream) const
@@ -82,7 +167,7 @@ void Ether::World::Serialize(OStream& ostream) const
 
 void Ether::World::Deserialize(IStream& istream)
 {
-    Serializable::Deserialize(istream);
+    DeserializeVersioned(istream, 0);
     istream >> m_WorldName;
 
     m_SceneGraph.Deserialize(istream);
@@ -114,6 +199,20 @@ Ether::Entity& Ether::World::CreateEntity(const std::string& name)
     return *m_Entities[entityID];
 }
 
+void Ether::World::DestroyEntity(Ecs::EntityID entityID)
+{
+    m_EcsManager.DestroyEntity(entityID);
+
+    // The root node stays registered, even without an entity
+    if (entityID != RootEntityID && m_SceneGraph.IsRegistered(entityID))
+        m_SceneGraph.Deregister(entityID);
+
+    if (m_MainCamera != nullptr && m_MainCamera->GetID() == entityID)
+        m_MainCamera = nullptr;
+
+    m_Entities.erase(entityID);
+}
+
 Ether::Entity& Ether::World::CreateCamera()
 {
     if (m_MainCamera != nullptr)
@@ -24,6 +24,8 @@
 #include "engine/world/scenegraph.h"
 #include "engine/world/ecs/ecsmanager.h"
 #include "engine/world/resources/resourcemanager.h"
+#include "engine/world/streaming/texturestreamer.h"
+#include "engine/world/streaming/worldstreamer.h"
 
 namespace Ether
 {
@@ -37,8 +39,15 @@ public:
     void Update();
     void Save(const std::string& path) const;
     void Load(const std::string& path);
+    // Destroys every entity and releases the meshes and textures. Materials are kept, the visual
+    // batches hold on to them.
     void Unload();
 
+    // Splits the world into cells of cellSize units (see StreamingWorldIndex)
+    void SaveStreamed(const std::string& path, float cellSize);
+    // Only the persistent entities are loaded right away, cells follow the camera from then on
+    void LoadStreamed(const std::string& path, const WorldStreamingParams& params);
+
 public:
     inline std::string GetWorldName() const { return m_WorldName; }
     inline Entity& GetEntity(Ecs::EntityID entityID) const { return *m_Entities.at(entityID); }
@@ -46,18 +55,27 @@ public:
     inline ResourceManager& GetResourceManager() { return m_ResourceManager; }
     inline Ecs::EcsManager& GetEcsManager() { return m_EcsManager; }
     inline Entity* GetMainCamera() { return m_MainCamera; }
+    // nullptr unless the world was loaded with LoadStreamed()
+    inline WorldStreamer* GetStreamer() { return m_Streamer.get(); }
+    // nullptr unless texture mip streaming is enabled (see Graphics::Texture::IsMipStreamingEnabled())
+    inline TextureStreamer* GetTextureStreamer() { return m_TextureStreamer.get(); }
+    inline bool HasEntity(Ecs::EntityID entityID) const { return m_Entities.contains(entityID); }
+    inline uint32_t GetNumEntities() const { return static_cast<uint32_t>(m_Entities.size()); }
 
     inline void SetWorldName(const std::string& name) { m_WorldName = name; }
 
 public:
     Entity& CreateEntity(const std::string& name);
     Entity& CreateCamera();
+    void DestroyEntity(Ecs::EntityID entityID);
 
 private:
     void Serialize(OStream& ostream) const override;
     void Deserialize(IStream& istream) override;
 
 private:
+    friend class StreamingWorldWriter;
+
     std::string m_WorldName;
 
     SceneGraph m_SceneGraph;
@@ -67,6 +85,12 @@ private:
     std::unordered_map<Ecs::EntityID, std::unique_ptr<Entity>> m_Entities;
 
     Entity* m_MainCamera;
+
+    // Destroyed before the resource manager, whose textures it refers to
+    std::unique_ptr<TextureStreamer> m_TextureStreamer;
+
+    // Last, so that the loader threads are stopped before anything they refer to is destroyed
+    std::unique_ptr<WorldStreamer> m_Streamer;
 };
 
 } // namespace Ether
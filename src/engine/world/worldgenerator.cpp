@@ -0,0 +1,403 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/world/worldgenerator.h"
+#include "engine/world/world.h"
+#include "engine/world/ecs/components/ecstransformcomponent.h"
+#include "engine/world/ecs/components/ecsvisualcomponent.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <numbers>
+
+static std::string ToLower(std::string str)
+{
+    for (char& c : str)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return str;
+}
+
+static bool ParseUint(const std::string& str, uint32_t& out)
+{
+    char* end = nullptr;
+    const unsigned long value = std::strtoul(str.c_str(), &end, 10);
+    if (str.empty() || *end != '\0' || str[0] == '-')
+        return false;
+
+    out = static_cast<uint32_t>(value);
+    return true;
+}
+
+static bool ParseFloat(const std::string& str, float& out)
+{
+    char* end = nullptr;
+    const float value = std::strtof(str.c_str(), &end);
+    if (str.empty() || *end != '\0')
+        return false;
+
+    out = value;
+    return true;
+}
+
+bool Ether::WorldGeneratorParams::SetParam(const std::string& name, const std::string& value)
+{
+    const std::string key = ToLower(name);
+
+    if (key == "seed")
+        return ParseUint(value, m_Seed);
+    if (key == "entities")
+        return ParseUint(value, m_NumEntities) && m_NumEntities > 1;
+    if (key == "hierarchydepth")
+        return ParseUint(value, m_HierarchyDepth) && m_HierarchyDepth > 0;
+    if (key == "hierarchybranching")
+        return ParseUint(value, m_HierarchyBranching) && m_HierarchyBranching > 0;
+    if (key == "meshes")
+        return ParseUint(value, m_NumMeshes) && m_NumMeshes > 0;
+    if (key == "materials")
+        return ParseUint(value, m_NumMaterials) && m_NumMaterials > 0;
+    if (key == "textures")
+        return ParseUint(value, m_NumTextures);
+    if (key == "texturesize")
+    {
+        // Mips are only generated for power of 2 sizes
+        return ParseUint(value, m_TextureSize) && m_TextureSize > 0 && m_TextureSize <= Graphics::MaxTextureSize &&
+               (m_TextureSize & (m_TextureSize - 1)) == 0;
+    }
+    if (key == "clusters")
+        return ParseUint(value, m_NumClusters) && m_NumClusters > 0;
+    if (key == "spacing")
+        return ParseFloat(value, m_Spacing) && m_Spacing > 0.0f;
+    if (key == "instanceskew")
+        return ParseFloat(value, m_InstanceSkew) && m_InstanceSkew >= 0.0f;
+    if (key == "placement")
+    {
+        const std::string placement = ToLower(value);
+        if (placement == "grid")
+            m_Placement = WorldPlacement::Grid;
+        else if (placement == "random")
+            m_Placement = WorldPlacement::Random;
+        else if (placement == "clustered")
+            m_Placement = WorldPlacement::Clustered;
+        else
+            return false;
+
+        return true;
+    }
+
+    return false;
+}
+
+Ether::WorldGenerator::WorldGenerator(const WorldGeneratorParams& params)
+    : m_Params(params)
+    , m_Random(params.m_Seed)
+    , m_Extent(0.0f)
+{
+}
+
+void Ether::WorldGenerator::Generate(World& world)
+{
+    ETH_MARKER_EVENT("World Generator - Generate");
+
+    const uint32_t numEntities = (std::min)(m_Params.m_NumEntities, Ecs::MaxNumEntities - 1);
+    if (numEntities != m_Params.m_NumEntities)
+        LogEngineWarning("World generator: Entity count clamped to %u", numEntities);
+
+    m_Random.seed(m_Params.m_Seed);
+    m_Extent = 0.0f;
+    m_VisualEntities.clear();
+
+    const std::vector<StringID> textures = GenerateTextures(world);
+    const std::vector<StringID> materials = GenerateMaterials(world, textures);
+    const std::vector<StringID> meshes = GenerateMeshes(world);
+
+    // The first entity of an empty world takes the id of the scene graph root
+    SceneGraph& sceneGraph = world.GetSceneGraph();
+    const Ecs::EntityID root = world.CreateEntity("Generated World").GetID();
+    if (root != RootEntityID)
+        sceneGraph.Register(root);
+
+    uint32_t numGroups = 0;
+    const std::vector<Ecs::EntityID> parents = GenerateHierarchy(world, root, numEntities - 2, numGroups);
+    const uint32_t numVisuals = numEntities - 1 - numGroups;
+
+    std::vector<ethVector3> clusters;
+    if (m_Params.m_Placement == WorldPlacement::Clustered)
+    {
+        const float halfSize = std::sqrt(static_cast<float>(numVisuals)) * m_Params.m_Spacing * 0.5f;
+        for (uint32_t i = 0; i < m_Params.m_NumClusters; ++i)
+            clusters.push_back({ NextFloat(-halfSize, halfSize), 0.0f, NextFloat(-halfSize, halfSize) });
+    }
+
+    const std::vector<float> meshDistribution = CreateSkewedDistribution(static_cast<uint32_t>(meshes.size()));
+    const std::vector<float> materialDistribution = CreateSkewedDistribution(static_cast<uint32_t>(materials.size()));
+
+    for (uint32_t i = 0; i < numVisuals; ++i)
+    {
+        Entity& entity = world.CreateEntity(std::format("Generated Visual {}", i));
+        // Contiguous ranges, so that siblings are also spatial neighbours in grid placement
+        sceneGraph.Register(entity.GetID(), parents[static_cast<uint64_t>(i) * parents.size() / numVisuals]);
+
+        // The engine does not propagate transforms through the scene graph, so these are world space
+        Ecs::EcsTransformComponent& transform = entity.GetComponent<Ecs::EcsTransformComponent>();
+        transform.m_Translation = GeneratePosition(i, numVisuals, clusters);
+        transform.m_Rotation = { 0.0f, NextFloat(0.0f, 2.0f * std::numbers::pi_v<float>), 0.0f };
+
+        const float scale = NextFloat(0.5f, 1.5f);
+        transform.m_Scale = { scale, scale, scale };
+        entity.MarkModified<Ecs::EcsTransformComponent>();
+
+        Ecs::EcsVisualComponent& visual = entity.AddComponent<Ecs::EcsVisualComponent>();
+        visual.m_MeshGuid = meshes[Sample(meshDistribution)];
+        visual.m_MaterialGuid = materials[Sample(materialDistribution)];
+        entity.MarkModified<Ecs::EcsVisualComponent>();
+
+        const float distance = std::sqrt(
+            transform.m_Translation.x * transform.m_Translation.x +
+            transform.m_Translation.z * transform.m_Translation.z);
+        m_Extent = (std::max)(m_Extent, distance);
+        m_VisualEntities.push_back(entity.GetID());
+    }
+
+    m_Extent += m_Params.m_Spacing;
+
+    LogEngineInfo(
+        "World generator: Generated %u visuals in %u groups, %zu meshes, %zu materials and %zu textures (seed %u)",
+        numVisuals,
+        numGroups,
+        meshes.size(),
+        materials.size(),
+        textures.size(),
+        m_Params.m_Seed);
+}
+
+std::vector<Ether::StringID> Ether::WorldGenerator::GenerateTextures(World& world)
+{
+    const uint32_t size = m_Params.m_TextureSize;
+    std::vector<StringID> textures;
+
+    for (uint32_t i = 0; i < m_Params.m_NumTextures; ++i)
+    {
+        auto texture = std::make_unique<Graphics::Texture>();
+        texture->SetName(std::format("Generated Texture {}", i).c_str());
+        texture->SetFormat(Graphics::RhiFormat::R8G8B8A8UnormSrgb);
+        texture->SetWidth(size);
+        texture->SetHeight(size);
+
+        const uint32_t colorA = m_Random() | 0xff000000;
+        const uint32_t colorB = m_Random() | 0xff000000;
+        const uint32_t cellSize = (std::max)(1u, size >> (1 + m_Random() % 4));
+
+        std::vector<uint32_t> data(static_cast<size_t>(size) * size);
+        for (uint32_t y = 0; y < size; ++y)
+            for (uint32_t x = 0; x < size; ++x)
+                data[y * size + x] = ((x / cellSize + y / cellSize) % 2) ? colorA : colorB;
+
+        texture->SetData(reinterpret_cast<const unsigned char*>(data.data()), true);
+        textures.push_back(world.GetResourceManager().RegisterTextureResource(std::move(texture)));
+    }
+
+    return textures;
+}
+
+std::vector<Ether::StringID> Ether::WorldGenerator::GenerateMaterials(World& world, const std::vector<StringID>& textures)
+{
+    std::vector<StringID> materials;
+
+    for (uint32_t i = 0; i < m_Params.m_NumMaterials; ++i)
+    {
+        auto material = std::make_unique<Graphics::Material>();
+        material->SetBaseColor({ NextFloat(0.1f, 1.0f), NextFloat(0.1f, 1.0f), NextFloat(0.1f, 1.0f), 1.0f });
+        material->SetSpecularColor({ 0.5f, 0.5f, 0.5f, 0.5f });
+
+        if (!textures.empty())
+            material->SetAlbedoTextureID(textures[i % textures.size()]);
+
+        materials.push_back(world.GetResourceManager().RegisterMaterialResource(std::move(material)));
+    }
+
+    return materials;
+}
+
+std::vector<Ether::StringID> Ether::WorldGenerator::GenerateMeshes(World& world)
+{
+    std::vector<StringID> meshes;
+
+    for (uint32_t i = 0; i < m_Params.m_NumMeshes; ++i)
+    {
+        const ethVector3 halfExtents = { NextFloat(0.25f, 1.5f), NextFloat(0.25f, 1.5f), NextFloat(0.25f, 1.5f) };
+        meshes.push_back(world.GetResourceManager().RegisterMeshResource(CreateBoxMesh(halfExtents)));
+    }
+
+    return meshes;
+}
+
+std::vector<Ether::Ecs::EntityID> Ether::WorldGenerator::GenerateHierarchy(
+    World& world,
+    Ecs::EntityID root,
+    uint32_t maxNumGroups,
+    uint32_t& numGroups)
+{
+    std::vector<Ecs::EntityID> level = { root };
+
+    for (uint32_t depth = 1; depth < m_Params.m_HierarchyDepth; ++depth)
+    {
+        const uint32_t levelSize = static_cast<uint32_t>(level.size()) * m_Params.m_HierarchyBranching;
+        if (numGroups + levelSize > maxNumGroups)
+        {
+            LogEngineWarning("World generator: Not enough entities for a hierarchy deeper than %u levels", depth);
+            break;
+        }
+
+        std::vector<Ecs::EntityID> nextLevel;
+        for (uint32_t i = 0; i < levelSize; ++i)
+        {
+            const Ecs::EntityID group = world.CreateEntity(std::format("Generated Group {}.{}", depth, i)).GetID();
+            world.GetSceneGraph().Register(group, level[i / m_Params.m_HierarchyBranching]);
+            nextLevel.push_back(group);
+        }
+
+        numGroups += levelSize;
+        level = std::move(nextLevel);
+    }
+
+    return level;
+}
+
+Ether::ethVector3 Ether::WorldGenerator::GeneratePosition(
+    uint32_t index,
+    uint32_t numVisuals,
+    const std::vector<ethVector3>& clusters)
+{
+    const float spacing = m_Params.m_Spacing;
+
+    switch (m_Params.m_Placement)
+    {
+    case WorldPlacement::Random:
+    {
+        const float halfSize = std::sqrt(static_cast<float>(numVisuals)) * spacing * 0.5f;
+        return { NextFloat(-halfSize, halfSize), NextFloat(0.0f, spacing), NextFloat(-halfSize, halfSize) };
+    }
+    case WorldPlacement::Clustered:
+    {
+        const ethVector3& center = clusters[m_Random() % clusters.size()];
+        const float radius = std::sqrt(static_cast<float>(numVisuals) / clusters.size()) * spacing * 0.5f;
+
+        // Sum of uniforms, a cheap and portable stand-in for a normal distribution
+        const float x = NextFloat(-0.5f, 0.5f) + NextFloat(-0.5f, 0.5f) + NextFloat(-0.5f, 0.5f);
+        const float z = NextFloat(-0.5f, 0.5f) + NextFloat(-0.5f, 0.5f) + NextFloat(-0.5f, 0.5f);
+        return { center.x + x * radius, NextFloat(0.0f, spacing), center.z + z * radius };
+    }
+    case WorldPlacement::Grid:
+    default:
+    {
+        const uint32_t gridSize = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(numVisuals))));
+        const float offset = (gridSize - 1) * spacing * 0.5f;
+        const float jitter = spacing * 0.25f;
+        return {
+            (index % gridSize) * spacing - offset + NextFloat(-jitter, jitter),
+            NextFloat(0.0f, spacing),
+            (index / gridSize) * spacing - offset + NextFloat(-jitter, jitter),
+        };
+    }
+    }
+}
+
+std::unique_ptr<Ether::Graphics::Mesh> Ether::WorldGenerator::CreateBoxMesh(const ethVector3& halfExtents) const
+{
+    using Vertex = Graphics::VertexFormats::PositionNormalTangentTexcoord;
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    // One face per axis direction, each with its own vertices so that normals stay flat
+    for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+        for (float sign : { 1.0f, -1.0f })
+        {
+            ethVector3 normal = { 0.0f, 0.0f, 0.0f };
+            ethVector3 tangent = { 0.0f, 0.0f, 0.0f };
+            ethVector3 bitangent = { 0.0f, 0.0f, 0.0f };
+            normal.m_Data[axis] = sign;
+            tangent.m_Data[(axis + 1) % 3] = 1.0f;
+            bitangent.m_Data[(axis + 2) % 3] = sign;
+
+            const uint32_t baseIndex = static_cast<uint32_t>(vertices.size());
+
+            for (uint32_t corner = 0; corner < 4; ++corner)
+            {
+                const float u = (corner == 1 || corner == 2) ? 1.0f : 0.0f;
+                const float v = (corner >= 2) ? 1.0f : 0.0f;
+
+                Vertex vertex;
+                for (uint32_t c = 0; c < 3; ++c)
+                {
+                    const float position = normal.m_Data[c] + tangent.m_Data[c] * (u * 2.0f - 1.0f) +
+                                           bitangent.m_Data[c] * (v * 2.0f - 1.0f);
+                    vertex.m_Position.m_Data[c] = position * halfExtents.m_Data[c];
+                }
+
+                vertex.m_Normal = normal;
+                vertex.m_Tangent = tangent;
+                vertex.m_TexCoord = { u, v };
+                vertices.push_back(vertex);
+            }
+
+            for (uint32_t index : { 0u, 1u, 2u, 0u, 2u, 3u })
+                indices.push_back(baseIndex + index);
+        }
+    }
+
+    auto mesh = std::make_unique<Graphics::Mesh>();
+    mesh->SetPackedVertices(std::move(vertices));
+    mesh->SetIndices(std::move(indices));
+    return mesh;
+}
+
+std::vector<float> Ether::WorldGenerator::CreateSkewedDistribution(uint32_t numItems) const
+{
+    std::vector<float> cumulative(numItems);
+    float total = 0.0f;
+
+    for (uint32_t i = 0; i < numItems; ++i)
+    {
+        total += 1.0f / std::pow(static_cast<float>(i + 1), m_Params.m_InstanceSkew);
+        cumulative[i] = total;
+    }
+
+    for (float& value : cumulative)
+        value /= total;
+
+    return cumulative;
+}
+
+uint32_t Ether::WorldGenerator::Sample(const std::vector<float>& distribution)
+{
+    const float value = NextFloat(0.0f, 1.0f);
+    const auto it = std::upper_bound(distribution.begin(), distribution.end(), value);
+    return static_cast<uint32_t>((std::min)(it - distribution.begin(), static_cast<ptrdiff_t>(distribution.size() - 1)));
+}
+
+float Ether::WorldGenerator::NextFloat(float min, float max)
+{
+    // Top 24 bits map exactly onto the float mantissa
+    return min + (max - min) * ((m_Random() >> 8) * (1.0f / 16777216.0f));
+}
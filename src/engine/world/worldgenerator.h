@@ -0,0 +1,108 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "engine/pch.h"
+#include "engine/world/ecs/ecstypes.h"
+#include "graphics/resources/mesh.h"
+#include "graphics/resources/texture.h"
+
+#include <random>
+
+namespace Ether
+{
+class World;
+
+enum class WorldPlacement : uint8_t
+{
+    Grid,
+    Random,
+    Clustered,
+};
+
+struct ETH_ENGINE_DLL WorldGeneratorParams
+{
+    uint32_t m_Seed = 1;
+
+    // Includes the group entities that make up the hierarchy. One entity is always left free for a camera.
+    uint32_t m_NumEntities = 2048;
+    // Levels of group entities above the visuals in the scene graph (1 = every visual is a child of the root)
+    uint32_t m_HierarchyDepth = 1;
+    uint32_t m_HierarchyBranching = 8;
+
+    uint32_t m_NumMeshes = 8;
+    uint32_t m_NumMaterials = 16;
+    uint32_t m_NumTextures = 0;
+    uint32_t m_TextureSize = 256;
+
+    WorldPlacement m_Placement = WorldPlacement::Grid;
+    uint32_t m_NumClusters = 16;
+    float m_Spacing = 4.0f;
+
+    // How unevenly instances are spread over the meshes and materials. Zipf exponent, 0 is uniform.
+    float m_InstanceSkew = 0.0f;
+
+    // Sets a parameter from its config file name (e.g. "entities", "placement"). Returns false if
+    // the key is unknown or the value is invalid.
+    bool SetParam(const std::string& name, const std::string& value);
+};
+
+/*
+    Builds synthetic world content of a controlled size, through the same ECS and resource
+    manager APIs that the importer uses, for scale and stress testing. The result can be
+    saved with World::Save like any other world.
+
+    Only raw std::mt19937 output is used (the standard distributions are implementation defined),
+    so the same parameters produce the same world on every platform and standard library.
+*/
+class ETH_ENGINE_DLL WorldGenerator : public NonCopyable, public NonMovable
+{
+public:
+    WorldGenerator(const WorldGeneratorParams& params);
+    ~WorldGenerator() = default;
+
+public:
+    void Generate(World& world);
+
+    // Radius of a circle (on the XZ plane, around the origin) that contains every visual
+    inline float GetExtent() const { return m_Extent; }
+    inline const std::vector<Ecs::EntityID>& GetVisualEntities() const { return m_VisualEntities; }
+
+private:
+    std::vector<StringID> GenerateTextures(World& world);
+    std::vector<StringID> GenerateMaterials(World& world, const std::vector<StringID>& textures);
+    std::vector<StringID> GenerateMeshes(World& world);
+    std::vector<Ecs::EntityID> GenerateHierarchy(World& world, Ecs::EntityID root, uint32_t maxNumGroups, uint32_t& numGroups);
+    ethVector3 GeneratePosition(uint32_t index, uint32_t numVisuals, const std::vector<ethVector3>& clusters);
+
+    std::unique_ptr<Graphics::Mesh> CreateBoxMesh(const ethVector3& halfExtents) const;
+    std::vector<float> CreateSkewedDistribution(uint32_t numItems) const;
+    uint32_t Sample(const std::vector<float>& distribution);
+
+    float NextFloat(float min, float max);
+
+private:
+    WorldGeneratorParams m_Params;
+    std::mt19937 m_Random;
+    float m_Extent;
+
+    std::vector<Ecs::EntityID> m_VisualEntities;
+};
+} // namespace Ether
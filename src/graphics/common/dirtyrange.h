@@ -0,0 +1,38 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include <algorithm>
+
+namespace Ether::Graphics
+{
+// Range of slots [begin, end) in an array that has changed since it was last consumed
+struct ETH_GRAPHIC_DLL DirtyRange
+{
+    uint32_t m_Begin = std::numeric_limits<uint32_t>::max();
+    uint32_t m_End = 0;
+
+    inline bool IsEmpty() const { return m_Begin >= m_End; }
+    inline void Add(uint32_t index) { Add(index, index + 1); }
+    inline void Add(uint32_t begin, uint32_t end) { m_Begin = (std::min)(m_Begin, begin); m_End = (std::max)(m_End, end); }
+    inline void Clear() { *this = {}; }
+};
+} // namespace Ether::Graphics
@@ -0,0 +1,58 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/common/instancebatcher.h"
+#include "graphics/resources/material.h"
+#include <algorithm>
+
+void Ether::Graphics::InstanceBatcher::Build(const std::vector<Visual>& visuals)
+{
+    ETH_MARKER_EVENT("Instance Batcher - Build");
+
+    // The vectors are kept around between frames so that their capacity is reused
+    m_SortEntries.clear();
+    m_Draws.clear();
+    m_Instances.clear();
+
+    for (uint32_t i = 0; i < visuals.size(); ++i)
+    {
+        const Visual& visual = visuals[i];
+        if (visual.m_Culled)
+            continue;
+
+        m_SortEntries.push_back({ visual.m_Mesh, visual.m_Material->GetTransientMaterialIdx(), i });
+    }
+
+    std::sort(m_SortEntries.begin(), m_SortEntries.end(), [](const SortEntry& a, const SortEntry& b)
+    {
+        if (a.m_Mesh != b.m_Mesh)
+            return std::less<Mesh*>()(a.m_Mesh, b.m_Mesh);
+
+        return a.m_MaterialIdx < b.m_MaterialIdx;
+    });
+
+    for (const SortEntry& entry : m_SortEntries)
+    {
+        if (m_Draws.empty() || m_Draws.back().m_Mesh != entry.m_Mesh)
+            m_Draws.push_back({ entry.m_Mesh, static_cast<uint32_t>(m_Instances.size()), 0 });
+
+        m_Draws.back().m_NumInstances++;
+        m_Instances.push_back(entry.m_VisualIdx);
+    }
+}
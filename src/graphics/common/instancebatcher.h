@@ -0,0 +1,64 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "graphics/common/visual.h"
+
+namespace Ether::Graphics
+{
+struct InstancedDraw
+{
+    Mesh* m_Mesh;
+    uint32_t m_FirstInstance;
+    uint32_t m_NumInstances;
+};
+
+// Sorts visuals by (mesh, material) so that all instances of a mesh end up next to each other,
+// and emits one instanced draw per unique mesh. All geometry currently goes through a single
+// g-buffer pipeline state, which is why it is not part of the sort key (yet).
+// Instances are indices into the visuals, so that a batch stays valid for every copy of the same
+// visuals (see RenderDataBuffer), not just for the vector it was built from.
+class ETH_GRAPHIC_DLL InstanceBatcher : public NonCopyable, public NonMovable
+{
+public:
+    InstanceBatcher() = default;
+    ~InstanceBatcher() = default;
+
+public:
+    inline const std::vector<InstancedDraw>& GetDraws() const { return m_Draws; }
+    inline const std::vector<uint32_t>& GetInstances() const { return m_Instances; }
+
+public:
+    void Build(const std::vector<Visual>& visuals);
+
+private:
+    struct SortEntry
+    {
+        Mesh* m_Mesh;
+        uint32_t m_MaterialIdx;
+        uint32_t m_VisualIdx;
+    };
+
+    std::vector<SortEntry> m_SortEntries;
+    std::vector<InstancedDraw> m_Draws;
+    std::vector<uint32_t> m_Instances;
+};
+} // namespace Ether::Graphics
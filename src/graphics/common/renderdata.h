@@ -20,7 +20,9 @@
 #pragma once
 
 #include "graphics/pch.h"
+#include "graphics/common/dirtyrange.h"
 #include "graphics/common/visualbatch.h"
+#include <functional>
 
 namespace Ether::Graphics
 {
@@ -35,7 +37,17 @@ public:
 
     StringID m_HdriTextureID;
 
+    // Maintained incrementally by the ECS. Slots are stable, except that removing a visual moves the last one into its place.
     std::vector<Visual> m_Visuals;
     std::vector<VisualBatch> m_VisualBatches;
+
+    // Bumped whenever anything in m_Visuals changes (including culling results), so that consumers can skip redundant work
+    uint64_t m_VisualsVersion = 0;
+
+    // Material slots that still have to be uploaded to the material table
+    DirtyRange m_DirtyMaterials;
+
+    // Executed before the frame is rendered (see GraphicCore::QueueRenderWork())
+    std::vector<std::function<void()>> m_RenderWork;
 };
 } // namespace Ether::Graphics
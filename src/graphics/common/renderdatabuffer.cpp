@@ -0,0 +1,95 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/common/renderdatabuffer.h"
+
+void Ether::Graphics::RenderDataBuffer::Publish()
+{
+    ETH_MARKER_EVENT("Render Data - Publish");
+
+    // The writer's slot is not visible to the renderer, so it can be filled without the lock
+    CopyFrame(m_WriteData, m_Slots[m_WriteIdx]);
+
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_FrameAcquired.wait(lock, [this]() { return !m_HasPublishedFrame || m_IsClosed; });
+
+        if (m_IsClosed)
+            return;
+
+        std::swap(m_WriteIdx, m_PublishedIdx);
+        m_HasPublishedFrame = true;
+    }
+
+    m_FramePublished.notify_one();
+
+    // Materials are only uploaded once, so every dirty range has to reach the renderer exactly once
+    m_WriteData.m_DirtyMaterials.Clear();
+}
+
+bool Ether::Graphics::RenderDataBuffer::Acquire()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_FramePublished.wait(lock, [this]() { return m_HasPublishedFrame || m_IsClosed; });
+
+    if (!m_HasPublishedFrame)
+        return false;
+
+    std::swap(m_ReadIdx, m_PublishedIdx);
+    m_HasPublishedFrame = false;
+    m_FrameAcquired.notify_one();
+    return true;
+}
+
+void Ether::Graphics::RenderDataBuffer::Close()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_IsClosed = true;
+    m_FramePublished.notify_all();
+    m_FrameAcquired.notify_all();
+}
+
+void Ether::Graphics::RenderDataBuffer::Reopen()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_IsClosed = false;
+    m_HasPublishedFrame = false;
+}
+
+void Ether::Graphics::RenderDataBuffer::CopyFrame(RenderData& src, RenderData& dst)
+{
+    dst.m_ViewMatrix = src.m_ViewMatrix;
+    dst.m_ProjectionMatrix = src.m_ProjectionMatrix;
+    dst.m_CameraDirection = src.m_CameraDirection;
+    dst.m_CameraPosition = src.m_CameraPosition;
+    dst.m_CameraJitter = src.m_CameraJitter;
+    dst.m_HdriTextureID = src.m_HdriTextureID;
+    dst.m_VisualBatches = src.m_VisualBatches;
+    dst.m_DirtyMaterials = src.m_DirtyMaterials;
+
+    // The slot's own work was executed when it was last rendered
+    std::swap(dst.m_RenderWork, src.m_RenderWork);
+
+    // The slot still holds the visuals of three frames ago, which in a static scene are the same
+    if (dst.m_VisualsVersion != src.m_VisualsVersion)
+    {
+        dst.m_Visuals = src.m_Visuals;
+        dst.m_VisualsVersion = src.m_VisualsVersion;
+    }
+}
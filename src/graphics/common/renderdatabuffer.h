@@ -0,0 +1,79 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "graphics/common/renderdata.h"
+#include <condition_variable>
+#include <mutex>
+
+namespace Ether::Graphics
+{
+/*
+    Hands RenderData over from the simulation to the renderer when the two run on separate threads
+    (see GraphicCore::StartRenderThread()).
+
+    The simulation keeps building the next frame in GetWriteData(), which persists from frame to
+    frame since the ECS maintains it incrementally. Publish() copies it into one of three slots and
+    hands that slot over, and the renderer switches to it with Acquire(). The writer's slot, the
+    published slot and the reader's slot are always distinct, and only ever swapped under the lock,
+    so the renderer can never observe a frame that is still being written.
+
+    Publishing waits while the previous frame has not been picked up yet. The simulation can
+    therefore run one frame ahead of the renderer, but no frame is ever skipped.
+*/
+class ETH_GRAPHIC_DLL RenderDataBuffer : public NonCopyable, public NonMovable
+{
+public:
+    RenderDataBuffer() = default;
+    ~RenderDataBuffer() = default;
+
+public:
+    // Simulation side
+    inline RenderData& GetWriteData() { return m_WriteData; }
+    void Publish();
+
+    // Render side. Returns false once the buffer is closed and there is nothing left to render.
+    bool Acquire();
+    inline RenderData& GetReadData() { return m_Slots[m_ReadIdx]; }
+
+    // Releases both sides, so that a render thread can be shut down
+    void Close();
+    void Reopen();
+
+private:
+    // Render work is moved rather than copied, it has to run exactly once
+    static void CopyFrame(RenderData& src, RenderData& dst);
+
+private:
+    RenderData m_WriteData;
+    RenderData m_Slots[3];
+
+    uint32_t m_WriteIdx = 0;
+    uint32_t m_PublishedIdx = 1;
+    uint32_t m_ReadIdx = 2;
+    bool m_HasPublishedFrame = false;
+    bool m_IsClosed = false;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_FramePublished;
+    std::condition_variable m_FrameAcquired;
+};
+} // namespace Ether::Graphics
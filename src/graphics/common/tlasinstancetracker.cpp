@@ -0,0 +1,88 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/common/tlasinstancetracker.h"
+
+Ether::Graphics::TlasInstanceTracker::TlasInstanceTracker()
+    : m_NumRefitsSinceRebuild(0)
+    , m_IsInvalidated(true)
+{
+}
+
+Ether::Graphics::TlasUpdateType Ether::Graphics::TlasInstanceTracker::Update(
+    const RhiRaytracingInstanceDesc* instances,
+    uint32_t numInstances)
+{
+    bool requiresRebuild = m_IsInvalidated || numInstances != m_Instances.size();
+
+    for (uint32_t i = 0; i < numInstances && !requiresRebuild; ++i)
+        requiresRebuild = !IsSameBlas(instances[i], m_Instances[i]);
+
+    if (requiresRebuild)
+    {
+        m_Instances.assign(instances, instances + numInstances);
+        m_DirtyRange.Add(0, numInstances);
+        m_NumRefitsSinceRebuild = 0;
+        m_IsInvalidated = false;
+        return TlasUpdateType::Rebuild;
+    }
+
+    bool hasChanged = false;
+
+    for (uint32_t i = 0; i < numInstances; ++i)
+    {
+        if (IsSameInstance(instances[i], m_Instances[i]))
+            continue;
+
+        m_Instances[i] = instances[i];
+        m_DirtyRange.Add(i);
+        hasChanged = true;
+    }
+
+    if (!hasChanged)
+        return TlasUpdateType::None;
+
+    if (++m_NumRefitsSinceRebuild > MaxRefitsBeforeRebuild)
+    {
+        m_NumRefitsSinceRebuild = 0;
+        return TlasUpdateType::Rebuild;
+    }
+
+    return TlasUpdateType::Refit;
+}
+
+void Ether::Graphics::TlasInstanceTracker::Invalidate()
+{
+    m_IsInvalidated = true;
+}
+
+bool Ether::Graphics::TlasInstanceTracker::IsSameBlas(const RhiRaytracingInstanceDesc& a, const RhiRaytracingInstanceDesc& b)
+{
+    // Instance flags are baked into the BVH as well, so they are treated like a BLAS change
+    return a.m_AccelerationStructure == b.m_AccelerationStructure && a.m_Flags == b.m_Flags;
+}
+
+bool Ether::Graphics::TlasInstanceTracker::IsSameInstance(const RhiRaytracingInstanceDesc& a, const RhiRaytracingInstanceDesc& b)
+{
+    return IsSameBlas(a, b) &&
+           a.m_InstanceID == b.m_InstanceID &&
+           a.m_InstanceMask == b.m_InstanceMask &&
+           a.m_InstanceContributionToHitGroupIndex == b.m_InstanceContributionToHitGroupIndex &&
+           std::memcmp(a.m_Transform, b.m_Transform, sizeof(a.m_Transform)) == 0;
+}
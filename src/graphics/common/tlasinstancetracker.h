@@ -0,0 +1,72 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "graphics/common/dirtyrange.h"
+#include "graphics/rhi/rhitypes.h"
+
+namespace Ether::Graphics
+{
+enum class TlasUpdateType
+{
+    None,
+    Refit,
+    Rebuild,
+};
+
+// Keeps the last set of TLAS instances around and works out the cheapest way to bring the TLAS up to date
+// with a new set. Changing only transforms, masks or instance IDs can be handled with a refit, while adding,
+// removing or swapping the BLAS of an instance requires a full rebuild. This class does not touch the GPU.
+class ETH_GRAPHIC_DLL TlasInstanceTracker : public NonCopyable, public NonMovable
+{
+public:
+    TlasInstanceTracker();
+    ~TlasInstanceTracker() = default;
+
+public:
+    inline const std::vector<RhiRaytracingInstanceDesc>& GetInstances() const { return m_Instances; }
+    inline uint32_t GetNumInstances() const { return static_cast<uint32_t>(m_Instances.size()); }
+
+    // Instances that changed since ClearDirtyRange() was last called, and have to be uploaded again
+    inline const DirtyRange& GetDirtyRange() const { return m_DirtyRange; }
+    inline void ClearDirtyRange() { m_DirtyRange.Clear(); }
+
+public:
+    TlasUpdateType Update(const RhiRaytracingInstanceDesc* instances, uint32_t numInstances);
+
+    // Forces the next update to be a rebuild (e.g. after the acceleration structure was recreated)
+    void Invalidate();
+
+private:
+    static bool IsSameBlas(const RhiRaytracingInstanceDesc& a, const RhiRaytracingInstanceDesc& b);
+    static bool IsSameInstance(const RhiRaytracingInstanceDesc& a, const RhiRaytracingInstanceDesc& b);
+
+private:
+    // Refits degrade the quality of the BVH as instances move away from where they were built
+    static constexpr uint32_t MaxRefitsBeforeRebuild = 120;
+
+    std::vector<RhiRaytracingInstanceDesc> m_Instances;
+    DirtyRange m_DirtyRange;
+
+    uint32_t m_NumRefitsSinceRebuild;
+    bool m_IsInvalidated;
+};
+} // namespace Ether::Graphics
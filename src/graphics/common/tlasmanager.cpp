@@ -0,0 +1,137 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/common/tlasmanager.h"
+#include "graphics/graphiccore.h"
+#include "graphics/resources/mesh.h"
+#include "graphics/resources/material.h"
+#include "graphics/shaders/common/raytracingconstants.h"
+
+Ether::Graphics::TlasManager::TlasManager()
+    : m_MaxInstances(0)
+    , m_VisualsVersion(std::numeric_limits<uint64_t>::max())
+{
+}
+
+void Ether::Graphics::TlasManager::Update(CommandContext& ctx, UploadRingBuffer& uploadAllocator, const RenderData& renderData)
+{
+    ETH_MARKER_EVENT("TLAS Manager - Update");
+
+    ReleaseStaleAccelerationStructures();
+
+    // The version also changes with culling results, which the TLAS does not care about. Those frames
+    // cost a diff of the instances, but static scenes skip the TLAS entirely.
+    if (m_AccelerationStructure != nullptr && renderData.m_VisualsVersion == m_VisualsVersion)
+        return;
+
+    m_VisualsVersion = renderData.m_VisualsVersion;
+    GatherInstances(renderData.m_Visuals);
+
+    const uint32_t numInstances = static_cast<uint32_t>(m_GatheredInstances.size());
+    if (m_AccelerationStructure == nullptr || numInstances > m_MaxInstances)
+        RecreateAccelerationStructure(numInstances);
+
+    const TlasUpdateType updateType = m_InstanceTracker.Update(m_GatheredInstances.data(), numInstances);
+    if (updateType == TlasUpdateType::None)
+        return;
+
+    UploadDirtyInstances(ctx, uploadAllocator);
+
+    ctx.PushMarker(updateType == TlasUpdateType::Refit ? "Refit TLAS" : "Build TLAS");
+    ctx.TransitionResource(*m_AccelerationStructure->m_InstanceDescBuffer, RhiResourceState::GenericRead);
+    ctx.TransitionResource(*m_AccelerationStructure->m_ScratchBuffer, RhiResourceState::UnorderedAccess);
+    ctx.BuildTopLevelAccelerationStructure(*m_AccelerationStructure, numInstances, updateType == TlasUpdateType::Refit);
+    ctx.PopMarker();
+}
+
+void Ether::Graphics::TlasManager::GatherInstances(const std::vector<Visual>& visuals)
+{
+    m_GatheredInstances.resize(visuals.size());
+
+    for (uint32_t i = 0; i < visuals.size(); ++i)
+    {
+        const Visual& visual = visuals[i];
+        const ethVector4 emissiveColor = visual.m_Material->GetEmissiveColor();
+        const bool isEmissive = emissiveColor.x > 0 || emissiveColor.y > 0 || emissiveColor.z > 0;
+
+        RhiRaytracingInstanceDesc& instance = m_GatheredInstances[i];
+        instance.m_InstanceID = i;
+        instance.m_InstanceMask = RT_INSTANCE_MASK_OPAQUE | (isEmissive ? RT_INSTANCE_MASK_EMISSIVE : 0);
+        instance.m_InstanceContributionToHitGroupIndex = 0;
+        instance.m_Flags = 0;
+        instance.m_AccelerationStructure = visual.m_Mesh->GetAccelerationStructure().m_DataBuffer->GetGpuAddress();
+
+        // Instances take the top three rows of the (row major, column vector) world matrix
+        for (uint32_t r = 0; r < 3; ++r)
+            for (uint32_t c = 0; c < 4; ++c)
+                instance.m_Transform[r][c] = visual.m_WorldMatrix.m_Data2D[r][c];
+    }
+}
+
+void Ether::Graphics::TlasManager::UploadDirtyInstances(CommandContext& ctx, UploadRingBuffer& uploadAllocator)
+{
+    const DirtyRange& dirtyRange = m_InstanceTracker.GetDirtyRange();
+    const std::vector<RhiRaytracingInstanceDesc>& instances = m_InstanceTracker.GetInstances();
+
+    for (uint32_t begin = dirtyRange.m_Begin; begin < dirtyRange.m_End; begin += MaxInstancesPerUpload)
+    {
+        const uint32_t numInstances = (std::min)(dirtyRange.m_End - begin, MaxInstancesPerUpload);
+        const uint32_t size = sizeof(RhiRaytracingInstanceDesc) * numInstances;
+
+        UploadBufferAllocation alloc = uploadAllocator.Allocate({ size, 256 });
+        memcpy(alloc.GetCpuHandle(), &instances[begin], size);
+
+        ctx.CopyBufferRegion(
+            alloc.GetResource(),
+            *m_AccelerationStructure->m_InstanceDescBuffer,
+            size,
+            static_cast<uint32_t>(alloc.GetOffset()),
+            sizeof(RhiRaytracingInstanceDesc) * begin);
+    }
+
+    m_InstanceTracker.ClearDirtyRange();
+}
+
+void Ether::Graphics::TlasManager::RecreateAccelerationStructure(uint32_t numInstances)
+{
+    if (m_AccelerationStructure != nullptr)
+    {
+        const uint64_t frameNumber = GraphicCore::GetGraphicRenderer().GetFrameNumber();
+        m_StaleAccelerationStructures.emplace(frameNumber, std::move(m_AccelerationStructure));
+    }
+
+    RhiTopLevelAccelerationStructureDesc desc = {};
+    desc.m_MaxInstances = AlignUp((std::max)(numInstances, 1u), InstanceGrowthSize);
+    desc.m_AllowUpdate = true;
+
+    m_AccelerationStructure = GraphicCore::GetDevice().CreateAccelerationStructure(desc);
+    m_MaxInstances = desc.m_MaxInstances;
+
+    // The new instance buffer is empty, so every instance has to be uploaded and built again
+    m_InstanceTracker.Invalidate();
+}
+
+void Ether::Graphics::TlasManager::ReleaseStaleAccelerationStructures()
+{
+    const uint64_t frameNumber = GraphicCore::GetGraphicRenderer().GetFrameNumber();
+
+    while (!m_StaleAccelerationStructures.empty() &&
+           m_StaleAccelerationStructures.front().first + MaxSwapChainBuffers < frameNumber)
+        m_StaleAccelerationStructures.pop();
+}
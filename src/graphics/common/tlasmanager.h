@@ -0,0 +1,69 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "graphics/common/renderdata.h"
+#include "graphics/common/tlasinstancetracker.h"
+#include "graphics/context/commandcontext.h"
+#include "graphics/memory/uploadringbuffer.h"
+#include "graphics/rhi/rhiaccelerationstructure.h"
+
+namespace Ether::Graphics
+{
+// Owns a top level acceleration structure that follows RenderData::m_Visuals. The instance buffer is kept on
+// the GPU between frames and only the instances that changed are uploaded. Transform-only changes are applied
+// with a refit, and the TLAS is only rebuilt when visuals are added or removed (or the BVH has been refit too often).
+// Instance i of the TLAS is always visual i, so InstanceIndex() can still be used to index per-visual data in shaders.
+class TlasManager : public NonCopyable, public NonMovable
+{
+public:
+    TlasManager();
+    ~TlasManager() = default;
+
+public:
+    inline RhiGpuAddress GetGpuAddress() const { return m_AccelerationStructure->m_DataBuffer->GetGpuAddress(); }
+
+public:
+    void Update(CommandContext& ctx, UploadRingBuffer& uploadAllocator, const RenderData& renderData);
+
+private:
+    void GatherInstances(const std::vector<Visual>& visuals);
+    void UploadDirtyInstances(CommandContext& ctx, UploadRingBuffer& uploadAllocator);
+    void RecreateAccelerationStructure(uint32_t numInstances);
+    void ReleaseStaleAccelerationStructures();
+
+private:
+    static constexpr uint32_t InstanceGrowthSize = 256;
+
+    // Uploads are split so that each one fits into a single upload allocator page
+    static constexpr uint32_t MaxInstancesPerUpload = _1MiB / sizeof(RhiRaytracingInstanceDesc);
+
+    TlasInstanceTracker m_InstanceTracker;
+    std::vector<RhiRaytracingInstanceDesc> m_GatheredInstances;
+
+    std::unique_ptr<RhiAccelerationStructure> m_AccelerationStructure;
+    uint32_t m_MaxInstances;
+    uint64_t m_VisualsVersion;
+
+    // Replaced acceleration structures, kept alive (along with the frame they were replaced in) until no frame in flight uses them
+    std::queue<std::pair<uint64_t, std::unique_ptr<RhiAccelerationStructure>>> m_StaleAccelerationStructures;
+};
+} // namespace Ether::Graphics
@@ -24,26 +24,11 @@
 
 namespace Ether::Graphics
 {
+// One batch exists per material, and its index doubles as the material's slot in the material table.
+// Batches are never removed so that material indices stay stable while visuals come and go.
 struct ETH_GRAPHIC_DLL VisualBatch
 {
     Material* m_Material;
-    std::vector<Visual> m_Visuals;
-
-    bool operator==(const VisualBatch& other) const
-    {
-        if (m_Material != other.m_Material)
-            return false;
-
-        if (m_Visuals.size() != other.m_Visuals.size())
-            return false;
-
-        for (uint32_t i = 0; i < m_Visuals.size(); ++i)
-        {
-            if (m_Visuals[i] != other.m_Visuals[i])
-                return false;
-        }
-
-        return true;
-    }
+    uint32_t m_NumVisuals;
 };
 } // namespace Ether::Graphics
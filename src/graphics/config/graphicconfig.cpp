@@ -27,7 +27,9 @@ Ether::Graphics::GraphicConfig::GraphicConfig()
     , m_UseSourceShaders(false)
     , m_IsValidationLayerEnabled(false)
     , m_IsDebugGuiEnabled(false)
+    , m_IsHeadless(false)
     , m_WindowHandle(nullptr)
+    , m_TextureStreamingBudget(_512MiB)
 {
 }
 
@@ -39,6 +41,6 @@ void Ether::Graphics::GraphicConfig::SetResolution(const ethVector2u& resolution
     m_Resolution.x = std::max(1u, resolution.x);
     m_Resolution.y = std::max(1u, resolution.y);
 
-    if (GraphicCore::IsInitialized())
+    if (GraphicCore::IsInitialized() && !m_IsHeadless)
         GraphicCore::GetGraphicDisplay().ResizeBuffers(m_Resolution);
 }
@@ -42,8 +42,12 @@ public:
     inline bool GetUseShaderDaemon() const { return m_UseShaderDaemon; }
     inline bool IsValidationLayerEnabled() const { return m_IsValidationLayerEnabled; }
     inline bool IsDebugGuiEnabled() const { return m_IsDebugGuiEnabled; }
+    inline bool IsHeadless() const { return m_IsHeadless; }
     inline void* GetWindowHandle() const { return m_WindowHandle; }
     inline ethVector4 GetClearColor() const { return m_ClearColor; }
+    // Upper bound for the mips that are streamed in on top of each texture's tail (see Texture::IsStreamable()),
+    // 0 keeps every mip resident
+    inline size_t GetTextureStreamingBudget() const { return m_TextureStreamingBudget; }
 
     void SetResolution(const ethVector2u& resolution);
     inline void SetShaderSourceDir(const std::string& dir) { m_ShaderPath = dir; }
@@ -51,8 +55,11 @@ public:
     inline void SetUseShaderDaemon(bool enable) { m_UseShaderDaemon = enable; }
     inline void SetValidationLayerEnabled(bool enabled) { m_IsValidationLayerEnabled = enabled; }
     inline void SetDebugGuiEnabled(bool enabled) { m_IsDebugGuiEnabled = enabled; }
+    inline void SetHeadless(bool headless) { m_IsHeadless = headless; }
     inline void SetWindowHandle(void* hwnd) { m_WindowHandle = hwnd; }
     inline void SetClearColor(const ethVector4& clearColor) { m_ClearColor = clearColor; }
+    // Only affects textures that are loaded afterwards
+    inline void SetTextureStreamingBudget(size_t budget) { m_TextureStreamingBudget = budget; }
 
 public:
     // Temporary debugging flags/values to be removed
@@ -92,6 +99,8 @@ private:
     bool m_UseShaderDaemon;
     bool m_IsValidationLayerEnabled;
     bool m_IsDebugGuiEnabled;
+    bool m_IsHeadless;
     void* m_WindowHandle;
+    size_t m_TextureStreamingBudget;
 };
 } // namespace Ether::Graphics
@@ -75,6 +75,11 @@ void Ether::Graphics::CommandContext::TransitionResource(RhiResource& resource,
     if (resource.GetCurrentState() == newState)
         return;
 
+    // Copy queues rely on implicit promotion from (and decay back to) the common state,
+    // and are not allowed to transition into most read states anyway
+    if (m_Type == RhiCommandType::Copy)
+        return;
+
     m_CommandList->TransitionResource(resource, newState);
 }
 
@@ -122,21 +127,27 @@ void Ether::Graphics::CommandContext::CopyBufferRegion(
     m_CommandList->CopyBufferRegion(src, dest, size, srcOffset, destOffset);
 }
 
+void Ether::Graphics::CommandContext::CopyTextureRegion(
+    RhiResource& src,
+    uint32_t srcSubresource,
+    RhiResource& dest,
+    uint32_t destSubresource)
+{
+    TransitionResource(src, RhiResourceState::CopySrc);
+    TransitionResource(dest, RhiResourceState::CopyDest);
+    m_CommandList->CopyTextureRegion(src, srcSubresource, dest, destSubresource);
+}
+
 void Ether::Graphics::CommandContext::InitializeBufferRegion(
     RhiResource& dest,
     const void* data,
     uint32_t size,
     uint32_t destOffset)
 {
-    auto alloc = m_UploadBufferAllocator->Allocate(size);
-    memcpy(alloc->GetCpuHandle(), data, size);
+    UploadBufferAllocation alloc = m_UploadBufferAllocator->Allocate(size);
+    memcpy(alloc.GetCpuHandle(), data, size);
 
-    CopyBufferRegion(
-        dynamic_cast<UploadBufferAllocation&>(*alloc).GetResource(),
-        dest,
-        size,
-        alloc->GetOffset(),
-        destOffset);
+    CopyBufferRegion(alloc.GetResource(), dest, size, alloc.GetOffset(), destOffset);
     TransitionResource(dest, RhiResourceState::GenericRead);
 }
 
@@ -154,10 +165,11 @@ void Ether::Graphics::CommandContext::InitializeTexture(
     if (numMips > 1)
         size *= 1.5;
 
-    auto alloc = m_UploadBufferAllocator->Allocate(size);
+    // Texture upload data must be placed at 512 byte boundaries (D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT)
+    UploadBufferAllocation alloc = m_UploadBufferAllocator->Allocate({ size, 512 });
 
     TransitionResource(dest, RhiResourceState::CopyDest);
-    m_CommandList->CopyTexture(((UploadBufferAllocation&)*alloc).GetResource(), dest, data, numMips, width, height, bytesPerPixel);
+    m_CommandList->CopyTexture(alloc.GetResource(), alloc.GetOffset(), dest, data, numMips, width, height, bytesPerPixel);
     TransitionResource(dest, RhiResourceState::GenericRead);
 }
 
@@ -172,9 +184,12 @@ void Ether::Graphics::CommandContext::BuildBottomLevelAccelerationStructure(
     m_CommandList->BuildAccelerationStructure(accelStructure);
 }
 
-void Ether::Graphics::CommandContext::BuildTopLevelAccelerationStructure(const RhiAccelerationStructure& accelStructure)
+void Ether::Graphics::CommandContext::BuildTopLevelAccelerationStructure(
+    const RhiAccelerationStructure& accelStructure,
+    uint32_t numInstances,
+    bool performUpdate)
 {
-    m_CommandList->BuildAccelerationStructure(accelStructure);
+    m_CommandList->BuildTopLevelAccelerationStructure(accelStructure, numInstances, performUpdate);
 }
 
 void Ether::Graphics::CommandContext::SetRaytracingShaderBindingTable(const RhiResource* bindTable)
@@ -70,7 +70,7 @@ public:
     void SetComputeRootDescriptorTable(uint32_t rootParameterIndex, RhiGpuAddress baseAddress);
 
     // Raytracing
-    void BuildTopLevelAccelerationStructure(const RhiAccelerationStructure& accelStructure);
+    void BuildTopLevelAccelerationStructure(const RhiAccelerationStructure& accelStructure, uint32_t numInstances, bool performUpdate);
     void BuildBottomLevelAccelerationStructure(const RhiAccelerationStructure& accelStructure);
     void SetRaytracingShaderBindingTable(const RhiResource* bindTable);
 
@@ -83,6 +83,8 @@ public:
     void InitializeTexture(RhiResource& dest, void** data, uint32_t numMips, uint32_t width, uint32_t height, uint32_t bytesPerPixel);
     void CopyResource(RhiResource& src, RhiResource& dest);
     void CopyBufferRegion(RhiResource& src, RhiResource& dest, uint32_t size, uint32_t srcOffset = 0, uint32_t destOffset = 0);
+    // Copies a whole subresource, both have to be of the same size (e.g. the same mip of two textures)
+    void CopyTextureRegion(RhiResource& src, uint32_t srcSubresource, RhiResource& dest, uint32_t destSubresource);
     void Dispatch(uint32_t x, uint32_t y, uint32_t z);
     void DispatchRays(uint32_t x, uint32_t y, uint32_t z);
 
@@ -149,30 +149,6 @@ Ether::Graphics::RhiResource& Ether::Graphics::ResourceContext::CreateTexture3DR
     return *m_ResourceTable.at(resourceName);
 }
 
-Ether::Graphics::RhiResource& Ether::Graphics::ResourceContext::CreateAccelerationStructure(
-    const char* resourceName,
-    const RhiTopLevelAccelerationStructureDesc& desc)
-{
-    if (!ShouldRecreateResource(resourceName, desc))
-        return *m_ResourceTable.at(resourceName);
-
-    InvalidateViews(resourceName);
-    InvalidateResource(resourceName);
-
-    std::unique_ptr<RhiAccelerationStructure> as = GraphicCore::GetDevice().CreateAccelerationStructure(desc);
-
-    CommandContext ctx("CommandContext - Build TLAS");
-    ctx.Reset();
-    ctx.TransitionResource(*as->m_ScratchBuffer, RhiResourceState::UnorderedAccess);
-    ctx.BuildTopLevelAccelerationStructure(*as);
-    ctx.FinalizeAndExecute(true);
-
-    m_ResourceTable[resourceName] = std::move(as->m_DataBuffer);
-    m_RaytracingResourceDescriptionTable[resourceName] = desc;
-
-    return *m_ResourceTable.at(resourceName);
-}
-
 Ether::Graphics::RhiResource& Ether::Graphics::ResourceContext::CreateRaytracingShaderBindingTable(
     const char* resourceName,
     const RhiRaytracingShaderBindingTableDesc& desc)
@@ -194,12 +170,12 @@ void Ether::Graphics::ResourceContext::InitializeRenderTargetView(std::shared_pt
     if (!ShouldRecreateView(view->GetViewID()))
         return;
 
-    auto alloc = GraphicCore::GetRtvAllocator().Allocate();
-    view->SetCpuAddress(((DescriptorAllocation&)(*alloc)).GetCpuAddress());
+    DescriptorAllocation alloc = GraphicCore::GetRtvAllocator().Allocate();
+    view->SetCpuAddress(alloc.GetCpuAddress());
 
     GraphicCore::GetDevice().InitializeRenderTargetView((*(RhiRenderTargetView*)(view.get())), *m_ResourceTable[view->GetResourceID()]);
     m_DescriptorTable[view->GetViewID()] = view;
-    m_DescriptorAllocations[view->GetViewID()] = std::move(alloc);
+    m_DescriptorAllocations.insert_or_assign(view->GetViewID(), std::move(alloc));
 }
 
 void Ether::Graphics::ResourceContext::InitializeDepthStencilView(std::shared_ptr<RhiResourceView> view)
@@ -207,12 +183,12 @@ void Ether::Graphics::ResourceContext::InitializeDepthStencilView(std::shared_pt
     if (!ShouldRecreateView(view->GetViewID()))
         return;
 
-    auto alloc = GraphicCore::GetDsvAllocator().Allocate();
-    view->SetCpuAddress(((DescriptorAllocation&)(*alloc)).GetCpuAddress());
+    DescriptorAllocation alloc = GraphicCore::GetDsvAllocator().Allocate();
+    view->SetCpuAddress(alloc.GetCpuAddress());
 
     GraphicCore::GetDevice().InitializeDepthStencilView((*(RhiDepthStencilView*)(view.get())), *m_ResourceTable[view->GetResourceID()]);
     m_DescriptorTable[view->GetViewID()] = view;
-    m_DescriptorAllocations[view->GetViewID()] = std::move(alloc);
+    m_DescriptorAllocations.insert_or_assign(view->GetViewID(), std::move(alloc));
 }
 
 void Ether::Graphics::ResourceContext::InitializeShaderResourceView(std::shared_ptr<RhiResourceView> view)
@@ -220,13 +196,13 @@ void Ether::Graphics::ResourceContext::InitializeShaderResourceView(std::shared_
     if (!ShouldRecreateView(view->GetViewID()))
         return;
 
-    auto alloc = GraphicCore::GetSrvCbvUavAllocator().Allocate();
-    view->SetCpuAddress(((DescriptorAllocation&)(*alloc)).GetCpuAddress());
-    ((RhiShaderResourceView*)view.get())->SetGpuAddress(((DescriptorAllocation&)(*alloc)).GetGpuAddress());
+    // The GPU address is assigned every frame by CommitShaderVisibleViews()
+    DescriptorAllocation alloc = m_StagingSrvCbvUavAllocator->Allocate();
+    view->SetCpuAddress(alloc.GetCpuAddress());
 
     GraphicCore::GetDevice().InitializeShaderResourceView((*(RhiShaderResourceView*)(view.get())), *m_ResourceTable[view->GetResourceID()]);
     m_DescriptorTable[view->GetViewID()] = view;
-    m_DescriptorAllocations[view->GetViewID()] = std::move(alloc);
+    m_DescriptorAllocations.insert_or_assign(view->GetViewID(), std::move(alloc));
 }
 
 void Ether::Graphics::ResourceContext::InitializeUnorderedAccessView(std::shared_ptr<RhiResourceView> view)
@@ -234,13 +210,13 @@ void Ether::Graphics::ResourceContext::InitializeUnorderedAccessView(std::shared
     if (!ShouldRecreateView(view->GetViewID()))
         return;
 
-    auto alloc = GraphicCore::GetSrvCbvUavAllocator().Allocate();
-    view->SetCpuAddress(((DescriptorAllocation&)(*alloc)).GetCpuAddress());
-    ((RhiUnorderedAccessView*)view.get())->SetGpuAddress(((DescriptorAllocation&)(*alloc)).GetGpuAddress());
+    // The GPU address is assigned every frame by CommitShaderVisibleViews()
+    DescriptorAllocation alloc = m_StagingSrvCbvUavAllocator->Allocate();
+    view->SetCpuAddress(alloc.GetCpuAddress());
 
     GraphicCore::GetDevice().InitializeUnorderedAccessView((*(RhiUnorderedAccessView*)(view.get())), *m_ResourceTable[view->GetResourceID()]);
     m_DescriptorTable[view->GetViewID()] = view;
-    m_DescriptorAllocations[view->GetViewID()] = std::move(alloc);
+    m_DescriptorAllocations.insert_or_assign(view->GetViewID(), std::move(alloc));
 }
 
 void Ether::Graphics::ResourceContext::InitializeConstantBufferView(std::shared_ptr<RhiResourceView> view)
@@ -248,13 +224,35 @@ void Ether::Graphics::ResourceContext::InitializeConstantBufferView(std::shared_
     if (!ShouldRecreateView(view->GetViewID()))
         return;
 
-    auto alloc = GraphicCore::GetSrvCbvUavAllocator().Allocate();
-    view->SetCpuAddress(((DescriptorAllocation&)(*alloc)).GetCpuAddress());
-    ((RhiConstantBufferView*)view.get())->SetGpuAddress(((DescriptorAllocation&)(*alloc)).GetGpuAddress());
+    // The GPU address is assigned every frame by CommitShaderVisibleViews()
+    DescriptorAllocation alloc = m_StagingSrvCbvUavAllocator->Allocate();
+    view->SetCpuAddress(alloc.GetCpuAddress());
 
     GraphicCore::GetDevice().InitializeConstantBufferView((*(RhiConstantBufferView*)(view.get())), *m_ResourceTable[view->GetResourceID()]);
     m_DescriptorTable[view->GetViewID()] = view;
-    m_DescriptorAllocations[view->GetViewID()] = std::move(alloc);
+    m_DescriptorAllocations.insert_or_assign(view->GetViewID(), std::move(alloc));
+}
+
+void Ether::Graphics::ResourceContext::CommitShaderVisibleViews()
+{
+    m_ShaderVisibleViews.clear();
+    for (auto iter = m_DescriptorTable.begin(); iter != m_DescriptorTable.end(); ++iter)
+    {
+        RhiShaderVisibleResourceView* view = dynamic_cast<RhiShaderVisibleResourceView*>(iter->second.get());
+        if (view != nullptr)
+            m_ShaderVisibleViews.push_back(view);
+    }
+
+    if (m_ShaderVisibleViews.empty())
+        return;
+
+    // A single table, so that the whole frame costs one ring allocation
+    const TransientDescriptorAllocation alloc = GraphicCore::GetTransientSrvCbvUavAllocator().Commit(
+        (const RhiResourceView**)m_ShaderVisibleViews.data(),
+        static_cast<uint32_t>(m_ShaderVisibleViews.size()));
+
+    for (uint32_t i = 0; i < m_ShaderVisibleViews.size(); ++i)
+        m_ShaderVisibleViews[i]->SetGpuAddress(alloc.GetGpuAddress(i));
 }
 
 bool Ether::Graphics::ResourceContext::ShouldRecreateResource(StringID resourceID, const RhiCommitedResourceDesc& desc)
@@ -277,35 +275,6 @@ bool Ether::Graphics::ResourceContext::ShouldRecreateResource(StringID resourceI
     return false;
 }
 
-bool Ether::Graphics::ResourceContext::ShouldRecreateResource(
-    StringID resourceID,
-    const RhiTopLevelAccelerationStructureDesc& desc)
-{
-    // If the resource don't exist in the resource table at all
-    if (m_ResourceTable.find(resourceID) == m_ResourceTable.end())
-        return true;
-
-    return false;
-
-    AssertGraphics(
-        m_RaytracingResourceDescriptionTable.find(resourceID) != m_RaytracingResourceDescriptionTable.end(),
-        "If the resource never existed, there should not be any cached desc with the same resourceID");
-
-    Visual* vbOld = (Visual*)m_RaytracingResourceDescriptionTable.at(resourceID).m_Visuals;
-    Visual* vbNew = (Visual*)desc.m_Visuals;
-
-    if (vbOld == vbNew)
-        return false;
-
-    if (vbOld == nullptr)
-        return true;
-
-    if (*vbOld != *vbNew)
-        return true;
-
-    return false;
-}
-
 bool Ether::Graphics::ResourceContext::ShouldRecreateResource(
     StringID resourceID,
     const RhiRaytracingShaderBindingTableDesc& desc)
@@ -46,7 +46,6 @@ public:
     RhiResource& CreateBufferResource(const char* resourceName, size_t size, RhiResourceFlag flags);
     RhiResource& CreateTexture2DResource(const char* resourceName, const ethVector2u resolution, RhiFormat format, RhiResourceFlag flags);
     RhiResource& CreateTexture3DResource(const char* resourceName, const ethVector3u resolution, RhiFormat format, RhiResourceFlag flags);
-    RhiResource& CreateAccelerationStructure(const char* resourceName, const RhiTopLevelAccelerationStructureDesc& desc);
     RhiResource& CreateRaytracingShaderBindingTable(const char* resourceName, const RhiRaytracingShaderBindingTableDesc& desc);
 
     void InitializeRenderTargetView(std::shared_ptr<RhiResourceView> view);
@@ -61,7 +60,6 @@ public:
 private:
     bool ShouldRecreateResource(StringID resourceID, const RhiCommitedResourceDesc& desc);
     bool ShouldRecreateResource(StringID resourceID, const RhiRaytracingShaderBindingTableDesc& desc);
-    bool ShouldRecreateResource(StringID resourceID, const RhiTopLevelAccelerationStructureDesc& desc);
 
     bool ShouldRecreateView(StringID viewID);
     void InvalidateViews(StringID resourceID);
@@ -70,19 +68,22 @@ private:
 private:
     friend class FrameScheduler;
     void Reset();
+    // Copies the SRV/UAV/CBVs into this frame's range of the transient ring, and points their GPU addresses there
+    void CommitShaderVisibleViews();
 
 private:
+    // SRV/UAV/CBVs are only written here, since they may be recreated while the GPU still reads an earlier frame's copy
     std::unique_ptr<DescriptorAllocator> m_StagingSrvCbvUavAllocator;
+    std::vector<RhiShaderVisibleResourceView*> m_ShaderVisibleViews;
 
     std::unordered_map<RhiPipelineStateDesc*, std::unique_ptr<RhiPipelineState>> m_CachedPipelineStates;
 
     std::unordered_map<StringID, RhiCommitedResourceDesc> m_ResourceDescriptionTable;
     std::unordered_map<StringID, RhiRaytracingShaderBindingTableDesc> m_RaytracingShaderBindingsTable;
-    std::unordered_map<StringID, RhiTopLevelAccelerationStructureDesc> m_RaytracingResourceDescriptionTable;
 
     std::unordered_map<StringID, std::unique_ptr<RhiResource>> m_ResourceTable;
     std::unordered_map<StringID, std::shared_ptr<RhiResourceView>> m_DescriptorTable;
-    std::unordered_map<StringID, std::unique_ptr<MemoryAllocation>> m_DescriptorAllocations;
+    std::unordered_map<StringID, DescriptorAllocation> m_DescriptorAllocations;
 
     std::queue<std::unique_ptr<RhiResource>> m_StaleResources;
 };
@@ -0,0 +1,195 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/graphiccore.h"
+#include "graphics/context/uploadqueue.h"
+#include "graphics/rhi/rhicommandqueue.h"
+
+Ether::Graphics::UploadQueue::UploadQueue(size_t batchSize, uint32_t maxBatchesInFlight)
+    : m_BatchSize(batchSize)
+    , m_MaxBatchesInFlight(maxBatchesInFlight)
+    , m_NumBatchesCreated(0)
+    , m_NumBatchesSubmitted(0)
+    , m_NumBytesStaged(0)
+{
+}
+
+Ether::Graphics::UploadQueue::~UploadQueue()
+{
+    Flush();
+}
+
+Ether::Graphics::CommandContext& Ether::Graphics::UploadQueue::GetCopyContext(size_t uploadSize)
+{
+    if (m_CurrentBatch != nullptr && m_CurrentBatch->m_NumBytesStaged + uploadSize > m_BatchSize)
+        Submit();
+
+    if (m_CurrentBatch == nullptr)
+        OpenBatch(uploadSize);
+
+    m_CurrentBatch->m_NumBytesStaged += uploadSize;
+    m_NumBytesStaged += uploadSize;
+    return *m_CurrentBatch->m_CopyContext;
+}
+
+Ether::Graphics::CommandContext& Ether::Graphics::UploadQueue::GetGraphicContext()
+{
+    if (m_CurrentBatch == nullptr)
+        OpenBatch(0);
+
+    if (!m_CurrentBatch->m_HasGraphicWork)
+    {
+        m_CurrentBatch->m_GraphicContext->Reset();
+        m_CurrentBatch->m_HasGraphicWork = true;
+    }
+
+    return *m_CurrentBatch->m_GraphicContext;
+}
+
+void Ether::Graphics::UploadQueue::Submit()
+{
+    ETH_MARKER_EVENT("Upload Queue - Submit");
+
+    if (m_CurrentBatch == nullptr)
+        return;
+
+    RhiCommandQueue& copyQueue = GraphicCore::GetCommandManager().GetCopyQueue();
+    RhiCommandQueue& graphicQueue = GraphicCore::GetCommandManager().GetGraphicQueue();
+
+    m_CurrentBatch->m_CopyContext->FinalizeAndExecute();
+    m_CurrentBatch->m_CopyFenceValue = copyQueue.GetFinalFenceValue();
+
+    // Anything that runs on the graphic queue after this point (including the next frame) may sample the
+    // uploaded resources, so the wait is inserted even if this batch has no graphic work of its own
+    graphicQueue.WaitForQueue(copyQueue, m_CurrentBatch->m_CopyFenceValue);
+
+    if (m_CurrentBatch->m_HasGraphicWork)
+    {
+        m_CurrentBatch->m_GraphicContext->FinalizeAndExecute();
+        m_CurrentBatch->m_GraphicFenceValue = graphicQueue.GetFinalFenceValue();
+    }
+
+    m_InFlightBatches.push_back(std::move(m_CurrentBatch));
+    ++m_NumBatchesSubmitted;
+}
+
+void Ether::Graphics::UploadQueue::Update()
+{
+    while (!m_InFlightBatches.empty() && IsBatchComplete(*m_InFlightBatches.front()))
+    {
+        RetireBatch(std::move(m_InFlightBatches.front()));
+        m_InFlightBatches.pop_front();
+    }
+}
+
+void Ether::Graphics::UploadQueue::Flush()
+{
+    ETH_MARKER_EVENT("Upload Queue - Flush");
+
+    Submit();
+
+    while (!m_InFlightBatches.empty())
+    {
+        UploadBatch& batch = *m_InFlightBatches.front();
+        GraphicCore::GetCommandManager().GetCopyQueue().StallForFence(batch.m_CopyFenceValue);
+
+        if (batch.m_HasGraphicWork)
+            GraphicCore::GetCommandManager().GetGraphicQueue().StallForFence(batch.m_GraphicFenceValue);
+
+        RetireBatch(std::move(m_InFlightBatches.front()));
+        m_InFlightBatches.pop_front();
+    }
+}
+
+std::unique_ptr<Ether::Graphics::UploadQueue::UploadBatch> Ether::Graphics::UploadQueue::CreateBatch(
+    size_t batchSize,
+    bool isDedicated) const
+{
+    std::unique_ptr<UploadBatch> batch = std::make_unique<UploadBatch>();
+    batch->m_CopyContext = std::make_unique<CommandContext>("UploadQueue - Copy Batch", RhiCommandType::Copy, batchSize);
+    batch->m_GraphicContext = std::make_unique<CommandContext>("UploadQueue - Graphic Batch", RhiCommandType::Graphic, _4KiB);
+    batch->m_IsDedicated = isDedicated;
+    return batch;
+}
+
+void Ether::Graphics::UploadQueue::OpenBatch(size_t uploadSize)
+{
+    if (uploadSize > m_BatchSize)
+    {
+        // Uploads that do not fit into a regular page get a batch (and upload heap) of their own,
+        // which is released as soon as the GPU is done with it
+        m_CurrentBatch = CreateBatch(AlignUp(uploadSize, _1MiB), true);
+    }
+    else
+    {
+        Update();
+
+        if (m_FreeBatches.empty() && m_NumBatchesCreated >= m_MaxBatchesInFlight)
+        {
+            // Every batch is still in flight. This is the only place where the CPU waits for the copy queue.
+            while (m_FreeBatches.empty())
+            {
+                UploadBatch& oldestBatch = *m_InFlightBatches.front();
+                GraphicCore::GetCommandManager().GetCopyQueue().StallForFence(oldestBatch.m_CopyFenceValue);
+
+                if (oldestBatch.m_HasGraphicWork)
+                    GraphicCore::GetCommandManager().GetGraphicQueue().StallForFence(oldestBatch.m_GraphicFenceValue);
+
+                RetireBatch(std::move(m_InFlightBatches.front()));
+                m_InFlightBatches.pop_front();
+            }
+        }
+
+        if (m_FreeBatches.empty())
+        {
+            m_FreeBatches.push_back(CreateBatch(m_BatchSize, false));
+            ++m_NumBatchesCreated;
+        }
+
+        m_CurrentBatch = std::move(m_FreeBatches.back());
+        m_FreeBatches.pop_back();
+    }
+
+    m_CurrentBatch->m_CopyFenceValue = 0;
+    m_CurrentBatch->m_GraphicFenceValue = 0;
+    m_CurrentBatch->m_NumBytesStaged = 0;
+    m_CurrentBatch->m_HasGraphicWork = false;
+    m_CurrentBatch->m_CopyContext->Reset();
+}
+
+void Ether::Graphics::UploadQueue::RetireBatch(std::unique_ptr<UploadBatch>&& batch)
+{
+    if (batch->m_IsDedicated)
+        return;
+
+    // The GPU is done reading from this batch's upload pages, so they can be handed out again
+    batch->m_CopyContext->GetUploadBufferAllocator().Reset();
+    m_FreeBatches.push_back(std::move(batch));
+}
+
+bool Ether::Graphics::UploadQueue::IsBatchComplete(const UploadBatch& batch) const
+{
+    if (!GraphicCore::GetCommandManager().GetCopyQueue().IsFenceComplete(batch.m_CopyFenceValue))
+        return false;
+
+    if (batch.m_HasGraphicWork && !GraphicCore::GetCommandManager().GetGraphicQueue().IsFenceComplete(batch.m_GraphicFenceValue))
+        return false;
+
+    return true;
+}
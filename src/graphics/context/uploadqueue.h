@@ -0,0 +1,89 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "graphics/context/commandcontext.h"
+#include <deque>
+
+namespace Ether::Graphics
+{
+/*
+    Batches resource uploads onto the copy queue. Resources are staged into the upload pages of the
+    current batch, and a batch is only submitted once its budget is used up (or when explicitly asked to).
+    Completion is tracked with fences, so the CPU never waits on the GPU unless every batch in the
+    ring is still in flight.
+*/
+class ETH_GRAPHIC_DLL UploadQueue : public NonCopyable, public NonMovable
+{
+public:
+    UploadQueue(size_t batchSize = _32MiB, uint32_t maxBatchesInFlight = 3);
+    ~UploadQueue();
+
+public:
+    inline uint32_t GetNumBatchesInFlight() const { return static_cast<uint32_t>(m_InFlightBatches.size()); }
+    inline uint32_t GetNumBatchesSubmitted() const { return m_NumBatchesSubmitted; }
+    inline uint64_t GetNumBytesStaged() const { return m_NumBytesStaged; }
+
+public:
+    // Returns the copy context that an upload of the given size should be recorded into.
+    // The current batch is submitted first if the upload would not fit into what is left of it.
+    CommandContext& GetCopyContext(size_t uploadSize);
+
+    // Returns a context for work that cannot be recorded on the copy queue (e.g. acceleration structure builds).
+    // It is executed on the graphic queue after the current batch's copies have completed.
+    CommandContext& GetGraphicContext();
+
+    void Submit();
+    void Update();
+    void Flush();
+
+private:
+    struct UploadBatch
+    {
+        std::unique_ptr<CommandContext> m_CopyContext;
+        std::unique_ptr<CommandContext> m_GraphicContext;
+
+        RhiFenceValue m_CopyFenceValue;
+        RhiFenceValue m_GraphicFenceValue;
+
+        size_t m_NumBytesStaged;
+        bool m_HasGraphicWork;
+        bool m_IsDedicated;
+    };
+
+    std::unique_ptr<UploadBatch> CreateBatch(size_t batchSize, bool isDedicated) const;
+    void OpenBatch(size_t uploadSize);
+    void RetireBatch(std::unique_ptr<UploadBatch>&& batch);
+    bool IsBatchComplete(const UploadBatch& batch) const;
+
+private:
+    std::unique_ptr<UploadBatch> m_CurrentBatch;
+    std::deque<std::unique_ptr<UploadBatch>> m_InFlightBatches;
+    std::vector<std::unique_ptr<UploadBatch>> m_FreeBatches;
+
+    const size_t m_BatchSize;
+    const uint32_t m_MaxBatchesInFlight;
+    uint32_t m_NumBatchesCreated;
+
+    uint32_t m_NumBatchesSubmitted;
+    uint64_t m_NumBytesStaged;
+};
+} // namespace Ether::Graphics
@@ -25,6 +25,14 @@ Ether::Graphics::GraphicCommon::GraphicCommon()
     InitializeRasterizerStates();
     InitializeDepthStates();
     InitializeBlendingStates();
+
+    // Materials are all that the CPU side of the renderer needs
+    if (GraphicCore::GetGraphicConfig().IsHeadless())
+    {
+        InitializeMaterials();
+        return;
+    }
+
     InitializeSamplers();
     InitializeRootSignatures();
     InitializeShaders();
@@ -23,6 +23,15 @@
 
 void Ether::Graphics::GraphicCore::Initialize()
 {
+    // Without a device, only the CPU side of the renderer exists (e.g. for benchmarks)
+    if (m_Config.IsHeadless())
+    {
+        m_GraphicCommon = std::make_unique<GraphicCommon>();
+        m_HeadlessRenderer = std::make_unique<HeadlessRenderer>();
+        m_IsInitialized = true;
+        return;
+    }
+
     m_RhiModule = RhiModule::InitForPlatform();
     m_RhiDevice = m_RhiModule->CreateDevice();
 
@@ -32,7 +41,10 @@ void Ether::Graphics::GraphicCore::Initialize()
     m_DsvAllocator = std::make_unique<DescriptorAllocator>(RhiDescriptorHeapType::Dsv, _4KiB);
     m_SrvCbvUavAllocator = std::make_unique<DescriptorAllocator>(RhiDescriptorHeapType::SrvCbvUav, _64KiB, true);
     m_SamplerAllocator = std::make_unique<DescriptorAllocator>(RhiDescriptorHeapType::Sampler, _1KiB, true);
+    m_TransientSrvCbvUavAllocator = std::make_unique<TransientDescriptorAllocator>(*m_SrvCbvUavAllocator, _4KiB);
     m_CommandManager = std::make_unique<CommandManager>();
+    m_UploadQueue = std::make_unique<UploadQueue>();
+    m_UploadRingBuffer = std::make_unique<UploadRingBuffer>();
     m_GraphicCommon = std::make_unique<GraphicCommon>();
     m_GraphicDisplay = std::make_unique<GraphicDisplay>();
     m_GraphicRenderer = std::make_unique<GraphicRenderer>();
@@ -42,13 +54,29 @@ void Ether::Graphics::GraphicCore::Initialize()
 
 void Ether::Graphics::GraphicCore::Shutdown()
 {
+    // Whatever was queued after the last frame, the render thread has been stopped by now
+    ExecuteRenderWork(m_RenderDataBuffer.GetWriteData());
+
+    if (m_Config.IsHeadless())
+    {
+        m_HeadlessRenderer.reset();
+        m_GraphicCommon.reset();
+        m_IsInitialized = false;
+        return;
+    }
+
     FlushGpu();
 
     m_GraphicRenderer.reset();
     m_GraphicDisplay.reset();
     m_GraphicCommon.reset();
-    m_CommandManager.reset();
+    m_UploadQueue.reset();
+    m_UploadRingBuffer.reset();
+    // Freeing descriptors needs the graphic queue's fence, so release them before the queues go away
     m_BindlessDescriptorManager.reset();
+    m_TransientSrvCbvUavAllocator.reset();
+    m_CommandManager.reset();
+    m_SamplerAllocator.reset();
     m_SrvCbvUavAllocator.reset();
     m_DsvAllocator.reset();
     m_RtvAllocator.reset();
@@ -69,7 +97,79 @@ void Ether::Graphics::GraphicCore::Main()
 {
     ETH_MARKER_EVENT("Graphics Update");
 
+    s_Instance->ExecuteRenderWork(GetRenderData());
+
+    if (s_Instance->m_Config.IsHeadless())
+    {
+        s_Instance->m_HeadlessRenderer->Render();
+        return;
+    }
+
+    s_Instance->m_UploadQueue->Update();
     s_Instance->m_GraphicRenderer->WaitForPresent();
     s_Instance->m_GraphicRenderer->Render();
     s_Instance->m_GraphicRenderer->Present();
 }
+
+void Ether::Graphics::GraphicCore::SubmitFrame()
+{
+    if (!s_Instance->m_IsRenderThreadRunning)
+    {
+        Main();
+        return;
+    }
+
+    s_Instance->m_RenderDataBuffer.Publish();
+}
+
+void Ether::Graphics::GraphicCore::StartRenderThread()
+{
+    if (s_Instance->m_IsRenderThreadRunning)
+        return;
+
+    LogGraphicsInfo("Starting render thread");
+    s_Instance->m_RenderDataBuffer.Reopen();
+    s_Instance->m_IsRenderThreadRunning = true;
+    s_Instance->m_RenderThread = std::thread(&GraphicCore::RenderThread, s_Instance);
+}
+
+void Ether::Graphics::GraphicCore::StopRenderThread()
+{
+    if (!s_Instance->m_IsRenderThreadRunning)
+        return;
+
+    // The frame that was already handed over is still rendered before the thread exits
+    s_Instance->m_RenderDataBuffer.Close();
+    s_Instance->m_RenderThread.join();
+    s_Instance->m_IsRenderThreadRunning = false;
+}
+
+void Ether::Graphics::GraphicCore::QueueRenderWork(std::function<void()>&& work)
+{
+    // Travels with the frame, so that it cannot run before the frames that were submitted earlier
+    GetNextRenderData().m_RenderWork.push_back(std::move(work));
+}
+
+void Ether::Graphics::GraphicCore::ExecuteRenderWork(RenderData& renderData)
+{
+    if (renderData.m_RenderWork.empty())
+        return;
+
+    ETH_MARKER_EVENT("Graphics - Execute Render Work");
+
+    for (std::function<void()>& work : renderData.m_RenderWork)
+        work();
+
+    // Kick off any uploads that the work has staged, the frame waits for them on the GPU
+    if (!m_Config.IsHeadless())
+        m_UploadQueue->Submit();
+
+    // Releases whatever the work still holds on to (e.g. resources that were waiting to be destroyed)
+    renderData.m_RenderWork.clear();
+}
+
+void Ether::Graphics::GraphicCore::RenderThread()
+{
+    while (m_RenderDataBuffer.Acquire())
+        Main();
+}
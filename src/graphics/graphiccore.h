@@ -29,13 +29,19 @@
 #include "graphics/command/commandmanager.h"
 #include "graphics/common/visualbatch.h"
 #include "graphics/config/graphicconfig.h"
+#include "graphics/context/uploadqueue.h"
 #include "graphics/memory/descriptorallocator.h"
+#include "graphics/memory/transientdescriptorallocator.h"
+#include "graphics/memory/uploadringbuffer.h"
 #include "graphics/memory/bindlessdescriptormanager.h"
 #include "graphics/shaderdaemon/shaderdaemon.h"
 
 #include "graphics/graphiccommon.h"
 #include "graphics/graphicdisplay.h"
 #include "graphics/graphicrenderer.h"
+#include "graphics/headlessrenderer.h"
+#include "graphics/common/renderdatabuffer.h"
+#include <thread>
 
 namespace Ether::Graphics
 {
@@ -59,19 +65,46 @@ public:
     static inline DescriptorAllocator& GetDsvAllocator() { return *Instance().m_DsvAllocator; }
     static inline DescriptorAllocator& GetSrvCbvUavAllocator() { return *Instance().m_SrvCbvUavAllocator; }
     static inline DescriptorAllocator& GetSamplerAllocator() { return *Instance().m_SamplerAllocator; }
+    static inline TransientDescriptorAllocator& GetTransientSrvCbvUavAllocator() { return *Instance().m_TransientSrvCbvUavAllocator; }
     static inline GraphicConfig& GetGraphicConfig() { return Instance().m_Config; }
     static inline GraphicCommon& GetGraphicCommon() { return *Instance().m_GraphicCommon; }
     static inline GraphicDisplay& GetGraphicDisplay() { return *Instance().m_GraphicDisplay; }
     static inline GraphicRenderer& GetGraphicRenderer() { return *Instance().m_GraphicRenderer; }
+    static inline HeadlessRenderer& GetHeadlessRenderer() { return *Instance().m_HeadlessRenderer; }
+    // The frame that is being rendered. Only for the renderer, the simulation writes GetNextRenderData().
+    static inline RenderData& GetRenderData() { return Instance().m_IsRenderThreadRunning ? Instance().m_RenderDataBuffer.GetReadData() : Instance().m_RenderDataBuffer.GetWriteData(); }
+    static inline RenderData& GetNextRenderData() { return Instance().m_RenderDataBuffer.GetWriteData(); }
     static inline ShaderDaemon& GetShaderDaemon() { return *Instance().m_ShaderDaemon; }
+    static inline UploadQueue& GetUploadQueue() { return *Instance().m_UploadQueue; }
+    static inline UploadRingBuffer& GetUploadRingBuffer() { return *Instance().m_UploadRingBuffer; }
 
     static inline bool IsInitialized() { return Instance().m_IsInitialized; }
+    static inline bool IsHeadless() { return Instance().m_Config.IsHeadless(); }
+    static inline bool IsRenderThreadRunning() { return Instance().m_IsRenderThreadRunning; }
 
 
 public:
     static void Main();
     static void FlushGpu();
 
+    // Hands the frame that the simulation has built over to the renderer. Without a render thread,
+    // this renders it right away.
+    static void SubmitFrame();
+
+    // Renders on a separate thread, one frame behind the simulation (see RenderDataBuffer)
+    static void StartRenderThread();
+    static void StopRenderThread();
+
+    // Runs on whichever thread renders, right before the frame that is currently being built is
+    // rendered. GPU resources that are created or released while the engine is running (e.g. streamed
+    // meshes and textures) go through this, so that they never change underneath a frame in flight.
+    // Main thread only.
+    static void QueueRenderWork(std::function<void()>&& work);
+
+private:
+    void RenderThread();
+    void ExecuteRenderWork(RenderData& renderData);
+
 private:
     bool m_IsInitialized;
 
@@ -84,12 +117,22 @@ private:
     std::unique_ptr<DescriptorAllocator> m_DsvAllocator;
     std::unique_ptr<DescriptorAllocator> m_SrvCbvUavAllocator;
     std::unique_ptr<DescriptorAllocator> m_SamplerAllocator;
+    std::unique_ptr<TransientDescriptorAllocator> m_TransientSrvCbvUavAllocator;
     std::unique_ptr<GraphicCommon> m_GraphicCommon;
     std::unique_ptr<GraphicDisplay> m_GraphicDisplay;
     std::unique_ptr<GraphicRenderer> m_GraphicRenderer;
+    std::unique_ptr<HeadlessRenderer> m_HeadlessRenderer;
     std::unique_ptr<ShaderDaemon> m_ShaderDaemon;
+    std::unique_ptr<UploadQueue> m_UploadQueue;
+    std::unique_ptr<UploadRingBuffer> m_UploadRingBuffer;
 
 private:
     GraphicConfig m_Config;
+
+    // Owned here rather than by the renderer, so that it also exists in headless mode
+    RenderDataBuffer m_RenderDataBuffer;
+
+    std::thread m_RenderThread;
+    bool m_IsRenderThreadRunning = false;
 };
 } // namespace Ether::Graphics
@@ -99,8 +99,8 @@ void Ether::Graphics::GraphicDisplay::CreateViewsFromSwapChain()
 {
     m_SwapChainDescriptors.clear();
 
-    auto rtvAllocation = GraphicCore::GetRtvAllocator().Allocate(3);
-    auto srvAllocation = GraphicCore::GetSrvCbvUavAllocator().Allocate(3);
+    DescriptorAllocation rtvAllocation = GraphicCore::GetRtvAllocator().Allocate(3);
+    DescriptorAllocation srvAllocation = GraphicCore::GetSrvCbvUavAllocator().Allocate(3);
 
     for (uint32_t i = 0; i < GetNumBuffers(); ++i)
     {
@@ -112,7 +112,7 @@ void Ether::Graphics::GraphicDisplay::CreateViewsFromSwapChain()
         m_RenderTargetRtv[i].SetFormat(BackBufferLdrFormat);
         m_RenderTargetRtv[i].SetViewID("BackBuffer RTV " + std::to_string(i));
         m_RenderTargetRtv[i].SetResourceID(m_RenderTargets[i]->GetResourceID());
-        m_RenderTargetRtv[i].SetCpuAddress(((DescriptorAllocation&)(*rtvAllocation)).GetCpuAddress(i));
+        m_RenderTargetRtv[i].SetCpuAddress(rtvAllocation.GetCpuAddress(i));
         GraphicCore::GetDevice().InitializeRenderTargetView(m_RenderTargetRtv[i], *m_RenderTargets[i]);
 
         m_RenderTargetSrv[i] = {};
@@ -124,8 +124,8 @@ void Ether::Graphics::GraphicDisplay::CreateViewsFromSwapChain()
         m_RenderTargetRtv[i].SetViewID("BackBuffer SRV " + std::to_string(i));
         m_RenderTargetSrv[i].SetResourceID(m_RenderTargets[i]->GetResourceID());
         m_RenderTargetSrv[i].SetDimension(RhiResourceDimension::Texture2D);
-        m_RenderTargetSrv[i].SetCpuAddress(((DescriptorAllocation&)(*srvAllocation)).GetCpuAddress(i));
-        m_RenderTargetSrv[i].SetGpuAddress(((DescriptorAllocation&)(*srvAllocation)).GetGpuAddress(i));
+        m_RenderTargetSrv[i].SetCpuAddress(srvAllocation.GetCpuAddress(i));
+        m_RenderTargetSrv[i].SetGpuAddress(srvAllocation.GetGpuAddress(i));
         GraphicCore::GetDevice().InitializeShaderResourceView(m_RenderTargetSrv[i], *m_RenderTargets[i]);
     }
 
@@ -72,7 +72,7 @@ namespace Ether::Graphics
         RhiRenderTargetView m_RenderTargetRtv[MaxSwapChainBuffers];
         RhiShaderResourceView m_RenderTargetSrv[MaxSwapChainBuffers];
 
-        std::vector<std::unique_ptr<MemoryAllocation>> m_SwapChainDescriptors;
+        std::vector<DescriptorAllocation> m_SwapChainDescriptors;
         uint64_t m_FrameBufferFences[MaxSwapChainBuffers];
         uint32_t m_CurrentBackBufferIndex;
 
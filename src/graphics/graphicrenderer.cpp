@@ -21,9 +21,11 @@
 #include "graphics/graphicrenderer.h"
 #include "graphics/resources/material.h"
 #include "graphics/rhi/rhishader.h"
+#include "common/telemetry/telemetry.h"
 
 Ether::Graphics::GraphicRenderer::GraphicRenderer()
     : m_FrameNumber(0)
+    , m_RenderStats()
 {
     LogGraphicsInfo("Initializing Graphic Renderer");
     m_Scheduler.PrecompilePipelineStates();
@@ -32,8 +34,11 @@ Ether::Graphics::GraphicRenderer::GraphicRenderer()
 void Ether::Graphics::GraphicRenderer::WaitForPresent()
 {
     ETH_MARKER_EVENT("Renderer - Wait for Present");
+    ScopedTelemetry telemetry("Renderer - Wait for Present");
     GraphicDisplay& gfxDisplay = GraphicCore::GetGraphicDisplay();
     GraphicCore::GetCommandManager().GetGraphicQueue().StallForFence(gfxDisplay.GetBackBufferFence());
+    GraphicCore::GetTransientSrvCbvUavAllocator().BeginFrame();
+    GraphicCore::GetUploadRingBuffer().BeginFrame();
 
     m_FrameNumber++;
 }
@@ -41,8 +46,11 @@ void Ether::Graphics::GraphicRenderer::WaitForPresent()
 void Ether::Graphics::GraphicRenderer::Render()
 {
     ETH_MARKER_EVENT("Renderer - Render");
+    ScopedTelemetry telemetry("Renderer - Render");
     static GraphicContext gfxContext("GraphicRenderer - Single Threaded Render Context");
 
+    m_RenderStats = {};
+
     m_Scheduler.BuildSchedule();
     m_Scheduler.RenderSingleThreaded(gfxContext);
 }
@@ -50,7 +58,10 @@ void Ether::Graphics::GraphicRenderer::Render()
 void Ether::Graphics::GraphicRenderer::Present()
 {
     ETH_MARKER_EVENT("Renderer - Present");
+    ScopedTelemetry telemetry("Renderer - Present");
     GraphicDisplay& gfxDisplay = GraphicCore::GetGraphicDisplay();
     gfxDisplay.SetCurrentBackBufferFence(GraphicCore::GetCommandManager().GetGraphicQueue().GetFinalFenceValue());
+    GraphicCore::GetTransientSrvCbvUavAllocator().EndFrame();
+    GraphicCore::GetUploadRingBuffer().EndFrame();
     gfxDisplay.Present();
 }
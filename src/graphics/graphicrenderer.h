@@ -20,7 +20,7 @@
 #pragma once
 
 #include "graphics/pch.h"
-#include "graphics/common/renderdata.h"
+#include "graphics/common/renderstats.h"
 #include "graphics/context/graphiccontext.h"
 #include "graphics/schedule/framescheduler.h"
 
@@ -34,7 +34,7 @@ public:
 
 public:
     inline uint64_t GetFrameNumber() const { return m_FrameNumber; }
-    inline RenderData& GetRenderData() { return m_RenderData; }
+    inline RenderStats& GetRenderStats() { return m_RenderStats; }
 
 public:
     void WaitForPresent();
@@ -45,6 +45,6 @@ private:
     uint64_t m_FrameNumber;
 
     FrameScheduler m_Scheduler;
-    RenderData m_RenderData;
+    RenderStats m_RenderStats;
 };
 } // namespace Ether::Graphics
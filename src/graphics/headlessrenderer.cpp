@@ -0,0 +1,62 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/graphiccore.h"
+#include "graphics/headlessrenderer.h"
+#include "graphics/resources/material.h"
+
+Ether::Graphics::HeadlessRenderer::HeadlessRenderer()
+    : m_FrameNumber(0)
+    , m_BatchedVisualsVersion(~0ull)
+    , m_RenderStats()
+{
+    LogGraphicsInfo("Initializing Headless Renderer");
+}
+
+void Ether::Graphics::HeadlessRenderer::Render()
+{
+    ETH_MARKER_EVENT("Headless Renderer - Render");
+
+    const RenderData& renderData = GraphicCore::GetRenderData();
+    m_RenderStats = {};
+    m_FrameNumber++;
+
+    const double submitStart = Time::GetRealTime();
+
+    // Same as the g-buffer producer, minus the command list
+    if (renderData.m_VisualsVersion != m_BatchedVisualsVersion)
+    {
+        m_InstanceBatcher.Build(renderData.m_Visuals);
+        m_BatchedVisualsVersion = renderData.m_VisualsVersion;
+    }
+
+    const std::vector<uint32_t>& instances = m_InstanceBatcher.GetInstances();
+    m_InstanceParams.resize(instances.size());
+
+    for (uint32_t i = 0; i < instances.size(); ++i)
+    {
+        const Visual& visual = renderData.m_Visuals[instances[i]];
+        m_InstanceParams[i].m_WorldMatrix = visual.m_WorldMatrix;
+        m_InstanceParams[i].m_MaterialIdx = visual.m_Material->GetTransientMaterialIdx();
+    }
+
+    m_RenderStats.m_NumDrawCalls = static_cast<uint32_t>(m_InstanceBatcher.GetDraws().size());
+    m_RenderStats.m_NumInstances = static_cast<uint32_t>(instances.size());
+    m_RenderStats.m_GeometrySubmitTime = Time::GetRealTime() - submitStart;
+}
@@ -0,0 +1,56 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "graphics/common/instancebatcher.h"
+#include "graphics/common/renderstats.h"
+#include "graphics/shaders/common/instanceparams.h"
+
+namespace Ether::Graphics
+{
+/*
+    Stands in for the GraphicRenderer when running without a device. Does the CPU side of a frame
+    (instance batching, and filling in the instance data that the g-buffer would upload) so that
+    headless runs still pay for, and can measure, render data preparation.
+*/
+class ETH_GRAPHIC_DLL HeadlessRenderer : public NonCopyable, public NonMovable
+{
+public:
+    HeadlessRenderer();
+    ~HeadlessRenderer() = default;
+
+public:
+    inline uint64_t GetFrameNumber() const { return m_FrameNumber; }
+    inline const RenderStats& GetRenderStats() const { return m_RenderStats; }
+    inline const InstanceBatcher& GetInstanceBatcher() const { return m_InstanceBatcher; }
+
+public:
+    void Render();
+
+private:
+    uint64_t m_FrameNumber;
+    uint64_t m_BatchedVisualsVersion;
+
+    InstanceBatcher m_InstanceBatcher;
+    std::vector<Shader::InstanceParams> m_InstanceParams;
+    RenderStats m_RenderStats;
+};
+} // namespace Ether::Graphics
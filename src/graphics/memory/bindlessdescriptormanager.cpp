@@ -30,18 +30,18 @@ uint32_t Ether::Graphics::BindlessDescriptorManager::RegisterAsShaderResourceVie
     if (m_GuidToIndexMap.find(resourceGuid) != m_GuidToIndexMap.end())
         LogGraphicsError("Resource GUID %s has already been registered", resourceGuid.GetString().c_str());
 
-    auto allocation = GraphicCore::GetSrvCbvUavAllocator().Allocate(1);
-    uint32_t indexInHeap = allocation->GetOffset();
+    DescriptorAllocation allocation = GraphicCore::GetSrvCbvUavAllocator().Allocate(1);
+    uint32_t indexInHeap = allocation.GetDescriptorIndex();
 
     RhiShaderResourceView srv;
     srv.SetResourceID(resource.GetResourceID());
     srv.SetFormat(format);
     srv.SetDimension(RhiResourceDimension::Texture2D);
-    srv.SetCpuAddress(((DescriptorAllocation&)(*allocation)).GetCpuAddress());
-    srv.SetGpuAddress(((DescriptorAllocation&)(*allocation)).GetGpuAddress());
+    srv.SetCpuAddress(allocation.GetCpuAddress());
+    srv.SetGpuAddress(allocation.GetGpuAddress());
 
     GraphicCore::GetDevice().InitializeShaderResourceView(srv, resource);
-    m_Allocations[resourceGuid] = std::move(allocation);
+    m_Allocations.insert_or_assign(resourceGuid, std::move(allocation));
     m_GuidToIndexMap[resourceGuid] = indexInHeap;
     return indexInHeap;
 }
@@ -54,20 +54,20 @@ uint32_t Ether::Graphics::BindlessDescriptorManager::RegisterAsShaderResourceVie
     if (m_GuidToIndexMap.find(resourceGuid) != m_GuidToIndexMap.end())
         LogGraphicsError("Resource GUID %s has already been registered", resourceGuid.GetString().c_str());
 
-    auto allocation = GraphicCore::GetSrvCbvUavAllocator().Allocate(1);
-    uint32_t indexInHeap = allocation->GetOffset();
+    DescriptorAllocation allocation = GraphicCore::GetSrvCbvUavAllocator().Allocate(1);
+    uint32_t indexInHeap = allocation.GetDescriptorIndex();
 
     RhiShaderResourceView srv;
     srv.SetResourceID(resource.GetResourceID());
     srv.SetFormat(RhiFormat::Unknown);
     srv.SetDimension(RhiResourceDimension::StructuredBuffer);
-    srv.SetCpuAddress(((DescriptorAllocation&)(*allocation)).GetCpuAddress());
-    srv.SetGpuAddress(((DescriptorAllocation&)(*allocation)).GetGpuAddress());
+    srv.SetCpuAddress(allocation.GetCpuAddress());
+    srv.SetGpuAddress(allocation.GetGpuAddress());
     srv.SetWidth(vb.m_BufferSize);
     srv.SetStructuredBufferStride(vb.m_Stride);
 
     GraphicCore::GetDevice().InitializeShaderResourceView(srv, resource);
-    m_Allocations[resourceGuid] = std::move(allocation);
+    m_Allocations.insert_or_assign(resourceGuid, std::move(allocation));
     m_GuidToIndexMap[resourceGuid] = indexInHeap;
     return indexInHeap;
 }
@@ -80,23 +80,29 @@ uint32_t Ether::Graphics::BindlessDescriptorManager::RegisterAsShaderResourceVie
     if (m_GuidToIndexMap.find(resourceGuid) != m_GuidToIndexMap.end())
         LogGraphicsError("Resource GUID %s has already been registered", resourceGuid.GetString().c_str());
 
-    auto allocation = GraphicCore::GetSrvCbvUavAllocator().Allocate(1);
-    uint32_t indexInHeap = allocation->GetOffset();
+    DescriptorAllocation allocation = GraphicCore::GetSrvCbvUavAllocator().Allocate(1);
+    uint32_t indexInHeap = allocation.GetDescriptorIndex();
 
     RhiShaderResourceView srv;
     srv.SetResourceID(resource.GetResourceID());
     srv.SetDimension(RhiResourceDimension::StructuredBuffer);
-    srv.SetCpuAddress(((DescriptorAllocation&)(*allocation)).GetCpuAddress());
-    srv.SetGpuAddress(((DescriptorAllocation&)(*allocation)).GetGpuAddress());
+    srv.SetCpuAddress(allocation.GetCpuAddress());
+    srv.SetGpuAddress(allocation.GetGpuAddress());
     srv.SetWidth(ib.m_BufferSize);
     srv.SetStructuredBufferStride(sizeof(uint32_t));
 
     GraphicCore::GetDevice().InitializeShaderResourceView(srv, resource);
-    m_Allocations[resourceGuid] = std::move(allocation);
+    m_Allocations.insert_or_assign(resourceGuid, std::move(allocation));
     m_GuidToIndexMap[resourceGuid] = indexInHeap;
     return indexInHeap;
 }
 
+void Ether::Graphics::BindlessDescriptorManager::Unregister(StringID guid)
+{
+    m_GuidToIndexMap.erase(guid);
+    m_Allocations.erase(guid);
+}
+
 uint32_t Ether::Graphics::BindlessDescriptorManager::GetDescriptorIndex(StringID guid) const
 {
     if (m_GuidToIndexMap.find(guid) == m_GuidToIndexMap.end())
@@ -110,11 +116,11 @@ uint32_t Ether::Graphics::BindlessDescriptorManager::RegisterSampler(StringID na
     if (m_GuidToIndexMap.find(name) != m_GuidToIndexMap.end())
         LogGraphicsError("Sampler %s has already been registered", name.GetString().c_str());
 
-    auto allocation = GraphicCore::GetSamplerAllocator().Allocate(1);
-    uint32_t indexInHeap = allocation->GetOffset();
+    DescriptorAllocation allocation = GraphicCore::GetSamplerAllocator().Allocate(1);
+    uint32_t indexInHeap = allocation.GetDescriptorIndex();
 
-    GraphicCore::GetDevice().CopySampler(sampler, ((DescriptorAllocation&)(*allocation)).GetCpuAddress());
-    m_Allocations[name] = std::move(allocation);
+    GraphicCore::GetDevice().CopySampler(sampler, allocation.GetCpuAddress());
+    m_Allocations.insert_or_assign(name, std::move(allocation));
     m_GuidToIndexMap[name] = indexInHeap;
 
     return indexInHeap;
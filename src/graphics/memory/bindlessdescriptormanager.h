@@ -39,10 +39,13 @@ public:
     uint32_t RegisterAsShaderResourceView(StringID resourceGuid, const RhiResource& resource, RhiIndexBufferViewDesc ib);
     uint32_t RegisterSampler(StringID name, RhiSamplerParameterDesc& sampler);
 
+    // The descriptor is only reused once the GPU is done with the frames that may still read it
+    void Unregister(StringID guid);
+
     uint32_t GetDescriptorIndex(StringID guid) const;
 
 private:
     std::unordered_map<StringID, uint32_t> m_GuidToIndexMap;
-    std::unordered_map<StringID, std::unique_ptr<MemoryAllocation>> m_Allocations;
+    std::unordered_map<StringID, DescriptorAllocation> m_Allocations;
 };
 } // namespace Ether::Graphics
@@ -21,59 +21,58 @@
 #include "graphics/memory/descriptorallocator.h"
 
 Ether::Graphics::DescriptorAllocation::DescriptorAllocation(
+    const AllocationHandle& handle,
     RhiCpuAddress allocBaseCpuAddr,
     RhiGpuAddress allocBaseGpuAddr,
-    size_t numDescriptors,
     size_t descriptorSize,
-    size_t indexInAllocator,
     DescriptorAllocator* parentAllocator)
-    : FreeListAllocation(indexInAllocator, numDescriptors)
+    : m_Handle(handle)
     , m_BaseCpuAddress(allocBaseCpuAddr)
     , m_BaseGpuAddress(allocBaseGpuAddr)
     , m_DescriptorSize(descriptorSize)
     , m_Parent(parentAllocator)
-    , m_IsValid(true)
 {
 }
 
 Ether::Graphics::DescriptorAllocation::~DescriptorAllocation() noexcept
 {
-    if (m_IsValid)
+    if (IsValid())
         m_Parent->Free(*this);
 }
 
 Ether::Graphics::DescriptorAllocation::DescriptorAllocation(DescriptorAllocation&& move) noexcept
-    : FreeListAllocation(move.m_Offset, move.m_Size)
+    : m_Handle(move.m_Handle)
     , m_BaseCpuAddress(move.m_BaseCpuAddress)
     , m_BaseGpuAddress(move.m_BaseGpuAddress)
     , m_DescriptorSize(move.m_DescriptorSize)
     , m_Parent(move.m_Parent)
-    , m_IsValid(move.m_IsValid)
 {
-    move.m_IsValid = false;
+    move.m_Parent = nullptr;
 }
 
 Ether::Graphics::DescriptorAllocation& Ether::Graphics::DescriptorAllocation::operator=(
     DescriptorAllocation&& move) noexcept
 {
-    m_Parent->Free(*this);
+    if (this == &move)
+        return *this;
 
+    if (IsValid())
+        m_Parent->Free(*this);
+
+    m_Handle = move.m_Handle;
     m_BaseCpuAddress = move.m_BaseCpuAddress;
     m_BaseGpuAddress = move.m_BaseGpuAddress;
-    m_Size = move.m_Size;
     m_DescriptorSize = move.m_DescriptorSize;
-    m_Offset = move.m_Offset;
     m_Parent = move.m_Parent;
-    m_IsValid = move.m_IsValid;
 
-    move.m_IsValid = false;
+    move.m_Parent = nullptr;
 
     return *this;
 }
 
 size_t Ether::Graphics::DescriptorAllocation::GetDescriptorIndex(size_t localIndex) const
 {
-    return m_Offset + localIndex;
+    return m_Handle.m_Offset + localIndex;
 }
 
 Ether::Graphics::RhiCpuAddress Ether::Graphics::DescriptorAllocation::GetCpuAddress(size_t localIndex) const
@@ -20,21 +20,22 @@
 #pragma once
 
 #include "graphics/pch.h"
-#include "common/memory/freelistallocator.h"
+#include "common/memory/tlsfallocator.h"
 
 namespace Ether::Graphics
 {
 class DescriptorAllocator;
 
-class DescriptorAllocation : public FreeListAllocation
+// Returns its descriptors to the parent allocator when destroyed
+class DescriptorAllocation
 {
 public:
+    DescriptorAllocation() = default;
     DescriptorAllocation(
+        const AllocationHandle& handle,
         RhiCpuAddress allocBaseCpuHandle,
         RhiGpuAddress allocBaseGpuHandle,
-        size_t numDescriptors,
         size_t descriptorSize,
-        size_t indexInAllocator,
         DescriptorAllocator* parentAllocator);
 
     ~DescriptorAllocation() noexcept;
@@ -45,11 +46,9 @@ public:
     DescriptorAllocation& operator=(DescriptorAllocation&& move) noexcept;
 
 public:
-    size_t GetOffset() const override { return m_Offset; }
-    size_t GetSize() const override { return m_Size; }
-
-public:
-    inline size_t GetNumDescriptors() const { return m_Size; }
+    inline bool IsValid() const { return m_Parent != nullptr; }
+    inline size_t GetNumDescriptors() const { return m_Handle.m_Size; }
+    inline const AllocationHandle& GetHandle() const { return m_Handle; }
 
 public:
     size_t GetDescriptorIndex(size_t localIndex = 0) const;
@@ -57,12 +56,12 @@ public:
     RhiGpuAddress GetGpuAddress(size_t localIndex = 0) const;
 
 private:
-    RhiCpuAddress m_BaseCpuAddress;
-    RhiGpuAddress m_BaseGpuAddress;
+    AllocationHandle m_Handle;
+    RhiCpuAddress m_BaseCpuAddress = 0;
+    RhiGpuAddress m_BaseGpuAddress = 0;
 
-    size_t m_DescriptorSize;
+    size_t m_DescriptorSize = 0;
 
-    DescriptorAllocator* m_Parent;
-    bool m_IsValid;
+    DescriptorAllocator* m_Parent = nullptr;
 };
 } // namespace Ether::Graphics
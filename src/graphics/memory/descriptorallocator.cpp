@@ -26,25 +26,40 @@ Ether::Graphics::DescriptorAllocator::DescriptorAllocator(
     RhiDescriptorHeapType type,
     size_t maxHeapSize,
     bool isShaderVisible)
-    : FreeListAllocator(maxHeapSize)
+    : m_MaxDescriptors(maxHeapSize)
     , m_HeapType(type)
-    , m_MaxDescriptors(maxHeapSize)
+    , m_Allocator(maxHeapSize)
 {
     m_DescriptorHeap = GraphicCore::GetDevice().CreateDescriptorHeap(type, maxHeapSize, isShaderVisible);
     m_IsShaderVisible = isShaderVisible;
 }
 
-std::unique_ptr<Ether::MemoryAllocation> Ether::Graphics::DescriptorAllocator::Allocate(SizeAlign sizeAlign)
+Ether::Graphics::DescriptorAllocation Ether::Graphics::DescriptorAllocator::Allocate(SizeAlign sizeAlign)
 {
-    std::unique_ptr<MemoryAllocation> baseAlloc = FreeListAllocator::Allocate(sizeAlign);
+    AllocationHandle baseAlloc = m_Allocator.Allocate(sizeAlign);
 
-    if (baseAlloc == nullptr)
+    if (!baseAlloc.IsValid())
     {
-        ReclaimStaleAllocations(sizeAlign.m_Size);
-        baseAlloc = FreeListAllocator::Allocate(sizeAlign);
+        ReclaimStaleAllocations();
+        baseAlloc = m_Allocator.Allocate(sizeAlign);
     }
 
-    size_t descriptorIdx = baseAlloc->GetOffset();
+    if (!baseAlloc.IsValid() && !m_StaleAllocations.empty())
+    {
+        // Whatever is left is still referenced by frames in flight
+        LogGraphicsWarning("Descriptor heap is full - waiting for the GPU to release stale descriptors");
+        GraphicCore::FlushGpu();
+        ReclaimStaleAllocations();
+        baseAlloc = m_Allocator.Allocate(sizeAlign);
+    }
+
+    if (!baseAlloc.IsValid())
+    {
+        LogGraphicsFatal("Descriptor allocation failed - heap is full or too fragmented");
+        throw std::bad_alloc();
+    }
+
+    size_t descriptorIdx = baseAlloc.m_Offset;
     size_t descriptorSize = m_DescriptorHeap->GetHandleIncrementSize();
 
     RhiCpuAddress allocBaseCpuHandle = m_DescriptorHeap->GetBaseCpuAddress() + descriptorIdx * descriptorSize;
@@ -52,57 +67,38 @@ std::unique_ptr<Ether::MemoryAllocation> Ether::Graphics::DescriptorAllocator::A
                                            ? m_DescriptorHeap->GetBaseGpuAddress() + descriptorIdx * descriptorSize
                                            : NullAddress;
 
-    return std::make_unique<DescriptorAllocation>(
-        allocBaseCpuHandle,
-        allocBaseGpuHandle,
-        sizeAlign.m_Size,
-        descriptorSize,
-        baseAlloc->GetOffset(),
-        this);
-}
-
-void Ether::Graphics::DescriptorAllocator::Free(std::unique_ptr<Ether::MemoryAllocation>&& alloc)
-{
-    alloc.reset();
+    return { baseAlloc, allocBaseCpuHandle, allocBaseGpuHandle, descriptorSize, this };
 }
 
 void Ether::Graphics::DescriptorAllocator::Free(const DescriptorAllocation& allocation)
 {
-    m_StaleAllocations.emplace(allocation.GetDescriptorIndex(), allocation.GetNumDescriptors());
+    RhiFenceValue fenceValue = GraphicCore::GetCommandManager().GetGraphicQueue().GetFinalFenceValue();
+    m_StaleAllocations.emplace(allocation.GetHandle(), fenceValue);
 }
 
-void Ether::Graphics::DescriptorAllocator::ReclaimStaleAllocations(size_t numIndices)
+void Ether::Graphics::DescriptorAllocator::ReclaimStaleAllocations()
 {
-    while (!m_StaleAllocations.empty())
-    {
-        FreeListAllocation staleAlloc = m_StaleAllocations.front();
-        m_StaleAllocations.pop();
-        FreeBlock(staleAlloc.GetOffset(), staleAlloc.GetSize());
+    RhiFenceValue completedFenceValue = GraphicCore::GetCommandManager().GetGraphicQueue().GetCurrentFenceValue();
 
-        if (numIndices > 0)
-            numIndices -= staleAlloc.GetSize();
-    }
-
-    if (numIndices > 0)
+    while (!m_StaleAllocations.empty() && m_StaleAllocations.front().second <= completedFenceValue)
     {
-        LogGraphicsFatal("Descriptor heap is full - no stale indices to reclaim");
-        LogGraphicsFatal("Descriptor allocation failed - heap is already full");
-        throw std::bad_alloc();
+        m_Allocator.Free(m_StaleAllocations.front().first);
+        m_StaleAllocations.pop();
     }
 }
 
-std::unique_ptr<Ether::MemoryAllocation> Ether::Graphics::DescriptorAllocator::Commit(
+Ether::Graphics::DescriptorAllocation Ether::Graphics::DescriptorAllocator::Commit(
     const RhiResourceView* descriptors[],
     uint32_t numDescriptors)
 {
-    std::unique_ptr<MemoryAllocation> newAlloc = Allocate({ numDescriptors, 1 });
+    DescriptorAllocation newAlloc = Allocate({ numDescriptors, 1 });
 
     for (uint32_t i = 0; i < numDescriptors; ++i)
     {
         GraphicCore::GetDevice().CopyDescriptors(
             1,
             descriptors[i]->GetCpuAddress(),
-            ((DescriptorAllocation&)*newAlloc).GetCpuAddress(i),
+            newAlloc.GetCpuAddress(i),
             m_HeapType);
     }
 
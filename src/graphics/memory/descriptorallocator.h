@@ -20,14 +20,14 @@
 #pragma once
 
 #include "graphics/pch.h"
-#include "common/memory/freelistallocator.h"
+#include "common/memory/tlsfallocator.h"
 #include "graphics/rhi/rhidescriptorheap.h"
 #include "graphics/memory/descriptorallocation.h"
 #include <queue>
 
 namespace Ether::Graphics
 {
-class DescriptorAllocator : public FreeListAllocator
+class DescriptorAllocator : public NonCopyable, public NonMovable
 {
 public:
     DescriptorAllocator(RhiDescriptorHeapType type, size_t maxHeapSize = _4MiB, bool isShaderVisible = false);
@@ -35,21 +35,19 @@ public:
     ~DescriptorAllocator() = default;
 
 public:
-    std::unique_ptr<MemoryAllocation> Allocate(SizeAlign = { 1, 1 }) override;
-    void Free(std::unique_ptr<MemoryAllocation>&& alloc) override;
-
-public:
-    std::unique_ptr<MemoryAllocation> Commit(const RhiResourceView* descriptors[], uint32_t numDescriptors);
+    DescriptorAllocation Allocate(SizeAlign sizeAlign = { 1, 1 });
+    DescriptorAllocation Commit(const RhiResourceView* descriptors[], uint32_t numDescriptors);
 
 public:
     inline RhiDescriptorHeap& GetDescriptorHeap() const { return *m_DescriptorHeap; }
     inline size_t GetMaxNumDescriptors() const { return m_MaxDescriptors; }
     inline bool IsShaderVisible() const { return m_IsShaderVisible; }
+    inline RhiDescriptorHeapType GetHeapType() const { return m_HeapType; }
 
 private:
     friend class DescriptorAllocation;
     void Free(const DescriptorAllocation& allocation);
-    void ReclaimStaleAllocations(size_t numIndices);
+    void ReclaimStaleAllocations();
 
 private:
     size_t m_MaxDescriptors;
@@ -57,6 +55,9 @@ private:
 
     RhiDescriptorHeapType m_HeapType;
     std::unique_ptr<RhiDescriptorHeap> m_DescriptorHeap;
-    std::queue<FreeListAllocation> m_StaleAllocations;
+
+    TlsfAllocator m_Allocator;
+    // Freed descriptors are only reused once the graphic queue is past the fence they were freed at
+    std::queue<std::pair<AllocationHandle, RhiFenceValue>> m_StaleAllocations;
 };
 } // namespace Ether::Graphics
@@ -0,0 +1,81 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/graphiccore.h"
+#include "graphics/memory/transientdescriptorallocator.h"
+#include "graphics/memory/descriptorallocator.h"
+#include "graphics/rhi/rhidevice.h"
+#include "graphics/rhi/rhiresourceviews.h"
+
+Ether::Graphics::TransientDescriptorAllocator::TransientDescriptorAllocator(
+    DescriptorAllocator& parentAllocator,
+    size_t numDescriptors)
+    : m_HeapType(parentAllocator.GetHeapType())
+    , m_DescriptorSize(parentAllocator.GetDescriptorHeap().GetHandleIncrementSize())
+    , m_Reservation(parentAllocator.Allocate({ numDescriptors, 1 }))
+    , m_Ring(numDescriptors)
+{
+}
+
+Ether::Graphics::TransientDescriptorAllocation Ether::Graphics::TransientDescriptorAllocator::Allocate(
+    uint32_t numDescriptors)
+{
+    AllocationHandle alloc = m_Ring.Allocate({ numDescriptors, 1 });
+
+    if (!alloc.IsValid())
+    {
+        LogGraphicsFatal("Transient descriptor allocation failed - frame has used up %zu descriptors", m_Ring.GetFrameCapacity());
+        throw std::bad_alloc();
+    }
+
+    return {
+        alloc,
+        m_Reservation.GetCpuAddress(alloc.m_Offset),
+        m_Reservation.GetGpuAddress(alloc.m_Offset),
+        m_DescriptorSize
+    };
+}
+
+Ether::Graphics::TransientDescriptorAllocation Ether::Graphics::TransientDescriptorAllocator::Commit(
+    const RhiResourceView* descriptors[],
+    uint32_t numDescriptors)
+{
+    TransientDescriptorAllocation newAlloc = Allocate(numDescriptors);
+
+    for (uint32_t i = 0; i < numDescriptors; ++i)
+    {
+        GraphicCore::GetDevice().CopyDescriptors(
+            1,
+            descriptors[i]->GetCpuAddress(),
+            newAlloc.GetCpuAddress(i),
+            m_HeapType);
+    }
+
+    return newAlloc;
+}
+
+void Ether::Graphics::TransientDescriptorAllocator::BeginFrame()
+{
+    m_Ring.BeginFrame(GraphicCore::GetCommandManager().GetGraphicQueue().GetCurrentFenceValue());
+}
+
+void Ether::Graphics::TransientDescriptorAllocator::EndFrame()
+{
+    m_Ring.EndFrame(GraphicCore::GetCommandManager().GetGraphicQueue().GetFinalFenceValue());
+}
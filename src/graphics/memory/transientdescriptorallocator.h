@@ -0,0 +1,90 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "common/memory/frameringallocator.h"
+#include "graphics/memory/descriptorallocation.h"
+
+namespace Ether::Graphics
+{
+class DescriptorAllocator;
+
+// Only valid until the GPU is done with the frame it was allocated in
+class TransientDescriptorAllocation
+{
+public:
+    TransientDescriptorAllocation() = default;
+    TransientDescriptorAllocation(
+        const AllocationHandle& handle,
+        RhiCpuAddress baseCpuAddress,
+        RhiGpuAddress baseGpuAddress,
+        size_t descriptorSize)
+        : m_Handle(handle)
+        , m_BaseCpuAddress(baseCpuAddress)
+        , m_BaseGpuAddress(baseGpuAddress)
+        , m_DescriptorSize(descriptorSize)
+    {
+    }
+
+public:
+    inline bool IsValid() const { return m_Handle.IsValid(); }
+    inline size_t GetNumDescriptors() const { return m_Handle.m_Size; }
+    inline RhiCpuAddress GetCpuAddress(size_t localIndex = 0) const { return m_BaseCpuAddress + localIndex * m_DescriptorSize; }
+    inline RhiGpuAddress GetGpuAddress(size_t localIndex = 0) const { return m_BaseGpuAddress + localIndex * m_DescriptorSize; }
+
+private:
+    AllocationHandle m_Handle;
+    RhiCpuAddress m_BaseCpuAddress = 0;
+    RhiGpuAddress m_BaseGpuAddress = 0;
+
+    size_t m_DescriptorSize = 0;
+};
+
+/**
+ * Descriptors that only live for a single frame (e.g. descriptor tables assembled while recording).
+ * A range is reserved from the persistent allocator's heap up front so that both can be bound at once,
+ * and is then sub-allocated as a frame ring that is reclaimed when the graphic queue retires the frame.
+ * Allocate() and Commit() can be called from multiple recording threads.
+ */
+class TransientDescriptorAllocator : public NonCopyable, public NonMovable
+{
+public:
+    TransientDescriptorAllocator(DescriptorAllocator& parentAllocator, size_t numDescriptors);
+    ~TransientDescriptorAllocator() = default;
+
+public:
+    TransientDescriptorAllocation Allocate(uint32_t numDescriptors);
+    TransientDescriptorAllocation Commit(const RhiResourceView* descriptors[], uint32_t numDescriptors);
+
+    void BeginFrame();
+    void EndFrame();
+
+public:
+    inline size_t GetMaxNumDescriptors() const { return m_Reservation.GetNumDescriptors(); }
+    inline size_t GetNumDescriptorsThisFrame() const { return m_Ring.GetFrameSize(); }
+
+private:
+    RhiDescriptorHeapType m_HeapType;
+    size_t m_DescriptorSize;
+    DescriptorAllocation m_Reservation;
+    FrameRingAllocator m_Ring;
+};
+} // namespace Ether::Graphics
@@ -20,12 +20,11 @@
 #include "graphics/memory/uploadbufferallocation.h"
 
 Ether::Graphics::UploadBufferAllocation::UploadBufferAllocation(
-    size_t offset,
-    size_t size,
+    const AllocationHandle& handle,
     void* mappedBaseAddr,
     RhiResource& resource)
-    : LinearAllocation(offset, size)
+    : m_Handle(handle)
     , m_MappedBaseAddress(mappedBaseAddr)
-    , m_Resource(resource)
+    , m_Resource(&resource)
 {
 }
@@ -24,20 +24,24 @@
 
 namespace Ether::Graphics
 {
-class UploadBufferAllocation : public LinearAllocation
+class UploadBufferAllocation
 {
 public:
-    UploadBufferAllocation(size_t offset, size_t size, void* mappedBaseAddr, RhiResource& resource);
+    UploadBufferAllocation() = default;
+    UploadBufferAllocation(const AllocationHandle& handle, void* mappedBaseAddr, RhiResource& resource);
 
 public:
-    inline void* GetBaseCpuHandle() const override { return m_MappedBaseAddress; }
+    inline bool IsValid() const { return m_Resource != nullptr; }
+    inline size_t GetOffset() const { return m_Handle.m_Offset; }
+    inline size_t GetSize() const { return m_Handle.m_Size; }
 
-    inline RhiGpuAddress GetBaseGpuAddress() const { return m_Resource.GetGpuAddress(); }
-    inline RhiGpuAddress GetGpuAddress() const { return GetBaseGpuAddress() + m_Offset; }
-    inline RhiResource& GetResource() { return m_Resource; }
+    inline void* GetCpuHandle() const { return static_cast<uint8_t*>(m_MappedBaseAddress) + m_Handle.m_Offset; }
+    inline RhiGpuAddress GetGpuAddress() const { return m_Resource->GetGpuAddress() + m_Handle.m_Offset; }
+    inline RhiResource& GetResource() const { return *m_Resource; }
 
 protected:
-    void* m_MappedBaseAddress;
-    RhiResource& m_Resource;
+    AllocationHandle m_Handle;
+    void* m_MappedBaseAddress = nullptr;
+    RhiResource* m_Resource = nullptr;
 };
 } // namespace Ether::Graphics
@@ -20,44 +20,46 @@
 #include "graphics/memory/uploadbufferallocator.h"
 
 Ether::Graphics::UploadBufferAllocator::UploadBufferAllocator(size_t pageSize)
-    : MemoryAllocator(std::numeric_limits<size_t>::max()) // No upper bound on max number of pages
-    , m_PageSize(pageSize)
+    : m_PageSize(pageSize)
 {
     m_CurrentPage = GetNextAvailablePage();
 }
 
-std::unique_ptr<Ether::MemoryAllocation> Ether::Graphics::UploadBufferAllocator::Allocate(SizeAlign sizeAlign)
+Ether::Graphics::UploadBufferAllocation Ether::Graphics::UploadBufferAllocator::Allocate(SizeAlign sizeAlign)
 {
-    if (AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment) > m_PageSize)
-        return nullptr;
+    if (!HasSpace(sizeAlign))
+    {
+        m_DedicatedPages.emplace_back(std::make_unique<UploadBufferAllocatorPage>(AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment)));
+        UploadBufferAllocatorPage& page = *m_DedicatedPages.back();
+        return { page.Allocate(sizeAlign), page.GetMappedAddress(), page.GetResource() };
+    }
 
     if (!m_CurrentPage->HasSpace(sizeAlign))
         m_CurrentPage = GetNextAvailablePage();
 
-    return m_CurrentPage->Allocate(sizeAlign);
-}
-
-void Ether::Graphics::UploadBufferAllocator::Free(std::unique_ptr<MemoryAllocation>&& alloc)
-{
-    // Page is implemented as a linear allocator which does not support freeing.
-    // UploadBufferAllocation& alloc = dynamic_cast<UploadBufferAllocation&>(*alloc);
-    // alloc->GetAllocator()->Free(alloc);
+    return { m_CurrentPage->Allocate(sizeAlign), m_CurrentPage->GetMappedAddress(), m_CurrentPage->GetResource() };
 }
 
 bool Ether::Graphics::UploadBufferAllocator::HasSpace(SizeAlign sizeAlign) const
 {
-    return m_CurrentPage->HasSpace(sizeAlign) || m_PagePool.size() >= m_Capacity;
+    // A new page is created whenever the current one is full
+    return AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment) <= m_PageSize;
 }
 
 void Ether::Graphics::UploadBufferAllocator::Reset()
 {
     m_AvaliablePages.clear();
+    m_DedicatedPages.clear();
 
     for (auto& page : m_PagePool)
     {
         page->Reset();
         m_AvaliablePages.push_back(page.get());
     }
+
+    // The current page was just returned to the available list as well, so a fresh one has to be
+    // picked or it could later be handed out a second time while still in use
+    m_CurrentPage = GetNextAvailablePage();
 }
 
 Ether::Graphics::UploadBufferAllocatorPage* Ether::Graphics::UploadBufferAllocator::GetNextAvailablePage()
@@ -73,9 +75,6 @@ Ether::Graphics::UploadBufferAllocatorPage* Ether::Graphics::UploadBufferAllocat
 
 void Ether::Graphics::UploadBufferAllocator::AllocatePage()
 {
-    if (m_PagePool.size() >= m_Capacity)
-        throw std::bad_alloc();
-
     m_PagePool.emplace_back(std::make_unique<UploadBufferAllocatorPage>(m_PageSize));
     m_AvaliablePages.push_back(m_PagePool.back().get());
 }
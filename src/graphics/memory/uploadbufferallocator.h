@@ -24,17 +24,20 @@
 
 namespace Ether::Graphics
 {
-class UploadBufferAllocator : public MemoryAllocator
+/*
+    Grows by whole pages and only frees everything at once through Reset(), so it is not a MemoryAllocator.
+*/
+class UploadBufferAllocator : public NonCopyable, public NonMovable
 {
 public:
     UploadBufferAllocator(size_t pageSize = _4KiB);
     ~UploadBufferAllocator() = default;
 
 public:
-    std::unique_ptr<MemoryAllocation> Allocate(SizeAlign sizeAlign) override;
-    void Free(std::unique_ptr<MemoryAllocation>&& alloc) override;
-    bool HasSpace(SizeAlign sizeAlign) const override;
-    void Reset() override;
+    // Requests that do not fit into a page get a dedicated page, which is released on Reset()
+    UploadBufferAllocation Allocate(SizeAlign sizeAlign);
+    bool HasSpace(SizeAlign sizeAlign) const;
+    void Reset();
 
 private:
     UploadBufferAllocatorPage* GetNextAvailablePage();
@@ -43,6 +46,7 @@ private:
 private:
     std::vector<std::unique_ptr<UploadBufferAllocatorPage>> m_PagePool;
     std::vector<UploadBufferAllocatorPage*> m_AvaliablePages;
+    std::vector<std::unique_ptr<UploadBufferAllocatorPage>> m_DedicatedPages;
 
     UploadBufferAllocatorPage* m_CurrentPage;
     const size_t m_PageSize;
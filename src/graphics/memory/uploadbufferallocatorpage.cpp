@@ -37,17 +37,3 @@ Ether::Graphics::UploadBufferAllocatorPage::~UploadBufferAllocatorPage()
 {
     m_UploadHeap->Unmap();
 }
-
-std::unique_ptr<Ether::MemoryAllocation> Ether::Graphics::UploadBufferAllocatorPage::Allocate(SizeAlign sizeAlign)
-{
-    std::unique_ptr<MemoryAllocation> baseAlloc = LinearAllocator::Allocate(sizeAlign);
-
-    if (baseAlloc == nullptr)
-        return nullptr;
-
-    return std::make_unique<UploadBufferAllocation>(
-        baseAlloc->GetOffset(),
-        baseAlloc->GetSize(),
-        m_BaseAddress,
-        *m_UploadHeap);
-}
@@ -31,7 +31,8 @@ public:
     ~UploadBufferAllocatorPage();
 
 public:
-    std::unique_ptr<MemoryAllocation> Allocate(SizeAlign sizeAlign) override;
+    inline void* GetMappedAddress() const { return m_BaseAddress; }
+    inline RhiResource& GetResource() const { return *m_UploadHeap; }
 
 protected:
     std::unique_ptr<RhiResource> m_UploadHeap;
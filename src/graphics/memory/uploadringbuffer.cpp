@@ -0,0 +1,173 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/graphiccore.h"
+#include "graphics/memory/uploadringbuffer.h"
+
+Ether::Graphics::UploadRingBuffer::UploadBlock::UploadBlock(size_t size, const char* name, bool isRing)
+    : m_MappedAddress(nullptr)
+    , m_TrackedMemory(MemoryTag::GraphicsStaging)
+{
+    RhiCommitedResourceDesc desc = {};
+    desc.m_HeapType = RhiHeapType::Upload;
+    desc.m_State = RhiResourceState::GenericRead;
+    desc.m_ResourceDesc = RhiCreateBufferResourceDesc(size);
+    desc.m_Name = name;
+
+    m_Resource = GraphicCore::GetDevice().CreateCommittedResource(desc);
+    m_Resource->Map(&m_MappedAddress);
+
+    if (isRing)
+        m_Allocator = std::make_unique<FrameRingAllocator>(size);
+
+    m_TrackedMemory.Set(size);
+}
+
+Ether::Graphics::UploadRingBuffer::UploadBlock::~UploadBlock()
+{
+    m_Resource->Unmap();
+}
+
+Ether::Graphics::UploadRingBuffer::UploadRingBuffer(size_t initialCapacity, size_t dedicatedThreshold)
+    : m_DedicatedThreshold(dedicatedThreshold)
+    , m_FrameRequestedRingBytes(0)
+    , m_FrameRetiredRingBytes(0)
+    , m_FrameDedicatedBytes(0)
+    , m_Stats()
+{
+    m_Ring = std::make_unique<UploadBlock>(initialCapacity, "UploadRingBuffer::Ring", true);
+    m_CurrentRing.store(m_Ring.get(), std::memory_order_release);
+    ResetStats();
+}
+
+Ether::Graphics::UploadBufferAllocation Ether::Graphics::UploadRingBuffer::Allocate(SizeAlign sizeAlign)
+{
+    if (AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment) > m_DedicatedThreshold)
+        return AllocateDedicated(sizeAlign);
+
+    m_FrameRequestedRingBytes.fetch_add(sizeAlign.m_Size, std::memory_order_relaxed);
+
+    UploadBlock* ring = m_CurrentRing.load(std::memory_order_acquire);
+    AllocationHandle alloc = ring->m_Allocator->Allocate(sizeAlign);
+
+    while (!alloc.IsValid())
+    {
+        ring = Grow(ring, sizeAlign);
+        alloc = ring->m_Allocator->Allocate(sizeAlign);
+    }
+
+    return { alloc, ring->m_MappedAddress, *ring->m_Resource };
+}
+
+void Ether::Graphics::UploadRingBuffer::BeginFrame()
+{
+    ETH_MARKER_EVENT("Upload Ring Buffer - Begin Frame");
+    const RhiFenceValue completedFenceValue = GraphicCore::GetCommandManager().GetGraphicQueue().GetCurrentFenceValue();
+
+    while (!m_PendingRelease.empty() && m_PendingRelease.front().second <= completedFenceValue)
+        m_PendingRelease.pop();
+
+    m_Ring->m_Allocator->BeginFrame(completedFenceValue);
+    m_FrameRequestedRingBytes.store(0, std::memory_order_relaxed);
+    m_FrameRetiredRingBytes = 0;
+    m_FrameDedicatedBytes = 0;
+}
+
+void Ether::Graphics::UploadRingBuffer::EndFrame()
+{
+    ETH_MARKER_EVENT("Upload Ring Buffer - End Frame");
+    const RhiFenceValue fenceValue = GraphicCore::GetCommandManager().GetGraphicQueue().GetFinalFenceValue();
+
+    const size_t ringBytes = m_FrameRetiredRingBytes + m_Ring->m_Allocator->GetFrameSize();
+    const size_t requestedBytes = m_FrameRequestedRingBytes.load(std::memory_order_relaxed);
+    const size_t wastedBytes = ringBytes - (std::min)(ringBytes, requestedBytes);
+
+    m_Ring->m_Allocator->EndFrame(fenceValue);
+
+    for (auto& block : m_RetiredThisFrame)
+        m_PendingRelease.emplace(std::move(block), fenceValue);
+    m_RetiredThisFrame.clear();
+
+    m_Stats.m_NumFrames++;
+    m_Stats.m_LastFrameBytes = ringBytes + m_FrameDedicatedBytes;
+    m_Stats.m_PeakFrameBytes = (std::max)(m_Stats.m_PeakFrameBytes, m_Stats.m_LastFrameBytes);
+    m_Stats.m_AverageFrameBytes += (m_Stats.m_LastFrameBytes - m_Stats.m_AverageFrameBytes) / m_Stats.m_NumFrames;
+    m_Stats.m_LastFrameWastedBytes = wastedBytes;
+    m_Stats.m_PeakFrameWastedBytes = (std::max)(m_Stats.m_PeakFrameWastedBytes, wastedBytes);
+    m_Stats.m_AverageFrameWastedBytes += (wastedBytes - m_Stats.m_AverageFrameWastedBytes) / m_Stats.m_NumFrames;
+    m_Stats.m_LastFrameDedicatedBytes = m_FrameDedicatedBytes;
+}
+
+void Ether::Graphics::UploadRingBuffer::ResetStats()
+{
+    const uint32_t numGrowths = m_Stats.m_NumGrowths;
+    m_Stats = {};
+    m_Stats.m_Capacity = m_Ring->m_Allocator->GetCapacity();
+    m_Stats.m_NumGrowths = numGrowths;
+}
+
+Ether::Graphics::UploadBufferAllocation Ether::Graphics::UploadRingBuffer::AllocateDedicated(SizeAlign sizeAlign)
+{
+    // Committed buffers are placed at 64KiB boundaries, which covers any alignment uploads ask for
+    const size_t alignedSize = AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment);
+    auto block = std::make_unique<UploadBlock>(alignedSize, "UploadRingBuffer::Dedicated", false);
+
+    AllocationHandle alloc = {};
+    alloc.m_Size = alignedSize;
+    UploadBufferAllocation uploadAlloc = { alloc, block->m_MappedAddress, *block->m_Resource };
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_FrameDedicatedBytes += alignedSize;
+    m_RetiredThisFrame.push_back(std::move(block));
+    return uploadAlloc;
+}
+
+Ether::Graphics::UploadRingBuffer::UploadBlock* Ether::Graphics::UploadRingBuffer::Grow(
+    UploadBlock* exhaustedRing,
+    SizeAlign sizeAlign)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // Another thread already replaced the ring
+    if (m_CurrentRing.load(std::memory_order_acquire) != exhaustedRing)
+        return m_CurrentRing.load(std::memory_order_acquire);
+
+    ETH_MARKER_EVENT("Upload Ring Buffer - Grow");
+    const size_t oldCapacity = m_Ring->m_Allocator->GetCapacity();
+    size_t newCapacity = oldCapacity * 2;
+    while (newCapacity < AlignUp(sizeAlign.m_Size, sizeAlign.m_Alignment) + sizeAlign.m_Alignment)
+        newCapacity *= 2;
+
+    LogGraphicsWarning(
+        "Upload ring buffer ran out of space, growing from %zu to %zu bytes",
+        oldCapacity,
+        newCapacity);
+
+    // The old ring is still referenced by the frames in flight, and by this one
+    m_FrameRetiredRingBytes += m_Ring->m_Allocator->GetFrameCapacity();
+    m_RetiredThisFrame.push_back(std::move(m_Ring));
+
+    m_Ring = std::make_unique<UploadBlock>(newCapacity, "UploadRingBuffer::Ring", true);
+    m_Ring->m_Allocator->BeginFrame(0);
+    m_CurrentRing.store(m_Ring.get(), std::memory_order_release);
+
+    m_Stats.m_Capacity = newCapacity;
+    m_Stats.m_NumGrowths++;
+    return m_Ring.get();
+}
@@ -0,0 +1,107 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "common/memory/frameringallocator.h"
+#include "common/memory/memorytracker.h"
+#include "graphics/memory/uploadbufferallocation.h"
+#include <mutex>
+#include <queue>
+
+namespace Ether::Graphics
+{
+struct UploadRingBufferStats
+{
+    size_t m_Capacity;
+    uint32_t m_NumGrowths;
+    uint64_t m_NumFrames;
+
+    // Bytes consumed per frame, including alignment padding and dedicated buffers
+    size_t m_LastFrameBytes;
+    size_t m_PeakFrameBytes;
+    double m_AverageFrameBytes;
+
+    // Ring space that was consumed without being requested (alignment padding, and the unused tail of a
+    // ring that had to grow mid frame)
+    size_t m_LastFrameWastedBytes;
+    size_t m_PeakFrameWastedBytes;
+    double m_AverageFrameWastedBytes;
+
+    size_t m_LastFrameDedicatedBytes;
+};
+
+/*
+    Upload memory shared by everything that records in a frame. Small requests are bump allocated from a
+    persistently mapped ring without taking a lock, and the ring doubles in size whenever a frame runs out
+    of it. Requests above the dedicated threshold get a buffer of their own. Retired rings, dedicated
+    buffers and each frame's range of the ring are reclaimed once the graphic queue is past the frame.
+*/
+class UploadRingBuffer : public NonCopyable, public NonMovable
+{
+public:
+    UploadRingBuffer(size_t initialCapacity = _8MiB, size_t dedicatedThreshold = _2MiB);
+    ~UploadRingBuffer() = default;
+
+public:
+    // Thread safe
+    UploadBufferAllocation Allocate(SizeAlign sizeAlign);
+
+    void BeginFrame();
+    void EndFrame();
+
+public:
+    inline const UploadRingBufferStats& GetStats() const { return m_Stats; }
+    void ResetStats();
+
+private:
+    struct UploadBlock
+    {
+        UploadBlock(size_t size, const char* name, bool isRing);
+        ~UploadBlock();
+
+        std::unique_ptr<RhiResource> m_Resource;
+        std::unique_ptr<FrameRingAllocator> m_Allocator;
+        void* m_MappedAddress;
+
+        // Upload heaps live in system memory
+        TrackedMemory m_TrackedMemory;
+    };
+
+    UploadBufferAllocation AllocateDedicated(SizeAlign sizeAlign);
+    UploadBlock* Grow(UploadBlock* exhaustedRing, SizeAlign sizeAlign);
+
+private:
+    const size_t m_DedicatedThreshold;
+
+    std::unique_ptr<UploadBlock> m_Ring;
+    std::atomic<UploadBlock*> m_CurrentRing;
+
+    // Guards growing and dedicated allocations
+    std::mutex m_Mutex;
+    std::vector<std::unique_ptr<UploadBlock>> m_RetiredThisFrame;
+    std::queue<std::pair<std::unique_ptr<UploadBlock>, RhiFenceValue>> m_PendingRelease;
+
+    std::atomic<size_t> m_FrameRequestedRingBytes;
+    size_t m_FrameRetiredRingBytes;
+    size_t m_FrameDedicatedBytes;
+    UploadRingBufferStats m_Stats;
+};
+} // namespace Ether::Graphics
@@ -26,6 +26,7 @@ Ether::Graphics::Mesh::Mesh()
     : Serializable(MeshVersion, ETH_CLASS_ID_MESH)
     , m_NumVertices(0)
     , m_NumIndices(0)
+    , m_CpuMemory(MemoryTag::Resources)
     , m_IndexBufferView({})
     , m_VertexBufferView({})
 {
@@ -69,6 +70,8 @@ void Ether::Graphics::Mesh::Deserialize(IStream& istream)
     istream >> m_DefaultMaterialGuid;
     istream >> (ethVector3&)m_BoundingBox.m_Min;
     istream >> (ethVector3&)m_BoundingBox.m_Max;
+
+    UpdateTrackedMemory();
 }
 
 void Ether::Graphics::Mesh::SetPackedVertices(
@@ -90,28 +93,47 @@ void Ether::Graphics::Mesh::SetPackedVertices(
         m_BoundingBox.m_Max.y = std::max(m_BoundingBox.m_Max.y, vertex.m_Position.y);
         m_BoundingBox.m_Max.z = std::max(m_BoundingBox.m_Max.z, vertex.m_Position.z);
     }
+
+    UpdateTrackedMemory();
 }
 
 void Ether::Graphics::Mesh::SetIndices(std::vector<uint32_t>&& indices)
 {
-    m_Indices = indices;
+    m_Indices = std::move(indices);
     m_NumIndices = m_Indices.size();
+    UpdateTrackedMemory();
 }
 
-void Ether::Graphics::Mesh::CreateGpuResources(CommandContext& ctx)
+void Ether::Graphics::Mesh::CreateGpuResources(UploadQueue& uploadQueue)
 {
-    CreateVertexBuffer(ctx);
-    CreateIndexBuffer(ctx);
-    CreateAccelerationStructure(ctx);
+    const size_t uploadSize = m_PackedVertices.size() * sizeof(m_PackedVertices[0]) + m_Indices.size() * sizeof(m_Indices[0]);
+    CommandContext& copyCtx = uploadQueue.GetCopyContext(uploadSize);
+
+    CreateVertexBuffer(copyCtx);
+    CreateIndexBuffer(copyCtx);
+
+    // Acceleration structures cannot be built on the copy queue
+    CreateAccelerationStructure(uploadQueue.GetGraphicContext());
 
 #ifdef ETH_ENGINE
     // Mesh data can be deallocated on the CPU. It's all in VRAM now.
     // This might cause problems down the line, but if it is not deallocated the CPU memory usage is going to be crazy
-    m_PackedVertices.clear();
-    m_Indices.clear();
+    // Swapping with empty vectors, since clear() alone keeps the capacity around
+    std::vector<VertexFormats::PositionNormalTangentTexcoord>().swap(m_PackedVertices);
+    std::vector<uint32_t>().swap(m_Indices);
+    UpdateTrackedMemory();
 #endif
 }
 
+void Ether::Graphics::Mesh::UnregisterShaderResourceViews()
+{
+    if (m_VertexBufferResource != nullptr)
+        GraphicCore::GetBindlessDescriptorManager().Unregister(m_VbName + " SRV");
+
+    if (m_IndexBufferResource != nullptr)
+        GraphicCore::GetBindlessDescriptorManager().Unregister(m_IbName + " SRV");
+}
+
 void Ether::Graphics::Mesh::CreateVertexBuffer(CommandContext& ctx)
 {
     m_VbName = "Mesh::VertexBuffer (" + GetGuid() + ")";
@@ -190,3 +212,10 @@ void Ether::Graphics::Mesh::InitializeIndexBufferViews()
         *m_IndexBufferResource,
         m_IndexBufferView);
 }
+
+void Ether::Graphics::Mesh::UpdateTrackedMemory()
+{
+    m_CpuMemory.Set(
+        m_PackedVertices.capacity() * sizeof(VertexFormats::PositionNormalTangentTexcoord) +
+        m_Indices.capacity() * sizeof(uint32_t));
+}
@@ -20,8 +20,10 @@
 #pragma once
 
 #include "graphics/pch.h"
+#include "common/memory/memorytracker.h"
 #include "graphics/common/vertexformats.h"
 #include "graphics/context/commandcontext.h"
+#include "graphics/context/uploadqueue.h"
 #include "graphics/rhi/rhiaccelerationstructure.h"
 
 #define ETH_CLASS_ID_MESH "Graphics::Mesh"
@@ -56,7 +58,9 @@ public:
     void SetDefaultMaterialGuid(StringID guid) { m_DefaultMaterialGuid = guid; }
     void SetPackedVertices(std::vector<VertexFormats::PositionNormalTangentTexcoord>&& vertices);
     void SetIndices(std::vector<uint32_t>&& indices);
-    void CreateGpuResources(CommandContext& ctx);
+    void CreateGpuResources(UploadQueue& uploadQueue);
+    // Has to happen before the resources are released, while the GPU may still be using them
+    void UnregisterShaderResourceViews();
 
 public:
     static constexpr RhiFormat s_VertexBufferPositionFormat = RhiFormat::R32G32B32Float;
@@ -69,6 +73,7 @@ private:
 
     void InitializeVertexBufferViews();
     void InitializeIndexBufferViews();
+    void UpdateTrackedMemory();
 
 private:
     std::vector<VertexFormats::PositionNormalTangentTexcoord> m_PackedVertices;
@@ -78,6 +83,9 @@ private:
     StringID m_DefaultMaterialGuid;
     Aabb m_BoundingBox;
 
+    // Vertex and index data held on the CPU until it is uploaded
+    TrackedMemory m_CpuMemory;
+
     // Transient Data
     std::unique_ptr<RhiResource> m_VertexBufferResource;
     std::unique_ptr<RhiResource> m_IndexBufferResource;
@@ -19,13 +19,24 @@
 
 #include "graphics/resources/texture.h"
 #include "graphics/graphiccore.h"
+#include "common/memory/memorytracker.h"
+#include <format>
 
 #define IS_POWER_OF_2(num) (num > 0 && (num & (num - 1)) == 0)
 
-constexpr uint32_t TextureVersion = 1;
+// 1: Mips stored from the most detailed one down
+// 2: Mip offset table, mips stored from the smallest one up so that the tail can be read on its own
+constexpr uint32_t TextureVersion = 2;
 
 Ether::Graphics::Texture::Texture()
     : Serializable(TextureVersion, ETH_CLASS_ID_TEXTURE)
+    , m_Width(0)
+    , m_Height(0)
+    , m_NumMips(0)
+    , m_Format(RhiFormat::R8G8B8A8Unorm)
+    , m_Data()
+    , m_MipFileOffsets()
+    , m_ResidentMip(0)
 {
 }
 
@@ -33,9 +44,7 @@ Ether::Graphics::Texture::~Texture()
 {
     for (uint32_t i = 0; i < m_NumMips; ++i)
     {
-        if (m_Data[i] != nullptr)
-            free(m_Data[i]);
-
+        MemoryTracker::Free(m_Data[i]);
         m_Data[i] = nullptr;
     }
 }
@@ -49,13 +58,25 @@ void Ether::Graphics::Texture::Serialize(OStream& ostream) const
     ostream << m_NumMips;
     ostream << static_cast<uint32_t>(m_Format);
 
+    // Relative to the start of the mip data
+    uint32_t mipOffsets[MaxNumMips] = {};
+    uint32_t offset = 0;
+    for (uint32_t i = m_NumMips; i-- > 0;)
+    {
+        mipOffsets[i] = offset;
+        offset += static_cast<uint32_t>(GetSizeInBytes(i));
+    }
+
     for (uint32_t i = 0; i < m_NumMips; ++i)
+        ostream << mipOffsets[i];
+
+    for (uint32_t i = m_NumMips; i-- > 0;)
         ostream.WriteBytes(m_Data[i], GetSizeInBytes(i));
 }
 
 void Ether::Graphics::Texture::Deserialize(IStream& istream)
 {
-    Serializable::Deserialize(istream);
+    const uint32_t version = DeserializeVersioned(istream, 1);
 
     uint32_t format;
 
@@ -66,26 +87,93 @@ void Ether::Graphics::Texture::Deserialize(IStream& istream)
     istream >> format;
     m_Format = static_cast<RhiFormat>(format);
 
+    if (m_NumMips > MaxNumMips || m_Width > MaxTextureSize || m_Height > MaxTextureSize)
+    {
+        m_NumMips = 0;
+        throw std::runtime_error(std::format("Texture {} has an invalid size", m_Name));
+    }
+
+    if (version < 2)
+    {
+        for (uint32_t i = 0; i < m_NumMips; ++i)
+        {
+            m_Data[i] = MemoryTracker::Allocate(GetSizeInBytes(i), MemoryTag::Resources);
+            istream.ReadBytes(m_Data[i], GetSizeInBytes(i));
+        }
+        return;
+    }
+
+    uint32_t mipOffsets[MaxNumMips];
     for (uint32_t i = 0; i < m_NumMips; ++i)
+        istream >> mipOffsets[i];
+
+    // The detailed mips of a texture that was read from a file are left on disk, until the streamer asks for them
+    const uint32_t firstTailMip = GetFirstTailMip();
+    std::string filePath;
+    size_t dataOffset = 0;
+    const bool isStreamed = firstTailMip > 0 && IsMipStreamingEnabled() && istream.GetFileLocation(filePath, dataOffset);
+    const uint32_t firstLoadedMip = isStreamed ? firstTailMip : 0;
+
+    uint32_t offset = 0;
+    for (uint32_t i = m_NumMips; i-- > 0;)
     {
-        m_Data[i] = malloc(GetSizeInBytes(i));
-        istream.ReadBytes(m_Data[i], GetSizeInBytes(i));
+        if (mipOffsets[i] != offset)
+        {
+            for (uint32_t j = i + 1; j < m_NumMips; ++j)
+            {
+                MemoryTracker::Free(m_Data[j]);
+                m_Data[j] = nullptr;
+            }
+
+            m_NumMips = 0;
+            throw std::runtime_error(std::format("Texture {} has an invalid mip table", m_Name));
+        }
+
+        if (i >= firstLoadedMip)
+        {
+            m_Data[i] = MemoryTracker::Allocate(GetSizeInBytes(i), MemoryTag::Resources);
+            istream.ReadBytes(m_Data[i], GetSizeInBytes(i));
+        }
+        else
+        {
+            istream.Skip(GetSizeInBytes(i));
+        }
+
+        offset += static_cast<uint32_t>(GetSizeInBytes(i));
     }
+
+    m_ResidentMip = firstLoadedMip;
+    if (!isStreamed)
+        return;
+
+    m_FilePath = filePath;
+    for (uint32_t i = 0; i < m_NumMips; ++i)
+        m_MipFileOffsets[i] = dataOffset + mipOffsets[i];
 }
 
-void Ether::Graphics::Texture::CreateGpuResource(CommandContext& ctx)
+bool Ether::Graphics::Texture::IsMipStreamingEnabled()
 {
-    RhiCommitedResourceDesc desc = {};
-    desc.m_Name = m_Name.c_str();
-    desc.m_HeapType = RhiHeapType::Default;
-    desc.m_State = RhiResourceState::Common;
-    desc.m_ClearValue = { m_Format, { 0, 0, 0, 0 } };
-    desc.m_ResourceDesc = RhiCreateTexture2DResourceDesc(m_Format, { m_Width, m_Height });
-    desc.m_ResourceDesc.m_Flag = RhiResourceFlag::None;
-    desc.m_ResourceDesc.m_MipLevels = m_NumMips;
+#ifdef ETH_ENGINE
+    // Headless runs never create GPU resources, so they keep the data around like tools do
+    return GraphicCore::IsInitialized() && !GraphicCore::IsHeadless() &&
+           GraphicCore::GetGraphicConfig().GetTextureStreamingBudget() > 0;
+#else
+    // Tools keep every mip, worlds are saved from there
+    return false;
+#endif
+}
 
-    m_Resource = GraphicCore::GetDevice().CreateCommittedResource(desc);
-    ctx.InitializeTexture(*m_Resource, (void**)m_Data, m_NumMips, m_Width, m_Height, GetBytesPerPixel());
+void Ether::Graphics::Texture::CreateGpuResource(UploadQueue& uploadQueue)
+{
+    // Streamed textures start out with their tail
+    const uint32_t numMips = m_NumMips - m_ResidentMip;
+
+    // Matches the (generous) estimate made by CommandContext::InitializeTexture, plus room for its alignment
+    const size_t uploadSize = static_cast<size_t>(GetSizeInBytes(m_ResidentMip) * (numMips > 1 ? 1.5 : 1.0)) + 512;
+    CommandContext& ctx = uploadQueue.GetCopyContext(uploadSize);
+
+    m_Resource = CreateResource(m_ResidentMip);
+    ctx.InitializeTexture(*m_Resource, (void**)m_Data + m_ResidentMip, numMips, m_Width >> m_ResidentMip, m_Height >> m_ResidentMip, GetBytesPerPixel());
     GraphicCore::GetBindlessDescriptorManager().RegisterAsShaderResourceView(m_Guid, *m_Resource.get(), m_Format);
 
 #ifdef ETH_ENGINE
@@ -93,18 +181,67 @@ void Ether::Graphics::Texture::CreateGpuResource(CommandContext& ctx)
     // This might cause problems down the line, but if it is not deallocated the CPU memory usage is going to be crazy
     for (uint32_t i = 0; i < m_NumMips; ++i)
     {
-        if (m_Data[i] != nullptr)
-            free(m_Data[i]);
-
+        MemoryTracker::Free(m_Data[i]);
         m_Data[i] = nullptr;
     }
 #endif
 }
 
+void Ether::Graphics::Texture::UnregisterShaderResourceView()
+{
+    if (m_Resource != nullptr)
+        GraphicCore::GetBindlessDescriptorManager().Unregister(m_Guid);
+}
+
+std::unique_ptr<Ether::Graphics::RhiResource> Ether::Graphics::Texture::SetResidentMip(
+    uint32_t residentMip,
+    void** mipData,
+    UploadQueue& uploadQueue)
+{
+    AssertGraphics(m_Resource != nullptr, "Texture %s has no GPU resource to change the residency of", m_Name.c_str());
+    AssertGraphics(residentMip < m_NumMips, "Texture %s does not have mip %u", m_Name.c_str(), residentMip);
+
+    const uint32_t oldResidentMip = m_ResidentMip;
+    std::unique_ptr<RhiResource> oldResource = std::move(m_Resource);
+    m_Resource = CreateResource(residentMip);
+    m_ResidentMip = residentMip;
+
+    if (residentMip < oldResidentMip)
+    {
+        const uint32_t numNewMips = oldResidentMip - residentMip;
+        const size_t uploadSize = static_cast<size_t>(GetSizeInBytes(residentMip) * (numNewMips > 1 ? 1.5 : 1.0)) + 512;
+        CommandContext& copyCtx = uploadQueue.GetCopyContext(uploadSize);
+        copyCtx.InitializeTexture(*m_Resource, mipData, numNewMips, m_Width >> residentMip, m_Height >> residentMip, GetBytesPerPixel());
+    }
+
+    // The old resource is copied from on the graphic queue, since the frames in flight may still be sampling it.
+    // This runs after the upload above.
+    CommandContext& graphicCtx = uploadQueue.GetGraphicContext();
+    for (uint32_t i = (std::max)(residentMip, oldResidentMip); i < m_NumMips; ++i)
+        graphicCtx.CopyTextureRegion(*oldResource, i - oldResidentMip, *m_Resource, i - residentMip);
+    graphicCtx.TransitionResource(*m_Resource, RhiResourceState::GenericRead);
+
+    // A new descriptor rather than an update of the old one, which the frames in flight still use
+    BindlessDescriptorManager& descriptorManager = GraphicCore::GetBindlessDescriptorManager();
+    descriptorManager.Unregister(m_Guid);
+    descriptorManager.RegisterAsShaderResourceView(m_Guid, *m_Resource, m_Format);
+
+    return oldResource;
+}
+
 void Ether::Graphics::Texture::SetData(const unsigned char* data, bool genMips)
 {
-    m_Data[0] = (void*)data;
+    for (uint32_t i = 0; i < m_NumMips; ++i)
+    {
+        MemoryTracker::Free(m_Data[i]);
+        m_Data[i] = nullptr;
+    }
+
+    m_Data[0] = MemoryTracker::Allocate(GetSizeInBytes(0), MemoryTag::Resources);
+    memcpy(m_Data[0], data, GetSizeInBytes(0));
     m_NumMips = 1;
+    m_ResidentMip = 0;
+    m_FilePath.clear();
 
     if (genMips && IS_POWER_OF_2(m_Width) && IS_POWER_OF_2(m_Height))
         GenerateMips();
@@ -116,6 +253,15 @@ size_t Ether::Graphics::Texture::GetSizeInBytes(uint32_t mipLevel) const
     return m_Width * mipFactor * m_Height * mipFactor * GetBytesPerPixel();
 }
 
+uint32_t Ether::Graphics::Texture::GetFirstTailMip() const
+{
+    uint32_t mipLevel = 0;
+    while (mipLevel + 1 < m_NumMips && ((std::max)(m_Width, m_Height) >> mipLevel) > MaxTailMipSize)
+        ++mipLevel;
+
+    return mipLevel;
+}
+
 size_t Ether::Graphics::Texture::GetBytesPerPixel() const
 {
     AssertGraphics(
@@ -124,6 +270,20 @@ size_t Ether::Graphics::Texture::GetBytesPerPixel() const
     return 4;
 }
 
+std::unique_ptr<Ether::Graphics::RhiResource> Ether::Graphics::Texture::CreateResource(uint32_t mostDetailedMip) const
+{
+    RhiCommitedResourceDesc desc = {};
+    desc.m_Name = m_Name.c_str();
+    desc.m_HeapType = RhiHeapType::Default;
+    desc.m_State = RhiResourceState::Common;
+    desc.m_ClearValue = { m_Format, { 0, 0, 0, 0 } };
+    desc.m_ResourceDesc = RhiCreateTexture2DResourceDesc(m_Format, { m_Width >> mostDetailedMip, m_Height >> mostDetailedMip });
+    desc.m_ResourceDesc.m_Flag = RhiResourceFlag::None;
+    desc.m_ResourceDesc.m_MipLevels = m_NumMips - mostDetailedMip;
+
+    return GraphicCore::GetDevice().CreateCommittedResource(desc);
+}
+
 Ether::ethColor4 Ether::Graphics::Texture::GetColor(const void* src, uint32_t x, uint32_t y, uint32_t pitch) const
 {
     const uint32_t bpp = GetBytesPerPixel();
@@ -182,7 +342,7 @@ void Ether::Graphics::Texture::GenerateMips()
 
     for (uint32_t i = 0; i < m_NumMips - 1; ++i)
     {
-        m_Data[i + 1] = malloc(GetSizeInBytes(i + 1));
+        m_Data[i + 1] = MemoryTracker::Allocate(GetSizeInBytes(i + 1), MemoryTag::Resources);
         DownsizeData(m_Data[i], m_Data[i + 1], width, height);
         width /= 2;
         height /= 2;
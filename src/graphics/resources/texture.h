@@ -21,6 +21,7 @@
 
 #include "graphics/pch.h"
 #include "graphics/context/commandcontext.h"
+#include "graphics/context/uploadqueue.h"
 
 #define ETH_CLASS_ID_TEXTURE "Graphics::Texture"
 
@@ -29,6 +30,8 @@ namespace Ether::Graphics
 
 static constexpr uint32_t MaxNumMips = 11;
 static constexpr uint32_t MaxTextureSize = 1 << MaxNumMips;
+// Mips up to this size (along the larger side) are always resident, see Texture::IsStreamable()
+static constexpr uint32_t MaxTailMipSize = 64;
 
 class ETH_GRAPHIC_DLL Texture : public Serializable
 {
@@ -41,7 +44,19 @@ public:
     void Deserialize(IStream& istream) override;
 
 public:
-    void CreateGpuResource(CommandContext& ctx);
+    // Only the tail mips of textures that are read from a file are loaded when this is enabled (engine
+    // builds with a texture streaming budget), the more detailed ones are read on demand
+    static bool IsMipStreamingEnabled();
+
+public:
+    void CreateGpuResource(UploadQueue& uploadQueue);
+    // Has to happen before the resource is released, while the GPU may still be using it
+    void UnregisterShaderResourceView();
+
+    // Recreates the GPU resource so that it holds the mips from residentMip down, and registers its shader
+    // resource view anew. Mips that are new to the resource are uploaded from mipData (which starts at residentMip),
+    // the others are copied over on the GPU. Returns the old resource, the frames in flight may still be using it.
+    std::unique_ptr<RhiResource> SetResidentMip(uint32_t residentMip, void** mipData, UploadQueue& uploadQueue);
 
 public:
     inline const char* GetName() const { return m_Name.c_str(); }
@@ -50,15 +65,26 @@ public:
     inline uint32_t GetNumMips() const { return m_NumMips; }
     inline RhiFormat GetFormat() const { return m_Format; }
 
+    // Streamable textures only load their tail when deserialized, the file offsets of the other mips are kept
+    inline bool IsStreamable() const { return !m_FilePath.empty(); }
+    inline const std::string& GetFilePath() const { return m_FilePath; }
+    inline uint64_t GetMipFileOffset(uint32_t mipLevel) const { return m_MipFileOffsets[mipLevel]; }
+    // The most detailed mip that the GPU resource holds. Rendering thread only.
+    inline uint32_t GetResidentMip() const { return m_ResidentMip; }
+    // The first mip that is no larger than MaxTailMipSize (or the last one)
+    uint32_t GetFirstTailMip() const;
+    size_t GetSizeInBytes(uint32_t mipLevel = 0) const;
+
     inline void SetName(const char* name) { m_Name = name; }
     inline void SetWidth(uint32_t width) { m_Width = width; }
     inline void SetHeight(uint32_t height) { m_Height = height; }
     inline void SetFormat(RhiFormat format) { m_Format = format; }
-    inline void SetData(const unsigned char* data, bool genMips);
+    // Copies the data, so the size and format have to be set first
+    void SetData(const unsigned char* data, bool genMips);
 
 private:
-    size_t GetSizeInBytes(uint32_t mipLevel = 0) const;
     size_t GetBytesPerPixel() const;
+    std::unique_ptr<RhiResource> CreateResource(uint32_t mostDetailedMip) const;
 
     ethColor4 GetColor(const void* src, uint32_t x, uint32_t y, uint32_t pitch) const;
     void SetColor(void* dest, const ethColor4& color, uint32_t x, uint32_t y, uint32_t pitch) const;
@@ -74,6 +100,10 @@ private:
     RhiFormat m_Format;
     void* m_Data[MaxNumMips];
 
+    std::string m_FilePath;
+    uint64_t m_MipFileOffsets[MaxNumMips];
+    uint32_t m_ResidentMip;
+
     std::unique_ptr<RhiResource> m_Resource;
 };
 } // namespace Ether::Graphics
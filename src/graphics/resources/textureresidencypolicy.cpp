@@ -0,0 +1,307 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/resources/textureresidencypolicy.h"
+#include <algorithm>
+#include <format>
+
+Ether::Graphics::TextureResidencyPolicy::TextureResidencyPolicy(size_t budget, uint32_t maxPendingLoads)
+    : m_Budget(budget)
+    , m_MaxPendingLoads(maxPendingLoads)
+    , m_UpdateIndex(0)
+    , m_CommittedMemory(0)
+    , m_NumPendingLoads(0)
+{
+}
+
+uint32_t Ether::Graphics::TextureResidencyPolicy::AddTexture(const size_t* mipSizes, uint32_t numMips, uint32_t firstTailMip)
+{
+    AssertGraphics(numMips > 0 && numMips <= MaxNumMips && firstTailMip < numMips, "Invalid mip chain for a streamed texture");
+
+    TextureState texture = {};
+    std::copy(mipSizes, mipSizes + numMips, texture.m_MipSizes);
+    texture.m_NumMips = numMips;
+    texture.m_FirstTailMip = firstTailMip;
+    texture.m_ResidentMip = firstTailMip;
+    texture.m_RequestedMip = NoRequest;
+    texture.m_WantedMip = firstTailMip;
+    texture.m_LastUsed = m_UpdateIndex;
+    texture.m_IsValid = true;
+
+    uint32_t handle;
+    if (m_FreeHandles.empty())
+    {
+        handle = static_cast<uint32_t>(m_Textures.size());
+        m_Textures.push_back(texture);
+    }
+    else
+    {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+        m_Textures[handle] = texture;
+    }
+
+    return handle;
+}
+
+void Ether::Graphics::TextureResidencyPolicy::RemoveTexture(uint32_t handle)
+{
+    TextureState& texture = m_Textures[handle];
+    m_CommittedMemory -= GetStreamedSize(texture);
+
+    if (texture.m_IsLoading)
+    {
+        m_CommittedMemory -= texture.m_MipSizes[texture.m_ResidentMip - 1];
+        m_NumPendingLoads--;
+    }
+
+    texture.m_IsValid = false;
+    m_FreeHandles.push_back(handle);
+}
+
+void Ether::Graphics::TextureResidencyPolicy::RequestMip(uint32_t handle, uint32_t mipLevel)
+{
+    TextureState& texture = m_Textures[handle];
+    texture.m_RequestedMip = (std::min)({ texture.m_RequestedMip, mipLevel, texture.m_FirstTailMip });
+}
+
+void Ether::Graphics::TextureResidencyPolicy::Update(
+    size_t releasingMemory,
+    std::vector<TextureMipLoad>& loads,
+    std::vector<TextureMipEviction>& evictions)
+{
+    ++m_UpdateIndex;
+    m_LoadCandidates.clear();
+    m_EvictionCandidates.clear();
+
+    for (uint32_t handle = 0; handle < m_Textures.size(); ++handle)
+    {
+        TextureState& texture = m_Textures[handle];
+        if (!texture.m_IsValid)
+            continue;
+
+        if (texture.m_RequestedMip != NoRequest)
+        {
+            texture.m_WantedMip = texture.m_RequestedMip;
+            texture.m_RequestedMip = NoRequest;
+            texture.m_LastUsed = m_UpdateIndex;
+        }
+
+        // Textures that are out of view keep what they have, but do not get any more
+        const bool isUsed = texture.m_LastUsed == m_UpdateIndex;
+        if (isUsed && texture.m_WantedMip < texture.m_ResidentMip && !texture.m_IsLoading && !texture.m_HasFailed)
+            m_LoadCandidates.push_back(handle);
+
+        if (GetEvictionLimit(texture) > texture.m_ResidentMip)
+            m_EvictionCandidates.push_back(handle);
+    }
+
+    std::sort(
+        m_LoadCandidates.begin(),
+        m_LoadCandidates.end(),
+        [this](uint32_t a, uint32_t b)
+        {
+            const TextureState& textureA = m_Textures[a];
+            const TextureState& textureB = m_Textures[b];
+            const size_t sizeA = textureA.m_MipSizes[textureA.m_ResidentMip - 1];
+            const size_t sizeB = textureB.m_MipSizes[textureB.m_ResidentMip - 1];
+            if (sizeA != sizeB)
+                return sizeA < sizeB;
+
+            const uint32_t numMissingA = textureA.m_ResidentMip - textureA.m_WantedMip;
+            const uint32_t numMissingB = textureB.m_ResidentMip - textureB.m_WantedMip;
+            if (numMissingA != numMissingB)
+                return numMissingA > numMissingB;
+
+            return a < b;
+        });
+
+    // Textures in view were used last, so they only give up their surplus once everything else is gone
+    std::sort(
+        m_EvictionCandidates.begin(),
+        m_EvictionCandidates.end(),
+        [this](uint32_t a, uint32_t b)
+        {
+            if (m_Textures[a].m_LastUsed != m_Textures[b].m_LastUsed)
+                return m_Textures[a].m_LastUsed < m_Textures[b].m_LastUsed;
+
+            return a < b;
+        });
+
+    size_t evictedMemory = 0;
+    size_t nextEviction = 0;
+
+    for (uint32_t handle : m_LoadCandidates)
+    {
+        if (m_NumPendingLoads >= m_MaxPendingLoads)
+            break;
+
+        TextureState& texture = m_Textures[handle];
+        const uint32_t mipLevel = texture.m_ResidentMip - 1;
+        const size_t size = texture.m_MipSizes[mipLevel];
+
+        while (m_CommittedMemory + size > m_Budget && nextEviction < m_EvictionCandidates.size())
+        {
+            const uint32_t victim = m_EvictionCandidates[nextEviction];
+            if (GetEvictionLimit(m_Textures[victim]) <= m_Textures[victim].m_ResidentMip)
+            {
+                ++nextEviction;
+                continue;
+            }
+
+            evictedMemory += m_Textures[victim].m_MipSizes[m_Textures[victim].m_ResidentMip];
+            EvictMip(victim, evictions);
+        }
+
+        // Evicted memory is only available once it has been released, the load is issued during a later update then.
+        // Loads are sorted by size, so none of the ones that follow would fit either.
+        if (m_CommittedMemory + releasingMemory + evictedMemory + size > m_Budget)
+            break;
+
+        texture.m_IsLoading = true;
+        m_CommittedMemory += size;
+        m_NumPendingLoads++;
+        loads.push_back({ handle, mipLevel });
+    }
+}
+
+void Ether::Graphics::TextureResidencyPolicy::OnMipLoaded(uint32_t handle, uint32_t mipLevel)
+{
+    TextureState& texture = m_Textures[handle];
+    AssertGraphics(texture.m_IsValid && texture.m_IsLoading && mipLevel + 1 == texture.m_ResidentMip, "Unexpected texture mip load");
+
+    texture.m_ResidentMip = mipLevel;
+    texture.m_IsLoading = false;
+    m_NumPendingLoads--;
+}
+
+void Ether::Graphics::TextureResidencyPolicy::OnMipLoadFailed(uint32_t handle, uint32_t mipLevel)
+{
+    TextureState& texture = m_Textures[handle];
+    AssertGraphics(texture.m_IsValid && texture.m_IsLoading && mipLevel + 1 == texture.m_ResidentMip, "Unexpected texture mip load");
+
+    texture.m_IsLoading = false;
+    texture.m_HasFailed = true;
+    m_CommittedMemory -= texture.m_MipSizes[mipLevel];
+    m_NumPendingLoads--;
+}
+
+std::string Ether::Graphics::TextureResidencyPolicy::Validate() const
+{
+    size_t committedMemory = 0;
+    uint32_t numPendingLoads = 0;
+    uint32_t numTextures = 0;
+
+    for (uint32_t handle = 0; handle < m_Textures.size(); ++handle)
+    {
+        const TextureState& texture = m_Textures[handle];
+        if (!texture.m_IsValid)
+            continue;
+
+        if (texture.m_ResidentMip > texture.m_FirstTailMip || texture.m_WantedMip > texture.m_FirstTailMip)
+            return std::format("Texture {} has dropped (or wants to drop) part of its tail", handle);
+
+        if (texture.m_IsLoading && texture.m_ResidentMip == 0)
+            return std::format("Texture {} is loading past its most detailed mip", handle);
+
+        committedMemory += GetStreamedSize(texture);
+        if (texture.m_IsLoading)
+        {
+            committedMemory += texture.m_MipSizes[texture.m_ResidentMip - 1];
+            numPendingLoads++;
+        }
+
+        numTextures++;
+    }
+
+    if (numTextures + m_FreeHandles.size() != m_Textures.size())
+        return "Free handles do not match the removed textures";
+
+    if (committedMemory != m_CommittedMemory)
+        return std::format("Committed memory is {} bytes, but the textures add up to {}", m_CommittedMemory, committedMemory);
+
+    if (numPendingLoads != m_NumPendingLoads)
+        return std::format("{} pending loads are counted, but {} textures are loading", m_NumPendingLoads, numPendingLoads);
+
+    if (m_NumPendingLoads > m_MaxPendingLoads)
+        return std::format("{} loads are pending, more than the {} allowed", m_NumPendingLoads, m_MaxPendingLoads);
+
+    return "";
+}
+
+uint32_t Ether::Graphics::TextureResidencyPolicy::GetResidentMip(uint32_t handle) const
+{
+    return m_Textures[handle].m_ResidentMip;
+}
+
+size_t Ether::Graphics::TextureResidencyPolicy::GetResidentSize(uint32_t handle) const
+{
+    const TextureState& texture = m_Textures[handle];
+
+    size_t size = 0;
+    for (uint32_t i = texture.m_ResidentMip; i < texture.m_NumMips; ++i)
+        size += texture.m_MipSizes[i];
+
+    return size;
+}
+
+bool Ether::Graphics::TextureResidencyPolicy::IsLoading(uint32_t handle) const
+{
+    return m_Textures[handle].m_IsLoading;
+}
+
+size_t Ether::Graphics::TextureResidencyPolicy::GetStreamedSize(const TextureState& texture) const
+{
+    size_t size = 0;
+    for (uint32_t i = texture.m_ResidentMip; i < texture.m_FirstTailMip; ++i)
+        size += texture.m_MipSizes[i];
+
+    return size;
+}
+
+uint32_t Ether::Graphics::TextureResidencyPolicy::GetEvictionLimit(const TextureState& texture) const
+{
+    if (texture.m_IsLoading)
+        return texture.m_ResidentMip;
+
+    // Textures in view keep the mips that they need
+    if (texture.m_LastUsed == m_UpdateIndex)
+        return texture.m_WantedMip;
+
+    return texture.m_FirstTailMip;
+}
+
+void Ether::Graphics::TextureResidencyPolicy::EvictMip(uint32_t handle, std::vector<TextureMipEviction>& evictions)
+{
+    TextureState& texture = m_Textures[handle];
+    const size_t size = texture.m_MipSizes[texture.m_ResidentMip];
+
+    texture.m_ResidentMip++;
+    m_CommittedMemory -= size;
+
+    // A texture that loses several mips in one go only has to change its residency once
+    if (!evictions.empty() && evictions.back().m_Handle == handle)
+    {
+        evictions.back().m_ResidentMip = texture.m_ResidentMip;
+        evictions.back().m_Size += size;
+        return;
+    }
+
+    evictions.push_back({ handle, texture.m_ResidentMip, size });
+}
@@ -0,0 +1,138 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graphics/pch.h"
+#include "graphics/resources/texture.h"
+
+namespace Ether::Graphics
+{
+struct TextureMipLoad
+{
+    uint32_t m_Handle;
+    uint32_t m_MipLevel;
+};
+
+struct TextureMipEviction
+{
+    uint32_t m_Handle;
+    // The most detailed mip that is left resident
+    uint32_t m_ResidentMip;
+    // Of the mips that were dropped
+    size_t m_Size;
+};
+
+/*
+    Decides which mips of the streamed textures are resident, without touching any GPU or file
+    resources itself (see TextureStreamer for that).
+
+    Textures start out with their tail resident. Every frame, the renderer requests the mip that each
+    texture in view is sampled at, and Update() turns the requests into loads and evictions. Textures
+    go up one mip at a time, and the smallest loads are issued first across all textures, so that
+    everything in view sharpens evenly instead of one texture after another.
+
+    Memory is only taken back when a load would not fit into the budget otherwise. The mips of the
+    textures that were used least recently go first, then the mips that textures in view have more of
+    than they need. The mips that are needed by the current frame are never evicted for others.
+*/
+class ETH_GRAPHIC_DLL TextureResidencyPolicy : public NonCopyable
+{
+public:
+    static constexpr uint32_t InvalidHandle = std::numeric_limits<uint32_t>::max();
+
+    TextureResidencyPolicy(size_t budget, uint32_t maxPendingLoads);
+    ~TextureResidencyPolicy() = default;
+
+public:
+    // mipSizes holds the size of each mip from the most detailed one down. The mips from firstTailMip
+    // down are resident from the start. They belong to whoever loaded the texture (e.g. the world
+    // streamer, which budgets for them), so only the more detailed mips count against this budget.
+    uint32_t AddTexture(const size_t* mipSizes, uint32_t numMips, uint32_t firstTailMip);
+    // Pending loads of the texture are forgotten, their data has to be dropped when it arrives
+    void RemoveTexture(uint32_t handle);
+
+    // The texture is sampled at (up to) this mip in the current frame
+    void RequestMip(uint32_t handle, uint32_t mipLevel);
+
+    // Turns the requests since the last update into loads and evictions. Evicted memory is usually not
+    // freed right away (e.g. the GPU may still be using it), releasingMemory is what is still waiting
+    // to be freed. It counts against the budget.
+    void Update(size_t releasingMemory, std::vector<TextureMipLoad>& loads, std::vector<TextureMipEviction>& evictions);
+
+    // For the loads that Update() has returned. Textures are not streamed any further once a load failed.
+    void OnMipLoaded(uint32_t handle, uint32_t mipLevel);
+    void OnMipLoadFailed(uint32_t handle, uint32_t mipLevel);
+
+    // Checks the bookkeeping, returns a description of the first problem found. Meant for tests.
+    std::string Validate() const;
+
+public:
+    inline size_t GetBudget() const { return m_Budget; }
+    // Resident mips above the tails and pending loads
+    inline size_t GetCommittedMemory() const { return m_CommittedMemory; }
+    inline uint32_t GetNumPendingLoads() const { return m_NumPendingLoads; }
+    inline uint32_t GetNumTextures() const { return static_cast<uint32_t>(m_Textures.size() - m_FreeHandles.size()); }
+
+    uint32_t GetResidentMip(uint32_t handle) const;
+    // Including the tail
+    size_t GetResidentSize(uint32_t handle) const;
+    bool IsLoading(uint32_t handle) const;
+
+private:
+    static constexpr uint32_t NoRequest = std::numeric_limits<uint32_t>::max();
+
+    struct TextureState
+    {
+        size_t m_MipSizes[MaxNumMips];
+        uint32_t m_NumMips;
+        uint32_t m_FirstTailMip;
+        uint32_t m_ResidentMip;
+        // The most detailed mip requested since the last update, and as of the last update that had one
+        uint32_t m_RequestedMip;
+        uint32_t m_WantedMip;
+        uint64_t m_LastUsed;
+        bool m_IsValid;
+        bool m_IsLoading;
+        bool m_HasFailed;
+    };
+
+private:
+    // The mips that may be evicted, down to (but excluding) the returned one
+    uint32_t GetEvictionLimit(const TextureState& texture) const;
+    // Of the resident mips above the tail, which are the ones that count against the budget
+    size_t GetStreamedSize(const TextureState& texture) const;
+    void EvictMip(uint32_t handle, std::vector<TextureMipEviction>& evictions);
+
+private:
+    const size_t m_Budget;
+    const uint32_t m_MaxPendingLoads;
+
+    std::vector<TextureState> m_Textures;
+    std::vector<uint32_t> m_FreeHandles;
+
+    uint64_t m_UpdateIndex;
+    size_t m_CommittedMemory;
+    uint32_t m_NumPendingLoads;
+
+    // Scratch space for Update()
+    std::vector<uint32_t> m_LoadCandidates;
+    std::vector<uint32_t> m_EvictionCandidates;
+};
+} // namespace Ether::Graphics
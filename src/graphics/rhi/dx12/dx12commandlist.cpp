@@ -260,6 +260,33 @@ void Ether::Graphics::Dx12CommandList::BuildAccelerationStructure(const RhiAccel
     InsertUavBarrier(*as.m_DataBuffer);
 }
 
+void Ether::Graphics::Dx12CommandList::BuildTopLevelAccelerationStructure(
+    const RhiAccelerationStructure& as,
+    uint32_t numInstances,
+    bool performUpdate)
+{
+    static_assert(sizeof(RhiRaytracingInstanceDesc) == sizeof(D3D12_RAYTRACING_INSTANCE_DESC), "Instance desc layouts must match");
+
+    const Dx12AccelerationStructure* dx12Obj = dynamic_cast<const Dx12AccelerationStructure*>(&as);
+
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC asDesc = {};
+    asDesc.Inputs = dx12Obj->m_Inputs;
+    asDesc.Inputs.NumDescs = numInstances;
+    asDesc.Inputs.InstanceDescs = dx12Obj->m_InstanceDescBuffer->GetGpuAddress();
+    asDesc.DestAccelerationStructureData = dx12Obj->m_DataBuffer->GetGpuAddress();
+    asDesc.ScratchAccelerationStructureData = dx12Obj->m_ScratchBuffer->GetGpuAddress();
+
+    // Refit in place
+    if (performUpdate)
+    {
+        asDesc.Inputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
+        asDesc.SourceAccelerationStructureData = dx12Obj->m_DataBuffer->GetGpuAddress();
+    }
+
+    m_CommandList->BuildRaytracingAccelerationStructure(&asDesc, 0, nullptr);
+    InsertUavBarrier(*as.m_DataBuffer);
+}
+
 void Ether::Graphics::Dx12CommandList::InsertUavBarrier(const RhiResource& uavResource)
 {
     D3D12_RESOURCE_BARRIER uavBarrier = {};
@@ -304,8 +331,23 @@ void Ether::Graphics::Dx12CommandList::CopyBufferRegion(
     m_CommandList->CopyBufferRegion(dx12DstResource->m_Resource.Get(), destOff, dx12SrcResource->m_Resource.Get(), srcOff, size);
 }
 
+void Ether::Graphics::Dx12CommandList::CopyTextureRegion(
+    const RhiResource& src,
+    uint32_t srcSubresource,
+    RhiResource& dest,
+    uint32_t destSubresource)
+{
+    const auto dx12SrcResource = (Dx12Resource*)&src;
+    const auto dx12DstResource = (Dx12Resource*)&dest;
+
+    const CD3DX12_TEXTURE_COPY_LOCATION srcLocation(dx12SrcResource->m_Resource.Get(), srcSubresource);
+    const CD3DX12_TEXTURE_COPY_LOCATION destLocation(dx12DstResource->m_Resource.Get(), destSubresource);
+    m_CommandList->CopyTextureRegion(&destLocation, 0, 0, 0, &srcLocation, nullptr);
+}
+
 void Ether::Graphics::Dx12CommandList::CopyTexture(
     RhiResource& scratch,
+    uint64_t scratchOffset,
     RhiResource& dest,
     void** data,
     uint32_t numMips,
@@ -332,7 +374,7 @@ void Ether::Graphics::Dx12CommandList::CopyTexture(
         m_CommandList.Get(),
         dx12DstResource->m_Resource.Get(),
         dx12ScratchResource->m_Resource.Get(),
-        0,
+        scratchOffset,
         0,
         numMips,
         allMipsData.data());
@@ -72,6 +72,7 @@ public:
 
     // Raytracing
     void BuildAccelerationStructure(const RhiAccelerationStructure& as) override;
+    void BuildTopLevelAccelerationStructure(const RhiAccelerationStructure& as, uint32_t numInstances, bool performUpdate) override;
     void SetRaytracingPipelineState(const RhiRaytracingPipelineState& pso) override;
 
     // Barriers
@@ -79,7 +80,8 @@ public:
     void TransitionResource(RhiResource& resource, RhiResourceState newState) override;
     void CopyResource(const RhiResource& src, RhiResource& dest) override;
     void CopyBufferRegion(const RhiResource& src, RhiResource& dest, uint32_t size, uint32_t srcOffset, uint32_t destOffset) override;
-    void CopyTexture(RhiResource& scratch, RhiResource& dest, void** data, uint32_t numMips, uint32_t width, uint32_t height, uint32_t bytesPerPixel) override;
+    void CopyTextureRegion(const RhiResource& src, uint32_t srcSubresource, RhiResource& dest, uint32_t destSubresource) override;
+    void CopyTexture(RhiResource& scratch, uint64_t scratchOffset, RhiResource& dest, void** data, uint32_t numMips, uint32_t width, uint32_t height, uint32_t bytesPerPixel) override;
 
     // Dispatches
     void ClearRenderTargetView(const RhiRenderTargetView rtv, const ethVector4& clearColor) override;
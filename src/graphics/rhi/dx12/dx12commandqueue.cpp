@@ -68,4 +68,15 @@ Ether::Graphics::RhiFenceValue Ether::Graphics::Dx12CommandQueue::Execute(RhiCom
     return m_FinalFenceValue;
 }
 
+void Ether::Graphics::Dx12CommandQueue::WaitForQueue(RhiCommandQueue& queue, RhiFenceValue fenceValue)
+{
+    const auto& dx12Queue = dynamic_cast<Dx12CommandQueue&>(queue);
+    const auto dx12Fence = dynamic_cast<Dx12Fence*>(dx12Queue.m_Fence.get());
+
+    HRESULT hr = m_CommandQueue->Wait(dx12Fence->m_Fence.Get(), fenceValue);
+
+    if (FAILED(hr))
+        LogGraphicsFatal("Failed to make command queue wait for fence");
+}
+
 #endif // ETH_GRAPHICS_DX12
@@ -35,6 +35,7 @@ public:
     void StallForFence(RhiFenceValue fenceValue) override;
     void Flush() override;
     RhiFenceValue Execute(RhiCommandList& cmdList) override;
+    void WaitForQueue(RhiCommandQueue& queue, RhiFenceValue fenceValue) override;
 
 private:
     friend class Dx12Device;
@@ -250,13 +250,16 @@ std::unique_ptr<Ether::Graphics::RhiAccelerationStructure> Ether::Graphics::Dx12
     const RhiTopLevelAccelerationStructureDesc& desc) const
 {
     std::unique_ptr<Dx12AccelerationStructure> dx12Obj = std::make_unique<Dx12AccelerationStructure>();
-    Visual* visuals = reinterpret_cast<Visual*>(desc.m_Visuals);
 
+    // Buffers are sized for the maximum number of instances. The actual number is only set when building.
     dx12Obj->m_Inputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
     dx12Obj->m_Inputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
-    dx12Obj->m_Inputs.NumDescs = desc.m_NumVisuals;
+    dx12Obj->m_Inputs.NumDescs = desc.m_MaxInstances;
     dx12Obj->m_Inputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
 
+    if (desc.m_AllowUpdate)
+        dx12Obj->m_Inputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
+
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO info;
     m_Device->GetRaytracingAccelerationStructurePrebuildInfo(&dx12Obj->m_Inputs, &info);
     dx12Obj->m_Size = info.ResultDataMaxSizeInBytes;
@@ -265,7 +268,7 @@ std::unique_ptr<Ether::Graphics::RhiAccelerationStructure> Ether::Graphics::Dx12
     scratchBufferDesc.m_Name = "TLAS::ScratchBuffer";
     scratchBufferDesc.m_HeapType = RhiHeapType::Default;
     scratchBufferDesc.m_State = RhiResourceState::Common;
-    scratchBufferDesc.m_ResourceDesc = RhiCreateBufferResourceDesc(info.ScratchDataSizeInBytes);
+    scratchBufferDesc.m_ResourceDesc = RhiCreateBufferResourceDesc((std::max)(info.ScratchDataSizeInBytes, info.UpdateScratchDataSizeInBytes));
     scratchBufferDesc.m_ResourceDesc.m_Flag = RhiResourceFlag::AllowUnorderedAccess;
     dx12Obj->m_ScratchBuffer = CreateCommittedResource(scratchBufferDesc);
 
@@ -277,31 +280,13 @@ std::unique_ptr<Ether::Graphics::RhiAccelerationStructure> Ether::Graphics::Dx12
     dataBufferDesc.m_ResourceDesc.m_Flag = RhiResourceFlag::AllowUnorderedAccess;
     dx12Obj->m_DataBuffer = CreateCommittedResource(dataBufferDesc);
 
-    if (desc.m_NumVisuals > 0)
-    {
-        RhiCommitedResourceDesc instanceBufferDesc = {};
-        instanceBufferDesc.m_Name = "TLAS::InstanceBuffer";
-        instanceBufferDesc.m_HeapType = RhiHeapType::Upload;
-        instanceBufferDesc.m_State = RhiResourceState::GenericRead;
-        instanceBufferDesc.m_ResourceDesc = RhiCreateBufferResourceDesc(
-            sizeof(D3D12_RAYTRACING_INSTANCE_DESC) * desc.m_NumVisuals);
-        dx12Obj->m_InstanceDescBuffer = CreateCommittedResource(instanceBufferDesc);
-
-        D3D12_RAYTRACING_INSTANCE_DESC* instanceDesc;
-        dx12Obj->m_InstanceDescBuffer->Map(reinterpret_cast<void**>(&instanceDesc));
-        for (uint64_t i = 0; i < desc.m_NumVisuals; ++i, ++instanceDesc)
-        {
-            instanceDesc->InstanceID = i;
-            instanceDesc->InstanceContributionToHitGroupIndex = 0;
-            instanceDesc->Flags = D3D12_RAYTRACING_INSTANCE_FLAG_NONE;
-            instanceDesc->InstanceMask = 0xFF;
-            ethMatrix4x4 I; // Identity matrix
-            memcpy(instanceDesc->Transform, &I, sizeof(instanceDesc->Transform));
-            instanceDesc
-                ->AccelerationStructure = visuals[i].m_Mesh->GetAccelerationStructure().m_DataBuffer->GetGpuAddress();
-        }
-        dx12Obj->m_InstanceDescBuffer->Unmap();
-    }
+    // Persistent instance buffer, which is updated with copies from upload memory
+    RhiCommitedResourceDesc instanceBufferDesc = {};
+    instanceBufferDesc.m_Name = "TLAS::InstanceBuffer";
+    instanceBufferDesc.m_HeapType = RhiHeapType::Default;
+    instanceBufferDesc.m_State = RhiResourceState::Common;
+    instanceBufferDesc.m_ResourceDesc = RhiCreateBufferResourceDesc(sizeof(D3D12_RAYTRACING_INSTANCE_DESC) * desc.m_MaxInstances);
+    dx12Obj->m_InstanceDescBuffer = CreateCommittedResource(instanceBufferDesc);
 
     return dx12Obj;
 }
@@ -73,6 +73,7 @@ public:
 
     // Raytracing
     virtual void BuildAccelerationStructure(const RhiAccelerationStructure& as) = 0;
+    virtual void BuildTopLevelAccelerationStructure(const RhiAccelerationStructure& as, uint32_t numInstances, bool performUpdate) = 0;
     virtual void SetRaytracingPipelineState(const RhiRaytracingPipelineState& pso) = 0;
 
     // Barriers
@@ -80,7 +81,8 @@ public:
     virtual void TransitionResource(RhiResource& resource, RhiResourceState newState) = 0;
     virtual void CopyResource(const RhiResource& src, RhiResource& dest) = 0;
     virtual void CopyBufferRegion(const RhiResource& src, RhiResource& dest, uint32_t size, uint32_t srcOffset, uint32_t destOffset) = 0;
-    virtual void CopyTexture(RhiResource& scratch, RhiResource& dest, void** data, uint32_t numMips, uint32_t width, uint32_t height, uint32_t bytesPerPixel) = 0;
+    virtual void CopyTextureRegion(const RhiResource& src, uint32_t srcSubresource, RhiResource& dest, uint32_t destSubresource) = 0;
+    virtual void CopyTexture(RhiResource& scratch, uint64_t scratchOffset, RhiResource& dest, void** data, uint32_t numMips, uint32_t width, uint32_t height, uint32_t bytesPerPixel) = 0;
 
     // Dispatches
     virtual void ClearRenderTargetView(const RhiRenderTargetView rtv, const ethVector4& clearColor) = 0;
@@ -49,6 +49,9 @@ public:
     virtual void Flush() = 0;
     virtual RhiFenceValue Execute(RhiCommandList& cmdList) = 0;
 
+    // Makes this queue wait on the GPU for another queue's fence, without blocking the CPU
+    virtual void WaitForQueue(RhiCommandQueue& queue, RhiFenceValue fenceValue) = 0;
+
 public:
     RhiCommandType GetType() const { return m_Type; }
 
@@ -21,6 +21,8 @@
 #include "graphics/rhi/rhiimguiwrapper.h"
 #include "graphics/imgui/imgui.h"
 #include "graphics/rhi/dx12/dx12imguiwrapper.h"
+#include "common/telemetry/telemetry.h"
+#include "common/memory/memorytracker.h"
 
 Ether::Graphics::RhiImguiWrapper::RhiImguiWrapper()
     : m_Context("Imgui Context")
@@ -145,6 +147,30 @@ void Ether::Graphics::RhiImguiWrapper::Render()
                 1000.0f / ImGui::GetIO().Framerate,
                 ImGui::GetIO().Framerate);
             ImGui::Text("Frame Number: %lld", Graphics::GraphicCore::GetGraphicRenderer().GetFrameNumber());
+
+            const RenderStats& renderStats = Graphics::GraphicCore::GetGraphicRenderer().GetRenderStats();
+            ImGui::Text(
+                "Geometry: %u draws, %u instances (%.3f ms CPU submit)",
+                renderStats.m_NumDrawCalls,
+                renderStats.m_NumInstances,
+                renderStats.m_GeometrySubmitTime);
+
+            const UploadRingBufferStats& uploadStats = Graphics::GraphicCore::GetUploadRingBuffer().GetStats();
+            ImGui::Text(
+                "Upload Ring: %.2f MiB (%u growths)",
+                uploadStats.m_Capacity / double(_1MiB),
+                uploadStats.m_NumGrowths);
+            ImGui::Text(
+                "Upload/Frame: %.1f KiB last, %.1f KiB avg, %.1f KiB peak",
+                uploadStats.m_LastFrameBytes / double(_1KiB),
+                uploadStats.m_AverageFrameBytes / _1KiB,
+                uploadStats.m_PeakFrameBytes / double(_1KiB));
+            ImGui::Text(
+                "Upload Waste/Frame: %.1f KiB last, %.1f KiB avg, %.1f KiB peak (%.1f KiB dedicated)",
+                uploadStats.m_LastFrameWastedBytes / double(_1KiB),
+                uploadStats.m_AverageFrameWastedBytes / _1KiB,
+                uploadStats.m_PeakFrameWastedBytes / double(_1KiB),
+                uploadStats.m_LastFrameDedicatedBytes / double(_1KiB));
             ImGui::PlotLines(
                 "",
                 fpsHistoryBuffer,
@@ -154,6 +180,91 @@ void Ether::Graphics::RhiImguiWrapper::Render()
                 0.0f,
                 300.0f,
                 ImVec2(360, 60));
+
+            if (ImGui::TreeNode("Frame Telemetry"))
+            {
+                Telemetry& telemetry = Telemetry::Instance();
+
+                ImGui::Columns(5, "Telemetry");
+                ImGui::SetColumnWidth(0, 200);
+                ImGui::Text("Channel (ms)");
+                ImGui::NextColumn();
+                ImGui::Text("p50");
+                ImGui::NextColumn();
+                ImGui::Text("p95");
+                ImGui::NextColumn();
+                ImGui::Text("p99");
+                ImGui::NextColumn();
+                ImGui::Text("max");
+                ImGui::NextColumn();
+                ImGui::Separator();
+
+                for (const std::string& channel : telemetry.GetChannelNames())
+                {
+                    const TelemetrySummary summary = telemetry.GetSummary(channel);
+                    ImGui::TextUnformatted(channel.c_str());
+                    ImGui::NextColumn();
+                    ImGui::Text("%.3f", summary.m_P50);
+                    ImGui::NextColumn();
+                    ImGui::Text("%.3f", summary.m_P95);
+                    ImGui::NextColumn();
+                    ImGui::Text("%.3f", summary.m_P99);
+                    ImGui::NextColumn();
+                    ImGui::Text("%.3f", summary.m_Max);
+                    ImGui::NextColumn();
+                }
+
+                ImGui::Columns(1);
+
+                if (ImGui::Button("Reset"))
+                    telemetry.Clear();
+                ImGui::SameLine();
+                if (ImGui::Button("Export CSV"))
+                    telemetry.ExportCsv("telemetry.csv");
+                ImGui::SameLine();
+                if (ImGui::Button("Export JSON"))
+                    telemetry.ExportJson("telemetry.json");
+
+                ImGui::TreePop();
+            }
+
+            if (ImGui::TreeNode("Memory"))
+            {
+                const MemorySnapshot snapshot = MemoryTracker::GetSnapshot();
+
+                ImGui::Columns(5, "Memory");
+                ImGui::SetColumnWidth(0, 200);
+                ImGui::Text("Tag");
+                ImGui::NextColumn();
+                ImGui::Text("Live (MiB)");
+                ImGui::NextColumn();
+                ImGui::Text("Peak (MiB)");
+                ImGui::NextColumn();
+                ImGui::Text("Allocs/frame");
+                ImGui::NextColumn();
+                ImGui::Text("KiB/frame");
+                ImGui::NextColumn();
+                ImGui::Separator();
+
+                for (uint32_t i = 0; i < static_cast<uint32_t>(MemoryTag::NumTags); ++i)
+                {
+                    const MemoryTag tag = static_cast<MemoryTag>(i);
+                    const MemoryTagStats& stats = snapshot.Get(tag);
+                    ImGui::TextUnformatted(GetMemoryTagName(tag));
+                    ImGui::NextColumn();
+                    ImGui::Text("%.2f", stats.m_LiveBytes / static_cast<double>(_1MiB));
+                    ImGui::NextColumn();
+                    ImGui::Text("%.2f", stats.m_PeakBytes / static_cast<double>(_1MiB));
+                    ImGui::NextColumn();
+                    ImGui::Text("%llu", stats.m_NumFrameAllocations);
+                    ImGui::NextColumn();
+                    ImGui::Text("%.2f", stats.m_NumFrameAllocatedBytes / static_cast<double>(_1KiB));
+                    ImGui::NextColumn();
+                }
+
+                ImGui::Columns(1);
+                ImGui::TreePop();
+            }
         }
         ImGui::End();
     }
@@ -336,10 +336,24 @@ struct RhiBottomLevelAccelerationStructureDesc
 
 struct RhiTopLevelAccelerationStructureDesc
 {
-    void* m_Visuals;
-    uint32_t m_NumVisuals;
+    uint32_t m_MaxInstances;
+    bool m_AllowUpdate;
 };
 
+// Same layout as D3D12_RAYTRACING_INSTANCE_DESC (and VkAccelerationStructureInstanceKHR),
+// so that instances can be copied into the TLAS instance buffer as is
+struct RhiRaytracingInstanceDesc
+{
+    float m_Transform[3][4];
+    uint32_t m_InstanceID : 24;
+    uint32_t m_InstanceMask : 8;
+    uint32_t m_InstanceContributionToHitGroupIndex : 24;
+    uint32_t m_Flags : 8;
+    RhiGpuAddress m_AccelerationStructure;
+};
+
+static_assert(sizeof(RhiRaytracingInstanceDesc) == 64, "Raytracing instance descs must be 64 bytes");
+
 struct RhiRaytracingShaderBindingTableDesc
 {
     const wchar_t* m_HitGroupName;
@@ -20,6 +20,7 @@
 #include "graphics/graphiccore.h"
 #include "graphics/schedule/framescheduler.h"
 #include "graphics/schedule/schedulecontext.h"
+#include "common/telemetry/telemetry.h"
 
 #include "graphics/schedule/producers/denoisedlightingproducer.h"
 #include "graphics/schedule/producers/finalcompositeproducer.h"
@@ -124,6 +125,7 @@ void Ether::Graphics::FrameScheduler::BuildSchedule()
     }
 
     schedule.CreateResources(m_ResourceContext);
+    m_ResourceContext.CommitShaderVisibleViews();
 
     // TODO: Run a topological sort to order the producers based on their inputs and outputs
     // defined in schedule context.
@@ -167,6 +169,7 @@ void Ether::Graphics::FrameScheduler::RenderSingleThreaded(GraphicContext& conte
         if (m_OrderedProducers.front()->IsEnabled())
         {
             ETH_MARKER_EVENT((m_OrderedProducers.front()->GetName() + " - Render").c_str());
+            ScopedTelemetry telemetry("Producer - " + m_OrderedProducers.front()->GetName());
             context.PushMarker(m_OrderedProducers.front()->GetName());
             m_OrderedProducers.front()->RenderFrame(context, m_ResourceContext);
             context.PopMarker();
@@ -175,10 +178,16 @@ void Ether::Graphics::FrameScheduler::RenderSingleThreaded(GraphicContext& conte
         m_OrderedProducers.pop();
     }
 
-    context.FinalizeAndExecute();
+    {
+        ScopedTelemetry telemetry("Renderer - Execute");
+        context.FinalizeAndExecute();
+    }
 
     if (GraphicCore::GetGraphicConfig().IsDebugGuiEnabled())
+    {
+        ScopedTelemetry telemetry("Renderer - Debug Gui");
         m_ImguiWrapper->Render();
+    }
 
     // The following can be moved into its own render pass
     context.Reset();
@@ -178,15 +178,15 @@ void Ether::Graphics::BloomProducer::AddBloomSubpass(
     const GraphicConfig& config = GraphicCore::GetGraphicConfig();
     const ethVector2u resolution = config.GetResolution();
 
-    auto alloc = GetFrameAllocator().Allocate({ sizeof(Shader::BloomParams), 256 });
-    Shader::BloomParams* params = (Shader::BloomParams*)alloc->GetCpuHandle();
+    UploadBufferAllocation alloc = GetFrameAllocator().Allocate({ sizeof(Shader::BloomParams), 256 });
+    Shader::BloomParams* params = (Shader::BloomParams*)alloc.GetCpuHandle();
     params->m_PassIndex = passType;
     params->m_Resolution = { std::floor(dstResolution.x), std::floor(dstResolution.y) };
     params->m_Intensity = config.m_BloomIntensity;
     params->m_Scatter = config.m_BloomScatter;
     params->m_Anamorphic = config.m_BloomAnamorphic;
     ctx.InsertUavBarrier(*rc.GetResource(src));
-    ctx.SetComputeRootConstantBufferView(1, ((UploadBufferAllocation&)(*alloc)).GetGpuAddress());
+    ctx.SetComputeRootConstantBufferView(1, alloc.GetGpuAddress());
     ctx.SetComputeRootDescriptorTable(2, src->GetGpuAddress());
     ctx.SetComputeRootDescriptorTable(3, dst->GetGpuAddress());
     ctx.SetComputeRootDescriptorTable(4, dstUav->GetGpuAddress());
@@ -48,6 +48,7 @@ DECLARE_GFX_SR(MaterialTable)
 
 Ether::Graphics::GBufferProducer::GBufferProducer()
     : GraphicProducer("GBufferProducer")
+    , m_BatchedVisualsVersion(std::numeric_limits<uint64_t>::max())
 {
 }
 
@@ -81,7 +82,8 @@ void Ether::Graphics::GBufferProducer::RenderFrame(GraphicContext& ctx, Resource
     const RhiDevice& gfxDevice = GraphicCore::GetDevice();
     const GraphicDisplay& gfxDisplay = GraphicCore::GetGraphicDisplay();
     const GraphicConfig& config = GraphicCore::GetGraphicConfig();
-    const std::vector<VisualBatch>& batches = GraphicCore::GetGraphicRenderer().GetRenderData().m_VisualBatches;
+    const RenderData& renderData = GraphicCore::GetRenderData();
+    RenderStats& stats = GraphicCore::GetGraphicRenderer().GetRenderStats();
 
     ctx.PushMarker("Clear");
     ctx.TransitionResource(gfxDisplay.GetBackBuffer(), RhiResourceState::RenderTarget);
@@ -116,21 +118,48 @@ void Ether::Graphics::GBufferProducer::RenderFrame(GraphicContext& ctx, Resource
     
     ctx.SetRenderTargets(rtvs, sizeof(rtvs) / sizeof(rtvs[0]), &(*ACCESS_GFX_DS(GBufferDepthStencil)));
 
-    for (const VisualBatch& batch : batches)
-    for (const Visual& visual : batch.m_Visuals)
     {
         ETH_MARKER_EVENT("Draw Meshes");
-        if (visual.m_Culled)
-            continue;
-
-        auto alloc = GetFrameAllocator().Allocate({ sizeof(Shader::InstanceParams), 256 });
-        Shader::InstanceParams* instanceParams = (Shader::InstanceParams*)alloc->GetCpuHandle();
-        instanceParams->m_MaterialIdx = visual.m_Material->GetTransientMaterialIdx();
-
-        ctx.SetGraphicsRootConstantBufferView(1, ((UploadBufferAllocation&)(*alloc)).GetGpuAddress());
-        ctx.SetVertexBuffer(visual.m_Mesh->GetVertexBufferView());
-        ctx.SetIndexBuffer(visual.m_Mesh->GetIndexBufferView());
-        ctx.DrawIndexedInstanced(visual.m_Mesh->GetNumIndices(), 1);
+        const double submitStart = Time::GetRealTime();
+
+        // The batch only depends on the visuals, so it can be reused for as long as the version is unchanged
+        if (renderData.m_VisualsVersion != m_BatchedVisualsVersion)
+        {
+            m_InstanceBatcher.Build(renderData.m_Visuals);
+            m_BatchedVisualsVersion = renderData.m_VisualsVersion;
+        }
+
+        const std::vector<uint32_t>& instances = m_InstanceBatcher.GetInstances();
+
+        // Instance data for the whole pass goes into a single frame allocation that is bound once as a root SRV.
+        // Each draw finds its instances through the offset passed as a root constant.
+        UploadBufferAllocation alloc = GetFrameAllocator().Allocate({ instances.size() * sizeof(Shader::InstanceParams), 256 });
+        Shader::InstanceParams* instanceParams = (Shader::InstanceParams*)alloc.GetCpuHandle();
+        ctx.SetGraphicsRootShaderResourceView(3, alloc.GetGpuAddress());
+
+        uint32_t numInstancesWritten = 0;
+
+        for (const InstancedDraw& draw : m_InstanceBatcher.GetDraws())
+        {
+            ctx.SetVertexBuffer(draw.m_Mesh->GetVertexBufferView());
+            ctx.SetIndexBuffer(draw.m_Mesh->GetIndexBufferView());
+
+            for (uint32_t i = 0; i < draw.m_NumInstances; ++i)
+            {
+                const Visual& visual = renderData.m_Visuals[instances[numInstancesWritten + i]];
+                instanceParams[numInstancesWritten + i].m_WorldMatrix = visual.m_WorldMatrix;
+                instanceParams[numInstancesWritten + i].m_MaterialIdx = visual.m_Material->GetTransientMaterialIdx();
+            }
+
+            ctx.SetGraphicsRootConstant(1, numInstancesWritten, 0);
+            ctx.DrawIndexedInstanced(draw.m_Mesh->GetNumIndices(), draw.m_NumInstances);
+
+            numInstancesWritten += draw.m_NumInstances;
+            stats.m_NumDrawCalls++;
+        }
+
+        stats.m_NumInstances += numInstancesWritten;
+        stats.m_GeometrySubmitTime += Time::GetRealTime() - submitStart;
     }
 
     ctx.PopMarker();
@@ -138,7 +167,7 @@ void Ether::Graphics::GBufferProducer::RenderFrame(GraphicContext& ctx, Resource
 
 bool Ether::Graphics::GBufferProducer::IsEnabled()
 {
-    //if (GraphicCore::GetGraphicRenderer().GetRenderData().m_Visuals.empty())
+    //if (GraphicCore::GetRenderData().m_Visuals.empty())
     //    return false;
 
     return true;
@@ -160,10 +189,11 @@ void Ether::Graphics::GBufferProducer::CreateShaders()
 
 void Ether::Graphics::GBufferProducer::CreateRootSignature()
 {
-    std::unique_ptr<RhiRootSignatureDesc> rsDesc = GraphicCore::GetDevice().CreateRootSignatureDesc(3, 0);
+    std::unique_ptr<RhiRootSignatureDesc> rsDesc = GraphicCore::GetDevice().CreateRootSignatureDesc(4, 0);
     rsDesc->SetAsConstantBufferView(0, 0, RhiShaderVisibility::All); // (b0) GlobalConstants
-    rsDesc->SetAsConstantBufferView(1, 1, RhiShaderVisibility::All); // (b1) InstanceParams
+    rsDesc->SetAsConstant(1, 1, 1, RhiShaderVisibility::All);        // (b1) DrawConstants
     rsDesc->SetAsShaderResourceView(2, 0, RhiShaderVisibility::All); // (t0) MaterialTable
+    rsDesc->SetAsShaderResourceView(3, 1, RhiShaderVisibility::All); // (t1) InstanceParams
     rsDesc->SetFlags(RhiRootSignatureFlag::AllowIAInputLayout | RhiRootSignatureFlag::DirectlyIndexed);
     m_RootSignature = rsDesc->Compile((GetName() + " Root Signature").c_str());
 }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "graphics/schedule/producers/graphicproducer.h"
+#include "graphics/common/instancebatcher.h"
 
 namespace Ether::Graphics
 {
@@ -46,5 +47,8 @@ private:
     std::unique_ptr<RhiShader> m_VertexShader, m_PixelShader;
     std::unique_ptr<RhiRootSignature> m_RootSignature;
     std::unique_ptr<RhiGraphicPipelineStateDesc> m_PsoDesc;
+
+    InstanceBatcher m_InstanceBatcher;
+    uint64_t m_BatchedVisualsVersion;
 };
 } // namespace Ether::Graphics
\ No newline at end of file
@@ -41,7 +41,7 @@ void Ether::Graphics::GlobalConstantsProducer::GetInputOutput(ScheduleContext& s
 
 void Ether::Graphics::GlobalConstantsProducer::RenderFrame(GraphicContext& ctx, ResourceContext& rc)
 {
-    const RenderData& renderData = GraphicCore::GetGraphicRenderer().GetRenderData();
+    const RenderData& renderData = GraphicCore::GetRenderData();
 
     static ethMatrix4x4 viewMatrixPrev = renderData.m_ViewMatrix;
     static ethMatrix4x4 projMatrixPrev = renderData.m_ProjectionMatrix;
@@ -51,8 +51,8 @@ void Ether::Graphics::GlobalConstantsProducer::RenderFrame(GraphicContext& ctx,
     if (renderData.m_ViewMatrix != viewMatrixPrev)
         lastMovedFrameNumber = GraphicCore::GetGraphicRenderer().GetFrameNumber();
 
-    auto alloc = GetFrameAllocator().Allocate({ sizeof(Shader::GlobalConstants), 256 });
-    Shader::GlobalConstants* globalConstants = (Shader::GlobalConstants*)alloc->GetCpuHandle();
+    UploadBufferAllocation alloc = GetFrameAllocator().Allocate({ sizeof(Shader::GlobalConstants), 256 });
+    Shader::GlobalConstants* globalConstants = (Shader::GlobalConstants*)alloc.GetCpuHandle();
     globalConstants->m_ViewMatrix = renderData.m_ViewMatrix;
     globalConstants->m_ViewMatrixInv = renderData.m_ViewMatrix.Inversed();
     globalConstants->m_ViewMatrixPrev = viewMatrixPrev;
@@ -93,15 +93,15 @@ void Ether::Graphics::GlobalConstantsProducer::RenderFrame(GraphicContext& ctx,
     globalConstants->m_SamplerIndex_Linear_Wrap = GraphicCore::GetGraphicCommon().m_SamplerIndex_Linear_Wrap;
     globalConstants->m_SamplerIndex_Linear_Border = GraphicCore::GetGraphicCommon().m_SamplerIndex_Linear_Border;
 
-    StringID hdriID = GraphicCore::GetGraphicRenderer().GetRenderData().m_HdriTextureID;
+    StringID hdriID = GraphicCore::GetRenderData().m_HdriTextureID;
     globalConstants->m_HdriTextureIndex = GraphicCore::GetBindlessDescriptorManager().GetDescriptorIndex(hdriID); 
 
     ctx.CopyBufferRegion(
-        dynamic_cast<UploadBufferAllocation&>(*alloc).GetResource(),
+        alloc.GetResource(),
         *rc.GetResource(ACCESS_GFX_CB(GlobalRingBuffer)),
-        alloc->GetSize(),
-        0,
-        alloc->GetSize() * GraphicCore::GetGraphicDisplay().GetBackBufferIndex()
+        alloc.GetSize(),
+        alloc.GetOffset(),
+        alloc.GetSize() * GraphicCore::GetGraphicDisplay().GetBackBufferIndex()
     );
 
     // For velocity vector calculations
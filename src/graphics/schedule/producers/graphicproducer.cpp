@@ -23,14 +23,11 @@
 Ether::Graphics::GraphicProducer::GraphicProducer(const char* name)
 {
     m_Name = name;
-
-    for (int i = 0; i < MaxSwapChainBuffers; ++i)
-        m_FrameLocalUploadBuffer[i] = std::make_unique<UploadBufferAllocator>(_2MiB);
 }
 
 void Ether::Graphics::GraphicProducer::Reset()
 {
-    m_FrameLocalUploadBuffer[GraphicCore::GetGraphicDisplay().GetBackBufferIndex()]->Reset();
+    // Frame uploads are reclaimed by the shared upload ring once the GPU is done with them
 }
 
 bool Ether::Graphics::GraphicProducer::IsEnabled()
@@ -39,7 +36,7 @@ bool Ether::Graphics::GraphicProducer::IsEnabled()
     return true;
 }
 
-Ether::Graphics::UploadBufferAllocator& Ether::Graphics::GraphicProducer::GetFrameAllocator()
+Ether::Graphics::UploadRingBuffer& Ether::Graphics::GraphicProducer::GetFrameAllocator()
 {
-    return *m_FrameLocalUploadBuffer[GraphicCore::GetGraphicDisplay().GetBackBufferIndex()];
+    return GraphicCore::GetUploadRingBuffer();
 }
@@ -24,6 +24,7 @@
 #include "graphics/schedule/schedulecontext.h"
 #include "graphics/context/resourcecontext.h"
 #include "graphics/context/graphiccontext.h"
+#include "graphics/memory/uploadringbuffer.h"
 #include "graphics/rhi/rhiresourceviews.h"
 
 namespace Ether::Graphics
@@ -48,10 +49,7 @@ protected:
     virtual bool IsEnabled();
 
 protected:
-    UploadBufferAllocator& GetFrameAllocator();
+    UploadRingBuffer& GetFrameAllocator();
     std::string m_Name;
-
-private:
-    std::unique_ptr<UploadBufferAllocator> m_FrameLocalUploadBuffer[MaxSwapChainBuffers];
 };
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include "graphics/schedule/producers/graphicproducer.h"
 #include "graphics/rhi/rhiraytracingpipelinestate.h"
 #include "graphics/rhi/rhiraytracingshaderbindingtable.h"
+#include "graphics/common/tlasmanager.h"
 
 namespace Ether::Graphics
 {
@@ -52,5 +53,6 @@ protected:
 
 protected:
     RhiResource* m_RaytracingShaderBindingTable;
+    TlasManager m_TlasManager;
 };
 } // namespace Ether::Graphics
\ No newline at end of file
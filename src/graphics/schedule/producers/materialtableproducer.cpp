@@ -27,6 +27,9 @@ DEFINE_GFX_SR(MaterialTable)
 
 Ether::Graphics::MaterialTableProducer::MaterialTableProducer()
     : GraphicProducer("MaterialTableProducer")
+    , m_TableCapacity(0)
+    , m_UploadedTable(nullptr)
+    , m_UploadedTableCapacity(0)
 {
 }
 
@@ -36,20 +39,39 @@ void Ether::Graphics::MaterialTableProducer::Initialize(ResourceContext& rc)
 
 void Ether::Graphics::MaterialTableProducer::GetInputOutput(ScheduleContext& schedule, ResourceContext& rc)
 {
-    uint32_t numMaterials = GraphicCore::GetGraphicRenderer().GetRenderData().m_VisualBatches.size();
-    schedule.NewSR(ACCESS_GFX_SR(MaterialTable), sizeof(Shader::Material) * numMaterials, 0, RhiFormat::Unknown, RhiResourceDimension::StructuredBuffer, sizeof(Shader::Material));
+    uint32_t numMaterials = GraphicCore::GetRenderData().m_VisualBatches.size();
+    m_TableCapacity = AlignUp((std::max)(numMaterials, 1u), TableGrowthSize);
+    schedule.NewSR(ACCESS_GFX_SR(MaterialTable), sizeof(Shader::Material) * m_TableCapacity, 0, RhiFormat::Unknown, RhiResourceDimension::StructuredBuffer, sizeof(Shader::Material));
 }
 
 void Ether::Graphics::MaterialTableProducer::RenderFrame(GraphicContext& ctx, ResourceContext& rc)
 {
-    const RenderData& renderData = GraphicCore::GetGraphicRenderer().GetRenderData();
+    RenderData& renderData = GraphicCore::GetRenderData();
+    RhiResource& materialTable = *rc.GetResource(ACCESS_GFX_SR(MaterialTable));
     uint32_t numMaterials = renderData.m_VisualBatches.size();
 
-    auto alloc = GetFrameAllocator().Allocate({ sizeof(Shader::Material) * numMaterials, 256 });
-    Shader::Material* materials = (Shader::Material*)alloc->GetCpuHandle();
-    for (uint32_t i = 0; i < numMaterials; ++i)
+    // Only batches in the dirty range are uploaded, unless the table was recreated. That covers new batches as well as
+    // the texture streamers, which mark a material's batch dirty whenever one of its textures gets a new descriptor index.
+    if (&materialTable != m_UploadedTable || m_TableCapacity != m_UploadedTableCapacity)
     {
-        Material* currMat = renderData.m_VisualBatches[i].m_Material;
+        renderData.m_DirtyMaterials.Add(0, numMaterials);
+        m_UploadedTable = &materialTable;
+        m_UploadedTableCapacity = m_TableCapacity;
+    }
+
+    const uint32_t begin = renderData.m_DirtyMaterials.m_Begin;
+    const uint32_t end = (std::min)(renderData.m_DirtyMaterials.m_End, numMaterials);
+    renderData.m_DirtyMaterials.Clear();
+
+    if (begin >= end)
+        return;
+
+    const uint32_t numDirtyMaterials = end - begin;
+    UploadBufferAllocation alloc = GetFrameAllocator().Allocate({ sizeof(Shader::Material) * numDirtyMaterials, 256 });
+    Shader::Material* materials = (Shader::Material*)alloc.GetCpuHandle();
+    for (uint32_t i = 0; i < numDirtyMaterials; ++i)
+    {
+        Material* currMat = renderData.m_VisualBatches[begin + i].m_Material;
         materials[i].m_BaseColor = currMat->GetBaseColor();
         materials[i].m_SpecularColor = currMat->GetSpecularColor();
         materials[i].m_EmissiveColor = currMat->GetEmissiveColor();
@@ -61,10 +83,9 @@ void Ether::Graphics::MaterialTableProducer::RenderFrame(GraphicContext& ctx, Re
     }
 
     ctx.CopyBufferRegion(
-        dynamic_cast<UploadBufferAllocation&>(*alloc).GetResource(),
-        *rc.GetResource(ACCESS_GFX_SR(MaterialTable)),
-        sizeof(Shader::Material) * numMaterials,
-        0,
-        0);
+        alloc.GetResource(),
+        materialTable,
+        sizeof(Shader::Material) * numDirtyMaterials,
+        static_cast<uint32_t>(alloc.GetOffset()),
+        sizeof(Shader::Material) * begin);
 }
-
@@ -33,5 +33,13 @@ public:
     void Initialize(ResourceContext& rc) override;
     void GetInputOutput(ScheduleContext& schedule, ResourceContext& rc) override;
     void RenderFrame(GraphicContext& ctx, ResourceContext& rc) override;
+
+private:
+    // The table is grown in blocks so that new materials do not recreate (and fully re-upload) it every time
+    static constexpr uint32_t TableGrowthSize = 64;
+
+    uint32_t m_TableCapacity;
+    RhiResource* m_UploadedTable;
+    uint32_t m_UploadedTableCapacity;
 };
 } // namespace Ether::Graphics
\ No newline at end of file
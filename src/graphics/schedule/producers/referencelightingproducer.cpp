@@ -31,7 +31,6 @@ DEFINE_GFX_PA(ReferenceLightingProducer)
 DEFINE_GFX_UA(RTIndirectTexture)
 DEFINE_GFX_SR(RTAccumulationTexture)
 DEFINE_GFX_SR(RTGeometryInfo)
-DEFINE_GFX_AS(RTTopLevelAccelerationStructure)
 
 DECLARE_GFX_UA(LightingTexture)
 DECLARE_GFX_SR(LightingTexture)
@@ -63,12 +62,11 @@ void Ether::Graphics::ReferenceLightingProducer::Initialize(ResourceContext& rc)
 void Ether::Graphics::ReferenceLightingProducer::GetInputOutput(ScheduleContext& schedule, ResourceContext& rc)
 {
     ethVector2u resolution = GraphicCore::GetGraphicConfig().GetResolution();
-    uint32_t numVisuals = GraphicCore::GetGraphicRenderer().GetRenderData().m_Visuals.size();
+    uint32_t numVisuals = GraphicCore::GetRenderData().m_Visuals.size();
 
     schedule.NewUA(ACCESS_GFX_UA(RTIndirectTexture), resolution.x, resolution.y, BackBufferHdrFormat, RhiResourceDimension::Texture2D);
     schedule.NewSR(ACCESS_GFX_SR(RTAccumulationTexture), resolution.x, resolution.y, BackBufferHdrFormat, RhiResourceDimension::Texture2D);
     schedule.NewSR(ACCESS_GFX_SR(RTGeometryInfo), sizeof(Shader::GeometryInfo) * numVisuals, 0, RhiFormat::Unknown, RhiResourceDimension::StructuredBuffer, sizeof(Shader::GeometryInfo));
-    schedule.NewAS(ACCESS_GFX_AS(RTTopLevelAccelerationStructure), GraphicCore::GetGraphicRenderer().GetRenderData().m_Visuals);
 
     schedule.Read(ACCESS_GFX_SR(GBufferTexture0));
     schedule.Read(ACCESS_GFX_SR(GBufferTexture1));
@@ -85,10 +83,12 @@ void Ether::Graphics::ReferenceLightingProducer::RenderFrame(GraphicContext& ctx
     const RhiDevice& gfxDevice = GraphicCore::GetDevice();
     const GraphicDisplay& gfxDisplay = GraphicCore::GetGraphicDisplay();
     const GraphicConfig& config = GraphicCore::GetGraphicConfig();
-    const std::vector<Visual>& visuals = GraphicCore::GetGraphicRenderer().GetRenderData().m_Visuals;
+    const RenderData& renderData = GraphicCore::GetRenderData();
+    const std::vector<Visual>& visuals = renderData.m_Visuals;
 
     const auto resolution = GraphicCore::GetGraphicConfig().GetResolution();
     ctx.PushMarker("Raytrace");
+    m_TlasManager.Update(ctx, GetFrameAllocator(), renderData);
     ctx.TransitionResource(*rc.GetResource(ACCESS_GFX_UA(LightingTexture)), RhiResourceState::UnorderedAccess);
     ctx.SetSrvCbvUavDescriptorHeap(GraphicCore::GetSrvCbvUavAllocator().GetDescriptorHeap());
     ctx.SetSamplerDescriptorHeap(GraphicCore::GetSamplerAllocator().GetDescriptorHeap());
@@ -96,7 +96,7 @@ void Ether::Graphics::ReferenceLightingProducer::RenderFrame(GraphicContext& ctx
 
     uint64_t ringBufferOffset = gfxDisplay.GetBackBufferIndex() * AlignUp(sizeof(Shader::GlobalConstants), 256);
     ctx.SetComputeRootConstantBufferView(0, rc.GetResource(ACCESS_GFX_CB(GlobalRingBuffer))->GetGpuAddress() + ringBufferOffset);
-    ctx.SetComputeRootShaderResourceView(1, rc.GetResource(ACCESS_GFX_AS(RTTopLevelAccelerationStructure))->GetGpuAddress());
+    ctx.SetComputeRootShaderResourceView(1, m_TlasManager.GetGpuAddress());
     ctx.SetComputeRootShaderResourceView(2, rc.GetResource(ACCESS_GFX_SR(RTGeometryInfo))->GetGpuAddress());
     ctx.SetComputeRootShaderResourceView(3, rc.GetResource(ACCESS_GFX_SR(MaterialTable))->GetGpuAddress());
     ctx.SetComputeRootDescriptorTable(4, ACCESS_GFX_SR(RTAccumulationTexture)->GetGpuAddress());
@@ -109,8 +109,8 @@ void Ether::Graphics::ReferenceLightingProducer::RenderFrame(GraphicContext& ctx
     ctx.SetRaytracingShaderBindingTable(m_RaytracingShaderBindingTable);
     ctx.SetRaytracingPipelineState((RhiRaytracingPipelineState&)rc.GetPipelineState(*m_RTPsoDesc));
 
-    auto alloc = GetFrameAllocator().Allocate({ sizeof(Shader::GeometryInfo) * visuals.size(), 256 });
-    Shader::GeometryInfo* geometryInfos = (Shader::GeometryInfo*)alloc->GetCpuHandle();
+    UploadBufferAllocation alloc = GetFrameAllocator().Allocate({ sizeof(Shader::GeometryInfo) * visuals.size(), 256 });
+    Shader::GeometryInfo* geometryInfos = (Shader::GeometryInfo*)alloc.GetCpuHandle();
     for (uint32_t i = 0; i < visuals.size(); ++i)
     {
         geometryInfos[i].m_VBDescriptorIndex = visuals[i].m_Mesh->GetVertexBufferSrvIndex();
@@ -119,10 +119,10 @@ void Ether::Graphics::ReferenceLightingProducer::RenderFrame(GraphicContext& ctx
     }
 
     ctx.CopyBufferRegion(
-        dynamic_cast<UploadBufferAllocation&>(*alloc).GetResource(),
+        alloc.GetResource(),
         *rc.GetResource(ACCESS_GFX_SR(RTGeometryInfo)),
         sizeof(Shader::GeometryInfo) * visuals.size(),
-        0,
+        alloc.GetOffset(),
         0);
 
     ctx.DispatchRays(resolution.x, resolution.y, 1);
@@ -140,7 +140,7 @@ bool Ether::Graphics::ReferenceLightingProducer::IsEnabled()
     if (!GraphicCore::GetGraphicConfig().m_IsRaytracingEnabled)
         return false;
 
-    if (GraphicCore::GetGraphicRenderer().GetRenderData().m_Visuals.empty())
+    if (GraphicCore::GetRenderData().m_Visuals.empty())
         return false;
 
     return true;
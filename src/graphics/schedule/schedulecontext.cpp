@@ -190,23 +190,6 @@ const void Ether::Graphics::ScheduleContext::NewCB(GFX_STATIC::GFX_CB_TYPE& cbv,
     Write(cbv);
 }
 
-const void Ether::Graphics::ScheduleContext::NewAS(GFX_STATIC::GFX_AS_TYPE& acv, const std::vector<Visual>& visuals)
-{
-    acv.Create();
-    RhiAccelerationStructureResourceView* view = acv.Get().get();
-    view->SetWidth(0);
-    view->SetHeight(0);
-    view->SetDepth(0);
-    view->SetFormat(RhiFormat::Unknown);
-    view->SetDimension(RhiResourceDimension::RTAccelerationStructure);
-    view->SetViewID(acv.GetName());
-    view->SetResourceID(acv.GetSharedResourceName());
-    view->SetVisuals((void*)visuals.data());
-    view->SetNumVisuals(visuals.size());
-
-    Write(acv);
-}
-
 void Ether::Graphics::ScheduleContext::CreateResources(ResourceContext& resourceContext)
 {
     // 1) Go through all descriptors that point to a single resource
@@ -256,12 +239,6 @@ void Ether::Graphics::ScheduleContext::CreateResources(ResourceContext& resource
         case RhiResourceDimension::Texture3D:
             resourceContext.CreateTexture3DResource(resourceID.GetString().c_str(), { width, height, depth }, format, flags);
             break;
-        case RhiResourceDimension::RTAccelerationStructure:
-            resourceContext.CreateAccelerationStructure(
-                resourceID.GetString().c_str(),
-                { dynamic_cast<RhiAccelerationStructureResourceView*>(firstView)->GetVisuals(),
-                  dynamic_cast<RhiAccelerationStructureResourceView*>(firstView)->GetNumVisuals() });
-            break;
         default:
             LogGraphicsError("Resource of an unsupported dimension specified");
         }
@@ -23,9 +23,15 @@
 
 ETH_BEGIN_SHADER_NAMESPACE
 
+// Per-instance data for instanced geometry draws. Laid out as a StructuredBuffer, indexed with
+// (first instance of the draw + SV_InstanceID), since SV_InstanceID does not include the start instance.
 struct InstanceParams
 {
+    ethMatrix4x4 m_WorldMatrix;
     uint32_t m_MaterialIdx;
+    uint32_t m_Padding[3];
 };
 
+ETH_SHADER_STATIC_ASSERT(sizeof(InstanceParams) % 16 == 0 && "Structured buffer stride should be 16byte aligned");
+
 ETH_END_SHADER_NAMESPACE
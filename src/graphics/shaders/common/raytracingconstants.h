@@ -28,6 +28,10 @@ ETH_BEGIN_SHADER_NAMESPACE
 #define RESTIR_SPATIAL_PASS     2
 #define RESTIR_EVALUATION_PASS  3
 
+#define RT_INSTANCE_MASK_OPAQUE     0x01
+#define RT_INSTANCE_MASK_EMISSIVE   0x02
+#define RT_INSTANCE_MASK_ALL        0xFF
+
 struct GeometryInfo
 {
     uint32_t m_VBDescriptorIndex;
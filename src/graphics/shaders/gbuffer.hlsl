@@ -30,6 +30,7 @@ struct VS_INPUT
     float3 Normal       : NORMAL;
     float3 Tangent      : TANGENT;
     float2 TexCoord     : TEXCOORD;
+    uint InstanceID     : SV_InstanceID;
 };
 
 struct VS_OUTPUT
@@ -38,6 +39,12 @@ struct VS_OUTPUT
     float3 Normal       : NORMAL;
     float2 TexCoord     : TEXCOORD0;
     float3 Tangent      : TEXCOORD1;
+    nointerpolation uint MaterialIdx : MATERIALIDX;
+};
+
+struct DrawConstants
+{
+    uint m_FirstInstance;
 };
 
 struct PS_OUTPUT
@@ -49,8 +56,9 @@ struct PS_OUTPUT
 };
 
 ConstantBuffer<GlobalConstants> g_GlobalConstants   : register(b0);
-ConstantBuffer<InstanceParams> g_InstanceParams     : register(b1);
+ConstantBuffer<DrawConstants> g_DrawConstants       : register(b1);
 StructuredBuffer<Material> g_MaterialTable          : register(t0);
+StructuredBuffer<InstanceParams> g_InstanceParams   : register(t1);
 
 float4x4 RemoveJitter(float4x4 jitteredProjMatrix)
 {
@@ -67,10 +75,15 @@ VS_OUTPUT VS_Main(VS_INPUT IN)
 {
     VS_OUTPUT o;
 
-    o.Position = mul(g_GlobalConstants.m_ViewProjectionMatrix, float4(IN.Position, 1.0f));
-    o.Normal = IN.Normal;
+    InstanceParams instance = g_InstanceParams[g_DrawConstants.m_FirstInstance + IN.InstanceID];
+    float4 worldPos = mul(instance.m_WorldMatrix, float4(IN.Position, 1.0f));
+
+    // Not the inverse transpose, so normals are only correct for uniform scales
+    o.Position = mul(g_GlobalConstants.m_ViewProjectionMatrix, worldPos);
+    o.Normal = normalize(mul((float3x3)instance.m_WorldMatrix, IN.Normal));
     o.TexCoord = IN.TexCoord;
-    o.Tangent = IN.Tangent;
+    o.Tangent = normalize(mul((float3x3)instance.m_WorldMatrix, IN.Tangent));
+    o.MaterialIdx = instance.m_MaterialIdx;
 
     return o;
 }
@@ -78,7 +91,7 @@ VS_OUTPUT VS_Main(VS_INPUT IN)
 PS_OUTPUT PS_Main(VS_OUTPUT IN)
 {
     sampler linearSampler = SamplerDescriptorHeap[g_GlobalConstants.m_SamplerIndex_Linear_Wrap];
-    Material material = g_MaterialTable[g_InstanceParams.m_MaterialIdx];
+    Material material = g_MaterialTable[IN.MaterialIdx];
 
     float4 clipPos = ScreenToClipSpace(IN.Position, g_GlobalConstants.m_ScreenResolution);
     float4 worldPos = mul(g_GlobalConstants.m_ViewProjectionMatrixInv, clipPos);
@@ -85,7 +85,7 @@ MeshVertex GetHitSurface(in BuiltInTriangleIntersectionAttributes attribs, in Ge
     const MeshVertex v1 = vtxBuffer[idx1];
     const MeshVertex v2 = vtxBuffer[idx2];
 
-    return BarycentricLerp(v0, v1, v2, barycentrics);
+    return TransformToWorldSpace(BarycentricLerp(v0, v1, v2, barycentrics));
 
 }
 
@@ -102,7 +102,7 @@ float3 TraceShadow(float3 position, float3 wo, float3 normal, float3 albedo, flo
     shadowRay.Origin = position + (normal * 0.01);
     shadowRay.TMax = 128;
     shadowRay.TMin = 0.01;
-    TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE | RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH, 0xFF, 0, 0, 0, shadowRay, payload);
+    TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE | RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH, RT_INSTANCE_MASK_ALL, 0, 0, 0, shadowRay, payload);
 
     const float3 wi = normalize(shadowRay.Direction);
     const float3 Li = payload.m_Radiance;
@@ -179,7 +179,7 @@ float3 TraceRecursively(float3 position, float3 wo, float3 normal, float3 albedo
     indirectRay.Origin = position;
     indirectRay.TMax = 128;
     indirectRay.TMin = 0.01;
-    TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE, 0xFF, 0, 0, 0, indirectRay, payload);
+    TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE, RT_INSTANCE_MASK_ALL, 0, 0, 0, indirectRay, payload);
     const float3 Li = min(10000.0f, payload.m_Radiance);
 
     return Li * f * cosTheta;
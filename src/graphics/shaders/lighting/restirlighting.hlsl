@@ -93,7 +93,7 @@ bool TraceVisibility(float3 a, float3 b)
     ray.Origin = a;
     ray.TMax = length(b - a) - 0.01;
     ray.TMin = 0.01;
-    TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE, 0xFF, 0, 0, 0, ray, payload);
+    TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE, RT_INSTANCE_MASK_ALL, 0, 0, 0, ray, payload);
 
     return !payload.m_Hit;
 }
@@ -161,7 +161,7 @@ MeshVertex GetHitSurface(in BuiltInTriangleIntersectionAttributes attribs, in Ge
     const MeshVertex v1 = vtxBuffer[idx1];
     const MeshVertex v2 = vtxBuffer[idx2];
 
-    return BarycentricLerp(v0, v1, v2, barycentrics);
+    return TransformToWorldSpace(BarycentricLerp(v0, v1, v2, barycentrics));
 }
 
 void SampleDirectionCosine(GBufferSurface surface, out float3 wi, out float pdf)
@@ -288,7 +288,7 @@ float3 TraceDirectLighting(GBufferSurface surface, float3 wo)
     shadowRay.TMax = 128;
     shadowRay.TMin = 0.01;
     uint flags = RAY_FLAG_FORCE_OPAQUE | RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH;
-    TraceRay(g_RaytracingTlas, flags, 0xFF, 0, 0, 0, shadowRay, payload);
+    TraceRay(g_RaytracingTlas, flags, RT_INSTANCE_MASK_ALL, 0, 0, 0, shadowRay, payload);
 
     const float3 wi = normalize(shadowRay.Direction);
     const float3 Li = payload.m_Radiance;
@@ -356,7 +356,7 @@ float3 TraceLightingRecursively(GBufferSurface surface, uint depth)
         indirectRay.Origin = surface.m_Position;
         indirectRay.TMax = 128;
         indirectRay.TMin = 0.01;
-        TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE, 0xFF, 0, 0, 0, indirectRay, indirectPayload);
+        TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE, RT_INSTANCE_MASK_ALL, 0, 0, 0, indirectRay, indirectPayload);
         Li = indirectPayload.m_Radiance;
     }
 
@@ -378,7 +378,7 @@ ReservoirSample TraceInitialSample(GBufferSurface surface, float3 wi, float3 wo)
     ray.Origin = surface.m_Position;
     ray.TMax = 128;
     ray.TMin = 0.01;
-    TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE, 0xFF, 0, 0, 0, ray, payload);
+    TraceRay(g_RaytracingTlas, RAY_FLAG_FORCE_OPAQUE, RT_INSTANCE_MASK_ALL, 0, 0, 0, ray, payload);
 
     ReservoirSample initialSample;
     initialSample.m_SamplePosition = payload.m_HitPosition;
@@ -55,3 +55,12 @@ MeshVertex BarycentricLerp(in MeshVertex v0, in MeshVertex v1, in MeshVertex v2,
 
     return vtx;
 }
+
+// Mesh vertices are stored in object space. Can only be called from hit shaders.
+MeshVertex TransformToWorldSpace(in MeshVertex vtx)
+{
+    vtx.m_Position = mul(ObjectToWorld3x4(), float4(vtx.m_Position, 1.0f));
+    vtx.m_Normal = normalize(mul(vtx.m_Normal, (float3x3)WorldToObject3x4()));
+    vtx.m_Tangent = normalize(mul((float3x3)ObjectToWorld3x4(), vtx.m_Tangent));
+    return vtx;
+}
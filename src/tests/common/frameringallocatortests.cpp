@@ -0,0 +1,333 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/memory/frameringallocator.h"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <thread>
+
+using namespace Ether;
+
+// Fence values are simulated on the CPU: every frame is closed with the next fence value, and the
+// "GPU" completes them with a configurable lag
+
+static bool Overlaps(const AllocationHandle& a, const AllocationHandle& b)
+{
+    return a.m_Offset < b.m_Offset + b.m_Size && b.m_Offset < a.m_Offset + a.m_Size;
+}
+
+ETH_TEST(FrameRingAllocator, AllocationsAreLinearWithinAFrame)
+{
+    FrameRingAllocator allocator(1024);
+    allocator.BeginFrame(0);
+    ETH_CHECK(allocator.GetFrameCapacity() == 1024);
+
+    const AllocationHandle a = allocator.Allocate(100);
+    const AllocationHandle b = allocator.Allocate({ 64, 64 });
+    ETH_REQUIRE(a.IsValid() && b.IsValid());
+    ETH_CHECK(a.m_Offset == 0);
+    ETH_CHECK(b.m_Offset == 128);
+    ETH_CHECK(!Overlaps(a, b));
+
+    allocator.EndFrame(1);
+    ETH_CHECK(allocator.GetNumPendingFrames() == 1);
+}
+
+ETH_TEST(FrameRingAllocator, StallsUntilFenceCompletes)
+{
+    FrameRingAllocator allocator(1024);
+
+    // The GPU never catches up, so every frame gets what the previous ones left over
+    allocator.BeginFrame(0);
+    ETH_CHECK(allocator.Allocate(600).IsValid());
+    allocator.EndFrame(1);
+
+    allocator.BeginFrame(0);
+    ETH_CHECK(allocator.GetFrameCapacity() == 424);
+    ETH_CHECK(allocator.Allocate(424).IsValid());
+    ETH_CHECK(!allocator.Allocate(1).IsValid());
+    allocator.EndFrame(2);
+
+    allocator.BeginFrame(0);
+    ETH_CHECK(allocator.GetFrameCapacity() == 0);
+    ETH_CHECK(!allocator.HasSpace(1));
+    ETH_CHECK(!allocator.Allocate(1).IsValid());
+    allocator.EndFrame(3);
+
+    // The failed allocations above must not have leaked into the next frame
+    allocator.BeginFrame(0);
+    ETH_CHECK(allocator.GetFrameCapacity() == 0);
+    allocator.EndFrame(4);
+
+    // Retiring the first frame frees its range at the start of the ring
+    allocator.BeginFrame(1);
+    ETH_CHECK(allocator.GetFrameCapacity() == 600);
+
+    const AllocationHandle alloc = allocator.Allocate(600);
+    ETH_REQUIRE(alloc.IsValid());
+    ETH_CHECK(alloc.m_Offset == 0);
+    allocator.EndFrame(5);
+}
+
+ETH_TEST(FrameRingAllocator, AlignedAllocationsFillTheFrame)
+{
+    FrameRingAllocator allocator(1024);
+    allocator.BeginFrame(0);
+
+    // Padding is only added where the head is actually misaligned
+    for (size_t offset = 0; offset < 1024; offset += 256)
+    {
+        const AllocationHandle alloc = allocator.Allocate({ 256, 256 });
+        ETH_REQUIRE(alloc.IsValid());
+        ETH_CHECK(alloc.m_Offset == offset);
+    }
+
+    ETH_CHECK(allocator.GetFrameSize() == 1024);
+    ETH_CHECK(!allocator.Allocate(1).IsValid());
+    allocator.EndFrame(1);
+
+    allocator.BeginFrame(1);
+    const AllocationHandle a = allocator.Allocate({ 8, 8 });
+    const AllocationHandle b = allocator.Allocate({ 64, 64 });
+    const AllocationHandle c = allocator.Allocate({ 8, 8 });
+    ETH_REQUIRE(a.IsValid() && b.IsValid() && c.IsValid());
+    ETH_CHECK(b.m_Offset == 64);
+    ETH_CHECK(c.m_Offset == 128);
+    allocator.EndFrame(2);
+}
+
+ETH_TEST(FrameRingAllocator, FailedAllocationLeavesTheFrameIntact)
+{
+    FrameRingAllocator allocator(1024);
+
+    allocator.BeginFrame(0);
+    ETH_CHECK(allocator.Allocate(1000).IsValid());
+    ETH_CHECK(!allocator.Allocate(2048).IsValid());
+    ETH_CHECK(!allocator.Allocate(32).IsValid());
+    ETH_CHECK(allocator.GetFrameSize() == 1000);
+
+    // Whatever is left is still there for allocations that fit
+    const AllocationHandle alloc = allocator.Allocate(24);
+    ETH_REQUIRE(alloc.IsValid());
+    ETH_CHECK(alloc.m_Offset == 1000);
+    ETH_CHECK(!allocator.Allocate(1).IsValid());
+    allocator.EndFrame(1);
+
+    // Only the frame is lost, the ring itself is intact
+    allocator.BeginFrame(1);
+    ETH_CHECK(allocator.GetFrameCapacity() == 1024);
+    ETH_CHECK(allocator.Allocate(1024).IsValid());
+    allocator.EndFrame(2);
+}
+
+ETH_TEST(FrameRingAllocator, FrameRangesNeverWrap)
+{
+    FrameRingAllocator allocator(1024);
+
+    allocator.BeginFrame(0);
+    ETH_REQUIRE(allocator.Allocate(400).IsValid());
+    allocator.EndFrame(1);
+
+    allocator.BeginFrame(0);
+    ETH_REQUIRE(allocator.Allocate(400).IsValid());
+    allocator.EndFrame(2);
+
+    // 224 left at the end of the ring, 400 freed at its start. The end is skipped for the larger range.
+    allocator.BeginFrame(1);
+    ETH_CHECK(allocator.GetFrameCapacity() == 400);
+
+    const AllocationHandle alloc = allocator.Allocate(400);
+    ETH_REQUIRE(alloc.IsValid());
+    ETH_CHECK(alloc.m_Offset == 0);
+    allocator.EndFrame(3);
+
+    // The skipped end is retired along with the frame that skipped it
+    allocator.BeginFrame(3);
+    ETH_CHECK(allocator.GetNumPendingFrames() == 0);
+    ETH_CHECK(allocator.GetFrameCapacity() == 1024);
+}
+
+ETH_TEST(FrameRingAllocator, FencesRetireInSubmissionOrder)
+{
+    FrameRingAllocator allocator(1024);
+
+    // The second frame closes with a lower fence value, e.g. from a queue that runs ahead. Its range
+    // lies behind the first frame's, so it must not be reclaimed before the first one retires.
+    allocator.BeginFrame(0);
+    ETH_REQUIRE(allocator.Allocate(300).IsValid());
+    allocator.EndFrame(5);
+
+    allocator.BeginFrame(0);
+    ETH_REQUIRE(allocator.Allocate(300).IsValid());
+    allocator.EndFrame(3);
+
+    allocator.BeginFrame(3);
+    ETH_CHECK(allocator.GetNumPendingFrames() == 2);
+    ETH_CHECK(allocator.GetFrameCapacity() == 424);
+    allocator.EndFrame(6);
+
+    allocator.BeginFrame(5);
+    ETH_CHECK(allocator.GetNumPendingFrames() == 1);
+    allocator.EndFrame(7);
+
+    allocator.BeginFrame(7);
+    ETH_CHECK(allocator.GetNumPendingFrames() == 0);
+    ETH_CHECK(allocator.GetFrameCapacity() == 1024);
+}
+
+ETH_TEST(FrameRingAllocator, ResetReclaimsEverything)
+{
+    FrameRingAllocator allocator(1024);
+    allocator.BeginFrame(0);
+    const AllocationHandle alloc = allocator.Allocate(512);
+    allocator.EndFrame(1);
+
+    allocator.Reset();
+    ETH_CHECK(!allocator.Owns(alloc));
+    ETH_CHECK(allocator.GetNumPendingFrames() == 0);
+
+    allocator.BeginFrame(0);
+    ETH_CHECK(allocator.GetFrameCapacity() == 1024);
+}
+
+// Many frames with a GPU that falls behind by a random number of frames. Every allocation is checked
+// against the allocations of all frames that have not retired yet.
+ETH_TEST(FrameRingAllocator, RandomizedFenceSimulation)
+{
+    static constexpr size_t Capacity = 4096;
+    static constexpr uint32_t NumFrames = 5000;
+    static constexpr uint32_t MaxFramesInFlight = 3;
+
+    struct InFlightFrame
+    {
+        uint64_t m_FenceValue;
+        std::vector<AllocationHandle> m_Allocations;
+    };
+
+    FrameRingAllocator allocator(Capacity);
+    std::deque<InFlightFrame> inFlightFrames;
+    uint64_t completedFenceValue = 0;
+    uint32_t numFailedAllocations = 0;
+    uint32_t numWraps = 0;
+    size_t lastOffset = 0;
+
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<uint32_t> lagDist(0, MaxFramesInFlight);
+    std::uniform_int_distribution<uint32_t> numAllocsDist(0, 24);
+    std::uniform_int_distribution<size_t> sizeDist(1, 96);
+    std::uniform_int_distribution<uint32_t> alignmentShiftDist(0, 4);
+
+    for (uint64_t frame = 1; frame <= NumFrames; ++frame)
+    {
+        // Complete fences until at most a random number of frames is still in flight
+        const uint32_t lag = lagDist(random);
+        while (inFlightFrames.size() > lag)
+        {
+            completedFenceValue = inFlightFrames.front().m_FenceValue;
+            inFlightFrames.pop_front();
+        }
+
+        allocator.BeginFrame(completedFenceValue);
+        ETH_REQUIRE(allocator.GetNumPendingFrames() == inFlightFrames.size());
+
+        InFlightFrame current = { frame, {} };
+        const uint32_t numAllocs = numAllocsDist(random);
+
+        for (uint32_t i = 0; i < numAllocs; ++i)
+        {
+            const size_t alignment = size_t(1) << alignmentShiftDist(random);
+            const AllocationHandle alloc = allocator.Allocate({ sizeDist(random), alignment });
+
+            if (!alloc.IsValid())
+            {
+                numFailedAllocations++;
+                continue;
+            }
+
+            ETH_CHECK_MSG(alloc.m_Offset % alignment == 0, "frame {}: offset {} is not aligned to {}", frame, alloc.m_Offset, alignment);
+            ETH_CHECK_MSG(alloc.m_Offset + alloc.m_Size <= Capacity, "frame {}: allocation wraps around the ring", frame);
+
+            for (const InFlightFrame& inFlight : inFlightFrames)
+                for (const AllocationHandle& other : inFlight.m_Allocations)
+                    ETH_REQUIRE(!Overlaps(alloc, other));
+
+            for (const AllocationHandle& other : current.m_Allocations)
+                ETH_REQUIRE(!Overlaps(alloc, other));
+
+            numWraps += alloc.m_Offset < lastOffset ? 1 : 0;
+            lastOffset = alloc.m_Offset;
+            current.m_Allocations.push_back(alloc);
+        }
+
+        allocator.EndFrame(frame);
+        inFlightFrames.push_back(std::move(current));
+    }
+
+    // The frames are small enough that only wrapping and stalling behind the GPU should fail them
+    ETH_CHECK_MSG(numFailedAllocations < NumFrames, "{} allocations failed", numFailedAllocations);
+    ETH_CHECK_MSG(numWraps > 100, "The ring only wrapped {} times", numWraps);
+
+    // Once the GPU catches up, the whole ring is available again
+    allocator.BeginFrame(NumFrames);
+    ETH_CHECK(allocator.GetNumPendingFrames() == 0);
+    ETH_CHECK(allocator.GetFrameCapacity() == Capacity);
+}
+
+ETH_TEST(FrameRingAllocator, ConcurrentAllocationsDoNotOverlap)
+{
+    static constexpr uint32_t NumThreads = 4;
+    static constexpr uint32_t NumAllocsPerThread = 200;
+
+    // Exactly enough room, so that contention must not cost any padding either
+    FrameRingAllocator allocator(NumThreads * NumAllocsPerThread * 16);
+    allocator.BeginFrame(0);
+
+    std::vector<std::vector<AllocationHandle>> allocations(NumThreads);
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < NumThreads; ++t)
+    {
+        threads.emplace_back([&allocator, &allocations, t]()
+        {
+            for (uint32_t i = 0; i < NumAllocsPerThread; ++i)
+                allocations[t].push_back(allocator.Allocate(16));
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::vector<AllocationHandle> all;
+    for (const std::vector<AllocationHandle>& threadAllocations : allocations)
+        for (const AllocationHandle& alloc : threadAllocations)
+        {
+            ETH_REQUIRE(alloc.IsValid());
+            all.push_back(alloc);
+        }
+
+    std::sort(all.begin(), all.end(), [](const AllocationHandle& a, const AllocationHandle& b) { return a.m_Offset < b.m_Offset; });
+    for (size_t i = 1; i < all.size(); ++i)
+        ETH_REQUIRE(all[i - 1].m_Offset + all[i - 1].m_Size <= all[i].m_Offset);
+
+    ETH_CHECK(!allocator.Allocate(16).IsValid());
+    allocator.EndFrame(1);
+}
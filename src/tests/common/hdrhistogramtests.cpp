@@ -0,0 +1,192 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/telemetry/hdrhistogram.h"
+
+#include <random>
+
+using namespace Ether;
+
+// The value that was recorded, or the next one up within the same bucket
+static bool IsWithinSignificantDigits(uint64_t actual, uint64_t expected, uint32_t numSignificantDigits)
+{
+    const double resolution = std::pow(10.0, -static_cast<double>(numSignificantDigits));
+    return actual >= expected && actual - expected <= static_cast<uint64_t>(expected * resolution);
+}
+
+ETH_TEST(HdrHistogram, ValuesKeepTheirSignificantDigits)
+{
+    // Nanoseconds up to an hour, as the frame time histograms use them
+    constexpr uint64_t highestTrackableValue = 3600ull * 1000 * 1000 * 1000;
+
+    for (uint32_t numSignificantDigits = 1; numSignificantDigits <= 5; ++numSignificantDigits)
+    {
+        HdrHistogram histogram(highestTrackableValue, numSignificantDigits);
+
+        for (uint64_t magnitude = 1; magnitude <= highestTrackableValue / 10; magnitude *= 10)
+        {
+            for (uint64_t mantissa : { 1, 3, 7, 9 })
+            {
+                // The value itself, and the value right below the next power of two
+                for (uint64_t value : { mantissa * magnitude + mantissa, std::bit_ceil(mantissa * magnitude) - 1 })
+                {
+                    histogram.Clear();
+                    histogram.Record(value);
+                    histogram.Record(highestTrackableValue);
+
+                    const uint64_t result = histogram.GetValueAtPercentile(50.0);
+                    ETH_CHECK_MSG(
+                        IsWithinSignificantDigits(result, value, numSignificantDigits),
+                        "{} came back as {} with {} significant digits",
+                        value,
+                        result,
+                        numSignificantDigits);
+                }
+            }
+        }
+    }
+}
+
+ETH_TEST(HdrHistogram, SmallValuesAreExact)
+{
+    HdrHistogram histogram(1000000, 3);
+
+    // Below the sub-bucket count, every value has a bucket of its own
+    for (uint64_t value = 0; value < 2048; ++value)
+    {
+        histogram.Clear();
+        histogram.Record(value);
+        histogram.Record(1000000);
+        ETH_CHECK_MSG(histogram.GetValueAtPercentile(50.0) == value, "{} came back as {}", value, histogram.GetValueAtPercentile(50.0));
+    }
+}
+
+ETH_TEST(HdrHistogram, ValuesAboveTheHighestTrackableValueAreClamped)
+{
+    for (uint64_t highestTrackableValue : { 1000ull, 4096ull, 4095ull, 1ull << 40, 1ull << 63, ~0ull })
+    {
+        HdrHistogram histogram(highestTrackableValue, 3);
+        histogram.Record(10);
+        histogram.Record(highestTrackableValue, 2);
+        histogram.Record(~0ull);
+
+        ETH_CHECK(histogram.GetTotalCount() == 4);
+        ETH_CHECK(histogram.GetMin() == 10);
+        ETH_CHECK_MSG(histogram.GetMax() == highestTrackableValue, "Max of {} is {}", highestTrackableValue, histogram.GetMax());
+        ETH_CHECK(histogram.GetValueAtPercentile(100.0) == highestTrackableValue);
+        ETH_CHECK(histogram.GetValueAtPercentile(25.0) == 10);
+    }
+}
+
+ETH_TEST(HdrHistogram, PercentilesOfAKnownDistribution)
+{
+    HdrHistogram histogram(1000000, 3);
+    for (uint64_t value = 1; value <= 100000; ++value)
+        histogram.Record(value);
+
+    ETH_CHECK(histogram.GetTotalCount() == 100000);
+    ETH_CHECK(histogram.GetMin() == 1);
+    ETH_CHECK(histogram.GetMax() == 100000);
+    ETH_CHECK(histogram.GetMean() == 50000.5);
+
+    ETH_CHECK(IsWithinSignificantDigits(histogram.GetValueAtPercentile(50.0), 50000, 3));
+    ETH_CHECK(IsWithinSignificantDigits(histogram.GetValueAtPercentile(90.0), 90000, 3));
+    ETH_CHECK(IsWithinSignificantDigits(histogram.GetValueAtPercentile(99.0), 99000, 3));
+    ETH_CHECK(IsWithinSignificantDigits(histogram.GetValueAtPercentile(99.9), 99900, 3));
+    ETH_CHECK(histogram.GetValueAtPercentile(100.0) == 100000);
+    ETH_CHECK(histogram.GetValueAtPercentile(0.0) == 1);
+
+    // Mostly fast frames with a few hitches, the hitches must show up in the tail only
+    HdrHistogram frameTimes(1000000, 3);
+    frameTimes.Record(16000, 990);
+    frameTimes.Record(250000, 10);
+
+    ETH_CHECK(IsWithinSignificantDigits(frameTimes.GetValueAtPercentile(50.0), 16000, 3));
+    ETH_CHECK(IsWithinSignificantDigits(frameTimes.GetValueAtPercentile(99.0), 16000, 3));
+    ETH_CHECK(IsWithinSignificantDigits(frameTimes.GetValueAtPercentile(99.5), 250000, 3));
+    ETH_CHECK(frameTimes.GetValueAtPercentile(100.0) == 250000);
+
+    frameTimes.Clear();
+    ETH_CHECK(frameTimes.GetTotalCount() == 0);
+    ETH_CHECK(frameTimes.GetValueAtPercentile(50.0) == 0);
+}
+
+ETH_TEST(HdrHistogram, MergeWithTheSameLayout)
+{
+    HdrHistogram a(1000000, 3), b(1000000, 3), combined(1000000, 3);
+
+    std::mt19937 random(1);
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        const uint64_t value = random() % 2000000;
+        (i % 3 == 0 ? a : b).Record(value);
+        combined.Record(value);
+    }
+
+    a.Merge(b);
+    ETH_CHECK(a.GetTotalCount() == combined.GetTotalCount());
+    ETH_CHECK(a.GetMin() == combined.GetMin());
+    ETH_CHECK(a.GetMax() == combined.GetMax());
+    ETH_CHECK(a.GetMean() == combined.GetMean());
+
+    // Exactly the same counts, so every percentile agrees
+    for (double percentile = 0.0; percentile <= 100.0; percentile += 0.5)
+        ETH_CHECK_MSG(a.GetValueAtPercentile(percentile) == combined.GetValueAtPercentile(percentile), "p{} differs", percentile);
+}
+
+ETH_TEST(HdrHistogram, MergeWithDifferentLayouts)
+{
+    // A coarser and wider histogram, merged into a finer and narrower one
+    HdrHistogram fine(1000000, 3), coarse(100000000, 2), combined(1000000, 3);
+
+    std::mt19937 random(2);
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        const uint64_t value = 1 + random() % 500000;
+        (i % 2 == 0 ? fine : coarse).Record(value);
+        combined.Record(value);
+    }
+
+    coarse.Record(50000000);
+    combined.Record(50000000);
+
+    fine.Merge(coarse);
+    ETH_CHECK(fine.GetTotalCount() == combined.GetTotalCount());
+    ETH_CHECK(fine.GetMin() == combined.GetMin());
+    ETH_CHECK(fine.GetMax() == 1000000);
+
+    // Only as precise as the coarser of the two
+    for (double percentile = 1.0; percentile < 100.0; percentile += 1.0)
+        ETH_CHECK_MSG(
+            IsWithinSignificantDigits(fine.GetValueAtPercentile(percentile), combined.GetValueAtPercentile(percentile), 2),
+            "p{} is {} instead of {}",
+            percentile,
+            fine.GetValueAtPercentile(percentile),
+            combined.GetValueAtPercentile(percentile));
+
+    // And the other way around, which loses nothing but the precision of the finer one
+    HdrHistogram wide(100000000, 2);
+    wide.Merge(combined);
+    ETH_CHECK(wide.GetTotalCount() == combined.GetTotalCount());
+    ETH_CHECK(wide.GetMin() == combined.GetMin());
+    ETH_CHECK(wide.GetMax() == combined.GetMax());
+    ETH_CHECK(wide.GetValueAtPercentile(100.0) == combined.GetMax());
+    ETH_CHECK(IsWithinSignificantDigits(wide.GetValueAtPercentile(50.0), combined.GetValueAtPercentile(50.0), 2));
+}
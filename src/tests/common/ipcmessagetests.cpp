@@ -0,0 +1,228 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/ipc/ipcmessage.h"
+#include "common/ipc/loopbacktransport.h"
+
+#include <cstring>
+#include <functional>
+
+using namespace Ether;
+
+static constexpr uint32_t TestMessageType = MakeIpcTag('T', 'E', 'S', 'T');
+
+static IpcMessage CreateBinaryMessage()
+{
+    IpcMessage message(TestMessageType, 3);
+
+    const uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+    const char name[] = "cube";
+    message.AddSection(MakeIpcTag('I', 'N', 'D', 'X'), indices, sizeof(indices));
+    message.AddSection(MakeIpcTag('N', 'A', 'M', 'E'), name, sizeof(name) - 1);
+    message.AddSection(MakeIpcTag('N', 'O', 'N', 'E'), nullptr, 0);
+    return message;
+}
+
+// A binary frame as it would come over the wire, with whatever header and payload it is given
+static std::vector<uint8_t> CreateFrame(uint32_t numSections, uint64_t payloadSize, const std::vector<uint8_t>& payload)
+{
+    IpcFrameHeader frameHeader = {};
+    frameHeader.m_Magic = IpcMessage::Magic;
+    frameHeader.m_MessageType = TestMessageType;
+    frameHeader.m_NumSections = numSections;
+    frameHeader.m_PayloadSize = payloadSize;
+
+    std::vector<uint8_t> frame(sizeof(frameHeader));
+    std::memcpy(frame.data(), &frameHeader, sizeof(frameHeader));
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    return frame;
+}
+
+static std::vector<uint8_t> CreateSection(uint32_t tag, uint64_t size, size_t numPayloadBytes)
+{
+    IpcSectionHeader sectionHeader = {};
+    sectionHeader.m_Tag = tag;
+    sectionHeader.m_Size = size;
+
+    std::vector<uint8_t> section(sizeof(sectionHeader) + numPayloadBytes, 0xab);
+    std::memcpy(section.data(), &sectionHeader, sizeof(sectionHeader));
+    return section;
+}
+
+/*
+    Sends the bytes and reads them back as a message. Returns why the message was rejected, or
+    nothing if it was not. The sender is closed right away, so that reading more than was sent
+    fails with a lost connection rather than blocking.
+*/
+static std::string GetReadError(const std::vector<uint8_t>& bytes)
+{
+    LoopbackTransport::Pair loopback = LoopbackTransport::CreatePair();
+    loopback.first->Send(bytes.data(), bytes.size());
+    loopback.first->Close();
+
+    try
+    {
+        IpcMessage::ReadFrom(*loopback.second);
+    }
+    catch (const std::runtime_error& error)
+    {
+        return error.what();
+    }
+
+    return {};
+}
+
+static bool IsRejectedFor(const std::vector<uint8_t>& bytes, const char* reason)
+{
+    return GetReadError(bytes).find(reason) != std::string::npos;
+}
+
+static bool IsSameSection(const IpcSection& a, const IpcSection& b)
+{
+    return a.m_Tag == b.m_Tag && a.m_Size == b.m_Size && (a.m_Size == 0 || std::memcmp(a.m_Data, b.m_Data, a.m_Size) == 0);
+}
+
+static bool IsRejected(const std::function<void()>& func)
+{
+    try
+    {
+        func();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+ETH_TEST(IpcMessage, FromBytesReadsWholeMessages)
+{
+    const IpcMessage json = IpcMessage::FromJson("{ \"command\": \"detach\" }");
+    const IpcMessage parsedJson = IpcMessage::FromBytes(json.GetData(), json.GetSizeInBytes());
+    ETH_CHECK(parsedJson.GetFormat() == IpcMessageFormat::Json);
+    ETH_CHECK(parsedJson.GetJson() == json.GetJson());
+
+    const IpcMessage binary = CreateBinaryMessage();
+    const IpcMessage parsedBinary = IpcMessage::FromBytes(binary.GetData(), binary.GetSizeInBytes());
+    ETH_CHECK(parsedBinary.GetFormat() == IpcMessageFormat::Binary);
+    ETH_CHECK(parsedBinary.GetMessageType() == TestMessageType);
+    ETH_CHECK(parsedBinary.GetSchemaVersion() == 3);
+    ETH_REQUIRE(parsedBinary.GetNumSections() == binary.GetNumSections());
+
+    for (size_t i = 0; i < binary.GetNumSections(); ++i)
+        ETH_CHECK_MSG(IsSameSection(parsedBinary.GetSection(i), binary.GetSection(i)), "Section {} differs", i);
+}
+
+ETH_TEST(IpcMessage, FromBytesRejectsAnythingButOneMessage)
+{
+    for (const IpcMessage& message : { IpcMessage::FromJson("{}"), CreateBinaryMessage() })
+    {
+        std::vector<uint8_t> bytes(message.GetData(), message.GetData() + message.GetSizeInBytes());
+
+        for (size_t numBytes = 0; numBytes < bytes.size(); ++numBytes)
+            ETH_CHECK_MSG(IsRejected([&]() { IpcMessage::FromBytes(bytes.data(), numBytes); }), "Accepted {} of {} bytes", numBytes, bytes.size());
+
+        bytes.push_back(0);
+        ETH_CHECK(IsRejected([&]() { IpcMessage::FromBytes(bytes.data(), bytes.size()); }));
+    }
+}
+
+ETH_TEST(IpcMessage, MessagesKeepTheirFramingOverLoopback)
+{
+    LoopbackTransport::Pair loopback = LoopbackTransport::CreatePair();
+
+    // Back to back, so that every message has to stop exactly at its own end
+    const IpcMessage binary = CreateBinaryMessage();
+    binary.WriteTo(*loopback.first);
+    IpcMessage::FromJson("{ \"command\": \"detach\" }").WriteTo(*loopback.first);
+    binary.WriteTo(*loopback.first);
+    IpcMessage(TestMessageType, 1).WriteTo(*loopback.first);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const IpcMessage message = IpcMessage::ReadFrom(*loopback.second);
+        ETH_CHECK(message.GetFormat() == IpcMessageFormat::Binary);
+        ETH_CHECK(message.GetMessageType() == TestMessageType);
+        ETH_CHECK(message.GetSchemaVersion() == 3);
+        ETH_REQUIRE(message.GetNumSections() == 3);
+
+        for (size_t j = 0; j < message.GetNumSections(); ++j)
+        {
+            ETH_CHECK_MSG(IsSameSection(message.GetSection(j), binary.GetSection(j)), "Section {} differs", j);
+            ETH_CHECK(reinterpret_cast<uintptr_t>(message.GetSection(j).m_Data) % IpcMessage::SectionAlignment == 0);
+        }
+
+        ETH_CHECK(IsSameSection(message.FindSection(MakeIpcTag('N', 'A', 'M', 'E')), binary.GetSection(1)));
+        ETH_CHECK(message.FindSection(MakeIpcTag('M', 'I', 'S', 'S')).m_Data == nullptr);
+
+        if (i == 0)
+            ETH_CHECK(IpcMessage::ReadFrom(*loopback.second).GetJson() == "{ \"command\": \"detach\" }");
+    }
+
+    const IpcMessage empty = IpcMessage::ReadFrom(*loopback.second);
+    ETH_CHECK(empty.GetFormat() == IpcMessageFormat::Binary);
+    ETH_CHECK(empty.GetNumSections() == 0);
+}
+
+ETH_TEST(IpcMessage, OversizeMessagesAreRejectedBeforeTheirPayload)
+{
+    // Neither sends a payload, so reading one would fail with a lost connection instead
+    const uint32_t jsonPrefix = static_cast<uint32_t>(IpcMessage::MaxMessageSize) + 1;
+    std::vector<uint8_t> bytes(sizeof(jsonPrefix));
+    std::memcpy(bytes.data(), &jsonPrefix, sizeof(jsonPrefix));
+    ETH_CHECK(IsRejectedFor(bytes, "exceeds the maximum message size"));
+
+    ETH_CHECK(IsRejectedFor(CreateFrame(0, IpcMessage::MaxMessageSize - sizeof(IpcFrameHeader) + 1, {}), "exceeds the maximum message size"));
+    ETH_CHECK(IsRejectedFor(CreateFrame(0, ~uint64_t(0), {}), "exceeds the maximum message size"));
+}
+
+ETH_TEST(IpcMessage, SectionHeadersOutOfBoundsAreRejected)
+{
+    const std::vector<uint8_t> section = CreateSection(MakeIpcTag('O', 'N', 'E', ' '), 8, 8);
+
+    // One section more than the payload holds
+    ETH_CHECK(IsRejectedFor(CreateFrame(2, section.size(), section), "section header out of bounds"));
+
+    // Part of a section header
+    ETH_CHECK(IsRejectedFor(CreateFrame(1, sizeof(IpcSectionHeader) - 1, std::vector<uint8_t>(section.begin(), section.begin() + sizeof(IpcSectionHeader) - 1)), "section header out of bounds"));
+
+    // Far more sections than could ever fit, which must not be allocated for up front
+    ETH_CHECK(IsRejectedFor(CreateFrame(0xffffffff, section.size(), section), "section header out of bounds"));
+
+    ETH_CHECK(GetReadError(CreateFrame(1, section.size(), section)).empty());
+}
+
+ETH_TEST(IpcMessage, SectionPayloadsOutOfBoundsAreRejected)
+{
+    // Claims more than the rest of the payload
+    std::vector<uint8_t> payload = CreateSection(MakeIpcTag('O', 'N', 'E', ' '), 8, 8);
+    const std::vector<uint8_t> tooLong = CreateSection(MakeIpcTag('T', 'W', 'O', ' '), 9, 8);
+    payload.insert(payload.end(), tooLong.begin(), tooLong.end());
+    ETH_CHECK(IsRejectedFor(CreateFrame(2, payload.size(), payload), "section payload out of bounds"));
+
+    // Would wrap around when added to the offset
+    const std::vector<uint8_t> huge = CreateSection(MakeIpcTag('H', 'U', 'G', 'E'), ~uint64_t(0) - 7, 8);
+    ETH_CHECK(IsRejectedFor(CreateFrame(1, huge.size(), huge), "section payload out of bounds"));
+
+    // The last section may leave out its padding
+    const std::vector<uint8_t> unpadded = CreateSection(MakeIpcTag('O', 'D', 'D', ' '), 5, 5);
+    ETH_CHECK(GetReadError(CreateFrame(1, unpadded.size(), unpadded)).empty());
+}
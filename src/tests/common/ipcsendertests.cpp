@@ -0,0 +1,403 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/ipc/ipcsender.h"
+#include "common/ipc/loopbacktransport.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <thread>
+
+using namespace Ether;
+
+static constexpr uint32_t TestMessageType = MakeIpcTag('T', 'E', 'S', 'T');
+static constexpr uint32_t TestSectionTag = MakeIpcTag('V', 'A', 'L', 'U');
+
+/*
+    Forwards to a loopback endpoint, but can hold the sender thread inside Send(). Whatever is
+    enqueued while it is held ends up in the next batch, which makes the batching deterministic.
+*/
+class GatedTransport : public IpcTransport
+{
+public:
+    GatedTransport(LoopbackTransport& transport)
+        : m_Transport(transport)
+    {
+    }
+
+public:
+    void WaitForConnection() override {}
+    bool HasActiveConnection() const override { return m_Transport.HasActiveConnection(); }
+    void Receive(void* data, size_t numBytes) override { m_Transport.Receive(data, numBytes); }
+    void Close() override { m_Transport.Close(); }
+
+    void Send(const void* data, size_t numBytes) override
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_IsSenderBlocked = m_IsHeld;
+            m_Condition.notify_all();
+            m_Condition.wait(lock, [this]() { return !m_IsHeld; });
+            m_IsSenderBlocked = false;
+
+            if (++m_NumSends > m_MaxNumSends)
+                m_Transport.Close();
+        }
+
+        m_Transport.Send(data, numBytes);
+    }
+
+public:
+    void Hold()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_IsHeld = true;
+    }
+
+    void Release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_IsHeld = false;
+        }
+
+        m_Condition.notify_all();
+    }
+
+    void WaitUntilSenderBlocked()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this]() { return m_IsSenderBlocked; });
+    }
+
+    // The connection is closed right before the write that would exceed this
+    void CloseAfter(uint32_t numSends)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_MaxNumSends = numSends;
+    }
+
+private:
+    LoopbackTransport& m_Transport;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_IsHeld = false;
+    bool m_IsSenderBlocked = false;
+    uint32_t m_NumSends = 0;
+    uint32_t m_MaxNumSends = std::numeric_limits<uint32_t>::max();
+};
+
+static IpcMessage CreateMessage(uint32_t value, size_t numBytes = sizeof(uint32_t))
+{
+    IpcMessage message(TestMessageType, 1);
+    uint8_t* payload = message.AddSection(TestSectionTag, numBytes);
+    std::memset(payload, 0, numBytes);
+    std::memcpy(payload, &value, sizeof(value));
+    return message;
+}
+
+static uint32_t ReadValue(IpcTransport& transport)
+{
+    const IpcMessage message = IpcMessage::ReadFrom(transport);
+    const IpcSection section = message.FindSection(TestSectionTag);
+    ETH_REQUIRE(section.m_Size >= sizeof(uint32_t));
+
+    uint32_t value;
+    std::memcpy(&value, section.m_Data, sizeof(value));
+    return value;
+}
+
+// Holds the sender thread inside the write of a first message, which the receiver should see as ~0u
+static void BlockSender(IpcSender& sender, GatedTransport& transport)
+{
+    transport.Hold();
+    sender.Enqueue(CreateMessage(~0u));
+    transport.WaitUntilSenderBlocked();
+}
+
+ETH_TEST(IpcSender, SmallMessagesShareOneWrite)
+{
+    static constexpr uint32_t NumMessages = 100;
+
+    LoopbackTransport::Pair pair = LoopbackTransport::CreatePair();
+    GatedTransport transport(*pair.first);
+    IpcSender sender;
+    sender.Attach(transport);
+
+    BlockSender(sender, transport);
+    for (uint32_t i = 0; i < NumMessages; ++i)
+        ETH_CHECK(sender.Enqueue(CreateMessage(i)));
+
+    transport.Release();
+    sender.Flush();
+
+    const IpcSenderStats stats = sender.GetStats();
+    ETH_CHECK(stats.m_NumMessagesSent == NumMessages + 1);
+    ETH_CHECK(stats.m_NumWrites == 2);
+    ETH_CHECK(stats.m_NumDropped == 0);
+
+    ETH_CHECK(ReadValue(*pair.second) == ~0u);
+    for (uint32_t i = 0; i < NumMessages; ++i)
+        ETH_REQUIRE(ReadValue(*pair.second) == i);
+}
+
+// Large messages are written on their own, without reordering the small ones around them
+ETH_TEST(IpcSender, LargeMessagesAreWrittenSeparately)
+{
+    LoopbackTransport::Pair pair = LoopbackTransport::CreatePair();
+    GatedTransport transport(*pair.first);
+    IpcSender sender;
+    sender.Attach(transport);
+
+    BlockSender(sender, transport);
+    sender.Enqueue(CreateMessage(0));
+    sender.Enqueue(CreateMessage(1));
+    sender.Enqueue(CreateMessage(2, IpcSender::MaxBatchedMessageSize));
+    sender.Enqueue(CreateMessage(3));
+
+    transport.Release();
+    sender.Flush();
+
+    // The gate, the two messages before the large one, the large one and the last one
+    ETH_CHECK(sender.GetStats().m_NumWrites == 4);
+
+    ETH_CHECK(ReadValue(*pair.second) == ~0u);
+    for (uint32_t i = 0; i < 4; ++i)
+        ETH_CHECK(ReadValue(*pair.second) == i);
+}
+
+ETH_TEST(IpcSender, DropFailsOnceTheQueueIsFull)
+{
+    LoopbackTransport::Pair pair = LoopbackTransport::CreatePair();
+    GatedTransport transport(*pair.first);
+    IpcSender sender;
+    sender.Attach(transport);
+
+    BlockSender(sender, transport);
+    for (uint32_t i = 0; i < IpcSender::QueueCapacity; ++i)
+        ETH_REQUIRE(sender.Enqueue(CreateMessage(i), IpcSendPolicy::Drop));
+
+    ETH_CHECK(!sender.Enqueue(CreateMessage(IpcSender::QueueCapacity), IpcSendPolicy::Drop));
+    ETH_CHECK(!sender.Enqueue(CreateMessage(IpcSender::QueueCapacity + 1), IpcSendPolicy::Drop));
+    ETH_CHECK(sender.GetStats().m_NumDropped == 2);
+
+    transport.Release();
+    sender.Flush();
+
+    const IpcSenderStats stats = sender.GetStats();
+    ETH_CHECK(stats.m_NumMessagesSent == IpcSender::QueueCapacity + 1);
+    ETH_CHECK(stats.m_NumDropped == 2);
+
+    ETH_CHECK(ReadValue(*pair.second) == ~0u);
+    for (uint32_t i = 0; i < IpcSender::QueueCapacity; ++i)
+        ETH_REQUIRE(ReadValue(*pair.second) == i);
+}
+
+ETH_TEST(IpcSender, BlockWaitsForRoomInTheQueue)
+{
+    LoopbackTransport::Pair pair = LoopbackTransport::CreatePair();
+    GatedTransport transport(*pair.first);
+    IpcSender sender;
+    sender.Attach(transport);
+
+    BlockSender(sender, transport);
+    for (uint32_t i = 0; i < IpcSender::QueueCapacity; ++i)
+        ETH_REQUIRE(sender.Enqueue(CreateMessage(i)));
+
+    std::future<bool> blocked = std::async(std::launch::async, [&sender]()
+    {
+        return sender.Enqueue(CreateMessage(IpcSender::QueueCapacity));
+    });
+
+    ETH_CHECK(blocked.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+
+    transport.Release();
+    ETH_CHECK(blocked.get());
+    sender.Flush();
+
+    ETH_CHECK(sender.GetStats().m_NumDropped == 0);
+
+    ETH_CHECK(ReadValue(*pair.second) == ~0u);
+    for (uint32_t i = 0; i <= IpcSender::QueueCapacity; ++i)
+        ETH_REQUIRE(ReadValue(*pair.second) == i);
+}
+
+ETH_TEST(IpcSender, CoalesceKeepsTheNewestMessagePerKey)
+{
+    static constexpr uint32_t NumUpdates = 10;
+
+    LoopbackTransport::Pair pair = LoopbackTransport::CreatePair();
+    GatedTransport transport(*pair.first);
+    IpcSender sender;
+    sender.Attach(transport);
+
+    // Key 1 gets 100..109, key 2 gets 200..209, with messages that have to arrive in between
+    BlockSender(sender, transport);
+    for (uint32_t i = 0; i < NumUpdates; ++i)
+    {
+        sender.Enqueue(CreateMessage(100 + i), IpcSendPolicy::Coalesce, 1);
+        sender.Enqueue(CreateMessage(200 + i), IpcSendPolicy::Coalesce, 2);
+        sender.Enqueue(CreateMessage(i));
+    }
+
+    transport.Release();
+    sender.Flush();
+
+    const IpcSenderStats stats = sender.GetStats();
+    ETH_CHECK(stats.m_NumMessagesSent == NumUpdates + 3);
+    ETH_CHECK(stats.m_NumCoalesced == 2 * (NumUpdates - 1));
+
+    // Each surviving update goes out where it was enqueued
+    ETH_CHECK(ReadValue(*pair.second) == ~0u);
+    for (uint32_t i = 0; i < NumUpdates - 1; ++i)
+        ETH_REQUIRE(ReadValue(*pair.second) == i);
+
+    ETH_CHECK(ReadValue(*pair.second) == 100 + NumUpdates - 1);
+    ETH_CHECK(ReadValue(*pair.second) == 200 + NumUpdates - 1);
+    ETH_CHECK(ReadValue(*pair.second) == NumUpdates - 1);
+}
+
+// Coalesced messages are never dropped. They wait outside the full queue and go out after it.
+ETH_TEST(IpcSender, CoalesceParksMessagesWhileTheQueueIsFull)
+{
+    LoopbackTransport::Pair pair = LoopbackTransport::CreatePair();
+    GatedTransport transport(*pair.first);
+    IpcSender sender;
+    sender.Attach(transport);
+
+    BlockSender(sender, transport);
+    for (uint32_t i = 0; i < IpcSender::QueueCapacity; ++i)
+        ETH_REQUIRE(sender.Enqueue(CreateMessage(i), IpcSendPolicy::Drop));
+
+    for (uint32_t i = 0; i < 5; ++i)
+        ETH_CHECK(sender.Enqueue(CreateMessage(5000 + i), IpcSendPolicy::Coalesce, 7));
+
+    ETH_CHECK(sender.GetStats().m_NumCoalesced == 4);
+
+    transport.Release();
+    sender.Flush();
+
+    const IpcSenderStats stats = sender.GetStats();
+    ETH_CHECK(stats.m_NumMessagesSent == IpcSender::QueueCapacity + 2);
+    ETH_CHECK(stats.m_NumDropped == 0);
+
+    ETH_CHECK(ReadValue(*pair.second) == ~0u);
+    for (uint32_t i = 0; i < IpcSender::QueueCapacity; ++i)
+        ETH_REQUIRE(ReadValue(*pair.second) == i);
+
+    ETH_CHECK(ReadValue(*pair.second) == 5004);
+}
+
+ETH_TEST(IpcSender, FlushWaitsForEveryProducer)
+{
+    static constexpr uint32_t NumThreads = 4;
+    static constexpr uint32_t NumMessagesPerThread = 5000;
+
+    LoopbackTransport::Pair pair = LoopbackTransport::CreatePair();
+    IpcSender sender;
+    sender.Attach(*pair.first);
+
+    std::vector<std::thread> producers;
+    for (uint32_t t = 0; t < NumThreads; ++t)
+    {
+        producers.emplace_back([&sender, t]()
+        {
+            for (uint32_t i = 0; i < NumMessagesPerThread; ++i)
+                sender.Enqueue(CreateMessage(t * NumMessagesPerThread + i));
+        });
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+
+    sender.Flush();
+
+    const IpcSenderStats stats = sender.GetStats();
+    ETH_CHECK(stats.m_NumMessagesSent == NumThreads * NumMessagesPerThread);
+    ETH_CHECK(stats.m_NumWrites < stats.m_NumMessagesSent);
+
+    // Everything is already in the loopback buffer, and each producer's messages are in order
+    std::vector<uint32_t> nextValues(NumThreads);
+    for (uint32_t t = 0; t < NumThreads; ++t)
+        nextValues[t] = t * NumMessagesPerThread;
+
+    for (uint32_t i = 0; i < NumThreads * NumMessagesPerThread; ++i)
+    {
+        const uint32_t value = ReadValue(*pair.second);
+        ETH_REQUIRE(value < NumThreads * NumMessagesPerThread);
+        ETH_REQUIRE(value == nextValues[value / NumMessagesPerThread]++);
+    }
+
+    sender.Detach();
+}
+
+ETH_TEST(IpcSender, CloseDuringABatchDropsTheRest)
+{
+    LoopbackTransport::Pair pair = LoopbackTransport::CreatePair();
+    GatedTransport transport(*pair.first);
+    IpcSender sender;
+    sender.Attach(transport);
+
+    BlockSender(sender, transport);
+    for (uint32_t i = 0; i < 3; ++i)
+        sender.Enqueue(CreateMessage(i));
+
+    sender.Enqueue(CreateMessage(3, IpcSender::MaxBatchedMessageSize));
+
+    for (uint32_t i = 4; i < 7; ++i)
+        sender.Enqueue(CreateMessage(i));
+
+    // The gate and the first three messages get through, the connection is gone for the large one
+    transport.CloseAfter(2);
+    transport.Release();
+    sender.Flush();
+
+    IpcSenderStats stats = sender.GetStats();
+    ETH_CHECK(stats.m_NumMessagesSent == 4);
+    ETH_CHECK(stats.m_NumWrites == 2);
+    ETH_CHECK(stats.m_NumDropped == 4);
+
+    // Nothing is written anymore until the sender is attached again
+    sender.Enqueue(CreateMessage(7));
+    sender.Flush();
+    stats = sender.GetStats();
+    ETH_CHECK(stats.m_NumMessagesSent == 4);
+    ETH_CHECK(stats.m_NumDropped == 5);
+
+    ETH_CHECK(ReadValue(*pair.second) == ~0u);
+    for (uint32_t i = 0; i < 3; ++i)
+        ETH_CHECK(ReadValue(*pair.second) == i);
+
+    bool hasThrown = false;
+    try
+    {
+        IpcMessage::ReadFrom(*pair.second);
+    }
+    catch (const std::runtime_error&)
+    {
+        hasThrown = true;
+    }
+
+    ETH_CHECK(hasThrown);
+}
@@ -0,0 +1,115 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/logging/loggingmanager.h"
+
+#include <thread>
+
+using namespace Ether;
+
+// Without Initialize() there is no writer thread, so records are only written by Flush()
+static LoggingManager& CreateLoggingManager()
+{
+    if (LoggingManager::HasInstance())
+        LoggingManager::Reset();
+
+    return LoggingManager::Instance();
+}
+
+ETH_TEST(LoggingManager, DeferredRecordsAreFormattedOnRead)
+{
+    LoggingManager& logger = CreateLoggingManager();
+    logger.LogDeferred(LogLevel::Warning, LogType::Engine, "%s has %d items (%.2f)", "Inventory", 42, 1.5);
+    logger.Flush();
+
+    const std::vector<LogEntry> entries = logger.GetRecentEntries();
+    ETH_REQUIRE(entries.size() == 1);
+    ETH_CHECK_MSG(entries[0].m_Text == "Inventory has 42 items (1.50)", "Formatted as '{}'", entries[0].m_Text);
+    ETH_CHECK(entries[0].m_Level == LogLevel::Warning);
+    ETH_CHECK(entries[0].m_Type == LogType::Engine);
+
+    LoggingManager::Reset();
+}
+
+ETH_TEST(LoggingManager, TextRecordsAreSplitIntoLines)
+{
+    LoggingManager& logger = CreateLoggingManager();
+    logger.Log(LogLevel::Info, LogType::None, "first %d\nsecond", 1);
+    logger.Flush();
+
+    const std::vector<LogEntry> entries = logger.GetRecentEntries();
+    ETH_REQUIRE(entries.size() == 2);
+    ETH_CHECK(entries[0].m_Text == "first 1");
+    ETH_CHECK(entries[1].m_Text == "second");
+
+    LoggingManager::Reset();
+}
+
+ETH_TEST(LoggingManager, RecentEntriesKeepTheNewestRecords)
+{
+    static constexpr uint32_t NumRecords = 20000;
+
+    LoggingManager& logger = CreateLoggingManager();
+    for (uint32_t i = 0; i < NumRecords; ++i)
+        logger.LogDeferred(LogLevel::Info, LogType::None, "record %u", i);
+    logger.Flush();
+
+    // Far more than fit, so the oldest have to have been dropped, and the rest has to be contiguous
+    const std::vector<LogEntry> entries = logger.GetRecentEntries();
+    ETH_REQUIRE(!entries.empty());
+    ETH_CHECK(entries.size() < NumRecords);
+
+    const uint32_t first = NumRecords - static_cast<uint32_t>(entries.size());
+    for (uint32_t i = 0; i < entries.size(); ++i)
+        ETH_REQUIRE(entries[i].m_Text == std::format("record {}", first + i));
+
+    LoggingManager::Reset();
+}
+
+ETH_TEST(LoggingManager, ConcurrentProducersLoseNothing)
+{
+    static constexpr uint32_t NumThreads = 4;
+    static constexpr uint32_t NumRecordsPerThread = 5000;
+
+    LoggingManager& logger = CreateLoggingManager();
+    std::vector<std::thread> threads;
+
+    // Rings that fill up are flushed by their own producer, since there is no writer thread
+    for (uint32_t t = 0; t < NumThreads; ++t)
+    {
+        threads.emplace_back([&logger, t]()
+        {
+            for (uint32_t i = 0; i < NumRecordsPerThread; ++i)
+                logger.LogDeferred(LogLevel::Info, LogType::None, "thread %u record %u", t, i);
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    logger.Flush();
+    ETH_CHECK_MSG(
+        logger.GetNumRecordsWritten() == NumThreads * NumRecordsPerThread,
+        "{} of {} records written",
+        logger.GetNumRecordsWritten(),
+        NumThreads * NumRecordsPerThread);
+
+    LoggingManager::Reset();
+}
@@ -0,0 +1,221 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/stream/lzcodec.h"
+
+#include <cstring>
+#include <random>
+
+using namespace Ether;
+
+// Worst case of the block format: one token and a length byte per 255 literals
+static size_t GetMaxCompressedSize(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+static std::vector<uint8_t> Compress(const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> compressed(GetMaxCompressedSize(data.size()));
+    const size_t compressedSize = LzCodec::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+    compressed.resize(compressedSize);
+    return compressed;
+}
+
+static bool RoundTrips(const std::vector<uint8_t>& data)
+{
+    const std::vector<uint8_t> compressed = Compress(data);
+    if (compressed.empty())
+        return false;
+
+    std::vector<uint8_t> decompressed(data.size());
+    return LzCodec::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()) && decompressed == data;
+}
+
+static std::vector<uint8_t> CreateRandomBytes(size_t size, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::vector<uint8_t> data(size);
+    for (uint8_t& byte : data)
+        byte = static_cast<uint8_t>(random());
+
+    return data;
+}
+
+// Words from a small vocabulary, which compresses about as well as serialized resources do
+static std::vector<uint8_t> CreateCompressibleBytes(size_t size, uint32_t seed)
+{
+    static const char* words[] = { "mesh", "texture", "material", "vertex", "index", "normal", "albedo", "roughness" };
+
+    std::mt19937 random(seed);
+    std::vector<uint8_t> data;
+    while (data.size() < size)
+    {
+        const char* word = words[random() % std::size(words)];
+        data.insert(data.end(), word, word + std::strlen(word));
+        data.push_back(static_cast<uint8_t>(random() % 4));
+    }
+
+    data.resize(size);
+    return data;
+}
+
+ETH_TEST(LzCodec, EmptyInputRoundTrips)
+{
+    uint8_t compressed[16];
+    const size_t compressedSize = LzCodec::Compress(nullptr, 0, compressed, sizeof(compressed));
+    ETH_REQUIRE(compressedSize == 1);
+
+    uint8_t decompressed[1];
+    ETH_CHECK(LzCodec::Decompress(compressed, compressedSize, decompressed, 0));
+    ETH_CHECK(!LzCodec::Decompress(compressed, compressedSize, decompressed, 1));
+
+    // Nothing at all is not a valid block for anything but empty data either
+    ETH_CHECK(LzCodec::Decompress(compressed, 0, decompressed, 0));
+    ETH_CHECK(!LzCodec::Decompress(compressed, 0, decompressed, 1));
+}
+
+// Sizes around the limits of where the block format allows matches
+ETH_TEST(LzCodec, SmallInputsRoundTrip)
+{
+    for (size_t size = 1; size < 300; ++size)
+    {
+        ETH_CHECK_MSG(RoundTrips(CreateCompressibleBytes(size, static_cast<uint32_t>(size))), "{} compressible bytes", size);
+        ETH_CHECK_MSG(RoundTrips(CreateRandomBytes(size, static_cast<uint32_t>(size))), "{} random bytes", size);
+        ETH_CHECK_MSG(RoundTrips(std::vector<uint8_t>(size, 0x5a)), "{} equal bytes", size);
+    }
+}
+
+ETH_TEST(LzCodec, IncompressibleDataRoundTrips)
+{
+    const std::vector<uint8_t> data = CreateRandomBytes(256 * 1024, 1);
+
+    // Does not get smaller, which is how the pack writer decides to store entries as they are
+    std::vector<uint8_t> compressed(data.size() - 1);
+    ETH_CHECK(LzCodec::Compress(data.data(), data.size(), compressed.data(), compressed.size()) == 0);
+
+    ETH_CHECK(RoundTrips(data));
+    ETH_CHECK(Compress(data).size() <= GetMaxCompressedSize(data.size()));
+}
+
+ETH_TEST(LzCodec, CompressibleDataGetsSmaller)
+{
+    const std::vector<uint8_t> data = CreateCompressibleBytes(1024 * 1024, 2);
+    ETH_CHECK(Compress(data).size() < data.size() / 2);
+    ETH_CHECK(RoundTrips(data));
+}
+
+// Matches far longer than the 15 + 255 that a token and one length byte can encode
+ETH_TEST(LzCodec, LongMatchesRoundTrip)
+{
+    std::vector<uint8_t> data = CreateRandomBytes(100, 3);
+    data.resize(data.size() + 100000, 0);
+    const std::vector<uint8_t> tail = CreateRandomBytes(1000, 4);
+    data.insert(data.end(), tail.begin(), tail.end());
+
+    // Repeats the random bytes with the full window between them
+    data.insert(data.end(), data.end() - 65000, data.end() - 64000);
+
+    const std::vector<uint8_t> compressed = Compress(data);
+    ETH_CHECK(compressed.size() < 3000);
+    ETH_CHECK(RoundTrips(data));
+}
+
+// Offsets shorter than the match repeat the bytes that the match itself produces
+ETH_TEST(LzCodec, OverlappingCopiesRoundTrip)
+{
+    for (size_t period = 1; period <= 17; ++period)
+    {
+        std::vector<uint8_t> data = CreateRandomBytes(period, static_cast<uint32_t>(period));
+        while (data.size() < 5000)
+            data.push_back(data[data.size() - period]);
+
+        ETH_CHECK(Compress(data).size() < 200);
+        ETH_CHECK_MSG(RoundTrips(data), "Period {}", period);
+    }
+
+    // Written by hand: one literal, repeated 20 more times at offset 1, and 5 literals to end the block
+    const uint8_t block[] = { 0x1f, 'a', 0x01, 0x00, 0x01, 0x50, 'b', 'b', 'b', 'b', 'b' };
+    std::vector<uint8_t> decompressed(26);
+    ETH_REQUIRE(LzCodec::Decompress(block, sizeof(block), decompressed.data(), decompressed.size()));
+    ETH_CHECK(std::string(decompressed.begin(), decompressed.end()) == std::string(21, 'a') + "bbbbb");
+}
+
+ETH_TEST(LzCodec, TruncatedBlocksFail)
+{
+    const std::vector<uint8_t> data = CreateCompressibleBytes(20000, 5);
+    const std::vector<uint8_t> compressed = Compress(data);
+    std::vector<uint8_t> decompressed(data.size());
+
+    for (size_t size = 0; size < compressed.size(); ++size)
+    {
+        // Copied, so that reading past the end is caught by the sanitizers
+        const std::vector<uint8_t> truncated(compressed.begin(), compressed.begin() + size);
+        ETH_REQUIRE(!LzCodec::Decompress(truncated.data(), truncated.size(), decompressed.data(), decompressed.size()));
+    }
+}
+
+ETH_TEST(LzCodec, WrongSizesFail)
+{
+    const std::vector<uint8_t> data = CreateCompressibleBytes(20000, 6);
+    const std::vector<uint8_t> compressed = Compress(data);
+
+    std::vector<uint8_t> tooSmall(data.size() - 1);
+    ETH_CHECK(!LzCodec::Decompress(compressed.data(), compressed.size(), tooSmall.data(), tooSmall.size()));
+
+    std::vector<uint8_t> tooLarge(data.size() + 1);
+    ETH_CHECK(!LzCodec::Decompress(compressed.data(), compressed.size(), tooLarge.data(), tooLarge.size()));
+}
+
+ETH_TEST(LzCodec, CorruptedBlocksFail)
+{
+    uint8_t decompressed[64];
+
+    // Offset 0, and offsets that reach back before the start of the data
+    const uint8_t zeroOffset[] = { 0x10, 'a', 0x00, 0x00, 0x50, 'b', 'b', 'b', 'b', 'b' };
+    const uint8_t farOffset[] = { 0x10, 'a', 0x02, 0x00, 0x50, 'b', 'b', 'b', 'b', 'b' };
+    ETH_CHECK(!LzCodec::Decompress(zeroOffset, sizeof(zeroOffset), decompressed, 10));
+    ETH_CHECK(!LzCodec::Decompress(farOffset, sizeof(farOffset), decompressed, 10));
+
+    // A match or literal run that is longer than the output
+    const uint8_t longMatch[] = { 0x1f, 'a', 0x01, 0x00, 0xff, 0xff, 0x10, 0x50, 'b', 'b', 'b', 'b', 'b' };
+    const uint8_t longLiterals[] = { 0xf0, 0xff, 0x10, 'a' };
+    ETH_CHECK(!LzCodec::Decompress(longMatch, sizeof(longMatch), decompressed, sizeof(decompressed)));
+    ETH_CHECK(!LzCodec::Decompress(longLiterals, sizeof(longLiterals), decompressed, sizeof(decompressed)));
+
+    // A length that continues past the end of the block
+    const uint8_t openLength[] = { 0xf0, 0xff, 0xff };
+    ETH_CHECK(!LzCodec::Decompress(openLength, sizeof(openLength), decompressed, sizeof(decompressed)));
+
+    // Random damage must never read or write out of bounds, whatever the result
+    const std::vector<uint8_t> data = CreateCompressibleBytes(4096, 7);
+    const std::vector<uint8_t> compressed = Compress(data);
+    std::vector<uint8_t> output(data.size());
+    std::mt19937 random(8);
+
+    for (uint32_t i = 0; i < 2000; ++i)
+    {
+        std::vector<uint8_t> damaged = compressed;
+        for (uint32_t j = 0; j < 1 + i % 4; ++j)
+            damaged[random() % damaged.size()] ^= static_cast<uint8_t>(1 + random() % 255);
+
+        LzCodec::Decompress(damaged.data(), damaged.size(), output.data(), output.size());
+    }
+}
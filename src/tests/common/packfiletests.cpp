@@ -0,0 +1,307 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/stream/packfile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace Ether;
+
+static std::string GetTestFilePath()
+{
+    return (std::filesystem::temp_directory_path() / "ether_packfile_tests.epak").string();
+}
+
+static std::vector<uint8_t> CreatePayload(size_t size, uint32_t seed, bool isCompressible)
+{
+    std::mt19937 random(seed);
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; ++i)
+        payload[i] = isCompressible ? static_cast<uint8_t>((i / 64) % 7) : static_cast<uint8_t>(random());
+
+    return payload;
+}
+
+static bool ReadsBack(PackFileReader& reader, const std::string& guid, const std::vector<uint8_t>& payload)
+{
+    const PackEntryDesc* entry = reader.Find(guid);
+    if (entry == nullptr || entry->m_Size != payload.size())
+        return false;
+
+    std::unique_ptr<IByteStream> istream = reader.Read(*entry);
+    return payload.empty() || std::memcmp(istream->GetData(), payload.data(), payload.size()) == 0;
+}
+
+static bool IsRejected(const std::string& path)
+{
+    try
+    {
+        PackFileReader reader(path);
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+/*
+    Writes a pack with a hand-made index, in the same layout as PackFileWriter does, so that the
+    index can be damaged in ways the writer never would. Payloads are left zero filled.
+*/
+static void WritePack(const std::string& path, const std::vector<PackEntryDesc>& entries, uint64_t payloadSize)
+{
+    OFileStream file(path);
+
+    const std::vector<char> payloads(payloadSize, 0);
+    file.WriteBytes(payloads.data(), static_cast<uint32_t>(payloads.size()));
+
+    file << PackFileVersion;
+    file << static_cast<uint32_t>(entries.size());
+    for (const PackEntryDesc& entry : entries)
+    {
+        file << entry.m_Guid;
+        file << entry.m_ClassID;
+        file << static_cast<uint32_t>(entry.m_Compression);
+        file << static_cast<uint32_t>(entry.m_Offset & 0xffffffff);
+        file << static_cast<uint32_t>(entry.m_Offset >> 32);
+        file << entry.m_StoredSize;
+        file << entry.m_Size;
+    }
+
+    file << static_cast<uint32_t>(payloadSize & 0xffffffff);
+    file << static_cast<uint32_t>(payloadSize >> 32);
+    file << PackFileMagic;
+}
+
+// Overwrites part of a file that was written already
+static void Patch(const std::string& path, size_t offset, const void* data, size_t size)
+{
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(offset);
+    file.write(static_cast<const char*>(data), size);
+}
+
+ETH_TEST(PackFile, EntriesReadBack)
+{
+    const std::vector<uint8_t> compressible = CreatePayload(10000, 1, true);
+    const std::vector<uint8_t> incompressible = CreatePayload(5000, 2, false);
+    const std::vector<uint8_t> empty;
+
+    {
+        PackFileWriter writer(GetTestFilePath());
+        writer.AddEntry("b", "Mesh", compressible.data(), static_cast<uint32_t>(compressible.size()), PackCompression::Lz);
+        writer.AddEntry("a", "Texture", incompressible.data(), static_cast<uint32_t>(incompressible.size()), PackCompression::Lz);
+        writer.AddEntry("d", "Mesh", empty.data(), 0, PackCompression::Lz);
+        writer.AddEntry("c", "Mesh", compressible.data(), static_cast<uint32_t>(compressible.size()), PackCompression::None);
+        writer.Finalize();
+    }
+
+    PackFileReader reader(GetTestFilePath());
+    ETH_REQUIRE(reader.GetEntries().size() == 4);
+
+    // Only the entry that gets smaller is compressed
+    ETH_CHECK(reader.Find("a")->m_Compression == PackCompression::None);
+    ETH_CHECK(reader.Find("b")->m_Compression == PackCompression::Lz);
+    ETH_CHECK(reader.Find("b")->m_StoredSize < compressible.size());
+    ETH_CHECK(reader.Find("b")->m_ClassID == "Mesh");
+    ETH_CHECK(reader.Find("c")->m_Compression == PackCompression::None);
+    ETH_CHECK(reader.Find("e") == nullptr);
+
+    for (const PackEntryDesc& entry : reader.GetEntries())
+        ETH_CHECK(entry.m_Offset % PackFileAlignment == 0);
+
+    ETH_CHECK(ReadsBack(reader, "a", incompressible));
+    ETH_CHECK(ReadsBack(reader, "b", compressible));
+    ETH_CHECK(ReadsBack(reader, "c", compressible));
+    ETH_CHECK(ReadsBack(reader, "d", empty));
+}
+
+ETH_TEST(PackFile, DuplicateGuidsAreNotWritten)
+{
+    const std::vector<uint8_t> payload = CreatePayload(100, 3, true);
+
+    bool hasThrown = false;
+    try
+    {
+        PackFileWriter writer(GetTestFilePath());
+        writer.AddEntry("a", "Mesh", payload.data(), static_cast<uint32_t>(payload.size()), PackCompression::None);
+        writer.AddEntry("a", "Mesh", payload.data(), static_cast<uint32_t>(payload.size()), PackCompression::None);
+        writer.Finalize();
+    }
+    catch (const std::runtime_error&)
+    {
+        hasThrown = true;
+    }
+
+    ETH_CHECK(hasThrown);
+}
+
+ETH_TEST(PackFile, DamagedFootersAreRejected)
+{
+    const std::string path = GetTestFilePath();
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, 16, 16 } }, PackFileAlignment);
+    ETH_REQUIRE(!IsRejected(path));
+
+    const size_t fileSize = std::filesystem::file_size(path);
+
+    // Magic
+    const uint32_t badMagic = 0x12345678;
+    Patch(path, fileSize - sizeof(uint32_t), &badMagic, sizeof(badMagic));
+    ETH_CHECK(IsRejected(path));
+
+    // Index offset past the end of the file
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, 16, 16 } }, PackFileAlignment);
+    const uint32_t badOffset = static_cast<uint32_t>(fileSize);
+    Patch(path, fileSize - 3 * sizeof(uint32_t), &badOffset, sizeof(badOffset));
+    ETH_CHECK(IsRejected(path));
+
+    // Too small to hold a footer at all
+    std::filesystem::resize_file(path, 8);
+    ETH_CHECK(IsRejected(path));
+
+    // Not a pack to begin with
+    std::filesystem::remove(path);
+    ETH_CHECK(IsRejected(path));
+}
+
+ETH_TEST(PackFile, DamagedIndicesAreRejected)
+{
+    const std::string path = GetTestFilePath();
+
+    // Truncated in the middle of an entry, by claiming one more entry than there is
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, 16, 16 } }, PackFileAlignment);
+    const uint32_t numEntries = 2;
+    Patch(path, PackFileAlignment + sizeof(uint32_t), &numEntries, sizeof(numEntries));
+    ETH_CHECK(IsRejected(path));
+
+    // More entries than the index has room for, which must fail before they are allocated
+    const uint32_t hugeNumEntries = 0xffffffff;
+    Patch(path, PackFileAlignment + sizeof(uint32_t), &hugeNumEntries, sizeof(hugeNumEntries));
+    ETH_CHECK(IsRejected(path));
+
+    // Unknown version
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, 16, 16 } }, PackFileAlignment);
+    const uint32_t badVersion = PackFileVersion + 1;
+    Patch(path, PackFileAlignment, &badVersion, sizeof(badVersion));
+    ETH_CHECK(IsRejected(path));
+
+    // Not sorted by guid, or the same guid twice
+    WritePack(path, { { "b", "Mesh", PackCompression::None, 0, 16, 16 }, { "a", "Mesh", PackCompression::None, PackFileAlignment, 16, 16 } }, 2 * PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, 16, 16 }, { "a", "Mesh", PackCompression::None, PackFileAlignment, 16, 16 } }, 2 * PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+
+    // Unknown compression, and stored entries whose sizes disagree
+    WritePack(path, { { "a", "Mesh", static_cast<PackCompression>(7), 0, 16, 16 } }, PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, 16, 32 } }, PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+}
+
+ETH_TEST(PackFile, EntriesOutOfRangeAreRejected)
+{
+    const std::string path = GetTestFilePath();
+
+    // Reaching into the index
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, PackFileAlignment + 1, PackFileAlignment + 1 } }, PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+
+    // Starting past the index, and wrapping around the end of the address space
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 2 * PackFileAlignment, 16, 16 } }, PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+    WritePack(path, { { "a", "Mesh", PackCompression::Lz, ~uint64_t(0) - PackFileAlignment + 1, PackFileAlignment, 16 } }, PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+
+    // Exactly up to the index is fine
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, PackFileAlignment, PackFileAlignment } }, PackFileAlignment);
+    ETH_CHECK(!IsRejected(path));
+}
+
+ETH_TEST(PackFile, MisalignedEntriesAreRejected)
+{
+    const std::string path = GetTestFilePath();
+
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 8, 16, 16 } }, PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, 16, 16 }, { "b", "Mesh", PackCompression::None, PackFileAlignment + 1, 16, 16 } }, 2 * PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+}
+
+ETH_TEST(PackFile, OverlappingEntriesAreRejected)
+{
+    const std::string path = GetTestFilePath();
+
+    // The same payload twice
+    WritePack(path, { { "a", "Mesh", PackCompression::None, 0, 16, 16 }, { "b", "Mesh", PackCompression::None, 0, 16, 16 } }, PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+
+    // Running into the next payload, with the index in a different order than the payloads
+    WritePack(
+        path,
+        { { "a", "Mesh", PackCompression::None, PackFileAlignment, 16, 16 }, { "b", "Mesh", PackCompression::Lz, 0, PackFileAlignment + 1, 64 } },
+        2 * PackFileAlignment);
+    ETH_CHECK(IsRejected(path));
+
+    // Empty entries take up no room, and may start where the next one does
+    WritePack(
+        path,
+        { { "a", "Mesh", PackCompression::None, 0, 16, 16 }, { "b", "Mesh", PackCompression::None, 0, 0, 0 }, { "c", "Mesh", PackCompression::None, PackFileAlignment, 0, 0 } },
+        PackFileAlignment);
+    ETH_CHECK(!IsRejected(path));
+}
+
+ETH_TEST(PackFile, CorruptedPayloadsFailToRead)
+{
+    const std::string path = GetTestFilePath();
+    const std::vector<uint8_t> payload = CreatePayload(10000, 4, true);
+
+    {
+        PackFileWriter writer(path);
+        writer.AddEntry("a", "Mesh", payload.data(), static_cast<uint32_t>(payload.size()), PackCompression::Lz);
+        writer.Finalize();
+    }
+
+    // Claims to decompress to more than it does
+    PackEntryDesc entry = *PackFileReader(path).Find("a");
+    ETH_REQUIRE(entry.m_Compression == PackCompression::Lz);
+
+    const uint8_t garbage[] = { 0xf0, 0xff, 0xff, 0xff };
+    Patch(path, entry.m_Offset, garbage, sizeof(garbage));
+
+    PackFileReader reader(path);
+    bool hasThrown = false;
+    try
+    {
+        reader.Read(*reader.Find("a"));
+    }
+    catch (const std::runtime_error&)
+    {
+        hasThrown = true;
+    }
+
+    ETH_CHECK(hasThrown);
+    std::filesystem::remove(path);
+}
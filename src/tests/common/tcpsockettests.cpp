@@ -0,0 +1,190 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/ipc/ipcmessage.h"
+#include "common/ipc/tcpsocket.h"
+
+#include <cstring>
+#include <future>
+#include <thread>
+
+using namespace Ether;
+
+static constexpr uint32_t TestMessageType = MakeIpcTag('T', 'E', 'S', 'T');
+static constexpr uint32_t TestSectionTag = MakeIpcTag('D', 'A', 'T', 'A');
+
+// Connects a client to the listener through localhost
+static std::unique_ptr<TcpSocket> ConnectLoopback(TcpSocket& listener)
+{
+    std::future<std::unique_ptr<TcpSocket>> client = std::async(std::launch::async, [&listener]()
+    {
+        return TcpSocket::Connect("127.0.0.1", listener.GetPort());
+    });
+
+    listener.WaitForConnection();
+    return client.get();
+}
+
+static std::vector<uint8_t> CreatePattern(size_t numBytes, uint32_t seed)
+{
+    std::vector<uint8_t> bytes(numBytes);
+    for (size_t i = 0; i < numBytes; ++i)
+        bytes[i] = static_cast<uint8_t>((i * 31 + seed) ^ (i >> 8));
+
+    return bytes;
+}
+
+static IpcMessage CreateBinaryMessage(size_t numBytes, uint32_t seed)
+{
+    const std::vector<uint8_t> payload = CreatePattern(numBytes, seed);
+    IpcMessage message(TestMessageType, 1);
+    message.AddSection(TestSectionTag, payload.data(), payload.size());
+    return message;
+}
+
+static bool HasPayload(const IpcMessage& message, size_t numBytes, uint32_t seed)
+{
+    const IpcSection section = message.FindSection(TestSectionTag);
+    const std::vector<uint8_t> expected = CreatePattern(numBytes, seed);
+    return section.m_Size == numBytes && std::memcmp(section.m_Data, expected.data(), numBytes) == 0;
+}
+
+ETH_TEST(TcpSocket, SendBeforeConnectionThrows)
+{
+    TcpSocket listener(0);
+    ETH_CHECK(!listener.HasActiveConnection());
+
+    bool hasThrown = false;
+    try
+    {
+        const uint32_t value = 0;
+        listener.Send(&value, sizeof(value));
+    }
+    catch (const std::runtime_error&)
+    {
+        hasThrown = true;
+    }
+
+    ETH_CHECK(hasThrown);
+}
+
+// Far larger than the socket buffers, so both sides only ever get part of it per call
+ETH_TEST(TcpSocket, LargeTransfersSurvivePartialSends)
+{
+    static constexpr size_t NumBytes = 16 * 1024 * 1024;
+
+    TcpSocket listener(0);
+    std::unique_ptr<TcpSocket> client = ConnectLoopback(listener);
+    ETH_REQUIRE(client->HasActiveConnection() && listener.HasActiveConnection());
+
+    const std::vector<uint8_t> sent = CreatePattern(NumBytes, 7);
+    std::thread sender([&client, &sent]() { client->Send(sent.data(), sent.size()); });
+
+    std::vector<uint8_t> received(NumBytes);
+    listener.Receive(received.data(), received.size());
+    sender.join();
+
+    ETH_CHECK(received == sent);
+}
+
+// The frame and section headers arrive in separate reads, split at every possible byte
+ETH_TEST(TcpSocket, MessagesAreReassembledFromSplitWrites)
+{
+    TcpSocket listener(0);
+    std::unique_ptr<TcpSocket> client = ConnectLoopback(listener);
+
+    const IpcMessage binaryMessage = CreateBinaryMessage(37, 3);
+    const IpcMessage jsonMessage = IpcMessage::FromJson("{\"command\":\"Ping\"}");
+
+    std::thread sender([&client, &binaryMessage, &jsonMessage]()
+    {
+        for (const IpcMessage* message : { &binaryMessage, &jsonMessage })
+            for (size_t i = 0; i < message->GetSizeInBytes(); ++i)
+                client->Send(message->GetData() + i, 1);
+    });
+
+    const IpcMessage receivedBinary = IpcMessage::ReadFrom(listener);
+    const IpcMessage receivedJson = IpcMessage::ReadFrom(listener);
+    sender.join();
+
+    ETH_CHECK(receivedBinary.GetFormat() == IpcMessageFormat::Binary);
+    ETH_CHECK(receivedBinary.GetMessageType() == TestMessageType);
+    ETH_CHECK(receivedBinary.GetNumSections() == 1);
+    ETH_CHECK(HasPayload(receivedBinary, 37, 3));
+
+    ETH_CHECK(receivedJson.GetFormat() == IpcMessageFormat::Json);
+    ETH_CHECK(receivedJson.GetJson() == "{\"command\":\"Ping\"}");
+}
+
+// Several messages in a single write have to be told apart by their framing alone
+ETH_TEST(TcpSocket, BackToBackMessagesKeepTheirFraming)
+{
+    static constexpr uint32_t NumMessages = 64;
+
+    TcpSocket listener(0);
+    std::unique_ptr<TcpSocket> client = ConnectLoopback(listener);
+
+    std::vector<uint8_t> stream;
+    for (uint32_t i = 0; i < NumMessages; ++i)
+    {
+        const IpcMessage message = CreateBinaryMessage(1 + i * 13, i);
+        stream.insert(stream.end(), message.GetData(), message.GetData() + message.GetSizeInBytes());
+    }
+
+    client->Send(stream.data(), stream.size());
+
+    for (uint32_t i = 0; i < NumMessages; ++i)
+    {
+        const IpcMessage message = IpcMessage::ReadFrom(listener);
+        ETH_REQUIRE(HasPayload(message, 1 + i * 13, i));
+    }
+}
+
+ETH_TEST(TcpSocket, ListenerAcceptsAgainAfterPeerCloses)
+{
+    TcpSocket listener(0);
+    std::unique_ptr<TcpSocket> client = ConnectLoopback(listener);
+    client->Close();
+    ETH_CHECK(!client->HasActiveConnection());
+
+    bool hasThrown = false;
+    try
+    {
+        uint32_t value;
+        listener.Receive(&value, sizeof(value));
+    }
+    catch (const std::runtime_error&)
+    {
+        hasThrown = true;
+    }
+
+    ETH_CHECK(hasThrown);
+    ETH_CHECK(!listener.HasActiveConnection());
+
+    std::unique_ptr<TcpSocket> newClient = ConnectLoopback(listener);
+    ETH_REQUIRE(listener.HasActiveConnection());
+
+    const uint32_t sent = 0x12345678;
+    newClient->Send(&sent, sizeof(sent));
+
+    uint32_t received = 0;
+    listener.Receive(&received, sizeof(received));
+    ETH_CHECK(received == sent);
+}
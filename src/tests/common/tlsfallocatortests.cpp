@@ -0,0 +1,178 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/memory/tlsfallocator.h"
+
+#include <map>
+#include <random>
+
+using namespace Ether;
+
+static constexpr size_t Capacity = 1 << 20;
+
+// Live allocations by offset, to check that nothing handed out overlaps
+using AllocationMap = std::map<size_t, AllocationHandle>;
+
+static bool OverlapsNeighbours(const AllocationMap& allocations, AllocationMap::const_iterator iter)
+{
+    if (iter != allocations.begin() && std::prev(iter)->first + std::prev(iter)->second.m_Size > iter->first)
+        return true;
+
+    return std::next(iter) != allocations.end() && iter->first + iter->second.m_Size > std::next(iter)->first;
+}
+
+ETH_TEST(TlsfAllocator, AllocateAndFreeWholeRange)
+{
+    TlsfAllocator allocator(Capacity);
+
+    const AllocationHandle alloc = allocator.Allocate(Capacity);
+    ETH_REQUIRE(alloc.IsValid());
+    ETH_CHECK(alloc.m_Offset == 0 && alloc.m_Size == Capacity);
+    ETH_CHECK(allocator.GetFreeSize() == 0);
+    ETH_CHECK(!allocator.HasSpace(1));
+    ETH_CHECK(!allocator.Allocate(1).IsValid());
+
+    allocator.Free(alloc);
+    ETH_CHECK(allocator.GetFreeSize() == Capacity);
+    ETH_CHECK(allocator.ValidateInvariants());
+}
+
+ETH_TEST(TlsfAllocator, FreeMergesNeighbours)
+{
+    TlsfAllocator allocator(Capacity);
+
+    const AllocationHandle a = allocator.Allocate(Capacity / 4);
+    const AllocationHandle b = allocator.Allocate(Capacity / 4);
+    const AllocationHandle c = allocator.Allocate(Capacity / 4);
+    const AllocationHandle d = allocator.Allocate(Capacity / 4);
+    ETH_REQUIRE(a.IsValid() && b.IsValid() && c.IsValid() && d.IsValid());
+
+    // Neither free neighbour alone is large enough, the merged block is
+    allocator.Free(a);
+    allocator.Free(c);
+    ETH_CHECK(!allocator.HasSpace(Capacity / 2));
+
+    allocator.Free(b);
+    ETH_CHECK(allocator.ValidateInvariants());
+
+    const AllocationHandle merged = allocator.Allocate(Capacity * 3 / 4);
+    ETH_REQUIRE(merged.IsValid());
+    ETH_CHECK(merged.m_Offset == 0);
+
+    allocator.Free(merged);
+    allocator.Free(d);
+    ETH_CHECK(allocator.GetFreeSize() == Capacity);
+    ETH_CHECK(allocator.ValidateInvariants());
+}
+
+ETH_TEST(TlsfAllocator, AlignmentPaddingIsReturned)
+{
+    TlsfAllocator allocator(Capacity);
+
+    const AllocationHandle unaligned = allocator.Allocate(3);
+    const AllocationHandle aligned = allocator.Allocate({ 64, 256 });
+    ETH_REQUIRE(unaligned.IsValid() && aligned.IsValid());
+    ETH_CHECK(aligned.m_Offset % 256 == 0);
+    ETH_CHECK(allocator.GetFreeSize() == Capacity - unaligned.m_Size - aligned.m_Size);
+    ETH_CHECK(allocator.ValidateInvariants());
+
+    // The padding between the two has to merge back once both are freed
+    allocator.Free(unaligned);
+    allocator.Free(aligned);
+    ETH_CHECK(allocator.Allocate(Capacity).IsValid());
+}
+
+ETH_TEST(TlsfAllocator, ResetInvalidatesHandles)
+{
+    TlsfAllocator allocator(Capacity);
+
+    const AllocationHandle alloc = allocator.Allocate(128);
+    ETH_REQUIRE(alloc.IsValid());
+    ETH_CHECK(allocator.Owns(alloc));
+
+    allocator.Reset();
+    ETH_CHECK(!allocator.Owns(alloc));
+    ETH_CHECK(allocator.GetFreeSize() == Capacity);
+    ETH_CHECK(allocator.ValidateInvariants());
+}
+
+// Random allocations and frees, with every invariant checked after each operation
+ETH_TEST(TlsfAllocator, RandomizedStress)
+{
+    static constexpr uint32_t NumOperations = 20000;
+
+    TlsfAllocator allocator(Capacity);
+    AllocationMap allocations;
+    size_t usedSize = 0;
+
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<uint32_t> percentDist(0, 99);
+    std::uniform_int_distribution<uint32_t> alignmentShiftDist(0, 8);
+
+    for (uint32_t op = 0; op < NumOperations; ++op)
+    {
+        // Lean towards allocating in the first half and towards freeing in the second, so that the
+        // allocator goes through both a filling and a draining phase
+        const uint32_t allocatePercent = op < NumOperations / 2 ? 65 : 35;
+
+        if (allocations.empty() || percentDist(random) < allocatePercent)
+        {
+            // Mostly small allocations, with the occasional large one
+            const size_t maxSize = percentDist(random) < 90 ? 512 : Capacity / 16;
+            const size_t size = std::uniform_int_distribution<size_t>(1, maxSize)(random);
+            const size_t alignment = size_t(1) << alignmentShiftDist(random);
+
+            const bool hasSpace = allocator.HasSpace({ size, alignment });
+            const AllocationHandle alloc = allocator.Allocate({ size, alignment });
+            ETH_CHECK_MSG(hasSpace == alloc.IsValid(), "op {}: HasSpace disagrees with Allocate", op);
+
+            if (alloc.IsValid())
+            {
+                ETH_CHECK_MSG(alloc.m_Offset % alignment == 0, "op {}: offset {} is not aligned to {}", op, alloc.m_Offset, alignment);
+                ETH_CHECK_MSG(alloc.m_Size >= size, "op {}: {} bytes handed out for {}", op, alloc.m_Size, size);
+                ETH_CHECK_MSG(alloc.m_Offset + alloc.m_Size <= Capacity, "op {}: allocation ends past the capacity", op);
+
+                const auto iter = allocations.emplace(alloc.m_Offset, alloc).first;
+                ETH_REQUIRE(!OverlapsNeighbours(allocations, iter));
+                usedSize += alloc.m_Size;
+            }
+        }
+        else
+        {
+            auto iter = allocations.begin();
+            std::advance(iter, std::uniform_int_distribution<size_t>(0, allocations.size() - 1)(random));
+
+            allocator.Free(iter->second);
+            usedSize -= iter->second.m_Size;
+            allocations.erase(iter);
+        }
+
+        ETH_REQUIRE(allocator.ValidateInvariants());
+        ETH_CHECK_MSG(allocator.GetFreeSize() == Capacity - usedSize, "op {}: free size is {}, expected {}", op, allocator.GetFreeSize(), Capacity - usedSize);
+    }
+
+    for (const auto& [offset, alloc] : allocations)
+        allocator.Free(alloc);
+
+    // Everything has to coalesce back into a single block
+    ETH_CHECK(allocator.ValidateInvariants());
+    ETH_CHECK(allocator.GetFreeSize() == Capacity);
+    ETH_CHECK(allocator.Allocate(Capacity).IsValid());
+}
@@ -0,0 +1,151 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "common/stream/filestream.h"
+#include "engine/world/ecs/components/ecscomponentarray.h"
+#include "engine/world/ecs/components/ecstransformcomponent.h"
+
+#include <filesystem>
+#include <format>
+#include <set>
+
+using namespace Ether;
+using namespace Ether::Ecs;
+
+using TransformArray = EcsComponentArray<EcsTransformComponent>;
+
+static std::string GetTestFilePath()
+{
+    return (std::filesystem::temp_directory_path() / "ether_componentarray_tests.bin").string();
+}
+
+// Writes the header of an array, in the format of the given version
+static void WriteArrayHeader(OStream& ostream, uint32_t version, uint32_t numRuns)
+{
+    ostream << version;
+    ostream << std::string("Engine::EcsComponentArray");
+    ostream << std::string("0-0-0-0");
+    ostream << GetEcsPrototype<EcsTransformComponent>().GetVersion();
+    ostream << numRuns;
+}
+
+static void WriteRun(OStream& ostream, EntityID firstEntity, uint32_t numEntities, bool hasGuids)
+{
+    ostream << firstEntity;
+    ostream << numEntities;
+
+    const EcsTransformComponent component;
+    for (uint32_t i = 0; i < numEntities; ++i)
+    {
+        if (hasGuids)
+            ostream << std::format("{}-{}", firstEntity, i);
+        SerializeEcsFields(ostream, EcsTransformComponent::GetComponentInfo(), &component);
+    }
+}
+
+ETH_TEST(EcsComponentArray, RoundTripKeepsGuidsAndFields)
+{
+    const std::vector<EntityID> entities = { 3, 4, 5, 9, 100 };
+
+    // Component arrays hold a component for every possible entity, far too much for the stack
+    auto original = std::make_unique<TransformArray>();
+    for (EntityID entityID : entities)
+    {
+        original->AddComponent(entityID);
+        original->GetComponent(entityID).m_Translation = { static_cast<float>(entityID), 1.0f, 2.0f };
+    }
+
+    {
+        OFileStream ostream(GetTestFilePath());
+        original->Serialize(ostream);
+    }
+
+    auto loaded = std::make_unique<TransformArray>();
+    {
+        IFileStream istream(GetTestFilePath());
+        loaded->Deserialize(istream);
+    }
+
+    ETH_REQUIRE(loaded->GetNumComponents() == entities.size());
+
+    std::set<std::string> guids;
+    for (EntityID entityID : entities)
+    {
+        const EcsTransformComponent& component = loaded->GetComponent(entityID);
+        ETH_CHECK_MSG(component.GetGuid() == original->GetComponent(entityID).GetGuid(), "Entity {} lost its guid", entityID);
+        ETH_CHECK(component.m_Translation.x == static_cast<float>(entityID));
+        guids.insert(component.GetGuid());
+    }
+
+    ETH_CHECK(guids.size() == entities.size());
+    std::filesystem::remove(GetTestFilePath());
+}
+
+// Version 1 did not store guids, loading it must not leave every component with the prototype's
+ETH_TEST(EcsComponentArray, VersionOneGetsUniqueGuids)
+{
+    {
+        OFileStream ostream(GetTestFilePath());
+        WriteArrayHeader(ostream, 1, 2);
+        WriteRun(ostream, 0, 8, false);
+        WriteRun(ostream, 20, 8, false);
+    }
+
+    auto loaded = std::make_unique<TransformArray>();
+    {
+        IFileStream istream(GetTestFilePath());
+        loaded->Deserialize(istream);
+    }
+
+    ETH_REQUIRE(loaded->GetNumComponents() == 16);
+
+    std::set<std::string> guids;
+    for (uint32_t i = 0; i < loaded->GetNumComponents(); ++i)
+        guids.insert(static_cast<EcsTransformComponent*>(loaded->GetComponentDataAt(i))->GetGuid());
+
+    ETH_CHECK(guids.size() == 16);
+    ETH_CHECK(guids.count(GetEcsPrototype<EcsTransformComponent>().GetGuid()) == 0);
+    std::filesystem::remove(GetTestFilePath());
+}
+
+ETH_TEST(EcsComponentArray, OverlappingRunsAreRejected)
+{
+    {
+        OFileStream ostream(GetTestFilePath());
+        WriteArrayHeader(ostream, ComponentArrayVersion, 2);
+        WriteRun(ostream, 10, 4, true);
+        WriteRun(ostream, 12, 4, true);
+    }
+
+    bool hasThrown = false;
+    try
+    {
+        auto loaded = std::make_unique<TransformArray>();
+        IFileStream istream(GetTestFilePath());
+        loaded->Deserialize(istream);
+    }
+    catch (const std::runtime_error&)
+    {
+        hasThrown = true;
+    }
+
+    ETH_CHECK(hasThrown);
+    std::filesystem::remove(GetTestFilePath());
+}
@@ -0,0 +1,314 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "engine/input/inputrecorder.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+
+using namespace Ether;
+
+constexpr uint32_t NumRecordedFrames = 120;
+constexpr size_t InputLogHeaderSize = 24;
+constexpr KeyCode RecordedKeys[] = { 0x10, 0x20, 0x41, 0x57 };
+
+// Everything a frame sees from the outside
+struct FrameState
+{
+    double m_Time;
+    double m_DeltaTime;
+    bool m_Keys[std::size(RecordedKeys)][3];
+    bool m_MouseButtons[3][3];
+    double m_MouseValues[5];
+    std::vector<std::vector<uint8_t>> m_Commands;
+
+    bool operator==(const FrameState&) const = default;
+};
+
+static std::string GetTestFilePath()
+{
+    return (std::filesystem::temp_directory_path() / "ether_inputrecorder_tests.erec").string();
+}
+
+static std::vector<uint8_t> ReadFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+}
+
+static void WriteFile(const std::string& path, const uint8_t* data, size_t numBytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data), numBytes);
+}
+
+// What the platform would deliver in the given frame, with a few commands every now and then
+static void ApplyLiveInput(uint32_t frame, std::vector<std::vector<uint8_t>>& commands)
+{
+    Input& input = Input::Instance();
+    const KeyCode key = RecordedKeys[frame % std::size(RecordedKeys)];
+
+    if (frame % 7 == 0)
+        input.SetKeyDown(key);
+    if (frame % 11 == 0)
+        input.SetKeyUp(key);
+    if (frame % 13 == 0)
+        input.SetMouseButtonDown(frame % 3);
+    if (frame % 17 == 0)
+        input.SetMouseButtonUp(frame % 3);
+
+    if (frame % 4 != 0)
+    {
+        input.SetMousePosX(frame * 1.25);
+        input.SetMousePosY(400.0 - frame * 0.75);
+    }
+
+    if (frame % 9 == 0)
+        input.SetMouseWheelDelta(frame % 2 == 0 ? 1.0 : -1.0);
+
+    for (uint32_t i = 0; i < frame % 5 / 3; ++i)
+        commands.push_back(std::vector<uint8_t>(frame * 3 % 50, static_cast<uint8_t>(frame + i)));
+
+    // Empty commands have to survive as well, toolmode uses them for detaching
+    if (frame % 23 == 0)
+        commands.emplace_back();
+}
+
+static FrameState CaptureFrameState(const std::vector<std::vector<uint8_t>>& commands)
+{
+    FrameState state = {};
+    state.m_Time = Time::GetCurrentTime();
+    state.m_DeltaTime = Time::GetDeltaTime();
+
+    for (size_t i = 0; i < std::size(RecordedKeys); ++i)
+    {
+        state.m_Keys[i][0] = Input::GetKey(RecordedKeys[i]);
+        state.m_Keys[i][1] = Input::GetKeyDown(RecordedKeys[i]);
+        state.m_Keys[i][2] = Input::GetKeyUp(RecordedKeys[i]);
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        state.m_MouseButtons[i][0] = Input::GetMouseButton(i);
+        state.m_MouseButtons[i][1] = Input::GetMouseButtonDown(i);
+        state.m_MouseButtons[i][2] = Input::GetMouseButtonUp(i);
+    }
+
+    state.m_MouseValues[0] = Input::GetMousePosX();
+    state.m_MouseValues[1] = Input::GetMousePosY();
+    state.m_MouseValues[2] = Input::GetMouseDeltaX();
+    state.m_MouseValues[3] = Input::GetMouseDeltaY();
+    state.m_MouseValues[4] = Input::GetMouseWheelDelta();
+    state.m_Commands = commands;
+    return state;
+}
+
+// Runs frames in the same order as the engine loop, until the recorder stops or after maxNumFrames
+static std::vector<FrameState> RunFrames(uint32_t maxNumFrames)
+{
+    InputRecorder& recorder = InputRecorder::Instance();
+    std::vector<FrameState> states;
+
+    for (uint32_t frame = 0; frame < maxNumFrames; ++frame)
+    {
+        if (!recorder.NewFrame())
+            break;
+
+        Time::NewFrame();
+        Input::NewFrame();
+
+        std::vector<std::vector<uint8_t>> commands;
+        if (!recorder.IsReplaying())
+            ApplyLiveInput(frame, commands);
+
+        recorder.ProcessInput();
+
+        if (recorder.IsReplaying())
+            commands = recorder.GetReplayedCommands();
+
+        for (const std::vector<uint8_t>& command : commands)
+            recorder.RecordCommand(command.data(), command.size());
+
+        states.push_back(CaptureFrameState(commands));
+
+        // Uneven frame times, a replay has to reproduce them without waiting
+        if (recorder.IsRecording())
+            std::this_thread::sleep_for(std::chrono::microseconds(frame % 3 * 200));
+    }
+
+    return states;
+}
+
+static std::vector<FrameState> Record(const std::string& path)
+{
+    Time::Instance().Initialize();
+    Input::Reset();
+    InputRecorder::Instance().StartRecording(path);
+    std::vector<FrameState> states = RunFrames(NumRecordedFrames);
+    InputRecorder::Instance().Stop();
+    return states;
+}
+
+static std::vector<FrameState> Replay(const std::string& path, double fixedTimestep = 0.0)
+{
+    // Starts from a different clock and input state than the recording did
+    Time::Instance().Initialize();
+    Input::Reset();
+    Input::Instance().SetKeyDown(RecordedKeys[0]);
+
+    InputRecorder::Instance().StartReplay(path, fixedTimestep);
+    if (!InputRecorder::Instance().IsReplaying())
+        return {};
+
+    // A malformed recording may be cut into more frames than were recorded, but must still end
+    std::vector<FrameState> states = RunFrames(NumRecordedFrames * 10);
+    InputRecorder::Instance().Stop();
+    return states;
+}
+
+static void ResetState()
+{
+    InputRecorder::Reset();
+    Input::Reset();
+    Time::Instance().Initialize();
+    std::filesystem::remove(GetTestFilePath());
+}
+
+ETH_TEST(InputRecorder, ReplayMatchesRecording)
+{
+    const std::vector<FrameState> recorded = Record(GetTestFilePath());
+    ETH_REQUIRE(recorded.size() == NumRecordedFrames);
+
+    const std::vector<FrameState> replayed = Replay(GetTestFilePath());
+    ETH_REQUIRE(replayed.size() == recorded.size());
+
+    // Bit for bit, including the frame times
+    for (uint32_t i = 0; i < NumRecordedFrames; ++i)
+        ETH_CHECK_MSG(replayed[i] == recorded[i], "Frame {} differs", i);
+
+    ResetState();
+}
+
+ETH_TEST(InputRecorder, IdleFramesAreSmall)
+{
+    Time::Instance().Initialize();
+    Input::Reset();
+    InputRecorder::Instance().StartRecording(GetTestFilePath());
+
+    for (uint32_t frame = 0; frame < NumRecordedFrames; ++frame)
+    {
+        InputRecorder::Instance().NewFrame();
+        Time::NewFrame();
+        Input::NewFrame();
+        InputRecorder::Instance().ProcessInput();
+    }
+
+    InputRecorder::Instance().Stop();
+
+    // 19 bytes a frame, and the first one may store where the mouse was left by a previous test
+    const size_t numBytes = std::filesystem::file_size(GetTestFilePath());
+    ETH_CHECK_MSG(numBytes <= InputLogHeaderSize + NumRecordedFrames * 19 + 5 * sizeof(double), "{} bytes recorded", numBytes);
+    ResetState();
+}
+
+ETH_TEST(InputRecorder, FixedTimestepReplaysTheSameInput)
+{
+    const std::vector<FrameState> recorded = Record(GetTestFilePath());
+    const std::vector<FrameState> replayed = Replay(GetTestFilePath(), 16.0);
+    ETH_REQUIRE(replayed.size() == recorded.size());
+
+    for (uint32_t i = 0; i < NumRecordedFrames; ++i)
+    {
+        ETH_CHECK_MSG(std::abs(replayed[i].m_DeltaTime - 16.0) < 1e-6, "Frame {} took {} ms", i, replayed[i].m_DeltaTime);
+        ETH_CHECK_MSG(std::abs(replayed[i].m_Time - recorded[0].m_Time + recorded[0].m_DeltaTime - 16.0 * (i + 1)) < 1e-3, "Frame {} is at the wrong time", i);
+
+        FrameState state = replayed[i];
+        state.m_Time = recorded[i].m_Time;
+        state.m_DeltaTime = recorded[i].m_DeltaTime;
+        ETH_CHECK_MSG(state == recorded[i], "Frame {} differs", i);
+    }
+
+    ResetState();
+}
+
+ETH_TEST(InputRecorder, TruncatedRecordingsStopEarly)
+{
+    const std::string path = GetTestFilePath();
+    const std::vector<FrameState> recorded = Record(path);
+    const std::vector<uint8_t> data = ReadFile(path);
+
+    // Not even a header
+    WriteFile(path, data.data(), InputLogHeaderSize - 1);
+    ETH_CHECK(Replay(path).empty());
+
+    // Every frame up to the cut replays as recorded, the one that was cut does not replay at all
+    for (size_t numBytes = InputLogHeaderSize; numBytes < data.size(); numBytes += 7)
+    {
+        WriteFile(path, data.data(), numBytes);
+        const std::vector<FrameState> replayed = Replay(path);
+
+        ETH_REQUIRE(replayed.size() < recorded.size());
+        for (size_t i = 0; i < replayed.size(); ++i)
+            ETH_CHECK_MSG(replayed[i] == recorded[i], "Frame {} differs after truncating to {} bytes", i, numBytes);
+    }
+
+    ResetState();
+}
+
+ETH_TEST(InputRecorder, CorruptedRecordingsStop)
+{
+    const std::string path = GetTestFilePath();
+    Record(path);
+    const std::vector<uint8_t> data = ReadFile(path);
+
+    // A frame that claims more keys than it holds
+    std::vector<uint8_t> damaged = data;
+    const uint16_t numKeys = 0xffff;
+    std::memcpy(damaged.data() + InputLogHeaderSize + sizeof(uint32_t) + sizeof(double), &numKeys, sizeof(numKeys));
+    WriteFile(path, damaged.data(), damaged.size());
+    ETH_CHECK(Replay(path).empty());
+
+    // A wrong magic or version is not replayed at all
+    damaged = data;
+    damaged[0] ^= 0xff;
+    WriteFile(path, damaged.data(), damaged.size());
+    ETH_CHECK(Replay(path).empty());
+
+    damaged = data;
+    damaged[4] ^= 0xff;
+    WriteFile(path, damaged.data(), damaged.size());
+    ETH_CHECK(Replay(path).empty());
+
+    // Random damage anywhere in the frames must never read out of bounds, and replay has to end
+    std::mt19937 random(1);
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        damaged = data;
+        for (uint32_t j = 0; j < 1 + i % 4; ++j)
+            damaged[InputLogHeaderSize + random() % (data.size() - InputLogHeaderSize)] = static_cast<uint8_t>(random());
+
+        WriteFile(path, damaged.data(), damaged.size());
+        ETH_CHECK(Replay(path).size() < NumRecordedFrames * 10);
+    }
+
+    ResetState();
+}
@@ -0,0 +1,186 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "engine/api/api.h"
+#include "engine/api/iapplicationbase.h"
+#include "engine/world/worldgenerator.h"
+#include "engine/world/ecs/components/ecstransformcomponent.h"
+
+#include <cmath>
+#include <filesystem>
+
+using namespace Ether;
+
+/*
+    Flies the camera between a few spots of a small generated world, streamed back in under a
+    budget that only holds a fraction of its textures. Cells are loaded on the main thread, so every
+    run streams exactly the same way.
+
+    Runs the whole engine headlessly, which can only be started once per process.
+*/
+class StreamingTestApp : public IApplicationBase
+{
+public:
+    // Room for about a dozen of the 32 textures (64x64 with mips), while each cell only uses four
+    static constexpr size_t MemoryBudget = 12 * 64 * 64 * 4 * 4 / 3;
+    static constexpr float CellSize = 8.0f;
+    static constexpr uint32_t NumFramesPerStop = 30;
+
+public:
+    void Initialize() override {}
+    void UnloadContent() override {}
+    void Shutdown() override {}
+    void OnRender(const RenderEventArgs& e) override {}
+    void OnShutdown() override {}
+
+    void LoadContent() override
+    {
+        World& world = GetActiveWorld();
+
+        WorldGeneratorParams params;
+        params.m_NumEntities = 1024;
+        params.m_Placement = WorldPlacement::Grid;
+        params.m_NumMeshes = 8;
+        params.m_NumMaterials = 32;
+        params.m_NumTextures = 32;
+        params.m_TextureSize = 64;
+
+        WorldGenerator generator(params);
+        generator.Generate(world);
+        const float extent = generator.GetExtent() * 0.5f;
+
+        m_Path = (std::filesystem::temp_directory_path() / "ether_worldstreamer_tests.ether").string();
+        world.SaveStreamed(m_Path, CellSize);
+
+        WorldStreamingParams streamingParams;
+        streamingParams.m_LoadRadius = 20.0f;
+        streamingParams.m_UnloadRadius = 32.0f;
+        streamingParams.m_MemoryBudget = MemoryBudget;
+        streamingParams.m_NumLoaderThreads = 0;
+        world.LoadStreamed(m_Path, streamingParams);
+
+        m_Streamer = world.GetStreamer();
+        m_Camera = &world.CreateCamera();
+        m_Stops = { { 0.0f, 0.0f }, { extent, extent }, { -extent, -extent }, { extent, -extent }, { 0.0f, 0.0f } };
+        MoveCamera();
+    }
+
+    void OnUpdate(const UpdateEventArgs& e) override
+    {
+        if (m_Streamer == nullptr)
+        {
+            ETH_CHECK_MSG(false, "Failed to stream the world back in from {}", m_Path);
+            Ether::Shutdown();
+            return;
+        }
+
+        // The world has been updated for the current camera position by now
+        const std::string error = m_Streamer->Validate();
+        ETH_CHECK_MSG(error.empty(), "Stop {}, frame {}: {}", m_StopIndex, m_FrameIndex, error);
+        ETH_CHECK(m_Streamer->GetStats().m_CommittedMemory <= MemoryBudget);
+
+        if (++m_FrameIndex < NumFramesPerStop)
+            return;
+
+        CheckStop();
+
+        m_FrameIndex = 0;
+        if (++m_StopIndex < m_Stops.size())
+        {
+            MoveCamera();
+            return;
+        }
+
+        // Every stop is out of the unload radius of the one before, so each move releases memory
+        const WorldStreamingStats& stats = m_Streamer->GetStats();
+        ETH_CHECK(stats.m_NumCellUnloads > 0);
+        ETH_CHECK(stats.m_NumResourceEvictions > 0);
+        ETH_CHECK(stats.m_NumFailedLoads == 0);
+        ETH_CHECK(stats.m_PeakCommittedMemory <= MemoryBudget);
+        ETH_CHECK(m_NumBudgetLimitedStops > 0);
+
+        Ether::Shutdown();
+    }
+
+public:
+    std::string m_Path;
+
+private:
+    int32_t GetCellCoordinate(float position) const { return static_cast<int32_t>(std::floor(position / CellSize)); }
+
+    void MoveCamera()
+    {
+        Ecs::EcsTransformComponent& transform = m_Camera->GetComponent<Ecs::EcsTransformComponent>();
+        transform.m_Translation = { m_Stops[m_StopIndex].first, 3.0f, m_Stops[m_StopIndex].second };
+        m_Camera->MarkModified<Ecs::EcsTransformComponent>();
+    }
+
+    void CheckStop()
+    {
+        const auto [cameraX, cameraZ] = m_Stops[m_StopIndex];
+        const int32_t x = GetCellCoordinate(cameraX);
+        const int32_t z = GetCellCoordinate(cameraZ);
+
+        ETH_CHECK(m_Streamer->HasCell(x, z));
+        ETH_CHECK_MSG(m_Streamer->IsCellResident(x, z), "Camera cell ({}, {}) is not resident at stop {}", x, z, m_StopIndex);
+
+        // The previous stop is beyond the unload radius, none of its cells are kept
+        if (m_StopIndex > 0)
+        {
+            const auto [previousX, previousZ] = m_Stops[m_StopIndex - 1];
+            const int32_t px = GetCellCoordinate(previousX);
+            const int32_t pz = GetCellCoordinate(previousZ);
+            ETH_CHECK_MSG(!m_Streamer->IsCellResident(px, pz), "Cell ({}, {}) of stop {} is still resident", px, pz, m_StopIndex - 1);
+        }
+
+        // The budget only holds the nearest few cells, not everything within the load radius
+        const int32_t radius = static_cast<int32_t>(m_Streamer->GetParams().m_LoadRadius / CellSize) - 1;
+        uint32_t numCells = 0;
+        uint32_t numResidentCells = 0;
+
+        for (int32_t dz = -radius; dz <= radius; ++dz)
+        {
+            for (int32_t dx = -radius; dx <= radius; ++dx)
+            {
+                numCells += m_Streamer->HasCell(x + dx, z + dz) ? 1 : 0;
+                numResidentCells += m_Streamer->IsCellResident(x + dx, z + dz) ? 1 : 0;
+            }
+        }
+
+        if (numResidentCells < numCells)
+            m_NumBudgetLimitedStops++;
+    }
+
+private:
+    WorldStreamer* m_Streamer = nullptr;
+    Entity* m_Camera = nullptr;
+
+    std::vector<std::pair<float, float>> m_Stops;
+    size_t m_StopIndex = 0;
+    uint32_t m_FrameIndex = 0;
+    uint32_t m_NumBudgetLimitedStops = 0;
+};
+
+ETH_TEST(WorldStreamer, StreamsCellsAroundTheCameraWithinBudget)
+{
+    StreamingTestApp app;
+    StartHeadless(app);
+    std::filesystem::remove(app.m_Path);
+}
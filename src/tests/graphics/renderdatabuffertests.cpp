@@ -0,0 +1,189 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "graphics/common/renderdatabuffer.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace Ether;
+using namespace Ether::Graphics;
+
+/*
+    Every field of a frame is stamped with the frame's number, so a frame that the renderer sees
+    while it is still being written (or that mixes two frames) shows up as fields that disagree.
+*/
+static void StampMatrix(ethMatrix4x4& matrix, float value)
+{
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+            matrix.m_Data2D[r][c] = value;
+}
+
+static bool IsMatrixStamped(const ethMatrix4x4& matrix, float value)
+{
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+            if (matrix.m_Data2D[r][c] != value)
+                return false;
+
+    return true;
+}
+
+static void StampFrame(RenderData& renderData, uint32_t frame, std::atomic<uint32_t>& lastExecutedWork)
+{
+    const float value = static_cast<float>(frame);
+
+    StampMatrix(renderData.m_ViewMatrix, value);
+    StampMatrix(renderData.m_ProjectionMatrix, value);
+    renderData.m_CameraDirection = { value, value, value };
+    renderData.m_CameraPosition = { value, value, value };
+    renderData.m_CameraJitter = { value, value };
+    renderData.m_HdriTextureID = StringID(std::to_string(frame));
+
+    renderData.m_VisualBatches.resize(1 + frame % 7);
+    for (VisualBatch& batch : renderData.m_VisualBatches)
+        batch = { nullptr, frame };
+
+    // Like a static scene, the visuals are left alone on some frames and are then only copied when they change.
+    // Their count varies, so that the vectors reallocate.
+    if (frame % 4 != 0)
+    {
+        renderData.m_Visuals.resize(1 + frame % 13);
+        for (Visual& visual : renderData.m_Visuals)
+        {
+            visual.m_Mesh = nullptr;
+            visual.m_Material = nullptr;
+            visual.m_Culled = frame % 2 == 0;
+            StampMatrix(visual.m_WorldMatrix, value);
+        }
+
+        renderData.m_VisualsVersion = frame;
+    }
+
+    renderData.m_RenderWork.push_back([frame, &lastExecutedWork]() { lastExecutedWork = frame; });
+}
+
+static std::string CheckFrame(const RenderData& renderData, uint32_t frame)
+{
+    const float value = static_cast<float>(frame);
+
+    if (!IsMatrixStamped(renderData.m_ViewMatrix, value) || !IsMatrixStamped(renderData.m_ProjectionMatrix, value))
+        return "camera matrices";
+
+    if (renderData.m_CameraDirection.x != value || renderData.m_CameraDirection.z != value ||
+        renderData.m_CameraPosition.x != value || renderData.m_CameraPosition.z != value ||
+        renderData.m_CameraJitter.x != value || renderData.m_CameraJitter.y != value)
+        return "camera vectors";
+
+    if (renderData.m_HdriTextureID != StringID(std::to_string(frame)))
+        return "hdri texture";
+
+    if (renderData.m_VisualBatches.size() != 1 + frame % 7)
+        return "visual batch count";
+
+    for (const VisualBatch& batch : renderData.m_VisualBatches)
+        if (batch.m_NumVisuals != frame)
+            return "visual batches";
+
+    // The visuals are from the last frame that changed them
+    const uint32_t visualsFrame = static_cast<uint32_t>(renderData.m_VisualsVersion);
+    if (visualsFrame > frame || frame - visualsFrame > 1 || renderData.m_Visuals.size() != 1 + visualsFrame % 13)
+        return "visual count";
+
+    for (const Visual& visual : renderData.m_Visuals)
+        if (!IsMatrixStamped(visual.m_WorldMatrix, static_cast<float>(visualsFrame)) || visual.m_Culled != (visualsFrame % 2 == 0))
+            return "visuals";
+
+    if (renderData.m_RenderWork.size() != 1)
+        return "render work";
+
+    return "";
+}
+
+ETH_TEST(RenderDataBuffer, PublishedFramesAreCopies)
+{
+    RenderDataBuffer buffer;
+    std::atomic<uint32_t> lastExecutedWork = 0;
+
+    StampFrame(buffer.GetWriteData(), 1, lastExecutedWork);
+    buffer.Publish();
+    ETH_REQUIRE(buffer.Acquire());
+
+    // The simulation carries on with the next frame, which the renderer must not see
+    StampFrame(buffer.GetWriteData(), 2, lastExecutedWork);
+
+    const std::string error = CheckFrame(buffer.GetReadData(), 1);
+    ETH_CHECK_MSG(error.empty(), "Read frame has wrong {}", error);
+
+    // Render work is handed over rather than copied
+    ETH_CHECK(buffer.GetWriteData().m_RenderWork.size() == 1);
+}
+
+ETH_TEST(RenderDataBuffer, ConcurrentReaderNeverSeesTornFrames)
+{
+    static constexpr uint32_t NumFrames = 20000;
+
+    RenderDataBuffer buffer;
+    std::atomic<uint32_t> lastExecutedWork = 0;
+
+    std::thread simulation([&buffer, &lastExecutedWork]()
+    {
+        for (uint32_t frame = 1; frame <= NumFrames; ++frame)
+        {
+            StampFrame(buffer.GetWriteData(), frame, lastExecutedWork);
+            buffer.Publish();
+        }
+
+        buffer.Close();
+    });
+
+    uint32_t numFrames = 0;
+    uint32_t numTornFrames = 0;
+    uint32_t numSkippedFrames = 0;
+
+    while (buffer.Acquire())
+    {
+        RenderData& renderData = buffer.GetReadData();
+        const uint32_t frame = static_cast<uint32_t>(renderData.m_ViewMatrix.m_Data2D[0][0]);
+
+        const std::string error = CheckFrame(renderData, frame);
+        if (!error.empty() && numTornFrames++ < 5)
+            ETH_CHECK_MSG(false, "Frame {} has torn {}", frame, error);
+
+        if (frame != numFrames + 1)
+            numSkippedFrames++;
+
+        // As GraphicCore does, so that the work list that is swapped back to the simulation is empty
+        for (const auto& work : renderData.m_RenderWork)
+            work();
+        renderData.m_RenderWork.clear();
+
+        ETH_CHECK(lastExecutedWork == frame);
+        numFrames = frame;
+    }
+
+    simulation.join();
+
+    ETH_CHECK(numTornFrames == 0);
+    ETH_CHECK(numSkippedFrames == 0);
+    ETH_CHECK(numFrames == NumFrames);
+}
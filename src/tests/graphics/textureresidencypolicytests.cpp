@@ -0,0 +1,378 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "graphics/resources/textureresidencypolicy.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace Ether::Graphics;
+
+struct UpdateResult
+{
+    std::vector<TextureMipLoad> m_Loads;
+    std::vector<TextureMipEviction> m_Evictions;
+};
+
+static UpdateResult Update(TextureResidencyPolicy& policy, size_t releasingMemory = 0)
+{
+    UpdateResult result;
+    policy.Update(releasingMemory, result.m_Loads, result.m_Evictions);
+    return result;
+}
+
+static uint32_t AddTexture(TextureResidencyPolicy& policy, const std::vector<size_t>& mipSizes, uint32_t firstTailMip)
+{
+    return policy.AddTexture(mipSizes.data(), static_cast<uint32_t>(mipSizes.size()), firstTailMip);
+}
+
+// Requests the mip every update until the texture has it, completing each load right away
+static void LoadUpTo(TextureResidencyPolicy& policy, uint32_t handle, uint32_t mipLevel)
+{
+    while (policy.GetResidentMip(handle) > mipLevel)
+    {
+        policy.RequestMip(handle, mipLevel);
+        const UpdateResult result = Update(policy);
+        ETH_REQUIRE(result.m_Loads.size() == 1);
+        policy.OnMipLoaded(handle, result.m_Loads[0].m_MipLevel);
+    }
+}
+
+ETH_TEST(TextureResidencyPolicy, TailsDoNotCountAgainstTheBudget)
+{
+    TextureResidencyPolicy policy(1000, 4);
+    const uint32_t handle = AddTexture(policy, { 4000, 1000, 250, 60, 15 }, 2);
+
+    ETH_CHECK(policy.GetResidentMip(handle) == 2);
+    ETH_CHECK(policy.GetResidentSize(handle) == 325);
+    ETH_CHECK(policy.GetCommittedMemory() == 0);
+    ETH_CHECK(policy.Validate().empty());
+
+    // Mip 1 fits, mip 0 never will
+    policy.RequestMip(handle, 0);
+    UpdateResult result = Update(policy);
+    ETH_REQUIRE(result.m_Loads.size() == 1);
+    policy.OnMipLoaded(handle, 1);
+    ETH_CHECK(policy.GetCommittedMemory() == 1000);
+
+    policy.RequestMip(handle, 0);
+    result = Update(policy);
+    ETH_CHECK(result.m_Loads.empty() && result.m_Evictions.empty());
+
+    policy.RemoveTexture(handle);
+    ETH_CHECK(policy.GetCommittedMemory() == 0);
+    ETH_CHECK(policy.GetNumTextures() == 0);
+    ETH_CHECK(policy.Validate().empty());
+}
+
+ETH_TEST(TextureResidencyPolicy, TexturesSharpenOneMipAtATime)
+{
+    TextureResidencyPolicy policy(1 << 20, 4);
+    const uint32_t handle = AddTexture(policy, { 4096, 1024, 256, 64, 16, 4 }, 3);
+
+    for (uint32_t expectedMip = 2; expectedMip != ~0u; --expectedMip)
+    {
+        policy.RequestMip(handle, 0);
+        UpdateResult result = Update(policy);
+        ETH_REQUIRE(result.m_Loads.size() == 1);
+        ETH_CHECK(result.m_Loads[0].m_Handle == handle && result.m_Loads[0].m_MipLevel == expectedMip);
+        ETH_CHECK(policy.IsLoading(handle));
+        ETH_CHECK(policy.Validate().empty());
+
+        // Nothing more is issued while the mip is on its way
+        policy.RequestMip(handle, 0);
+        result = Update(policy);
+        ETH_CHECK(result.m_Loads.empty());
+
+        policy.OnMipLoaded(handle, expectedMip);
+        ETH_CHECK(policy.GetResidentMip(handle) == expectedMip);
+        ETH_CHECK(policy.Validate().empty());
+    }
+
+    ETH_CHECK(policy.GetCommittedMemory() == 4096 + 1024 + 256);
+}
+
+ETH_TEST(TextureResidencyPolicy, SmallestLoadsGoFirst)
+{
+    TextureResidencyPolicy policy(1 << 20, 1);
+    const uint32_t large = AddTexture(policy, { 16000, 4000, 1000 }, 2);
+    const uint32_t small = AddTexture(policy, { 4000, 1000, 250 }, 2);
+
+    policy.RequestMip(large, 0);
+    policy.RequestMip(small, 0);
+    UpdateResult result = Update(policy);
+    ETH_REQUIRE(result.m_Loads.size() == 1);
+    ETH_CHECK(result.m_Loads[0].m_Handle == small && result.m_Loads[0].m_MipLevel == 1);
+    ETH_CHECK(policy.GetNumPendingLoads() == 1);
+    policy.OnMipLoaded(small, 1);
+
+    // Both want 4000 bytes next, the one that is missing more mips goes first
+    policy.RequestMip(large, 0);
+    policy.RequestMip(small, 0);
+    result = Update(policy);
+    ETH_REQUIRE(result.m_Loads.size() == 1);
+    ETH_CHECK(result.m_Loads[0].m_Handle == large && result.m_Loads[0].m_MipLevel == 1);
+    ETH_CHECK(policy.Validate().empty());
+}
+
+ETH_TEST(TextureResidencyPolicy, DetailedMipsAreEvictedFirst)
+{
+    // Exactly fits the mips above the first texture's tail
+    TextureResidencyPolicy policy(1750, 4);
+    const uint32_t unused = AddTexture(policy, { 1000, 500, 250, 100, 50 }, 3);
+    LoadUpTo(policy, unused, 0);
+    ETH_CHECK(policy.GetCommittedMemory() == 1750);
+
+    // The first texture is out of view from here on
+    const uint32_t inView = AddTexture(policy, { 600, 300, 150, 75 }, 2);
+    policy.RequestMip(inView, 0);
+    UpdateResult result = Update(policy);
+
+    // Only the most detailed mip has to go to make room, and the load waits until it has been released
+    ETH_REQUIRE(result.m_Evictions.size() == 1);
+    ETH_CHECK(result.m_Evictions[0].m_Handle == unused);
+    ETH_CHECK(result.m_Evictions[0].m_ResidentMip == 1);
+    ETH_CHECK(result.m_Evictions[0].m_Size == 1000);
+    ETH_CHECK(result.m_Loads.empty());
+    ETH_CHECK(policy.Validate().empty());
+
+    policy.RequestMip(inView, 0);
+    result = Update(policy);
+    ETH_REQUIRE(result.m_Loads.size() == 1);
+    ETH_CHECK(result.m_Evictions.empty());
+    policy.OnMipLoaded(inView, 1);
+    LoadUpTo(policy, inView, 0);
+    ETH_CHECK(policy.GetCommittedMemory() == 500 + 250 + 900);
+
+    // Evicts the next two mips in one go, down to the tail, and never the tail itself
+    const uint32_t other = AddTexture(policy, { 800, 400 }, 1);
+    policy.RequestMip(inView, 0);
+    policy.RequestMip(other, 0);
+    result = Update(policy);
+    ETH_REQUIRE(result.m_Evictions.size() == 1);
+    ETH_CHECK(result.m_Evictions[0].m_Handle == unused);
+    ETH_CHECK(result.m_Evictions[0].m_ResidentMip == 3);
+    ETH_CHECK(result.m_Evictions[0].m_Size == 750);
+    ETH_CHECK(policy.GetResidentMip(inView) == 0);
+    ETH_CHECK(policy.Validate().empty());
+
+    policy.RequestMip(inView, 0);
+    policy.RequestMip(other, 0);
+    result = Update(policy);
+    ETH_REQUIRE(result.m_Loads.size() == 1);
+    policy.OnMipLoaded(other, 0);
+
+    // Nothing is left that the current frame does not need, so the last texture has to wait
+    const uint32_t waiting = AddTexture(policy, { 500, 10 }, 1);
+    policy.RequestMip(inView, 0);
+    policy.RequestMip(other, 0);
+    policy.RequestMip(waiting, 0);
+    result = Update(policy);
+    ETH_CHECK(result.m_Loads.empty() && result.m_Evictions.empty());
+    ETH_CHECK(policy.GetResidentMip(unused) == 3);
+    ETH_CHECK(policy.Validate().empty());
+}
+
+ETH_TEST(TextureResidencyPolicy, BudgetSqueezeWhileLoading)
+{
+    TextureResidencyPolicy policy(1000, 4);
+    const uint32_t loading = AddTexture(policy, { 600, 150, 40 }, 2);
+    const uint32_t squeezing = AddTexture(policy, { 800, 200, 50 }, 2);
+
+    policy.RequestMip(loading, 0);
+    policy.RequestMip(squeezing, 1);
+    UpdateResult result = Update(policy);
+    ETH_CHECK(result.m_Loads.size() == 2);
+    ETH_CHECK(policy.GetCommittedMemory() == 350);
+    policy.OnMipLoaded(loading, 1);
+    policy.OnMipLoaded(squeezing, 1);
+
+    // Pending loads count against the budget as soon as they are issued
+    policy.RequestMip(loading, 0);
+    result = Update(policy);
+    ETH_REQUIRE(result.m_Loads.size() == 1);
+    ETH_CHECK(policy.GetCommittedMemory() == 950);
+    ETH_CHECK(policy.Validate().empty());
+
+    // The loading texture is out of view now, but cannot give up anything until its load is done
+    policy.RequestMip(squeezing, 0);
+    result = Update(policy);
+    ETH_CHECK(result.m_Loads.empty() && result.m_Evictions.empty());
+    ETH_CHECK(policy.GetResidentMip(loading) == 1);
+    ETH_CHECK(policy.Validate().empty());
+
+    // A failed load gives its memory back, and the texture is not streamed any further
+    policy.OnMipLoadFailed(loading, 0);
+    ETH_CHECK(policy.GetCommittedMemory() == 350);
+    ETH_CHECK(policy.Validate().empty());
+
+    // Its mips above the tail go once another texture needs the room
+    policy.RequestMip(squeezing, 0);
+    result = Update(policy);
+    ETH_REQUIRE(result.m_Evictions.size() == 1);
+    ETH_CHECK(result.m_Evictions[0].m_Handle == loading && result.m_Evictions[0].m_Size == 150);
+    ETH_CHECK(result.m_Loads.empty());
+
+    // Memory that is still being released counts too
+    policy.RequestMip(squeezing, 0);
+    result = Update(policy, 150);
+    ETH_CHECK(result.m_Loads.empty() && result.m_Evictions.empty());
+
+    policy.RequestMip(squeezing, 0);
+    result = Update(policy);
+    ETH_REQUIRE(result.m_Loads.size() == 1);
+    ETH_CHECK(policy.GetCommittedMemory() == 1000);
+
+    // Removing a texture with a load in flight forgets the load
+    policy.RemoveTexture(squeezing);
+    ETH_CHECK(policy.GetNumPendingLoads() == 0);
+    ETH_CHECK(policy.GetCommittedMemory() == 0);
+    ETH_CHECK(policy.Validate().empty());
+
+    policy.RequestMip(loading, 0);
+    result = Update(policy);
+    ETH_CHECK(result.m_Loads.empty());
+}
+
+// Mirrors what TextureStreamer does with the policy: evicted memory is released a few updates later,
+// and loads complete (or fail) after a random delay. Textures come and go with the world.
+ETH_TEST(TextureResidencyPolicy, RandomizedStreaming)
+{
+    static constexpr size_t Budget = 4 << 20;
+    static constexpr uint32_t MaxPendingLoads = 4;
+    static constexpr uint32_t NumTextures = 48;
+    static constexpr uint32_t NumUpdates = 5000;
+    static constexpr uint32_t ReleaseLatency = 3;
+
+    TextureResidencyPolicy policy(Budget, MaxPendingLoads);
+    std::mt19937 random(7);
+
+    struct TextureInfo
+    {
+        uint32_t m_Handle = TextureResidencyPolicy::InvalidHandle;
+        uint32_t m_FirstTailMip = 0;
+        uint32_t m_RequestedMip = 0;
+        bool m_IsRequested = false;
+    };
+
+    std::vector<TextureInfo> textures(NumTextures);
+    std::vector<std::pair<uint32_t, size_t>> releases;
+    std::vector<TextureMipLoad> pendingLoads;
+    size_t releasingMemory = 0;
+    uint64_t numLoads = 0;
+    uint64_t numEvictions = 0;
+
+    const auto addTexture = [&](TextureInfo& texture)
+    {
+        const uint32_t size = 64u << (random() % 4);
+        std::vector<size_t> mipSizes;
+        for (uint32_t mipSize = size; mipSize > 0; mipSize >>= 1)
+            mipSizes.push_back(static_cast<size_t>(mipSize) * mipSize * 4);
+
+        // Like Texture::GetFirstTailMip(), with a tail of 64 texels
+        uint32_t firstTailMip = 0;
+        while ((size >> firstTailMip) > 64)
+            ++firstTailMip;
+
+        texture.m_Handle = AddTexture(policy, mipSizes, firstTailMip);
+        texture.m_FirstTailMip = firstTailMip;
+    };
+
+    for (TextureInfo& texture : textures)
+        addTexture(texture);
+
+    for (uint32_t update = 0; update < NumUpdates; ++update)
+    {
+        while (!releases.empty() && releases.front().first + ReleaseLatency <= update)
+        {
+            releasingMemory -= releases.front().second;
+            releases.erase(releases.begin());
+        }
+
+        // The camera sees a different part of the world now and then
+        for (TextureInfo& texture : textures)
+        {
+            if (update % 50 == 0)
+            {
+                texture.m_IsRequested = random() % 3 == 0;
+                texture.m_RequestedMip = random() % (texture.m_FirstTailMip + 1);
+            }
+
+            if (texture.m_IsRequested)
+                policy.RequestMip(texture.m_Handle, texture.m_RequestedMip);
+        }
+
+        const UpdateResult result = Update(policy, releasingMemory);
+
+        for (const TextureMipEviction& eviction : result.m_Evictions)
+        {
+            const TextureInfo& texture = *std::find_if(textures.begin(), textures.end(), [&](const TextureInfo& t) { return t.m_Handle == eviction.m_Handle; });
+            ETH_CHECK(eviction.m_ResidentMip <= texture.m_FirstTailMip);
+            ETH_CHECK(!policy.IsLoading(eviction.m_Handle));
+            ETH_CHECK_MSG(!texture.m_IsRequested || eviction.m_ResidentMip <= texture.m_RequestedMip, "Texture {} lost a mip it needs", eviction.m_Handle);
+
+            releases.emplace_back(update, eviction.m_Size);
+            releasingMemory += eviction.m_Size;
+            numEvictions++;
+        }
+
+        for (const TextureMipLoad& load : result.m_Loads)
+        {
+            ETH_CHECK(load.m_MipLevel + 1 == policy.GetResidentMip(load.m_Handle));
+            pendingLoads.push_back(load);
+            numLoads++;
+        }
+
+        ETH_REQUIRE(policy.GetCommittedMemory() + releasingMemory <= Budget);
+
+        // Some loads complete, a few fail
+        for (size_t i = 0; i < pendingLoads.size();)
+        {
+            if (random() % 3 != 0)
+            {
+                ++i;
+                continue;
+            }
+
+            if (random() % 50 == 0)
+                policy.OnMipLoadFailed(pendingLoads[i].m_Handle, pendingLoads[i].m_MipLevel);
+            else
+                policy.OnMipLoaded(pendingLoads[i].m_Handle, pendingLoads[i].m_MipLevel);
+
+            pendingLoads.erase(pendingLoads.begin() + i);
+        }
+
+        // The world streamer drops a texture, the data of its pending load is thrown away
+        if (random() % 20 == 0)
+        {
+            TextureInfo& texture = textures[random() % NumTextures];
+            std::erase_if(pendingLoads, [&](const TextureMipLoad& load) { return load.m_Handle == texture.m_Handle; });
+            policy.RemoveTexture(texture.m_Handle);
+            addTexture(texture);
+        }
+
+        const std::string error = policy.Validate();
+        ETH_CHECK_MSG(error.empty(), "Update {}: {}", update, error);
+        ETH_REQUIRE(error.empty());
+    }
+
+    ETH_CHECK(numLoads > 500);
+    ETH_CHECK(numEvictions > 100);
+}
@@ -0,0 +1,175 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/testframework.h"
+#include "graphics/common/tlasinstancetracker.h"
+
+#include <cstring>
+
+using namespace Ether::Graphics;
+
+// See TlasInstanceTracker::MaxRefitsBeforeRebuild
+static constexpr uint32_t MaxRefitsBeforeRebuild = 120;
+
+static std::vector<RhiRaytracingInstanceDesc> CreateInstances(uint32_t numInstances)
+{
+    std::vector<RhiRaytracingInstanceDesc> instances(numInstances);
+
+    for (uint32_t i = 0; i < numInstances; ++i)
+    {
+        RhiRaytracingInstanceDesc& instance = instances[i];
+        std::memset(&instance, 0, sizeof(instance));
+        instance.m_Transform[0][0] = instance.m_Transform[1][1] = instance.m_Transform[2][2] = 1.0f;
+        instance.m_Transform[0][3] = static_cast<float>(i);
+        instance.m_InstanceID = i;
+        instance.m_InstanceMask = 0xff;
+        instance.m_AccelerationStructure = 0x10000 * (i % 4 + 1);
+    }
+
+    return instances;
+}
+
+static TlasUpdateType Update(TlasInstanceTracker& tracker, const std::vector<RhiRaytracingInstanceDesc>& instances)
+{
+    tracker.ClearDirtyRange();
+    return tracker.Update(instances.data(), static_cast<uint32_t>(instances.size()));
+}
+
+ETH_TEST(TlasInstanceTracker, FirstUpdateRebuilds)
+{
+    TlasInstanceTracker tracker;
+    const std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Rebuild);
+    ETH_CHECK(tracker.GetNumInstances() == 16);
+    ETH_CHECK(tracker.GetDirtyRange().m_Begin == 0 && tracker.GetDirtyRange().m_End == 16);
+}
+
+ETH_TEST(TlasInstanceTracker, UnchangedInstancesNeedNoUpdate)
+{
+    TlasInstanceTracker tracker;
+    const std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+    Update(tracker, instances);
+
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::None);
+    ETH_CHECK(tracker.GetDirtyRange().IsEmpty());
+}
+
+ETH_TEST(TlasInstanceTracker, TransformChangeRefits)
+{
+    TlasInstanceTracker tracker;
+    std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+    Update(tracker, instances);
+
+    instances[5].m_Transform[1][3] += 2.0f;
+    instances[9].m_Transform[0][0] = 0.5f;
+
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Refit);
+    ETH_CHECK(tracker.GetDirtyRange().m_Begin == 5 && tracker.GetDirtyRange().m_End == 10);
+    ETH_CHECK(tracker.GetInstances()[5].m_Transform[1][3] == instances[5].m_Transform[1][3]);
+}
+
+ETH_TEST(TlasInstanceTracker, InstanceIdAndMaskChangesRefit)
+{
+    TlasInstanceTracker tracker;
+    std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+    Update(tracker, instances);
+
+    instances[2].m_InstanceID = 100;
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Refit);
+
+    instances[3].m_InstanceMask = 0x01;
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Refit);
+    ETH_CHECK(tracker.GetDirtyRange().m_Begin == 3 && tracker.GetDirtyRange().m_End == 4);
+}
+
+ETH_TEST(TlasInstanceTracker, CountChangeRebuilds)
+{
+    TlasInstanceTracker tracker;
+    std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+    Update(tracker, instances);
+
+    instances = CreateInstances(17);
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Rebuild);
+    ETH_CHECK(tracker.GetNumInstances() == 17);
+
+    instances.pop_back();
+    instances.pop_back();
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Rebuild);
+    ETH_CHECK(tracker.GetNumInstances() == 15);
+    ETH_CHECK(tracker.GetDirtyRange().m_Begin == 0 && tracker.GetDirtyRange().m_End == 15);
+}
+
+ETH_TEST(TlasInstanceTracker, BlasChangeRebuilds)
+{
+    TlasInstanceTracker tracker;
+    std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+    Update(tracker, instances);
+
+    // Also when the transform changes in the same update, which alone would be a refit
+    instances[7].m_AccelerationStructure = 0x90000;
+    instances[8].m_Transform[0][3] += 1.0f;
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Rebuild);
+    ETH_CHECK(tracker.GetInstances()[7].m_AccelerationStructure == 0x90000);
+}
+
+ETH_TEST(TlasInstanceTracker, FlagChangeRebuilds)
+{
+    TlasInstanceTracker tracker;
+    std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+    Update(tracker, instances);
+
+    instances[15].m_Flags = 0x4;
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Rebuild);
+}
+
+ETH_TEST(TlasInstanceTracker, InvalidateForcesRebuild)
+{
+    TlasInstanceTracker tracker;
+    const std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+    Update(tracker, instances);
+
+    tracker.Invalidate();
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Rebuild);
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::None);
+}
+
+ETH_TEST(TlasInstanceTracker, RebuildsAfterMaxRefits)
+{
+    TlasInstanceTracker tracker;
+    std::vector<RhiRaytracingInstanceDesc> instances = CreateInstances(16);
+    Update(tracker, instances);
+
+    for (uint32_t i = 1; i <= MaxRefitsBeforeRebuild; ++i)
+    {
+        instances[0].m_Transform[0][3] = static_cast<float>(i);
+        const TlasUpdateType type = Update(tracker, instances);
+        ETH_CHECK_MSG(type == TlasUpdateType::Refit, "Update {} was not a refit", i);
+    }
+
+    // Frames without changes do not count towards the limit
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::None);
+
+    instances[0].m_Transform[0][3] = -1.0f;
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Rebuild);
+
+    // The count starts over after the forced rebuild
+    instances[0].m_Transform[0][3] = -2.0f;
+    ETH_CHECK(Update(tracker, instances) == TlasUpdateType::Refit);
+}
@@ -0,0 +1,78 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testframework.h"
+
+#include <chrono>
+#include <cstdio>
+
+/*
+    Runs every registered test, or only the ones whose "Suite.Name" contains the filter.
+    Returns 0 when every test passed.
+
+    Usage: UnitTests [filter]
+*/
+int main(int argc, char** argv)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const char* filter = argc >= 2 ? argv[1] : "";
+    uint32_t numRun = 0;
+    std::vector<std::string> failedTests;
+
+    for (const Ether::Test::TestCase& test : Ether::Test::GetTestCases())
+    {
+        const std::string fullName = std::string(test.m_Suite) + "." + test.m_Name;
+        if (fullName.find(filter) == std::string::npos)
+            continue;
+
+        std::printf("[ RUN    ] %s\n", fullName.c_str());
+        std::fflush(stdout);
+
+        const uint32_t numFailuresBefore = Ether::Test::GetNumFailures();
+        const Clock::time_point start = Clock::now();
+
+        try
+        {
+            test.m_Func();
+        }
+        catch (const Ether::Test::TestAbort&)
+        {
+        }
+        catch (const std::exception& e)
+        {
+            Ether::Test::ReportFailure(nullptr, 0, std::string("Unexpected exception: ") + e.what());
+        }
+
+        const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        const bool passed = Ether::Test::GetNumFailures() == numFailuresBefore;
+        std::printf("[ %s ] %s (%.1f ms)\n", passed ? "    OK" : "FAILED", fullName.c_str(), milliseconds);
+
+        if (!passed)
+            failedTests.push_back(fullName);
+
+        numRun++;
+    }
+
+    std::printf("\n%u tests run, %zu failed\n", numRun, failedTests.size());
+    for (const std::string& name : failedTests)
+        std::printf("    %s\n", name.c_str());
+
+    return failedTests.empty() && numRun > 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testframework.h"
+
+static uint32_t s_NumFailures = 0;
+
+Ether::Test::TestRegistrar::TestRegistrar(const char* suite, const char* name, TestFunc func)
+{
+    GetTestCases().push_back({ suite, name, func });
+}
+
+std::vector<Ether::Test::TestCase>& Ether::Test::GetTestCases()
+{
+    // Function local, since registrars in other translation units may run first
+    static std::vector<TestCase> testCases;
+    return testCases;
+}
+
+void Ether::Test::ReportFailure(const char* file, int line, const std::string& message)
+{
+    if (file == nullptr)
+        std::printf("    %s\n", message.c_str());
+    else
+        std::printf("    %s(%d): %s\n", file, line, message.c_str());
+
+    s_NumFailures++;
+}
+
+uint32_t Ether::Test::GetNumFailures()
+{
+    return s_NumFailures;
+}
@@ -0,0 +1,103 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "common/common.h"
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+    Minimal unit test registry for the UnitTests executable, which ctest runs after every build.
+    Tests register themselves at static initialization time:
+
+        ETH_TEST(TlsfAllocator, FreeMergesNeighbours)
+        {
+            ETH_CHECK(allocator.GetFreeSize() == 0);
+            ETH_REQUIRE(allocation.IsValid());  // Stops the test on failure
+        }
+
+    Tests only cover code that runs without a GPU or a window. Anything that needs the engine loop
+    is checked by the benchmark harness instead (see tools/benchmarkharness).
+*/
+namespace Ether::Test
+{
+using TestFunc = void (*)();
+
+struct TestCase
+{
+    const char* m_Suite;
+    const char* m_Name;
+    TestFunc m_Func;
+};
+
+// Thrown by ETH_REQUIRE to abandon the rest of the test
+class TestAbort : public std::runtime_error
+{
+public:
+    TestAbort()
+        : std::runtime_error("Required check failed")
+    {
+    }
+};
+
+class TestRegistrar
+{
+public:
+    TestRegistrar(const char* suite, const char* name, TestFunc func);
+};
+
+std::vector<TestCase>& GetTestCases();
+
+// Failures are attributed to the test that is currently running. The file may be null.
+void ReportFailure(const char* file, int line, const std::string& message);
+uint32_t GetNumFailures();
+} // namespace Ether::Test
+
+#define ETH_TEST(suite, name)                                                                                       \
+    static void EthTest_##suite##_##name();                                                                         \
+    static Ether::Test::TestRegistrar s_EthTestRegistrar_##suite##_##name(#suite, #name, &EthTest_##suite##_##name); \
+    static void EthTest_##suite##_##name()
+
+#define ETH_CHECK(cond)                                                 \
+    do                                                                  \
+    {                                                                   \
+        if (!(cond))                                                    \
+            Ether::Test::ReportFailure(__FILE__, __LINE__, #cond);      \
+    } while (0)
+
+// Same as ETH_CHECK, with a message built from std::format arguments
+#define ETH_CHECK_MSG(cond, ...)                                                                          \
+    do                                                                                                    \
+    {                                                                                                     \
+        if (!(cond))                                                                                      \
+            Ether::Test::ReportFailure(__FILE__, __LINE__, std::string(#cond) + " - " + std::format(__VA_ARGS__)); \
+    } while (0)
+
+#define ETH_REQUIRE(cond)                                               \
+    do                                                                  \
+    {                                                                   \
+        if (!(cond))                                                    \
+        {                                                               \
+            Ether::Test::ReportFailure(__FILE__, __LINE__, #cond);      \
+            throw Ether::Test::TestAbort();                             \
+        }                                                               \
+    } while (0)
@@ -277,6 +277,7 @@ Ether::StringID Ether::Toolmode::AssetImporter::ProcessTexture(
     gfxTexture.SetHeight(static_cast<uint32_t>(h));
     gfxTexture.SetData(downscaleOutput, genMips);
     gfxTexture.Serialize(ofstream);
+    stbi_image_free(image);
 
     m_PathToGuidMap[texturePath] = gfxTexture.GetGuid();
     return gfxTexture.GetGuid();
@@ -24,13 +24,17 @@
 
 #include "toolmode/ipc/command/asset/importassetcommand.h"
 
-// #include "toolmode/ipc/command/ecs/gettoplevelentitiescommand.h"
-// #include "toolmode/ipc/command/ecs/getcomponentscommand.h"
-// #include "toolmode/ipc/command/ecs/setcomponentcommand.h"
-//
+#include "toolmode/ipc/command/ecs/getcomponentschemacommand.h"
+#include "toolmode/ipc/command/ecs/getcomponentscommand.h"
+#include "toolmode/ipc/command/ecs/getentitiescommand.h"
+#include "toolmode/ipc/command/ecs/setcomponentcommand.h"
+#include "toolmode/ipc/command/ecs/setfieldscommand.h"
+#include "toolmode/ipc/command/ecs/subscribecomponentscommand.h"
+
 // #include "toolmode/ipc/command/state/viewport/setdrawmodecommand.h"
 
 #define REGISTER_COMMAND(id, T) RegisterCommand(id, [](const CommandData* data) { return std::make_unique<T>(data); })
+#define REGISTER_BINARY_COMMAND(type, T) RegisterBinaryCommand(type, [](const IpcMessage& message) { return std::make_unique<T>(message); })
 
 Ether::Toolmode::CommandFactory::CommandFactory()
 {
@@ -40,10 +44,13 @@ Ether::Toolmode::CommandFactory::CommandFactory()
     // Asset
     REGISTER_COMMAND("importasset", ImportAssetCommand);
 
-    //// ECS
-    // REGISTER_COMMAND("gettoplevelentities", GetTopLevelEntitiesCommand);
-    // REGISTER_COMMAND("getcomponents", GetComponentsCommand);
-    // REGISTER_COMMAND("setcomponent", SetComponentCommand);
+    // ECS
+    REGISTER_COMMAND("getcomponentschema", GetComponentSchemaCommand);
+    REGISTER_COMMAND("getcomponents", GetComponentsCommand);
+    REGISTER_COMMAND("setcomponent", SetComponentCommand);
+    REGISTER_BINARY_COMMAND(GetEntitiesCommand::MessageType, GetEntitiesCommand);
+    REGISTER_BINARY_COMMAND(SubscribeComponentsCommand::MessageType, SubscribeComponentsCommand);
+    REGISTER_BINARY_COMMAND(SetFieldsCommand::MessageType, SetFieldsCommand);
 
     //// State
     // REGISTER_COMMAND("setdrawmode", SetDrawModeCommand);
@@ -59,6 +66,14 @@ std::unique_ptr<Ether::Toolmode::Command> Ether::Toolmode::CommandFactory::Creat
     return (m_FactoryMap.find(commandID)->second)(data);
 }
 
+std::unique_ptr<Ether::Toolmode::Command> Ether::Toolmode::CommandFactory::CreateCommand(const IpcMessage& message) const
+{
+    if (m_BinaryFactoryMap.find(message.GetMessageType()) == m_BinaryFactoryMap.end())
+        return nullptr;
+
+    return (m_BinaryFactoryMap.find(message.GetMessageType())->second)(message);
+}
+
 void Ether::Toolmode::CommandFactory::RegisterCommand(const std::string& commandID, FactoryFunction factoryFunction)
 {
     AssertToolmode(
@@ -68,3 +83,13 @@ void Ether::Toolmode::CommandFactory::RegisterCommand(const std::string& command
 
     m_FactoryMap[commandID] = factoryFunction;
 }
+
+void Ether::Toolmode::CommandFactory::RegisterBinaryCommand(uint32_t messageType, BinaryFactoryFunction factoryFunction)
+{
+    AssertToolmode(
+        m_BinaryFactoryMap.find(messageType) == m_BinaryFactoryMap.end(),
+        "The binary command 0x%08x has already been registered",
+        messageType);
+
+    m_BinaryFactoryMap[messageType] = factoryFunction;
+}
@@ -21,6 +21,7 @@
 
 #include "toolmode/pch.h"
 #include "toolmode/ipc/command/command.h"
+#include "common/ipc/ipcmessage.h"
 
 namespace Ether::Toolmode
 {
@@ -31,13 +32,17 @@ namespace Ether::Toolmode
         ~CommandFactory() = default;
 
         std::unique_ptr<Command> CreateCommand(const std::string& commandID, const CommandData* command) const;
+        std::unique_ptr<Command> CreateCommand(const IpcMessage& message) const;
 
     private:
         using FactoryFunction = std::function<std::unique_ptr<Command>(const CommandData* data)>;
+        using BinaryFactoryFunction = std::function<std::unique_ptr<Command>(const IpcMessage& message)>;
         void RegisterCommand(const std::string& commandID, FactoryFunction factoryFunction);
+        void RegisterBinaryCommand(uint32_t messageType, BinaryFactoryFunction factoryFunction);
 
     private:
         std::unordered_map<std::string, FactoryFunction> m_FactoryMap;
+        std::unordered_map<uint32_t, BinaryFactoryFunction> m_BinaryFactoryMap;
     };
 }
 
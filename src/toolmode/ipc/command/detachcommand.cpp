@@ -19,6 +19,7 @@
 
 #include "toolmode/ipc/command/detachcommand.h"
 #include "toolmode/ipc/ipcmanager.h"
+#include "toolmode/property/componentsync.h"
 
 Ether::Toolmode::DetachCommand::DetachCommand(const CommandData* data)
 {
@@ -29,5 +30,7 @@ void Ether::Toolmode::DetachCommand::Execute()
     LogToolmodeInfo("Detaching from editor");
     SetParentWindow(nullptr);
     HideWindow();
+
+    ComponentSync::Instance().Unsubscribe();
 }
 
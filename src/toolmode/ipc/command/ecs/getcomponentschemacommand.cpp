@@ -0,0 +1,56 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "toolmode/ipc/command/ecs/getcomponentschemacommand.h"
+#include "toolmode/ipc/ipcmanager.h"
+
+Ether::Toolmode::GetComponentSchemaCommand::GetComponentSchemaCommand(const CommandData* data)
+{
+}
+
+void Ether::Toolmode::GetComponentSchemaCommand::Execute()
+{
+    IpcManager::Instance().QueueOutgoingCommand(std::make_unique<ComponentSchemaCommandResponse>());
+}
+
+std::string Ether::Toolmode::ComponentSchemaCommandResponse::GetSendableData() const
+{
+    Ecs::EcsComponentManager& componentManager = GetActiveWorld().GetEcsManager().GetComponentManager();
+
+    CommandData components = CommandData::array();
+    for (uint32_t componentID = 0; componentID < componentManager.GetNumComponentTypes(); ++componentID)
+    {
+        const Ecs::EcsComponentInfo& info = componentManager.GetComponentArray(componentID).GetComponentInfo();
+
+        CommandData fields = CommandData::array();
+        for (const Ecs::EcsFieldInfo& field : info.m_Fields)
+            fields.push_back({ { "name", field.m_Name }, { "type", Ecs::GetEcsFieldTypeName(field.m_Type) } });
+
+        components.push_back({ { "id", componentID }, { "name", info.m_Name }, { "fields", fields } });
+    }
+
+    CommandData command = {
+        { "command", "componentschema" },
+        { "args", {
+            { "components", components }
+        }}
+    };
+
+    return command.dump();
+}
@@ -0,0 +1,68 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "toolmode/ipc/command/ecs/getcomponentscommand.h"
+#include "toolmode/ipc/ipcmanager.h"
+#include "toolmode/property/componentproperties.h"
+
+Ether::Toolmode::GetComponentsCommand::GetComponentsCommand(const CommandData* data)
+    : m_EntityID((*data)["args"]["entity"])
+{
+}
+
+void Ether::Toolmode::GetComponentsCommand::Execute()
+{
+    IpcManager::Instance().QueueOutgoingCommand(std::make_unique<GetComponentsCommandResponse>(m_EntityID));
+}
+
+Ether::Toolmode::GetComponentsCommandResponse::GetComponentsCommandResponse(Ecs::EntityID entityID)
+    : m_EntityID(entityID)
+{
+}
+
+std::string Ether::Toolmode::GetComponentsCommandResponse::GetSendableData() const
+{
+    Ecs::EcsComponentManager& componentManager = GetActiveWorld().GetEcsManager().GetComponentManager();
+
+    CommandData components = CommandData::array();
+    for (uint32_t componentID = 0; componentID < componentManager.GetNumComponentTypes(); ++componentID)
+    {
+        Ecs::EcsComponentArrayBase& componentArray = componentManager.GetComponentArray(componentID);
+        const void* component = componentArray.GetComponentData(m_EntityID);
+        if (component == nullptr)
+            continue;
+
+        const Ecs::EcsComponentInfo& info = componentArray.GetComponentInfo();
+        components.push_back({
+            { "id", componentID },
+            { "name", info.m_Name },
+            { "fields", ComponentProperties::GetFields(info, component) },
+        });
+    }
+
+    CommandData command = {
+        { "command", "getcomponents" },
+        { "args", {
+            { "entity", m_EntityID },
+            { "components", components }
+        }}
+    };
+
+    return command.dump();
+}
@@ -20,40 +20,33 @@
 #pragma once
 
 #include "toolmode/pch.h"
-#include "toolmode/property/field.h"
+#include "toolmode/ipc/command/incomingcommand.h"
+#include "toolmode/ipc/command/outgoingcommand.h"
 
 namespace Ether::Toolmode
 {
-    class Vector3Field : public Field
+    // The property view of every component of an entity
+    class GetComponentsCommand : public IncomingCommand
     {
     public:
-        Vector3Field(const std::string& name, const ethVector3& data)
-            : Field(name)
-            , m_Data(&data)
-        {
-        }
-        ~Vector3Field() = default;
-
-        std::string GetData() override
-        {
-            nlohmann::json data;
-            data["name"] = m_Name;
-            data["type"] = "Vector3";
-            data["values"][0] = m_Data->x;
-            data["values"][1] = m_Data->y;
-            data["values"][2] = m_Data->z;
-            return data.dump();
-        }
-
-        void SetData(const nlohmann::json& data) override
-        {
-            m_Data->x = data["values"][0];
-            m_Data->y = data["values"][1];
-            m_Data->z = data["values"][2];
-        }
+        GetComponentsCommand(const CommandData* data = nullptr);
+        ~GetComponentsCommand() override = default;
+
+        void Execute() override;
 
     private:
-        ethVector3* const m_Data;
+        Ecs::EntityID m_EntityID;
     };
-}
 
+    class GetComponentsCommandResponse : public OutgoingCommand
+    {
+    public:
+        GetComponentsCommandResponse(Ecs::EntityID entityID);
+        ~GetComponentsCommandResponse() = default;
+
+        std::string GetSendableData() const override;
+
+    private:
+        Ecs::EntityID m_EntityID;
+    };
+}
@@ -0,0 +1,50 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "toolmode/ipc/command/ecs/getentitiescommand.h"
+#include "toolmode/ipc/ipcmanager.h"
+#include "engine/world/ecs/components/ecsmetadatacomponent.h"
+
+Ether::Toolmode::GetEntitiesCommand::GetEntitiesCommand(const IpcMessage& message)
+{
+}
+
+void Ether::Toolmode::GetEntitiesCommand::Execute()
+{
+    Ecs::EcsManager& ecsManager = GetActiveWorld().GetEcsManager();
+    Ecs::EcsComponentManager& componentManager = ecsManager.GetComponentManager();
+
+    // Every entity has metadata, so its array holds all of the live entities
+    Ecs::EcsComponentArrayBase& metadataArray = componentManager.GetComponentArray(
+        componentManager.GetTypeID<Ecs::EcsMetadataComponent>());
+
+    const uint32_t numEntities = metadataArray.GetNumComponents();
+    IpcMessage response(MessageType, SchemaVersion);
+    uint32_t* entities = reinterpret_cast<uint32_t*>(
+        response.AddSection(EntitiesSectionTag, numEntities * 2 * sizeof(uint32_t)));
+
+    for (uint32_t i = 0; i < numEntities; ++i)
+    {
+        const Ecs::EntityID entityID = metadataArray.GetEntityAt(i);
+        entities[i * 2 + 0] = entityID;
+        entities[i * 2 + 1] = static_cast<uint32_t>(ecsManager.GetEntityManager().GetSignature(entityID).to_ulong());
+    }
+
+    IpcManager::Instance().QueueOutgoingMessage(std::move(response));
+}
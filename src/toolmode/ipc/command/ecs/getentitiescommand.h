@@ -0,0 +1,43 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "toolmode/pch.h"
+#include "toolmode/ipc/command/incomingcommand.h"
+#include "common/ipc/ipcmessage.h"
+
+namespace Ether::Toolmode
+{
+    // Replies with the same message type, and a section of { uint32 entityID, uint32 signature } pairs.
+    // Bit i of the signature is set if the entity has the component with ID i.
+    class GetEntitiesCommand : public IncomingCommand
+    {
+    public:
+        GetEntitiesCommand(const IpcMessage& message);
+        ~GetEntitiesCommand() override = default;
+
+        void Execute() override;
+
+    public:
+        static constexpr uint32_t MessageType = MakeIpcTag('E', 'E', 'N', 'T');
+        static constexpr uint32_t EntitiesSectionTag = MakeIpcTag('E', 'N', 'T', 'S');
+        static constexpr uint16_t SchemaVersion = 1;
+    };
+}
@@ -0,0 +1,55 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "toolmode/ipc/command/ecs/setcomponentcommand.h"
+#include "toolmode/property/componentproperties.h"
+#include "toolmode/property/componentsync.h"
+
+Ether::Toolmode::SetComponentCommand::SetComponentCommand(const CommandData* data)
+    : m_EntityID((*data)["args"]["entity"])
+    , m_ComponentID((*data)["args"]["component"])
+    , m_Fields((*data)["args"]["fields"])
+{
+}
+
+void Ether::Toolmode::SetComponentCommand::Execute()
+{
+    Ecs::EcsComponentManager& componentManager = GetActiveWorld().GetEcsManager().GetComponentManager();
+    if (m_ComponentID >= componentManager.GetNumComponentTypes())
+    {
+        LogToolmodeWarning("Cannot set fields of unknown component %zu", m_ComponentID);
+        return;
+    }
+
+    Ecs::EcsComponentArrayBase& componentArray = componentManager.GetComponentArray(m_ComponentID);
+    void* component = componentArray.GetComponentData(m_EntityID);
+    if (component == nullptr)
+    {
+        LogToolmodeWarning("Entity %u does not have a %s component", m_EntityID, componentArray.GetComponentInfo().m_Name);
+        return;
+    }
+
+    const uint32_t fieldMask = ComponentProperties::SetFields(componentArray.GetComponentInfo(), component, m_Fields);
+    if (fieldMask == 0)
+        return;
+
+    // Systems cache what they derive from components, e.g. the visual system's world matrices
+    GetActiveWorld().GetEcsManager().GetSystemManager().OnComponentModified(m_EntityID, m_ComponentID);
+    ComponentSync::Instance().MarkSynchronized(m_ComponentID, m_EntityID, fieldMask);
+}
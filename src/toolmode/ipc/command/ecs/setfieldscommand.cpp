@@ -0,0 +1,34 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "toolmode/ipc/command/ecs/setfieldscommand.h"
+#include "toolmode/property/componentsync.h"
+
+Ether::Toolmode::SetFieldsCommand::SetFieldsCommand(const IpcMessage& message)
+{
+    // Copied out, as the message is gone by the time the command executes
+    const IpcSection section = message.FindSection(ComponentSync::DeltaSectionTag);
+    m_Delta.assign(section.m_Data, section.m_Data + section.m_Size);
+}
+
+void Ether::Toolmode::SetFieldsCommand::Execute()
+{
+    if (!ComponentSync::Instance().ApplyFields(m_Delta.data(), m_Delta.size()))
+        LogToolmodeWarning("Received malformed field data from the editor, some fields might not have been set");
+}
@@ -3,7 +3,7 @@
 
     Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
 
-    Ether is free software: you can redistribute it jand/or modify
+    Ether is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
     the Free Software Foundation, either version 3 of the License, or
     (at your option) any later version.
@@ -20,38 +20,25 @@
 #pragma once
 
 #include "toolmode/pch.h"
-#include "toolmode/property/field.h"
+#include "toolmode/ipc/command/incomingcommand.h"
+#include "common/ipc/ipcmessage.h"
 
 namespace Ether::Toolmode
 {
-    class Vector2Field : public Field
+    // Sets any number of fields at once. The payload uses the same encoding as the component sync
+    // updates (see EcsDeltaWriter).
+    class SetFieldsCommand : public IncomingCommand
     {
     public:
-        Vector2Field(const std::string& name, const ethVector2& data)
-            : Field(name)
-            , m_Data(&data)
-        {
-        }
-        ~Vector2Field() = default;
-
-        std::string GetData() override
-        {
-            nlohmann::json data;
-            data["name"] = m_Name;
-            data["type"] = "Vector2";
-            data["values"][0] = m_Data->x;
-            data["values"][1] = m_Data->y;
-            return data.dump();
-        }
-
-        void SetData(const nlohmann::json& data) override
-        {
-            m_Data->x = data["values"][0];
-            m_Data->y = data["values"][1];
-        }
+        SetFieldsCommand(const IpcMessage& message);
+        ~SetFieldsCommand() override = default;
+
+        void Execute() override;
+
+    public:
+        static constexpr uint32_t MessageType = MakeIpcTag('E', 'S', 'E', 'T');
 
     private:
-        ethVector2* const m_Data;
+        std::vector<uint8_t> m_Delta;
     };
 }
-
@@ -20,26 +20,21 @@
 #pragma once
 
 #include "toolmode/pch.h"
-#include "parser/json/json.hpp"
+#include "toolmode/ipc/command/incomingcommand.h"
+#include "common/ipc/ipcmessage.h"
 
 namespace Ether::Toolmode
 {
-    class Field
+    // Starts the component sync, which first sends a full snapshot of all components
+    class SubscribeComponentsCommand : public IncomingCommand
     {
     public:
-        Field(const std::string& name = "Unnamed Property")
-            : m_Name(name)
-        {
-        }
+        SubscribeComponentsCommand(const IpcMessage& message);
+        ~SubscribeComponentsCommand() override = default;
 
-        virtual std::string GetData() = 0;
-        virtual void SetData(const nlohmann::json& data) = 0;
+        void Execute() override;
 
     public:
-        inline const std::string& GetName() const { return m_Name; }
-
-    protected:
-        std::string m_Name;
+        static constexpr uint32_t MessageType = MakeIpcTag('E', 'S', 'U', 'B');
     };
 }
-
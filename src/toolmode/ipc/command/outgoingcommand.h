@@ -21,6 +21,8 @@
 
 #include "toolmode/pch.h"
 #include "toolmode/ipc/command/command.h"
+#include "common/ipc/ipcmessage.h"
+#include "common/ipc/ipcsender.h"
 
 namespace Ether::Toolmode
 {
@@ -31,6 +33,13 @@ namespace Ether::Toolmode
         virtual ~OutgoingCommand() = 0;
 
         virtual std::string GetSendableData() const = 0;
+
+        // Responses go out as JSON unless the command provides a binary message of its own
+        virtual IpcMessage GetIpcMessage() const { return IpcMessage::FromJson(GetSendableData()); }
+
+        // High rate updates can opt into being dropped or coalesced when the editor falls behind
+        virtual IpcSendPolicy GetSendPolicy() const { return IpcSendPolicy::Block; }
+        virtual uint64_t GetCoalesceKey() const { return 0; }
     };
 }
 
@@ -20,7 +20,9 @@
 #pragma once
 
 #include "toolmode/pch.h"
-#include "toolmode/ipc/tcpsocket.h"
+#include "common/ipc/ipcmessage.h"
+#include "common/ipc/ipcsender.h"
+#include "common/ipc/ipctransport.h"
 #include "toolmode/ipc/command/commandfactory.h"
 #include "toolmode/ipc/command/incomingcommand.h"
 #include "toolmode/ipc/command/outgoingcommand.h"
@@ -35,30 +37,36 @@ namespace Ether::Toolmode
         ~IpcManager();
 
     public:
-        inline bool HasConnection() const { return m_Socket->HasActiveConnection(); }
+        inline bool HasConnection() const { return m_Transport != nullptr && m_Transport->HasActiveConnection(); }
 
     public:
-        void QueueIncomingCommand(std::shared_ptr<IncomingCommand>&& incomingCommand);
+        // The message the command was parsed from is kept, so that it can be recorded (see InputRecorder)
+        void QueueIncomingCommand(std::shared_ptr<IncomingCommand>&& incomingCommand, IpcMessage&& message = {});
         void QueueOutgoingCommand(std::shared_ptr<OutgoingCommand>&& outgoingCommand);
+
+        // For binary messages that are built directly, returns false if the message was dropped
+        bool QueueOutgoingMessage(IpcMessage&& message, IpcSendPolicy policy = IpcSendPolicy::Block, uint64_t coalesceKey = 0);
         void ProcessIncomingCommands();
-        void ProcessOutgoingCommands();
 
         void Connect();
         void Disconnect();
 
     private:
         void ClearCommandQueues();
-        std::shared_ptr<IncomingCommand> ParseMessage(const std::string& rawRequest) const;
+        void ProcessReplayedCommands();
+        std::shared_ptr<IncomingCommand> ParseMessage(const IpcMessage& message) const;
 
     private:
         void CommandListenerThread();
 
     private:
         CommandFactory m_CommandFactory;
-        std::unique_ptr<TcpSocket> m_Socket;
+        std::unique_ptr<IpcTransport> m_Transport;
+
+        // Declared after the transport, so that it stops writing before the transport goes away
+        IpcSender m_Sender;
 
-        std::queue<std::shared_ptr<IncomingCommand>> m_IncommingCommandQueue;
-        std::queue<std::shared_ptr<OutgoingCommand>> m_OutgoingCommandQueue;
+        std::queue<std::pair<std::shared_ptr<IncomingCommand>, IpcMessage>> m_IncommingCommandQueue;
 
         std::mutex m_IncomingCommandQueueMutex;
         std::thread m_IncomingCommandListener;
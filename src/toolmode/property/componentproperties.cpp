@@ -0,0 +1,133 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "toolmode/property/componentproperties.h"
+
+nlohmann::json Ether::Toolmode::ComponentProperties::GetField(const Ecs::EcsFieldInfo& field, const void* component)
+{
+    const void* data = field.GetData(component);
+
+    nlohmann::json property;
+    property["name"] = field.m_Name;
+    property["type"] = Ecs::GetEcsFieldTypeName(field.m_Type);
+
+    nlohmann::json& values = property["values"];
+    switch (field.m_Type)
+    {
+    case Ecs::EcsFieldType::Bool:
+        values[0] = *static_cast<const bool*>(data);
+        break;
+    case Ecs::EcsFieldType::UInt32:
+        values[0] = *static_cast<const uint32_t*>(data);
+        break;
+    case Ecs::EcsFieldType::Float:
+        values[0] = *static_cast<const float*>(data);
+        break;
+    case Ecs::EcsFieldType::Vector2:
+    case Ecs::EcsFieldType::Vector3:
+    case Ecs::EcsFieldType::Vector4:
+    {
+        // Vectors are tightly packed floats
+        const size_t numComponents = field.m_Type == Ecs::EcsFieldType::Vector2 ? 2 : field.m_Type == Ecs::EcsFieldType::Vector3 ? 3 : 4;
+        for (size_t i = 0; i < numComponents; ++i)
+            values[i] = static_cast<const float*>(data)[i];
+        break;
+    }
+    case Ecs::EcsFieldType::StringID:
+        values[0] = static_cast<const StringID*>(data)->GetString();
+        break;
+    case Ecs::EcsFieldType::String:
+        values[0] = *static_cast<const std::string*>(data);
+        break;
+    default:
+        break;
+    }
+
+    if (field.IsReadOnly())
+        property["properties"]["readonly"] = true;
+
+    return property;
+}
+
+nlohmann::json Ether::Toolmode::ComponentProperties::GetFields(const Ecs::EcsComponentInfo& info, const void* component)
+{
+    nlohmann::json fields = nlohmann::json::array();
+    for (const Ecs::EcsFieldInfo& field : info.m_Fields)
+        fields.push_back(GetField(field, component));
+
+    return fields;
+}
+
+uint32_t Ether::Toolmode::ComponentProperties::SetFields(
+    const Ecs::EcsComponentInfo& info,
+    void* component,
+    const nlohmann::json& fields)
+{
+    uint32_t fieldMask = 0;
+
+    for (const nlohmann::json& property : fields)
+    {
+        const std::string name = property["name"];
+        for (uint32_t i = 0; i < info.m_Fields.size(); ++i)
+        {
+            if (name != info.m_Fields[i].m_Name || info.m_Fields[i].IsReadOnly())
+                continue;
+
+            SetField(info.m_Fields[i], component, property["values"]);
+            fieldMask |= 1u << i;
+        }
+    }
+
+    return fieldMask;
+}
+
+void Ether::Toolmode::ComponentProperties::SetField(const Ecs::EcsFieldInfo& field, void* component, const nlohmann::json& values)
+{
+    void* data = field.GetData(component);
+
+    switch (field.m_Type)
+    {
+    case Ecs::EcsFieldType::Bool:
+        *static_cast<bool*>(data) = values[0];
+        break;
+    case Ecs::EcsFieldType::UInt32:
+        *static_cast<uint32_t*>(data) = values[0];
+        break;
+    case Ecs::EcsFieldType::Float:
+        *static_cast<float*>(data) = values[0];
+        break;
+    case Ecs::EcsFieldType::Vector2:
+    case Ecs::EcsFieldType::Vector3:
+    case Ecs::EcsFieldType::Vector4:
+    {
+        const size_t numComponents = field.m_Type == Ecs::EcsFieldType::Vector2 ? 2 : field.m_Type == Ecs::EcsFieldType::Vector3 ? 3 : 4;
+        for (size_t i = 0; i < numComponents; ++i)
+            static_cast<float*>(data)[i] = values[i];
+        break;
+    }
+    case Ecs::EcsFieldType::StringID:
+        *static_cast<StringID*>(data) = values[0].get<std::string>();
+        break;
+    case Ecs::EcsFieldType::String:
+        *static_cast<std::string*>(data) = values[0];
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,48 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "toolmode/pch.h"
+#include "engine/world/ecs/ecsreflection.h"
+#include "parser/json/json.hpp"
+
+namespace Ether::Toolmode
+{
+    /*
+        JSON view of the reflected fields of a component, for the editor's property panels. Each
+        field is shown as
+
+            { "name": "Translation", "type": "Vector3", "values": [ 0, 2, 0 ] }
+
+        with a "properties" object for anything extra, such as "readonly".
+    */
+    class ComponentProperties
+    {
+    public:
+        static nlohmann::json GetField(const Ecs::EcsFieldInfo& field, const void* component);
+        static nlohmann::json GetFields(const Ecs::EcsComponentInfo& info, const void* component);
+
+        // Fields are matched by name, returns the mask of the fields that were set
+        static uint32_t SetFields(const Ecs::EcsComponentInfo& info, void* component, const nlohmann::json& fields);
+
+    private:
+        static void SetField(const Ecs::EcsFieldInfo& field, void* component, const nlohmann::json& values);
+    };
+}
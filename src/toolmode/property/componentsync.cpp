@@ -0,0 +1,79 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "toolmode/property/componentsync.h"
+#include "toolmode/ipc/ipcmanager.h"
+#include "common/telemetry/telemetry.h"
+
+Ether::Toolmode::ComponentSync::ComponentSync()
+    : m_IsSubscribed(false)
+{
+}
+
+void Ether::Toolmode::ComponentSync::Update()
+{
+    if (!m_IsSubscribed || !IpcManager::Instance().HasConnection())
+        return;
+
+    ScopedTelemetry telemetry("Toolmode - Component Sync");
+    Ecs::EcsComponentManager& componentManager = GetActiveWorld().GetEcsManager().GetComponentManager();
+
+    m_DeltaBuffer.clear();
+    if (!m_DeltaTracker.CollectChanges(componentManager, m_DeltaBuffer))
+        return;
+
+    IpcMessage message(DeltaMessageType, DeltaSchemaVersion);
+    message.AddSection(DeltaSectionTag, m_DeltaBuffer.data(), m_DeltaBuffer.size());
+
+    // Only what was actually queued is considered sent, the rest goes out with the next update
+    if (IpcManager::Instance().QueueOutgoingMessage(std::move(message), IpcSendPolicy::Drop))
+        m_DeltaTracker.CommitChanges();
+}
+
+void Ether::Toolmode::ComponentSync::Subscribe()
+{
+    LogToolmodeInfo("Editor subscribed to component changes");
+
+    // Forgetting what was sent before makes the next update a full snapshot
+    m_DeltaTracker.Reset();
+    m_IsSubscribed = true;
+}
+
+void Ether::Toolmode::ComponentSync::Unsubscribe()
+{
+    m_DeltaTracker.Reset();
+    m_IsSubscribed = false;
+}
+
+bool Ether::Toolmode::ComponentSync::ApplyFields(const uint8_t* data, size_t size)
+{
+    Ecs::EcsComponentManager& componentManager = GetActiveWorld().GetEcsManager().GetComponentManager();
+
+    // Through the ECS manager, so that the systems pick up the new values
+    return GetActiveWorld().GetEcsManager().ApplyDelta(
+        data,
+        size,
+        [&](Ecs::ComponentID componentID, Ecs::EntityID entityID, uint32_t fieldMask)
+        { m_DeltaTracker.MarkSynchronized(componentManager, componentID, entityID, fieldMask); });
+}
+
+void Ether::Toolmode::ComponentSync::MarkSynchronized(Ecs::ComponentID componentID, Ecs::EntityID entityID, uint32_t fieldMask)
+{
+    m_DeltaTracker.MarkSynchronized(GetActiveWorld().GetEcsManager().GetComponentManager(), componentID, entityID, fieldMask);
+}
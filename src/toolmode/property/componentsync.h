@@ -0,0 +1,61 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "toolmode/pch.h"
+#include "common/ipc/ipcmessage.h"
+#include "engine/world/ecs/ecsdeltacodec.h"
+
+namespace Ether::Toolmode
+{
+    /*
+        Keeps the editor's view of the components up to date. Once subscribed, the editor gets the
+        full state of every component, and from then on only the fields that changed, once per frame.
+
+        Updates are sent as droppable messages, so a slow editor does not stall the engine. Changes
+        of dropped updates are sent with the next one.
+    */
+    class ComponentSync : public Singleton<ComponentSync>
+    {
+    public:
+        ComponentSync();
+        ~ComponentSync() = default;
+
+    public:
+        void Update();
+
+        void Subscribe();
+        void Unsubscribe();
+
+        // Fields set by the editor are not sent back to it
+        bool ApplyFields(const uint8_t* data, size_t size);
+        void MarkSynchronized(Ecs::ComponentID componentID, Ecs::EntityID entityID, uint32_t fieldMask);
+
+    public:
+        static constexpr uint32_t DeltaMessageType = MakeIpcTag('E', 'D', 'L', 'T');
+        static constexpr uint32_t DeltaSectionTag = MakeIpcTag('D', 'L', 'T', 'A');
+        static constexpr uint16_t DeltaSchemaVersion = 1;
+
+    private:
+        Ecs::EcsDeltaTracker m_DeltaTracker;
+        std::vector<uint8_t> m_DeltaBuffer;
+        bool m_IsSubscribed;
+    };
+}
@@ -19,9 +19,11 @@
 
 #include "toolmode/toolmain.h"
 #include "toolmode/ipc/ipcmanager.h"
+#include "toolmode/property/componentsync.h"
 #include "engine/platform/win32/ethwin.h"
 #include "engine/world/ecs/components/ecscameracomponent.h"
 #include "asset/assetimporter.h"
+#include "common/stream/packfile.h"
 #include <filesystem>
 #include "engine/world/ecs/components/ecsvisualcomponent.h"
 
@@ -49,7 +51,7 @@ void Ether::Toolmode::EtherHeadless::Initialize()
 //          this generates a library of .eres files. In practice, toolmode itself should serialize this library
 //          which could contain guid to type mappings, and could reload all the guids during toolmode runtime.
 //      - Build resource table
-//          this is simulated by blindly loading all .eres files and assuming them to be meshes
+//          this is simulated by packing all .eres files and loading everything in the pack
 //      - Create entity (menu > new > entity)
 //          simulated by creating entity object
 //      - Assign mesh to entity (through components)
@@ -90,17 +92,30 @@ void Ether::Toolmode::EtherHeadless::LoadContent()
 
         AssetImporter::Instance().ImportTexture(hdriPath);
 
-        // Load from library files and serialize to world
+        // Pack the library, so that it is loaded the way a runtime would load it, from one file rather
+        // than a file per resource
+        const std::string packPath = libraryPath + ".epak";
+        {
+            PackFileWriter packWriter(packPath);
+            for (const auto& entry : std::filesystem::directory_iterator(libraryPath))
+            {
+                if (entry.path().extension().string() != ".eres")
+                    continue;
+
+                packWriter.AddFile(entry.path().string(), PackCompression::Lz);
+            }
+
+            packWriter.Finalize();
+        }
+
+        // Load from the pack and serialize to world
         // This simulates user dragging resources from the editor resource browser into the scene,
         // then saving the world file.
         std::vector<std::unique_ptr<Graphics::Mesh>> meshes;
-        for (const auto& entry : std::filesystem::directory_iterator(libraryPath))
+        PackFileReader pack(packPath);
+        for (const PackEntryDesc& entry : pack.GetEntries())
         {
-            if (entry.path().extension().string() != ".eres")
-                continue;
-
-            IFileStream classIdStream(entry.path().string());
-            std::string classID = Serializable::DeserializeClassID(classIdStream);
+            const std::string& classID = entry.m_ClassID;
 
             static const StringID MeshClassID = StringID(ETH_CLASS_ID_MESH);
             static const StringID MaterialClassID = StringID(ETH_CLASS_ID_MATERIAL);
@@ -108,22 +123,22 @@ void Ether::Toolmode::EtherHeadless::LoadContent()
 
             if (classID == MeshClassID)
             {
-                IFileStream assetFileStream(entry.path().string());
+                std::unique_ptr<IByteStream> assetStream = pack.Read(entry);
                 meshes.emplace_back(std::make_unique<Graphics::Mesh>());
-                meshes.back()->Deserialize(assetFileStream);
+                meshes.back()->Deserialize(*assetStream);
             }
             else if (classID == MaterialClassID)
             {
-                IFileStream assetFileStream(entry.path().string());
+                std::unique_ptr<IByteStream> assetStream = pack.Read(entry);
                 std::unique_ptr<Graphics::Material> material = std::make_unique<Graphics::Material>();
-                material->Deserialize(assetFileStream);
+                material->Deserialize(*assetStream);
                 currentWorld.GetResourceManager().RegisterMaterialResource(std::move(material));
             }
             else if (classID == TextureClassID)
             {
-                IFileStream assetFileStream(entry.path().string());
+                std::unique_ptr<IByteStream> assetStream = pack.Read(entry);
                 std::unique_ptr<Graphics::Texture> texture = std::make_unique<Graphics::Texture>();
-                texture->Deserialize(assetFileStream);
+                texture->Deserialize(*assetStream);
                 currentWorld.GetResourceManager().RegisterTextureResource(std::move(texture));
             }
         }
@@ -135,11 +150,13 @@ void Ether::Toolmode::EtherHeadless::LoadContent()
             Ecs::EcsVisualComponent& visual = entity.GetComponent<Ecs::EcsVisualComponent>();
             visual.m_MeshGuid = mesh->GetGuid();
             visual.m_MaterialGuid = mesh->GetDefaultMaterialGuid();
+            entity.MarkModified<Ecs::EcsVisualComponent>();
             currentWorld.GetResourceManager().RegisterMeshResource(std::move(mesh));
         }
 
         Entity& cameraObj = currentWorld.CreateCamera();
         cameraObj.GetComponent<Ecs::EcsCameraComponent>().SetHdriTextureID(AssetImporter::Instance().GetAssetGuid(hdriPath));
+        cameraObj.MarkModified<Ecs::EcsCameraComponent>();
 
         currentWorld.SetWorldName(exportWorldName);
         currentWorld.Save(sceneSavePath);
@@ -152,10 +169,11 @@ void Ether::Toolmode::EtherHeadless::LoadContent()
     if (PathUtils::GetFileExtension(sceneLoadPath) == ".ether")
         currentWorld.Load(sceneLoadPath);
 
-    Entity& cameraObj = currentWorld.CreateCamera();
-    m_CameraTransform = &cameraObj.GetComponent<Ecs::EcsTransformComponent>();
-    m_CameraTransform->m_Translation = { 0, 2, 0 };
-    m_CameraTransform->m_Rotation = { 0, SMath::DegToRad(-90.0f), 0 };
+    m_Camera = &currentWorld.CreateCamera();
+    Ecs::EcsTransformComponent& transform = m_Camera->GetComponent<Ecs::EcsTransformComponent>();
+    transform.m_Translation = { 0, 2, 0 };
+    transform.m_Rotation = { 0, SMath::DegToRad(-90.0f), 0 };
+    m_Camera->MarkModified<Ecs::EcsTransformComponent>();
 }
 
 void Ether::Toolmode::EtherHeadless::UnloadContent()
@@ -169,10 +187,12 @@ void Ether::Toolmode::EtherHeadless::Shutdown()
 void Ether::Toolmode::EtherHeadless::OnUpdate(const Ether::UpdateEventArgs& e)
 {
     IpcManager::Instance().ProcessIncomingCommands();
-    IpcManager::Instance().ProcessOutgoingCommands();
 
     UpdateGraphicConfig();
     UpdateCamera();
+
+    // After everything that edits components this frame
+    ComponentSync::Instance().Update();
 }
 
 void Ether::Toolmode::EtherHeadless::OnRender(const Ether::RenderEventArgs& e)
@@ -222,6 +242,8 @@ void Ether::Toolmode::EtherHeadless::UpdateGraphicConfig() const
 
 void Ether::Toolmode::EtherHeadless::UpdateCamera() const
 {
+    Ecs::EcsTransformComponent& transform = m_Camera->GetComponent<Ecs::EcsTransformComponent>();
+
     static ethVector3 cameraRotation;
     static float moveSpeed = 1.0f;
 
@@ -232,35 +254,37 @@ void Ether::Toolmode::EtherHeadless::UpdateCamera() const
 
     if (Input::GetMouseButton(2))
     {
-        m_CameraTransform->m_Rotation.x += Input::GetMouseDeltaY() / 500;
-        m_CameraTransform->m_Rotation.y += Input::GetMouseDeltaX() / 500;
-        m_CameraTransform->m_Rotation.x = std::clamp(
-            m_CameraTransform->m_Rotation.x,
+        transform.m_Rotation.x += Input::GetMouseDeltaY() / 500;
+        transform.m_Rotation.y += Input::GetMouseDeltaX() / 500;
+        transform.m_Rotation.x = std::clamp(
+            transform.m_Rotation.x,
             -SMath::DegToRad(89.0f),
             SMath::DegToRad(89.0f));
     }
 
     if (Input::GetKey((KeyCode)Win32::KeyCode::E))
-        m_CameraTransform->m_Translation.y += Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation.y += Time::GetDeltaTime() * moveSpeed;
 
     if (Input::GetKey((KeyCode)Win32::KeyCode::Q))
-        m_CameraTransform->m_Translation.y -= Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation.y -= Time::GetDeltaTime() * moveSpeed;
 
-    ethMatrix4x4 rotation = Transform::GetRotationMatrix(m_CameraTransform->m_Rotation);
+    ethMatrix4x4 rotation = Transform::GetRotationMatrix(transform.m_Rotation);
     ethVector3 forward = (rotation * ethVector4(0, 0, 1, 0)).Resize<3>().Normalized();
     ethVector3 upVec = { 0, 1, 0 };
     ethVector3 rightVec = ethVector3::Cross(upVec, forward).Normalized();
 
     if (Input::GetKey((KeyCode)Win32::KeyCode::W))
-        m_CameraTransform->m_Translation = m_CameraTransform->m_Translation +
-                                           forward * Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation = transform.m_Translation +
+                                forward * Time::GetDeltaTime() * moveSpeed;
     if (Input::GetKey((KeyCode)Win32::KeyCode::A))
-        m_CameraTransform->m_Translation = m_CameraTransform->m_Translation -
-                                           rightVec * Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation = transform.m_Translation -
+                                rightVec * Time::GetDeltaTime() * moveSpeed;
     if (Input::GetKey((KeyCode)Win32::KeyCode::S))
-        m_CameraTransform->m_Translation = m_CameraTransform->m_Translation -
-                                           forward * Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation = transform.m_Translation -
+                                forward * Time::GetDeltaTime() * moveSpeed;
     if (Input::GetKey((KeyCode)Win32::KeyCode::D))
-        m_CameraTransform->m_Translation = m_CameraTransform->m_Translation +
-                                           rightVec * Time::GetDeltaTime() * moveSpeed;
+        transform.m_Translation = transform.m_Translation +
+                                rightVec * Time::GetDeltaTime() * moveSpeed;
+
+    m_Camera->MarkModified<Ecs::EcsTransformComponent>();
 }
@@ -42,7 +42,7 @@ namespace Ether::Toolmode
         void UpdateCamera() const;
 
     private:
-        Ether::Ecs::EcsTransformComponent* m_CameraTransform;
+        Ether::Entity* m_Camera;
     };
 }
 
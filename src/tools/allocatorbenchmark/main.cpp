@@ -0,0 +1,159 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/common.h"
+#include "common/memory/freelistallocator.h"
+#include "common/memory/tlsfallocator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+    Compares the TLSF allocator with the free list allocator it replaced for descriptor heaps,
+    under a descriptor table like workload: mostly small ranges with the occasional large one,
+    allocated and freed in random order while the heap is kept at a target occupancy.
+
+    - Throughput:    average cost of an Allocate or Free call during the churn
+    - Failures:      allocations that did not fit even though the heap was not full
+    - Fragmentation: after the churn, 1 - (largest allocatable range / free space)
+
+    Usage: AllocatorBenchmark [operations] [occupancy percent]
+*/
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t Capacity = 1 << 20;
+static constexpr uint32_t RandomSeed = 1234;
+
+struct ChurnResult
+{
+    double m_NanosecondsPerOp;
+    uint32_t m_NumFailures;
+    size_t m_UsedSize;
+    size_t m_LargestAllocatable;
+};
+
+static size_t GetRandomSize(std::mt19937& random)
+{
+    // Descriptor tables are mostly a handful of entries, with the occasional large bindless range
+    if (std::uniform_int_distribution<uint32_t>(0, 99)(random) < 95)
+        return std::uniform_int_distribution<size_t>(1, 64)(random);
+
+    return std::uniform_int_distribution<size_t>(256, 8192)(random);
+}
+
+// Largest range that still fits, found through HasSpace
+static size_t FindLargestAllocatable(const Ether::MemoryAllocator& allocator)
+{
+    size_t low = 0;
+    size_t high = allocator.GetCapacity();
+
+    while (low < high)
+    {
+        const size_t mid = (low + high + 1) / 2;
+        if (allocator.HasSpace(mid))
+            low = mid;
+        else
+            high = mid - 1;
+    }
+
+    return low;
+}
+
+static ChurnResult RunChurn(Ether::MemoryAllocator& allocator, uint32_t numOperations, float occupancy)
+{
+    std::mt19937 random(RandomSeed);
+    std::vector<Ether::AllocationHandle> allocations;
+    allocations.reserve(Capacity / 16);
+
+    ChurnResult result = {};
+    const size_t targetUsedSize = static_cast<size_t>(Capacity * occupancy);
+
+    const Clock::time_point start = Clock::now();
+
+    for (uint32_t op = 0; op < numOperations; ++op)
+    {
+        if (allocations.empty() || result.m_UsedSize < targetUsedSize)
+        {
+            const Ether::AllocationHandle alloc = allocator.Allocate(GetRandomSize(random));
+            if (!alloc.IsValid())
+            {
+                result.m_NumFailures++;
+                continue;
+            }
+
+            allocations.push_back(alloc);
+            result.m_UsedSize += alloc.m_Size;
+        }
+        else
+        {
+            const size_t idx = std::uniform_int_distribution<size_t>(0, allocations.size() - 1)(random);
+            allocator.Free(allocations[idx]);
+            result.m_UsedSize -= allocations[idx].m_Size;
+            allocations[idx] = allocations.back();
+            allocations.pop_back();
+        }
+    }
+
+    result.m_NanosecondsPerOp = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numOperations;
+    result.m_LargestAllocatable = FindLargestAllocatable(allocator);
+    return result;
+}
+
+static void PrintResult(const char* name, const ChurnResult& result)
+{
+    const size_t freeSize = Capacity - result.m_UsedSize;
+    const double fragmentation = freeSize > 0 ? 1.0 - static_cast<double>(result.m_LargestAllocatable) / freeSize : 0.0;
+
+    std::printf(
+        "%-10s %8.1f ns/op   failures %6u   free %8zu   largest %8zu   fragmentation %5.1f%%\n",
+        name,
+        result.m_NanosecondsPerOp,
+        result.m_NumFailures,
+        freeSize,
+        result.m_LargestAllocatable,
+        fragmentation * 100.0);
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const uint32_t numOperations = argc >= 2 ? static_cast<uint32_t>(std::stoul(argv[1])) : 1000000;
+        const float occupancy = argc >= 3 ? std::stof(argv[2]) / 100.0f : 0.8f;
+
+        std::printf("%u operations at %.0f%% of %zu units\n", numOperations, occupancy * 100.0f, Capacity);
+
+        Ether::TlsfAllocator tlsf(Capacity);
+        PrintResult("tlsf", RunChurn(tlsf, numOperations, occupancy));
+
+        Ether::FreeListAllocator freeList(Capacity);
+        PrintResult("freelist", RunChurn(freeList, numOperations, occupancy));
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
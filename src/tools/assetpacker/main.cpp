@@ -0,0 +1,168 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/common.h"
+#include "common/stream/packfile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+/*
+    Packs a library of loose resources (.eres files) into a single pack file, and back.
+
+    - pack:   every .eres file of the library, compressed where that makes it smaller (unless -store)
+    - unpack: every entry of the pack, as <guid>.eres
+    - bench:  time to read every resource of a library from the loose files versus from its pack,
+              and the space either takes up on disk. For cold numbers, flush the OS file cache
+              (or reboot) first, the loose files are read before the pack.
+
+    Usage: AssetPacker pack <library directory> <output.epak> [-store]
+           AssetPacker unpack <input.epak> <output directory>
+           AssetPacker bench <library directory> <input.epak>
+*/
+
+using Clock = std::chrono::steady_clock;
+
+// Loose files take up whole clusters
+constexpr size_t DiskClusterSize = 4096;
+
+static double ToMilliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static size_t RoundUpToCluster(size_t size)
+{
+    return (size + DiskClusterSize - 1) / DiskClusterSize * DiskClusterSize;
+}
+
+static std::vector<std::filesystem::path> GetLibraryFiles(const std::string& libraryPath)
+{
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(libraryPath))
+    {
+        if (entry.path().extension().string() == ".eres")
+            files.push_back(entry.path());
+    }
+
+    return files;
+}
+
+static int Pack(const std::string& libraryPath, const std::string& packPath, bool isStored)
+{
+    Ether::PackFileWriter writer(packPath);
+    for (const std::filesystem::path& path : GetLibraryFiles(libraryPath))
+        writer.AddFile(path.string(), isStored ? Ether::PackCompression::None : Ether::PackCompression::Lz);
+
+    writer.Finalize();
+
+    size_t size = 0, storedSize = 0;
+    uint32_t numCompressed = 0;
+    for (const Ether::PackEntryDesc& entry : writer.GetEntries())
+    {
+        size += entry.m_Size;
+        storedSize += entry.m_StoredSize;
+        numCompressed += entry.m_Compression == Ether::PackCompression::Lz;
+    }
+
+    std::printf(
+        "Packed %zu resources (%u compressed), %zu bytes into %zu bytes\n",
+        writer.GetEntries().size(),
+        numCompressed,
+        size,
+        storedSize);
+
+    return 0;
+}
+
+static int Unpack(const std::string& packPath, const std::string& outputPath)
+{
+    Ether::PackFileReader reader(packPath);
+    std::filesystem::create_directories(outputPath);
+
+    for (const Ether::PackEntryDesc& entry : reader.GetEntries())
+    {
+        std::unique_ptr<Ether::IByteStream> istream = reader.Read(entry);
+        Ether::OFileStream ofstream((std::filesystem::path(outputPath) / (entry.m_Guid + ".eres")).string());
+        ofstream.WriteBytes(istream->GetData(), entry.m_Size);
+    }
+
+    std::printf("Unpacked %zu resources\n", reader.GetEntries().size());
+    return 0;
+}
+
+static int Bench(const std::string& libraryPath, const std::string& packPath)
+{
+    const std::vector<std::filesystem::path> files = GetLibraryFiles(libraryPath);
+
+    size_t looseSize = 0, looseDiskSize = 0;
+    const Clock::time_point looseStart = Clock::now();
+    for (const std::filesystem::path& path : files)
+    {
+        Ether::IFileStream file(path.string());
+        Ether::IByteStream istream(file);
+        looseSize += file.GetFileSize();
+        looseDiskSize += RoundUpToCluster(file.GetFileSize());
+    }
+    const double looseTime = ToMilliseconds(Clock::now() - looseStart);
+
+    size_t packedSize = 0;
+    const Clock::time_point packStart = Clock::now();
+    Ether::PackFileReader reader(packPath);
+    for (const Ether::PackEntryDesc& entry : reader.GetEntries())
+        packedSize += reader.Read(entry)->IsOpen() ? entry.m_Size : 0;
+    const double packTime = ToMilliseconds(Clock::now() - packStart);
+
+    const size_t packDiskSize = RoundUpToCluster(std::filesystem::file_size(packPath));
+
+    std::printf("%-6s %8s %16s %16s %12s\n", "", "files", "bytes", "on disk", "load");
+    std::printf("%-6s %8zu %16zu %16zu %9.2f ms\n", "loose", files.size(), looseSize, looseDiskSize, looseTime);
+    std::printf("%-6s %8zu %16zu %16zu %9.2f ms\n", "pack", reader.GetEntries().size(), packedSize, packDiskSize, packTime);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (argc >= 4 && std::strcmp(argv[1], "pack") == 0)
+            return Pack(argv[2], argv[3], argc >= 5 && std::strcmp(argv[4], "-store") == 0);
+
+        if (argc == 4 && std::strcmp(argv[1], "unpack") == 0)
+            return Unpack(argv[2], argv[3]);
+
+        if (argc == 4 && std::strcmp(argv[1], "bench") == 0)
+            return Bench(argv[2], argv[3]);
+    }
+    catch (const std::exception& exception)
+    {
+        std::fprintf(stderr, "%s\n", exception.what());
+        return 1;
+    }
+
+    std::fprintf(
+        stderr,
+        "Usage: AssetPacker pack <library directory> <output.epak> [-store]\n"
+        "       AssetPacker unpack <input.epak> <output directory>\n"
+        "       AssetPacker bench <library directory> <input.epak>\n");
+    return 1;
+}
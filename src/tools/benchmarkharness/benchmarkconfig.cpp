@@ -0,0 +1,245 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmarkconfig.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <format>
+
+static std::string Trim(const std::string& str)
+{
+    const size_t begin = str.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+        return "";
+
+    const size_t end = str.find_last_not_of(" \t\r\n");
+    return str.substr(begin, end - begin + 1);
+}
+
+static std::string ToLower(std::string str)
+{
+    for (char& c : str)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return str;
+}
+
+static bool ParseUint(const std::string& str, uint32_t& out)
+{
+    char* end = nullptr;
+    const unsigned long value = std::strtoul(str.c_str(), &end, 10);
+    if (str.empty() || *end != '\0' || str[0] == '-')
+        return false;
+
+    out = static_cast<uint32_t>(value);
+    return true;
+}
+
+static bool ParseDouble(const std::string& str, double& out)
+{
+    char* end = nullptr;
+    const double value = std::strtod(str.c_str(), &end);
+    if (str.empty() || *end != '\0')
+        return false;
+
+    out = value;
+    return true;
+}
+
+// <channel> : <metric> <'<' or '>'> <limit>
+static bool ParseThreshold(const std::string& str, BenchmarkThreshold& out)
+{
+    const size_t separator = str.rfind(':');
+    if (separator == std::string::npos)
+        return false;
+
+    out.m_Channel = Trim(str.substr(0, separator));
+    const std::string condition = str.substr(separator + 1);
+
+    const size_t op = condition.find_first_of("<>");
+    if (out.m_Channel.empty() || op == std::string::npos)
+        return false;
+
+    out.m_Metric = ToLower(Trim(condition.substr(0, op)));
+    out.m_IsUpperBound = condition[op] == '<';
+    return !out.m_Metric.empty() && ParseDouble(Trim(condition.substr(op + 1)), out.m_Limit);
+}
+
+bool BenchmarkConfig::Load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        LogError("Benchmark: Failed to open config %s", path.c_str());
+        return false;
+    }
+
+    std::string line;
+    uint32_t lineNumber = 0;
+    bool isValid = true;
+
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        line = Trim(line.substr(0, line.find('#')));
+
+        if (line.empty())
+            continue;
+
+        const size_t equals = line.find('=');
+        const std::string key = ToLower(Trim(line.substr(0, equals)));
+        const std::string value = equals == std::string::npos ? "" : Trim(line.substr(equals + 1));
+
+        bool isLineValid = true;
+        double ratio = m_MovingEntitiesRatio;
+        double number = 0.0;
+        BenchmarkThreshold threshold;
+
+        if (equals == std::string::npos)
+            isLineValid = false;
+        else if (key == "frames")
+            isLineValid = ParseUint(value, m_NumFrames);
+        else if (key == "warmupframes")
+            isLineValid = ParseUint(value, m_NumWarmupFrames);
+        else if (key == "fixeddeltatime")
+            isLineValid = ParseDouble(value, m_FixedDeltaTime) && m_FixedDeltaTime > 0.0;
+        else if (key == "world")
+            m_WorldPath = value;
+        else if (key == "movingentities")
+        {
+            isLineValid = ParseDouble(value, ratio) && ratio >= 0.0 && ratio <= 1.0;
+            m_MovingEntitiesRatio = static_cast<float>(ratio);
+        }
+        else if (key == "camerapath")
+        {
+            const std::string name = ToLower(value);
+            if (name == "static")
+                m_CameraPath = CameraPath::Static;
+            else if (name == "orbit")
+                m_CameraPath = CameraPath::Orbit;
+            else if (name == "flythrough")
+                m_CameraPath = CameraPath::Flythrough;
+            else
+                isLineValid = false;
+        }
+        else if (key == "streamingcellsize")
+        {
+            isLineValid = ParseDouble(value, number) && number >= 0.0;
+            m_StreamingCellSize = static_cast<float>(number);
+        }
+        else if (key == "streamingbudget")
+        {
+            isLineValid = ParseDouble(value, number) && number > 0.0;
+            m_StreamingParams.m_MemoryBudget = static_cast<size_t>(number * Ether::_1MiB);
+        }
+        else if (key == "loadradius")
+        {
+            isLineValid = ParseDouble(value, number) && number > 0.0;
+            m_StreamingParams.m_LoadRadius = static_cast<float>(number);
+        }
+        else if (key == "unloadradius")
+        {
+            isLineValid = ParseDouble(value, number) && number > 0.0;
+            m_StreamingParams.m_UnloadRadius = static_cast<float>(number);
+        }
+        else if (key == "loaderthreads")
+            isLineValid = ParseUint(value, m_StreamingParams.m_NumLoaderThreads);
+        else if (key == "editinterval")
+            isLineValid = ParseUint(value, m_EditInterval);
+        else if (key == "output")
+            m_OutputPath = value;
+        else if (key == "threshold")
+        {
+            isLineValid = ParseThreshold(value, threshold);
+            if (isLineValid)
+                m_Thresholds.push_back(threshold);
+        }
+        else
+            isLineValid = m_WorldParams.SetParam(key, value);
+
+        if (!isLineValid)
+        {
+            LogError("Benchmark: Invalid setting in %s (line %u): %s", path.c_str(), lineNumber, line.c_str());
+            isValid = false;
+        }
+    }
+
+    // Cells would be unloaded as soon as they are loaded
+    if (m_StreamingParams.m_UnloadRadius < m_StreamingParams.m_LoadRadius)
+    {
+        LogError("Benchmark: unloadradius has to be at least as large as loadradius in %s", path.c_str());
+        isValid = false;
+    }
+
+    return isValid;
+}
+
+std::vector<std::string> BenchmarkConfig::EvaluateThresholds(const BenchmarkResults& results) const
+{
+    std::vector<std::string> failures;
+
+    for (const BenchmarkThreshold& threshold : m_Thresholds)
+    {
+        const auto channel = results.find(threshold.m_Channel);
+        if (channel == results.end())
+        {
+            failures.push_back(std::format("{}: no such channel", threshold.m_Channel));
+            continue;
+        }
+
+        const auto metric = channel->second.find(threshold.m_Metric);
+        if (metric == channel->second.end())
+        {
+            failures.push_back(std::format("{}: no such metric '{}'", threshold.m_Channel, threshold.m_Metric));
+            continue;
+        }
+
+        const double value = metric->second;
+        const bool passed = threshold.m_IsUpperBound ? value < threshold.m_Limit : value > threshold.m_Limit;
+
+        if (!passed)
+        {
+            failures.push_back(std::format(
+                "{}: {} is {:.4f}, expected {} {:.4f}",
+                threshold.m_Channel,
+                threshold.m_Metric,
+                value,
+                threshold.m_IsUpperBound ? "<" : ">",
+                threshold.m_Limit));
+        }
+    }
+
+    return failures;
+}
+
+const char* BenchmarkConfig::GetCameraPathName(CameraPath path)
+{
+    switch (path)
+    {
+    case CameraPath::Static:
+        return "static";
+    case CameraPath::Orbit:
+        return "orbit";
+    case CameraPath::Flythrough:
+        return "flythrough";
+    default:
+        return "unknown";
+    }
+}
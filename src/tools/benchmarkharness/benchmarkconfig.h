@@ -0,0 +1,115 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "ether.h"
+#include "engine/world/worldgenerator.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+enum class CameraPath
+{
+    Static,
+    Orbit,
+    Flythrough,
+};
+
+// Results are grouped by telemetry channel, then by metric name (mean, p50, ...)
+using BenchmarkResults = std::map<std::string, std::map<std::string, double>>;
+
+struct BenchmarkThreshold
+{
+    std::string m_Channel;
+    std::string m_Metric;
+    bool m_IsUpperBound;
+    double m_Limit;
+};
+
+/*
+    Plain "key = value" text file, one setting per line. '#' starts a comment.
+
+        frames = 600
+        warmupframes = 60
+        fixeddeltatime = 16.6667                # milliseconds
+        world = .\Data\worlds\sponza.ether      # a generated world is used when empty
+        entities = 2048                         # world generator settings, see WorldGeneratorParams
+        placement = clustered
+        seed = 1
+        movingentities = 0.1                    # fraction of generated visuals animated every frame
+        camerapath = orbit                      # static, orbit or flythrough
+        streamingcellsize = 32                  # streams the world in cells of this size, 0 loads it whole
+        streamingbudget = 64                    # MiB of meshes and textures
+        loadradius = 96
+        unloadradius = 128
+        loaderthreads = 2                       # 0 loads on the main thread, deterministically
+        output = benchmark.json
+        threshold = Engine - World Update : p99 < 2.0
+        threshold = Frame : mean < 4.0
+
+    Thresholds compare a metric of a telemetry channel (mean, p50, p95, p99, max, in ms)
+    against a limit. Any violated threshold fails the run. The configs folder holds the
+    benchmarks that are run regularly.
+
+    A streamed world is saved to a temporary file and loaded back through the world streamer,
+    which is then checked every measured frame. Its "Streaming" channel counts the frames that
+    broke the budget or the streamer's bookkeeping, and the ones where the cell under the camera
+    was not resident, e.g.
+
+        threshold = Streaming : budgetviolations < 1
+        threshold = Streaming : validationerrors < 1
+        threshold = Streaming : cameracellmisses < 1
+
+    With an edit interval, a static visual of a generated world is moved every that many frames
+    by applying a delta to its transform, the way the editor sets fields. The "Sync" channel
+    counts the edits whose world matrix was not in the render data by the next frame, e.g.
+
+        editinterval = 10
+        threshold = Sync : editmisses < 1
+*/
+struct BenchmarkConfig
+{
+    uint32_t m_NumFrames = 600;
+    uint32_t m_NumWarmupFrames = 60;
+    double m_FixedDeltaTime = 1000.0 / 60.0;
+
+    std::string m_WorldPath;
+    Ether::WorldGeneratorParams m_WorldParams;
+    float m_MovingEntitiesRatio = 0.1f;
+
+    CameraPath m_CameraPath = CameraPath::Orbit;
+
+    float m_StreamingCellSize = 0.0f;
+    Ether::WorldStreamingParams m_StreamingParams;
+
+    uint32_t m_EditInterval = 0;
+
+    std::string m_OutputPath = "benchmark.json";
+    std::vector<BenchmarkThreshold> m_Thresholds;
+
+    bool Load(const std::string& path);
+
+    // Returns a description of every violated threshold. Thresholds on missing channels or
+    // metrics count as violated, so that a typo in the config cannot silently pass.
+    std::vector<std::string> EvaluateThresholds(const BenchmarkResults& results) const;
+
+    static const char* GetCameraPathName(CameraPath path);
+};
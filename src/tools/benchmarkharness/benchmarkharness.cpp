@@ -0,0 +1,439 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmarkharness.h"
+#include "common/memory/memorytracker.h"
+#include "common/telemetry/telemetry.h"
+#include "graphics/graphiccore.h"
+#include "graphics/headlessrenderer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <numbers>
+
+using namespace Ether;
+
+// Camera distance for worlds loaded from disk, whose extent is not known up front
+static constexpr float DefaultCameraDistance = 25.0f;
+
+static std::string EscapeJson(const std::string& str)
+{
+    std::string escaped;
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+void BenchmarkHarness::Initialize()
+{
+    LogInfo("Initializing Application: Benchmark Harness");
+
+    const std::string& configPath = GetCommandLineOptions().GetBenchmarkConfigPath();
+    if (configPath.empty())
+        LogInfo("Benchmark: No config given (-benchmark <path>), using defaults");
+    else if (!m_Config.Load(configPath))
+    {
+        Abort();
+        return;
+    }
+
+    Time::SetFixedDeltaTime(m_Config.m_FixedDeltaTime);
+}
+
+void BenchmarkHarness::LoadContent()
+{
+    if (m_IsAborted)
+        return;
+
+    World& world = GetActiveWorld();
+
+    if (!m_Config.m_WorldPath.empty())
+    {
+        if (!std::filesystem::exists(m_Config.m_WorldPath))
+        {
+            LogError("Benchmark: World %s does not exist", m_Config.m_WorldPath.c_str());
+            Abort();
+            return;
+        }
+
+        world.Load(m_Config.m_WorldPath);
+        m_CameraDistance = DefaultCameraDistance;
+    }
+    else
+    {
+        m_SyntheticWorld = std::make_unique<SyntheticWorld>(m_Config);
+        m_SyntheticWorld->Generate(world);
+        m_CameraDistance = m_SyntheticWorld->GetExtent();
+    }
+
+    if (m_Config.m_StreamingCellSize > 0.0f && !StreamWorld())
+    {
+        Abort();
+        return;
+    }
+
+    // Streaming reloads the world, so only the generated world's entities are known
+    if (m_Config.m_EditInterval > 0)
+    {
+        m_EditedEntity = m_SyntheticWorld != nullptr ? m_SyntheticWorld->GetStaticEntity() : nullptr;
+        if (m_EditedEntity == nullptr)
+        {
+            LogError("Benchmark: editinterval needs a generated, non streamed world with a static visual");
+            Abort();
+            return;
+        }
+    }
+
+    m_Camera = &world.CreateCamera();
+    UpdateCamera(0.0);
+}
+
+void BenchmarkHarness::UnloadContent()
+{
+}
+
+void BenchmarkHarness::Shutdown()
+{
+}
+
+void BenchmarkHarness::OnUpdate(const UpdateEventArgs& e)
+{
+    if (m_IsAborted)
+        return;
+
+    // Everything is a function of the frame index rather than of the clock, so that every run
+    // simulates exactly the same frames
+    const double timeInSeconds = m_FrameIndex * m_Config.m_FixedDeltaTime / 1000.0;
+
+    if (m_FrameIndex == m_Config.m_NumWarmupFrames)
+        Telemetry::Instance().Clear();
+
+    // The world has been updated for the previous camera position by now
+    if (m_FrameIndex >= m_Config.m_NumWarmupFrames && GetActiveWorld().GetStreamer() != nullptr)
+        CheckStreaming();
+
+    if (m_FrameIndex >= m_Config.m_NumWarmupFrames && m_EditedEntity != nullptr)
+        CheckEdits();
+
+    UpdateCamera(timeInSeconds);
+
+    if (m_SyntheticWorld != nullptr)
+        m_SyntheticWorld->Animate(timeInSeconds);
+
+    if (++m_FrameIndex >= m_Config.m_NumWarmupFrames + m_Config.m_NumFrames)
+        Ether::Shutdown();
+}
+
+void BenchmarkHarness::OnRender(const RenderEventArgs& e)
+{
+}
+
+void BenchmarkHarness::OnShutdown()
+{
+    if (!m_IsAborted)
+        ReportResults();
+
+    // The streamer keeps the file open until the world is unloaded
+    if (!m_StreamedWorldPath.empty())
+    {
+        GetActiveWorld().Unload();
+        std::error_code error;
+        std::filesystem::remove(m_StreamedWorldPath, error);
+    }
+}
+
+void BenchmarkHarness::ReportResults()
+{
+    const BenchmarkResults results = CollectResults();
+    const std::vector<std::string> failures = m_Config.EvaluateThresholds(results);
+
+    for (const std::string& failure : failures)
+        LogError("Benchmark: Threshold violated - %s", failure.c_str());
+
+    if (!WriteResults(results, failures))
+    {
+        LogError("Benchmark: Failed to write results to %s", m_Config.m_OutputPath.c_str());
+        m_ExitCode = ExitCodeError;
+        return;
+    }
+
+    m_ExitCode = failures.empty() ? ExitCodeSuccess : ExitCodeThresholdFailed;
+    LogInfo(
+        "Benchmark: %llu frames measured, %zu/%zu thresholds passed, results written to %s",
+        static_cast<unsigned long long>(Telemetry::Instance().GetNumFrames()),
+        m_Config.m_Thresholds.size() - failures.size(),
+        m_Config.m_Thresholds.size(),
+        m_Config.m_OutputPath.c_str());
+}
+
+void BenchmarkHarness::UpdateCamera(double timeInSeconds)
+{
+    const float distance = m_CameraDistance;
+    const float height = distance * 0.5f;
+    const float t = static_cast<float>(timeInSeconds);
+    Ecs::EcsTransformComponent& transform = m_Camera->GetComponent<Ecs::EcsTransformComponent>();
+
+    // Positive pitch looks down, yaw 0 looks down +z
+    switch (m_Config.m_CameraPath)
+    {
+    case CameraPath::Static:
+        transform.m_Translation = { 0.0f, height, -distance };
+        transform.m_Rotation = { std::atan2(height, distance), 0.0f, 0.0f };
+        break;
+    case CameraPath::Orbit:
+    {
+        // One revolution every 30 seconds, always facing the center of the world
+        const float angle = t * 2.0f * std::numbers::pi_v<float> / 30.0f;
+        transform.m_Translation = { -std::sin(angle) * distance, height, -std::cos(angle) * distance };
+        transform.m_Rotation = { std::atan2(height, distance), angle, 0.0f };
+        break;
+    }
+    case CameraPath::Flythrough:
+    {
+        // Sweeps back and forth through the middle of the world at low height, weaving sideways
+        const float period = 20.0f;
+        const float phase = std::fmod(t, period) / period;
+        const float forward = phase < 0.5f ? 1.0f : -1.0f;
+        const float x = (phase < 0.5f ? phase * 4.0f - 1.0f : 3.0f - phase * 4.0f) * distance;
+        transform.m_Translation = { x, 3.0f, std::sin(t) * distance * 0.25f };
+        transform.m_Rotation = { 0.1f, forward * std::numbers::pi_v<float> * 0.5f, 0.0f };
+        break;
+    }
+    }
+
+    m_Camera->MarkModified<Ecs::EcsTransformComponent>();
+}
+
+bool BenchmarkHarness::StreamWorld()
+{
+    World& world = GetActiveWorld();
+    m_StreamedWorldPath = (std::filesystem::temp_directory_path() / "ether_benchmark_streamed.ether").string();
+
+    // The animated entities are not kept across the reload
+    m_SyntheticWorld.reset();
+
+    world.SaveStreamed(m_StreamedWorldPath, m_Config.m_StreamingCellSize);
+    world.LoadStreamed(m_StreamedWorldPath, m_Config.m_StreamingParams);
+
+    if (world.GetStreamer() == nullptr)
+    {
+        LogError("Benchmark: Failed to stream the world back in from %s", m_StreamedWorldPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void BenchmarkHarness::CheckStreaming()
+{
+    WorldStreamer& streamer = *GetActiveWorld().GetStreamer();
+    const WorldStreamingStats& stats = streamer.GetStats();
+    const size_t budget = streamer.GetParams().m_MemoryBudget;
+
+    const std::string error = streamer.Validate();
+    if (!error.empty() && m_NumStreamingValidationErrors++ < 10)
+        LogError("Benchmark: Streaming frame %u - %s", m_FrameIndex, error.c_str());
+
+    if (stats.m_CommittedMemory > budget)
+        m_NumBudgetViolations++;
+
+    // What the resources actually take up, as opposed to what the streamer planned with
+    const size_t resourceMemory = MemoryTracker::GetSnapshot().Get(MemoryTag::Resources).m_LiveBytes;
+    m_PeakResourceMemory = (std::max)(m_PeakResourceMemory, resourceMemory);
+    if (resourceMemory > budget)
+        m_NumMemoryViolations++;
+
+    const ethVector3 position = m_Camera->GetComponent<Ecs::EcsTransformComponent>().m_Translation;
+    const int32_t x = StreamingWorldIndex::GetCellCoordinate(position.x, streamer.GetCellSize());
+    const int32_t z = StreamingWorldIndex::GetCellCoordinate(position.z, streamer.GetCellSize());
+    if (streamer.HasCell(x, z) && !streamer.IsCellResident(x, z))
+        m_NumCameraCellMisses++;
+}
+
+void BenchmarkHarness::CheckEdits()
+{
+    // The previous frame's edit has been through the world update by now
+    if (m_IsEditPending)
+    {
+        m_IsEditPending = false;
+        if (!HasVisualWithWorldMatrix(m_ExpectedWorldMatrix) && m_NumEditMisses++ < 10)
+            LogError("Benchmark: Frame %u - Transform edit did not reach the render data", m_FrameIndex);
+    }
+
+    if ((m_FrameIndex - m_Config.m_NumWarmupFrames) % m_Config.m_EditInterval == 0)
+        EditTransform();
+}
+
+void BenchmarkHarness::EditTransform()
+{
+    static constexpr uint32_t TranslationFieldMask = 1u << 0;
+
+    // The component itself is only written by the delta
+    Ecs::EcsTransformComponent transform = m_EditedEntity->GetComponent<Ecs::EcsTransformComponent>();
+    transform.m_Translation.y += 0.5f;
+
+    std::vector<uint8_t> delta;
+    Ecs::EcsDeltaWriter writer(delta);
+    writer.BeginComponent(Ecs::EcsTransformComponent::s_ComponentID);
+    writer.WriteFields(m_EditedEntity->GetID(), TranslationFieldMask, Ecs::EcsTransformComponent::GetComponentInfo(), &transform);
+    writer.EndComponent();
+    writer.Finish();
+
+    if (!GetActiveWorld().GetEcsManager().ApplyDelta(delta.data(), delta.size()))
+    {
+        LogError("Benchmark: Failed to apply transform delta");
+        m_NumEditMisses++;
+        return;
+    }
+
+    m_ExpectedWorldMatrix = Transform::GetTranslationMatrix(transform.m_Translation) *
+                            Transform::GetRotationMatrix(transform.m_Rotation) *
+                            Transform::GetScaleMatrix(transform.m_Scale);
+    m_IsEditPending = true;
+    m_NumEdits++;
+}
+
+// Computed exactly like the visual system does, so the matrices are bitwise equal
+bool BenchmarkHarness::HasVisualWithWorldMatrix(const ethMatrix4x4& worldMatrix) const
+{
+    for (const Graphics::Visual& visual : Graphics::GraphicCore::GetNextRenderData().m_Visuals)
+    {
+        if (std::memcmp(&visual.m_WorldMatrix, &worldMatrix, sizeof(worldMatrix)) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+BenchmarkResults BenchmarkHarness::CollectResults() const
+{
+    BenchmarkResults results;
+    Telemetry& telemetry = Telemetry::Instance();
+
+    for (const std::string& channel : telemetry.GetChannelNames())
+    {
+        const TelemetrySummary summary = telemetry.GetSummary(channel);
+        results[channel] = {
+            { "mean", summary.m_Mean },
+            { "p50", summary.m_P50 },
+            { "p95", summary.m_P95 },
+            { "p99", summary.m_P99 },
+            { "max", summary.m_Max },
+        };
+    }
+
+    // Counters from the last frame, so that thresholds can also catch e.g. broken batching
+    const Graphics::RenderStats& stats = Graphics::GraphicCore::GetHeadlessRenderer().GetRenderStats();
+    results["Render Stats"] = {
+        { "visuals", static_cast<double>(Graphics::GraphicCore::GetRenderData().m_Visuals.size()) },
+        { "drawcalls", static_cast<double>(stats.m_NumDrawCalls) },
+        { "instances", static_cast<double>(stats.m_NumInstances) },
+    };
+
+    if (m_EditedEntity != nullptr)
+    {
+        results["Sync"] = {
+            { "edits", static_cast<double>(m_NumEdits) },
+            { "editmisses", static_cast<double>(m_NumEditMisses) },
+        };
+    }
+
+    if (GetActiveWorld().GetStreamer() != nullptr)
+    {
+        const WorldStreamingStats& stats = GetActiveWorld().GetStreamer()->GetStats();
+        results["Streaming"] = {
+            { "validationerrors", static_cast<double>(m_NumStreamingValidationErrors) },
+            { "budgetviolations", static_cast<double>(m_NumBudgetViolations) },
+            { "memoryviolations", static_cast<double>(m_NumMemoryViolations) },
+            { "cameracellmisses", static_cast<double>(m_NumCameraCellMisses) },
+            { "peakcommittedmib", stats.m_PeakCommittedMemory / static_cast<double>(_1MiB) },
+            { "peakresourcemib", m_PeakResourceMemory / static_cast<double>(_1MiB) },
+            { "residentcells", static_cast<double>(stats.m_NumResidentCells) },
+            { "cellloads", static_cast<double>(stats.m_NumCellLoads) },
+            { "cellunloads", static_cast<double>(stats.m_NumCellUnloads) },
+            { "resourceloads", static_cast<double>(stats.m_NumResourceLoads) },
+            { "resourceevictions", static_cast<double>(stats.m_NumResourceEvictions) },
+            { "failedloads", static_cast<double>(stats.m_NumFailedLoads) },
+        };
+    }
+
+    return results;
+}
+
+bool BenchmarkHarness::WriteResults(const BenchmarkResults& results, const std::vector<std::string>& failures) const
+{
+    FILE* file = std::fopen(m_Config.m_OutputPath.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"config\": {\n");
+    std::fprintf(file, "    \"frames\": %u,\n", m_Config.m_NumFrames);
+    std::fprintf(file, "    \"warmupframes\": %u,\n", m_Config.m_NumWarmupFrames);
+    std::fprintf(file, "    \"fixeddeltatime\": %.6f,\n", m_Config.m_FixedDeltaTime);
+    std::fprintf(file, "    \"seed\": %u,\n", m_Config.m_WorldParams.m_Seed);
+    std::fprintf(file, "    \"world\": \"%s\",\n", EscapeJson(m_Config.m_WorldPath).c_str());
+    std::fprintf(file, "    \"entities\": %u,\n", m_Config.m_WorldParams.m_NumEntities);
+    std::fprintf(file, "    \"camerapath\": \"%s\",\n", BenchmarkConfig::GetCameraPathName(m_Config.m_CameraPath));
+    std::fprintf(file, "    \"streamingcellsize\": %.2f\n", m_Config.m_StreamingCellSize);
+    std::fprintf(file, "  },\n");
+
+    std::fprintf(file, "  \"results\": {");
+    const char* channelSeparator = "\n";
+    for (const auto& [channel, metrics] : results)
+    {
+        std::fprintf(file, "%s    \"%s\": {", channelSeparator, EscapeJson(channel).c_str());
+        const char* metricSeparator = " ";
+        for (const auto& [metric, value] : metrics)
+        {
+            std::fprintf(file, "%s\"%s\": %.6f", metricSeparator, metric.c_str(), value);
+            metricSeparator = ", ";
+        }
+        std::fprintf(file, " }");
+        channelSeparator = ",\n";
+    }
+    std::fprintf(file, "\n  },\n");
+
+    std::fprintf(file, "  \"failures\": [");
+    const char* failureSeparator = "\n";
+    for (const std::string& failure : failures)
+    {
+        std::fprintf(file, "%s    \"%s\"", failureSeparator, EscapeJson(failure).c_str());
+        failureSeparator = ",\n";
+    }
+    std::fprintf(file, "%s],\n", failures.empty() ? "" : "\n  ");
+
+    std::fprintf(file, "  \"passed\": %s\n", failures.empty() ? "true" : "false");
+    std::fprintf(file, "}\n");
+
+    return std::fclose(file) == 0;
+}
+
+void BenchmarkHarness::Abort()
+{
+    m_IsAborted = true;
+    m_ExitCode = ExitCodeError;
+    Ether::Shutdown();
+}
@@ -0,0 +1,92 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "ether.h"
+#include "benchmarkconfig.h"
+#include "syntheticworld.h"
+#include "engine/world/ecs/components/ecstransformcomponent.h"
+
+/*
+    Drives the engine headlessly (see Ether::StartHeadless) for a fixed number of fixed-timestep
+    frames along a scripted camera path, then writes per-channel frame timings as json and
+    checks them against the thresholds in the config.
+
+    Exit codes: 0 when every threshold passed, 1 when any threshold was violated, 2 when the
+    benchmark could not run (bad config, missing world, unwritable output).
+*/
+class BenchmarkHarness : public Ether::IApplicationBase
+{
+public:
+    void Initialize() override;
+    void LoadContent() override;
+    void UnloadContent() override;
+    void Shutdown() override;
+
+public:
+    void OnUpdate(const Ether::UpdateEventArgs& e) override;
+    void OnRender(const Ether::RenderEventArgs& e) override;
+    void OnShutdown() override;
+
+public:
+    inline int GetExitCode() const { return m_ExitCode; }
+
+public:
+    static constexpr int ExitCodeSuccess = 0;
+    static constexpr int ExitCodeThresholdFailed = 1;
+    static constexpr int ExitCodeError = 2;
+
+private:
+    void UpdateCamera(double timeInSeconds);
+    bool StreamWorld();
+    void CheckStreaming();
+    void CheckEdits();
+    void EditTransform();
+    bool HasVisualWithWorldMatrix(const Ether::ethMatrix4x4& worldMatrix) const;
+    void ReportResults();
+    BenchmarkResults CollectResults() const;
+    bool WriteResults(const BenchmarkResults& results, const std::vector<std::string>& failures) const;
+    void Abort();
+
+private:
+    BenchmarkConfig m_Config;
+    std::unique_ptr<SyntheticWorld> m_SyntheticWorld;
+    // Components move around in their arrays as entities come and go, so the transform is looked up every frame
+    Ether::Entity* m_Camera = nullptr;
+
+    std::string m_StreamedWorldPath;
+    uint32_t m_NumStreamingValidationErrors = 0;
+    uint32_t m_NumBudgetViolations = 0;
+    uint32_t m_NumMemoryViolations = 0;
+    uint32_t m_NumCameraCellMisses = 0;
+    size_t m_PeakResourceMemory = 0;
+
+    // Moved through the same delta path as the fields set by the editor (see EditTransform)
+    Ether::Entity* m_EditedEntity = nullptr;
+    Ether::ethMatrix4x4 m_ExpectedWorldMatrix;
+    bool m_IsEditPending = false;
+    uint32_t m_NumEdits = 0;
+    uint32_t m_NumEditMisses = 0;
+
+    float m_CameraDistance = 0.0f;
+    uint32_t m_FrameIndex = 0;
+    bool m_IsAborted = false;
+    int m_ExitCode = ExitCodeSuccess;
+};
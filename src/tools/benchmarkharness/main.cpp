@@ -0,0 +1,35 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmarkharness.h"
+
+/*
+    Headless benchmark of the engine loop, meant to be run from automation.
+
+    Usage: BenchmarkHarness [-benchmark <config>] [-telemetry <path>]
+
+    See benchmarkconfig.h for the config format. The exit code is non-zero when the benchmark
+    failed to run or any configured threshold was violated.
+*/
+int main()
+{
+    BenchmarkHarness harness;
+    Ether::StartHeadless(harness);
+    return harness.GetExitCode();
+}
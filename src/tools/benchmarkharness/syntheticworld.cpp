@@ -0,0 +1,72 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "syntheticworld.h"
+#include "engine/world/ecs/components/ecstransformcomponent.h"
+
+#include <cmath>
+#include <numbers>
+
+SyntheticWorld::SyntheticWorld(const BenchmarkConfig& config)
+    : m_Config(config)
+    , m_Random(config.m_WorldParams.m_Seed)
+    , m_Extent(0.0f)
+    , m_StaticEntity(nullptr)
+{
+}
+
+void SyntheticWorld::Generate(Ether::World& world)
+{
+    Ether::WorldGenerator generator(m_Config.m_WorldParams);
+    generator.Generate(world);
+    m_Extent = generator.GetExtent();
+
+    const std::vector<Ether::Ecs::EntityID>& visuals = generator.GetVisualEntities();
+    const uint64_t numVisuals = visuals.size();
+    const uint64_t numAnimated = static_cast<uint64_t>(numVisuals * m_Config.m_MovingEntitiesRatio);
+
+    m_AnimatedEntities.clear();
+    m_AnimationSpeeds.clear();
+    m_StaticEntity = nullptr;
+
+    // Spread the animated entities evenly over the world rather than taking the first few rows
+    for (uint64_t i = 0; i < numVisuals; ++i)
+    {
+        if (numAnimated == 0 || (i * numAnimated) % numVisuals >= numAnimated)
+        {
+            if (m_StaticEntity == nullptr)
+                m_StaticEntity = &world.GetEntity(visuals[i]);
+            continue;
+        }
+
+        m_AnimatedEntities.push_back(&world.GetEntity(visuals[i]));
+        m_AnimationSpeeds.push_back(((m_Random() >> 8) / 16777216.0f) * 4.0f - 2.0f);
+    }
+}
+
+void SyntheticWorld::Animate(double timeInSeconds)
+{
+    for (uint32_t i = 0; i < m_AnimatedEntities.size(); ++i)
+    {
+        Ether::Entity& entity = *m_AnimatedEntities[i];
+        Ether::Ecs::EcsTransformComponent& transform = entity.GetComponent<Ether::Ecs::EcsTransformComponent>();
+        transform.m_Rotation.y = static_cast<float>(std::fmod(timeInSeconds * m_AnimationSpeeds[i], 2.0 * std::numbers::pi));
+        entity.MarkModified<Ether::Ecs::EcsTransformComponent>();
+    }
+}
@@ -0,0 +1,57 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "ether.h"
+#include "benchmarkconfig.h"
+
+#include <random>
+
+/*
+    A world from the engine's world generator, plus a subset of its visuals that is animated every
+    frame so that the benchmark also exercises the incremental render data updates.
+*/
+class SyntheticWorld
+{
+public:
+    SyntheticWorld(const BenchmarkConfig& config);
+
+public:
+    void Generate(Ether::World& world);
+
+    // Spins the animated subset of entities. Rotation is a function of time only, so that every
+    // run moves the same entities by the same amount.
+    void Animate(double timeInSeconds);
+
+    // Radius of a circle (on the XZ plane) that contains every generated entity
+    inline float GetExtent() const { return m_Extent; }
+
+    // A visual that is never animated, or null if every visual is
+    inline Ether::Entity* GetStaticEntity() const { return m_StaticEntity; }
+
+private:
+    const BenchmarkConfig& m_Config;
+    std::mt19937 m_Random;
+    float m_Extent;
+
+    std::vector<Ether::Entity*> m_AnimatedEntities;
+    std::vector<float> m_AnimationSpeeds;
+    Ether::Entity* m_StaticEntity;
+};
@@ -0,0 +1,299 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/common.h"
+#include "common/ipc/ipcmessage.h"
+#include "common/ipc/ipcsender.h"
+#include "common/ipc/loopbacktransport.h"
+#include "common/ipc/tcpsocket.h"
+#include "parser/json/json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    Measures the toolmode IPC layer over the in-process loopback and over a localhost TCP socket:
+
+    - Latency:    round trips of a small binary message through an echo thread
+    - Throughput: one way streams of binary messages of increasing size
+    - Encoding:   a batch of floats sent as a JSON command versus as a raw binary section,
+                  including the time to encode and decode on either end
+    - Sender:     small messages from several threads through IpcSender, which batches them into
+                  as few writes as possible, versus one write per message
+
+    Usage: IpcBenchmark [iterations]
+*/
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t BenchmarkMessageType = Ether::MakeIpcTag('B', 'N', 'C', 'H');
+constexpr uint32_t PayloadTag = Ether::MakeIpcTag('D', 'A', 'T', 'A');
+
+struct TransportPair
+{
+    const char* m_Name;
+    std::unique_ptr<Ether::IpcTransport> m_Client;
+    std::unique_ptr<Ether::IpcTransport> m_Server;
+};
+
+static double ToMicroseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+static TransportPair CreateLoopbackPair()
+{
+    Ether::LoopbackTransport::Pair pair = Ether::LoopbackTransport::CreatePair();
+    return { "loopback", std::move(pair.first), std::move(pair.second) };
+}
+
+static TransportPair CreateTcpPair()
+{
+    std::unique_ptr<Ether::TcpSocket> server = std::make_unique<Ether::TcpSocket>(0);
+    std::thread acceptThread([&server]() { server->WaitForConnection(); });
+    std::unique_ptr<Ether::TcpSocket> client = Ether::TcpSocket::Connect("127.0.0.1", server->GetPort());
+    acceptThread.join();
+
+    return { "tcp", std::move(client), std::move(server) };
+}
+
+static void BenchmarkLatency(TransportPair& transports, uint32_t numIterations)
+{
+    std::thread echoThread([&transports, numIterations]()
+    {
+        for (uint32_t i = 0; i < numIterations; ++i)
+            Ether::IpcMessage::ReadFrom(*transports.m_Server).WriteTo(*transports.m_Server);
+    });
+
+    Ether::IpcMessage ping(BenchmarkMessageType, 1);
+    ping.AddSection(PayloadTag, 64);
+
+    std::vector<double> roundTrips(numIterations);
+    for (uint32_t i = 0; i < numIterations; ++i)
+    {
+        const Clock::time_point start = Clock::now();
+        ping.WriteTo(*transports.m_Client);
+        Ether::IpcMessage::ReadFrom(*transports.m_Client);
+        roundTrips[i] = ToMicroseconds(Clock::now() - start);
+    }
+
+    echoThread.join();
+    std::sort(roundTrips.begin(), roundTrips.end());
+
+    std::printf(
+        "%-10s latency     64 B round trip    p50 %8.2f us   p99 %8.2f us   max %8.2f us\n",
+        transports.m_Name,
+        roundTrips[numIterations / 2],
+        roundTrips[numIterations * 99 / 100],
+        roundTrips.back());
+}
+
+static void BenchmarkThroughput(TransportPair& transports, size_t payloadSize, uint32_t numMessages)
+{
+    Ether::IpcMessage message(BenchmarkMessageType, 1);
+    message.AddSection(PayloadTag, payloadSize);
+
+    const Clock::time_point start = Clock::now();
+
+    std::thread receiveThread([&transports, numMessages]()
+    {
+        for (uint32_t i = 0; i < numMessages; ++i)
+            Ether::IpcMessage::ReadFrom(*transports.m_Server);
+    });
+
+    for (uint32_t i = 0; i < numMessages; ++i)
+        message.WriteTo(*transports.m_Client);
+
+    receiveThread.join();
+
+    const double seconds = ToMicroseconds(Clock::now() - start) / 1e6;
+    const double numMiB = static_cast<double>(message.GetSizeInBytes()) * numMessages / Ether::_1MiB;
+
+    std::printf(
+        "%-10s throughput  %8zu B payload  %10.1f msg/s  %10.1f MiB/s\n",
+        transports.m_Name,
+        payloadSize,
+        numMessages / seconds,
+        numMiB / seconds);
+}
+
+static void BenchmarkEncoding(TransportPair& transports, size_t numFloats, uint32_t numMessages)
+{
+    std::vector<float> values(numFloats);
+    for (size_t i = 0; i < numFloats; ++i)
+        values[i] = static_cast<float>(i) * 0.25f;
+
+    const auto measure = [&](const std::function<Ether::IpcMessage()>& encode, const std::function<float(const Ether::IpcMessage&)>& decode)
+    {
+        std::thread receiveThread([&]()
+        {
+            for (uint32_t i = 0; i < numMessages; ++i)
+                decode(Ether::IpcMessage::ReadFrom(*transports.m_Server));
+        });
+
+        const Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < numMessages; ++i)
+            encode().WriteTo(*transports.m_Client);
+
+        receiveThread.join();
+        return ToMicroseconds(Clock::now() - start) / numMessages;
+    };
+
+    const double jsonTime = measure(
+        [&]()
+        {
+            nlohmann::json command = { { "command", "setproperty" }, { "args", { { "values", values } } } };
+            return Ether::IpcMessage::FromJson(command.dump());
+        },
+        [](const Ether::IpcMessage& message)
+        {
+            const std::string_view json = message.GetJson();
+            const nlohmann::json command = nlohmann::json::parse(json.begin(), json.end());
+            return command["args"]["values"].back().get<float>();
+        });
+
+    const double binaryTime = measure(
+        [&]()
+        {
+            Ether::IpcMessage message(BenchmarkMessageType, 1);
+            message.AddSection(PayloadTag, values.data(), values.size() * sizeof(float));
+            return message;
+        },
+        [](const Ether::IpcMessage& message)
+        {
+            const Ether::IpcSection section = message.FindSection(PayloadTag);
+            return reinterpret_cast<const float*>(section.m_Data)[section.m_Size / sizeof(float) - 1];
+        });
+
+    std::printf(
+        "%-10s encoding    %8zu floats   json %10.2f us/msg   binary %10.2f us/msg   (%.1fx)\n",
+        transports.m_Name,
+        numFloats,
+        jsonTime,
+        binaryTime,
+        jsonTime / binaryTime);
+}
+
+static void BenchmarkSender(TransportPair& transports, uint32_t numProducers, uint32_t numMessages)
+{
+    const uint32_t numMessagesTotal = numProducers * numMessages;
+
+    const auto measure = [&](const std::function<void(uint32_t)>& produce)
+    {
+        std::thread receiveThread([&]()
+        {
+            for (uint32_t i = 0; i < numMessagesTotal; ++i)
+                Ether::IpcMessage::ReadFrom(*transports.m_Server);
+        });
+
+        const Clock::time_point start = Clock::now();
+
+        std::vector<std::thread> producers;
+        for (uint32_t i = 0; i < numProducers; ++i)
+            producers.emplace_back(produce, i);
+
+        for (std::thread& producer : producers)
+            producer.join();
+
+        receiveThread.join();
+        return numMessagesTotal / (ToMicroseconds(Clock::now() - start) / 1e6);
+    };
+
+    // Without a sender, producers have to take turns writing to the transport
+    std::mutex writeMutex;
+    const double directRate = measure([&](uint32_t)
+    {
+        for (uint32_t i = 0; i < numMessages; ++i)
+        {
+            Ether::IpcMessage message(BenchmarkMessageType, 1);
+            message.AddSection(PayloadTag, 64);
+
+            std::lock_guard<std::mutex> lock(writeMutex);
+            message.WriteTo(*transports.m_Client);
+        }
+    });
+
+    Ether::IpcSender sender;
+    sender.Attach(*transports.m_Client);
+
+    const double senderRate = measure([&](uint32_t)
+    {
+        for (uint32_t i = 0; i < numMessages; ++i)
+        {
+            Ether::IpcMessage message(BenchmarkMessageType, 1);
+            message.AddSection(PayloadTag, 64);
+            sender.Enqueue(std::move(message));
+        }
+    });
+
+    sender.Flush();
+    sender.Detach();
+
+    const Ether::IpcSenderStats stats = sender.GetStats();
+    std::printf(
+        "%-10s sender      %u producers       direct %10.1f msg/s   batched %10.1f msg/s   (%.1f msgs per write)\n",
+        transports.m_Name,
+        numProducers,
+        directRate,
+        senderRate,
+        static_cast<double>(stats.m_NumMessagesSent) / (std::max)(stats.m_NumWrites, uint64_t(1)));
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t numIterations = argc >= 2 ? static_cast<uint32_t>(std::stoul(argv[1])) : 10000;
+
+    try
+    {
+        std::vector<std::function<TransportPair()>> transportFactories = { CreateLoopbackPair, CreateTcpPair };
+
+        for (const auto& createTransports : transportFactories)
+        {
+            TransportPair transports = createTransports();
+
+            BenchmarkLatency(transports, numIterations);
+
+            for (size_t payloadSize : { size_t(64), Ether::_4KiB, Ether::_256KiB, Ether::_4MiB })
+            {
+                const uint32_t numMessages = static_cast<uint32_t>((std::max)(size_t(16), numIterations * Ether::_4KiB / (std::max)(payloadSize, Ether::_4KiB)));
+                BenchmarkThroughput(transports, payloadSize, numMessages);
+            }
+
+            for (size_t numFloats : { size_t(16), size_t(4096), size_t(65536) })
+                BenchmarkEncoding(transports, numFloats, (std::max)(16u, numIterations / static_cast<uint32_t>(1 + numFloats / 256)));
+
+            BenchmarkSender(transports, 4, numIterations * 4);
+
+            transports.m_Client->Close();
+            transports.m_Server->Close();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "IPC benchmark failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
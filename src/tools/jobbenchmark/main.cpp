@@ -0,0 +1,194 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/common.h"
+#include "common/jobs/jobsystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    Measures how the job system scales with the number of threads, against std::async running
+    the same chunks:
+
+    - Scaling:  a compute bound ParallelFor over a large array, for 2 threads up to one per
+                hardware thread, as speedup over a plain loop on the calling thread
+    - Overhead: many tiny jobs scheduled one by one and waited on together, as the cost per job
+
+    Every measurement is the median of several repetitions.
+
+    Usage: JobBenchmark [items] [repetitions]
+*/
+
+using Clock = std::chrono::steady_clock;
+
+// Enough arithmetic per item that the benchmark is not bound by memory bandwidth
+static constexpr uint32_t IterationsPerItem = 64;
+// Stays within a single thread's job ring so scheduling never has to help out
+static constexpr uint32_t NumTinyJobs = Ether::JobSystem::MaxJobsPerThread / 2;
+
+static double ToMilliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static void ProcessItems(float* items, uint32_t begin, uint32_t end)
+{
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        float value = items[i];
+        for (uint32_t j = 0; j < IterationsPerItem; ++j)
+            value = std::sqrt(value * 1.0001f + static_cast<float>(j));
+        items[i] = value;
+    }
+}
+
+template <typename Func>
+static double MeasureMedian(uint32_t numRepetitions, Func&& func)
+{
+    std::vector<double> times(numRepetitions);
+    for (uint32_t i = 0; i < numRepetitions; ++i)
+    {
+        const Clock::time_point start = Clock::now();
+        func();
+        times[i] = ToMilliseconds(Clock::now() - start);
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[numRepetitions / 2];
+}
+
+// Splits the items into the same chunks as JobSystem::ParallelFor, one std::async task each
+static void AsyncParallelFor(float* items, uint32_t numItems, uint32_t numChunks)
+{
+    const uint32_t chunkSize = (numItems + numChunks - 1) / numChunks;
+    std::vector<std::future<void>> futures;
+    futures.reserve(numChunks);
+
+    for (uint32_t begin = 0; begin < numItems; begin += chunkSize)
+    {
+        const uint32_t end = (std::min)(begin + chunkSize, numItems);
+        futures.push_back(std::async(std::launch::async, ProcessItems, items, begin, end));
+    }
+
+    for (std::future<void>& future : futures)
+        future.wait();
+}
+
+static void BenchmarkScaling(uint32_t numThreads, std::vector<float>& items, uint32_t numRepetitions, double serialTime)
+{
+    Ether::JobSystem::Instance().Initialize(numThreads - 1);
+
+    float* data = items.data();
+    const uint32_t numItems = static_cast<uint32_t>(items.size());
+    const uint32_t numChunks = numThreads * Ether::JobSystem::ChunksPerThread;
+
+    const double jobTime = MeasureMedian(numRepetitions, [&]()
+    {
+        Ether::JobSystem::ParallelFor("Benchmark", numItems, [data](uint32_t begin, uint32_t end) { ProcessItems(data, begin, end); });
+    });
+
+    const double asyncTime = MeasureMedian(numRepetitions, [&]() { AsyncParallelFor(data, numItems, numChunks); });
+
+    Ether::JobSystem::Instance().Shutdown();
+
+    std::printf(
+        "scaling   %3u threads   jobs %9.3f ms (%5.2fx)   async %9.3f ms (%5.2fx)\n",
+        numThreads,
+        jobTime,
+        serialTime / jobTime,
+        asyncTime,
+        serialTime / asyncTime);
+}
+
+static void BenchmarkOverhead(uint32_t numThreads, uint32_t numRepetitions)
+{
+    Ether::JobSystem::Instance().Initialize(numThreads - 1);
+
+    std::vector<uint32_t> results(NumTinyJobs);
+    uint32_t* data = results.data();
+
+    const double jobTime = MeasureMedian(numRepetitions, [&]()
+    {
+        Ether::JobCounter counter;
+        for (uint32_t i = 0; i < NumTinyJobs; ++i)
+            Ether::JobSystem::Run("Tiny Job", counter, [data, i]() { data[i] = i * 3; });
+
+        Ether::JobSystem::Wait(counter);
+    });
+
+    Ether::JobSystem::Instance().Shutdown();
+
+    const double asyncTime = MeasureMedian(numRepetitions, [&]()
+    {
+        std::vector<std::future<void>> futures;
+        futures.reserve(NumTinyJobs);
+        for (uint32_t i = 0; i < NumTinyJobs; ++i)
+            futures.push_back(std::async(std::launch::async, [data, i]() { data[i] = i * 3; }));
+
+        for (std::future<void>& future : futures)
+            future.wait();
+    });
+
+    std::printf(
+        "overhead  %3u threads   jobs %9.1f ns/job            async %9.1f ns/job            (%.1fx)\n",
+        numThreads,
+        jobTime * 1e6 / NumTinyJobs,
+        asyncTime * 1e6 / NumTinyJobs,
+        asyncTime / jobTime);
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t numItems = argc >= 2 ? static_cast<uint32_t>(std::stoul(argv[1])) : 1 << 20;
+    const uint32_t numRepetitions = argc >= 3 ? (std::max)(static_cast<uint32_t>(std::stoul(argv[2])), 1u) : 9;
+    const uint32_t maxThreads = (std::max)(std::thread::hardware_concurrency(), 2u);
+
+    std::vector<float> items(numItems);
+    for (uint32_t i = 0; i < numItems; ++i)
+        items[i] = static_cast<float>(i % 1024);
+
+    const double serialTime = MeasureMedian(numRepetitions, [&]() { ProcessItems(items.data(), 0, numItems); });
+    std::printf("serial      1 thread    %9.3f ms for %u items\n", serialTime, numItems);
+
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t numThreads = 2; numThreads < maxThreads; numThreads *= 2)
+        threadCounts.push_back(numThreads);
+    threadCounts.push_back(maxThreads);
+
+    for (uint32_t numThreads : threadCounts)
+        BenchmarkScaling(numThreads, items, numRepetitions, serialTime);
+
+    for (uint32_t numThreads : threadCounts)
+        BenchmarkOverhead(numThreads, numRepetitions);
+
+    // Keeps the compiler from dropping the work
+    float checksum = 0.0f;
+    for (float item : items)
+        checksum += item;
+    std::printf("checksum %f\n", checksum);
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/common.h"
+#include "common/logging/loggingmanager.h"
+#include "common/telemetry/hdrhistogram.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    Measures how long a log call blocks the calling thread while several threads log at once and
+    the writer thread drains their rings:
+
+    - formatted: Log(), which formats on the calling thread
+    - deferred:  LogDeferred(), which only copies the arguments
+
+    Every call is timed on its own (which includes the cost of reading the clock), and the latency
+    percentiles are reported over all threads together with the number of producer stalls, i.e.
+    calls that had to wait for the writer because their ring was full.
+
+    Usage: LogBenchmark [records per thread]
+*/
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr uint64_t HighestTrackableLatency = 1000000000; // 1 s in ns
+
+enum class LogMode
+{
+    Formatted,
+    Deferred,
+};
+
+static void LogRecords(LogMode mode, uint32_t threadIndex, uint32_t numRecords, Ether::HdrHistogram& latencies)
+{
+    Ether::LoggingManager& logger = Ether::LoggingManager::Instance();
+
+    for (uint32_t i = 0; i < numRecords; ++i)
+    {
+        const Clock::time_point start = Clock::now();
+
+        if (mode == LogMode::Formatted)
+            logger.Log(Ether::LogLevel::Info, Ether::LogType::None, "Thread %u record %u (%f ms)", threadIndex, i, i * 0.25);
+        else
+            logger.LogDeferred(Ether::LogLevel::Info, Ether::LogType::None, "Thread %u record %u (%f ms)", threadIndex, i, i * 0.25);
+
+        latencies.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+}
+
+static void BenchmarkContention(LogMode mode, uint32_t numThreads, uint32_t numRecordsPerThread)
+{
+    Ether::LoggingManager& logger = Ether::LoggingManager::Instance();
+    logger.Flush();
+
+    std::vector<Ether::HdrHistogram> latencies(numThreads, Ether::HdrHistogram(HighestTrackableLatency));
+    std::vector<std::thread> threads;
+
+    const uint64_t stallsBefore = logger.GetNumProducerStalls();
+    const Clock::time_point start = Clock::now();
+
+    for (uint32_t t = 0; t < numThreads; ++t)
+        threads.emplace_back(LogRecords, mode, t, numRecordsPerThread, std::ref(latencies[t]));
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    const double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    const uint64_t numStalls = logger.GetNumProducerStalls() - stallsBefore;
+
+    for (uint32_t t = 1; t < numThreads; ++t)
+        latencies[0].Merge(latencies[t]);
+
+    const Ether::HdrHistogram& merged = latencies[0];
+    std::printf(
+        "%-10s %2u threads   p50 %7llu ns   p99 %7llu ns   p99.9 %8llu ns   max %9llu ns   stalls %7llu   %6.2f M records/s\n",
+        mode == LogMode::Formatted ? "formatted" : "deferred",
+        numThreads,
+        static_cast<unsigned long long>(merged.GetValueAtPercentile(50.0)),
+        static_cast<unsigned long long>(merged.GetValueAtPercentile(99.0)),
+        static_cast<unsigned long long>(merged.GetValueAtPercentile(99.9)),
+        static_cast<unsigned long long>(merged.GetMax()),
+        static_cast<unsigned long long>(numStalls),
+        numThreads * numRecordsPerThread / elapsedMs / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const uint32_t numRecordsPerThread = argc >= 2 ? static_cast<uint32_t>(std::stoul(argv[1])) : 200000;
+        const uint32_t maxThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+        // Starts the writer thread, so that the rings are drained while the producers are running
+        Ether::LoggingManager::Instance().Initialize();
+
+        std::vector<uint32_t> threadCounts;
+        for (uint32_t numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+            threadCounts.push_back(numThreads);
+        threadCounts.push_back(maxThreads);
+
+        for (LogMode mode : { LogMode::Formatted, LogMode::Deferred })
+            for (uint32_t numThreads : threadCounts)
+                BenchmarkContention(mode, numThreads, numRecordsPerThread);
+
+        Ether::LoggingManager::Reset();
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
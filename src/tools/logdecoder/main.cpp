@@ -0,0 +1,69 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/common.h"
+#include "common/logging/binarylog.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+/*
+    Turns a binary log (.elog) written by the logging manager back into the plain text format
+    that the logging manager used to write directly.
+
+    Usage: LogDecoder <input.elog> [output.txt]
+*/
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: LogDecoder <input.elog> [output.txt]" << std::endl;
+        return 1;
+    }
+
+    Ether::BinaryLogReader reader;
+    if (!reader.Open(argv[1]))
+    {
+        std::cerr << "Failed to open " << argv[1] << " (missing file or not a binary log)" << std::endl;
+        return 1;
+    }
+
+    std::ofstream outputFile;
+    if (argc >= 3)
+    {
+        outputFile.open(argv[2]);
+        if (!outputFile.is_open())
+        {
+            std::cerr << "Failed to open " << argv[2] << " for writing" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ostream& output = outputFile.is_open() ? outputFile : std::cout;
+
+    Ether::DecodedLogRecord record;
+    while (reader.ReadNext(record))
+    {
+        const Ether::LogEntry entry(record.m_Text, record.m_Level, record.m_Type, record.m_Time / 1000000);
+        output << entry.GetFullText() << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,274 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engine/world/ecs/components/ecsmetadatacomponent.h"
+#include "engine/world/ecs/components/ecstransformcomponent.h"
+#include "engine/world/ecs/components/ecsvisualcomponent.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+    Compares the component serializers generated from reflection (EcsComponent<T>::Serialize and
+    Deserialize, driven by T::GetComponentInfo()) with the hand-written ones they replaced, which
+    are kept below as the baseline.
+
+    Both write into memory with the same encoding as OByteStream and read back through
+    IByteStream, so only the serializers differ. Components whose format did not change are
+    checked to serialize to the same bytes either way before anything is timed.
+
+    Reports the best of all runs, in nanoseconds per component.
+
+    Usage: SerializerBenchmark [components] [runs]
+*/
+
+using namespace Ether;
+using namespace Ether::Ecs;
+
+using Clock = std::chrono::steady_clock;
+
+// Same encoding as OByteStream, into memory that can be read back
+class MemoryOStream : public OStream
+{
+public:
+    MemoryOStream(size_t capacity) { m_Data.reserve(capacity); m_IsOpen = true; }
+
+    OStream& operator<<(const float v) override { return Write(v); }
+    OStream& operator<<(const int v) override { return Write(v); }
+    OStream& operator<<(const long v) override { return Write(v); }
+    OStream& operator<<(const char v) override { return Write(v); }
+    OStream& operator<<(const unsigned int v) override { return Write(v); }
+    OStream& operator<<(const unsigned long v) override { return Write(v); }
+    OStream& operator<<(const unsigned char v) override { return Write(v); }
+    OStream& operator<<(const bool v) override { return Write(v); }
+    OStream& operator<<(const ethVector2& v) override { return Write(v); }
+    OStream& operator<<(const ethVector3& v) override { return Write(v); }
+    OStream& operator<<(const ethVector4& v) override { return Write(v); }
+    OStream& operator<<(const StringID& v) override { return *this << v.GetString(); }
+
+    OStream& operator<<(const std::string& v) override
+    {
+        WriteBytes(v.c_str(), static_cast<uint32_t>(v.size() + 1));
+        return *this;
+    }
+
+    void WriteBytes(const void* src, uint32_t numBytes) override
+    {
+        const char* bytes = static_cast<const char*>(src);
+        m_Data.insert(m_Data.end(), bytes, bytes + numBytes);
+    }
+
+    inline const std::vector<char>& GetData() const { return m_Data; }
+
+private:
+    template <typename T>
+    OStream& Write(const T& value)
+    {
+        WriteBytes(&value, sizeof(value));
+        return *this;
+    }
+
+private:
+    std::vector<char> m_Data;
+};
+
+// The hand-written serializers as they were before reflection, apart from being free functions
+namespace HandWritten
+{
+static void Serialize(const EcsTransformComponent& component, OStream& ostream)
+{
+    component.Serializable::Serialize(ostream);
+    ostream << component.m_Translation;
+    ostream << component.m_Rotation;
+    ostream << component.m_Scale;
+}
+
+static void Deserialize(EcsTransformComponent& component, IStream& istream)
+{
+    component.Serializable::Deserialize(istream);
+    istream >> component.m_Translation;
+    istream >> component.m_Rotation;
+    istream >> component.m_Scale;
+}
+
+static void Serialize(const EcsMetadataComponent& component, OStream& ostream)
+{
+    component.Serializable::Serialize(ostream);
+    ostream << component.m_EntityID;
+    ostream << component.m_EntityName;
+    ostream << component.m_EntityEnabled;
+}
+
+static void Deserialize(EcsMetadataComponent& component, IStream& istream)
+{
+    component.Serializable::Deserialize(istream);
+    istream >> component.m_EntityID;
+    istream >> component.m_EntityName;
+    istream >> component.m_EntityEnabled;
+}
+
+static void Serialize(const EcsVisualComponent& component, OStream& ostream)
+{
+    component.Serializable::Serialize(ostream);
+    ostream << component.m_Enabled;
+    ostream << component.m_MeshGuid.GetString();
+    ostream << component.m_MaterialGuid.GetString();
+}
+
+static void Deserialize(EcsVisualComponent& component, IStream& istream)
+{
+    component.Serializable::Deserialize(istream);
+    istream >> component.m_Enabled;
+
+    std::string meshGuid, materialGuid;
+    istream >> meshGuid;
+    istream >> materialGuid;
+
+    component.m_MeshGuid = meshGuid;
+    component.m_MaterialGuid = materialGuid;
+}
+} // namespace HandWritten
+
+struct Timings
+{
+    double m_Write = 1e30;
+    double m_Read = 1e30;
+};
+
+static double ToNanoseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::nano>(duration).count();
+}
+
+static std::unique_ptr<IByteStream> CreateInputStream(const MemoryOStream& ostream)
+{
+    std::unique_ptr<IByteStream> istream = std::make_unique<IByteStream>(ostream.GetData().size());
+    std::memcpy(istream->GetData(), ostream.GetData().data(), ostream.GetData().size());
+    return istream;
+}
+
+template <typename T, typename WriteFunc, typename ReadFunc>
+static void Measure(const std::vector<T>& src, std::vector<T>& dst, WriteFunc write, ReadFunc read, Timings& timings, size_t& numBytes)
+{
+    MemoryOStream ostream(src.size() * 256);
+
+    const Clock::time_point writeStart = Clock::now();
+    for (const T& component : src)
+        write(component, ostream);
+    timings.m_Write = (std::min)(timings.m_Write, ToNanoseconds(Clock::now() - writeStart) / src.size());
+
+    std::unique_ptr<IByteStream> istream = CreateInputStream(ostream);
+
+    const Clock::time_point readStart = Clock::now();
+    for (T& component : dst)
+        read(component, *istream);
+    timings.m_Read = (std::min)(timings.m_Read, ToNanoseconds(Clock::now() - readStart) / dst.size());
+
+    numBytes = ostream.GetData().size();
+}
+
+template <typename T, typename InitFunc>
+static bool Run(const char* name, uint32_t numComponents, uint32_t numRuns, InitFunc init)
+{
+    std::vector<T> src(numComponents), dst(numComponents);
+    for (uint32_t i = 0; i < numComponents; ++i)
+        init(src[i], i);
+
+    MemoryOStream generated(256), handWritten(256);
+    src[0].Serialize(generated);
+    HandWritten::Serialize(src[0], handWritten);
+
+    if (generated.GetData() != handWritten.GetData())
+    {
+        std::fprintf(stderr, "%s: generated and hand-written serializers disagree\n", name);
+        return false;
+    }
+
+    Timings generatedTimings, handWrittenTimings;
+    size_t numBytes = 0;
+
+    // Interleaved, so that both see the same machine state
+    for (uint32_t run = 0; run < numRuns; ++run)
+    {
+        Measure(
+            src,
+            dst,
+            [](const T& component, OStream& ostream) { component.Serialize(ostream); },
+            [](T& component, IStream& istream) { component.Deserialize(istream); },
+            generatedTimings,
+            numBytes);
+
+        Measure(
+            src,
+            dst,
+            [](const T& component, OStream& ostream) { HandWritten::Serialize(component, ostream); },
+            [](T& component, IStream& istream) { HandWritten::Deserialize(component, istream); },
+            handWrittenTimings,
+            numBytes);
+    }
+
+    std::printf(
+        "%-10s %5zu B   write %7.1f / %7.1f ns   read %7.1f / %7.1f ns\n",
+        name,
+        numBytes / numComponents,
+        generatedTimings.m_Write,
+        handWrittenTimings.m_Write,
+        generatedTimings.m_Read,
+        handWrittenTimings.m_Read);
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const uint32_t numComponents = argc >= 2 ? static_cast<uint32_t>(std::stoul(argv[1])) : MaxNumEntities;
+        const uint32_t numRuns = argc >= 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 40;
+
+        std::printf("%u components, best of %u runs (generated / hand-written, per component)\n", numComponents, numRuns);
+
+        bool isValid = true;
+
+        isValid &= Run<EcsTransformComponent>("Transform", numComponents, numRuns, [](EcsTransformComponent& component, uint32_t i) {
+            component.m_Translation = { static_cast<float>(i), 1.0f, 2.0f };
+            component.m_Rotation = { 0.0f, static_cast<float>(i % 360), 0.0f };
+        });
+
+        isValid &= Run<EcsMetadataComponent>("Metadata", numComponents, numRuns, [](EcsMetadataComponent& component, uint32_t i) {
+            component.m_EntityID = i;
+            component.m_EntityName = "Entity " + std::to_string(i);
+        });
+
+        isValid &= Run<EcsVisualComponent>("Visual", numComponents, numRuns, [](EcsVisualComponent& component, uint32_t i) {
+            component.m_MeshGuid = StringID("Mesh " + std::to_string(i % 64));
+            component.m_MaterialGuid = StringID("Material " + std::to_string(i % 16));
+        });
+
+        return isValid ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,130 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "worldgeneratorapp.h"
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace Ether;
+
+static std::string Trim(const std::string& str)
+{
+    const size_t begin = str.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+        return "";
+
+    const size_t end = str.find_last_not_of(" \t\r\n");
+    return str.substr(begin, end - begin + 1);
+}
+
+void WorldGeneratorApp::Initialize()
+{
+    LogInfo("Initializing Application: World Generator");
+}
+
+void WorldGeneratorApp::LoadContent()
+{
+    const std::string& configPath = GetCommandLineOptions().GetWorldGeneratorConfigPath();
+
+    if (configPath.empty())
+        LogError("World generator: No config given (-worldgen <path>)");
+    else if (!LoadConfig(configPath))
+        LogError("World generator: Failed to load config %s", configPath.c_str());
+    else if (m_OutputPath.empty())
+        LogError("World generator: No output path set in %s", configPath.c_str());
+    else
+    {
+        WorldGenerator generator(m_Params);
+        generator.Generate(GetActiveWorld());
+
+        if (m_CellSize > 0.0f)
+            GetActiveWorld().SaveStreamed(m_OutputPath, m_CellSize);
+        else
+            GetActiveWorld().Save(m_OutputPath);
+
+        LogInfo("World generator: Saved world to %s", m_OutputPath.c_str());
+        m_ExitCode = 0;
+    }
+
+    // Nothing to simulate, exit before the first frame
+    Ether::Shutdown();
+}
+
+void WorldGeneratorApp::UnloadContent()
+{
+}
+
+void WorldGeneratorApp::Shutdown()
+{
+}
+
+void WorldGeneratorApp::OnUpdate(const UpdateEventArgs& e)
+{
+}
+
+void WorldGeneratorApp::OnRender(const RenderEventArgs& e)
+{
+}
+
+void WorldGeneratorApp::OnShutdown()
+{
+}
+
+bool WorldGeneratorApp::LoadConfig(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        return false;
+
+    std::string line;
+    bool isValid = true;
+
+    while (std::getline(file, line))
+    {
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        const size_t equals = line.find('=');
+        const std::string key = Trim(line.substr(0, equals));
+        const std::string value = equals == std::string::npos ? "" : Trim(line.substr(equals + 1));
+
+        if (key == "output" && !value.empty())
+            m_OutputPath = value;
+        else if (key == "cellsize")
+        {
+            char* end = nullptr;
+            m_CellSize = std::strtof(value.c_str(), &end);
+
+            if (value.empty() || *end != '\0' || !(m_CellSize > 0.0f))
+            {
+                LogError("World generator: Invalid setting: %s", line.c_str());
+                isValid = false;
+            }
+        }
+        else if (equals == std::string::npos || !m_Params.SetParam(key, value))
+        {
+            LogError("World generator: Invalid setting: %s", line.c_str());
+            isValid = false;
+        }
+    }
+
+    return isValid;
+}
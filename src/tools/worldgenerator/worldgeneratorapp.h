@@ -0,0 +1,67 @@
+/*
+    This file is part of Ether, an open-source DirectX 12 renderer.
+
+    Copyright (c) 2020-2023 Samuel Huang - All rights reserved.
+
+    Ether is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "ether.h"
+#include "engine/world/worldgenerator.h"
+
+/*
+    Generates a world from a "key = value" config file and saves it. Besides the world generator
+    settings (see WorldGeneratorParams::SetParam), the config takes the path to save to:
+
+        output = .\Data\worlds\generated.ether
+        seed = 7
+        entities = 4000
+        hierarchydepth = 3
+        hierarchybranching = 4
+        meshes = 64
+        materials = 128
+        textures = 32
+        texturesize = 512
+        placement = clustered                   # grid, random or clustered
+        clusters = 24
+        instanceskew = 1.0                      # 0 spreads instances evenly over meshes and materials
+        cellsize = 64                           # Saves a streaming world with cells of this size instead
+*/
+class WorldGeneratorApp : public Ether::IApplicationBase
+{
+public:
+    void Initialize() override;
+    void LoadContent() override;
+    void UnloadContent() override;
+    void Shutdown() override;
+
+public:
+    void OnUpdate(const Ether::UpdateEventArgs& e) override;
+    void OnRender(const Ether::RenderEventArgs& e) override;
+    void OnShutdown() override;
+
+public:
+    inline int GetExitCode() const { return m_ExitCode; }
+
+private:
+    bool LoadConfig(const std::string& path);
+
+private:
+    Ether::WorldGeneratorParams m_Params;
+    std::string m_OutputPath;
+    float m_CellSize = 0.0f;
+    int m_ExitCode = 1;
+};